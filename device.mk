@@ -126,6 +126,7 @@ PRODUCT_PACKAGES += \
 # These are the OpenMAX IL modules
 PRODUCT_PACKAGES += \
     libSEC_OMX_Core.aries \
+    libSEC_OMX_Resourcemanager.aries \
     libOMX.SEC.AVC.Decoder.aries \
     libOMX.SEC.M4V.Decoder.aries \
     libOMX.SEC.M4V.Encoder.aries \
@@ -0,0 +1,48 @@
+LOCAL_PATH := $(call my-dir)
+include $(CLEAR_VARS)
+
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_SRC_FILES := \
+	mfc_backend.c
+
+LOCAL_MODULE := libsecmfcbackend.aries
+
+LOCAL_CFLAGS :=
+
+LOCAL_ARM_MODE := arm
+
+LOCAL_STATIC_LIBRARIES :=
+
+LOCAL_SHARED_LIBRARIES := liblog
+
+LOCAL_C_INCLUDES := \
+	$(SEC_CODECS)/video/mfc_c110/include
+
+include $(BUILD_STATIC_LIBRARY)
+
+#########################################################################
+# Build MFC API and simulator for host, simulator selected by default
+#########################################################################
+
+include $(CLEAR_VARS)
+
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_SRC_FILES := \
+	mfc_backend.c \
+	mfc_sim.c \
+	mfc_sim_dec.c \
+	mfc_sim_enc.c \
+	mfc_sim_stream.c \
+	../dec/src/SsbSipMfcDecAPI.c \
+	../enc/src/SsbSipMfcEncAPI.c
+
+LOCAL_MODULE := libsecmfcapi_host
+
+LOCAL_CFLAGS := -DUSE_MFC_SIM
+
+LOCAL_C_INCLUDES := \
+	$(SEC_CODECS)/video/mfc_c110/include
+
+include $(BUILD_HOST_STATIC_LIBRARY)
@@ -0,0 +1,153 @@
+/*
+ *
+ * Copyright 2011 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    mfc_backend.c
+ * @brief   Selection of MFC backend and the device backend
+ * @version 1.0
+ */
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+
+#include "mfc_backend.h"
+#ifdef USE_MFC_SIM
+#include "mfc_sim.h"
+#endif
+
+static int mfc_device_open(const char *pathname, int flags)
+{
+    return open(pathname, flags);
+}
+
+static int mfc_device_ioctl(int fd, unsigned int request, void *arg)
+{
+    return ioctl(fd, request, arg);
+}
+
+static const MFC_BACKEND_OPS mfc_ops_device = {
+    MFC_BACKEND_DEVICE,
+    mfc_device_open,
+    close,
+    mfc_device_ioctl,
+    mmap,
+    munmap,
+};
+
+#ifdef USE_MFC_SIM
+static const MFC_BACKEND_OPS mfc_ops_sim = {
+    MFC_BACKEND_SIM,
+    mfc_sim_open,
+    mfc_sim_close,
+    mfc_sim_ioctl,
+    mfc_sim_mmap,
+    mfc_sim_munmap,
+};
+#endif
+
+static const MFC_BACKEND_OPS *mfc_ops = NULL;
+
+static const MFC_BACKEND_OPS *mfc_find_backend(MFC_BACKEND backend)
+{
+    switch (backend) {
+    case MFC_BACKEND_DEVICE:
+        return &mfc_ops_device;
+#ifdef USE_MFC_SIM
+    case MFC_BACKEND_SIM:
+        return &mfc_ops_sim;
+#endif
+    default:
+        break;
+    }
+
+    return NULL;
+}
+
+static MFC_BACKEND mfc_auto_backend(void)
+{
+#ifdef USE_MFC_SIM
+    return MFC_BACKEND_SIM;
+#else
+    return MFC_BACKEND_DEVICE;
+#endif
+}
+
+/*
+ * Selects backend used by SsbSipMfcDecOpen and SsbSipMfcEncOpen
+ *
+ * @param backend
+ *   Backend to use, MFC_BACKEND_AUTO for the build default[in]
+ *
+ * @return
+ *   0 on success, -1 if backend is unknown or not built in
+ */
+int mfc_backend_init(MFC_BACKEND backend)
+{
+    const MFC_BACKEND_OPS *ops;
+
+    if (backend == MFC_BACKEND_AUTO)
+        backend = mfc_auto_backend();
+
+    ops = mfc_find_backend(backend);
+    if (ops == NULL)
+        return -1;
+
+    mfc_ops = ops;
+
+    return 0;
+}
+
+/*
+ * Returns operations of backend used by next open
+ */
+const MFC_BACKEND_OPS *mfc_get_backend_ops(void)
+{
+    if (mfc_ops == NULL)
+        mfc_backend_init(MFC_BACKEND_AUTO);
+
+    return mfc_ops;
+}
+
+/*
+ * Returns backend used by next open
+ */
+MFC_BACKEND mfc_get_backend(void)
+{
+    return mfc_get_backend_ops()->backend;
+}
+
+/*
+ * Returns printable name of backend
+ */
+const char *mfc_get_backend_name(MFC_BACKEND backend)
+{
+    switch (backend) {
+    case MFC_BACKEND_AUTO:
+        return "auto";
+    case MFC_BACKEND_DEVICE:
+        return "device";
+    case MFC_BACKEND_SIM:
+        return "sim";
+    default:
+        break;
+    }
+
+    return "unknown";
+}
@@ -0,0 +1,469 @@
+/*
+ *
+ * Copyright 2011 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    mfc_sim.c
+ * @brief   Userspace simulator of the MFC driver
+ *   Instances, the mapped area and its buffers, and the ioctl entry.
+ *   Every instance gets an anonymous mapping of MMAP_BUFFER_SIZE_MMAP
+ *   in place of the reserved memory of the driver, physical addresses
+ *   are made up from MFC_SIM_PHYS_BASE. The API keeps addresses in
+ *   unsigned int, so on 64 bit hosts the mapping is placed in the low
+ *   4GB with MAP_32BIT.
+ * @version 1.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <utils/Log.h>
+
+#include "mfc_sim.h"
+
+static MFC_SIM_INSTANCE mfc_sim_instance[MFC_SIM_MAX_INSTANCE];
+
+/* instance table and everything in it */
+static pthread_mutex_t mfc_sim_lock = PTHREAD_MUTEX_INITIALIZER;
+/* held for a whole decode or encode run, there is only one MFC */
+static pthread_mutex_t mfc_sim_hw_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static MFC_SIM_INSTANCE *mfc_sim_get_instance(int fd)
+{
+    int index = fd - MFC_SIM_FD_BASE;
+
+    if ((index < 0) || (index >= MFC_SIM_MAX_INSTANCE) ||
+        (mfc_sim_instance[index].bUsed == 0))
+        return NULL;
+
+    return &mfc_sim_instance[index];
+}
+
+static unsigned long long mfc_sim_time_us(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((unsigned long long)ts.tv_sec * 1000000) + (ts.tv_nsec / 1000);
+}
+
+/* Waits until one run of mbNum macroblocks took as long as on the hardware */
+static void mfc_sim_wait(int speed, int mbNum, int mbPerSec, unsigned long long startUs)
+{
+    unsigned long long runUs;
+    unsigned long long elapsedUs;
+
+    if (speed <= 0)
+        return;
+
+    runUs = MFC_SIM_RUN_OVERHEAD_US + ((unsigned long long)mbNum * 1000000) / mbPerSec;
+    runUs = (runUs * 100) / speed;
+
+    elapsedUs = mfc_sim_time_us() - startUs;
+    if (elapsedUs < runUs)
+        usleep((useconds_t)(runUs - elapsedUs));
+}
+
+/*
+ * Allocates size bytes of the mapped area, first fit
+ *
+ * @return
+ *   0 on success, -1 if the area is full
+ */
+int mfc_sim_alloc(MFC_SIM_INSTANCE *pInst, unsigned int size, unsigned int align, unsigned int *pPhys)
+{
+    unsigned int start = 0;
+    unsigned int end;
+    int i;
+
+    if ((size == 0) || (pInst->bufferNum >= MFC_SIM_MAX_BUFFER))
+        return -1;
+
+    for (i = 0; i <= pInst->bufferNum; i++) {
+        end = (i < pInst->bufferNum) ? pInst->buffer[i].offset : MMAP_BUFFER_SIZE_MMAP;
+        start = (start + align - 1) & ~(align - 1);
+
+        if ((start <= end) && (end - start >= size)) {
+            memmove(&pInst->buffer[i + 1], &pInst->buffer[i], (pInst->bufferNum - i) * sizeof(MFC_SIM_BUFFER));
+            pInst->buffer[i].offset = start;
+            pInst->buffer[i].size = size;
+            pInst->bufferNum++;
+            *pPhys = pInst->phys + start;
+            return 0;
+        }
+
+        if (i < pInst->bufferNum)
+            start = pInst->buffer[i].offset + pInst->buffer[i].size;
+    }
+
+    return -1;
+}
+
+/*
+ * Frees buffer allocated at phys
+ *
+ * @return
+ *   0 on success, -1 if there is no such buffer
+ */
+int mfc_sim_free(MFC_SIM_INSTANCE *pInst, unsigned int phys)
+{
+    int i;
+
+    for (i = 0; i < pInst->bufferNum; i++) {
+        if (pInst->phys + pInst->buffer[i].offset == phys) {
+            pInst->bufferNum--;
+            memmove(&pInst->buffer[i], &pInst->buffer[i + 1], (pInst->bufferNum - i) * sizeof(MFC_SIM_BUFFER));
+            return 0;
+        }
+    }
+
+    return -1;
+}
+
+/*
+ * Returns pointer to size bytes at physical address phys,
+ * NULL if they are not in the mapped area of the instance
+ */
+unsigned char *mfc_sim_phys_to_virt(MFC_SIM_INSTANCE *pInst, unsigned int phys, unsigned int size)
+{
+    if ((pInst->base == NULL) || (phys < pInst->phys) ||
+        (phys - pInst->phys > MMAP_BUFFER_SIZE_MMAP) ||
+        (size > MMAP_BUFFER_SIZE_MMAP - (phys - pInst->phys)))
+        return NULL;
+
+    return pInst->base + (phys - pInst->phys);
+}
+
+/*
+ * Same as mfc_sim_phys_to_virt over the mapped areas of all instances,
+ * for buffers handed from one instance to another. Caller holds mfc_sim_lock.
+ */
+unsigned char *mfc_sim_phys_to_virt_any(unsigned int phys, unsigned int size)
+{
+    unsigned char *virt;
+    int i;
+
+    for (i = 0; i < MFC_SIM_MAX_INSTANCE; i++) {
+        if (mfc_sim_instance[i].bUsed == 0)
+            continue;
+        virt = mfc_sim_phys_to_virt(&mfc_sim_instance[i], phys, size);
+        if (virt != NULL)
+            return virt;
+    }
+
+    return NULL;
+}
+
+unsigned char *mfc_sim_map_phys(unsigned int phys, unsigned int size)
+{
+    unsigned char *virt;
+
+    pthread_mutex_lock(&mfc_sim_lock);
+    virt = mfc_sim_phys_to_virt_any(phys, size);
+    pthread_mutex_unlock(&mfc_sim_lock);
+
+    return virt;
+}
+
+/*
+ * Returns physical address of user address virt, 0 if not mapped
+ */
+unsigned int mfc_sim_virt_to_phys(MFC_SIM_INSTANCE *pInst, unsigned int virt)
+{
+    unsigned int base = (unsigned int)(unsigned long)pInst->base;
+
+    if ((pInst->base == NULL) || (virt < base) || (virt - base >= MMAP_BUFFER_SIZE_MMAP))
+        return 0;
+
+    return pInst->phys + (virt - base);
+}
+
+/*
+ * Returns user address of physical address phys in the mapped area
+ */
+unsigned int mfc_sim_virt(MFC_SIM_INSTANCE *pInst, unsigned int phys)
+{
+    return (unsigned int)(unsigned long)(pInst->base + (phys - pInst->phys));
+}
+
+static SSBSIP_MFC_ERROR_CODE mfc_sim_set_config(MFC_SIM_INSTANCE *pInst, mfc_set_config_arg_t *pArg)
+{
+    int *pValue = NULL;
+
+    switch (pArg->in_config_param) {
+    case MFC_DEC_SETCONF_EXTRA_BUFFER_NUM:
+        pValue = &pInst->extraBufferNum;
+        break;
+    case MFC_DEC_SETCONF_DISPLAY_DELAY:
+        pValue = &pInst->displayDelay;
+        break;
+    case MFC_DEC_SETCONF_IS_LAST_FRAME:
+        pValue = &pInst->bLastFrame;
+        break;
+    case MFC_DEC_SETCONF_FIMV1_WIDTH_HEIGHT:
+        pArg->out_config_value_old[0] = pInst->fimv1Width;
+        pArg->out_config_value_old[1] = pInst->fimv1Height;
+        pInst->fimv1Width = pArg->in_config_value[0];
+        pInst->fimv1Height = pArg->in_config_value[1];
+        return MFC_RET_OK;
+    case MFC_DEC_SETCONF_POST_ENABLE:
+    case MFC_DEC_SETCONF_SLICE_ENABLE:
+    case MFC_DEC_SETCONF_CRC_ENABLE:
+    case MFC_ENC_SETCONF_ALLOW_FRAME_SKIP:
+        return MFC_RET_OK;
+    case MFC_ENC_SETCONF_FRAME_TYPE:
+        pValue = &pInst->forceFrameType;
+        break;
+    case MFC_ENC_SETCONF_CHANGE_FRAME_RATE:
+        pValue = &pInst->frameRate;
+        break;
+    case MFC_ENC_SETCONF_CHANGE_BIT_RATE:
+        pValue = &pInst->bitRate;
+        break;
+    default:
+        return MFC_RET_INVALID_PARAM;
+    }
+
+    pArg->out_config_value_old[0] = *pValue;
+    *pValue = pArg->in_config_value[0];
+
+    return MFC_RET_OK;
+}
+
+int mfc_sim_open(const char *pathname, int flags)
+{
+    MFC_SIM_INSTANCE *pInst = NULL;
+    const char *env;
+    int i;
+
+    pthread_mutex_lock(&mfc_sim_lock);
+    for (i = 0; i < MFC_SIM_MAX_INSTANCE; i++) {
+        if (mfc_sim_instance[i].bUsed == 0) {
+            pInst = &mfc_sim_instance[i];
+            break;
+        }
+    }
+
+    if (pInst == NULL) {
+        pthread_mutex_unlock(&mfc_sim_lock);
+        LOGE("mfc_sim_open: no free instance\n");
+        errno = EBUSY;
+        return -1;
+    }
+
+    memset(pInst, 0, sizeof(MFC_SIM_INSTANCE));
+    pInst->bUsed = 1;
+    pInst->phys = MFC_SIM_PHYS_BASE + (i * MFC_SIM_PHYS_STRIDE);
+    pInst->displayDelay = -1;
+
+    env = getenv("SEC_MFC_SIM_SPEED");
+    pInst->speed = (env != NULL) ? atoi(env) : 100;
+    pthread_mutex_unlock(&mfc_sim_lock);
+
+    return MFC_SIM_FD_BASE + i;
+}
+
+int mfc_sim_close(int fd)
+{
+    MFC_SIM_INSTANCE *pInst;
+
+    pthread_mutex_lock(&mfc_sim_lock);
+    pInst = mfc_sim_get_instance(fd);
+    if (pInst == NULL) {
+        pthread_mutex_unlock(&mfc_sim_lock);
+        errno = EBADF;
+        return -1;
+    }
+
+    if (pInst->base != NULL)
+        munmap(pInst->base, MMAP_BUFFER_SIZE_MMAP);
+    pInst->base = NULL;
+    pInst->bUsed = 0;
+    pthread_mutex_unlock(&mfc_sim_lock);
+
+    return 0;
+}
+
+void *mfc_sim_mmap(void *addr, size_t length, int prot, int flags, int fd, off_t offset)
+{
+    MFC_SIM_INSTANCE *pInst;
+    void *base;
+    int mapFlags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE;
+
+#ifdef MAP_32BIT
+    mapFlags |= MAP_32BIT;
+#endif
+
+    pthread_mutex_lock(&mfc_sim_lock);
+    pInst = mfc_sim_get_instance(fd);
+    if ((pInst == NULL) || (pInst->base != NULL) ||
+        (length > MMAP_BUFFER_SIZE_MMAP) || (offset != 0)) {
+        pthread_mutex_unlock(&mfc_sim_lock);
+        errno = EINVAL;
+        return MAP_FAILED;
+    }
+
+    base = mmap(NULL, MMAP_BUFFER_SIZE_MMAP, PROT_READ | PROT_WRITE, mapFlags, -1, 0);
+    if (base == MAP_FAILED) {
+        pthread_mutex_unlock(&mfc_sim_lock);
+        LOGE("mfc_sim_mmap: mmap failed (%d)\n", errno);
+        return MAP_FAILED;
+    }
+
+    if ((unsigned long)base + MMAP_BUFFER_SIZE_MMAP > 0xFFFFFFFFUL) {
+        munmap(base, MMAP_BUFFER_SIZE_MMAP);
+        pthread_mutex_unlock(&mfc_sim_lock);
+        LOGE("mfc_sim_mmap: mapped area is out of 32 bit address range\n");
+        errno = ENOMEM;
+        return MAP_FAILED;
+    }
+
+    pInst->base = (unsigned char *)base;
+    pthread_mutex_unlock(&mfc_sim_lock);
+
+    return base;
+}
+
+int mfc_sim_munmap(void *addr, size_t length)
+{
+    int i;
+
+    pthread_mutex_lock(&mfc_sim_lock);
+    for (i = 0; i < MFC_SIM_MAX_INSTANCE; i++) {
+        if ((mfc_sim_instance[i].bUsed != 0) && (mfc_sim_instance[i].base == addr)) {
+            munmap(mfc_sim_instance[i].base, MMAP_BUFFER_SIZE_MMAP);
+            mfc_sim_instance[i].base = NULL;
+            mfc_sim_instance[i].bufferNum = 0;
+            pthread_mutex_unlock(&mfc_sim_lock);
+            return 0;
+        }
+    }
+    pthread_mutex_unlock(&mfc_sim_lock);
+
+    errno = EINVAL;
+    return -1;
+}
+
+int mfc_sim_ioctl(int fd, unsigned int request, void *arg)
+{
+    mfc_common_args *pArgs = (mfc_common_args *)arg;
+    MFC_SIM_INSTANCE *pInst;
+    SSBSIP_MFC_ERROR_CODE ret = MFC_RET_OK;
+    unsigned long long startUs;
+    unsigned int phys;
+    int mbNum = 0;
+    int mbPerSec = 0;
+    int speed;
+    int bRun = 0;
+
+    if ((request == IOCTL_MFC_DEC_EXE) || (request == IOCTL_MFC_ENC_EXE)) {
+        pthread_mutex_lock(&mfc_sim_hw_lock);
+        bRun = 1;
+    }
+    startUs = mfc_sim_time_us();
+
+    pthread_mutex_lock(&mfc_sim_lock);
+    pInst = mfc_sim_get_instance(fd);
+    if (pInst == NULL) {
+        pthread_mutex_unlock(&mfc_sim_lock);
+        if (bRun)
+            pthread_mutex_unlock(&mfc_sim_hw_lock);
+        errno = EBADF;
+        return -1;
+    }
+
+    switch (request) {
+    case IOCTL_MFC_DEC_INIT:
+        ret = mfc_sim_dec_init(pInst, &pArgs->args.dec_init);
+        break;
+
+    case IOCTL_MFC_DEC_EXE:
+        ret = mfc_sim_dec_exe(pInst, &pArgs->args.dec_exe, &mbNum);
+        mbPerSec = MFC_SIM_DEC_MB_PER_SEC;
+        break;
+
+    case IOCTL_MFC_ENC_INIT:
+        ret = mfc_sim_enc_init(pInst, &pArgs->args.enc_init_mpeg4,
+                               (pArgs->args.enc_init_mpeg4.in_codec_type == H264_ENC) ?
+                                   pArgs->args.enc_init_h264.in_RC_mb_enable : 0);
+        break;
+
+    case IOCTL_MFC_ENC_EXE:
+        ret = mfc_sim_enc_exe(pInst, &pArgs->args.enc_exe, &mbNum);
+        mbPerSec = MFC_SIM_ENC_MB_PER_SEC;
+        break;
+
+    case IOCTL_MFC_GET_IN_BUF:
+        if ((pArgs->args.mem_alloc.buff_size <= 0) ||
+            (mfc_sim_alloc(pInst, ALIGN_TO_2KB(pArgs->args.mem_alloc.buff_size), 2048, &phys) != 0)) {
+            LOGE("mfc_sim_ioctl: IOCTL_MFC_GET_IN_BUF of %d bytes failed\n", pArgs->args.mem_alloc.buff_size);
+            ret = MFC_RET_FAIL;
+            break;
+        }
+        pArgs->args.mem_alloc.out_paddr = phys;
+        pArgs->args.mem_alloc.out_uaddr = mfc_sim_virt(pInst, phys);
+        break;
+
+    case IOCTL_MFC_FREE_BUF:
+        phys = mfc_sim_virt_to_phys(pInst, pArgs->args.mem_free.u_addr);
+        if ((phys == 0) || (mfc_sim_free(pInst, phys) != 0))
+            ret = MFC_RET_FAIL;
+        break;
+
+    case IOCTL_MFC_GET_PHYS_ADDR:
+        pArgs->args.get_phys_addr.p_addr = mfc_sim_virt_to_phys(pInst, pArgs->args.get_phys_addr.u_addr);
+        if (pArgs->args.get_phys_addr.p_addr == 0)
+            ret = MFC_RET_FAIL;
+        break;
+
+    case IOCTL_MFC_SET_CONFIG:
+        ret = mfc_sim_set_config(pInst, &pArgs->args.set_config);
+        break;
+
+    case IOCTL_MFC_GET_CONFIG:
+        /* CRC of the decoded frame is not simulated */
+        memset(pArgs->args.get_config.out_config_value, 0, sizeof(pArgs->args.get_config.out_config_value));
+        break;
+
+    case IOCTL_MFC_BUF_CACHE:
+        break;
+
+    default:
+        ret = MFC_RET_INVALID_PARAM;
+        break;
+    }
+    speed = pInst->speed;
+    pthread_mutex_unlock(&mfc_sim_lock);
+
+    if (bRun) {
+        if (ret == MFC_RET_OK)
+            mfc_sim_wait(speed, mbNum, mbPerSec, startUs);
+        pthread_mutex_unlock(&mfc_sim_hw_lock);
+    }
+
+    pArgs->ret_code = ret;
+    if (ret != MFC_RET_OK) {
+        errno = EINVAL;
+        return -1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,171 @@
+/*
+ *
+ * Copyright 2011 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    mfc_sim.h
+ * @brief   Internal interface of the MFC simulator
+ * @version 1.0
+ */
+
+#ifndef MFC_SIM_H_
+#define MFC_SIM_H_
+
+#include "mfc_backend.h"
+#include "mfc_interface.h"
+
+#define MFC_SIM_MAX_INSTANCE        8
+#define MFC_SIM_MAX_BUFFER          64
+#define MFC_SIM_MAX_FRAME           40      /* DPB, display delay and extra buffers */
+#define MFC_SIM_MAX_REF             16
+
+/* Descriptors returned by mfc_sim_open, never real ones */
+#define MFC_SIM_FD_BASE             0x4D460000
+
+/* Physical address of the mapped area of instance n */
+#define MFC_SIM_PHYS_BASE           0x40000000
+#define MFC_SIM_PHYS_STRIDE         ALIGN_TO_64KB(MMAP_BUFFER_SIZE_MMAP)
+
+typedef struct _MFC_SIM_BUFFER
+{
+    unsigned int offset;    /* from start of mapped area */
+    unsigned int size;
+} MFC_SIM_BUFFER;
+
+typedef struct _MFC_SIM_PICTURE
+{
+    int slot;               /* index of frame buffer */
+    int tag;
+    int poc;                /* display order */
+} MFC_SIM_PICTURE;
+
+/* What the decoder keeps of the H.264 sequence parameter set */
+typedef struct _MFC_SIM_H264_SPS
+{
+    int maxRefFrames;
+    int log2MaxFrameNum;
+    int pocType;
+    int log2MaxPocLsb;
+    int frameMbsOnly;
+    int separateColourPlane;
+} MFC_SIM_H264_SPS;
+
+/* Picture size and cropping parsed from the stream header */
+typedef struct _MFC_SIM_SEQ_INFO
+{
+    int width;              /* of the decoded picture, macroblock aligned for H.264 */
+    int height;
+    int cropTop;
+    int cropBottom;
+    int cropLeft;
+    int cropRight;
+    int refFrames;          /* frames referenced by a picture */
+    int lowDelay;           /* no B pictures */
+    MFC_SIM_H264_SPS sps;
+} MFC_SIM_SEQ_INFO;
+
+typedef struct _MFC_SIM_INSTANCE
+{
+    int                   bUsed;
+    int                   speed;            /* percent of hardware speed, 0 for no wait */
+    unsigned char        *base;             /* mapped area */
+    unsigned int          phys;             /* physical address of base */
+    MFC_SIM_BUFFER        buffer[MFC_SIM_MAX_BUFFER];   /* sorted by offset */
+    int                   bufferNum;
+    SSBSIP_MFC_CODEC_TYPE codecType;
+
+    /* decoder */
+    MFC_SIM_SEQ_INFO      seq;
+    int                   extraBufferNum;
+    int                   displayDelay;     /* -1 if not set */
+    int                   bLastFrame;
+    int                   fimv1Width;
+    int                   fimv1Height;
+    unsigned int          lumaPhys;         /* frame buffers */
+    unsigned int          chromaPhys;
+    unsigned int          lumaSize;         /* of one frame */
+    unsigned int          chromaSize;
+    int                   frameNum;
+    int                   nextSlot;
+    int                   window;           /* pictures held for reordering */
+    MFC_SIM_PICTURE       pending[MFC_SIM_MAX_FRAME];
+    int                   pendingNum;
+    int                   pocBase;          /* continues display order over IDR */
+    int                   pocMax;
+    int                   prevPocMsb;
+    int                   prevPocLsb;
+
+    /* encoder */
+    int                   width;
+    int                   height;
+    int                   gopNum;
+    int                   frameQp;
+    int                   rcEnable;
+    int                   frameRate;
+    int                   bitRate;          /* bits per second */
+    int                   forceFrameType;
+    int                   encodeCount;
+    unsigned int          strmPhys;
+    unsigned int          refPhys;
+} MFC_SIM_INSTANCE;
+
+/* mfc_sim.c */
+int   mfc_sim_open(const char *pathname, int flags);
+int   mfc_sim_close(int fd);
+int   mfc_sim_ioctl(int fd, unsigned int request, void *arg);
+void *mfc_sim_mmap(void *addr, size_t length, int prot, int flags, int fd, off_t offset);
+int   mfc_sim_munmap(void *addr, size_t length);
+
+int            mfc_sim_alloc(MFC_SIM_INSTANCE *pInst, unsigned int size, unsigned int align, unsigned int *pPhys);
+int            mfc_sim_free(MFC_SIM_INSTANCE *pInst, unsigned int phys);
+unsigned char *mfc_sim_phys_to_virt(MFC_SIM_INSTANCE *pInst, unsigned int phys, unsigned int size);
+unsigned char *mfc_sim_phys_to_virt_any(unsigned int phys, unsigned int size);
+unsigned int   mfc_sim_virt_to_phys(MFC_SIM_INSTANCE *pInst, unsigned int virt);
+unsigned int   mfc_sim_virt(MFC_SIM_INSTANCE *pInst, unsigned int phys);
+
+/* mfc_sim_dec.c */
+SSBSIP_MFC_ERROR_CODE mfc_sim_dec_init(MFC_SIM_INSTANCE *pInst, mfc_dec_init_arg_t *pArg);
+SSBSIP_MFC_ERROR_CODE mfc_sim_dec_exe(MFC_SIM_INSTANCE *pInst, mfc_dec_exe_arg_t *pArg, int *pMbNum);
+
+/* mfc_sim_enc.c */
+SSBSIP_MFC_ERROR_CODE mfc_sim_enc_init(MFC_SIM_INSTANCE *pInst, mfc_enc_init_mpeg4_arg_t *pArg, int mbRcEnable);
+SSBSIP_MFC_ERROR_CODE mfc_sim_enc_exe(MFC_SIM_INSTANCE *pInst, mfc_enc_exe_arg *pArg, int *pMbNum);
+
+/* mfc_sim_stream.c */
+typedef struct _MFC_SIM_BITS
+{
+    unsigned char *buf;
+    int            size;    /* bytes */
+    int            pos;     /* bits */
+} MFC_SIM_BITS;
+
+int          mfc_sim_find_start_code(const unsigned char *buf, int size, int pos);
+unsigned int mfc_sim_bits_get(MFC_SIM_BITS *pBits, int n);
+unsigned int mfc_sim_bits_get_ue(MFC_SIM_BITS *pBits);
+int          mfc_sim_bits_get_se(MFC_SIM_BITS *pBits);
+void         mfc_sim_bits_put(MFC_SIM_BITS *pBits, unsigned int value, int n);
+void         mfc_sim_bits_put_ue(MFC_SIM_BITS *pBits, unsigned int value);
+int          mfc_sim_bits_trailing(MFC_SIM_BITS *pBits);
+
+int mfc_sim_h264_parse_sps(const unsigned char *nal, int size, MFC_SIM_SEQ_INFO *pSeq);
+int mfc_sim_h264_parse_slice(const unsigned char *nal, int size, const MFC_SIM_H264_SPS *pSps,
+                             int *pIdr, int *pRef, int *pPocLsb);
+int mfc_sim_mpeg4_parse_vol(const unsigned char *buf, int size, MFC_SIM_SEQ_INFO *pSeq);
+int mfc_sim_h263_parse_picture(const unsigned char *buf, int size, MFC_SIM_SEQ_INFO *pSeq);
+int mfc_sim_mpeg2_parse_sequence(const unsigned char *buf, int size, MFC_SIM_SEQ_INFO *pSeq);
+int mfc_sim_put_nal(unsigned char *dest, int destSize, int nalHeader, const unsigned char *rbsp, int rbspSize);
+
+#endif /*MFC_SIM_H_*/
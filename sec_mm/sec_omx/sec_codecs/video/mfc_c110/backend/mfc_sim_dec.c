@@ -0,0 +1,432 @@
+/*
+ *
+ * Copyright 2011 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    mfc_sim_dec.c
+ * @brief   Decoder of the MFC simulator
+ *   IOCTL_MFC_DEC_INIT takes the picture size from the stream header,
+ *   IOCTL_MFC_DEC_EXE stamps a frame buffer for every picture and hands
+ *   them out in display order: H.264 by picture order count within the
+ *   display delay, MPEG-1/2/4 by holding the last I or P picture while B
+ *   pictures pass. A run with no stream flushes one held picture.
+ *   FIMV1 and VC-1 streams take the size of MFC_DEC_SETCONF_FIMV1_WIDTH_HEIGHT.
+ * @version 1.0
+ */
+
+#include <string.h>
+#include <utils/Log.h>
+
+#include "mfc_sim.h"
+
+#define MFC_SIM_CODING_I    0
+#define MFC_SIM_CODING_P    1
+#define MFC_SIM_CODING_B    2
+
+/* out_display_status */
+#define MFC_SIM_DISPLAY_END         0
+#define MFC_SIM_DISPLAY_DECODING    1
+#define MFC_SIM_DISPLAY_ONLY        2
+#define MFC_SIM_DECODING_ONLY       3
+
+static int mfc_sim_is_mpeg4(SSBSIP_MFC_CODEC_TYPE codecType)
+{
+    return (codecType == MPEG4_DEC) || (codecType == XVID_DEC) ||
+           (codecType == FIMV2_DEC) || (codecType == FIMV3_DEC) || (codecType == FIMV4_DEC);
+}
+
+/* Returns index of the H.263 picture start code, -1 if none */
+static int mfc_sim_find_h263_picture(const unsigned char *buf, int size)
+{
+    int i;
+
+    for (i = 0; i + 3 <= size; i++) {
+        if ((buf[i] == 0) && (buf[i + 1] == 0) && ((buf[i + 2] & 0xFC) == 0x80))
+            return i;
+    }
+
+    return -1;
+}
+
+static int mfc_sim_dec_parse_header(MFC_SIM_INSTANCE *pInst, const unsigned char *buf, int size, MFC_SIM_SEQ_INFO *pSeq)
+{
+    int pos = 0;
+    int next;
+
+    switch (pInst->codecType) {
+    case H264_DEC:
+        while ((pos = mfc_sim_find_start_code(buf, size, pos)) >= 0) {
+            next = mfc_sim_find_start_code(buf, size, pos);
+            if ((buf[pos] & 0x1F) == 7)
+                return mfc_sim_h264_parse_sps(buf + pos, ((next < 0) ? size : next - 3) - pos, pSeq);
+        }
+        break;
+
+    case H263_DEC:
+        pos = mfc_sim_find_h263_picture(buf, size);
+        if (pos >= 0)
+            return (mfc_sim_h263_parse_picture(buf + pos, size - pos, pSeq) < 0) ? -1 : 0;
+        break;
+
+    case MPEG1_DEC:
+    case MPEG2_DEC:
+        while ((pos = mfc_sim_find_start_code(buf, size, pos)) >= 0) {
+            if (buf[pos] == 0xB3)
+                return mfc_sim_mpeg2_parse_sequence(buf + pos + 1, size - pos - 1, pSeq);
+        }
+        break;
+
+    case FIMV1_DEC:
+    case VC1RCV_DEC:
+    case VC1_DEC:
+        if ((pInst->fimv1Width <= 0) || (pInst->fimv1Height <= 0))
+            break;
+        memset(pSeq, 0, sizeof(MFC_SIM_SEQ_INFO));
+        pSeq->width = pInst->fimv1Width;
+        pSeq->height = pInst->fimv1Height;
+        pSeq->refFrames = 2;
+        return 0;
+
+    default:
+        if (mfc_sim_is_mpeg4(pInst->codecType)) {
+            while ((pos = mfc_sim_find_start_code(buf, size, pos)) >= 0) {
+                if ((buf[pos] & 0xF0) == 0x20)
+                    return mfc_sim_mpeg4_parse_vol(buf + pos + 1, size - pos - 1, pSeq);
+            }
+        }
+        break;
+    }
+
+    return -1;
+}
+
+/*
+ * Finds the first picture of the stream and works out its display order
+ *
+ * @return
+ *   Picture coding type, -1 if there is no picture
+ */
+static int mfc_sim_dec_find_picture(MFC_SIM_INSTANCE *pInst, const unsigned char *buf, int size, int *pPoc)
+{
+    MFC_SIM_H264_SPS *pSps = &pInst->seq.sps;
+    int pos = 0;
+    int next;
+    int idr, ref, pocLsb, pocMsb, maxPocLsb;
+
+    switch (pInst->codecType) {
+    case H264_DEC:
+        while ((pos = mfc_sim_find_start_code(buf, size, pos)) >= 0) {
+            if (((buf[pos] & 0x1F) != 1) && ((buf[pos] & 0x1F) != 5))
+                continue;
+
+            next = mfc_sim_find_start_code(buf, size, pos);
+            if (mfc_sim_h264_parse_slice(buf + pos, ((next < 0) ? size : next - 3) - pos, pSps,
+                                         &idr, &ref, &pocLsb) != 0)
+                return -1;
+
+            if (idr) {
+                pInst->pocBase = pInst->pocMax + 2;
+                pInst->prevPocMsb = 0;
+                pInst->prevPocLsb = 0;
+            }
+
+            if (pSps->pocType == 0) {
+                maxPocLsb = 1 << pSps->log2MaxPocLsb;
+                if ((pocLsb < pInst->prevPocLsb) && (pInst->prevPocLsb - pocLsb >= maxPocLsb / 2))
+                    pocMsb = pInst->prevPocMsb + maxPocLsb;
+                else if ((pocLsb > pInst->prevPocLsb) && (pocLsb - pInst->prevPocLsb > maxPocLsb / 2))
+                    pocMsb = pInst->prevPocMsb - maxPocLsb;
+                else
+                    pocMsb = pInst->prevPocMsb;
+                if (ref) {
+                    pInst->prevPocMsb = pocMsb;
+                    pInst->prevPocLsb = pocLsb;
+                }
+                *pPoc = pInst->pocBase + pocMsb + pocLsb;
+            } else {
+                /* POC type 1 is not parsed, decoding order */
+                *pPoc = (idr) ? pInst->pocBase : pInst->pocMax + 2;
+            }
+
+            if (*pPoc > pInst->pocMax)
+                pInst->pocMax = *pPoc;
+
+            return (idr) ? MFC_SIM_CODING_I : MFC_SIM_CODING_P;
+        }
+        break;
+
+    case H263_DEC:
+        pos = mfc_sim_find_h263_picture(buf, size);
+        if (pos >= 0)
+            return mfc_sim_h263_parse_picture(buf + pos, size - pos, NULL);
+        break;
+
+    case MPEG1_DEC:
+    case MPEG2_DEC:
+        while ((pos = mfc_sim_find_start_code(buf, size, pos)) >= 0) {
+            if ((buf[pos] == 0x00) && (pos + 2 < size)) {
+                switch ((buf[pos + 2] >> 3) & 0x7) {    /* picture_coding_type */
+                case 1:
+                    return MFC_SIM_CODING_I;
+                case 3:
+                    return MFC_SIM_CODING_B;
+                default:
+                    return MFC_SIM_CODING_P;
+                }
+            }
+        }
+        break;
+
+    case FIMV1_DEC:
+    case VC1RCV_DEC:
+    case VC1_DEC:
+        return (size > 0) ? MFC_SIM_CODING_P : -1;
+
+    default:
+        if (mfc_sim_is_mpeg4(pInst->codecType)) {
+            while ((pos = mfc_sim_find_start_code(buf, size, pos)) >= 0) {
+                if ((buf[pos] == 0xB6) && (pos + 1 < size)) {
+                    switch (buf[pos + 1] >> 6) {        /* vop_coding_type */
+                    case 0:
+                        return MFC_SIM_CODING_I;
+                    case 2:
+                        return MFC_SIM_CODING_B;
+                    default:
+                        return MFC_SIM_CODING_P;
+                    }
+                }
+            }
+        }
+        break;
+    }
+
+    return -1;
+}
+
+static int mfc_sim_dec_get_slot(MFC_SIM_INSTANCE *pInst)
+{
+    int slot;
+    int i, j;
+
+    for (i = 0; i < pInst->frameNum; i++) {
+        slot = (pInst->nextSlot + i) % pInst->frameNum;
+        for (j = 0; j < pInst->pendingNum; j++) {
+            if (pInst->pending[j].slot == slot)
+                break;
+        }
+        if (j == pInst->pendingNum) {
+            pInst->nextSlot = (slot + 1) % pInst->frameNum;
+            return slot;
+        }
+    }
+
+    return -1;
+}
+
+/* Takes the held picture first in display order */
+static int mfc_sim_dec_pop(MFC_SIM_INSTANCE *pInst, MFC_SIM_PICTURE *pPicture)
+{
+    int min = 0;
+    int i;
+
+    if (pInst->pendingNum == 0)
+        return 0;
+
+    for (i = 1; i < pInst->pendingNum; i++) {
+        if (pInst->pending[i].poc < pInst->pending[min].poc)
+            min = i;
+    }
+
+    *pPicture = pInst->pending[min];
+    pInst->pendingNum--;
+    memmove(&pInst->pending[min], &pInst->pending[min + 1], (pInst->pendingNum - min) * sizeof(MFC_SIM_PICTURE));
+
+    return 1;
+}
+
+static void mfc_sim_dec_fill(MFC_SIM_INSTANCE *pInst, int slot, int tag)
+{
+    unsigned char *luma = pInst->base + (pInst->lumaPhys - pInst->phys) + (slot * pInst->lumaSize);
+    unsigned char *chroma = pInst->base + (pInst->chromaPhys - pInst->phys) + (slot * pInst->chromaSize);
+    unsigned int n;
+
+    for (n = 0; n < pInst->lumaSize / 2048; n++)
+        memset(luma + (n * 2048), MFC_SIM_FILL_VALUE(tag, n), 2048);
+    memset(chroma, 0x80, pInst->chromaSize);
+}
+
+SSBSIP_MFC_ERROR_CODE mfc_sim_dec_init(MFC_SIM_INSTANCE *pInst, mfc_dec_init_arg_t *pArg)
+{
+    MFC_SIM_SEQ_INFO *pSeq = &pInst->seq;
+    unsigned char *buf;
+    int window;
+    int frameNum;
+
+    buf = mfc_sim_phys_to_virt(pInst, pArg->in_strm_buf, pArg->in_strm_size);
+    if ((buf == NULL) || (pArg->in_strm_size <= 0)) {
+        LOGE("mfc_sim_dec_init: stream buffer is invalid\n");
+        return MFC_RET_DEC_INIT_FAIL;
+    }
+
+    if (pInst->lumaPhys != 0) {
+        mfc_sim_free(pInst, pInst->lumaPhys);
+        mfc_sim_free(pInst, pInst->chromaPhys);
+        pInst->lumaPhys = 0;
+        pInst->chromaPhys = 0;
+    }
+
+    pInst->codecType = pArg->in_codec_type;
+    if (mfc_sim_dec_parse_header(pInst, buf, pArg->in_strm_size, pSeq) != 0) {
+        LOGE("mfc_sim_dec_init: no supported sequence header, codec type %d\n", pInst->codecType);
+        return MFC_RET_DEC_INIT_FAIL;
+    }
+
+    if (pInst->codecType == H264_DEC) {
+        if (pInst->displayDelay >= 0)
+            window = pInst->displayDelay;
+        else
+            window = (pSeq->lowDelay) ? 0 : pSeq->refFrames;
+    } else {
+        window = ((pSeq->lowDelay) || (pInst->displayDelay == 0)) ? 0 : 1;
+    }
+
+    /* held pictures are in the DPB, extra buffers are for the ones displayed */
+    frameNum = ((window > pSeq->refFrames) ? window : pSeq->refFrames) + 1 + pInst->extraBufferNum;
+    if (frameNum > MFC_SIM_MAX_FRAME)
+        frameNum = MFC_SIM_MAX_FRAME;
+    if (window >= frameNum)
+        window = frameNum - 1;
+
+    pInst->lumaSize = ALIGN_TO_8KB(ALIGN_TO_128B(pSeq->width) * ALIGN_TO_32B(pSeq->height));
+    pInst->chromaSize = ALIGN_TO_8KB(ALIGN_TO_128B(pSeq->width) * ALIGN_TO_32B(pSeq->height / 2));
+
+    /* planes start 64KB aligned, the frames after the first if their size is a multiple of it */
+    if (mfc_sim_alloc(pInst, frameNum * pInst->lumaSize, 65536, &pInst->lumaPhys) != 0) {
+        LOGE("mfc_sim_dec_init: no memory for %d frames\n", frameNum);
+        pInst->lumaPhys = 0;
+        return MFC_RET_DEC_INIT_FAIL;
+    }
+    if (mfc_sim_alloc(pInst, frameNum * pInst->chromaSize, 65536, &pInst->chromaPhys) != 0) {
+        LOGE("mfc_sim_dec_init: no memory for %d frames\n", frameNum);
+        mfc_sim_free(pInst, pInst->lumaPhys);
+        pInst->lumaPhys = 0;
+        pInst->chromaPhys = 0;
+        return MFC_RET_DEC_INIT_FAIL;
+    }
+
+    pInst->frameNum = frameNum;
+    pInst->window = window;
+    pInst->nextSlot = 0;
+    pInst->pendingNum = 0;
+    pInst->pocBase = 0;
+    pInst->pocMax = 0;
+    pInst->prevPocMsb = 0;
+    pInst->prevPocLsb = 0;
+
+    pArg->out_img_width = pSeq->width;
+    pArg->out_img_height = pSeq->height;
+    pArg->out_buf_width = ALIGN_TO_128B(pSeq->width);
+    pArg->out_buf_height = ALIGN_TO_32B(pSeq->height);
+    pArg->out_dpb_cnt = frameNum;
+    pArg->out_crop_top_offset = pSeq->cropTop;
+    pArg->out_crop_bottom_offset = pSeq->cropBottom;
+    pArg->out_crop_left_offset = pSeq->cropLeft;
+    pArg->out_crop_right_offset = pSeq->cropRight;
+    pArg->out_u_addr.luma = mfc_sim_virt(pInst, pInst->lumaPhys);
+    pArg->out_u_addr.chroma = mfc_sim_virt(pInst, pInst->chromaPhys);
+    pArg->out_p_addr.luma = pInst->lumaPhys;
+    pArg->out_p_addr.chroma = pInst->chromaPhys;
+    pArg->out_frame_buf_size.luma = frameNum * pInst->lumaSize;
+    pArg->out_frame_buf_size.chroma = frameNum * pInst->chromaSize;
+
+    return MFC_RET_OK;
+}
+
+SSBSIP_MFC_ERROR_CODE mfc_sim_dec_exe(MFC_SIM_INSTANCE *pInst, mfc_dec_exe_arg_t *pArg, int *pMbNum)
+{
+    MFC_SIM_PICTURE picture;
+    MFC_SIM_PICTURE display;
+    unsigned char *buf = NULL;
+    int bDisplay = 0;
+    int codingType = -1;
+    int poc = 0;
+
+    if (pInst->lumaPhys == 0)
+        return MFC_RET_DEC_EXE_ERR;
+
+    if (pArg->in_strm_size > 0) {
+        buf = mfc_sim_phys_to_virt(pInst, pArg->in_strm_buf, pArg->in_strm_size);
+        if (buf == NULL) {
+            LOGE("mfc_sim_dec_exe: stream buffer is not in the mapped area\n");
+            return MFC_RET_DEC_EXE_ERR;
+        }
+        codingType = mfc_sim_dec_find_picture(pInst, buf, pArg->in_strm_size, &poc);
+    }
+
+    if (buf == NULL) {
+        /* end of stream, one held picture per run */
+        bDisplay = mfc_sim_dec_pop(pInst, &display);
+        pArg->out_display_status = (bDisplay) ? MFC_SIM_DISPLAY_ONLY : MFC_SIM_DISPLAY_END;
+    } else if (codingType >= 0) {
+        picture.slot = mfc_sim_dec_get_slot(pInst);
+        picture.tag = pArg->in_frametag;
+        picture.poc = poc;
+        if (picture.slot < 0)
+            return MFC_RET_DEC_EXE_ERR;
+
+        mfc_sim_dec_fill(pInst, picture.slot, picture.tag);
+        *pMbNum = ((pInst->seq.width + 15) / 16) * ((pInst->seq.height + 15) / 16);
+
+        if (pInst->codecType == H264_DEC) {
+            pInst->pending[pInst->pendingNum++] = picture;
+            if (pInst->pendingNum > pInst->window)
+                bDisplay = mfc_sim_dec_pop(pInst, &display);
+        } else if ((pInst->window == 0) || (codingType == MFC_SIM_CODING_B)) {
+            display = picture;
+            bDisplay = 1;
+        } else {
+            bDisplay = mfc_sim_dec_pop(pInst, &display);
+            pInst->pending[pInst->pendingNum++] = picture;
+        }
+        pArg->out_display_status = (bDisplay) ? MFC_SIM_DISPLAY_DECODING : MFC_SIM_DECODING_ONLY;
+    } else {
+        /* headers only */
+        pArg->out_display_status = MFC_SIM_DECODING_ONLY;
+    }
+
+    if (bDisplay) {
+        pArg->out_display_Y_addr = pInst->lumaPhys + (display.slot * pInst->lumaSize);
+        pArg->out_display_C_addr = pInst->chromaPhys + (display.slot * pInst->chromaSize);
+        pArg->out_frametag_top = display.tag;
+        pArg->out_frametag_bottom = display.tag;
+    } else {
+        pArg->out_display_Y_addr = pInst->lumaPhys;
+        pArg->out_display_C_addr = pInst->chromaPhys;
+        pArg->out_frametag_top = -1;
+        pArg->out_frametag_bottom = -1;
+    }
+
+    pArg->out_timestamp_top = 0;
+    pArg->out_timestamp_bottom = 0;
+    pArg->out_consume_bytes = pArg->in_strm_size;
+    pArg->out_res_change = 0;
+    pArg->out_crop_top_offset = pInst->seq.cropTop;
+    pArg->out_crop_bottom_offset = pInst->seq.cropBottom;
+    pArg->out_crop_left_offset = pInst->seq.cropLeft;
+    pArg->out_crop_right_offset = pInst->seq.cropRight;
+
+    return MFC_RET_OK;
+}
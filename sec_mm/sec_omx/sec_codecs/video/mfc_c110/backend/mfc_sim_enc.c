@@ -0,0 +1,400 @@
+/*
+ *
+ * Copyright 2011 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    mfc_sim_enc.c
+ * @brief   Encoder of the MFC simulator
+ *   IOCTL_MFC_ENC_INIT writes a sequence header the simulated decoder
+ *   accepts, IOCTL_MFC_ENC_EXE one I or P picture: a real picture header
+ *   and filler that never forms a start code. With rate control the
+ *   pictures average the bit rate with I pictures three times the size of
+ *   P pictures, without it the size follows the QP. The input frame is
+ *   not read, only checked to be in MFC memory and, outside the own input
+ *   buffer, 64KB aligned. B frames are not produced.
+ * @version 1.0
+ */
+
+#include <string.h>
+#include <utils/Log.h>
+
+#include "mfc_sim.h"
+
+#define MFC_SIM_HEADER_MAX          64
+#define MFC_SIM_I_FRAME_WEIGHT      3
+#define MFC_SIM_DEFAULT_FRAME_RATE  30
+#define MFC_SIM_DEFAULT_GOP         30
+
+/* out_frame_type */
+#define MFC_SIM_FRAME_NOT_CODED     0
+#define MFC_SIM_FRAME_I             1
+#define MFC_SIM_FRAME_P             2
+
+static int mfc_sim_h263_source_format(int width, int height)
+{
+    static const int width_table[]  = { 128, 176, 352, 704, 1408 };
+    static const int height_table[] = {  96, 144, 288, 576, 1152 };
+    unsigned int i;
+
+    for (i = 0; i < sizeof(width_table) / sizeof(width_table[0]); i++) {
+        if ((width == width_table[i]) && (height == height_table[i]))
+            return i + 1;
+    }
+
+    return -1;
+}
+
+static int mfc_sim_mpeg4_time_bits(int resolution)
+{
+    int n;
+
+    for (n = 1; (1 << n) < resolution; n++)
+        ;
+
+    return n;
+}
+
+/* MPEG-4 next_start_code stuffing, returns bytes written */
+static int mfc_sim_mpeg4_stuffing(MFC_SIM_BITS *pBits)
+{
+    mfc_sim_bits_put(pBits, 0, 1);
+    if (pBits->pos & 7)
+        mfc_sim_bits_put(pBits, 0xFF, 8 - (pBits->pos & 7));
+
+    return pBits->pos >> 3;
+}
+
+static int mfc_sim_enc_put_header(MFC_SIM_INSTANCE *pInst, unsigned char *dest, int destSize)
+{
+    unsigned char rbsp[MFC_SIM_HEADER_MAX];
+    MFC_SIM_BITS bits;
+    int widthMbs = (pInst->width + 15) / 16;
+    int heightMbs = (pInst->height + 15) / 16;
+    int len, ret;
+
+    memset(rbsp, 0, sizeof(rbsp));
+    bits.buf = rbsp;
+    bits.size = sizeof(rbsp);
+    bits.pos = 0;
+
+    switch (pInst->codecType) {
+    case H264_ENC:
+        /* Baseline, POC type 2 so the display order is the encoding order */
+        mfc_sim_bits_put(&bits, 66, 8);             /* profile_idc */
+        mfc_sim_bits_put(&bits, 0xC0, 8);           /* constraint_set0_flag, constraint_set1_flag */
+        mfc_sim_bits_put(&bits, 31, 8);             /* level_idc */
+        mfc_sim_bits_put_ue(&bits, 0);              /* seq_parameter_set_id */
+        mfc_sim_bits_put_ue(&bits, 0);              /* log2_max_frame_num_minus4 */
+        mfc_sim_bits_put_ue(&bits, 2);              /* pic_order_cnt_type */
+        mfc_sim_bits_put_ue(&bits, 1);              /* max_num_ref_frames */
+        mfc_sim_bits_put(&bits, 0, 1);              /* gaps_in_frame_num_value_allowed_flag */
+        mfc_sim_bits_put_ue(&bits, widthMbs - 1);
+        mfc_sim_bits_put_ue(&bits, heightMbs - 1);
+        mfc_sim_bits_put(&bits, 1, 1);              /* frame_mbs_only_flag */
+        mfc_sim_bits_put(&bits, 1, 1);              /* direct_8x8_inference_flag */
+        if (((pInst->width & 15) != 0) || ((pInst->height & 15) != 0)) {
+            mfc_sim_bits_put(&bits, 1, 1);          /* frame_cropping_flag */
+            mfc_sim_bits_put_ue(&bits, 0);
+            mfc_sim_bits_put_ue(&bits, (widthMbs * 16 - pInst->width) / 2);
+            mfc_sim_bits_put_ue(&bits, 0);
+            mfc_sim_bits_put_ue(&bits, (heightMbs * 16 - pInst->height) / 2);
+        } else {
+            mfc_sim_bits_put(&bits, 0, 1);
+        }
+        mfc_sim_bits_put(&bits, 0, 1);              /* vui_parameters_present_flag */
+        len = mfc_sim_put_nal(dest, destSize, 0x67, rbsp, mfc_sim_bits_trailing(&bits));
+        if (len < 0)
+            return -1;
+
+        memset(rbsp, 0, sizeof(rbsp));
+        bits.pos = 0;
+        mfc_sim_bits_put_ue(&bits, 0);              /* pic_parameter_set_id */
+        mfc_sim_bits_put_ue(&bits, 0);              /* seq_parameter_set_id */
+        mfc_sim_bits_put(&bits, 0, 2);              /* entropy_coding_mode_flag, bottom_field_pic_order_in_frame_present_flag */
+        mfc_sim_bits_put_ue(&bits, 0);              /* num_slice_groups_minus1 */
+        mfc_sim_bits_put_ue(&bits, 0);              /* num_ref_idx_l0_default_active_minus1 */
+        mfc_sim_bits_put_ue(&bits, 0);              /* num_ref_idx_l1_default_active_minus1 */
+        mfc_sim_bits_put(&bits, 0, 3);              /* weighted_pred_flag, weighted_bipred_idc */
+        mfc_sim_bits_put_ue(&bits, 0);              /* pic_init_qp_minus26 */
+        mfc_sim_bits_put_ue(&bits, 0);              /* pic_init_qs_minus26 */
+        mfc_sim_bits_put_ue(&bits, 0);              /* chroma_qp_index_offset */
+        mfc_sim_bits_put(&bits, 1, 1);              /* deblocking_filter_control_present_flag */
+        mfc_sim_bits_put(&bits, 0, 2);              /* constrained_intra_pred_flag, redundant_pic_cnt_present_flag */
+        ret = mfc_sim_put_nal(dest + len, destSize - len, 0x68, rbsp, mfc_sim_bits_trailing(&bits));
+        if (ret < 0)
+            return -1;
+
+        return len + ret;
+
+    case MPEG4_ENC:
+        if (destSize < MFC_SIM_HEADER_MAX + 14)
+            return -1;
+        /* Simple Profile visual object sequence, visual object, video object */
+        memcpy(dest, "\x00\x00\x01\xB0\x03\x00\x00\x01\xB5\x09\x00\x00\x01\x00\x00\x00\x01\x20", 18);
+        mfc_sim_bits_put(&bits, 0, 1);              /* random_accessible_vol */
+        mfc_sim_bits_put(&bits, 1, 8);              /* video_object_type_indication, Simple */
+        mfc_sim_bits_put(&bits, 0, 1);              /* is_object_layer_identifier */
+        mfc_sim_bits_put(&bits, 1, 4);              /* aspect_ratio_info, square */
+        mfc_sim_bits_put(&bits, 0, 1);              /* vol_control_parameters */
+        mfc_sim_bits_put(&bits, 0, 2);              /* video_object_layer_shape, rectangular */
+        mfc_sim_bits_put(&bits, 1, 1);
+        mfc_sim_bits_put(&bits, pInst->frameRate, 16);  /* vop_time_increment_resolution */
+        mfc_sim_bits_put(&bits, 1, 1);
+        mfc_sim_bits_put(&bits, 0, 1);              /* fixed_vop_rate */
+        mfc_sim_bits_put(&bits, 1, 1);
+        mfc_sim_bits_put(&bits, pInst->width, 13);
+        mfc_sim_bits_put(&bits, 1, 1);
+        mfc_sim_bits_put(&bits, pInst->height, 13);
+        mfc_sim_bits_put(&bits, 1, 1);
+        mfc_sim_bits_put(&bits, 0, 1);              /* interlaced */
+        mfc_sim_bits_put(&bits, 1, 1);              /* obmc_disable */
+        mfc_sim_bits_put(&bits, 0, 3);              /* sprite_enable, not_8_bit, quant_type */
+        mfc_sim_bits_put(&bits, 1, 2);              /* complexity_estimation_disable, resync_marker_disable */
+        mfc_sim_bits_put(&bits, 0, 2);              /* data_partitioned, scalability */
+        len = mfc_sim_mpeg4_stuffing(&bits);
+        memcpy(dest + 18, rbsp, len);
+
+        return 18 + len;
+
+    default:
+        /* H.263 has no sequence header */
+        return 0;
+    }
+}
+
+static int mfc_sim_enc_put_picture(MFC_SIM_INSTANCE *pInst, unsigned char *dest, int destSize, int frameType, int frameSize)
+{
+    unsigned char rbsp[MFC_SIM_HEADER_MAX];
+    MFC_SIM_BITS bits;
+    unsigned int seed = (unsigned int)pInst->encodeCount * 2654435761U;
+    int bIntra = (frameType == MFC_SIM_FRAME_I);
+    int len = 0;
+    int headerLen;
+
+    memset(rbsp, 0, sizeof(rbsp));
+    bits.buf = rbsp;
+    bits.size = sizeof(rbsp);
+    bits.pos = 0;
+
+    switch (pInst->codecType) {
+    case H264_ENC:
+        mfc_sim_bits_put_ue(&bits, 0);              /* first_mb_in_slice */
+        mfc_sim_bits_put_ue(&bits, (bIntra) ? 7 : 5);   /* slice_type, I or P */
+        mfc_sim_bits_put_ue(&bits, 0);              /* pic_parameter_set_id */
+        mfc_sim_bits_put(&bits, pInst->frameNum & 15, 4);   /* frame_num */
+        if (bIntra)
+            mfc_sim_bits_put_ue(&bits, 0);          /* idr_pic_id */
+        headerLen = (bits.pos + 7) >> 3;
+        /* filler is odd, no byte of it needs emulation prevention */
+        memset(rbsp + headerLen, 0x55, 4);
+        len = mfc_sim_put_nal(dest, destSize, (bIntra) ? 0x65 : 0x41, rbsp, headerLen + 4);
+        break;
+
+    case MPEG4_ENC:
+        memcpy(rbsp, "\x00\x00\x01\xB6", 4);
+        bits.pos = 32;
+        mfc_sim_bits_put(&bits, (bIntra) ? 0 : 1, 2);   /* vop_coding_type */
+        mfc_sim_bits_put(&bits, 0, 1);              /* modulo_time_base */
+        mfc_sim_bits_put(&bits, 1, 1);
+        mfc_sim_bits_put(&bits, pInst->frameNum % pInst->frameRate, mfc_sim_mpeg4_time_bits(pInst->frameRate));
+        mfc_sim_bits_put(&bits, 1, 1);
+        mfc_sim_bits_put(&bits, 1, 1);              /* vop_coded */
+        len = (bits.pos + 7) >> 3;
+        rbsp[len - 1] |= 0xFF >> (bits.pos & 7 ? bits.pos & 7 : 8);
+        break;
+
+    case H263_ENC:
+        bits.pos = 16;                              /* picture start code */
+        mfc_sim_bits_put(&bits, 0x20, 6);
+        mfc_sim_bits_put(&bits, pInst->frameNum & 0xFF, 8);  /* temporal reference */
+        mfc_sim_bits_put(&bits, 0x10, 5);           /* PTYPE 1 0, split screen, camera, freeze */
+        mfc_sim_bits_put(&bits, mfc_sim_h263_source_format(pInst->width, pInst->height), 3);
+        mfc_sim_bits_put(&bits, (bIntra) ? 0 : 1, 1);
+        len = (bits.pos + 7) >> 3;
+        rbsp[len - 1] |= 0xFF >> (bits.pos & 7 ? bits.pos & 7 : 8);
+        break;
+
+    default:
+        return -1;
+    }
+
+    if ((len < 0) || (len > destSize))
+        return -1;
+    if (pInst->codecType != H264_ENC)
+        memcpy(dest, rbsp, len);
+
+    if (frameSize > destSize)
+        frameSize = destSize;
+
+    /* no zero byte, so no start code */
+    for (; len < frameSize; len++) {
+        seed = (seed * 1103515245) + 12345;
+        dest[len] = (unsigned char)(seed >> 24) | 0x01;
+    }
+
+    return len;
+}
+
+/* Bytes of the next picture, for the rate or the QP */
+static int mfc_sim_enc_frame_size(MFC_SIM_INSTANCE *pInst, int frameType)
+{
+    int mbNum = ((pInst->width + 15) / 16) * ((pInst->height + 15) / 16);
+    int gopNum = (pInst->gopNum > 0) ? pInst->gopNum : MFC_SIM_DEFAULT_GOP;
+    int frameRate = (pInst->frameRate > 0) ? pInst->frameRate : MFC_SIM_DEFAULT_FRAME_RATE;
+    long long size;
+
+    if (frameType == MFC_SIM_FRAME_NOT_CODED)
+        return 0;
+
+    if ((pInst->rcEnable) && (pInst->bitRate > 0)) {
+        /* gopNum pictures of the GOP carry gopNum + MFC_SIM_I_FRAME_WEIGHT - 1 P picture sizes */
+        size = ((long long)pInst->bitRate / 8) * gopNum / (frameRate * (gopNum + MFC_SIM_I_FRAME_WEIGHT - 1));
+    } else if (pInst->codecType == H264_ENC) {
+        size = ((long long)mbNum * 400) >> ((pInst->frameQp > 0) ? pInst->frameQp / 6 : 0);
+    } else {
+        size = ((long long)mbNum * 200) / ((pInst->frameQp > 0) ? pInst->frameQp : 1);
+    }
+
+    if (frameType == MFC_SIM_FRAME_I)
+        size *= MFC_SIM_I_FRAME_WEIGHT;
+
+    return (size > MAX_ENCODER_OUTPUT_BUFFER_SIZE) ? MAX_ENCODER_OUTPUT_BUFFER_SIZE : (int)size;
+}
+
+SSBSIP_MFC_ERROR_CODE mfc_sim_enc_init(MFC_SIM_INSTANCE *pInst, mfc_enc_init_mpeg4_arg_t *pArg, int mbRcEnable)
+{
+    unsigned int lumaSize, chromaSize, refSize;
+    int headerSize;
+
+    pInst->codecType = pArg->in_codec_type;
+    pInst->width = pArg->in_width;
+    pInst->height = pArg->in_height;
+    pInst->gopNum = pArg->in_gop_num;
+    pInst->frameQp = pArg->in_frame_qp;
+    pInst->rcEnable = (pArg->in_RC_frm_enable != 0) || (mbRcEnable != 0);
+    pInst->frameRate = (pArg->in_RC_framerate > 0) ? pArg->in_RC_framerate : MFC_SIM_DEFAULT_FRAME_RATE;
+    pInst->bitRate = pArg->in_RC_bitrate;
+    pInst->forceFrameType = DONT_CARE;
+    pInst->encodeCount = 0;
+    pInst->frameNum = 0;
+
+    if ((pInst->width <= 0) || (pInst->height <= 0) ||
+        (((pInst->width + 15) / 16) * ((pInst->height + 15) / 16) > (1920 / 16) * (1088 / 16)) ||
+        ((pInst->codecType != H264_ENC) && (pInst->codecType != MPEG4_ENC) && (pInst->codecType != H263_ENC)) ||
+        ((pInst->codecType == H263_ENC) && (mfc_sim_h263_source_format(pInst->width, pInst->height) < 0))) {
+        LOGE("mfc_sim_enc_init: %dx%d is not supported, codec type %d\n", pInst->width, pInst->height, pInst->codecType);
+        return MFC_RET_ENC_INIT_FAIL;
+    }
+
+    /* two reconstructed frames and the motion vectors */
+    lumaSize = ALIGN_TO_8KB(ALIGN_TO_128B(pInst->width) * ALIGN_TO_32B(pInst->height));
+    chromaSize = ALIGN_TO_8KB(ALIGN_TO_128B(pInst->width) * ALIGN_TO_32B(pInst->height / 2));
+    refSize = 2 * (lumaSize + chromaSize) + ALIGN_TO_8KB(((pInst->width + 15) / 16) * ((pInst->height + 15) / 16) * 16);
+
+    if (mfc_sim_alloc(pInst, MAX_ENCODER_OUTPUT_BUFFER_SIZE, 2048, &pInst->strmPhys) != 0) {
+        LOGE("mfc_sim_enc_init: no memory for the stream buffer\n");
+        return MFC_RET_ENC_INIT_FAIL;
+    }
+    if (mfc_sim_alloc(pInst, refSize, 8192, &pInst->refPhys) != 0) {
+        LOGE("mfc_sim_enc_init: no memory for the reference frames\n");
+        mfc_sim_free(pInst, pInst->strmPhys);
+        return MFC_RET_ENC_INIT_FAIL;
+    }
+
+    headerSize = mfc_sim_enc_put_header(pInst, mfc_sim_phys_to_virt(pInst, pInst->strmPhys, MAX_ENCODER_OUTPUT_BUFFER_SIZE),
+                                        MAX_ENCODER_OUTPUT_BUFFER_SIZE);
+    if (headerSize < 0) {
+        mfc_sim_free(pInst, pInst->refPhys);
+        mfc_sim_free(pInst, pInst->strmPhys);
+        return MFC_RET_ENC_INIT_FAIL;
+    }
+
+    pArg->out_u_addr.strm_ref_y = mfc_sim_virt(pInst, pInst->strmPhys);
+    pArg->out_u_addr.mv_ref_yc = mfc_sim_virt(pInst, pInst->refPhys);
+    pArg->out_p_addr.strm_ref_y = pInst->strmPhys;
+    pArg->out_p_addr.mv_ref_yc = pInst->refPhys;
+    pArg->out_buf_size.strm_ref_y = MAX_ENCODER_OUTPUT_BUFFER_SIZE;
+    pArg->out_buf_size.mv_ref_yc = refSize;
+    pArg->out_header_size = headerSize;
+
+    return MFC_RET_OK;
+}
+
+SSBSIP_MFC_ERROR_CODE mfc_sim_enc_exe(MFC_SIM_INSTANCE *pInst, mfc_enc_exe_arg *pArg, int *pMbNum)
+{
+    unsigned char *dest;
+    int destSize;
+    int frameType;
+    int size;
+
+    if (pInst->strmPhys == 0)
+        return MFC_RET_ENC_EXE_ERR;
+
+    destSize = (int)(pArg->in_strm_end - pArg->in_strm_st);
+    dest = mfc_sim_phys_to_virt(pInst, pArg->in_strm_st, destSize);
+    if ((dest == NULL) || (destSize <= 0)) {
+        LOGE("mfc_sim_enc_exe: stream buffer is not in the mapped area\n");
+        return MFC_RET_ENC_EXE_ERR;
+    }
+
+    /* input may be in the frame buffers of a decoder instance, anywhere else is a bad address */
+    if ((mfc_sim_phys_to_virt_any(pArg->in_Y_addr, pInst->width * pInst->height) == NULL) ||
+        (mfc_sim_phys_to_virt_any(pArg->in_CbCr_addr, (pInst->width * pInst->height) / 2) == NULL)) {
+        LOGE("mfc_sim_enc_exe: input frame is not in the mapped area\n");
+        return MFC_RET_ENC_EXE_ERR;
+    }
+
+    /* a frame set with SsbSipMfcEncSetInBuf is read only at 64KB aligned addresses */
+    if ((mfc_sim_phys_to_virt(pInst, pArg->in_Y_addr, pInst->width * pInst->height) == NULL) &&
+        (((pArg->in_Y_addr | pArg->in_CbCr_addr) & 0xFFFF) != 0)) {
+        LOGE("mfc_sim_enc_exe: input frame at 0x%x/0x%x is not 64KB aligned\n",
+             pArg->in_Y_addr, pArg->in_CbCr_addr);
+        return MFC_RET_ENC_EXE_ERR;
+    }
+
+    if (pInst->forceFrameType == NOT_CODED)
+        frameType = MFC_SIM_FRAME_NOT_CODED;
+    else if ((pInst->encodeCount == 0) || (pInst->forceFrameType == I_FRAME) ||
+             ((pInst->gopNum > 0) && (pInst->frameNum >= pInst->gopNum)))
+        frameType = MFC_SIM_FRAME_I;
+    else
+        frameType = MFC_SIM_FRAME_P;
+    pInst->forceFrameType = DONT_CARE;
+
+    if (frameType == MFC_SIM_FRAME_I)
+        pInst->frameNum = 0;
+
+    if (frameType == MFC_SIM_FRAME_NOT_CODED) {
+        size = 0;
+    } else {
+        size = mfc_sim_enc_put_picture(pInst, dest, destSize, frameType, mfc_sim_enc_frame_size(pInst, frameType));
+        if (size < 0)
+            return MFC_RET_ENC_EXE_ERR;
+        pInst->frameNum++;
+    }
+    pInst->encodeCount++;
+
+    *pMbNum = ((pInst->width + 15) / 16) * ((pInst->height + 15) / 16);
+
+    pArg->out_frame_type = frameType;
+    pArg->out_encoded_size = size;
+    pArg->out_encoded_Y_paddr = pArg->in_Y_addr;
+    pArg->out_encoded_C_paddr = pArg->in_CbCr_addr;
+    pArg->out_frametag_top = pArg->in_frametag;
+    pArg->out_frametag_bottom = pArg->in_frametag;
+
+    return MFC_RET_OK;
+}
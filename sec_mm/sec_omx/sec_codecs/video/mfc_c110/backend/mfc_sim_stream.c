@@ -0,0 +1,493 @@
+/*
+ *
+ * Copyright 2011 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    mfc_sim_stream.c
+ * @brief   Bitstream reading and writing for the MFC simulator
+ *   Only the header fields the simulator needs are parsed: picture size,
+ *   cropping, references and what gives the display order.
+ * @version 1.0
+ */
+
+#include <string.h>
+
+#include "mfc_sim.h"
+
+/* Largest parameter set or slice header prefix copied out of the stream */
+#define MFC_SIM_RBSP_MAX    512
+
+/* MFC can not decode more than 1920x1088 */
+#define MFC_SIM_MAX_MB_NUM  ((1920 / 16) * (1088 / 16))
+
+static const int mfc_sim_h263_width[8]  = { 0, 128, 176, 352, 704, 1408, 0, 0 };
+static const int mfc_sim_h263_height[8] = { 0,  96, 144, 288, 576, 1152, 0, 0 };
+
+/*
+ * Returns index of the byte after the next 00 00 01 at or after pos,
+ * -1 if there is none or nothing follows it
+ */
+int mfc_sim_find_start_code(const unsigned char *buf, int size, int pos)
+{
+    int i;
+
+    for (i = pos; i + 3 < size; i++) {
+        if (buf[i + 2] > 1) {
+            i += 2;
+            continue;
+        }
+        if ((buf[i] == 0) && (buf[i + 1] == 0) && (buf[i + 2] == 1))
+            return i + 3;
+    }
+
+    return -1;
+}
+
+/* Reads n bits, 0 past the end */
+unsigned int mfc_sim_bits_get(MFC_SIM_BITS *pBits, int n)
+{
+    unsigned int value = 0;
+    int i;
+
+    for (i = 0; i < n; i++) {
+        value <<= 1;
+        if (pBits->pos < pBits->size * 8)
+            value |= (pBits->buf[pBits->pos >> 3] >> (7 - (pBits->pos & 7))) & 1;
+        pBits->pos++;
+    }
+
+    return value;
+}
+
+unsigned int mfc_sim_bits_get_ue(MFC_SIM_BITS *pBits)
+{
+    int zeros = 0;
+
+    while ((mfc_sim_bits_get(pBits, 1) == 0) && (zeros < 31))
+        zeros++;
+
+    if (zeros == 0)
+        return 0;
+
+    return ((1U << zeros) - 1) + mfc_sim_bits_get(pBits, zeros);
+}
+
+int mfc_sim_bits_get_se(MFC_SIM_BITS *pBits)
+{
+    unsigned int code = mfc_sim_bits_get_ue(pBits);
+
+    if (code & 1)
+        return (int)((code + 1) >> 1);
+
+    return -(int)(code >> 1);
+}
+
+/* Writes n bits, nothing past the end */
+void mfc_sim_bits_put(MFC_SIM_BITS *pBits, unsigned int value, int n)
+{
+    unsigned char mask;
+    int i;
+
+    for (i = n - 1; i >= 0; i--) {
+        if (pBits->pos < pBits->size * 8) {
+            mask = 0x80 >> (pBits->pos & 7);
+            if ((value >> i) & 1)
+                pBits->buf[pBits->pos >> 3] |= mask;
+            else
+                pBits->buf[pBits->pos >> 3] &= ~mask;
+        }
+        pBits->pos++;
+    }
+}
+
+void mfc_sim_bits_put_ue(MFC_SIM_BITS *pBits, unsigned int value)
+{
+    unsigned int code = value + 1;
+    int len = 0;
+
+    while ((code >> len) > 1)
+        len++;
+
+    mfc_sim_bits_put(pBits, 0, len);
+    mfc_sim_bits_put(pBits, code, len + 1);
+}
+
+/* Writes rbsp trailing bits, returns bytes written */
+int mfc_sim_bits_trailing(MFC_SIM_BITS *pBits)
+{
+    mfc_sim_bits_put(pBits, 1, 1);
+    if (pBits->pos & 7)
+        mfc_sim_bits_put(pBits, 0, 8 - (pBits->pos & 7));
+
+    return pBits->pos >> 3;
+}
+
+/* Copies at most max bytes of NAL payload, removing emulation prevention bytes */
+static int mfc_sim_h264_unescape(const unsigned char *src, int size, unsigned char *rbsp, int max)
+{
+    int zeros = 0;
+    int len = 0;
+    int i;
+
+    for (i = 0; (i < size) && (len < max); i++) {
+        if ((zeros >= 2) && (src[i] == 0x03)) {
+            zeros = 0;
+            continue;
+        }
+        zeros = (src[i] == 0) ? zeros + 1 : 0;
+        rbsp[len++] = src[i];
+    }
+
+    return len;
+}
+
+static void mfc_sim_h264_skip_scaling_list(MFC_SIM_BITS *pBits, int size)
+{
+    int lastScale = 8;
+    int nextScale = 8;
+    int i;
+
+    for (i = 0; i < size; i++) {
+        if (nextScale != 0)
+            nextScale = (lastScale + mfc_sim_bits_get_se(pBits) + 256) % 256;
+        lastScale = (nextScale == 0) ? lastScale : nextScale;
+    }
+}
+
+/*
+ * Parses H.264 sequence parameter set
+ *
+ * @param nal
+ *   NAL unit, starting with the NAL header[in]
+ *
+ * @return
+ *   0 on success, -1 if the picture size is not supported
+ */
+int mfc_sim_h264_parse_sps(const unsigned char *nal, int size, MFC_SIM_SEQ_INFO *pSeq)
+{
+    unsigned char rbsp[MFC_SIM_RBSP_MAX];
+    MFC_SIM_BITS bits;
+    MFC_SIM_H264_SPS *pSps = &pSeq->sps;
+    int profile;
+    int chromaFormat = 1;
+    int widthMbs, heightMapUnits;
+    int cropUnitX, cropUnitY;
+    int i, n;
+
+    memset(pSeq, 0, sizeof(MFC_SIM_SEQ_INFO));
+    bits.buf = rbsp;
+    bits.size = mfc_sim_h264_unescape(nal + 1, size - 1, rbsp, sizeof(rbsp));
+    bits.pos = 0;
+
+    profile = mfc_sim_bits_get(&bits, 8);
+    mfc_sim_bits_get(&bits, 16);                    /* constraint flags, level */
+    mfc_sim_bits_get_ue(&bits);                     /* seq_parameter_set_id */
+
+    if ((profile == 100) || (profile == 110) || (profile == 122) || (profile == 244) ||
+        (profile == 44) || (profile == 83) || (profile == 86) || (profile == 118) ||
+        (profile == 128)) {
+        chromaFormat = mfc_sim_bits_get_ue(&bits);
+        if (chromaFormat == 3)
+            pSps->separateColourPlane = mfc_sim_bits_get(&bits, 1);
+        mfc_sim_bits_get_ue(&bits);                 /* bit_depth_luma_minus8 */
+        mfc_sim_bits_get_ue(&bits);                 /* bit_depth_chroma_minus8 */
+        mfc_sim_bits_get(&bits, 1);                 /* qpprime_y_zero_transform_bypass_flag */
+        if (mfc_sim_bits_get(&bits, 1)) {           /* seq_scaling_matrix_present_flag */
+            for (i = 0; i < ((chromaFormat != 3) ? 8 : 12); i++) {
+                if (mfc_sim_bits_get(&bits, 1))
+                    mfc_sim_h264_skip_scaling_list(&bits, (i < 6) ? 16 : 64);
+            }
+        }
+    }
+
+    pSps->log2MaxFrameNum = mfc_sim_bits_get_ue(&bits) + 4;
+    pSps->pocType = mfc_sim_bits_get_ue(&bits);
+    if (pSps->pocType == 0) {
+        pSps->log2MaxPocLsb = mfc_sim_bits_get_ue(&bits) + 4;
+    } else if (pSps->pocType == 1) {
+        mfc_sim_bits_get(&bits, 1);                 /* delta_pic_order_always_zero_flag */
+        mfc_sim_bits_get_se(&bits);                 /* offset_for_non_ref_pic */
+        mfc_sim_bits_get_se(&bits);                 /* offset_for_top_to_bottom_field */
+        n = mfc_sim_bits_get_ue(&bits);
+        for (i = 0; (i < n) && (i < 256); i++)
+            mfc_sim_bits_get_se(&bits);
+    }
+
+    pSps->maxRefFrames = mfc_sim_bits_get_ue(&bits);
+    mfc_sim_bits_get(&bits, 1);                     /* gaps_in_frame_num_value_allowed_flag */
+    widthMbs = mfc_sim_bits_get_ue(&bits) + 1;
+    heightMapUnits = mfc_sim_bits_get_ue(&bits) + 1;
+    pSps->frameMbsOnly = mfc_sim_bits_get(&bits, 1);
+    if (pSps->frameMbsOnly == 0)
+        mfc_sim_bits_get(&bits, 1);                 /* mb_adaptive_frame_field_flag */
+    mfc_sim_bits_get(&bits, 1);                     /* direct_8x8_inference_flag */
+    if ((widthMbs > MFC_SIM_MAX_MB_NUM) || (heightMapUnits > MFC_SIM_MAX_MB_NUM))
+        return -1;
+
+    pSeq->width = widthMbs * 16;
+    pSeq->height = heightMapUnits * 16 * (2 - pSps->frameMbsOnly);
+
+    if (mfc_sim_bits_get(&bits, 1)) {               /* frame_cropping_flag */
+        cropUnitX = ((chromaFormat == 0) || (chromaFormat == 3) || pSps->separateColourPlane) ? 1 : 2;
+        cropUnitY = ((chromaFormat == 1) && (pSps->separateColourPlane == 0)) ? 2 : 1;
+        cropUnitY *= 2 - pSps->frameMbsOnly;
+        pSeq->cropLeft = mfc_sim_bits_get_ue(&bits) * cropUnitX;
+        pSeq->cropRight = mfc_sim_bits_get_ue(&bits) * cropUnitX;
+        pSeq->cropTop = mfc_sim_bits_get_ue(&bits) * cropUnitY;
+        pSeq->cropBottom = mfc_sim_bits_get_ue(&bits) * cropUnitY;
+    }
+
+    if ((bits.pos > bits.size * 8) ||
+        ((pSeq->width / 16) * (pSeq->height / 16) > MFC_SIM_MAX_MB_NUM) ||
+        (pSps->maxRefFrames > MFC_SIM_MAX_REF) ||
+        (pSps->log2MaxFrameNum > 16) || (pSps->log2MaxPocLsb > 16) ||
+        (pSeq->cropLeft + pSeq->cropRight >= pSeq->width) ||
+        (pSeq->cropTop + pSeq->cropBottom >= pSeq->height))
+        return -1;
+
+    pSeq->refFrames = (pSps->maxRefFrames > 0) ? pSps->maxRefFrames : 1;
+    pSeq->lowDelay = (pSps->pocType == 2);
+
+    return 0;
+}
+
+/*
+ * Parses the start of H.264 slice header
+ *
+ * @param nal
+ *   Coded slice NAL unit, starting with the NAL header[in]
+ *
+ * @param pPocLsb
+ *   pic_order_cnt_lsb, 0 if the POC type of the sequence is not 0[out]
+ */
+int mfc_sim_h264_parse_slice(const unsigned char *nal, int size, const MFC_SIM_H264_SPS *pSps,
+                             int *pIdr, int *pRef, int *pPocLsb)
+{
+    unsigned char rbsp[32];
+    MFC_SIM_BITS bits;
+
+    if (size < 2)
+        return -1;
+
+    *pIdr = ((nal[0] & 0x1F) == 5);
+    *pRef = ((nal[0] >> 5) & 0x3) != 0;
+    *pPocLsb = 0;
+
+    bits.buf = rbsp;
+    bits.size = mfc_sim_h264_unescape(nal + 1, size - 1, rbsp, sizeof(rbsp));
+    bits.pos = 0;
+
+    mfc_sim_bits_get_ue(&bits);                     /* first_mb_in_slice */
+    mfc_sim_bits_get_ue(&bits);                     /* slice_type */
+    mfc_sim_bits_get_ue(&bits);                     /* pic_parameter_set_id */
+    if (pSps->separateColourPlane)
+        mfc_sim_bits_get(&bits, 2);                 /* colour_plane_id */
+    mfc_sim_bits_get(&bits, pSps->log2MaxFrameNum); /* frame_num */
+    if ((pSps->frameMbsOnly == 0) && mfc_sim_bits_get(&bits, 1))
+        mfc_sim_bits_get(&bits, 1);                 /* field_pic_flag, bottom_field_flag */
+    if (*pIdr)
+        mfc_sim_bits_get_ue(&bits);                 /* idr_pic_id */
+    if (pSps->pocType == 0)
+        *pPocLsb = mfc_sim_bits_get(&bits, pSps->log2MaxPocLsb);
+
+    return (bits.pos > bits.size * 8) ? -1 : 0;
+}
+
+/*
+ * Parses MPEG-4 video object layer header
+ *
+ * @param buf
+ *   Header after the video_object_layer_start_code[in]
+ */
+int mfc_sim_mpeg4_parse_vol(const unsigned char *buf, int size, MFC_SIM_SEQ_INFO *pSeq)
+{
+    MFC_SIM_BITS bits;
+    int objectType;
+    int resolution;
+    int n;
+
+    memset(pSeq, 0, sizeof(MFC_SIM_SEQ_INFO));
+    bits.buf = (unsigned char *)buf;
+    bits.size = size;
+    bits.pos = 0;
+
+    mfc_sim_bits_get(&bits, 1);                     /* random_accessible_vol */
+    objectType = mfc_sim_bits_get(&bits, 8);
+    pSeq->lowDelay = (objectType == 1);             /* Simple Object Type has no B-VOP */
+    if (mfc_sim_bits_get(&bits, 1))                 /* is_object_layer_identifier */
+        mfc_sim_bits_get(&bits, 7);                 /* verid, priority */
+    if (mfc_sim_bits_get(&bits, 4) == 0xF)          /* aspect_ratio_info */
+        mfc_sim_bits_get(&bits, 16);                /* par_width, par_height */
+    if (mfc_sim_bits_get(&bits, 1)) {               /* vol_control_parameters */
+        mfc_sim_bits_get(&bits, 2);                 /* chroma_format */
+        pSeq->lowDelay = mfc_sim_bits_get(&bits, 1);
+        if (mfc_sim_bits_get(&bits, 1))             /* vbv_parameters */
+            mfc_sim_bits_get(&bits, 15 + 1 + 15 + 1 + 15 + 1 + 3 + 11 + 1 + 15 + 1);
+    }
+    if (mfc_sim_bits_get(&bits, 2) != 0)            /* video_object_layer_shape, rectangular only */
+        return -1;
+    mfc_sim_bits_get(&bits, 1);                     /* marker */
+    resolution = mfc_sim_bits_get(&bits, 16);       /* vop_time_increment_resolution */
+    mfc_sim_bits_get(&bits, 1);                     /* marker */
+    if (mfc_sim_bits_get(&bits, 1)) {               /* fixed_vop_rate */
+        for (n = 1; (1 << n) < resolution; n++)
+            ;
+        mfc_sim_bits_get(&bits, n);                 /* fixed_vop_time_increment */
+    }
+    mfc_sim_bits_get(&bits, 1);                     /* marker */
+    pSeq->width = mfc_sim_bits_get(&bits, 13);
+    mfc_sim_bits_get(&bits, 1);                     /* marker */
+    pSeq->height = mfc_sim_bits_get(&bits, 13);
+
+    if ((bits.pos > bits.size * 8) || (pSeq->width == 0) || (pSeq->height == 0) ||
+        (((pSeq->width + 15) / 16) * ((pSeq->height + 15) / 16) > MFC_SIM_MAX_MB_NUM))
+        return -1;
+
+    pSeq->refFrames = 2;
+
+    return 0;
+}
+
+/*
+ * Parses H.263 picture header
+ *
+ * @param buf
+ *   Picture, starting with the picture start code[in]
+ *
+ * @param pSeq
+ *   Picture size, may be NULL[out]
+ *
+ * @return
+ *   Picture coding type, 0 for INTRA and 1 for INTER, -1 if not a picture
+ */
+int mfc_sim_h263_parse_picture(const unsigned char *buf, int size, MFC_SIM_SEQ_INFO *pSeq)
+{
+    MFC_SIM_BITS bits;
+    int sourceFormat;
+    int codingType;
+    int width, height;
+
+    if ((size < 5) || (buf[0] != 0) || (buf[1] != 0) || ((buf[2] & 0xFC) != 0x80))
+        return -1;
+
+    bits.buf = (unsigned char *)buf;
+    bits.size = size;
+    bits.pos = 22;                                  /* picture start code */
+
+    mfc_sim_bits_get(&bits, 8);                     /* temporal reference */
+    mfc_sim_bits_get(&bits, 5);                     /* PTYPE 1 0, split screen, camera, freeze */
+    sourceFormat = mfc_sim_bits_get(&bits, 3);
+
+    if (sourceFormat != 7) {
+        codingType = mfc_sim_bits_get(&bits, 1);
+        width = mfc_sim_h263_width[sourceFormat];
+        height = mfc_sim_h263_height[sourceFormat];
+    } else {
+        /* PLUSPTYPE, picture size only in a picture with UFEP 001 */
+        width = 0;
+        height = 0;
+        if (mfc_sim_bits_get(&bits, 3) == 1) {
+            sourceFormat = mfc_sim_bits_get(&bits, 3);
+            mfc_sim_bits_get(&bits, 15);            /* rest of OPPTYPE */
+        }
+        codingType = mfc_sim_bits_get(&bits, 3);    /* MPPTYPE picture type */
+        mfc_sim_bits_get(&bits, 6);
+        if (mfc_sim_bits_get(&bits, 1))             /* CPM */
+            mfc_sim_bits_get(&bits, 2);             /* PSBI */
+        if (sourceFormat == 6) {
+            mfc_sim_bits_get(&bits, 4);             /* pixel aspect ratio */
+            width = (mfc_sim_bits_get(&bits, 9) + 1) * 4;
+            mfc_sim_bits_get(&bits, 1);
+            height = mfc_sim_bits_get(&bits, 9) * 4;
+        } else if (sourceFormat != 7) {
+            width = mfc_sim_h263_width[sourceFormat];
+            height = mfc_sim_h263_height[sourceFormat];
+        }
+        codingType = (codingType != 0);
+    }
+
+    if (pSeq != NULL) {
+        memset(pSeq, 0, sizeof(MFC_SIM_SEQ_INFO));
+        if ((width == 0) || (height == 0) ||
+            (((width + 15) / 16) * ((height + 15) / 16) > MFC_SIM_MAX_MB_NUM))
+            return -1;
+        pSeq->width = width;
+        pSeq->height = height;
+        pSeq->refFrames = 1;
+        pSeq->lowDelay = 1;
+    }
+
+    return codingType;
+}
+
+/*
+ * Parses MPEG-1/2 sequence header
+ *
+ * @param buf
+ *   Header after the sequence_header_code[in]
+ */
+int mfc_sim_mpeg2_parse_sequence(const unsigned char *buf, int size, MFC_SIM_SEQ_INFO *pSeq)
+{
+    memset(pSeq, 0, sizeof(MFC_SIM_SEQ_INFO));
+
+    if (size < 3)
+        return -1;
+
+    pSeq->width = (buf[0] << 4) | (buf[1] >> 4);
+    pSeq->height = ((buf[1] & 0xF) << 8) | buf[2];
+    pSeq->refFrames = 2;
+
+    if ((pSeq->width == 0) || (pSeq->height == 0) ||
+        (((pSeq->width + 15) / 16) * ((pSeq->height + 15) / 16) > MFC_SIM_MAX_MB_NUM))
+        return -1;
+
+    return 0;
+}
+
+/*
+ * Writes H.264 NAL unit with start code and emulation prevention bytes
+ *
+ * @return
+ *   Bytes written, -1 if dest is too small
+ */
+int mfc_sim_put_nal(unsigned char *dest, int destSize, int nalHeader, const unsigned char *rbsp, int rbspSize)
+{
+    int zeros = 0;
+    int len = 0;
+    int i;
+
+    if (destSize < 5)
+        return -1;
+
+    dest[len++] = 0;
+    dest[len++] = 0;
+    dest[len++] = 0;
+    dest[len++] = 1;
+    dest[len++] = (unsigned char)nalHeader;
+
+    for (i = 0; i < rbspSize; i++) {
+        if (len + 2 > destSize)
+            return -1;
+        if ((zeros >= 2) && (rbsp[i] <= 0x03)) {
+            dest[len++] = 0x03;
+            zeros = 0;
+        }
+        zeros = (rbsp[i] == 0) ? zeros + 1 : 0;
+        dest[len++] = rbsp[i];
+    }
+
+    return len;
+}
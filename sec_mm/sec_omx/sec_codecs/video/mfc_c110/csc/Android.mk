@@ -1,11 +1,22 @@
-
 LOCAL_PATH := $(call my-dir)
 include $(CLEAR_VARS)
 
 LOCAL_MODULE_TAGS := optional
 
-ifeq ($(ARCH_ARM_HAVE_NEON),true)
 LOCAL_SRC_FILES := \
+	color_space_convertor.c \
+	csc_dispatch.c \
+	csc_frame.c \
+	csc_neon.c \
+	csc_parallel.c \
+	csc_sse2.c \
+	csc_avx2.c \
+	csc_tile_map.c
+
+LOCAL_CFLAGS :=
+
+ifeq ($(ARCH_ARM_HAVE_NEON),true)
+LOCAL_SRC_FILES += \
 	csc_yuv420_nv12t_y_neon.s \
 	csc_yuv420_nv12t_uv_neon.s \
 	csc_nv12t_yuv420_y_neon.s \
@@ -13,16 +24,11 @@ LOCAL_SRC_FILES := \
 	csc_interleave_memcpy.s \
 	csc_deinterleave_memcpy.s
 
-else
-LOCAL_SRC_FILES := \
-	color_space_convertor.c
-
+LOCAL_CFLAGS += -DUSE_CSC_NEON_ASM
 endif
 
 LOCAL_MODULE := libseccsc.aries
 
-LOCAL_CFLAGS :=
-
 LOCAL_ARM_MODE := arm
 
 LOCAL_STATIC_LIBRARIES :=
@@ -34,3 +40,81 @@ LOCAL_C_INCLUDES := \
 
 include $(BUILD_STATIC_LIBRARY)
 
+#########################################################################
+# Build csc benchmark and correctness test
+#########################################################################
+
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES := \
+	csc_bench.c
+
+LOCAL_MODULE := csc_bench
+
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_STATIC_LIBRARIES := libseccsc.aries
+
+LOCAL_SHARED_LIBRARIES := liblog
+
+LOCAL_C_INCLUDES := \
+	$(SEC_CODECS)/video/mfc_c110/include
+
+include $(BUILD_EXECUTABLE)
+
+#########################################################################
+# Build csc benchmark for host, generic C and x86 backends
+#########################################################################
+
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES := \
+	csc_bench.c \
+	color_space_convertor.c \
+	csc_dispatch.c \
+	csc_frame.c \
+	csc_neon.c \
+	csc_parallel.c \
+	csc_sse2.c \
+	csc_avx2.c \
+	csc_tile_map.c
+
+LOCAL_MODULE := csc_bench_host
+
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_CFLAGS := -O2
+
+LOCAL_LDLIBS := -lpthread -lrt
+
+LOCAL_C_INCLUDES := \
+	$(SEC_CODECS)/video/mfc_c110/include
+
+include $(BUILD_HOST_EXECUTABLE)
+
+#########################################################################
+# Build csc for host, generic C and x86 backends
+#########################################################################
+
+include $(CLEAR_VARS)
+
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_SRC_FILES := \
+	color_space_convertor.c \
+	csc_dispatch.c \
+	csc_frame.c \
+	csc_neon.c \
+	csc_parallel.c \
+	csc_sse2.c \
+	csc_avx2.c \
+	csc_tile_map.c
+
+LOCAL_MODULE := libseccsc_host
+
+LOCAL_CFLAGS :=
+
+LOCAL_C_INCLUDES := \
+	$(SEC_CODECS)/video/mfc_c110/include
+
+include $(BUILD_HOST_STATIC_LIBRARY)
@@ -0,0 +1,117 @@
+/*
+ *
+ * Copyright 2011 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    csc_avx2.c
+ * @brief   AVX2 backend of csc
+ *   Built for every x86 target with AVX2 enabled per function, so it is
+ *   only selected after csc_dispatch.c has checked the CPU at run time.
+ * @version 1.0
+ */
+
+#include "csc_backend.h"
+
+#ifdef CSC_HAVE_AVX2
+
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+#include <immintrin.h>
+
+static inline void csc_row_copy64(char *dest, const char *src)
+{
+    __m256i a = _mm256_loadu_si256((const __m256i *)(src));
+    __m256i b = _mm256_loadu_si256((const __m256i *)(src + 32));
+    _mm256_storeu_si256((__m256i *)(dest), a);
+    _mm256_storeu_si256((__m256i *)(dest + 32), b);
+}
+
+static inline void csc_row_deinterleave(char *dest1, char *dest2, const char *src, int src_size)
+{
+    const __m256i mask = _mm256_set1_epi16(0x00FF);
+    int i = 0;
+
+    for (; i + 64 <= src_size; i += 64) {
+        __m256i a = _mm256_loadu_si256((const __m256i *)(src + i));
+        __m256i b = _mm256_loadu_si256((const __m256i *)(src + i + 32));
+        /* packus works per 128 bit lane, permute restores byte order */
+        __m256i even = _mm256_packus_epi16(_mm256_and_si256(a, mask), _mm256_and_si256(b, mask));
+        __m256i odd  = _mm256_packus_epi16(_mm256_srli_epi16(a, 8), _mm256_srli_epi16(b, 8));
+        even = _mm256_permute4x64_epi64(even, 0xD8);
+        odd  = _mm256_permute4x64_epi64(odd, 0xD8);
+        _mm256_storeu_si256((__m256i *)(dest1 + i/2), even);
+        _mm256_storeu_si256((__m256i *)(dest2 + i/2), odd);
+    }
+    for (; i < src_size - 1; i += 2) {
+        dest1[i/2] = src[i];
+        dest2[i/2] = src[i+1];
+    }
+}
+
+static inline void csc_row_interleave(char *dest, const char *src1, const char *src2, int src_size)
+{
+    int i = 0;
+
+    for (; i + 32 <= src_size; i += 32) {
+        __m256i u = _mm256_loadu_si256((const __m256i *)(src1 + i));
+        __m256i v = _mm256_loadu_si256((const __m256i *)(src2 + i));
+        __m256i lo = _mm256_unpacklo_epi8(u, v);
+        __m256i hi = _mm256_unpackhi_epi8(u, v);
+        _mm256_storeu_si256((__m256i *)(dest + i*2), _mm256_permute2x128_si256(lo, hi, 0x20));
+        _mm256_storeu_si256((__m256i *)(dest + i*2 + 32), _mm256_permute2x128_si256(lo, hi, 0x31));
+    }
+    for (; i < src_size; i++) {
+        dest[i*2] = src1[i];
+        dest[i*2+1] = src2[i];
+    }
+}
+
+#include "csc_tiled_template.h"
+
+static void csc_deinterleave_memcpy_avx2(char *dest1, char *dest2, char *src, int src_size)
+{
+    csc_row_deinterleave(dest1, dest2, src, src_size);
+}
+
+static void csc_interleave_memcpy_avx2(char *dest, char *src1, char *src2, int src_size)
+{
+    csc_row_interleave(dest, src1, src2, src_size);
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+const CSC_BACKEND_OPS csc_ops_avx2 = {
+    CSC_BACKEND_AVX2,
+    csc_deinterleave_memcpy_avx2,
+    csc_interleave_memcpy_avx2,
+    csc_tmpl_tiled_to_linear,
+    csc_tmpl_tiled_to_linear_deinterleave,
+    csc_tmpl_linear_to_tiled,
+    csc_tmpl_linear_to_tiled_interleave,
+    csc_tmpl_tiled_to_linear_map,
+    csc_tmpl_tiled_to_linear_deinterleave_map,
+};
+
+#endif /* CSC_HAVE_AVX2 */
@@ -0,0 +1,135 @@
+/*
+ *
+ * Copyright 2011 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    csc_backend.h
+ * @brief   Internal interface between csc dispatcher and its backends
+ * @version 1.0
+ */
+
+#ifndef CSC_BACKEND_H_
+#define CSC_BACKEND_H_
+
+#include "color_space_convertor.h"
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#define CSC_HAVE_NEON
+#endif
+
+#if defined(__SSE2__) || defined(__x86_64__)
+#define CSC_HAVE_SSE2
+#endif
+
+#if (defined(__i386__) || defined(__x86_64__)) && defined(__GNUC__)
+#define CSC_HAVE_AVX2
+#endif
+
+typedef struct _CSC_BACKEND_OPS
+{
+    CSC_BACKEND backend;
+    void (*deinterleave_memcpy)(char *dest1, char *dest2, char *src, int src_size);
+    void (*interleave_memcpy)(char *dest, char *src1, char *src2, int src_size);
+    void (*tiled_to_linear)(char *yuv420_dest, char *nv12t_src, int yuv420_width, int yuv420_height);
+    void (*tiled_to_linear_deinterleave)(char *yuv420_u_dest, char *yuv420_v_dest, char *nv12t_uv_src, int yuv420_width, int yuv420_uv_height);
+    void (*linear_to_tiled)(char *nv12t_dest, char *yuv420_src, int yuv420_width, int yuv420_height);
+    void (*linear_to_tiled_interleave)(char *nv12t_uv_dest, char *yuv420p_u_src, char *yuv420p_v_src, int yuv420_width, int yuv420_uv_height);
+    /* tile rows [tile_row_start, tile_row_end) of map, lines of dest dest_stride apart */
+    void (*tiled_to_linear_map)(char *yuv420_dest, int dest_stride, char *nv12t_src, CSC_TILE_MAP *map,
+                                int tile_row_start, int tile_row_end);
+    void (*tiled_to_linear_deinterleave_map)(char *yuv420_u_dest, char *yuv420_v_dest, int u_stride, int v_stride,
+                                             char *nv12t_uv_src, CSC_TILE_MAP *map, int tile_row_start, int tile_row_end);
+} CSC_BACKEND_OPS;
+
+/* Generic C, color_space_convertor.c */
+void csc_deinterleave_memcpy_c(char *dest1, char *dest2, char *src, int src_size);
+void csc_interleave_memcpy_c(char *dest, char *src1, char *src2, int src_size);
+void csc_tiled_to_linear_c(char *yuv420_dest, char *nv12t_src, int yuv420_width, int yuv420_height);
+void csc_tiled_to_linear_deinterleave_c(char *yuv420_u_dest, char *yuv420_v_dest, char *nv12t_uv_src, int yuv420_width, int yuv420_uv_height);
+void csc_linear_to_tiled_c(char *nv12t_dest, char *yuv420_src, int yuv420_width, int yuv420_height);
+void csc_linear_to_tiled_interleave_c(char *nv12t_uv_dest, char *yuv420p_u_src, char *yuv420p_v_src, int yuv420_width, int yuv420_uv_height);
+
+/* Generic C, csc_tile_map.c */
+void csc_tiled_to_linear_map_c(char *yuv420_dest, int dest_stride, char *nv12t_src, CSC_TILE_MAP *map,
+                               int tile_row_start, int tile_row_end);
+void csc_tiled_to_linear_deinterleave_map_c(char *yuv420_u_dest, char *yuv420_v_dest, int u_stride, int v_stride,
+                                            char *nv12t_uv_src, CSC_TILE_MAP *map, int tile_row_start, int tile_row_end);
+
+/* csc_dispatch.c, map walkers of the selected backend for csc_frame.c */
+void csc_tiled_to_linear_map_rows(char *yuv420_dest, int dest_stride, char *nv12t_src, CSC_TILE_MAP *map,
+                                  int tile_row_start, int tile_row_end);
+void csc_tiled_to_linear_deinterleave_map_rows(char *yuv420_u_dest, char *yuv420_v_dest, int u_stride, int v_stride,
+                                               char *nv12t_uv_src, CSC_TILE_MAP *map, int tile_row_start, int tile_row_end);
+
+#ifdef USE_CSC_NEON_ASM
+/* Hand written NEON assembly, csc_*.s */
+void csc_deinterleave_memcpy_neon_asm(char *dest1, char *dest2, char *src, int src_size);
+void csc_interleave_memcpy_neon_asm(char *dest, char *src1, char *src2, int src_size);
+void csc_tiled_to_linear_neon_asm(char *yuv420_dest, char *nv12t_src, int yuv420_width, int yuv420_height);
+void csc_tiled_to_linear_deinterleave_neon_asm(char *yuv420_u_dest, char *yuv420_v_dest, char *nv12t_uv_src, int yuv420_width, int yuv420_uv_height);
+void csc_linear_to_tiled_neon_asm(char *nv12t_dest, char *yuv420_src, int yuv420_width, int yuv420_height);
+void csc_linear_to_tiled_interleave_neon_asm(char *nv12t_uv_dest, char *yuv420p_u_src, char *yuv420p_v_src, int yuv420_width, int yuv420_uv_height);
+#endif
+
+#ifdef CSC_HAVE_NEON
+extern const CSC_BACKEND_OPS csc_ops_neon;
+/* csc_neon.c, also the map walkers of the assembly backend */
+void csc_tiled_to_linear_map_neon(char *yuv420_dest, int dest_stride, char *nv12t_src, CSC_TILE_MAP *map,
+                                  int tile_row_start, int tile_row_end);
+void csc_tiled_to_linear_deinterleave_map_neon(char *yuv420_u_dest, char *yuv420_v_dest, int u_stride, int v_stride,
+                                               char *nv12t_uv_src, CSC_TILE_MAP *map, int tile_row_start, int tile_row_end);
+#endif
+#ifdef CSC_HAVE_SSE2
+extern const CSC_BACKEND_OPS csc_ops_sse2;
+#endif
+#ifdef CSC_HAVE_AVX2
+extern const CSC_BACKEND_OPS csc_ops_avx2;
+#endif
+
+/*
+ * Returns byte offset of tile (x, y) in NV12T plane
+ *
+ * @param x
+ *   Horizontal tile index[in]
+ *
+ * @param y
+ *   Vertical tile index[in]
+ *
+ * @param x_block_num
+ *   Number of tiles per row of 128 byte aligned plane[in]
+ *
+ * @param last_row
+ *   Non-zero if y is the last tile row of the plane[in]
+ */
+static inline unsigned int csc_get_tiled_offset(unsigned int x, unsigned int y, unsigned int x_block_num, int last_row)
+{
+    unsigned int offset;
+
+    if (y & 0x1) {
+        /* odd fomula: 2+x+(x>>2)<<2+x_block_num*(y-1) */
+        offset = x_block_num*(y-1) + 2 + x + ((x>>2)<<2);
+    } else if (!last_row) {
+        /* even1 fomula: x+((x+2)>>2)<<2+x_block_num*y */
+        offset = x + (((x+2)>>2)<<2) + x_block_num*y;
+    } else {
+        /* even2 fomula: x+x_block_num*y */
+        offset = x + x_block_num*y;
+    }
+
+    return offset<<11;
+}
+
+#endif /*CSC_BACKEND_H_*/
@@ -0,0 +1,859 @@
+/*
+ *
+ * Copyright 2011 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    csc_bench.c
+ * @brief   Correctness and speed harness of csc
+ *   Runs every csc_* function of every backend available on the running
+ *   CPU over a matrix of resolutions, compares the output bit exact with
+ *   a per pixel reference and reports MB/s and cycles per pixel.
+ *   Output buffers are surrounded by guard bytes, so writes past the
+ *   picture or into the stride padding are reported as mismatches too.
+ *   Exit status is non-zero if any mismatch was found.
+ *
+ *   Builds as csc_bench_host with the Android build system, or on any
+ *   Linux host with:
+ *     gcc -O2 -I../include -o csc_bench csc_bench.c color_space_convertor.c \
+ *         csc_dispatch.c csc_frame.c csc_neon.c csc_parallel.c csc_sse2.c \
+ *         csc_avx2.c csc_tile_map.c -lpthread
+ * @version 1.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "color_space_convertor.h"
+
+#if defined(__i386__) || defined(__x86_64__)
+#include <x86intrin.h>
+#define CSC_BENCH_HAVE_TSC
+#endif
+
+#define CSC_BENCH_GUARD         256
+#define CSC_BENCH_GUARD_BYTE    0xA5
+#define CSC_BENCH_STRIDE_PAD    48
+#define CSC_BENCH_MAX_REPORT    4
+
+#define ALIGN(x, a) (((x) + (a) - 1) & ~((a) - 1))
+
+typedef struct _CSC_BENCH_SIZE
+{
+    int width;
+    int height;
+} CSC_BENCH_SIZE;
+
+/*
+ * QCIF to 1080p, plus widths that are not a multiple of 128, of 64 and
+ * of 4, and heights that are not a multiple of 32
+ */
+static const CSC_BENCH_SIZE csc_bench_sizes[] = {
+    {  176,  144 },
+    {  320,  240 },
+    {  352,  288 },
+    {  640,  480 },
+    {  720,  480 },
+    {  800,  480 },
+    {  854,  480 },
+    { 1280,  720 },
+    { 1366,  768 },
+    { 1920, 1080 },
+    {   66,   40 },
+    {  130,   72 },
+    {  198,  104 },
+    { 1030,  584 },
+};
+
+typedef struct _CSC_BENCH_CTX
+{
+    int   width;
+    int   height;
+    int   uv_height;
+    int   tiled_y_size;
+    int   tiled_uv_size;
+
+    /* NV12T source and its reference linear conversion */
+    char *tiled_y;
+    char *tiled_uv;
+    char *ref_y;
+    char *ref_uv;
+    char *ref_u;
+    char *ref_v;
+
+    /* reference with CSC_BENCH_STRIDE_PAD padded lines, as encoder input */
+    char *src_y;
+    char *src_uv;
+    char *src_vu;
+    char *src_u;
+    char *src_v;
+    char *src_yuyv;
+
+    /* outputs, each followed by CSC_BENCH_GUARD guard bytes */
+    char *out[3];
+    int   out_size[3];
+
+    CSC_TILE_MAP y_map;
+    CSC_TILE_MAP uv_map;
+    CSC_LINEAR_FRAME frame;
+} CSC_BENCH_CTX;
+
+typedef struct _CSC_BENCH_TEST
+{
+    const char *name;
+    void (*run)(CSC_BENCH_CTX *ctx);
+    int  (*check)(CSC_BENCH_CTX *ctx);
+    int   uv_only;
+} CSC_BENCH_TEST;
+
+static int csc_bench_verbose = 0;
+
+/*--------------------------------------------------------------------------------*/
+/* Reference                                                                      */
+/*--------------------------------------------------------------------------------*/
+/*
+ * Offset of pixel (x, y) in a NV12T plane of width x height.
+ * Tiles are 64x32 and laid out in Z order over pairs of tile rows; the
+ * last tile row of a plane with an odd number of tile rows is linear.
+ */
+static unsigned int ref_tiled_offset(int x, int y, int width, int height)
+{
+    int x_block_num = ALIGN(width, 128) / 64;
+    int y_block_num = ALIGN(height, 32) / 32;
+    int tx = x / 64;
+    int ty = y / 32;
+    int tile;
+
+    if (ty & 1)
+        tile = x_block_num * (ty - 1) + 2 + tx + (tx / 4) * 4;
+    else if (ty < y_block_num - 1)
+        tile = x_block_num * ty + tx + ((tx + 2) / 4) * 4;
+    else
+        tile = x_block_num * ty + tx;
+
+    return tile * 2048 + (y % 32) * 64 + (x % 64);
+}
+
+static int ref_tiled_size(int width, int height)
+{
+    return ALIGN(width, 128) * ALIGN(height, 32);
+}
+
+static void ref_tiled_to_linear(char *dest, char *src, int width, int height)
+{
+    int x, y;
+
+    for (y = 0; y < height; y++)
+        for (x = 0; x < width; x++)
+            dest[y * width + x] = src[ref_tiled_offset(x, y, width, height)];
+}
+
+static void ref_deinterleave(char *dest1, char *dest2, char *src, int size)
+{
+    int i;
+
+    for (i = 0; i < size / 2; i++) {
+        dest1[i] = src[i * 2];
+        dest2[i] = src[i * 2 + 1];
+    }
+}
+
+/*--------------------------------------------------------------------------------*/
+/* Checks                                                                         */
+/*--------------------------------------------------------------------------------*/
+static void csc_bench_clear(CSC_BENCH_CTX *ctx)
+{
+    int i;
+
+    for (i = 0; i < 3; i++)
+        memset(ctx->out[i], CSC_BENCH_GUARD_BYTE, ctx->out_size[i] + CSC_BENCH_GUARD);
+}
+
+static void csc_bench_report(const char *what, int index, int expected, int got)
+{
+    if (csc_bench_verbose)
+        printf("    %s at %d: expected 0x%02x, got 0x%02x\n", what, index, expected & 0xFF, got & 0xFF);
+}
+
+/*
+ * Compares rows of row_size bytes, stride apart, and checks that stride
+ * padding and guard bytes are untouched
+ */
+static int csc_bench_check_linear(char *out, int out_size, char *ref, int row_size, int rows, int stride)
+{
+    int mismatch = 0;
+    int x, y, i;
+
+    for (y = 0; y < rows; y++) {
+        for (x = 0; x < stride; x++) {
+            i = y * stride + x;
+            if (x < row_size) {
+                if (out[i] != ref[y * row_size + x]) {
+                    if (mismatch++ < CSC_BENCH_MAX_REPORT)
+                        csc_bench_report("pixel", i, ref[y * row_size + x], out[i]);
+                }
+            } else if ((unsigned char)out[i] != CSC_BENCH_GUARD_BYTE) {
+                if (mismatch++ < CSC_BENCH_MAX_REPORT)
+                    csc_bench_report("padding", i, CSC_BENCH_GUARD_BYTE, out[i]);
+            }
+        }
+    }
+
+    for (i = rows * stride; i < out_size + CSC_BENCH_GUARD; i++) {
+        if ((unsigned char)out[i] != CSC_BENCH_GUARD_BYTE) {
+            if (mismatch++ < CSC_BENCH_MAX_REPORT)
+                csc_bench_report("guard", i, CSC_BENCH_GUARD_BYTE, out[i]);
+        }
+    }
+
+    return mismatch;
+}
+
+/*
+ * Compares the bytes of a NV12T plane that belong to the picture.
+ * Tile padding is not defined by the API and is not compared.
+ */
+static int csc_bench_check_tiled(char *out, int out_size, char *ref, int width, int height)
+{
+    int mismatch = 0;
+    unsigned int offset;
+    int x, y, i;
+
+    for (y = 0; y < height; y++) {
+        for (x = 0; x < width; x++) {
+            offset = ref_tiled_offset(x, y, width, height);
+            if (out[offset] != ref[offset]) {
+                if (mismatch++ < CSC_BENCH_MAX_REPORT)
+                    csc_bench_report("pixel", offset, ref[offset], out[offset]);
+            }
+        }
+    }
+
+    for (i = out_size; i < out_size + CSC_BENCH_GUARD; i++) {
+        if ((unsigned char)out[i] != CSC_BENCH_GUARD_BYTE) {
+            if (mismatch++ < CSC_BENCH_MAX_REPORT)
+                csc_bench_report("guard", i, CSC_BENCH_GUARD_BYTE, out[i]);
+        }
+    }
+
+    return mismatch;
+}
+
+/*--------------------------------------------------------------------------------*/
+/* Tests                                                                          */
+/*--------------------------------------------------------------------------------*/
+static void run_deinterleave_memcpy(CSC_BENCH_CTX *ctx)
+{
+    csc_deinterleave_memcpy(ctx->out[1], ctx->out[2], ctx->ref_uv, ctx->width * ctx->uv_height);
+}
+
+static int check_deinterleave(CSC_BENCH_CTX *ctx)
+{
+    int size = ctx->width / 2 * ctx->uv_height;
+
+    return csc_bench_check_linear(ctx->out[1], ctx->out_size[1], ctx->ref_u, size, 1, size) +
+           csc_bench_check_linear(ctx->out[2], ctx->out_size[2], ctx->ref_v, size, 1, size);
+}
+
+static void run_interleave_memcpy(CSC_BENCH_CTX *ctx)
+{
+    csc_interleave_memcpy(ctx->out[1], ctx->ref_u, ctx->ref_v, ctx->width / 2 * ctx->uv_height);
+}
+
+static int check_interleave(CSC_BENCH_CTX *ctx)
+{
+    int size = ctx->width * ctx->uv_height;
+
+    return csc_bench_check_linear(ctx->out[1], ctx->out_size[1], ctx->ref_uv, size, 1, size);
+}
+
+static void run_tiled_to_linear_y(CSC_BENCH_CTX *ctx)
+{
+    csc_tiled_to_linear(ctx->out[0], ctx->tiled_y, ctx->width, ctx->height);
+}
+
+static void run_tiled_to_linear_y_map(CSC_BENCH_CTX *ctx)
+{
+    csc_tiled_to_linear_map(ctx->out[0], ctx->tiled_y, &ctx->y_map);
+}
+
+static void run_tiled_to_linear_y_parallel(CSC_BENCH_CTX *ctx)
+{
+    csc_tiled_to_linear_parallel(ctx->out[0], ctx->tiled_y, ctx->width, ctx->height);
+}
+
+static int check_linear_y(CSC_BENCH_CTX *ctx)
+{
+    return csc_bench_check_linear(ctx->out[0], ctx->out_size[0], ctx->ref_y, ctx->width, ctx->height, ctx->width);
+}
+
+static void run_tiled_to_linear_uv(CSC_BENCH_CTX *ctx)
+{
+    csc_tiled_to_linear(ctx->out[1], ctx->tiled_uv, ctx->width, ctx->uv_height);
+}
+
+static void run_tiled_to_linear_uv_map(CSC_BENCH_CTX *ctx)
+{
+    csc_tiled_to_linear_map(ctx->out[1], ctx->tiled_uv, &ctx->uv_map);
+}
+
+static void run_tiled_to_linear_uv_parallel(CSC_BENCH_CTX *ctx)
+{
+    csc_tiled_to_linear_parallel(ctx->out[1], ctx->tiled_uv, ctx->width, ctx->uv_height);
+}
+
+static int check_linear_uv(CSC_BENCH_CTX *ctx)
+{
+    return csc_bench_check_linear(ctx->out[1], ctx->out_size[1], ctx->ref_uv, ctx->width, ctx->uv_height, ctx->width);
+}
+
+static void run_tiled_to_linear_deinterleave(CSC_BENCH_CTX *ctx)
+{
+    csc_tiled_to_linear_deinterleave(ctx->out[1], ctx->out[2], ctx->tiled_uv, ctx->width, ctx->uv_height);
+}
+
+static void run_tiled_to_linear_deinterleave_map(CSC_BENCH_CTX *ctx)
+{
+    csc_tiled_to_linear_deinterleave_map(ctx->out[1], ctx->out[2], ctx->tiled_uv, &ctx->uv_map);
+}
+
+static void run_tiled_to_linear_deinterleave_parallel(CSC_BENCH_CTX *ctx)
+{
+    csc_tiled_to_linear_deinterleave_parallel(ctx->out[1], ctx->out[2], ctx->tiled_uv, ctx->width, ctx->uv_height);
+}
+
+static int check_linear_u_v(CSC_BENCH_CTX *ctx)
+{
+    int width = ctx->width / 2;
+
+    return csc_bench_check_linear(ctx->out[1], ctx->out_size[1], ctx->ref_u, width, ctx->uv_height, width) +
+           csc_bench_check_linear(ctx->out[2], ctx->out_size[2], ctx->ref_v, width, ctx->uv_height, width);
+}
+
+static void run_linear_to_tiled_y(CSC_BENCH_CTX *ctx)
+{
+    csc_linear_to_tiled(ctx->out[0], ctx->ref_y, ctx->width, ctx->height);
+}
+
+static void run_linear_to_tiled_y_parallel(CSC_BENCH_CTX *ctx)
+{
+    csc_linear_to_tiled_parallel(ctx->out[0], ctx->ref_y, ctx->width, ctx->height);
+}
+
+static int check_tiled_y(CSC_BENCH_CTX *ctx)
+{
+    return csc_bench_check_tiled(ctx->out[0], ctx->out_size[0], ctx->tiled_y, ctx->width, ctx->height);
+}
+
+static void run_linear_to_tiled_interleave(CSC_BENCH_CTX *ctx)
+{
+    csc_linear_to_tiled_interleave(ctx->out[1], ctx->ref_u, ctx->ref_v, ctx->width, ctx->uv_height);
+}
+
+static void run_linear_to_tiled_interleave_parallel(CSC_BENCH_CTX *ctx)
+{
+    csc_linear_to_tiled_interleave_parallel(ctx->out[1], ctx->ref_u, ctx->ref_v, ctx->width, ctx->uv_height);
+}
+
+static int check_tiled_uv(CSC_BENCH_CTX *ctx)
+{
+    return csc_bench_check_tiled(ctx->out[1], ctx->out_size[1], ctx->tiled_uv, ctx->width, ctx->uv_height);
+}
+
+static void csc_bench_set_frame(CSC_BENCH_CTX *ctx, CSC_LAYOUT layout, int pad)
+{
+    int stride = ctx->width + pad;
+
+    ctx->frame.layout = layout;
+    ctx->frame.plane[0] = ctx->out[0];
+    ctx->frame.plane[1] = ctx->out[1];
+    ctx->frame.plane[2] = ctx->out[2];
+    ctx->frame.stride[0] = stride;
+    if (layout == CSC_LAYOUT_I420) {
+        ctx->frame.stride[1] = stride / 2;
+        ctx->frame.stride[2] = stride / 2;
+    } else {
+        ctx->frame.stride[1] = stride;
+        ctx->frame.stride[2] = 0;
+    }
+}
+
+static int check_frame(CSC_BENCH_CTX *ctx)
+{
+    CSC_LINEAR_FRAME *frame = &ctx->frame;
+    int mismatch;
+    char *ref;
+    int i;
+
+    mismatch = csc_bench_check_linear(frame->plane[0], ctx->out_size[0], ctx->ref_y,
+                                      ctx->width, ctx->height, frame->stride[0]);
+
+    switch (frame->layout) {
+    case CSC_LAYOUT_I420:
+        mismatch += csc_bench_check_linear(frame->plane[1], ctx->out_size[1], ctx->ref_u,
+                                           ctx->width / 2, ctx->uv_height, frame->stride[1]);
+        mismatch += csc_bench_check_linear(frame->plane[2], ctx->out_size[2], ctx->ref_v,
+                                           ctx->width / 2, ctx->uv_height, frame->stride[2]);
+        break;
+    case CSC_LAYOUT_NV21:
+        ref = malloc(ctx->width * ctx->uv_height);
+        for (i = 0; i < ctx->width * ctx->uv_height; i += 2) {
+            ref[i] = ctx->ref_uv[i + 1];
+            ref[i + 1] = ctx->ref_uv[i];
+        }
+        mismatch += csc_bench_check_linear(frame->plane[1], ctx->out_size[1], ref,
+                                           ctx->width, ctx->uv_height, frame->stride[1]);
+        free(ref);
+        break;
+    case CSC_LAYOUT_NV12:
+    default:
+        mismatch += csc_bench_check_linear(frame->plane[1], ctx->out_size[1], ctx->ref_uv,
+                                           ctx->width, ctx->uv_height, frame->stride[1]);
+        break;
+    }
+
+    return mismatch;
+}
+
+static void run_frame_nv12(CSC_BENCH_CTX *ctx)
+{
+    csc_bench_set_frame(ctx, CSC_LAYOUT_NV12, CSC_BENCH_STRIDE_PAD);
+    csc_tiled_to_linear_frame(&ctx->frame, ctx->tiled_y, ctx->tiled_uv, &ctx->y_map, &ctx->uv_map);
+}
+
+static void run_frame_nv21(CSC_BENCH_CTX *ctx)
+{
+    csc_bench_set_frame(ctx, CSC_LAYOUT_NV21, CSC_BENCH_STRIDE_PAD);
+    csc_tiled_to_linear_frame(&ctx->frame, ctx->tiled_y, ctx->tiled_uv, &ctx->y_map, &ctx->uv_map);
+}
+
+static void run_frame_i420(CSC_BENCH_CTX *ctx)
+{
+    csc_bench_set_frame(ctx, CSC_LAYOUT_I420, CSC_BENCH_STRIDE_PAD);
+    csc_tiled_to_linear_frame(&ctx->frame, ctx->tiled_y, ctx->tiled_uv, &ctx->y_map, &ctx->uv_map);
+}
+
+static void run_frame_i420_parallel(CSC_BENCH_CTX *ctx)
+{
+    csc_bench_set_frame(ctx, CSC_LAYOUT_I420, CSC_BENCH_STRIDE_PAD);
+    csc_tiled_to_linear_frame_parallel(&ctx->frame, ctx->tiled_y, ctx->tiled_uv, &ctx->y_map, &ctx->uv_map);
+}
+
+/* tight strides as the decoder output, through the dispatched backend */
+static void run_frame_nv12_packed(CSC_BENCH_CTX *ctx)
+{
+    csc_bench_set_frame(ctx, CSC_LAYOUT_NV12, 0);
+    csc_tiled_to_linear_frame(&ctx->frame, ctx->tiled_y, ctx->tiled_uv, &ctx->y_map, &ctx->uv_map);
+}
+
+static void run_frame_i420_packed(CSC_BENCH_CTX *ctx)
+{
+    csc_bench_set_frame(ctx, CSC_LAYOUT_I420, 0);
+    csc_tiled_to_linear_frame(&ctx->frame, ctx->tiled_y, ctx->tiled_uv, &ctx->y_map, &ctx->uv_map);
+}
+
+static void run_frame_i420_packed_parallel(CSC_BENCH_CTX *ctx)
+{
+    csc_bench_set_frame(ctx, CSC_LAYOUT_I420, 0);
+    csc_tiled_to_linear_frame_parallel(&ctx->frame, ctx->tiled_y, ctx->tiled_uv, &ctx->y_map, &ctx->uv_map);
+}
+
+static void csc_bench_set_src_frame(CSC_BENCH_CTX *ctx, CSC_LAYOUT layout)
+{
+    int stride = ctx->width + CSC_BENCH_STRIDE_PAD;
+
+    ctx->frame.layout = layout;
+    ctx->frame.plane[0] = ctx->src_y;
+    ctx->frame.plane[1] = ctx->src_uv;
+    ctx->frame.plane[2] = NULL;
+    ctx->frame.stride[0] = stride;
+    ctx->frame.stride[1] = stride;
+    ctx->frame.stride[2] = 0;
+
+    switch (layout) {
+    case CSC_LAYOUT_I420:
+        ctx->frame.plane[1] = ctx->src_u;
+        ctx->frame.plane[2] = ctx->src_v;
+        ctx->frame.stride[1] = stride / 2;
+        ctx->frame.stride[2] = stride / 2;
+        break;
+    case CSC_LAYOUT_NV21:
+        ctx->frame.plane[1] = ctx->src_vu;
+        break;
+    case CSC_LAYOUT_YUYV:
+        ctx->frame.plane[0] = ctx->src_yuyv;
+        ctx->frame.plane[1] = NULL;
+        ctx->frame.stride[0] = stride * 2;
+        ctx->frame.stride[1] = 0;
+        break;
+    case CSC_LAYOUT_NV12:
+    default:
+        break;
+    }
+}
+
+static int check_tiled_frame(CSC_BENCH_CTX *ctx)
+{
+    return check_tiled_y(ctx) + check_tiled_uv(ctx);
+}
+
+static void run_tiled_frame_nv12(CSC_BENCH_CTX *ctx)
+{
+    csc_bench_set_src_frame(ctx, CSC_LAYOUT_NV12);
+    csc_linear_to_tiled_frame(ctx->out[0], ctx->out[1], &ctx->frame, &ctx->y_map, &ctx->uv_map);
+}
+
+static void run_tiled_frame_nv21(CSC_BENCH_CTX *ctx)
+{
+    csc_bench_set_src_frame(ctx, CSC_LAYOUT_NV21);
+    csc_linear_to_tiled_frame(ctx->out[0], ctx->out[1], &ctx->frame, &ctx->y_map, &ctx->uv_map);
+}
+
+static void run_tiled_frame_i420(CSC_BENCH_CTX *ctx)
+{
+    csc_bench_set_src_frame(ctx, CSC_LAYOUT_I420);
+    csc_linear_to_tiled_frame(ctx->out[0], ctx->out[1], &ctx->frame, &ctx->y_map, &ctx->uv_map);
+}
+
+static void run_tiled_frame_yuyv(CSC_BENCH_CTX *ctx)
+{
+    csc_bench_set_src_frame(ctx, CSC_LAYOUT_YUYV);
+    csc_linear_to_tiled_frame(ctx->out[0], ctx->out[1], &ctx->frame, &ctx->y_map, &ctx->uv_map);
+}
+
+static void run_tiled_frame_i420_parallel(CSC_BENCH_CTX *ctx)
+{
+    csc_bench_set_src_frame(ctx, CSC_LAYOUT_I420);
+    csc_linear_to_tiled_frame_parallel(ctx->out[0], ctx->out[1], &ctx->frame, &ctx->y_map, &ctx->uv_map);
+}
+
+static const CSC_BENCH_TEST csc_bench_tests[] = {
+    { "deinterleave_memcpy",                  run_deinterleave_memcpy,                  check_deinterleave, 1 },
+    { "interleave_memcpy",                    run_interleave_memcpy,                    check_interleave,   1 },
+    { "tiled_to_linear(y)",                   run_tiled_to_linear_y,                    check_linear_y,     0 },
+    { "tiled_to_linear(uv)",                  run_tiled_to_linear_uv,                   check_linear_uv,    1 },
+    { "tiled_to_linear_deinterleave",         run_tiled_to_linear_deinterleave,         check_linear_u_v,   1 },
+    { "linear_to_tiled(y)",                   run_linear_to_tiled_y,                    check_tiled_y,      0 },
+    { "linear_to_tiled_interleave",           run_linear_to_tiled_interleave,           check_tiled_uv,     1 },
+    { "tiled_to_linear_map(y)",               run_tiled_to_linear_y_map,                check_linear_y,     0 },
+    { "tiled_to_linear_map(uv)",              run_tiled_to_linear_uv_map,               check_linear_uv,    1 },
+    { "tiled_to_linear_deinterleave_map",     run_tiled_to_linear_deinterleave_map,     check_linear_u_v,   1 },
+    { "tiled_to_linear_frame(nv12)",          run_frame_nv12,                           check_frame,        0 },
+    { "tiled_to_linear_frame(nv21)",          run_frame_nv21,                           check_frame,        0 },
+    { "tiled_to_linear_frame(i420)",          run_frame_i420,                           check_frame,        0 },
+    { "tiled_to_linear_frame(nv12 packed)",   run_frame_nv12_packed,                    check_frame,        0 },
+    { "tiled_to_linear_frame(i420 packed)",   run_frame_i420_packed,                    check_frame,        0 },
+    { "linear_to_tiled_frame(nv12)",          run_tiled_frame_nv12,                     check_tiled_frame,  0 },
+    { "linear_to_tiled_frame(nv21)",          run_tiled_frame_nv21,                     check_tiled_frame,  0 },
+    { "linear_to_tiled_frame(i420)",          run_tiled_frame_i420,                     check_tiled_frame,  0 },
+    { "linear_to_tiled_frame(yuyv)",          run_tiled_frame_yuyv,                     check_tiled_frame,  0 },
+    { "tiled_to_linear_parallel(y)",          run_tiled_to_linear_y_parallel,           check_linear_y,     0 },
+    { "tiled_to_linear_parallel(uv)",         run_tiled_to_linear_uv_parallel,          check_linear_uv,    1 },
+    { "tiled_to_linear_deinterleave_parallel", run_tiled_to_linear_deinterleave_parallel, check_linear_u_v, 1 },
+    { "linear_to_tiled_parallel(y)",          run_linear_to_tiled_y_parallel,           check_tiled_y,      0 },
+    { "linear_to_tiled_interleave_parallel",  run_linear_to_tiled_interleave_parallel,  check_tiled_uv,     1 },
+    { "tiled_to_linear_frame_parallel(i420)", run_frame_i420_parallel,                  check_frame,        0 },
+    { "tiled_to_linear_frame_par(i420 packed)", run_frame_i420_packed_parallel,         check_frame,        0 },
+    { "linear_to_tiled_frame_parallel(i420)", run_tiled_frame_i420_parallel,            check_tiled_frame,  0 },
+};
+
+/*--------------------------------------------------------------------------------*/
+/* Timing                                                                         */
+/*--------------------------------------------------------------------------------*/
+static double csc_bench_cpu_mhz = 0;
+
+static double csc_bench_now_ns(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static unsigned long long csc_bench_cycles(void)
+{
+#ifdef CSC_BENCH_HAVE_TSC
+    return __rdtsc();
+#else
+    return 0;
+#endif
+}
+
+/*
+ * Without a cycle counter cycles are estimated from the maximum clock
+ * of cpu0, or from the -m option
+ */
+static void csc_bench_init_cpu_mhz(void)
+{
+    FILE *fp;
+    long khz = 0;
+
+    if (csc_bench_cpu_mhz > 0)
+        return;
+
+    fp = fopen("/sys/devices/system/cpu/cpu0/cpufreq/cpuinfo_max_freq", "r");
+    if (fp != NULL) {
+        if (fscanf(fp, "%ld", &khz) != 1)
+            khz = 0;
+        fclose(fp);
+    }
+    csc_bench_cpu_mhz = khz / 1000.0;
+}
+
+/*--------------------------------------------------------------------------------*/
+/* Main                                                                           */
+/*--------------------------------------------------------------------------------*/
+static int csc_bench_ctx_init(CSC_BENCH_CTX *ctx, int width, int height)
+{
+    int stride = width + CSC_BENCH_STRIDE_PAD;
+    int i, x, y;
+
+    memset(ctx, 0, sizeof(CSC_BENCH_CTX));
+    ctx->width = width;
+    ctx->height = height;
+    ctx->uv_height = height / 2;
+    ctx->tiled_y_size = ref_tiled_size(width, height);
+    ctx->tiled_uv_size = ref_tiled_size(width, ctx->uv_height);
+
+    ctx->tiled_y = malloc(ctx->tiled_y_size);
+    ctx->tiled_uv = malloc(ctx->tiled_uv_size);
+    ctx->ref_y = malloc(width * height);
+    ctx->ref_uv = malloc(width * ctx->uv_height);
+    ctx->ref_u = malloc(width / 2 * ctx->uv_height);
+    ctx->ref_v = malloc(width / 2 * ctx->uv_height);
+    ctx->src_y = malloc(stride * height);
+    ctx->src_uv = malloc(stride * ctx->uv_height);
+    ctx->src_vu = malloc(stride * ctx->uv_height);
+    ctx->src_u = malloc(stride / 2 * ctx->uv_height);
+    ctx->src_v = malloc(stride / 2 * ctx->uv_height);
+    ctx->src_yuyv = malloc(stride * 2 * height);
+
+    /* large enough for a tiled plane and for a linear plane with stride */
+    ctx->out_size[0] = ctx->tiled_y_size;
+    if (ctx->out_size[0] < stride * height)
+        ctx->out_size[0] = stride * height;
+    ctx->out_size[1] = ctx->tiled_uv_size;
+    if (ctx->out_size[1] < stride * ctx->uv_height)
+        ctx->out_size[1] = stride * ctx->uv_height;
+    ctx->out_size[2] = stride / 2 * ctx->uv_height;
+    for (i = 0; i < 3; i++)
+        ctx->out[i] = malloc(ctx->out_size[i] + CSC_BENCH_GUARD);
+
+    if (!ctx->tiled_y || !ctx->tiled_uv || !ctx->ref_y || !ctx->ref_uv || !ctx->ref_u || !ctx->ref_v ||
+        !ctx->src_y || !ctx->src_uv || !ctx->src_vu || !ctx->src_u || !ctx->src_v || !ctx->src_yuyv ||
+        !ctx->out[0] || !ctx->out[1] || !ctx->out[2])
+        return -1;
+
+    for (i = 0; i < ctx->tiled_y_size; i++)
+        ctx->tiled_y[i] = rand();
+    for (i = 0; i < ctx->tiled_uv_size; i++)
+        ctx->tiled_uv[i] = rand();
+
+    ref_tiled_to_linear(ctx->ref_y, ctx->tiled_y, width, height);
+    ref_tiled_to_linear(ctx->ref_uv, ctx->tiled_uv, width, ctx->uv_height);
+    ref_deinterleave(ctx->ref_u, ctx->ref_v, ctx->ref_uv, width * ctx->uv_height);
+
+    /* padding of the sources is random, it must not reach the tiles */
+    for (i = 0; i < stride * 2 * height; i++)
+        ctx->src_yuyv[i] = rand();
+    for (y = 0; y < height; y++) {
+        memset(ctx->src_y + y * stride + width, rand(), stride - width);
+        memcpy(ctx->src_y + y * stride, ctx->ref_y + y * width, width);
+        for (x = 0; x < width; x++)
+            ctx->src_yuyv[y * stride * 2 + x * 2] = ctx->ref_y[y * width + x];
+    }
+    for (y = 0; y < ctx->uv_height; y++) {
+        memset(ctx->src_uv + y * stride + width, rand(), stride - width);
+        memset(ctx->src_vu + y * stride + width, rand(), stride - width);
+        memset(ctx->src_u + y * (stride / 2) + width / 2, rand(), stride / 2 - width / 2);
+        memset(ctx->src_v + y * (stride / 2) + width / 2, rand(), stride / 2 - width / 2);
+        memcpy(ctx->src_uv + y * stride, ctx->ref_uv + y * width, width);
+        memcpy(ctx->src_u + y * (stride / 2), ctx->ref_u + y * (width / 2), width / 2);
+        memcpy(ctx->src_v + y * (stride / 2), ctx->ref_v + y * (width / 2), width / 2);
+        for (x = 0; x < width; x += 2) {
+            ctx->src_vu[y * stride + x] = ctx->ref_uv[y * width + x + 1];
+            ctx->src_vu[y * stride + x + 1] = ctx->ref_uv[y * width + x];
+            /* chroma of the even lines only */
+            ctx->src_yuyv[y * 2 * stride * 2 + x * 2 + 1] = ctx->ref_uv[y * width + x];
+            ctx->src_yuyv[y * 2 * stride * 2 + x * 2 + 3] = ctx->ref_uv[y * width + x + 1];
+        }
+    }
+
+    if (csc_tile_map_update(&ctx->y_map, width, height) != 0 ||
+        csc_tile_map_update(&ctx->uv_map, width, ctx->uv_height) != 0)
+        return -1;
+
+    return 0;
+}
+
+static void csc_bench_ctx_deinit(CSC_BENCH_CTX *ctx)
+{
+    int i;
+
+    free(ctx->tiled_y);
+    free(ctx->tiled_uv);
+    free(ctx->ref_y);
+    free(ctx->ref_uv);
+    free(ctx->ref_u);
+    free(ctx->ref_v);
+    free(ctx->src_y);
+    free(ctx->src_uv);
+    free(ctx->src_vu);
+    free(ctx->src_u);
+    free(ctx->src_v);
+    free(ctx->src_yuyv);
+    for (i = 0; i < 3; i++)
+        free(ctx->out[i]);
+    csc_tile_map_release(&ctx->y_map);
+    csc_tile_map_release(&ctx->uv_map);
+}
+
+static int csc_bench_run(CSC_BENCH_CTX *ctx, const CSC_BENCH_TEST *test, int iterations)
+{
+    unsigned long long cycles;
+    double ns, bytes, pixels, cpp;
+    int mismatch;
+    int i;
+
+    csc_bench_clear(ctx);
+    test->run(ctx);
+    mismatch = test->check(ctx);
+
+    cycles = csc_bench_cycles();
+    ns = csc_bench_now_ns();
+    for (i = 0; i < iterations; i++)
+        test->run(ctx);
+    ns = csc_bench_now_ns() - ns;
+    cycles = csc_bench_cycles() - cycles;
+
+    pixels = (double)ctx->width * ctx->height * iterations;
+    bytes = test->uv_only ? pixels / 2 : pixels;
+    if (cycles == 0)
+        cycles = (unsigned long long)(ns * csc_bench_cpu_mhz / 1000.0);
+    cpp = cycles / pixels;
+
+    printf("%-9s %-38s %4dx%-4d %9.1f %8.3f %8d%s\n",
+           csc_get_backend_name(csc_get_backend()), test->name, ctx->width, ctx->height,
+           bytes / (ns / 1e9) / 1e6, cpp, mismatch, mismatch ? "  FAIL" : "");
+
+    return mismatch;
+}
+
+static void csc_bench_usage(const char *name)
+{
+    printf("usage: %s [-b backend] [-s WxH] [-n iterations] [-m cpu_mhz] [-v]\n", name);
+    printf("  -b  backend to test, default all available\n");
+    printf("  -s  resolution to test, default built in matrix\n");
+    printf("  -n  iterations at 1080p, scaled up for smaller sizes, default 20\n");
+    printf("  -m  cpu clock used for cycles/pixel when there is no cycle counter\n");
+    printf("  -v  print first mismatching bytes\n");
+}
+
+int main(int argc, char **argv)
+{
+    CSC_BENCH_SIZE custom_size;
+    const CSC_BENCH_SIZE *sizes = csc_bench_sizes;
+    int size_num = sizeof(csc_bench_sizes) / sizeof(csc_bench_sizes[0]);
+    int backend_only = CSC_BACKEND_AUTO;
+    int iterations = 20;
+    int total_mismatch = 0;
+    CSC_BENCH_CTX ctx;
+    int backend, s, t, i, n;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp(argv[i], "-b") && i + 1 < argc) {
+            i++;
+            for (backend = CSC_BACKEND_C; backend < CSC_BACKEND_MAX; backend++) {
+                if (!strcmp(argv[i], csc_get_backend_name(backend)))
+                    backend_only = backend;
+            }
+            if (backend_only == CSC_BACKEND_AUTO) {
+                printf("unknown backend %s\n", argv[i]);
+                return 2;
+            }
+        } else if (!strcmp(argv[i], "-s") && i + 1 < argc) {
+            i++;
+            if (sscanf(argv[i], "%dx%d", &custom_size.width, &custom_size.height) != 2 ||
+                custom_size.width < 2 || custom_size.height < 2 ||
+                (custom_size.width & 1) || (custom_size.height & 1)) {
+                printf("invalid size %s, width and height must be even\n", argv[i]);
+                return 2;
+            }
+            sizes = &custom_size;
+            size_num = 1;
+        } else if (!strcmp(argv[i], "-n") && i + 1 < argc) {
+            iterations = atoi(argv[++i]);
+            if (iterations < 1)
+                iterations = 1;
+        } else if (!strcmp(argv[i], "-m") && i + 1 < argc) {
+            csc_bench_cpu_mhz = atof(argv[++i]);
+        } else if (!strcmp(argv[i], "-v")) {
+            csc_bench_verbose = 1;
+        } else {
+            csc_bench_usage(argv[0]);
+            return 2;
+        }
+    }
+
+    csc_bench_init_cpu_mhz();
+    csc_parallel_open();
+
+    printf("csc_bench: %d thread(s) for parallel conversion", csc_parallel_thread_num());
+#ifdef CSC_BENCH_HAVE_TSC
+    printf(", cycles from TSC\n");
+#else
+    if (csc_bench_cpu_mhz > 0)
+        printf(", cycles estimated at %.0f MHz\n", csc_bench_cpu_mhz);
+    else
+        printf(", no cycle counter\n");
+#endif
+    printf("%-9s %-38s %9s %9s %8s %8s\n", "backend", "function", "size", "MB/s", "cyc/px", "mismatch");
+
+    srand(1);
+    for (s = 0; s < size_num; s++) {
+        if (csc_bench_ctx_init(&ctx, sizes[s].width, sizes[s].height) != 0) {
+            printf("out of memory at %dx%d\n", sizes[s].width, sizes[s].height);
+            csc_bench_ctx_deinit(&ctx);
+            csc_parallel_close();
+            return 2;
+        }
+
+        n = (int)((double)iterations * (1920 * 1080) / (sizes[s].width * sizes[s].height));
+        if (n < iterations)
+            n = iterations;
+
+        for (backend = CSC_BACKEND_C; backend < CSC_BACKEND_MAX; backend++) {
+            if (backend_only != CSC_BACKEND_AUTO && backend != backend_only)
+                continue;
+            if (csc_init(backend) != 0)
+                continue;
+            for (t = 0; t < (int)(sizeof(csc_bench_tests) / sizeof(csc_bench_tests[0])); t++)
+                total_mismatch += csc_bench_run(&ctx, &csc_bench_tests[t], n);
+        }
+
+        csc_bench_ctx_deinit(&ctx);
+    }
+
+    csc_parallel_close();
+
+    if (total_mismatch != 0) {
+        printf("csc_bench: %d mismatching bytes\n", total_mismatch);
+        return 1;
+    }
+
+    printf("csc_bench: all outputs bit exact\n");
+    return 0;
+}
@@ -16,7 +16,7 @@
  */
 
 /*
- * @file    csc_deinterleave_memcpy.s
+ * @file    csc_deinterleave_memcpy_neon_asm.s
  * @brief   SEC_OMX specific define
  * @author  ShinWon Lee (shinwon.lee@samsung.com)
  * @version 1.0
@@ -25,9 +25,9 @@
  */
     .arch armv7-a
     .text
-    .global csc_deinterleave_memcpy
-    .type   csc_deinterleave_memcpy, %function
-csc_deinterleave_memcpy:
+    .global csc_deinterleave_memcpy_neon_asm
+    .type   csc_deinterleave_memcpy_neon_asm, %function
+csc_deinterleave_memcpy_neon_asm:
     .fnstart
 
     @r0     dest1
@@ -0,0 +1,250 @@
+/*
+ *
+ * Copyright 2011 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    csc_dispatch.c
+ * @brief   Runtime selection of csc backend
+ *   The public csc_* entry points forward to the backend chosen by
+ *   csc_init(). If csc_init() is never called, the fastest backend
+ *   available on the running CPU is chosen on first use.
+ * @version 1.0
+ */
+
+#include <stdlib.h>
+#include <pthread.h>
+#include "color_space_convertor.h"
+#include "csc_backend.h"
+
+static const CSC_BACKEND_OPS csc_ops_c = {
+    CSC_BACKEND_C,
+    csc_deinterleave_memcpy_c,
+    csc_interleave_memcpy_c,
+    csc_tiled_to_linear_c,
+    csc_tiled_to_linear_deinterleave_c,
+    csc_linear_to_tiled_c,
+    csc_linear_to_tiled_interleave_c,
+    csc_tiled_to_linear_map_c,
+    csc_tiled_to_linear_deinterleave_map_c,
+};
+
+#ifdef USE_CSC_NEON_ASM
+static const CSC_BACKEND_OPS csc_ops_neon_asm = {
+    CSC_BACKEND_NEON_ASM,
+    csc_deinterleave_memcpy_neon_asm,
+    csc_interleave_memcpy_neon_asm,
+    csc_tiled_to_linear_neon_asm,
+    csc_tiled_to_linear_deinterleave_neon_asm,
+    csc_linear_to_tiled_neon_asm,
+    csc_linear_to_tiled_interleave_neon_asm,
+    /* the assembly has no map walker, the intrinsic one is used */
+#ifdef CSC_HAVE_NEON
+    csc_tiled_to_linear_map_neon,
+    csc_tiled_to_linear_deinterleave_map_neon,
+#else
+    csc_tiled_to_linear_map_c,
+    csc_tiled_to_linear_deinterleave_map_c,
+#endif
+};
+#endif
+
+/* Order of preference for CSC_BACKEND_AUTO */
+static const CSC_BACKEND csc_auto_order[] = {
+    CSC_BACKEND_AVX2,
+    CSC_BACKEND_SSE2,
+    CSC_BACKEND_NEON_ASM,
+    CSC_BACKEND_NEON,
+    CSC_BACKEND_C,
+};
+
+static const CSC_BACKEND_OPS *csc_ops = NULL;
+static pthread_once_t csc_ops_once = PTHREAD_ONCE_INIT;
+
+static const CSC_BACKEND_OPS *csc_find_backend(CSC_BACKEND backend)
+{
+    switch (backend) {
+    case CSC_BACKEND_C:
+        return &csc_ops_c;
+#ifdef USE_CSC_NEON_ASM
+    case CSC_BACKEND_NEON_ASM:
+        return &csc_ops_neon_asm;
+#endif
+#ifdef CSC_HAVE_NEON
+    case CSC_BACKEND_NEON:
+        return &csc_ops_neon;
+#endif
+#ifdef CSC_HAVE_SSE2
+    case CSC_BACKEND_SSE2:
+        return &csc_ops_sse2;
+#endif
+#ifdef CSC_HAVE_AVX2
+    case CSC_BACKEND_AVX2:
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+            return &csc_ops_avx2;
+        break;
+#endif
+    default:
+        break;
+    }
+
+    return NULL;
+}
+
+static void csc_init_default(void)
+{
+    if (csc_ops == NULL)
+        csc_init(CSC_BACKEND_AUTO);
+}
+
+/* decoder and encoder threads may both make the first call */
+static inline const CSC_BACKEND_OPS *csc_get_ops(void)
+{
+    if (csc_ops == NULL)
+        pthread_once(&csc_ops_once, csc_init_default);
+
+    return csc_ops;
+}
+
+/*
+ * Selects backend used by the csc_* functions
+ *
+ * @param backend
+ *   Backend to use, CSC_BACKEND_AUTO for the fastest available[in]
+ *
+ * @return
+ *   0 on success, -1 if backend is not available on this CPU
+ */
+int csc_init(CSC_BACKEND backend)
+{
+    const CSC_BACKEND_OPS *ops = NULL;
+    unsigned int i;
+
+    if (backend == CSC_BACKEND_AUTO) {
+        for (i = 0; (ops == NULL) && (i < sizeof(csc_auto_order) / sizeof(csc_auto_order[0])); i++)
+            ops = csc_find_backend(csc_auto_order[i]);
+    } else {
+        ops = csc_find_backend(backend);
+    }
+
+    if (ops == NULL)
+        return -1;
+
+    csc_ops = ops;
+
+    return 0;
+}
+
+/*
+ * Returns backend currently used by the csc_* functions
+ */
+CSC_BACKEND csc_get_backend(void)
+{
+    return csc_get_ops()->backend;
+}
+
+/*
+ * Returns non-zero if backend can run on this CPU
+ *
+ * @param backend
+ *   Backend to check[in]
+ */
+int csc_backend_available(CSC_BACKEND backend)
+{
+    return csc_find_backend(backend) != NULL;
+}
+
+/*
+ * Returns printable name of backend
+ *
+ * @param backend
+ *   Backend[in]
+ */
+const char *csc_get_backend_name(CSC_BACKEND backend)
+{
+    switch (backend) {
+    case CSC_BACKEND_AUTO:
+        return "auto";
+    case CSC_BACKEND_C:
+        return "c";
+    case CSC_BACKEND_NEON:
+        return "neon";
+    case CSC_BACKEND_NEON_ASM:
+        return "neon_asm";
+    case CSC_BACKEND_SSE2:
+        return "sse2";
+    case CSC_BACKEND_AVX2:
+        return "avx2";
+    default:
+        break;
+    }
+
+    return "unknown";
+}
+
+void csc_deinterleave_memcpy(char *dest1, char *dest2, char *src, int src_size)
+{
+    csc_get_ops()->deinterleave_memcpy(dest1, dest2, src, src_size);
+}
+
+void csc_interleave_memcpy(char *dest, char *src1, char *src2, int src_size)
+{
+    csc_get_ops()->interleave_memcpy(dest, src1, src2, src_size);
+}
+
+void csc_tiled_to_linear(char *yuv420_dest, char *nv12t_src, int yuv420_width, int yuv420_height)
+{
+    csc_get_ops()->tiled_to_linear(yuv420_dest, nv12t_src, yuv420_width, yuv420_height);
+}
+
+void csc_tiled_to_linear_deinterleave(char *yuv420_u_dest, char *yuv420_v_dest, char *nv12t_uv_src, int yuv420_width, int yuv420_uv_height)
+{
+    csc_get_ops()->tiled_to_linear_deinterleave(yuv420_u_dest, yuv420_v_dest, nv12t_uv_src, yuv420_width, yuv420_uv_height);
+}
+
+void csc_linear_to_tiled(char *nv12t_dest, char *yuv420_src, int yuv420_width, int yuv420_height)
+{
+    csc_get_ops()->linear_to_tiled(nv12t_dest, yuv420_src, yuv420_width, yuv420_height);
+}
+
+void csc_linear_to_tiled_interleave(char *nv12t_uv_dest, char *yuv420p_u_src, char *yuv420p_v_src, int yuv420_width, int yuv420_uv_height)
+{
+    csc_get_ops()->linear_to_tiled_interleave(nv12t_uv_dest, yuv420p_u_src, yuv420p_v_src, yuv420_width, yuv420_uv_height);
+}
+
+void csc_tiled_to_linear_map(char *yuv420_dest, char *nv12t_src, CSC_TILE_MAP *map)
+{
+    csc_get_ops()->tiled_to_linear_map(yuv420_dest, map->width, nv12t_src, map, 0, map->y_tile_num);
+}
+
+void csc_tiled_to_linear_deinterleave_map(char *yuv420_u_dest, char *yuv420_v_dest, char *nv12t_uv_src, CSC_TILE_MAP *map)
+{
+    csc_get_ops()->tiled_to_linear_deinterleave_map(yuv420_u_dest, yuv420_v_dest, map->width / 2, map->width / 2,
+                                                    nv12t_uv_src, map, 0, map->y_tile_num);
+}
+
+void csc_tiled_to_linear_map_rows(char *yuv420_dest, int dest_stride, char *nv12t_src, CSC_TILE_MAP *map,
+                                  int tile_row_start, int tile_row_end)
+{
+    csc_get_ops()->tiled_to_linear_map(yuv420_dest, dest_stride, nv12t_src, map, tile_row_start, tile_row_end);
+}
+
+void csc_tiled_to_linear_deinterleave_map_rows(char *yuv420_u_dest, char *yuv420_v_dest, int u_stride, int v_stride,
+                                               char *nv12t_uv_src, CSC_TILE_MAP *map, int tile_row_start, int tile_row_end)
+{
+    csc_get_ops()->tiled_to_linear_deinterleave_map(yuv420_u_dest, yuv420_v_dest, u_stride, v_stride,
+                                                    nv12t_uv_src, map, tile_row_start, tile_row_end);
+}
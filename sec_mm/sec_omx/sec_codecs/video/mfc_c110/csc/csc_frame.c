@@ -0,0 +1,282 @@
+/*
+ *
+ * Copyright 2011 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    csc_frame.c
+ * @brief   Fused conversion between NV12T and linear frames
+ *   Converts Y and UV of a NV12T frame in one walk, band by band, and
+ *   writes straight into the final NV12, NV21 or I420 layout with an
+ *   arbitrary stride per plane. A band is one UV tile row and the two
+ *   Y tile rows covering the same picture lines.
+ *   The other way, NV12, NV21, I420 or YUYV frames with any stride are
+ *   written straight into NV12T, e.g. into the encoder input buffer.
+ * @version 1.0
+ */
+
+#include <string.h>
+#include "color_space_convertor.h"
+#include "csc_backend.h"
+
+/* NV21 has no backend walker, CbCr is swapped pair by pair */
+static void csc_frame_copy_vu(CSC_LINEAR_FRAME *dest, char *nv12t_uv_src, CSC_TILE_MAP *map, int tile_row)
+{
+    int x, row, rows, cols, i;
+    unsigned int *tile_offset;
+    char *src, *dst;
+
+    if (tile_row >= map->y_tile_num)
+        return;
+
+    rows = map->height - tile_row * CSC_TILE_HEIGHT;
+    if (rows > CSC_TILE_HEIGHT)
+        rows = CSC_TILE_HEIGHT;
+
+    tile_offset = map->tile_offset + tile_row * map->x_tile_num;
+    for (x = 0; x < map->x_tile_num; x++) {
+        src = nv12t_uv_src + tile_offset[x];
+        cols = map->width - x * CSC_TILE_WIDTH;
+        if (cols > CSC_TILE_WIDTH)
+            cols = CSC_TILE_WIDTH;
+
+        dst = dest->plane[1] + dest->stride[1] * tile_row * CSC_TILE_HEIGHT + x * CSC_TILE_WIDTH;
+        for (row = 0; row < rows; row++) {
+            for (i = 0; i < cols - 1; i += 2) {
+                dst[i] = src[i+1];
+                dst[i+1] = src[i];
+            }
+            dst += dest->stride[1];
+            src += CSC_TILE_WIDTH;
+        }
+    }
+}
+
+/*
+ * Converts bands [band_start, band_end) of NV12T frame to linear frame
+ */
+void csc_tiled_to_linear_frame_bands(CSC_LINEAR_FRAME *dest, char *nv12t_y_src, char *nv12t_uv_src,
+                                     CSC_TILE_MAP *y_map, CSC_TILE_MAP *uv_map, int band_start, int band_end)
+{
+    int band;
+
+    for (band = band_start; band < band_end; band++) {
+        csc_tiled_to_linear_map_rows(dest->plane[0], dest->stride[0], nv12t_y_src, y_map, band * 2, band * 2 + 2);
+
+        switch (dest->layout) {
+        case CSC_LAYOUT_I420:
+            csc_tiled_to_linear_deinterleave_map_rows(dest->plane[1], dest->plane[2], dest->stride[1], dest->stride[2],
+                                                      nv12t_uv_src, uv_map, band, band + 1);
+            break;
+        case CSC_LAYOUT_NV21:
+            csc_frame_copy_vu(dest, nv12t_uv_src, uv_map, band);
+            break;
+        case CSC_LAYOUT_NV12:
+        default:
+            csc_tiled_to_linear_map_rows(dest->plane[1], dest->stride[1], nv12t_uv_src, uv_map, band, band + 1);
+            break;
+        }
+    }
+}
+
+/*
+ * Returns number of bands of NV12T frame
+ */
+int csc_tiled_frame_band_num(CSC_TILE_MAP *y_map, CSC_TILE_MAP *uv_map)
+{
+    int y_bands = (y_map->y_tile_num + 1) / 2;
+
+    return (y_bands > uv_map->y_tile_num) ? y_bands : uv_map->y_tile_num;
+}
+
+/*
+ * Converts NV12T frame to linear frame in one pass
+ *   Tile addresses come from the maps and the rows are moved by the map
+ *   walkers of the selected backend, for packed and padded strides alike.
+ *
+ * @param dest
+ *   Layout, plane addresses and strides of linear frame[out]
+ *
+ * @param nv12t_y_src
+ *   Y plane address of NV12T[in]
+ *
+ * @param nv12t_uv_src
+ *   UV plane address of NV12T[in]
+ *
+ * @param y_map
+ *   Tile map built for width and height of YUV420[in]
+ *
+ * @param uv_map
+ *   Tile map built for width and height/2 of YUV420[in]
+ */
+void csc_tiled_to_linear_frame(CSC_LINEAR_FRAME *dest, char *nv12t_y_src, char *nv12t_uv_src,
+                               CSC_TILE_MAP *y_map, CSC_TILE_MAP *uv_map)
+{
+    csc_tiled_to_linear_frame_bands(dest, nv12t_y_src, nv12t_uv_src, y_map, uv_map,
+                                    0, csc_tiled_frame_band_num(y_map, uv_map));
+}
+
+static void csc_frame_put_y(char *nv12t_y_dest, CSC_LINEAR_FRAME *src, CSC_TILE_MAP *map, int tile_row)
+{
+    int x, row, rows, cols, i;
+    int stride = src->stride[0];
+    unsigned int *tile_offset;
+    char *s, *dst;
+
+    if (tile_row >= map->y_tile_num)
+        return;
+
+    rows = map->height - tile_row * CSC_TILE_HEIGHT;
+    if (rows > CSC_TILE_HEIGHT)
+        rows = CSC_TILE_HEIGHT;
+
+    tile_offset = map->tile_offset + tile_row * map->x_tile_num;
+    for (x = 0; x < map->x_tile_num; x++) {
+        dst = nv12t_y_dest + tile_offset[x];
+        cols = map->width - x * CSC_TILE_WIDTH;
+        if (cols > CSC_TILE_WIDTH)
+            cols = CSC_TILE_WIDTH;
+
+        if (src->layout == CSC_LAYOUT_YUYV) {
+            s = src->plane[0] + stride * tile_row * CSC_TILE_HEIGHT + x * CSC_TILE_WIDTH * 2;
+            for (row = 0; row < rows; row++) {
+                for (i = 0; i < cols; i++)
+                    dst[i] = s[i * 2];
+                dst += CSC_TILE_WIDTH;
+                s += stride;
+            }
+        } else {
+            s = src->plane[0] + stride * tile_row * CSC_TILE_HEIGHT + x * CSC_TILE_WIDTH;
+            for (row = 0; row < rows; row++) {
+                memcpy(dst, s, cols);
+                dst += CSC_TILE_WIDTH;
+                s += stride;
+            }
+        }
+    }
+}
+
+static void csc_frame_put_uv(char *nv12t_uv_dest, CSC_LINEAR_FRAME *src, CSC_TILE_MAP *map, int tile_row)
+{
+    int x, row, rows, cols, i;
+    unsigned int *tile_offset;
+    char *s, *u_src, *v_src, *dst;
+
+    if (tile_row >= map->y_tile_num)
+        return;
+
+    rows = map->height - tile_row * CSC_TILE_HEIGHT;
+    if (rows > CSC_TILE_HEIGHT)
+        rows = CSC_TILE_HEIGHT;
+
+    tile_offset = map->tile_offset + tile_row * map->x_tile_num;
+    for (x = 0; x < map->x_tile_num; x++) {
+        dst = nv12t_uv_dest + tile_offset[x];
+        cols = map->width - x * CSC_TILE_WIDTH;
+        if (cols > CSC_TILE_WIDTH)
+            cols = CSC_TILE_WIDTH;
+
+        switch (src->layout) {
+        case CSC_LAYOUT_I420:
+        {
+            u_src = src->plane[1] + src->stride[1] * tile_row * CSC_TILE_HEIGHT + x * (CSC_TILE_WIDTH / 2);
+            v_src = src->plane[2] + src->stride[2] * tile_row * CSC_TILE_HEIGHT + x * (CSC_TILE_WIDTH / 2);
+            for (row = 0; row < rows; row++) {
+                csc_interleave_memcpy(dst, u_src, v_src, cols / 2);
+                dst += CSC_TILE_WIDTH;
+                u_src += src->stride[1];
+                v_src += src->stride[2];
+            }
+        }
+            break;
+        case CSC_LAYOUT_YUYV:
+        {
+            /* chroma of the even lines, Cb and Cr are the odd bytes */
+            s = src->plane[0] + src->stride[0] * 2 * tile_row * CSC_TILE_HEIGHT + x * CSC_TILE_WIDTH * 2;
+            for (row = 0; row < rows; row++) {
+                for (i = 0; i < cols; i++)
+                    dst[i] = s[i * 2 + 1];
+                dst += CSC_TILE_WIDTH;
+                s += src->stride[0] * 2;
+            }
+        }
+            break;
+        case CSC_LAYOUT_NV21:
+        {
+            s = src->plane[1] + src->stride[1] * tile_row * CSC_TILE_HEIGHT + x * CSC_TILE_WIDTH;
+            for (row = 0; row < rows; row++) {
+                for (i = 0; i < cols - 1; i += 2) {
+                    dst[i] = s[i+1];
+                    dst[i+1] = s[i];
+                }
+                dst += CSC_TILE_WIDTH;
+                s += src->stride[1];
+            }
+        }
+            break;
+        case CSC_LAYOUT_NV12:
+        default:
+        {
+            s = src->plane[1] + src->stride[1] * tile_row * CSC_TILE_HEIGHT + x * CSC_TILE_WIDTH;
+            for (row = 0; row < rows; row++) {
+                memcpy(dst, s, cols);
+                dst += CSC_TILE_WIDTH;
+                s += src->stride[1];
+            }
+        }
+            break;
+        }
+    }
+}
+
+/*
+ * Converts bands [band_start, band_end) of linear frame to NV12T frame
+ */
+void csc_linear_to_tiled_frame_bands(char *nv12t_y_dest, char *nv12t_uv_dest, CSC_LINEAR_FRAME *src,
+                                     CSC_TILE_MAP *y_map, CSC_TILE_MAP *uv_map, int band_start, int band_end)
+{
+    int band;
+
+    for (band = band_start; band < band_end; band++) {
+        csc_frame_put_y(nv12t_y_dest, src, y_map, band * 2);
+        csc_frame_put_y(nv12t_y_dest, src, y_map, band * 2 + 1);
+        csc_frame_put_uv(nv12t_uv_dest, src, uv_map, band);
+    }
+}
+
+/*
+ * Converts linear frame to NV12T frame in one pass
+ *
+ * @param nv12t_y_dest
+ *   Y plane address of NV12T[out]
+ *
+ * @param nv12t_uv_dest
+ *   UV plane address of NV12T[out]
+ *
+ * @param src
+ *   Layout, plane addresses and strides of linear frame[in]
+ *
+ * @param y_map
+ *   Tile map built for width and height of YUV420[in]
+ *
+ * @param uv_map
+ *   Tile map built for width and height/2 of YUV420[in]
+ */
+void csc_linear_to_tiled_frame(char *nv12t_y_dest, char *nv12t_uv_dest, CSC_LINEAR_FRAME *src,
+                               CSC_TILE_MAP *y_map, CSC_TILE_MAP *uv_map)
+{
+    csc_linear_to_tiled_frame_bands(nv12t_y_dest, nv12t_uv_dest, src, y_map, uv_map,
+                                    0, csc_tiled_frame_band_num(y_map, uv_map));
+}
@@ -16,7 +16,7 @@
  */
 
 /*
- * @file    csc_interleave_memcpy.s
+ * @file    csc_interleave_memcpy_neon_asm.s
  * @brief   SEC_OMX specific define
  * @author  ShinWon Lee (shinwon.lee@samsung.com)
  * @version 1.0
@@ -25,9 +25,9 @@
  */
     .arch armv7-a
     .text
-    .global csc_interleave_memcpy
-    .type   csc_interleave_memcpy, %function
-csc_interleave_memcpy:
+    .global csc_interleave_memcpy_neon_asm
+    .type   csc_interleave_memcpy_neon_asm, %function
+csc_interleave_memcpy_neon_asm:
     .fnstart
 
     @r0     dest
@@ -0,0 +1,113 @@
+/*
+ *
+ * Copyright 2011 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    csc_neon.c
+ * @brief   NEON intrinsic backend of csc
+ *   Portable counterpart of the hand written csc_*.s files. Builds for
+ *   any NEON capable ARM target, including ones the assembly does not
+ *   support.
+ * @version 1.0
+ */
+
+#include "csc_backend.h"
+
+#ifdef CSC_HAVE_NEON
+
+#include <arm_neon.h>
+
+static inline void csc_row_copy64(char *dest, const char *src)
+{
+    uint8x16_t a = vld1q_u8((const uint8_t *)(src));
+    uint8x16_t b = vld1q_u8((const uint8_t *)(src + 16));
+    uint8x16_t c = vld1q_u8((const uint8_t *)(src + 32));
+    uint8x16_t d = vld1q_u8((const uint8_t *)(src + 48));
+    vst1q_u8((uint8_t *)(dest), a);
+    vst1q_u8((uint8_t *)(dest + 16), b);
+    vst1q_u8((uint8_t *)(dest + 32), c);
+    vst1q_u8((uint8_t *)(dest + 48), d);
+}
+
+static inline void csc_row_deinterleave(char *dest1, char *dest2, const char *src, int src_size)
+{
+    int i = 0;
+
+    for (; i + 32 <= src_size; i += 32) {
+        uint8x16x2_t uv = vld2q_u8((const uint8_t *)(src + i));
+        vst1q_u8((uint8_t *)(dest1 + i/2), uv.val[0]);
+        vst1q_u8((uint8_t *)(dest2 + i/2), uv.val[1]);
+    }
+    for (; i < src_size - 1; i += 2) {
+        dest1[i/2] = src[i];
+        dest2[i/2] = src[i+1];
+    }
+}
+
+static inline void csc_row_interleave(char *dest, const char *src1, const char *src2, int src_size)
+{
+    int i = 0;
+
+    for (; i + 16 <= src_size; i += 16) {
+        uint8x16x2_t uv;
+        uv.val[0] = vld1q_u8((const uint8_t *)(src1 + i));
+        uv.val[1] = vld1q_u8((const uint8_t *)(src2 + i));
+        vst2q_u8((uint8_t *)(dest + i*2), uv);
+    }
+    for (; i < src_size; i++) {
+        dest[i*2] = src1[i];
+        dest[i*2+1] = src2[i];
+    }
+}
+
+#include "csc_tiled_template.h"
+
+static void csc_deinterleave_memcpy_neon(char *dest1, char *dest2, char *src, int src_size)
+{
+    csc_row_deinterleave(dest1, dest2, src, src_size);
+}
+
+static void csc_interleave_memcpy_neon(char *dest, char *src1, char *src2, int src_size)
+{
+    csc_row_interleave(dest, src1, src2, src_size);
+}
+
+void csc_tiled_to_linear_map_neon(char *yuv420_dest, int dest_stride, char *nv12t_src, CSC_TILE_MAP *map,
+                                  int tile_row_start, int tile_row_end)
+{
+    csc_tmpl_tiled_to_linear_map(yuv420_dest, dest_stride, nv12t_src, map, tile_row_start, tile_row_end);
+}
+
+void csc_tiled_to_linear_deinterleave_map_neon(char *yuv420_u_dest, char *yuv420_v_dest, int u_stride, int v_stride,
+                                               char *nv12t_uv_src, CSC_TILE_MAP *map, int tile_row_start, int tile_row_end)
+{
+    csc_tmpl_tiled_to_linear_deinterleave_map(yuv420_u_dest, yuv420_v_dest, u_stride, v_stride,
+                                              nv12t_uv_src, map, tile_row_start, tile_row_end);
+}
+
+const CSC_BACKEND_OPS csc_ops_neon = {
+    CSC_BACKEND_NEON,
+    csc_deinterleave_memcpy_neon,
+    csc_interleave_memcpy_neon,
+    csc_tmpl_tiled_to_linear,
+    csc_tmpl_tiled_to_linear_deinterleave,
+    csc_tmpl_linear_to_tiled,
+    csc_tmpl_linear_to_tiled_interleave,
+    csc_tiled_to_linear_map_neon,
+    csc_tiled_to_linear_deinterleave_map_neon,
+};
+
+#endif /* CSC_HAVE_NEON */
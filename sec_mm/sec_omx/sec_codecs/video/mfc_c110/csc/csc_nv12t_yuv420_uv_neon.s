@@ -46,9 +46,9 @@
 
     .arch armv7-a
     .text
-    .global csc_tiled_to_linear_deinterleave
-    .type   csc_tiled_to_linear_deinterleave, %function
-csc_tiled_to_linear_deinterleave:
+    .global csc_tiled_to_linear_deinterleave_neon_asm
+    .type   csc_tiled_to_linear_deinterleave_neon_asm, %function
+csc_tiled_to_linear_deinterleave_neon_asm:
     .fnstart
 
     @r0         linear_u_dest
@@ -45,9 +45,9 @@
 
     .arch armv7-a
     .text
-    .global csc_tiled_to_linear
-    .type   csc_tiled_to_linear, %function
-csc_tiled_to_linear:
+    .global csc_tiled_to_linear_neon_asm
+    .type   csc_tiled_to_linear_neon_asm, %function
+csc_tiled_to_linear_neon_asm:
     .fnstart
 
     @r0         linear_dest
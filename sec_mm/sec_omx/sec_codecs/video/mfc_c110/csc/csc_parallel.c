@@ -0,0 +1,380 @@
+/*
+ *
+ * Copyright 2011 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    csc_parallel.c
+ * @brief   Band parallel csc on a small worker pool
+ *   A frame is split into bands of two tile rows (64 lines). Because the
+ *   tile address of an even tile row y0+k is the address of row k plus
+ *   x_block_num*y0 tiles, every band can be converted by the ordinary
+ *   single threaded function on offset pointers, whatever backend is
+ *   selected. The caller thread always takes the first share itself.
+ *   The pool is shared by the whole process. Its threads are started on
+ *   first use after csc_parallel_open() and stopped by the last
+ *   csc_parallel_close().
+ * @version 1.0
+ */
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "color_space_convertor.h"
+#include "csc_backend.h"
+
+#define CSC_PARALLEL_MAX_THREAD  4
+#define CSC_BAND_HEIGHT          (CSC_TILE_HEIGHT * 2)
+
+typedef void (*CSC_PARALLEL_FUNC)(void *arg, int band_start, int band_end);
+
+typedef struct _CSC_PARALLEL_POOL
+{
+    pthread_mutex_t   run_lock;     /* one job at a time, others run inline */
+    pthread_mutex_t   lock;         /* protects fields below */
+    pthread_cond_t    start_cond;
+    pthread_cond_t    done_cond;
+    pthread_t         thread[CSC_PARALLEL_MAX_THREAD];
+    unsigned int      seen[CSC_PARALLEL_MAX_THREAD];
+    int               thread_num;   /* workers, caller not included */
+    int               ref_count;
+    int               started;
+    int               exit;
+    unsigned int      generation;
+    int               pending;
+    CSC_PARALLEL_FUNC func;
+    void             *arg;
+    int               band_num;
+} CSC_PARALLEL_POOL;
+
+static CSC_PARALLEL_POOL csc_pool = {
+    .run_lock   = PTHREAD_MUTEX_INITIALIZER,
+    .lock       = PTHREAD_MUTEX_INITIALIZER,
+    .start_cond = PTHREAD_COND_INITIALIZER,
+    .done_cond  = PTHREAD_COND_INITIALIZER,
+};
+
+static void csc_parallel_share(int index, int parts, int band_num, int *band_start, int *band_end)
+{
+    *band_start = (band_num * index) / parts;
+    *band_end = (band_num * (index + 1)) / parts;
+}
+
+static void *csc_parallel_worker(void *param)
+{
+    int index = (int)(long)param;
+    int band_start, band_end;
+
+    pthread_mutex_lock(&csc_pool.lock);
+    for (;;) {
+        while ((csc_pool.exit == 0) && (csc_pool.seen[index] == csc_pool.generation))
+            pthread_cond_wait(&csc_pool.start_cond, &csc_pool.lock);
+        if (csc_pool.exit != 0)
+            break;
+        csc_pool.seen[index] = csc_pool.generation;
+
+        csc_parallel_share(index + 1, csc_pool.thread_num + 1, csc_pool.band_num, &band_start, &band_end);
+        pthread_mutex_unlock(&csc_pool.lock);
+
+        if (band_start < band_end)
+            csc_pool.func(csc_pool.arg, band_start, band_end);
+
+        pthread_mutex_lock(&csc_pool.lock);
+        if (--csc_pool.pending == 0)
+            pthread_cond_signal(&csc_pool.done_cond);
+    }
+    pthread_mutex_unlock(&csc_pool.lock);
+
+    return NULL;
+}
+
+/* called with csc_pool.lock held */
+static void csc_parallel_start(void)
+{
+    long cpu_num = sysconf(_SC_NPROCESSORS_ONLN);
+    int i;
+
+    if (cpu_num > CSC_PARALLEL_MAX_THREAD)
+        cpu_num = CSC_PARALLEL_MAX_THREAD;
+
+    csc_pool.thread_num = 0;
+    for (i = 0; i < cpu_num - 1; i++) {
+        csc_pool.seen[i] = csc_pool.generation;
+        if (pthread_create(&csc_pool.thread[i], NULL, csc_parallel_worker, (void *)(long)i) != 0)
+            break;
+        csc_pool.thread_num++;
+    }
+    csc_pool.started = 1;
+}
+
+static void csc_parallel_stop(void)
+{
+    int i, thread_num;
+
+    pthread_mutex_lock(&csc_pool.lock);
+    csc_pool.exit = 1;
+    thread_num = csc_pool.thread_num;
+    pthread_cond_broadcast(&csc_pool.start_cond);
+    pthread_mutex_unlock(&csc_pool.lock);
+
+    for (i = 0; i < thread_num; i++)
+        pthread_join(csc_pool.thread[i], NULL);
+
+    pthread_mutex_lock(&csc_pool.lock);
+    csc_pool.thread_num = 0;
+    csc_pool.started = 0;
+    csc_pool.exit = 0;
+    pthread_mutex_unlock(&csc_pool.lock);
+}
+
+/*
+ * Runs func on the pool, or inline on the caller without any global lock
+ * when the pool is missing or busy with the job of another component
+ */
+static void csc_parallel_run(CSC_PARALLEL_FUNC func, void *arg, int band_num)
+{
+    int band_start, band_end;
+
+    if ((band_num < 2) || (pthread_mutex_trylock(&csc_pool.run_lock) != 0)) {
+        func(arg, 0, band_num);
+        return;
+    }
+
+    pthread_mutex_lock(&csc_pool.lock);
+
+    if ((csc_pool.started == 0) && (csc_pool.ref_count > 0))
+        csc_parallel_start();
+
+    if (csc_pool.thread_num == 0) {
+        pthread_mutex_unlock(&csc_pool.lock);
+        pthread_mutex_unlock(&csc_pool.run_lock);
+        func(arg, 0, band_num);
+        return;
+    }
+
+    csc_pool.func = func;
+    csc_pool.arg = arg;
+    csc_pool.band_num = band_num;
+    csc_pool.pending = csc_pool.thread_num;
+    csc_pool.generation++;
+    csc_parallel_share(0, csc_pool.thread_num + 1, band_num, &band_start, &band_end);
+    pthread_cond_broadcast(&csc_pool.start_cond);
+    pthread_mutex_unlock(&csc_pool.lock);
+
+    if (band_start < band_end)
+        func(arg, band_start, band_end);
+
+    pthread_mutex_lock(&csc_pool.lock);
+    while (csc_pool.pending > 0)
+        pthread_cond_wait(&csc_pool.done_cond, &csc_pool.lock);
+    pthread_mutex_unlock(&csc_pool.lock);
+
+    pthread_mutex_unlock(&csc_pool.run_lock);
+}
+
+/*
+ * Registers a user of the worker pool
+ *
+ * @return
+ *   0 on success
+ */
+int csc_parallel_open(void)
+{
+    pthread_mutex_lock(&csc_pool.lock);
+    csc_pool.ref_count++;
+    pthread_mutex_unlock(&csc_pool.lock);
+
+    return 0;
+}
+
+/*
+ * Unregisters a user of the worker pool. Last user stops the threads.
+ */
+void csc_parallel_close(void)
+{
+    int stop = 0;
+
+    pthread_mutex_lock(&csc_pool.run_lock);
+
+    pthread_mutex_lock(&csc_pool.lock);
+    if (csc_pool.ref_count > 0)
+        csc_pool.ref_count--;
+    if ((csc_pool.ref_count == 0) && (csc_pool.started != 0))
+        stop = 1;
+    pthread_mutex_unlock(&csc_pool.lock);
+
+    if (stop)
+        csc_parallel_stop();
+
+    pthread_mutex_unlock(&csc_pool.run_lock);
+}
+
+/*
+ * Returns number of threads a parallel conversion runs on, caller included
+ */
+int csc_parallel_thread_num(void)
+{
+    int thread_num;
+
+    pthread_mutex_lock(&csc_pool.lock);
+    thread_num = csc_pool.thread_num + 1;
+    pthread_mutex_unlock(&csc_pool.lock);
+
+    return thread_num;
+}
+
+typedef struct _CSC_PARALLEL_PLANE_ARG
+{
+    char *dest1;
+    char *dest2;
+    char *src1;
+    char *src2;
+    int   width;
+    int   height;
+} CSC_PARALLEL_PLANE_ARG;
+
+static int csc_band_num(int height)
+{
+    return (height + CSC_BAND_HEIGHT - 1) / CSC_BAND_HEIGHT;
+}
+
+/* tiled byte offset of first tile of band */
+static unsigned int csc_band_tiled_offset(int width, int band)
+{
+    unsigned int x_block_num = (((width+127)>>7)<<7)>>6;
+
+    return (x_block_num * band * 2) << 11;
+}
+
+static int csc_band_lines(int height, int band_start, int band_end)
+{
+    int end = band_end * CSC_BAND_HEIGHT;
+
+    if (end > height)
+        end = height;
+
+    return end - band_start * CSC_BAND_HEIGHT;
+}
+
+static void csc_tiled_to_linear_band(void *param, int band_start, int band_end)
+{
+    CSC_PARALLEL_PLANE_ARG *arg = (CSC_PARALLEL_PLANE_ARG *)param;
+    int line = band_start * CSC_BAND_HEIGHT;
+
+    csc_tiled_to_linear(arg->dest1 + arg->width * line,
+                        arg->src1 + csc_band_tiled_offset(arg->width, band_start),
+                        arg->width, csc_band_lines(arg->height, band_start, band_end));
+}
+
+static void csc_tiled_to_linear_deinterleave_band(void *param, int band_start, int band_end)
+{
+    CSC_PARALLEL_PLANE_ARG *arg = (CSC_PARALLEL_PLANE_ARG *)param;
+    int line = band_start * CSC_BAND_HEIGHT;
+
+    csc_tiled_to_linear_deinterleave(arg->dest1 + (arg->width / 2) * line,
+                                     arg->dest2 + (arg->width / 2) * line,
+                                     arg->src1 + csc_band_tiled_offset(arg->width, band_start),
+                                     arg->width, csc_band_lines(arg->height, band_start, band_end));
+}
+
+static void csc_linear_to_tiled_band(void *param, int band_start, int band_end)
+{
+    CSC_PARALLEL_PLANE_ARG *arg = (CSC_PARALLEL_PLANE_ARG *)param;
+    int line = band_start * CSC_BAND_HEIGHT;
+
+    csc_linear_to_tiled(arg->dest1 + csc_band_tiled_offset(arg->width, band_start),
+                        arg->src1 + arg->width * line,
+                        arg->width, csc_band_lines(arg->height, band_start, band_end));
+}
+
+static void csc_linear_to_tiled_interleave_band(void *param, int band_start, int band_end)
+{
+    CSC_PARALLEL_PLANE_ARG *arg = (CSC_PARALLEL_PLANE_ARG *)param;
+    int line = band_start * CSC_BAND_HEIGHT;
+
+    csc_linear_to_tiled_interleave(arg->dest1 + csc_band_tiled_offset(arg->width, band_start),
+                                   arg->src1 + (arg->width / 2) * line,
+                                   arg->src2 + (arg->width / 2) * line,
+                                   arg->width, csc_band_lines(arg->height, band_start, band_end));
+}
+
+void csc_tiled_to_linear_parallel(char *yuv420_dest, char *nv12t_src, int yuv420_width, int yuv420_height)
+{
+    CSC_PARALLEL_PLANE_ARG arg = { yuv420_dest, NULL, nv12t_src, NULL, yuv420_width, yuv420_height };
+
+    csc_parallel_run(csc_tiled_to_linear_band, &arg, csc_band_num(yuv420_height));
+}
+
+void csc_tiled_to_linear_deinterleave_parallel(char *yuv420_u_dest, char *yuv420_v_dest, char *nv12t_uv_src, int yuv420_width, int yuv420_uv_height)
+{
+    CSC_PARALLEL_PLANE_ARG arg = { yuv420_u_dest, yuv420_v_dest, nv12t_uv_src, NULL, yuv420_width, yuv420_uv_height };
+
+    csc_parallel_run(csc_tiled_to_linear_deinterleave_band, &arg, csc_band_num(yuv420_uv_height));
+}
+
+void csc_linear_to_tiled_parallel(char *nv12t_dest, char *yuv420_src, int yuv420_width, int yuv420_height)
+{
+    CSC_PARALLEL_PLANE_ARG arg = { nv12t_dest, NULL, yuv420_src, NULL, yuv420_width, yuv420_height };
+
+    csc_parallel_run(csc_linear_to_tiled_band, &arg, csc_band_num(yuv420_height));
+}
+
+void csc_linear_to_tiled_interleave_parallel(char *nv12t_uv_dest, char *yuv420p_u_src, char *yuv420p_v_src, int yuv420_width, int yuv420_uv_height)
+{
+    CSC_PARALLEL_PLANE_ARG arg = { nv12t_uv_dest, NULL, yuv420p_u_src, yuv420p_v_src, yuv420_width, yuv420_uv_height };
+
+    csc_parallel_run(csc_linear_to_tiled_interleave_band, &arg, csc_band_num(yuv420_uv_height));
+}
+
+typedef struct _CSC_PARALLEL_FRAME_ARG
+{
+    CSC_LINEAR_FRAME *frame;
+    char             *nv12t_y;
+    char             *nv12t_uv;
+    CSC_TILE_MAP     *y_map;
+    CSC_TILE_MAP     *uv_map;
+} CSC_PARALLEL_FRAME_ARG;
+
+static void csc_tiled_to_linear_frame_band(void *param, int band_start, int band_end)
+{
+    CSC_PARALLEL_FRAME_ARG *arg = (CSC_PARALLEL_FRAME_ARG *)param;
+
+    csc_tiled_to_linear_frame_bands(arg->frame, arg->nv12t_y, arg->nv12t_uv,
+                                    arg->y_map, arg->uv_map, band_start, band_end);
+}
+
+static void csc_linear_to_tiled_frame_band(void *param, int band_start, int band_end)
+{
+    CSC_PARALLEL_FRAME_ARG *arg = (CSC_PARALLEL_FRAME_ARG *)param;
+
+    csc_linear_to_tiled_frame_bands(arg->nv12t_y, arg->nv12t_uv, arg->frame,
+                                    arg->y_map, arg->uv_map, band_start, band_end);
+}
+
+void csc_tiled_to_linear_frame_parallel(CSC_LINEAR_FRAME *dest, char *nv12t_y_src, char *nv12t_uv_src,
+                                        CSC_TILE_MAP *y_map, CSC_TILE_MAP *uv_map)
+{
+    CSC_PARALLEL_FRAME_ARG arg = { dest, nv12t_y_src, nv12t_uv_src, y_map, uv_map };
+
+    csc_parallel_run(csc_tiled_to_linear_frame_band, &arg, csc_tiled_frame_band_num(y_map, uv_map));
+}
+
+void csc_linear_to_tiled_frame_parallel(char *nv12t_y_dest, char *nv12t_uv_dest, CSC_LINEAR_FRAME *src,
+                                        CSC_TILE_MAP *y_map, CSC_TILE_MAP *uv_map)
+{
+    CSC_PARALLEL_FRAME_ARG arg = { src, nv12t_y_dest, nv12t_uv_dest, y_map, uv_map };
+
+    csc_parallel_run(csc_linear_to_tiled_frame_band, &arg, csc_tiled_frame_band_num(y_map, uv_map));
+}
@@ -0,0 +1,101 @@
+/*
+ *
+ * Copyright 2011 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    csc_sse2.c
+ * @brief   SSE2 backend of csc
+ * @version 1.0
+ */
+
+#include "csc_backend.h"
+
+#ifdef CSC_HAVE_SSE2
+
+#include <emmintrin.h>
+
+static inline void csc_row_copy64(char *dest, const char *src)
+{
+    __m128i a = _mm_loadu_si128((const __m128i *)(src));
+    __m128i b = _mm_loadu_si128((const __m128i *)(src + 16));
+    __m128i c = _mm_loadu_si128((const __m128i *)(src + 32));
+    __m128i d = _mm_loadu_si128((const __m128i *)(src + 48));
+    _mm_storeu_si128((__m128i *)(dest), a);
+    _mm_storeu_si128((__m128i *)(dest + 16), b);
+    _mm_storeu_si128((__m128i *)(dest + 32), c);
+    _mm_storeu_si128((__m128i *)(dest + 48), d);
+}
+
+static inline void csc_row_deinterleave(char *dest1, char *dest2, const char *src, int src_size)
+{
+    const __m128i mask = _mm_set1_epi16(0x00FF);
+    int i = 0;
+
+    for (; i + 32 <= src_size; i += 32) {
+        __m128i a = _mm_loadu_si128((const __m128i *)(src + i));
+        __m128i b = _mm_loadu_si128((const __m128i *)(src + i + 16));
+        __m128i even = _mm_packus_epi16(_mm_and_si128(a, mask), _mm_and_si128(b, mask));
+        __m128i odd  = _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+        _mm_storeu_si128((__m128i *)(dest1 + i/2), even);
+        _mm_storeu_si128((__m128i *)(dest2 + i/2), odd);
+    }
+    for (; i < src_size - 1; i += 2) {
+        dest1[i/2] = src[i];
+        dest2[i/2] = src[i+1];
+    }
+}
+
+static inline void csc_row_interleave(char *dest, const char *src1, const char *src2, int src_size)
+{
+    int i = 0;
+
+    for (; i + 16 <= src_size; i += 16) {
+        __m128i u = _mm_loadu_si128((const __m128i *)(src1 + i));
+        __m128i v = _mm_loadu_si128((const __m128i *)(src2 + i));
+        _mm_storeu_si128((__m128i *)(dest + i*2), _mm_unpacklo_epi8(u, v));
+        _mm_storeu_si128((__m128i *)(dest + i*2 + 16), _mm_unpackhi_epi8(u, v));
+    }
+    for (; i < src_size; i++) {
+        dest[i*2] = src1[i];
+        dest[i*2+1] = src2[i];
+    }
+}
+
+#include "csc_tiled_template.h"
+
+static void csc_deinterleave_memcpy_sse2(char *dest1, char *dest2, char *src, int src_size)
+{
+    csc_row_deinterleave(dest1, dest2, src, src_size);
+}
+
+static void csc_interleave_memcpy_sse2(char *dest, char *src1, char *src2, int src_size)
+{
+    csc_row_interleave(dest, src1, src2, src_size);
+}
+
+const CSC_BACKEND_OPS csc_ops_sse2 = {
+    CSC_BACKEND_SSE2,
+    csc_deinterleave_memcpy_sse2,
+    csc_interleave_memcpy_sse2,
+    csc_tmpl_tiled_to_linear,
+    csc_tmpl_tiled_to_linear_deinterleave,
+    csc_tmpl_linear_to_tiled,
+    csc_tmpl_linear_to_tiled_interleave,
+    csc_tmpl_tiled_to_linear_map,
+    csc_tmpl_tiled_to_linear_deinterleave_map,
+};
+
+#endif /* CSC_HAVE_SSE2 */
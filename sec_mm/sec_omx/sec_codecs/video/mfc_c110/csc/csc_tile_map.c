@@ -0,0 +1,226 @@
+/*
+ *
+ * Copyright 2011 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    csc_tile_map.c
+ * @brief   Table driven NV12T to linear conversion
+ *   The byte offset of every 64x32 tile of a plane is computed once per
+ *   resolution and kept in a CSC_TILE_MAP. Conversion then walks the
+ *   table and copies whole tile rows instead of re-evaluating the tile
+ *   address formula for every 64 or 4 byte chunk.
+ * @version 1.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "color_space_convertor.h"
+#include "csc_backend.h"
+
+/*
+ * Builds tile offset table for plane of given size
+ *
+ * @param map
+ *   Tile map to (re)build. Must be zero initialized before first use[in/out]
+ *
+ * @param width
+ *   Width of plane in bytes[in]
+ *
+ * @param height
+ *   Height of plane in lines[in]
+ *
+ * @return
+ *   0 on success, -1 on invalid size or allocation failure
+ */
+int csc_tile_map_update(CSC_TILE_MAP *map, int width, int height)
+{
+    unsigned int x, y;
+    unsigned int x_block_num;
+    unsigned int *tile_offset;
+    int x_tile_num, y_tile_num;
+
+    if ((map == NULL) || (width <= 0) || (height <= 0))
+        return -1;
+
+    if ((map->tile_offset != NULL) &&
+        (map->width == width) && (map->height == height))
+        return 0;
+
+    csc_tile_map_release(map);
+
+    x_tile_num = (width + CSC_TILE_WIDTH - 1) / CSC_TILE_WIDTH;
+    y_tile_num = (height + CSC_TILE_HEIGHT - 1) / CSC_TILE_HEIGHT;
+    x_block_num = (((width+127)>>7)<<7)>>6;
+
+    tile_offset = (unsigned int *)malloc(sizeof(unsigned int) * x_tile_num * y_tile_num);
+    if (tile_offset == NULL)
+        return -1;
+
+    for (y = 0; y < (unsigned int)y_tile_num; y++) {
+        int last_row = (y == (unsigned int)(y_tile_num - 1));
+        for (x = 0; x < (unsigned int)x_tile_num; x++)
+            tile_offset[y * x_tile_num + x] = csc_get_tiled_offset(x, y, x_block_num, last_row);
+    }
+
+    map->width = width;
+    map->height = height;
+    map->x_tile_num = x_tile_num;
+    map->y_tile_num = y_tile_num;
+    map->tile_offset = tile_offset;
+
+    return 0;
+}
+
+/*
+ * Frees tile offset table
+ *
+ * @param map
+ *   Tile map[in/out]
+ */
+void csc_tile_map_release(CSC_TILE_MAP *map)
+{
+    if (map == NULL)
+        return;
+
+    if (map->tile_offset != NULL)
+        free(map->tile_offset);
+
+    memset(map, 0, sizeof(CSC_TILE_MAP));
+}
+
+/*
+ * Converts tile rows of tiled data to linear using tile map, generic C
+ * backend of csc_tiled_to_linear_map()
+ *
+ * @param yuv420_dest
+ *   Y or UV plane address of YUV420[out]
+ *
+ * @param dest_stride
+ *   Distance in bytes between two lines of yuv420_dest[in]
+ *
+ * @param nv12t_src
+ *   Y or UV plane address of NV12T[in]
+ *
+ * @param map
+ *   Tile map built for width and height of the plane[in]
+ *
+ * @param tile_row_start
+ *   First tile row to convert[in]
+ *
+ * @param tile_row_end
+ *   Tile row after the last one to convert, clipped to the plane[in]
+ */
+void csc_tiled_to_linear_map_c(char *yuv420_dest, int dest_stride, char *nv12t_src, CSC_TILE_MAP *map,
+                               int tile_row_start, int tile_row_end)
+{
+    int x, y, row;
+    int rows, cols;
+    unsigned int *tile_offset;
+    char *src, *dest;
+
+    if (tile_row_end > map->y_tile_num)
+        tile_row_end = map->y_tile_num;
+
+    for (y = tile_row_start; y < tile_row_end; y++) {
+        rows = map->height - y * CSC_TILE_HEIGHT;
+        if (rows > CSC_TILE_HEIGHT)
+            rows = CSC_TILE_HEIGHT;
+
+        tile_offset = map->tile_offset + y * map->x_tile_num;
+        for (x = 0; x < map->x_tile_num; x++) {
+            src = nv12t_src + tile_offset[x];
+            dest = yuv420_dest + dest_stride * y * CSC_TILE_HEIGHT + x * CSC_TILE_WIDTH;
+            cols = map->width - x * CSC_TILE_WIDTH;
+
+            if (cols >= CSC_TILE_WIDTH) {
+                for (row = 0; row < rows; row++) {
+                    memcpy(dest, src, CSC_TILE_WIDTH);
+                    dest += dest_stride;
+                    src += CSC_TILE_WIDTH;
+                }
+            } else {
+                for (row = 0; row < rows; row++) {
+                    memcpy(dest, src, cols);
+                    dest += dest_stride;
+                    src += CSC_TILE_WIDTH;
+                }
+            }
+        }
+    }
+}
+
+/*
+ * Converts and Deinterleaves tile rows of tiled data to linear using tile
+ * map, generic C backend of csc_tiled_to_linear_deinterleave_map()
+ *
+ * @param yuv420_u_dest
+ *   U plane address of YUV420P[out]
+ *
+ * @param yuv420_v_dest
+ *   V plane address of YUV420P[out]
+ *
+ * @param u_stride
+ *   Distance in bytes between two lines of yuv420_u_dest[in]
+ *
+ * @param v_stride
+ *   Distance in bytes between two lines of yuv420_v_dest[in]
+ *
+ * @param nv12t_uv_src
+ *   UV plane address of NV12T[in]
+ *
+ * @param map
+ *   Tile map built for width and height/2 of YUV420[in]
+ *
+ * @param tile_row_start
+ *   First tile row to convert[in]
+ *
+ * @param tile_row_end
+ *   Tile row after the last one to convert, clipped to the plane[in]
+ */
+void csc_tiled_to_linear_deinterleave_map_c(char *yuv420_u_dest, char *yuv420_v_dest, int u_stride, int v_stride,
+                                            char *nv12t_uv_src, CSC_TILE_MAP *map, int tile_row_start, int tile_row_end)
+{
+    int x, y, row;
+    int rows, cols;
+    unsigned int *tile_offset;
+    char *src, *u_dest, *v_dest;
+
+    if (tile_row_end > map->y_tile_num)
+        tile_row_end = map->y_tile_num;
+
+    for (y = tile_row_start; y < tile_row_end; y++) {
+        rows = map->height - y * CSC_TILE_HEIGHT;
+        if (rows > CSC_TILE_HEIGHT)
+            rows = CSC_TILE_HEIGHT;
+
+        tile_offset = map->tile_offset + y * map->x_tile_num;
+        for (x = 0; x < map->x_tile_num; x++) {
+            src = nv12t_uv_src + tile_offset[x];
+            u_dest = yuv420_u_dest + u_stride * y * CSC_TILE_HEIGHT + x * (CSC_TILE_WIDTH / 2);
+            v_dest = yuv420_v_dest + v_stride * y * CSC_TILE_HEIGHT + x * (CSC_TILE_WIDTH / 2);
+            cols = map->width - x * CSC_TILE_WIDTH;
+            if (cols > CSC_TILE_WIDTH)
+                cols = CSC_TILE_WIDTH;
+
+            for (row = 0; row < rows; row++) {
+                csc_deinterleave_memcpy_c(u_dest, v_dest, src, cols);
+                u_dest += u_stride;
+                v_dest += v_stride;
+                src += CSC_TILE_WIDTH;
+            }
+        }
+    }
+}
@@ -0,0 +1,236 @@
+/*
+ *
+ * Copyright 2011 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    csc_tiled_template.h
+ * @brief   Tile walkers shared by SIMD backends
+ *   Included once by each SIMD backend after it has defined
+ *     static void csc_row_copy64(char *dest, const char *src);
+ *     static void csc_row_deinterleave(char *dest1, char *dest2, const char *src, int src_size);
+ *     static void csc_row_interleave(char *dest, const char *src1, const char *src2, int src_size);
+ *   The walkers below visit every 64x32 tile once, compute its address
+ *   once and hand complete tile rows to the row functions, so that the
+ *   backends only differ in how a row is moved.
+ *   Only bytes inside width x height are read and written.
+ * @version 1.0
+ */
+
+#ifndef CSC_TILED_TEMPLATE_H_
+#define CSC_TILED_TEMPLATE_H_
+
+#include <string.h>
+#include "csc_backend.h"
+
+static void csc_tmpl_tiled_to_linear(char *yuv420_dest, char *nv12t_src, int yuv420_width, int yuv420_height)
+{
+    int x, y, row, rows, cols;
+    int x_tile_num = (yuv420_width + CSC_TILE_WIDTH - 1) / CSC_TILE_WIDTH;
+    int y_tile_num = (yuv420_height + CSC_TILE_HEIGHT - 1) / CSC_TILE_HEIGHT;
+    unsigned int x_block_num = (((yuv420_width+127)>>7)<<7)>>6;
+    const char *src;
+    char *dest;
+
+    for (y = 0; y < y_tile_num; y++) {
+        rows = yuv420_height - y * CSC_TILE_HEIGHT;
+        if (rows > CSC_TILE_HEIGHT)
+            rows = CSC_TILE_HEIGHT;
+
+        for (x = 0; x < x_tile_num; x++) {
+            src = nv12t_src + csc_get_tiled_offset(x, y, x_block_num, y == y_tile_num - 1);
+            dest = yuv420_dest + yuv420_width * y * CSC_TILE_HEIGHT + x * CSC_TILE_WIDTH;
+            cols = yuv420_width - x * CSC_TILE_WIDTH;
+
+            for (row = 0; row < rows; row++) {
+                if (cols >= CSC_TILE_WIDTH)
+                    csc_row_copy64(dest, src);
+                else
+                    memcpy(dest, src, cols);
+                dest += yuv420_width;
+                src += CSC_TILE_WIDTH;
+            }
+        }
+    }
+}
+
+static void csc_tmpl_tiled_to_linear_deinterleave(char *yuv420_u_dest, char *yuv420_v_dest, char *nv12t_uv_src, int yuv420_width, int yuv420_uv_height)
+{
+    int x, y, row, rows, cols;
+    int uv_width = yuv420_width / 2;
+    int x_tile_num = (yuv420_width + CSC_TILE_WIDTH - 1) / CSC_TILE_WIDTH;
+    int y_tile_num = (yuv420_uv_height + CSC_TILE_HEIGHT - 1) / CSC_TILE_HEIGHT;
+    unsigned int x_block_num = (((yuv420_width+127)>>7)<<7)>>6;
+    const char *src;
+    char *u_dest, *v_dest;
+
+    for (y = 0; y < y_tile_num; y++) {
+        rows = yuv420_uv_height - y * CSC_TILE_HEIGHT;
+        if (rows > CSC_TILE_HEIGHT)
+            rows = CSC_TILE_HEIGHT;
+
+        for (x = 0; x < x_tile_num; x++) {
+            src = nv12t_uv_src + csc_get_tiled_offset(x, y, x_block_num, y == y_tile_num - 1);
+            u_dest = yuv420_u_dest + uv_width * y * CSC_TILE_HEIGHT + x * (CSC_TILE_WIDTH / 2);
+            v_dest = yuv420_v_dest + uv_width * y * CSC_TILE_HEIGHT + x * (CSC_TILE_WIDTH / 2);
+            cols = yuv420_width - x * CSC_TILE_WIDTH;
+            if (cols > CSC_TILE_WIDTH)
+                cols = CSC_TILE_WIDTH;
+
+            for (row = 0; row < rows; row++) {
+                csc_row_deinterleave(u_dest, v_dest, src, cols);
+                u_dest += uv_width;
+                v_dest += uv_width;
+                src += CSC_TILE_WIDTH;
+            }
+        }
+    }
+}
+
+static void csc_tmpl_linear_to_tiled(char *nv12t_dest, char *yuv420_src, int yuv420_width, int yuv420_height)
+{
+    int x, y, row, rows, cols;
+    int x_tile_num = (yuv420_width + CSC_TILE_WIDTH - 1) / CSC_TILE_WIDTH;
+    int y_tile_num = (yuv420_height + CSC_TILE_HEIGHT - 1) / CSC_TILE_HEIGHT;
+    unsigned int x_block_num = (((yuv420_width+127)>>7)<<7)>>6;
+    const char *src;
+    char *dest;
+
+    for (y = 0; y < y_tile_num; y++) {
+        rows = yuv420_height - y * CSC_TILE_HEIGHT;
+        if (rows > CSC_TILE_HEIGHT)
+            rows = CSC_TILE_HEIGHT;
+
+        for (x = 0; x < x_tile_num; x++) {
+            dest = nv12t_dest + csc_get_tiled_offset(x, y, x_block_num, y == y_tile_num - 1);
+            src = yuv420_src + yuv420_width * y * CSC_TILE_HEIGHT + x * CSC_TILE_WIDTH;
+            cols = yuv420_width - x * CSC_TILE_WIDTH;
+
+            for (row = 0; row < rows; row++) {
+                if (cols >= CSC_TILE_WIDTH)
+                    csc_row_copy64(dest, src);
+                else
+                    memcpy(dest, src, cols);
+                dest += CSC_TILE_WIDTH;
+                src += yuv420_width;
+            }
+        }
+    }
+}
+
+static void csc_tmpl_linear_to_tiled_interleave(char *nv12t_uv_dest, char *yuv420p_u_src, char *yuv420p_v_src, int yuv420_width, int yuv420_uv_height)
+{
+    int x, y, row, rows, cols;
+    int uv_width = yuv420_width / 2;
+    int x_tile_num = (yuv420_width + CSC_TILE_WIDTH - 1) / CSC_TILE_WIDTH;
+    int y_tile_num = (yuv420_uv_height + CSC_TILE_HEIGHT - 1) / CSC_TILE_HEIGHT;
+    unsigned int x_block_num = (((yuv420_width+127)>>7)<<7)>>6;
+    const char *u_src, *v_src;
+    char *dest;
+
+    for (y = 0; y < y_tile_num; y++) {
+        rows = yuv420_uv_height - y * CSC_TILE_HEIGHT;
+        if (rows > CSC_TILE_HEIGHT)
+            rows = CSC_TILE_HEIGHT;
+
+        for (x = 0; x < x_tile_num; x++) {
+            dest = nv12t_uv_dest + csc_get_tiled_offset(x, y, x_block_num, y == y_tile_num - 1);
+            u_src = yuv420p_u_src + uv_width * y * CSC_TILE_HEIGHT + x * (CSC_TILE_WIDTH / 2);
+            v_src = yuv420p_v_src + uv_width * y * CSC_TILE_HEIGHT + x * (CSC_TILE_WIDTH / 2);
+            cols = uv_width - x * (CSC_TILE_WIDTH / 2);
+            if (cols > CSC_TILE_WIDTH / 2)
+                cols = CSC_TILE_WIDTH / 2;
+
+            for (row = 0; row < rows; row++) {
+                csc_row_interleave(dest, u_src, v_src, cols);
+                dest += CSC_TILE_WIDTH;
+                u_src += uv_width;
+                v_src += uv_width;
+            }
+        }
+    }
+}
+
+/* same walk with the tile addresses taken from map */
+static void csc_tmpl_tiled_to_linear_map(char *yuv420_dest, int dest_stride, char *nv12t_src, CSC_TILE_MAP *map,
+                                         int tile_row_start, int tile_row_end)
+{
+    int x, y, row, rows, cols;
+    const unsigned int *tile_offset;
+    const char *src;
+    char *dest;
+
+    if (tile_row_end > map->y_tile_num)
+        tile_row_end = map->y_tile_num;
+
+    for (y = tile_row_start; y < tile_row_end; y++) {
+        rows = map->height - y * CSC_TILE_HEIGHT;
+        if (rows > CSC_TILE_HEIGHT)
+            rows = CSC_TILE_HEIGHT;
+
+        tile_offset = map->tile_offset + y * map->x_tile_num;
+        for (x = 0; x < map->x_tile_num; x++) {
+            src = nv12t_src + tile_offset[x];
+            dest = yuv420_dest + dest_stride * y * CSC_TILE_HEIGHT + x * CSC_TILE_WIDTH;
+            cols = map->width - x * CSC_TILE_WIDTH;
+
+            for (row = 0; row < rows; row++) {
+                if (cols >= CSC_TILE_WIDTH)
+                    csc_row_copy64(dest, src);
+                else
+                    memcpy(dest, src, cols);
+                dest += dest_stride;
+                src += CSC_TILE_WIDTH;
+            }
+        }
+    }
+}
+
+static void csc_tmpl_tiled_to_linear_deinterleave_map(char *yuv420_u_dest, char *yuv420_v_dest, int u_stride, int v_stride,
+                                                      char *nv12t_uv_src, CSC_TILE_MAP *map, int tile_row_start, int tile_row_end)
+{
+    int x, y, row, rows, cols;
+    const unsigned int *tile_offset;
+    const char *src;
+    char *u_dest, *v_dest;
+
+    if (tile_row_end > map->y_tile_num)
+        tile_row_end = map->y_tile_num;
+
+    for (y = tile_row_start; y < tile_row_end; y++) {
+        rows = map->height - y * CSC_TILE_HEIGHT;
+        if (rows > CSC_TILE_HEIGHT)
+            rows = CSC_TILE_HEIGHT;
+
+        tile_offset = map->tile_offset + y * map->x_tile_num;
+        for (x = 0; x < map->x_tile_num; x++) {
+            src = nv12t_uv_src + tile_offset[x];
+            u_dest = yuv420_u_dest + u_stride * y * CSC_TILE_HEIGHT + x * (CSC_TILE_WIDTH / 2);
+            v_dest = yuv420_v_dest + v_stride * y * CSC_TILE_HEIGHT + x * (CSC_TILE_WIDTH / 2);
+            cols = map->width - x * CSC_TILE_WIDTH;
+            if (cols > CSC_TILE_WIDTH)
+                cols = CSC_TILE_WIDTH;
+
+            for (row = 0; row < rows; row++) {
+                csc_row_deinterleave(u_dest, v_dest, src, cols);
+                u_dest += u_stride;
+                v_dest += v_stride;
+                src += CSC_TILE_WIDTH;
+            }
+        }
+    }
+}
+
+#endif /*CSC_TILED_TEMPLATE_H_*/
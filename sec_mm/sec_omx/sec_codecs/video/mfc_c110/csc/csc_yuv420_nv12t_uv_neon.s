@@ -46,9 +46,9 @@
 
     .arch armv7-a
     .text
-    .global csc_linear_to_tiled_interleave
-    .type   csc_linear_to_tiled_interleave, %function
-csc_linear_to_tiled_interleave:
+    .global csc_linear_to_tiled_interleave_neon_asm
+    .type   csc_linear_to_tiled_interleave_neon_asm, %function
+csc_linear_to_tiled_interleave_neon_asm:
     .fnstart
 
     @r0     tiled_dest
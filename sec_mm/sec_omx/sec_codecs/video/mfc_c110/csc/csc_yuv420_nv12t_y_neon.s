@@ -45,9 +45,9 @@
 
     .arch armv7-a
     .text
-    .global csc_linear_to_tiled
-    .type   csc_linear_to_tiled, %function
-csc_linear_to_tiled:
+    .global csc_linear_to_tiled_neon_asm
+    .type   csc_linear_to_tiled_neon_asm, %function
+csc_linear_to_tiled_neon_asm:
     .fnstart
 
     @r0     tiled_dest
@@ -50,8 +50,8 @@ static mfc_packed_mode isPBPacked(_MFCLIB *pCtx, int length)
     char *strmBufferEnd = NULL;
     int startCode = 0xFFFFFFFF;
 
-    strmBuffer = (char *)pCtx->virStrmBuf;
-    strmBufferEnd = (char *)pCtx->virStrmBuf + length;
+    strmBuffer = (char *)(unsigned long)pCtx->virStrmBuf;
+    strmBufferEnd = (char *)(unsigned long)pCtx->virStrmBuf + length;
 
     while (1) {
         while (startCode != USR_DATA_START_CODE) {
@@ -87,6 +87,7 @@ out:
 void *SsbSipMfcDecOpen(void *value)
 {
     int hMFCOpen;
+    const MFC_BACKEND_OPS *ops;
     unsigned int mapped_addr;
     _MFCLIB *pCTX;
     mfc_common_args DecArg;
@@ -99,7 +100,8 @@ void *SsbSipMfcDecOpen(void *value)
     }
     memset(pCTX, 0, sizeof(_MFCLIB));
 
-    hMFCOpen = open(S5PC110_MFC_DEV_NAME, O_RDWR | O_NDELAY);
+    ops = mfc_get_backend_ops();
+    hMFCOpen = ops->open(S5PC110_MFC_DEV_NAME, O_RDWR | O_NDELAY);
     if (hMFCOpen < 0) {
         LOGE("SsbSipMfcDecOpen: MFC Open failure\n");
         return NULL;
@@ -108,7 +110,7 @@ void *SsbSipMfcDecOpen(void *value)
     if (*(unsigned int *)value == NO_CACHE ||
         *(unsigned int *)value == CACHE) {
         DecArg.args.buf_type = *(unsigned int *)value;
-        ret_code = ioctl(hMFCOpen, IOCTL_MFC_BUF_CACHE, &DecArg);
+        ret_code = ops->ioctl(hMFCOpen, IOCTL_MFC_BUF_CACHE, &DecArg);
         if (DecArg.ret_code != MFC_RET_OK) {
             LOGE("SsbSipMfcDecOpenExt: IOCTL_MFC_BUF_CACHE (%d) failed\n", DecArg.ret_code);
         }
@@ -116,7 +118,7 @@ void *SsbSipMfcDecOpen(void *value)
         LOGE("SsbSipMfcDecOpenExt: value is invalid, value: %d\n", *(int *)value);
     }
 
-    mapped_addr = (unsigned int)mmap(0, MMAP_BUFFER_SIZE_MMAP, PROT_READ | PROT_WRITE, MAP_SHARED, hMFCOpen, 0);
+    mapped_addr = (unsigned int)(unsigned long)ops->mmap(0, MMAP_BUFFER_SIZE_MMAP, PROT_READ | PROT_WRITE, MAP_SHARED, hMFCOpen, 0);
     if (!mapped_addr) {
         LOGE("SsbSipMfcDecOpen: FIMV5.0 driver address mapping failed\n");
         return NULL;
@@ -124,6 +126,7 @@ void *SsbSipMfcDecOpen(void *value)
 
     pCTX->magic = _MFCLIB_MAGIC_NUMBER;
     pCTX->hMFC = hMFCOpen;
+    pCTX->ops = ops;
     pCTX->mapped_addr = mapped_addr;
     pCTX->inter_buff_status = MFC_USE_NONE;
 
@@ -180,7 +183,7 @@ SSBSIP_MFC_ERROR_CODE SsbSipMfcDecInit(void *openHandle, SSBSIP_MFC_CODEC_TYPE c
     /* mem alloc args */
     DecArg.args.dec_init.in_mapped_addr = pCTX->mapped_addr;
 
-    ret_code = ioctl(pCTX->hMFC, IOCTL_MFC_DEC_INIT, &DecArg);
+    ret_code = pCTX->ops->ioctl(pCTX->hMFC, IOCTL_MFC_DEC_INIT, &DecArg);
     if (DecArg.ret_code != MFC_RET_OK) {
         LOGE("SsbSipMfcDecInit: IOCTL_MFC_DEC_INIT (%d) failed\n", DecArg.ret_code);
         return MFC_RET_DEC_INIT_FAIL;
@@ -239,7 +242,7 @@ SSBSIP_MFC_ERROR_CODE SsbSipMfcDecExe(void *openHandle, int lengthBufFill)
     DecArg.args.dec_exe.in_frm_size.chroma = pCTX->sizeFrmBuf.chroma;
     DecArg.args.dec_exe.in_frametag = pCTX->in_frametag;
 
-    ret_code = ioctl(pCTX->hMFC, IOCTL_MFC_DEC_EXE, &DecArg);
+    ret_code = pCTX->ops->ioctl(pCTX->hMFC, IOCTL_MFC_DEC_EXE, &DecArg);
     if (DecArg.ret_code != MFC_RET_OK) {
         LOGE("SsbSipMfcDecExe: IOCTL_MFC_DEC_EXE failed(ret : %d)\n", DecArg.ret_code);
         return MFC_RET_DEC_EXE_ERR;
@@ -248,10 +251,10 @@ SSBSIP_MFC_ERROR_CODE SsbSipMfcDecExe(void *openHandle, int lengthBufFill)
     Yoffset = DecArg.args.dec_exe.out_display_Y_addr - DecArg.args.dec_exe.in_frm_buf.luma;
     Coffset = DecArg.args.dec_exe.out_display_C_addr - DecArg.args.dec_exe.in_frm_buf.chroma;
 
-    pCTX->decOutInfo.YPhyAddr = (void *)(DecArg.args.dec_exe.out_display_Y_addr);
-    pCTX->decOutInfo.CPhyAddr = (void *)(DecArg.args.dec_exe.out_display_C_addr);
-    pCTX->decOutInfo.YVirAddr = (void *)(pCTX->virFrmBuf.luma + Yoffset);
-    pCTX->decOutInfo.CVirAddr = (void *)(pCTX->virFrmBuf.chroma + Coffset);
+    pCTX->decOutInfo.YPhyAddr = (void *)(unsigned long)(DecArg.args.dec_exe.out_display_Y_addr);
+    pCTX->decOutInfo.CPhyAddr = (void *)(unsigned long)(DecArg.args.dec_exe.out_display_C_addr);
+    pCTX->decOutInfo.YVirAddr = (void *)(unsigned long)(pCTX->virFrmBuf.luma + Yoffset);
+    pCTX->decOutInfo.CVirAddr = (void *)(unsigned long)(pCTX->virFrmBuf.chroma + Coffset);
     pCTX->decOutInfo.timestamp_top = DecArg.args.dec_exe.out_timestamp_top;
     pCTX->decOutInfo.timestamp_bottom = DecArg.args.dec_exe.out_timestamp_bottom;
     pCTX->decOutInfo.consumedByte = DecArg.args.dec_exe.out_consume_bytes;
@@ -282,20 +285,20 @@ SSBSIP_MFC_ERROR_CODE SsbSipMfcDecClose(void *openHandle)
 
     if (pCTX->inter_buff_status & MFC_USE_YUV_BUFF) {
         free_arg.args.mem_free.u_addr = pCTX->virFrmBuf.luma;
-        ret_code = ioctl(pCTX->hMFC, IOCTL_MFC_FREE_BUF, &free_arg);
+        ret_code = pCTX->ops->ioctl(pCTX->hMFC, IOCTL_MFC_FREE_BUF, &free_arg);
         free_arg.args.mem_free.u_addr = pCTX->virFrmBuf.chroma;
-        ret_code = ioctl(pCTX->hMFC, IOCTL_MFC_FREE_BUF, &free_arg);
+        ret_code = pCTX->ops->ioctl(pCTX->hMFC, IOCTL_MFC_FREE_BUF, &free_arg);
     }
 
     if (pCTX->inter_buff_status & MFC_USE_STRM_BUFF) {
         free_arg.args.mem_free.u_addr = pCTX->virStrmBuf;
-        ret_code = ioctl(pCTX->hMFC, IOCTL_MFC_FREE_BUF, &free_arg);
+        ret_code = pCTX->ops->ioctl(pCTX->hMFC, IOCTL_MFC_FREE_BUF, &free_arg);
     }
 
     pCTX->inter_buff_status = MFC_USE_NONE;
 
-    munmap((void *)pCTX->mapped_addr, MMAP_BUFFER_SIZE_MMAP);
-    close(pCTX->hMFC);
+    pCTX->ops->munmap((void *)(unsigned long)pCTX->mapped_addr, MMAP_BUFFER_SIZE_MMAP);
+    pCTX->ops->close(pCTX->hMFC);
     free(pCTX);
 
     return MFC_RET_OK;
@@ -322,7 +325,7 @@ void *SsbSipMfcDecGetInBuf(void *openHandle, void **phyInBuf, int inputBufferSiz
     user_addr_arg.args.mem_alloc.codec_type = pCTX->codec_type;
     user_addr_arg.args.mem_alloc.buff_size = inputBufferSize;
     user_addr_arg.args.mem_alloc.mapped_addr = pCTX->mapped_addr;
-    ret_code = ioctl(pCTX->hMFC, IOCTL_MFC_GET_IN_BUF, &user_addr_arg);
+    ret_code = pCTX->ops->ioctl(pCTX->hMFC, IOCTL_MFC_GET_IN_BUF, &user_addr_arg);
     if (ret_code < 0) {
         LOGE("SsbSipMfcDecGetInBuf: IOCTL_MFC_GET_IN_BUF failed\n");
         return NULL;
@@ -332,9 +335,9 @@ void *SsbSipMfcDecGetInBuf(void *openHandle, void **phyInBuf, int inputBufferSiz
     pCTX->sizeStrmBuf = inputBufferSize;
     pCTX->inter_buff_status |= MFC_USE_STRM_BUFF;
 
-    *phyInBuf = (void *)pCTX->phyStrmBuf;
+    *phyInBuf = (void *)(unsigned long)pCTX->phyStrmBuf;
 
-    return (void *)pCTX->virStrmBuf;
+    return (void *)(unsigned long)pCTX->virStrmBuf;
 }
 
 SSBSIP_MFC_ERROR_CODE SsbSipMfcDecSetInBuf(void *openHandle, void *phyInBuf, void *virInBuf, int inputBufferSize)
@@ -348,8 +351,8 @@ SSBSIP_MFC_ERROR_CODE SsbSipMfcDecSetInBuf(void *openHandle, void *phyInBuf, voi
 
     pCTX  = (_MFCLIB *)openHandle;
 
-    pCTX->phyStrmBuf = (int)phyInBuf;
-    pCTX->virStrmBuf = (int)virInBuf;
+    pCTX->phyStrmBuf = (int)(unsigned long)phyInBuf;
+    pCTX->virStrmBuf = (int)(unsigned long)virInBuf;
     pCTX->sizeStrmBuf = inputBufferSize;
     return MFC_RET_OK;
 }
@@ -441,7 +444,7 @@ SSBSIP_MFC_ERROR_CODE SsbSipMfcDecSetConfig(void *openHandle, SSBSIP_MFC_DEC_CON
         return MFC_RET_INVALID_PARAM;
     }
 
-    ret_code = ioctl(pCTX->hMFC, IOCTL_MFC_SET_CONFIG, &DecArg);
+    ret_code = pCTX->ops->ioctl(pCTX->hMFC, IOCTL_MFC_SET_CONFIG, &DecArg);
     if (DecArg.ret_code != MFC_RET_OK) {
         LOGE("SsbSipMfcDecSetConfig: IOCTL_MFC_SET_CONFIG failed(ret : %d, conf_type: %d)\n", DecArg.ret_code, conf_type);
         return MFC_RET_DEC_SET_CONF_FAIL;
@@ -496,7 +499,7 @@ SSBSIP_MFC_ERROR_CODE SsbSipMfcDecGetConfig(void *openHandle, SSBSIP_MFC_DEC_CON
 
         DecArg.args.get_config.in_config_param = conf_type;
 
-        ret_code = ioctl(pCTX->hMFC, IOCTL_MFC_GET_CONFIG, &DecArg);
+        ret_code = pCTX->ops->ioctl(pCTX->hMFC, IOCTL_MFC_GET_CONFIG, &DecArg);
         if (DecArg.ret_code != MFC_RET_OK) {
             LOGE("SsbSipMfcDecGetConfig: IOCTL_MFC_GET_CONFIG failed(ret : %d, conf_type: %d)\n", DecArg.ret_code, conf_type);
             return MFC_RET_DEC_GET_CONF_FAIL;
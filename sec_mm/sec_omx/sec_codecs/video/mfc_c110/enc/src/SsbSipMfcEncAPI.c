@@ -33,12 +33,14 @@
 void *SsbSipMfcEncOpen(void *value)
 {
     int hMFCOpen;
+    const MFC_BACKEND_OPS *ops;
     _MFCLIB *pCTX;
     unsigned int mapped_addr;
     mfc_common_args EncArg;
     int ret_code;
 
-    hMFCOpen = open(S5PC110_MFC_DEV_NAME, O_RDWR | O_NDELAY);
+    ops = mfc_get_backend_ops();
+    hMFCOpen = ops->open(S5PC110_MFC_DEV_NAME, O_RDWR | O_NDELAY);
     if (hMFCOpen < 0) {
         LOGE("SsbSipMfcEncOpen: MFC Open failure\n");
         return NULL;
@@ -47,14 +49,14 @@ void *SsbSipMfcEncOpen(void *value)
     pCTX = (_MFCLIB *)malloc(sizeof(_MFCLIB));
     if (pCTX == NULL) {
         LOGE("SsbSipMfcEncOpen: malloc failed.\n");
-        close(hMFCOpen);
+        ops->close(hMFCOpen);
         return NULL;
     }
 
     if (*(unsigned int *)value == NO_CACHE ||
         *(unsigned int *)value == CACHE) {
         EncArg.args.buf_type = *(unsigned int *)value;
-        ret_code = ioctl(hMFCOpen, IOCTL_MFC_BUF_CACHE, &EncArg);
+        ret_code = ops->ioctl(hMFCOpen, IOCTL_MFC_BUF_CACHE, &EncArg);
         if (EncArg.ret_code != MFC_RET_OK) {
             LOGE("SsbSipMfcDecOpenExt: IOCTL_MFC_BUF_CACHE (%d) failed\n", EncArg.ret_code);
         }
@@ -62,7 +64,7 @@ void *SsbSipMfcEncOpen(void *value)
         LOGE("SsbSipMfcDecOpenExt: value is invalid, value: %d\n", *(int *)value);
     }
 
-    mapped_addr = (unsigned int)mmap(0, MMAP_BUFFER_SIZE_MMAP, PROT_READ | PROT_WRITE, MAP_SHARED, hMFCOpen, 0);
+    mapped_addr = (unsigned int)(unsigned long)ops->mmap(0, MMAP_BUFFER_SIZE_MMAP, PROT_READ | PROT_WRITE, MAP_SHARED, hMFCOpen, 0);
     if (!mapped_addr) {
         LOGE("SsbSipMfcEncOpen: FIMV5.0 driver address mapping failed\n");
         return NULL;
@@ -72,6 +74,7 @@ void *SsbSipMfcEncOpen(void *value)
 
     pCTX->magic = _MFCLIB_MAGIC_NUMBER;
     pCTX->hMFC = hMFCOpen;
+    pCTX->ops = ops;
     pCTX->mapped_addr = mapped_addr;
     pCTX->inter_buff_status = MFC_USE_NONE;
 
@@ -346,7 +349,7 @@ SSBSIP_MFC_ERROR_CODE SsbSipMfcEncInit(void *openHandle, void *param)
 
     EncArg.args.enc_init_mpeg4.in_mapped_addr = pCTX->mapped_addr;
 
-    ret_code = ioctl(pCTX->hMFC, IOCTL_MFC_ENC_INIT, &EncArg);
+    ret_code = pCTX->ops->ioctl(pCTX->hMFC, IOCTL_MFC_ENC_INIT, &EncArg);
     if (EncArg.ret_code != MFC_RET_OK) {
         LOGE("SsbSipMfcEncInit: IOCTL_MFC_ENC_INIT (%d) failed\n", EncArg.ret_code);
         return MFC_RET_ENC_INIT_FAIL;
@@ -387,7 +390,11 @@ SSBSIP_MFC_ERROR_CODE SsbSipMfcEncExe(void *openHandle)
     EncArg.args.enc_exe.in_strm_st = (unsigned int)pCTX->phyStrmBuf;
     EncArg.args.enc_exe.in_strm_end = (unsigned int)pCTX->phyStrmBuf + pCTX->sizeStrmBuf;
     EncArg.args.enc_exe.in_frametag = pCTX->in_frametag;
-    if (pCTX->encode_cnt == 0) {
+    if (pCTX->phyOutStrmBuf != 0) {
+        /* a buffer of the caller, the stream is not copied out of the halves */
+        EncArg.args.enc_exe.in_strm_st = pCTX->phyOutStrmBuf;
+        EncArg.args.enc_exe.in_strm_end = pCTX->phyOutStrmBuf + pCTX->sizeOutStrmBuf;
+    } else if (pCTX->encode_cnt == 0) {
         EncArg.args.enc_exe.in_strm_st = (unsigned int)pCTX->phyStrmBuf;
         EncArg.args.enc_exe.in_strm_end = (unsigned int)pCTX->phyStrmBuf + pCTX->sizeStrmBuf;
     } else {
@@ -395,7 +402,7 @@ SSBSIP_MFC_ERROR_CODE SsbSipMfcEncExe(void *openHandle)
         EncArg.args.enc_exe.in_strm_end = (unsigned int)pCTX->phyStrmBuf  + (MAX_ENCODER_OUTPUT_BUFFER_SIZE/2) + pCTX->sizeStrmBuf;
     }
 
-    ret_code = ioctl(pCTX->hMFC, IOCTL_MFC_ENC_EXE, &EncArg);
+    ret_code = pCTX->ops->ioctl(pCTX->hMFC, IOCTL_MFC_ENC_EXE, &EncArg);
     if (EncArg.ret_code != MFC_RET_OK) {
         LOGE("SsbSipMfcDecExe: IOCTL_MFC_ENC_EXE failed(ret : %d)\n", EncArg.ret_code);
         return MFC_RET_ENC_EXE_ERR;
@@ -407,6 +414,8 @@ SSBSIP_MFC_ERROR_CODE SsbSipMfcEncExe(void *openHandle)
     pCTX->encoded_C_paddr = EncArg.args.enc_exe.out_encoded_C_paddr;
     pCTX->out_frametag_top = EncArg.args.enc_exe.out_frametag_top;
     pCTX->out_frametag_bottom = EncArg.args.enc_exe.out_frametag_bottom;
+    pCTX->phyEncodedStrm = pCTX->phyOutStrmBuf;
+    pCTX->virEncodedStrm = pCTX->virOutStrmBuf;
 
     return MFC_RET_OK;
 }
@@ -426,20 +435,25 @@ SSBSIP_MFC_ERROR_CODE SsbSipMfcEncClose(void *openHandle)
 
     if (pCTX->inter_buff_status & MFC_USE_YUV_BUFF) {
         free_arg.args.mem_free.u_addr = pCTX->virFrmBuf.luma;
-        ret_code = ioctl(pCTX->hMFC, IOCTL_MFC_FREE_BUF, &free_arg);
+        ret_code = pCTX->ops->ioctl(pCTX->hMFC, IOCTL_MFC_FREE_BUF, &free_arg);
     }
 
     if (pCTX->inter_buff_status & MFC_USE_STRM_BUFF) {
         free_arg.args.mem_free.u_addr = pCTX->virStrmBuf;
-        ret_code = ioctl(pCTX->hMFC, IOCTL_MFC_FREE_BUF, &free_arg);
+        ret_code = pCTX->ops->ioctl(pCTX->hMFC, IOCTL_MFC_FREE_BUF, &free_arg);
         free_arg.args.mem_free.u_addr = pCTX->virMvRefYC;
-        ret_code = ioctl(pCTX->hMFC, IOCTL_MFC_FREE_BUF, &free_arg);
+        ret_code = pCTX->ops->ioctl(pCTX->hMFC, IOCTL_MFC_FREE_BUF, &free_arg);
+    }
+
+    if (pCTX->virClientStrmBuf != 0) {
+        free_arg.args.mem_free.u_addr = pCTX->virClientStrmBuf;
+        ret_code = pCTX->ops->ioctl(pCTX->hMFC, IOCTL_MFC_FREE_BUF, &free_arg);
     }
 
     pCTX->inter_buff_status = MFC_USE_NONE;
 
-    munmap((void *)pCTX->mapped_addr, MMAP_BUFFER_SIZE_MMAP);
-    close(pCTX->hMFC);
+    pCTX->ops->munmap((void *)(unsigned long)pCTX->mapped_addr, MMAP_BUFFER_SIZE_MMAP);
+    pCTX->ops->close(pCTX->hMFC);
     free(pCTX);
 
     return MFC_RET_OK;
@@ -492,7 +506,7 @@ SSBSIP_MFC_ERROR_CODE SsbSipMfcEncGetInBuf(void *openHandle, SSBSIP_MFC_ENC_INPU
     /* Allocate luma & chroma buf */
     user_addr_arg.args.mem_alloc.buff_size = aligned_y_size + aligned_c_size;
     user_addr_arg.args.mem_alloc.mapped_addr = pCTX->mapped_addr;
-    ret_code = ioctl(pCTX->hMFC, IOCTL_MFC_GET_IN_BUF, &user_addr_arg);
+    ret_code = pCTX->ops->ioctl(pCTX->hMFC, IOCTL_MFC_GET_IN_BUF, &user_addr_arg);
     if (ret_code < 0) {
         LOGE("SsbSipMfcEncGetInBuf: IOCTL_MFC_GET_IN_BUF failed\n");
         return MFC_RET_ENC_GET_INBUF_FAIL;
@@ -506,10 +520,10 @@ SSBSIP_MFC_ERROR_CODE SsbSipMfcEncGetInBuf(void *openHandle, SSBSIP_MFC_ENC_INPU
     pCTX->sizeFrmBuf.chroma = (unsigned int)c_size;
     pCTX->inter_buff_status |= MFC_USE_YUV_BUFF;
 
-    input_info->YPhyAddr = (void*)pCTX->phyFrmBuf.luma;
-    input_info->CPhyAddr = (void*)pCTX->phyFrmBuf.chroma;
-    input_info->YVirAddr = (void*)pCTX->virFrmBuf.luma;
-    input_info->CVirAddr = (void*)pCTX->virFrmBuf.chroma;
+    input_info->YPhyAddr = (void*)(unsigned long)pCTX->phyFrmBuf.luma;
+    input_info->CPhyAddr = (void*)(unsigned long)pCTX->phyFrmBuf.chroma;
+    input_info->YVirAddr = (void*)(unsigned long)pCTX->virFrmBuf.luma;
+    input_info->CVirAddr = (void*)(unsigned long)pCTX->virFrmBuf.chroma;
 
     input_info->YSize    = aligned_y_size;
     input_info->CSize    = aligned_c_size;
@@ -530,10 +544,10 @@ SSBSIP_MFC_ERROR_CODE SsbSipMfcEncSetInBuf(void *openHandle, SSBSIP_MFC_ENC_INPU
 
     pCTX = (_MFCLIB *)openHandle;
 
-    pCTX->phyFrmBuf.luma = (unsigned int)input_info->YPhyAddr;
-    pCTX->phyFrmBuf.chroma = (unsigned int)input_info->CPhyAddr;
-    pCTX->virFrmBuf.luma = (unsigned int)input_info->YVirAddr;
-    pCTX->virFrmBuf.chroma = (unsigned int)input_info->CVirAddr;
+    pCTX->phyFrmBuf.luma = (unsigned int)(unsigned long)input_info->YPhyAddr;
+    pCTX->phyFrmBuf.chroma = (unsigned int)(unsigned long)input_info->CPhyAddr;
+    pCTX->virFrmBuf.luma = (unsigned int)(unsigned long)input_info->YVirAddr;
+    pCTX->virFrmBuf.chroma = (unsigned int)(unsigned long)input_info->CVirAddr;
 
     pCTX->sizeFrmBuf.luma = (unsigned int)input_info->YSize;
     pCTX->sizeFrmBuf.chroma = (unsigned int)input_info->CSize;
@@ -555,12 +569,15 @@ SSBSIP_MFC_ERROR_CODE SsbSipMfcEncGetOutBuf(void *openHandle, SSBSIP_MFC_ENC_OUT
     output_info->headerSize = pCTX->encodedHeaderSize;
     output_info->dataSize = pCTX->encodedDataSize;
 
-    if (pCTX->encode_cnt == 0) {
-        output_info->StrmPhyAddr = (void *)pCTX->phyStrmBuf;
-        output_info->StrmVirAddr = (void *)pCTX->virStrmBuf;
+    if (pCTX->phyEncodedStrm != 0) {
+        output_info->StrmPhyAddr = (void *)(unsigned long)pCTX->phyEncodedStrm;
+        output_info->StrmVirAddr = (void *)(unsigned long)pCTX->virEncodedStrm;
+    } else if (pCTX->encode_cnt == 0) {
+        output_info->StrmPhyAddr = (void *)(unsigned long)pCTX->phyStrmBuf;
+        output_info->StrmVirAddr = (void *)(unsigned long)pCTX->virStrmBuf;
     } else {
-        output_info->StrmPhyAddr = (unsigned char *)pCTX->phyStrmBuf + (MAX_ENCODER_OUTPUT_BUFFER_SIZE/2);
-        output_info->StrmVirAddr = (unsigned char *)pCTX->virStrmBuf + (MAX_ENCODER_OUTPUT_BUFFER_SIZE/2);
+        output_info->StrmPhyAddr = (unsigned char *)(unsigned long)pCTX->phyStrmBuf + (MAX_ENCODER_OUTPUT_BUFFER_SIZE/2);
+        output_info->StrmVirAddr = (unsigned char *)(unsigned long)pCTX->virStrmBuf + (MAX_ENCODER_OUTPUT_BUFFER_SIZE/2);
     }
 
     pCTX->encode_cnt ++;
@@ -581,8 +598,8 @@ SSBSIP_MFC_ERROR_CODE SsbSipMfcEncGetOutBuf(void *openHandle, SSBSIP_MFC_ENC_OUT
         return MFC_RET_INVALID_PARAM;
     }
 
-    output_info->encodedYPhyAddr = (void *)pCTX->encoded_Y_paddr;
-    output_info->encodedCPhyAddr = (void *)pCTX->encoded_C_paddr;
+    output_info->encodedYPhyAddr = (void *)(unsigned long)pCTX->encoded_Y_paddr;
+    output_info->encodedCPhyAddr = (void *)(unsigned long)pCTX->encoded_C_paddr;
 
     return MFC_RET_OK;
 }
@@ -598,13 +615,58 @@ SSBSIP_MFC_ERROR_CODE SsbSipMfcEncSetOutBuf(void *openHandle, void *phyOutbuf, v
 
     pCTX = (_MFCLIB *)openHandle;
 
-    pCTX->phyStrmBuf = (int)phyOutbuf;
-    pCTX->virStrmBuf = (int)virOutbuf;
-    pCTX->sizeStrmBuf = outputBufferSize;
+    /* used from the next SsbSipMfcEncExe, NULL goes back to the encoder's own buffer */
+    if ((phyOutbuf == NULL) || (virOutbuf == NULL) || (outputBufferSize <= 0)) {
+        pCTX->phyOutStrmBuf = 0;
+        pCTX->virOutStrmBuf = 0;
+        pCTX->sizeOutStrmBuf = 0;
+    } else {
+        pCTX->phyOutStrmBuf = (unsigned int)(unsigned long)phyOutbuf;
+        pCTX->virOutStrmBuf = (unsigned int)(unsigned long)virOutbuf;
+        pCTX->sizeOutStrmBuf = outputBufferSize;
+    }
 
     return MFC_RET_OK;
 }
 
+void *SsbSipMfcEncGetStrmBuf(void *openHandle, void **phyStrmBuf, int strmBufferSize)
+{
+    int ret_code;
+    _MFCLIB *pCTX;
+    mfc_common_args user_addr_arg;
+
+    if (strmBufferSize <= 0) {
+        LOGE("SsbSipMfcEncGetStrmBuf: strmBufferSize = %d is invalid\n", strmBufferSize);
+        return NULL;
+    }
+
+    if (openHandle == NULL) {
+        LOGE("SsbSipMfcEncGetStrmBuf: openHandle is NULL\n");
+        return NULL;
+    }
+
+    pCTX = (_MFCLIB *)openHandle;
+
+    if (pCTX->virClientStrmBuf != 0) {
+        LOGE("SsbSipMfcEncGetStrmBuf: stream buffer is already allocated\n");
+        return NULL;
+    }
+
+    user_addr_arg.args.mem_alloc.codec_type = pCTX->codec_type;
+    user_addr_arg.args.mem_alloc.buff_size = strmBufferSize;
+    user_addr_arg.args.mem_alloc.mapped_addr = pCTX->mapped_addr;
+    ret_code = pCTX->ops->ioctl(pCTX->hMFC, IOCTL_MFC_GET_IN_BUF, &user_addr_arg);
+    if (ret_code < 0) {
+        LOGE("SsbSipMfcEncGetStrmBuf: IOCTL_MFC_GET_IN_BUF failed\n");
+        return NULL;
+    }
+    pCTX->virClientStrmBuf = user_addr_arg.args.mem_alloc.out_uaddr;
+
+    *phyStrmBuf = (void *)(unsigned long)user_addr_arg.args.mem_alloc.out_paddr;
+
+    return (void *)(unsigned long)pCTX->virClientStrmBuf;
+}
+
 SSBSIP_MFC_ERROR_CODE SsbSipMfcEncSetConfig(void *openHandle, SSBSIP_MFC_ENC_CONF conf_type, void *value)
 {
     int ret_code;
@@ -643,7 +705,7 @@ SSBSIP_MFC_ERROR_CODE SsbSipMfcEncSetConfig(void *openHandle, SSBSIP_MFC_ENC_CON
         return MFC_RET_INVALID_PARAM;
     }
 
-    ret_code = ioctl(pCTX->hMFC, IOCTL_MFC_SET_CONFIG, &EncArg);
+    ret_code = pCTX->ops->ioctl(pCTX->hMFC, IOCTL_MFC_SET_CONFIG, &EncArg);
     if (EncArg.ret_code != MFC_RET_OK) {
         LOGE("SsbSipMfcEncSetConfig: IOCTL_MFC_SET_CONFIG failed(ret : %d)\n", EncArg.ret_code);
         return MFC_RET_ENC_SET_CONF_FAIL;
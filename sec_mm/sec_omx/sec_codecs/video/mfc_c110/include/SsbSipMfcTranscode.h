@@ -0,0 +1,102 @@
+/*
+ *
+ * Copyright 2011 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    SsbSipMfcTranscode.h
+ * @brief   Offline transcoding with one MFC decoder and one MFC encoder
+ *   Every decoded NV12T frame goes to the encoder by its physical
+ *   addresses, scaled by FIMC first when the encoded size differs from
+ *   the decoded one. The CPU only moves the streams, never pixel data.
+ * @version 1.0
+ */
+
+#ifndef _SSBSIP_MFC_TRANSCODE_H_
+#define _SSBSIP_MFC_TRANSCODE_H_
+
+#include "SsbSipMfcApi.h"
+
+/*--------------------------------------------------------------------------------*/
+/* Structure and Type                                                             */
+/*--------------------------------------------------------------------------------*/
+typedef struct {
+    SSBSIP_MFC_CODEC_TYPE decCodecType; // [IN] codec type of the input stream
+    SSBSIP_MFC_CODEC_TYPE encCodecType; // [IN] H264_ENC, MPEG4_ENC or H263_ENC
+    int width;                          // [IN] width of encoded video, 0 for the decoded width
+    int height;                         // [IN] height of encoded video, 0 for the decoded height
+    int IDRPeriod;                      // [IN] GOP number(interval of I-frame)
+    int Bitrate;                        // [IN] rate control parameter(bit rate), 0 to encode at FrameQp
+    int FrameRate;                      // [IN] frame rate
+    int FrameQp;                        // [IN] The quantization parameter of the frame
+} SSBSIP_MFC_TRANSCODE_PARAM;
+
+typedef struct {
+    SSBSIP_MFC_DEC_OUTBUF_STATUS status;// [OUT] MFC_GETOUTBUF_DISPLAY_END once all frames are out
+    unsigned int dataSize;              // [OUT] encoded data size(without header), 0 if no frame was encoded
+    unsigned int headerSize;            // [OUT] encoded header size, set after SsbSipMfcTranscodeInit only
+    unsigned int frameType;             // [OUT] frame type of encoded stream
+    void *StrmVirAddr;                  // [OUT] virtual address of encoded stream
+    int frameTag;                       // [OUT] tag given to SsbSipMfcTranscodeExe with the input of the frame
+    int width;                          // [OUT] width of encoded video
+    int height;                         // [OUT] height of encoded video
+    int bScaled;                        // [OUT] decoded frame was scaled or copied by FIMC
+    void *decYPhyAddr;                  // [OUT] physical address of Y of the decoded frame
+    void *decCPhyAddr;                  // [OUT] physical address of CbCr of the decoded frame
+    void *encYPhyAddr;                  // [OUT] physical address of Y read by the encoder
+    void *encCPhyAddr;                  // [OUT] physical address of CbCr read by the encoder
+} SSBSIP_MFC_TRANSCODE_OUTPUT_INFO;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------------*/
+/* Transcoding APIs                                                               */
+/*--------------------------------------------------------------------------------*/
+/*
+ * Opens the decoder and the encoder instance
+ */
+void *SsbSipMfcTranscodeOpen(void);
+
+/*
+ * Returns stream buffer of the decoder, same as SsbSipMfcDecGetInBuf
+ */
+void *SsbSipMfcTranscodeGetInBuf(void *openHandle, void **phyInBuf, int inputBufferSize);
+
+/*
+ * Initializes the decoder with the stream header in the input buffer,
+ * headerLength as Frameleng of SsbSipMfcDecInit, then the encoder for
+ * the decoded size. The encoded header is in the output buffer after it.
+ */
+SSBSIP_MFC_ERROR_CODE SsbSipMfcTranscodeInit(void *openHandle, SSBSIP_MFC_TRANSCODE_PARAM *param, int headerLength);
+
+/*
+ * Decodes one frame of lengthBufFill bytes in the input buffer and
+ * encodes the frame the decoder outputs, if any.
+ * lengthBufFill 0 drains one frame held by the decoder per call.
+ * The encoded frame is valid until the next call.
+ */
+SSBSIP_MFC_ERROR_CODE SsbSipMfcTranscodeExe(void *openHandle, int lengthBufFill, int frameTag);
+
+SSBSIP_MFC_ERROR_CODE SsbSipMfcTranscodeGetOutBuf(void *openHandle, SSBSIP_MFC_TRANSCODE_OUTPUT_INFO *output_info);
+
+SSBSIP_MFC_ERROR_CODE SsbSipMfcTranscodeClose(void *openHandle);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* _SSBSIP_MFC_TRANSCODE_H_ */
@@ -53,6 +53,53 @@
 #ifndef COLOR_SPACE_CONVERTOR_H_
 #define COLOR_SPACE_CONVERTOR_H_
 
+/*--------------------------------------------------------------------------------*/
+/* Backend Selection API                                                          */
+/*--------------------------------------------------------------------------------*/
+typedef enum _CSC_BACKEND
+{
+    CSC_BACKEND_AUTO = 0,   /* fastest backend available on running CPU */
+    CSC_BACKEND_C,          /* generic C */
+    CSC_BACKEND_NEON,       /* NEON intrinsics */
+    CSC_BACKEND_NEON_ASM,   /* hand written NEON assembly */
+    CSC_BACKEND_SSE2,       /* x86 SSE2 */
+    CSC_BACKEND_AVX2,       /* x86 AVX2, checked at run time */
+    CSC_BACKEND_MAX
+} CSC_BACKEND;
+
+/*
+ * Selects backend used by the csc_* functions.
+ * Calling it is optional, CSC_BACKEND_AUTO is used on first conversion.
+ *
+ * @param backend
+ *   Backend to use[in]
+ *
+ * @return
+ *   0 on success, -1 if backend is not available on this CPU
+ */
+int csc_init(CSC_BACKEND backend);
+
+/*
+ * Returns backend currently used by the csc_* functions
+ */
+CSC_BACKEND csc_get_backend(void);
+
+/*
+ * Returns non-zero if backend can run on this CPU
+ *
+ * @param backend
+ *   Backend to check[in]
+ */
+int csc_backend_available(CSC_BACKEND backend);
+
+/*
+ * Returns printable name of backend
+ *
+ * @param backend
+ *   Backend[in]
+ */
+const char *csc_get_backend_name(CSC_BACKEND backend);
+
 /*--------------------------------------------------------------------------------*/
 /* Format Conversion API                                                          */
 /*--------------------------------------------------------------------------------*/
@@ -173,4 +220,216 @@ void csc_linear_to_tiled(char *nv12t_dest, char *yuv420p_src, int yuv420p_width,
  */
 void csc_linear_to_tiled_interleave(char *nv12t_uv_dest, char *yuv420p_u_src, char *yuv420p_v_src, int yuv420p_width, int yuv420p_uv_height);
 
+/*--------------------------------------------------------------------------------*/
+/* Tile Map API                                                                   */
+/*--------------------------------------------------------------------------------*/
+#define CSC_TILE_WIDTH   64
+#define CSC_TILE_HEIGHT  32
+
+/*
+ * Byte offset of every 64x32 tile of one NV12T plane.
+ * Built once per resolution by csc_tile_map_update().
+ */
+typedef struct _CSC_TILE_MAP
+{
+    int           width;       /* plane width in bytes */
+    int           height;      /* plane height in lines */
+    int           x_tile_num;  /* tiles per row covering width */
+    int           y_tile_num;  /* tile rows covering height */
+    unsigned int *tile_offset; /* x_tile_num * y_tile_num entries, row major */
+} CSC_TILE_MAP;
+
+/*
+ * Builds tile offset table for plane of given size.
+ * Does nothing if map is already built for width and height.
+ *
+ * @param map
+ *   Tile map. Must be zero initialized before first use[in/out]
+ *
+ * @param width
+ *   Width of plane in bytes[in]
+ *
+ * @param height
+ *   Height of plane in lines[in]
+ *
+ * @return
+ *   0 on success, -1 on failure
+ */
+int csc_tile_map_update(CSC_TILE_MAP *map, int width, int height);
+
+/*
+ * Frees tile offset table
+ *
+ * @param map
+ *   Tile map[in/out]
+ */
+void csc_tile_map_release(CSC_TILE_MAP *map);
+
+/*
+ * Converts tiled data to linear using tile map.
+ * Same output as csc_tiled_to_linear()
+ *
+ * @param yuv420_dest
+ *   Y or UV plane address of YUV420[out]
+ *
+ * @param nv12t_src
+ *   Y or UV plane address of NV12T[in]
+ *
+ * @param map
+ *   Tile map built for width and height of the plane[in]
+ */
+void csc_tiled_to_linear_map(char *yuv420_dest, char *nv12t_src, CSC_TILE_MAP *map);
+
+/*
+ * Converts and Deinterleaves tiled data to linear using tile map.
+ * Same output as csc_tiled_to_linear_deinterleave()
+ *
+ * @param yuv420_u_dest
+ *   U plane address of YUV420P[out]
+ *
+ * @param yuv420_v_dest
+ *   V plane address of YUV420P[out]
+ *
+ * @param nv12t_uv_src
+ *   UV plane address of NV12T[in]
+ *
+ * @param map
+ *   Tile map built for width and height/2 of YUV420[in]
+ */
+void csc_tiled_to_linear_deinterleave_map(char *yuv420_u_dest, char *yuv420_v_dest, char *nv12t_uv_src, CSC_TILE_MAP *map);
+
+/*--------------------------------------------------------------------------------*/
+/* Fused Frame Conversion API                                                     */
+/*--------------------------------------------------------------------------------*/
+typedef enum _CSC_LAYOUT
+{
+    CSC_LAYOUT_NV12 = 0,    /* plane[0]: Y, plane[1]: CbCr interleaved */
+    CSC_LAYOUT_NV21,        /* plane[0]: Y, plane[1]: CrCb interleaved */
+    CSC_LAYOUT_I420,        /* plane[0]: Y, plane[1]: Cb, plane[2]: Cr */
+    CSC_LAYOUT_YUYV         /* plane[0]: Y0 Cb Y1 Cr, source of csc_linear_to_tiled_frame() only */
+} CSC_LAYOUT;
+
+/*
+ * Destination or source of fused conversion.
+ * stride is the distance in bytes between two lines of a plane and may
+ * be larger than the picture width, e.g. for gralloc buffers.
+ */
+typedef struct _CSC_LINEAR_FRAME
+{
+    CSC_LAYOUT layout;
+    char      *plane[3];
+    int        stride[3];
+} CSC_LINEAR_FRAME;
+
+/*
+ * Converts NV12T frame to linear frame in one pass.
+ * Y and UV are converted band by band straight into the layout and
+ * strides of dest, so no further copy is needed to honour stride.
+ *
+ * @param dest
+ *   Layout, plane addresses and strides of linear frame[out]
+ *
+ * @param nv12t_y_src
+ *   Y plane address of NV12T[in]
+ *
+ * @param nv12t_uv_src
+ *   UV plane address of NV12T[in]
+ *
+ * @param y_map
+ *   Tile map built for width and height of YUV420[in]
+ *
+ * @param uv_map
+ *   Tile map built for width and height/2 of YUV420[in]
+ */
+void csc_tiled_to_linear_frame(CSC_LINEAR_FRAME *dest, char *nv12t_y_src, char *nv12t_uv_src,
+                               CSC_TILE_MAP *y_map, CSC_TILE_MAP *uv_map);
+
+/*
+ * Returns number of bands of NV12T frame.
+ * A band is one UV tile row and the two Y tile rows of the same lines.
+ *
+ * @param y_map
+ *   Tile map of Y plane[in]
+ *
+ * @param uv_map
+ *   Tile map of UV plane[in]
+ */
+int csc_tiled_frame_band_num(CSC_TILE_MAP *y_map, CSC_TILE_MAP *uv_map);
+
+/*
+ * Same as csc_tiled_to_linear_frame() for bands [band_start, band_end) only.
+ * Different bands never touch the same bytes of dest.
+ */
+void csc_tiled_to_linear_frame_bands(CSC_LINEAR_FRAME *dest, char *nv12t_y_src, char *nv12t_uv_src,
+                                     CSC_TILE_MAP *y_map, CSC_TILE_MAP *uv_map, int band_start, int band_end);
+
+/*
+ * Converts linear frame to NV12T frame in one pass.
+ * Lines are read with the strides of src and written straight into the
+ * tiles, so a frame with padding needs no copy before conversion.
+ * Chroma of a YUYV frame is taken from the even lines.
+ * Tile padding right of and below the picture is not written.
+ * @param nv12t_y_dest
+ *   Y plane address of NV12T[out]
+ * @param nv12t_uv_dest
+ *   UV plane address of NV12T[out]
+ * @param src
+ *   Layout, plane addresses and strides of linear frame[in]
+ * @param y_map
+ *   Tile map built for width and height of YUV420[in]
+ * @param uv_map
+ *   Tile map built for width and height/2 of YUV420[in]
+ */
+void csc_linear_to_tiled_frame(char *nv12t_y_dest, char *nv12t_uv_dest, CSC_LINEAR_FRAME *src,
+                               CSC_TILE_MAP *y_map, CSC_TILE_MAP *uv_map);
+
+/*
+ * Same as csc_linear_to_tiled_frame() for bands [band_start, band_end) only.
+ */
+void csc_linear_to_tiled_frame_bands(char *nv12t_y_dest, char *nv12t_uv_dest, CSC_LINEAR_FRAME *src,
+                                     CSC_TILE_MAP *y_map, CSC_TILE_MAP *uv_map, int band_start, int band_end);
+
+/*--------------------------------------------------------------------------------*/
+/* Parallel Conversion API                                                        */
+/*--------------------------------------------------------------------------------*/
+/*
+ * Registers a user of the shared worker pool.
+ * Threads are started on first parallel conversion, one per online CPU
+ * up to 4, the calling thread included.
+ *
+ * @return
+ *   0 on success
+ */
+int csc_parallel_open(void);
+
+/*
+ * Unregisters a user of the shared worker pool.
+ * The last user stops the worker threads.
+ */
+void csc_parallel_close(void);
+
+/*
+ * Returns number of threads a parallel conversion runs on, caller included
+ */
+int csc_parallel_thread_num(void);
+
+/*
+ * Band parallel versions of the functions above. Same arguments and same
+ * output. Without csc_parallel_open(), on a single core or while the pool
+ * runs the conversion of another thread they run on the calling thread only.
+ */
+void csc_tiled_to_linear_parallel(char *yuv420_dest, char *nv12t_src, int yuv420_width, int yuv420_height);
+
+void csc_tiled_to_linear_deinterleave_parallel(char *yuv420_u_dest, char *yuv420_v_dest, char *nv12t_uv_src, int yuv420_width, int yuv420_uv_height);
+
+void csc_linear_to_tiled_parallel(char *nv12t_dest, char *yuv420_src, int yuv420_width, int yuv420_height);
+
+void csc_linear_to_tiled_interleave_parallel(char *nv12t_uv_dest, char *yuv420p_u_src, char *yuv420p_v_src, int yuv420_width, int yuv420_uv_height);
+
+void csc_tiled_to_linear_frame_parallel(CSC_LINEAR_FRAME *dest, char *nv12t_y_src, char *nv12t_uv_src,
+                                        CSC_TILE_MAP *y_map, CSC_TILE_MAP *uv_map);
+
+void csc_linear_to_tiled_frame_parallel(char *nv12t_y_dest, char *nv12t_uv_dest, CSC_LINEAR_FRAME *src,
+                                        CSC_TILE_MAP *y_map, CSC_TILE_MAP *uv_map);
+
 #endif /*COLOR_SPACE_CONVERTOR_H_*/
@@ -0,0 +1,123 @@
+/*
+ *
+ * Copyright 2011 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    mfc_backend.h
+ * @brief   Device access of the SsbSipMfc API
+ *   Every open, ioctl, mmap, munmap and close of the MFC device made by
+ *   SsbSipMfcDecAPI.c and SsbSipMfcEncAPI.c goes through a backend, either
+ *   the /dev/s3c-mfc driver or a userspace simulator of it.
+ * @version 1.0
+ */
+
+#ifndef MFC_BACKEND_H_
+#define MFC_BACKEND_H_
+
+#include <sys/types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum _MFC_BACKEND
+{
+    MFC_BACKEND_AUTO = 0,   /* build default */
+    MFC_BACKEND_DEVICE,     /* MFC driver, S5PC110_MFC_DEV_NAME */
+    MFC_BACKEND_SIM,        /* userspace simulator of the driver and the hardware, USE_MFC_SIM only */
+    MFC_BACKEND_MAX
+} MFC_BACKEND;
+
+/* Same semantics as the system calls, file descriptors are only valid for the backend */
+typedef struct _MFC_BACKEND_OPS
+{
+    MFC_BACKEND backend;
+    int   (*open)(const char *pathname, int flags);
+    int   (*close)(int fd);
+    int   (*ioctl)(int fd, unsigned int request, void *arg);
+    void *(*mmap)(void *addr, size_t length, int prot, int flags, int fd, off_t offset);
+    int   (*munmap)(void *addr, size_t length);
+} MFC_BACKEND_OPS;
+
+/*
+ * Selects backend used by SsbSipMfcDecOpen and SsbSipMfcEncOpen.
+ * Instances opened before keep their backend.
+ * Calling it is optional, MFC_BACKEND_AUTO is used on first open.
+ *
+ * MFC_BACKEND_AUTO is MFC_BACKEND_SIM if built with USE_MFC_SIM and
+ * MFC_BACKEND_DEVICE otherwise. The simulator is only built for host
+ * tests, never into the device library.
+ *
+ * @param backend
+ *   Backend to use[in]
+ *
+ * @return
+ *   0 on success, -1 if backend is unknown or not built in
+ */
+int mfc_backend_init(MFC_BACKEND backend);
+
+/*
+ * Returns backend used by next open
+ */
+MFC_BACKEND mfc_get_backend(void);
+
+/*
+ * Returns printable name of backend
+ */
+const char *mfc_get_backend_name(MFC_BACKEND backend);
+
+/*
+ * Returns operations of backend used by next open
+ */
+const MFC_BACKEND_OPS *mfc_get_backend_ops(void);
+
+#ifdef USE_MFC_SIM
+/*--------------------------------------------------------------------------------*/
+/* Simulator                                                                      */
+/*--------------------------------------------------------------------------------*/
+/*
+ * The simulator parses the stream headers to get the picture size and
+ * the display order, stamps every decoded NV12T frame and produces
+ * parseable headers and frames of the rate controlled size on encode.
+ * Decode and encode runs of all instances are serialized like on the one
+ * hardware block and take as long as the S5PC110 MFC would: 1080p30
+ * decode, 720p30 encode, plus a fixed overhead per run.
+ *
+ * SEC_MFC_SIM_SPEED environment variable scales the run time in percent
+ * of the hardware speed, read on every open: 200 runs twice as fast,
+ * 0 does not wait at all. Default is 100.
+ *
+ * Luma tile n of a decoded frame is filled with (frame tag + n) & 0xff,
+ * chroma with 0x80.
+ */
+#define MFC_SIM_DEC_MB_PER_SEC      244800  /* 1920x1088 at 30 fps */
+#define MFC_SIM_ENC_MB_PER_SEC      108000  /* 1280x720 at 30 fps */
+#define MFC_SIM_RUN_OVERHEAD_US     150
+#define MFC_SIM_FILL_VALUE(tag, n)  ((unsigned char)((tag) + (n)))
+
+/*
+ * Returns user address of size bytes at physical address phys in the
+ * memory of any simulator instance, NULL if they are not there.
+ * For stand-ins of other DMA blocks working on MFC buffers.
+ */
+unsigned char *mfc_sim_map_phys(unsigned int phys, unsigned int size);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /*MFC_BACKEND_H_*/
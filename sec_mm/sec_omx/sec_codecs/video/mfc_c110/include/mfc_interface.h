@@ -18,6 +18,7 @@
 #define _MFC_INTERFACE_H_
 
 #include "SsbSipMfcApi.h"
+#include "mfc_backend.h"
 
 #define IOCTL_MFC_DEC_INIT                     0x00800001
 #define IOCTL_MFC_ENC_INIT                     0x00800002
@@ -342,6 +343,13 @@ typedef struct {
     unsigned int encoded_Y_paddr;
     unsigned int encoded_C_paddr;
     unsigned int encode_cnt;
+    unsigned int phyOutStrmBuf;     /* encoder stream buffer set by SsbSipMfcEncSetOutBuf, 0 for its own */
+    unsigned int virOutStrmBuf;
+    int sizeOutStrmBuf;
+    unsigned int phyEncodedStrm;    /* where SsbSipMfcEncExe put the last frame, 0 for its own buffer */
+    unsigned int virEncodedStrm;
+    unsigned int virClientStrmBuf;  /* allocated by SsbSipMfcEncGetStrmBuf */
+    const MFC_BACKEND_OPS *ops;
 } _MFCLIB;
 
 #endif /* _MFC_INTERFACE_H_ */
@@ -0,0 +1,65 @@
+LOCAL_PATH := $(call my-dir)
+include $(CLEAR_VARS)
+
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_SRC_FILES := \
+	SsbSipMfcTranscode.c \
+	mfc_fimc.c
+
+LOCAL_MODULE := libsecmfctranscode.aries
+
+LOCAL_CFLAGS :=
+
+LOCAL_ARM_MODE := arm
+
+LOCAL_STATIC_LIBRARIES := libsecmfcdecapi.aries libsecmfcencapi.aries libsecmfcbackend.aries \
+	libseccsc.aries
+
+LOCAL_SHARED_LIBRARIES := liblog
+
+LOCAL_C_INCLUDES := \
+	$(SEC_CODECS)/video/mfc_c110/include \
+	$(SEC_OMX_TOP)/../../include
+
+include $(BUILD_STATIC_LIBRARY)
+
+#########################################################################
+# Build transcoding test for host, on the MFC simulator
+#########################################################################
+
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES := \
+	mfc_transcode_test.c \
+	SsbSipMfcTranscode.c \
+	mfc_fimc.c \
+	../backend/mfc_backend.c \
+	../backend/mfc_sim.c \
+	../backend/mfc_sim_dec.c \
+	../backend/mfc_sim_enc.c \
+	../backend/mfc_sim_stream.c \
+	../dec/src/SsbSipMfcDecAPI.c \
+	../enc/src/SsbSipMfcEncAPI.c \
+	../csc/color_space_convertor.c \
+	../csc/csc_dispatch.c \
+	../csc/csc_frame.c \
+	../csc/csc_neon.c \
+	../csc/csc_parallel.c \
+	../csc/csc_sse2.c \
+	../csc/csc_avx2.c \
+	../csc/csc_tile_map.c
+
+LOCAL_MODULE := mfc_transcode_test_host
+
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_CFLAGS := -DUSE_MFC_SIM
+
+LOCAL_LDLIBS := -lpthread -lrt
+
+LOCAL_C_INCLUDES := \
+	$(SEC_CODECS)/video/mfc_c110/include \
+	$(SEC_OMX_TOP)/../../include
+
+include $(BUILD_HOST_EXECUTABLE)
@@ -0,0 +1,450 @@
+/*
+ *
+ * Copyright 2011 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    SsbSipMfcTranscode.c
+ * @brief   Offline transcoding with one MFC decoder and one MFC encoder
+ *   A decoded frame is handed to the encoder as it lies in the frame
+ *   buffers of the decoder: SsbSipMfcEncSetInBuf takes its physical
+ *   addresses. Decode, scale and encode of a frame all finish within
+ *   SsbSipMfcTranscodeExe, so the decoder never reuses a frame buffer the
+ *   encoder still reads. FIMC scales into the input buffer of the encoder
+ *   when the encoded size, the crop offset or the NV12T tile layout
+ *   differs from the decoded frame, and copies a frame whose buffers are
+ *   not 64KB aligned as SsbSipMfcEncSetInBuf requires.
+ * @version 1.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <utils/Log.h>
+
+#include "SsbSipMfcTranscode.h"
+#include "mfc_interface.h"
+#include "mfc_fimc.h"
+
+#define _MFCTRANSCODE_MAGIC_NUMBER  0x92241003
+
+typedef struct _MFCTRANSCODE
+{
+    unsigned int               magic;
+    void                      *hDec;
+    void                      *hEnc;
+    MFC_BACKEND                backend;
+    MFC_FIMC                   fimc;
+    int                        bFimcOpen;
+    int                        bInit;
+    int                        bLastFrame;
+    int                        bEnd;
+    MFC_FIMC_FRAME             decFrame;    /* layout and visible area of decoded frames */
+    MFC_FIMC_FRAME             encFrame;    /* input buffer of the encoder */
+    SSBSIP_MFC_ENC_INPUT_INFO  encInput;
+    int                        bScale;
+    SSBSIP_MFC_TRANSCODE_OUTPUT_INFO out;
+} _MFCTRANSCODE;
+
+static _MFCTRANSCODE *SsbSipMfcTranscodeGetContext(void *openHandle)
+{
+    _MFCTRANSCODE *pCTX = (_MFCTRANSCODE *)openHandle;
+
+    if ((pCTX == NULL) || (pCTX->magic != _MFCTRANSCODE_MAGIC_NUMBER))
+        return NULL;
+
+    return pCTX;
+}
+
+/*
+ * The encoder reads a decoded frame in place only if it lays out the
+ * tiles of its own size the same way and the visible area starts at 0,0
+ */
+static int SsbSipMfcTranscodeNeedScale(MFC_FIMC_FRAME *pDec, int width, int height)
+{
+    if ((pDec->width != width) || (pDec->height != height) ||
+        (pDec->left != 0) || (pDec->top != 0))
+        return 1;
+
+    if ((ALIGN_TO_128B(pDec->bufWidth) != ALIGN_TO_128B(width)) ||
+        (ALIGN_TO_32B(pDec->bufHeight) != ALIGN_TO_32B(height)) ||
+        (ALIGN_TO_32B(pDec->bufHeight / 2) != ALIGN_TO_32B(height / 2)))
+        return 1;
+
+    return 0;
+}
+
+/* FIMC is opened for the first frame it writes, zero copy never needs it */
+static int SsbSipMfcTranscodeFimcOpen(_MFCTRANSCODE *pCTX)
+{
+    if (pCTX->bFimcOpen)
+        return 0;
+
+    if (mfc_fimc_open(&pCTX->fimc, pCTX->backend) != 0)
+        return -1;
+    pCTX->bFimcOpen = 1;
+
+    return 0;
+}
+
+static SSBSIP_MFC_ERROR_CODE SsbSipMfcTranscodeEncInit(_MFCTRANSCODE *pCTX, SSBSIP_MFC_TRANSCODE_PARAM *param,
+                                                       int width, int height)
+{
+    SSBSIP_MFC_ENC_H264_PARAM  h264Param;
+    SSBSIP_MFC_ENC_MPEG4_PARAM mpeg4Param;
+    SSBSIP_MFC_ENC_H263_PARAM  h263Param;
+    void *pParam;
+    int bRateControl = (param->Bitrate > 0) ? 1 : 0;
+
+    switch (param->encCodecType) {
+    case H264_ENC:
+        memset(&h264Param, 0, sizeof(h264Param));
+        h264Param.codecType            = H264_ENC;
+        h264Param.SourceWidth          = width;
+        h264Param.SourceHeight         = height;
+        h264Param.IDRPeriod            = param->IDRPeriod;
+        h264Param.EnableFRMRateControl = bRateControl;
+        h264Param.Bitrate              = param->Bitrate;
+        h264Param.FrameQp              = param->FrameQp;
+        h264Param.FrameQp_P            = param->FrameQp;
+        h264Param.FrameQp_B            = param->FrameQp;
+        h264Param.QSCodeMax            = 51;
+        h264Param.QSCodeMin            = 10;
+        h264Param.CBRPeriodRf          = 100;
+        h264Param.FrameMap             = NV12_TILE;
+        h264Param.ProfileIDC           = 2;    /* baseline */
+        h264Param.LevelIDC             = 40;
+        h264Param.FrameRate            = param->FrameRate;
+        h264Param.NumberReferenceFrames = 1;
+        h264Param.NumberRefForPframes  = 1;
+        h264Param.LoopFilterDisable    = 1;
+        h264Param.DarkDisable          = 1;
+        h264Param.SmoothDisable        = 1;
+        h264Param.StaticDisable        = 1;
+        h264Param.ActivityDisable      = 1;
+        pParam = &h264Param;
+        break;
+    case MPEG4_ENC:
+        memset(&mpeg4Param, 0, sizeof(mpeg4Param));
+        mpeg4Param.codecType            = MPEG4_ENC;
+        mpeg4Param.SourceWidth          = width;
+        mpeg4Param.SourceHeight         = height;
+        mpeg4Param.IDRPeriod            = param->IDRPeriod;
+        mpeg4Param.EnableFRMRateControl = bRateControl;
+        mpeg4Param.Bitrate              = param->Bitrate;
+        mpeg4Param.FrameQp              = param->FrameQp;
+        mpeg4Param.FrameQp_P            = param->FrameQp;
+        mpeg4Param.FrameQp_B            = param->FrameQp;
+        mpeg4Param.QSCodeMax            = 30;
+        mpeg4Param.QSCodeMin            = 10;
+        mpeg4Param.CBRPeriodRf          = 10;
+        mpeg4Param.FrameMap             = NV12_TILE;
+        mpeg4Param.ProfileIDC           = 0;    /* simple */
+        mpeg4Param.LevelIDC             = 4;
+        mpeg4Param.TimeIncreamentRes    = param->FrameRate;
+        mpeg4Param.VopTimeIncreament    = 1;
+        mpeg4Param.DisableQpelME        = 1;
+        pParam = &mpeg4Param;
+        break;
+    case H263_ENC:
+        memset(&h263Param, 0, sizeof(h263Param));
+        h263Param.codecType            = H263_ENC;
+        h263Param.SourceWidth          = width;
+        h263Param.SourceHeight         = height;
+        h263Param.IDRPeriod            = param->IDRPeriod;
+        h263Param.EnableFRMRateControl = bRateControl;
+        h263Param.Bitrate              = param->Bitrate;
+        h263Param.FrameQp              = param->FrameQp;
+        h263Param.FrameQp_P            = param->FrameQp;
+        h263Param.QSCodeMax            = 30;
+        h263Param.QSCodeMin            = 10;
+        h263Param.CBRPeriodRf          = 10;
+        h263Param.FrameMap             = NV12_TILE;
+        h263Param.FrameRate            = param->FrameRate;
+        pParam = &h263Param;
+        break;
+    default:
+        LOGE("SsbSipMfcTranscodeInit: codec type %d is no encoder\n", param->encCodecType);
+        return MFC_RET_INVALID_PARAM;
+    }
+
+    return SsbSipMfcEncInit(pCTX->hEnc, pParam);
+}
+
+void *SsbSipMfcTranscodeOpen(void)
+{
+    _MFCTRANSCODE *pCTX;
+    unsigned int decBufType = NO_CACHE;    /* decoded frames never reach the CPU */
+    unsigned int encBufType = CACHE;       /* the stream is copied out by the CPU */
+
+    pCTX = (_MFCTRANSCODE *)malloc(sizeof(_MFCTRANSCODE));
+    if (pCTX == NULL) {
+        LOGE("SsbSipMfcTranscodeOpen: malloc failed\n");
+        return NULL;
+    }
+    memset(pCTX, 0, sizeof(_MFCTRANSCODE));
+
+    pCTX->hDec = SsbSipMfcDecOpen(&decBufType);
+    if (pCTX->hDec == NULL) {
+        LOGE("SsbSipMfcTranscodeOpen: SsbSipMfcDecOpen failed\n");
+        goto err;
+    }
+
+    pCTX->hEnc = SsbSipMfcEncOpen(&encBufType);
+    if (pCTX->hEnc == NULL) {
+        LOGE("SsbSipMfcTranscodeOpen: SsbSipMfcEncOpen failed\n");
+        goto err;
+    }
+
+    pCTX->backend = mfc_get_backend();
+    pCTX->magic = _MFCTRANSCODE_MAGIC_NUMBER;
+
+    return (void *)pCTX;
+
+err:
+    if (pCTX->hDec != NULL)
+        SsbSipMfcDecClose(pCTX->hDec);
+    free(pCTX);
+    return NULL;
+}
+
+void *SsbSipMfcTranscodeGetInBuf(void *openHandle, void **phyInBuf, int inputBufferSize)
+{
+    _MFCTRANSCODE *pCTX = SsbSipMfcTranscodeGetContext(openHandle);
+
+    if (pCTX == NULL) {
+        LOGE("SsbSipMfcTranscodeGetInBuf: openHandle is invalid\n");
+        return NULL;
+    }
+
+    return SsbSipMfcDecGetInBuf(pCTX->hDec, phyInBuf, inputBufferSize);
+}
+
+SSBSIP_MFC_ERROR_CODE SsbSipMfcTranscodeInit(void *openHandle, SSBSIP_MFC_TRANSCODE_PARAM *param, int headerLength)
+{
+    _MFCTRANSCODE *pCTX = SsbSipMfcTranscodeGetContext(openHandle);
+    SSBSIP_MFC_DEC_OUTPUT_INFO decInfo;
+    SSBSIP_MFC_ENC_OUTPUT_INFO encOutput;
+    SSBSIP_MFC_ERROR_CODE      ret;
+    int width, height;
+
+    if ((pCTX == NULL) || (param == NULL) || pCTX->bInit) {
+        LOGE("SsbSipMfcTranscodeInit: openHandle or param is invalid\n");
+        return MFC_RET_INVALID_PARAM;
+    }
+
+    ret = SsbSipMfcDecInit(pCTX->hDec, param->decCodecType, headerLength);
+    if (ret != MFC_RET_OK) {
+        LOGE("SsbSipMfcTranscodeInit: SsbSipMfcDecInit failed(ret : %d)\n", ret);
+        return ret;
+    }
+
+    /* decoded frames are laid out for img_width x img_height */
+    SsbSipMfcDecGetOutBuf(pCTX->hDec, &decInfo);
+    pCTX->decFrame.bufWidth  = decInfo.img_width;
+    pCTX->decFrame.bufHeight = decInfo.img_height;
+    pCTX->decFrame.left      = decInfo.crop_left_offset;
+    pCTX->decFrame.top       = decInfo.crop_top_offset;
+    pCTX->decFrame.width     = decInfo.img_width - decInfo.crop_left_offset - decInfo.crop_right_offset;
+    pCTX->decFrame.height    = decInfo.img_height - decInfo.crop_top_offset - decInfo.crop_bottom_offset;
+
+    width  = (param->width > 0) ? param->width : pCTX->decFrame.width;
+    height = (param->height > 0) ? param->height : pCTX->decFrame.height;
+    pCTX->bScale = SsbSipMfcTranscodeNeedScale(&pCTX->decFrame, width, height);
+
+    ret = SsbSipMfcTranscodeEncInit(pCTX, param, width, height);
+    if (ret != MFC_RET_OK) {
+        LOGE("SsbSipMfcTranscodeInit: SsbSipMfcEncInit of %dx%d failed(ret : %d)\n", width, height, ret);
+        return ret;
+    }
+
+    /* FIMC writes the own input buffer of the encoder, also for unscaled frames out of alignment */
+    ret = SsbSipMfcEncGetInBuf(pCTX->hEnc, &pCTX->encInput);
+    if (ret != MFC_RET_OK)
+        return ret;
+
+    pCTX->encFrame.YPhyAddr  = (unsigned int)(unsigned long)pCTX->encInput.YPhyAddr;
+    pCTX->encFrame.CPhyAddr  = (unsigned int)(unsigned long)pCTX->encInput.CPhyAddr;
+    pCTX->encFrame.bufWidth  = width;
+    pCTX->encFrame.bufHeight = height;
+    pCTX->encFrame.width     = width;
+    pCTX->encFrame.height    = height;
+
+    if (pCTX->bScale && (SsbSipMfcTranscodeFimcOpen(pCTX) != 0))
+        return MFC_RET_FAIL;
+
+    SsbSipMfcEncGetOutBuf(pCTX->hEnc, &encOutput);
+
+    memset(&pCTX->out, 0, sizeof(pCTX->out));
+    pCTX->out.status      = MFC_GETOUTBUF_STATUS_NULL;
+    pCTX->out.headerSize  = encOutput.headerSize;
+    pCTX->out.StrmVirAddr = encOutput.StrmVirAddr;
+    pCTX->out.width       = width;
+    pCTX->out.height      = height;
+    pCTX->bInit = 1;
+
+    LOGV("SsbSipMfcTranscodeInit: %dx%d at %d,%d of %dx%d to %dx%d%s\n",
+         pCTX->decFrame.width, pCTX->decFrame.height, pCTX->decFrame.left, pCTX->decFrame.top,
+         pCTX->decFrame.bufWidth, pCTX->decFrame.bufHeight, width, height,
+         pCTX->bScale ? " through FIMC" : "");
+
+    return MFC_RET_OK;
+}
+
+SSBSIP_MFC_ERROR_CODE SsbSipMfcTranscodeExe(void *openHandle, int lengthBufFill, int frameTag)
+{
+    _MFCTRANSCODE *pCTX = SsbSipMfcTranscodeGetContext(openHandle);
+    SSBSIP_MFC_DEC_OUTPUT_INFO   decOutput;
+    SSBSIP_MFC_ENC_INPUT_INFO    encInput;
+    SSBSIP_MFC_ENC_OUTPUT_INFO   encOutput;
+    SSBSIP_MFC_DEC_OUTBUF_STATUS status;
+    SSBSIP_MFC_ERROR_CODE        ret;
+    MFC_FIMC_FRAME               srcFrame;
+    int bScale;
+    int lastFrame = 1;
+    int tag = 0;
+
+    if ((pCTX == NULL) || (pCTX->bInit == 0)) {
+        LOGE("SsbSipMfcTranscodeExe: openHandle is invalid or not initialized\n");
+        return MFC_RET_INVALID_PARAM;
+    }
+
+    pCTX->out.dataSize   = 0;
+    pCTX->out.headerSize = 0;
+    pCTX->out.bScaled    = 0;
+
+    if (pCTX->bEnd) {
+        pCTX->out.status = MFC_GETOUTBUF_DISPLAY_END;
+        return MFC_RET_OK;
+    }
+
+    if (lengthBufFill > 0) {
+        SsbSipMfcDecSetConfig(pCTX->hDec, MFC_DEC_SETCONF_FRAME_TAG, &frameTag);
+    } else if (pCTX->bLastFrame == 0) {
+        SsbSipMfcDecSetConfig(pCTX->hDec, MFC_DEC_SETCONF_IS_LAST_FRAME, &lastFrame);
+        pCTX->bLastFrame = 1;
+    }
+
+    ret = SsbSipMfcDecExe(pCTX->hDec, lengthBufFill);
+    if (ret != MFC_RET_OK) {
+        LOGE("SsbSipMfcTranscodeExe: SsbSipMfcDecExe failed(ret : %d)\n", ret);
+        return ret;
+    }
+
+    status = SsbSipMfcDecGetOutBuf(pCTX->hDec, &decOutput);
+    pCTX->out.status = status;
+    if (status == MFC_GETOUTBUF_DISPLAY_END)
+        pCTX->bEnd = 1;
+    if ((status != MFC_GETOUTBUF_DISPLAY_DECODING) && (status != MFC_GETOUTBUF_DISPLAY_ONLY))
+        return MFC_RET_OK;
+
+    if ((decOutput.img_width != pCTX->decFrame.bufWidth) || (decOutput.img_height != pCTX->decFrame.bufHeight)) {
+        LOGE("SsbSipMfcTranscodeExe: resolution change to %dx%d is not supported\n",
+             decOutput.img_width, decOutput.img_height);
+        return MFC_RET_DEC_EXE_ERR;
+    }
+    SsbSipMfcDecGetConfig(pCTX->hDec, MFC_DEC_GETCONF_FRAME_TAG, &tag);
+
+    /* the encoder reads frames set with SsbSipMfcEncSetInBuf only at 64KB aligned addresses */
+    bScale = pCTX->bScale;
+    if ((((unsigned int)(unsigned long)decOutput.YPhyAddr | (unsigned int)(unsigned long)decOutput.CPhyAddr) & 0xFFFF) != 0) {
+        LOGV("SsbSipMfcTranscodeExe: frame at %p/%p is not 64KB aligned, copied by FIMC\n",
+             decOutput.YPhyAddr, decOutput.CPhyAddr);
+        bScale = 1;
+    }
+
+    if (bScale) {
+        if (SsbSipMfcTranscodeFimcOpen(pCTX) != 0) {
+            LOGE("SsbSipMfcTranscodeExe: mfc_fimc_open failed\n");
+            return MFC_RET_FAIL;
+        }
+        srcFrame = pCTX->decFrame;
+        srcFrame.YPhyAddr = (unsigned int)(unsigned long)decOutput.YPhyAddr;
+        srcFrame.CPhyAddr = (unsigned int)(unsigned long)decOutput.CPhyAddr;
+        if (mfc_fimc_scale(&pCTX->fimc, &srcFrame, &pCTX->encFrame) != 0) {
+            LOGE("SsbSipMfcTranscodeExe: mfc_fimc_scale failed\n");
+            return MFC_RET_FAIL;
+        }
+        /* back from a frame buffer of the decoder a zero copy frame left set */
+        ret = SsbSipMfcEncSetInBuf(pCTX->hEnc, &pCTX->encInput);
+        if (ret != MFC_RET_OK)
+            return ret;
+    } else {
+        /* the frame buffer of the decoder is the input of the encoder */
+        encInput.YPhyAddr = decOutput.YPhyAddr;
+        encInput.CPhyAddr = decOutput.CPhyAddr;
+        encInput.YVirAddr = decOutput.YVirAddr;
+        encInput.CVirAddr = decOutput.CVirAddr;
+        encInput.YSize    = ALIGN_TO_8KB(ALIGN_TO_128B(pCTX->decFrame.bufWidth) * ALIGN_TO_32B(pCTX->decFrame.bufHeight));
+        encInput.CSize    = ALIGN_TO_8KB(ALIGN_TO_128B(pCTX->decFrame.bufWidth) * ALIGN_TO_32B(pCTX->decFrame.bufHeight / 2));
+        ret = SsbSipMfcEncSetInBuf(pCTX->hEnc, &encInput);
+        if (ret != MFC_RET_OK)
+            return ret;
+    }
+
+    SsbSipMfcEncSetConfig(pCTX->hEnc, MFC_ENC_SETCONF_FRAME_TAG, &tag);
+    ret = SsbSipMfcEncExe(pCTX->hEnc);
+    if (ret != MFC_RET_OK) {
+        LOGE("SsbSipMfcTranscodeExe: SsbSipMfcEncExe failed(ret : %d)\n", ret);
+        return ret;
+    }
+    SsbSipMfcEncGetOutBuf(pCTX->hEnc, &encOutput);
+    SsbSipMfcEncGetConfig(pCTX->hEnc, MFC_ENC_GETCONF_FRAME_TAG, &tag);
+
+    pCTX->out.dataSize    = encOutput.dataSize;
+    pCTX->out.frameType   = encOutput.frameType;
+    pCTX->out.StrmVirAddr = encOutput.StrmVirAddr;
+    pCTX->out.frameTag    = tag;
+    pCTX->out.bScaled     = bScale;
+    pCTX->out.decYPhyAddr = decOutput.YPhyAddr;
+    pCTX->out.decCPhyAddr = decOutput.CPhyAddr;
+    pCTX->out.encYPhyAddr = encOutput.encodedYPhyAddr;
+    pCTX->out.encCPhyAddr = encOutput.encodedCPhyAddr;
+
+    return MFC_RET_OK;
+}
+
+SSBSIP_MFC_ERROR_CODE SsbSipMfcTranscodeGetOutBuf(void *openHandle, SSBSIP_MFC_TRANSCODE_OUTPUT_INFO *output_info)
+{
+    _MFCTRANSCODE *pCTX = SsbSipMfcTranscodeGetContext(openHandle);
+
+    if ((pCTX == NULL) || (output_info == NULL)) {
+        LOGE("SsbSipMfcTranscodeGetOutBuf: openHandle is invalid\n");
+        return MFC_RET_INVALID_PARAM;
+    }
+
+    *output_info = pCTX->out;
+
+    return MFC_RET_OK;
+}
+
+SSBSIP_MFC_ERROR_CODE SsbSipMfcTranscodeClose(void *openHandle)
+{
+    _MFCTRANSCODE *pCTX = SsbSipMfcTranscodeGetContext(openHandle);
+
+    if (pCTX == NULL) {
+        LOGE("SsbSipMfcTranscodeClose: openHandle is invalid\n");
+        return MFC_RET_INVALID_PARAM;
+    }
+
+    if (pCTX->bFimcOpen)
+        mfc_fimc_close(&pCTX->fimc);
+    SsbSipMfcEncClose(pCTX->hEnc);
+    SsbSipMfcDecClose(pCTX->hDec);
+
+    pCTX->magic = 0;
+    free(pCTX);
+
+    return MFC_RET_OK;
+}
@@ -0,0 +1,345 @@
+/*
+ *
+ * Copyright 2011 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    mfc_fimc.c
+ * @brief   NV12T scaling between MFC buffers
+ *   The FIMC reads the source frame and writes the destination frame by
+ *   their physical addresses, one shot per frame. The destination takes
+ *   its chroma right after the 8KB aligned luma, which is where
+ *   SsbSipMfcEncGetInBuf puts it. The stand-in for the simulator scales
+ *   nearest neighbour through the tile maps of both frames.
+ * @version 1.0
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <utils/Log.h>
+
+#include "s5p_fimc.h"
+#include "mfc_interface.h"
+#include "mfc_fimc.h"
+
+#define MFC_FIMC_Y_SIZE(w, h)   ALIGN_TO_8KB(ALIGN_TO_128B(w) * ALIGN_TO_32B(h))
+#define MFC_FIMC_C_SIZE(w, h)   ALIGN_TO_8KB(ALIGN_TO_128B(w) * ALIGN_TO_32B((h) / 2))
+
+static int mfc_fimc_check(MFC_FIMC_FRAME *pSrc, MFC_FIMC_FRAME *pDst)
+{
+    if ((pSrc->width <= 0) || (pSrc->height <= 0) ||
+        (pSrc->left < 0) || (pSrc->top < 0) ||
+        (pSrc->left + pSrc->width > pSrc->bufWidth) ||
+        (pSrc->top + pSrc->height > pSrc->bufHeight) ||
+        ((pSrc->left | pSrc->top) & 1))
+        return -1;
+
+    /* FIMC writes NV12T in units of 8 pixels and 2 lines */
+    if ((pDst->width <= 0) || (pDst->height <= 0) ||
+        (pDst->width & 7) || (pDst->height & 1) ||
+        (pDst->left != 0) || (pDst->top != 0) ||
+        (pDst->bufWidth != pDst->width) || (pDst->bufHeight != pDst->height))
+        return -1;
+
+    if ((pSrc->width > pDst->width * MFC_FIMC_MAX_DOWNSCALE) ||
+        (pSrc->height > pDst->height * MFC_FIMC_MAX_DOWNSCALE))
+        return -1;
+
+    if (pDst->CPhyAddr != pDst->YPhyAddr + MFC_FIMC_Y_SIZE(pDst->bufWidth, pDst->bufHeight))
+        return -1;
+
+    return 0;
+}
+
+/*--------------------------------------------------------------------------------*/
+/* Device                                                                         */
+/*--------------------------------------------------------------------------------*/
+static int mfc_fimc_dev_open(MFC_FIMC *pFimc)
+{
+    struct v4l2_capability cap;
+    struct v4l2_control    vc;
+
+    pFimc->fd = open(MFC_FIMC_DEV_NAME, O_RDWR);
+    if (pFimc->fd < 0) {
+        LOGE("mfc_fimc_open: %s open failed\n", MFC_FIMC_DEV_NAME);
+        return -1;
+    }
+
+    if (ioctl(pFimc->fd, VIDIOC_QUERYCAP, &cap) < 0) {
+        LOGE("mfc_fimc_open: VIDIOC_QUERYCAP failed\n");
+        goto err;
+    }
+
+    if (!(cap.capabilities & V4L2_CAP_STREAMING) ||
+        !(cap.capabilities & V4L2_CAP_VIDEO_OUTPUT)) {
+        LOGE("mfc_fimc_open: %s is no streaming video output\n", MFC_FIMC_DEV_NAME);
+        goto err;
+    }
+
+    vc.id = V4L2_CID_FIMC_VERSION;
+    vc.value = 0;
+    if (ioctl(pFimc->fd, VIDIOC_G_CTRL, &vc) < 0) {
+        LOGE("mfc_fimc_open: VIDIOC_G_CTRL of the version failed\n");
+        goto err;
+    }
+    pFimc->hwVer = vc.value;
+
+    return 0;
+
+err:
+    close(pFimc->fd);
+    pFimc->fd = -1;
+    return -1;
+}
+
+static int mfc_fimc_dev_scale(MFC_FIMC *pFimc, MFC_FIMC_FRAME *pSrc, MFC_FIMC_FRAME *pDst)
+{
+    struct v4l2_format         fmt;
+    struct v4l2_crop           crop;
+    struct v4l2_requestbuffers req;
+    struct v4l2_control        vc;
+    struct v4l2_framebuffer    fbuf;
+    struct v4l2_buffer         buf;
+    struct fimc_buf            fimcBuf;
+    enum v4l2_buf_type         type = V4L2_BUF_TYPE_VIDEO_OUTPUT;
+    int                        bStreamOn = 0;
+    int                        ret = -1;
+
+    /* only the FIMC of version 0x50 crops at an offset */
+    if ((pFimc->hwVer != 0x50) && ((pSrc->left != 0) || (pSrc->top != 0))) {
+        LOGE("mfc_fimc_scale: FIMC 0x%x can not crop at %d,%d\n", pFimc->hwVer, pSrc->left, pSrc->top);
+        return -1;
+    }
+
+    /* source, DMA input */
+    memset(&fmt, 0, sizeof(fmt));
+    fmt.type = V4L2_BUF_TYPE_VIDEO_OUTPUT;
+    fmt.fmt.pix.width = pSrc->bufWidth;
+    fmt.fmt.pix.height = pSrc->bufHeight;
+    fmt.fmt.pix.pixelformat = V4L2_PIX_FMT_NV12T;
+    fmt.fmt.pix.field = V4L2_FIELD_NONE;
+    if (ioctl(pFimc->fd, VIDIOC_S_FMT, &fmt) < 0) {
+        LOGE("mfc_fimc_scale: VIDIOC_S_FMT of the source failed\n");
+        return -1;
+    }
+
+    memset(&crop, 0, sizeof(crop));
+    crop.type = V4L2_BUF_TYPE_VIDEO_OUTPUT;
+    crop.c.left = pSrc->left;
+    crop.c.top = pSrc->top;
+    crop.c.width = pSrc->width;
+    crop.c.height = pSrc->height;
+    if (ioctl(pFimc->fd, VIDIOC_S_CROP, &crop) < 0) {
+        LOGE("mfc_fimc_scale: VIDIOC_S_CROP failed\n");
+        return -1;
+    }
+
+    memset(&req, 0, sizeof(req));
+    req.count = 1;
+    req.type = V4L2_BUF_TYPE_VIDEO_OUTPUT;
+    req.memory = V4L2_MEMORY_USERPTR;
+    if (ioctl(pFimc->fd, VIDIOC_REQBUFS, &req) < 0) {
+        LOGE("mfc_fimc_scale: VIDIOC_REQBUFS failed\n");
+        return -1;
+    }
+
+    /* destination, DMA output */
+    vc.id = V4L2_CID_ROTATION;
+    vc.value = 0;
+    if (ioctl(pFimc->fd, VIDIOC_S_CTRL, &vc) < 0) {
+        LOGE("mfc_fimc_scale: VIDIOC_S_CTRL of the rotation failed\n");
+        goto EXIT;
+    }
+
+    if (ioctl(pFimc->fd, VIDIOC_G_FBUF, &fbuf) < 0) {
+        LOGE("mfc_fimc_scale: VIDIOC_G_FBUF failed\n");
+        goto EXIT;
+    }
+    fbuf.base = (void *)(unsigned long)pDst->YPhyAddr;
+    fbuf.fmt.width = pDst->bufWidth;
+    fbuf.fmt.height = pDst->bufHeight;
+    fbuf.fmt.pixelformat = V4L2_PIX_FMT_NV12T;
+    if (ioctl(pFimc->fd, VIDIOC_S_FBUF, &fbuf) < 0) {
+        LOGE("mfc_fimc_scale: VIDIOC_S_FBUF failed\n");
+        goto EXIT;
+    }
+
+    memset(&fmt, 0, sizeof(fmt));
+    fmt.type = V4L2_BUF_TYPE_VIDEO_OVERLAY;
+    fmt.fmt.win.w.left = 0;
+    fmt.fmt.win.w.top = 0;
+    fmt.fmt.win.w.width = pDst->width;
+    fmt.fmt.win.w.height = pDst->height;
+    if (ioctl(pFimc->fd, VIDIOC_S_FMT, &fmt) < 0) {
+        LOGE("mfc_fimc_scale: VIDIOC_S_FMT of the destination failed\n");
+        goto EXIT;
+    }
+
+    /* one shot */
+    if (ioctl(pFimc->fd, VIDIOC_STREAMON, &type) < 0) {
+        LOGE("mfc_fimc_scale: VIDIOC_STREAMON failed\n");
+        goto EXIT;
+    }
+    bStreamOn = 1;
+
+    memset(&fimcBuf, 0, sizeof(fimcBuf));
+    fimcBuf.base[0] = pSrc->YPhyAddr;
+    fimcBuf.base[1] = pSrc->CPhyAddr;
+    fimcBuf.length[0] = MFC_FIMC_Y_SIZE(pSrc->bufWidth, pSrc->bufHeight);
+    fimcBuf.length[1] = MFC_FIMC_C_SIZE(pSrc->bufWidth, pSrc->bufHeight);
+
+    memset(&buf, 0, sizeof(buf));
+    buf.type = V4L2_BUF_TYPE_VIDEO_OUTPUT;
+    buf.memory = V4L2_MEMORY_USERPTR;
+    buf.m.userptr = (unsigned long)&fimcBuf;
+    buf.length = 0;
+    buf.index = 0;
+    if (ioctl(pFimc->fd, VIDIOC_QBUF, &buf) < 0) {
+        LOGE("mfc_fimc_scale: VIDIOC_QBUF failed\n");
+        goto EXIT;
+    }
+
+    if (ioctl(pFimc->fd, VIDIOC_DQBUF, &buf) < 0) {
+        LOGE("mfc_fimc_scale: VIDIOC_DQBUF failed\n");
+        goto EXIT;
+    }
+
+    ret = 0;
+
+EXIT:
+    if (bStreamOn && (ioctl(pFimc->fd, VIDIOC_STREAMOFF, &type) < 0)) {
+        LOGE("mfc_fimc_scale: VIDIOC_STREAMOFF failed\n");
+        ret = -1;
+    }
+
+    req.count = 0;
+    req.type = V4L2_BUF_TYPE_VIDEO_OUTPUT;
+    req.memory = V4L2_MEMORY_USERPTR;
+    ioctl(pFimc->fd, VIDIOC_REQBUFS, &req);
+
+    return ret;
+}
+
+#ifdef USE_MFC_SIM
+/*--------------------------------------------------------------------------------*/
+/* Simulator stand-in                                                             */
+/*--------------------------------------------------------------------------------*/
+static inline unsigned int mfc_fimc_tile_pos(CSC_TILE_MAP *map, int x, int y)
+{
+    return map->tile_offset[((y >> 5) * map->x_tile_num) + (x >> 6)] + ((y & 31) << 6) + (x & 63);
+}
+
+static int mfc_fimc_sim_scale(MFC_FIMC *pFimc, MFC_FIMC_FRAME *pSrc, MFC_FIMC_FRAME *pDst)
+{
+    unsigned char *srcY, *srcC, *dstY, *dstC;
+    int x, y, sx, sy;
+
+    srcY = mfc_sim_map_phys(pSrc->YPhyAddr, MFC_FIMC_Y_SIZE(pSrc->bufWidth, pSrc->bufHeight));
+    srcC = mfc_sim_map_phys(pSrc->CPhyAddr, MFC_FIMC_C_SIZE(pSrc->bufWidth, pSrc->bufHeight));
+    dstY = mfc_sim_map_phys(pDst->YPhyAddr, MFC_FIMC_Y_SIZE(pDst->bufWidth, pDst->bufHeight));
+    dstC = mfc_sim_map_phys(pDst->CPhyAddr, MFC_FIMC_C_SIZE(pDst->bufWidth, pDst->bufHeight));
+    if ((srcY == NULL) || (srcC == NULL) || (dstY == NULL) || (dstC == NULL)) {
+        LOGE("mfc_fimc_scale: frame is not in MFC memory\n");
+        return -1;
+    }
+
+    if ((csc_tile_map_update(&pFimc->srcMap[0], pSrc->bufWidth, pSrc->bufHeight) != 0) ||
+        (csc_tile_map_update(&pFimc->srcMap[1], pSrc->bufWidth, pSrc->bufHeight / 2) != 0) ||
+        (csc_tile_map_update(&pFimc->dstMap[0], pDst->bufWidth, pDst->bufHeight) != 0) ||
+        (csc_tile_map_update(&pFimc->dstMap[1], pDst->bufWidth, pDst->bufHeight / 2) != 0))
+        return -1;
+
+    for (y = 0; y < pDst->height; y++) {
+        sy = pSrc->top + ((y * pSrc->height) / pDst->height);
+        for (x = 0; x < pDst->width; x++) {
+            sx = pSrc->left + ((x * pSrc->width) / pDst->width);
+            dstY[mfc_fimc_tile_pos(&pFimc->dstMap[0], x, y)] =
+                srcY[mfc_fimc_tile_pos(&pFimc->srcMap[0], sx, sy)];
+        }
+    }
+
+    /* CbCr pairs */
+    for (y = 0; y < pDst->height / 2; y++) {
+        sy = (pSrc->top / 2) + ((y * (pSrc->height / 2)) / (pDst->height / 2));
+        for (x = 0; x < pDst->width / 2; x++) {
+            sx = (pSrc->left / 2) + ((x * (pSrc->width / 2)) / (pDst->width / 2));
+            dstC[mfc_fimc_tile_pos(&pFimc->dstMap[1], x * 2, y)] =
+                srcC[mfc_fimc_tile_pos(&pFimc->srcMap[1], sx * 2, sy)];
+            dstC[mfc_fimc_tile_pos(&pFimc->dstMap[1], (x * 2) + 1, y)] =
+                srcC[mfc_fimc_tile_pos(&pFimc->srcMap[1], (sx * 2) + 1, sy)];
+        }
+    }
+
+    return 0;
+}
+#endif
+
+/*--------------------------------------------------------------------------------*/
+/* Interface                                                                      */
+/*--------------------------------------------------------------------------------*/
+/*
+ * Opens the FIMC for backend, the stand-in for MFC_BACKEND_SIM.
+ * Returns 0 on success, -1 on failure
+ */
+int mfc_fimc_open(MFC_FIMC *pFimc, MFC_BACKEND backend)
+{
+    memset(pFimc, 0, sizeof(MFC_FIMC));
+    pFimc->backend = backend;
+    pFimc->fd = -1;
+
+#ifdef USE_MFC_SIM
+    if (backend == MFC_BACKEND_SIM)
+        return 0;
+#endif
+
+    return mfc_fimc_dev_open(pFimc);
+}
+
+/*
+ * Scales area of pSrc to whole pDst, both NV12T in physical memory.
+ * Destination width must be a multiple of 8, height of 2.
+ * Returns 0 on success, -1 on failure
+ */
+int mfc_fimc_scale(MFC_FIMC *pFimc, MFC_FIMC_FRAME *pSrc, MFC_FIMC_FRAME *pDst)
+{
+    if (mfc_fimc_check(pSrc, pDst) != 0) {
+        LOGE("mfc_fimc_scale: can not scale %dx%d at %d,%d of %dx%d to %dx%d\n",
+             pSrc->width, pSrc->height, pSrc->left, pSrc->top, pSrc->bufWidth, pSrc->bufHeight,
+             pDst->width, pDst->height);
+        return -1;
+    }
+
+#ifdef USE_MFC_SIM
+    if (pFimc->backend == MFC_BACKEND_SIM)
+        return mfc_fimc_sim_scale(pFimc, pSrc, pDst);
+#endif
+
+    return mfc_fimc_dev_scale(pFimc, pSrc, pDst);
+}
+
+void mfc_fimc_close(MFC_FIMC *pFimc)
+{
+    if (pFimc->fd >= 0)
+        close(pFimc->fd);
+    pFimc->fd = -1;
+
+    csc_tile_map_release(&pFimc->srcMap[0]);
+    csc_tile_map_release(&pFimc->srcMap[1]);
+    csc_tile_map_release(&pFimc->dstMap[0]);
+    csc_tile_map_release(&pFimc->dstMap[1]);
+}
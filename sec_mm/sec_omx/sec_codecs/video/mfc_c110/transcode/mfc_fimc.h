@@ -0,0 +1,63 @@
+/*
+ *
+ * Copyright 2011 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    mfc_fimc.h
+ * @brief   NV12T scaling between MFC buffers
+ *   Memory to memory through the V4L2 output device of a FIMC, as the
+ *   hwcomposer and tvout libraries use it. With the MFC simulator a
+ *   software stand-in scales in the memory of the simulator instead.
+ * @version 1.0
+ */
+
+#ifndef MFC_FIMC_H_
+#define MFC_FIMC_H_
+
+#include "mfc_backend.h"
+#include "color_space_convertor.h"
+
+/* FIMC2, the hwcomposer keeps FIMC1 */
+#define MFC_FIMC_DEV_NAME       "/dev/video2"
+#define MFC_FIMC_MAX_DOWNSCALE  64
+
+/* NV12T frame, chroma follows luma as in SsbSipMfcEncGetInBuf */
+typedef struct _MFC_FIMC_FRAME
+{
+    unsigned int YPhyAddr;
+    unsigned int CPhyAddr;
+    int          bufWidth;  /* of the frame buffer */
+    int          bufHeight;
+    int          left;      /* area read from the source, whole frame on destination */
+    int          top;
+    int          width;
+    int          height;
+} MFC_FIMC_FRAME;
+
+typedef struct _MFC_FIMC
+{
+    MFC_BACKEND  backend;
+    int          fd;
+    unsigned int hwVer;
+    CSC_TILE_MAP srcMap[2]; /* luma and chroma, stand-in only */
+    CSC_TILE_MAP dstMap[2];
+} MFC_FIMC;
+
+int  mfc_fimc_open(MFC_FIMC *pFimc, MFC_BACKEND backend);
+int  mfc_fimc_scale(MFC_FIMC *pFimc, MFC_FIMC_FRAME *pSrc, MFC_FIMC_FRAME *pDst);
+void mfc_fimc_close(MFC_FIMC *pFimc);
+
+#endif /*MFC_FIMC_H_*/
@@ -0,0 +1,535 @@
+/*
+ *
+ * Copyright 2011 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    mfc_transcode_test.c
+ * @brief   Test of SsbSipMfcTranscode on the MFC simulator
+ *   Every case encodes a source stream with the simulator, transcodes it
+ *   and decodes the result again. Checked are the frame tags and count,
+ *   the encoded size, that unscaled frames reach the encoder at the
+ *   physical address the decoder wrote them to if it is 64KB aligned, and
+ *   that frames through FIMC hold the nearest source pixel, read through
+ *   an own NV12T reference. The simulated encoder fails frames out of
+ *   alignment. Frame buffers of the simulated decoder are all 64KB aligned
+ *   for 512x256, only the first for the other sizes.
+ *   Exit status is non-zero if any case failed.
+ *
+ *   Builds as mfc_transcode_test_host with the Android build system.
+ * @version 1.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SsbSipMfcApi.h"
+#include "SsbSipMfcTranscode.h"
+#include "mfc_backend.h"
+
+#define MFC_TRANSCODE_TEST_FRAMES       12
+#define MFC_TRANSCODE_TEST_STREAM_SIZE  (4 * 1024 * 1024)
+#define MFC_TRANSCODE_TEST_TAG_BASE     1000
+
+#define ALIGN(x, a) (((x) + (a) - 1) & ~((a) - 1))
+
+typedef struct _MFC_TRANSCODE_TEST_CASE
+{
+    SSBSIP_MFC_CODEC_TYPE srcCodecType;     /* encoder of the source stream */
+    SSBSIP_MFC_CODEC_TYPE decCodecType;
+    int                   srcWidth;
+    int                   srcHeight;
+    SSBSIP_MFC_CODEC_TYPE encCodecType;
+    int                   width;            /* 0 keeps the decoded size */
+    int                   height;
+    int                   bScaled;          /* expected, else frames out of 64KB alignment only */
+} MFC_TRANSCODE_TEST_CASE;
+
+static const MFC_TRANSCODE_TEST_CASE mfc_transcode_test_cases[] = {
+    { H264_ENC,  H264_DEC,  512, 256, H264_ENC,    0,   0, 0 },
+    { H264_ENC,  H264_DEC,  320, 180, H264_ENC,    0,   0, 0 },
+    { H264_ENC,  H264_DEC,  320, 180, H264_ENC,  320, 180, 0 },
+    { MPEG4_ENC, MPEG4_DEC, 352, 288, H263_ENC,    0,   0, 0 },
+    { H264_ENC,  H264_DEC,  320, 180, MPEG4_ENC, 176, 144, 1 },
+    { MPEG4_ENC, MPEG4_DEC, 640, 480, H264_ENC,  320, 240, 1 },
+    { H263_ENC,  H263_DEC,  176, 144, H264_ENC,  352, 288, 1 },
+    { H264_ENC,  H264_DEC,  176, 144, H264_ENC,  192, 144, 1 },
+};
+
+/* elementary stream and where its frames are */
+typedef struct _MFC_TRANSCODE_TEST_STREAM
+{
+    unsigned char *data;
+    int            size;
+    int            headerSize;
+    int            frameOffset[MFC_TRANSCODE_TEST_FRAMES];
+    int            frameSize[MFC_TRANSCODE_TEST_FRAMES];
+    int            frameNum;
+} MFC_TRANSCODE_TEST_STREAM;
+
+static const char *mfc_transcode_test_codec_name(SSBSIP_MFC_CODEC_TYPE codecType)
+{
+    switch (codecType) {
+    case H264_DEC:
+    case H264_ENC:
+        return "h264";
+    case MPEG4_DEC:
+    case MPEG4_ENC:
+        return "mpeg4";
+    case H263_DEC:
+    case H263_ENC:
+        return "h263";
+    default:
+        return "unknown";
+    }
+}
+
+static SSBSIP_MFC_CODEC_TYPE mfc_transcode_test_dec_type(SSBSIP_MFC_CODEC_TYPE encCodecType)
+{
+    if (encCodecType == MPEG4_ENC)
+        return MPEG4_DEC;
+    if (encCodecType == H263_ENC)
+        return H263_DEC;
+    return H264_DEC;
+}
+
+/*
+ * Offset of pixel (x, y) in a NV12T plane of width x height, written out
+ * on its own so the tile map of csc is not checked against itself
+ */
+static unsigned int ref_tiled_offset(int x, int y, int width, int height)
+{
+    int x_block_num = ALIGN(width, 128) / 64;
+    int y_block_num = ALIGN(height, 32) / 32;
+    int tx = x / 64;
+    int ty = y / 32;
+    int tile;
+
+    if (ty & 1)
+        tile = x_block_num * (ty - 1) + 2 + tx + (tx / 4) * 4;
+    else if (ty < y_block_num - 1)
+        tile = x_block_num * ty + tx + ((tx + 2) / 4) * 4;
+    else
+        tile = x_block_num * ty + tx;
+
+    return tile * 2048 + (y % 32) * 64 + (x % 64);
+}
+
+static int mfc_transcode_test_append(MFC_TRANSCODE_TEST_STREAM *pStream, void *data, int size, int bFrame)
+{
+    if ((pStream->size + size > MFC_TRANSCODE_TEST_STREAM_SIZE) ||
+        (bFrame && (pStream->frameNum >= MFC_TRANSCODE_TEST_FRAMES)))
+        return -1;
+
+    if (bFrame) {
+        pStream->frameOffset[pStream->frameNum] = pStream->size;
+        pStream->frameSize[pStream->frameNum] = size;
+        pStream->frameNum++;
+    } else {
+        pStream->headerSize += size;
+    }
+    memcpy(pStream->data + pStream->size, data, size);
+    pStream->size += size;
+
+    return 0;
+}
+
+/*
+ * Source stream from the encoder of the simulator, which does not read
+ * its input, so the frames decode to the fill pattern of the simulator
+ */
+static int mfc_transcode_test_source(MFC_TRANSCODE_TEST_STREAM *pStream, SSBSIP_MFC_CODEC_TYPE codecType,
+                                     int width, int height)
+{
+    SSBSIP_MFC_ENC_H264_PARAM  h264Param;
+    SSBSIP_MFC_ENC_MPEG4_PARAM mpeg4Param;
+    SSBSIP_MFC_ENC_H263_PARAM  h263Param;
+    SSBSIP_MFC_ENC_INPUT_INFO  input;
+    SSBSIP_MFC_ENC_OUTPUT_INFO output;
+    unsigned int bufType = CACHE;
+    void *pParam;
+    void *hEnc;
+    int ret = -1;
+    int i;
+
+    memset(&h264Param, 0, sizeof(h264Param));
+    memset(&mpeg4Param, 0, sizeof(mpeg4Param));
+    memset(&h263Param, 0, sizeof(h263Param));
+    if (codecType == H264_ENC) {
+        h264Param.codecType = H264_ENC;
+        h264Param.SourceWidth = width;
+        h264Param.SourceHeight = height;
+        h264Param.IDRPeriod = 5;
+        h264Param.FrameQp = 20;
+        h264Param.FrameQp_P = 20;
+        h264Param.QSCodeMax = 51;
+        h264Param.QSCodeMin = 10;
+        h264Param.FrameRate = 30;
+        h264Param.ProfileIDC = 2;
+        h264Param.LevelIDC = 40;
+        h264Param.NumberReferenceFrames = 1;
+        h264Param.NumberRefForPframes = 1;
+        pParam = &h264Param;
+    } else if (codecType == MPEG4_ENC) {
+        mpeg4Param.codecType = MPEG4_ENC;
+        mpeg4Param.SourceWidth = width;
+        mpeg4Param.SourceHeight = height;
+        mpeg4Param.IDRPeriod = 5;
+        mpeg4Param.FrameQp = 10;
+        mpeg4Param.FrameQp_P = 10;
+        mpeg4Param.QSCodeMax = 31;
+        mpeg4Param.QSCodeMin = 1;
+        mpeg4Param.LevelIDC = 4;
+        mpeg4Param.TimeIncreamentRes = 30;
+        mpeg4Param.VopTimeIncreament = 1;
+        pParam = &mpeg4Param;
+    } else {
+        h263Param.codecType = H263_ENC;
+        h263Param.SourceWidth = width;
+        h263Param.SourceHeight = height;
+        h263Param.IDRPeriod = 5;
+        h263Param.FrameQp = 10;
+        h263Param.FrameQp_P = 10;
+        h263Param.QSCodeMax = 31;
+        h263Param.QSCodeMin = 1;
+        h263Param.FrameRate = 30;
+        pParam = &h263Param;
+    }
+
+    hEnc = SsbSipMfcEncOpen(&bufType);
+    if (hEnc == NULL)
+        return -1;
+
+    if ((SsbSipMfcEncInit(hEnc, pParam) != MFC_RET_OK) ||
+        (SsbSipMfcEncGetInBuf(hEnc, &input) != MFC_RET_OK) ||
+        (SsbSipMfcEncGetOutBuf(hEnc, &output) != MFC_RET_OK) ||
+        (mfc_transcode_test_append(pStream, output.StrmVirAddr, output.headerSize, 0) != 0))
+        goto EXIT;
+
+    for (i = 0; i < MFC_TRANSCODE_TEST_FRAMES; i++) {
+        if ((SsbSipMfcEncExe(hEnc) != MFC_RET_OK) ||
+            (SsbSipMfcEncGetOutBuf(hEnc, &output) != MFC_RET_OK) ||
+            (mfc_transcode_test_append(pStream, output.StrmVirAddr, output.dataSize, 1) != 0))
+            goto EXIT;
+    }
+    ret = 0;
+
+EXIT:
+    SsbSipMfcEncClose(hEnc);
+    return ret;
+}
+
+/*
+ * Every 7th luma pixel and every 5th CbCr pair of the scaled frame
+ * against the nearest pixel of the visible area of the decoded one
+ */
+static int mfc_transcode_test_check_scaled(SSBSIP_MFC_TRANSCODE_OUTPUT_INFO *pOut,
+                                           int decWidth, int decHeight, int visWidth, int visHeight)
+{
+    unsigned char *srcY, *srcC, *dstY, *dstC;
+    int x, y, sx, sy;
+
+    srcY = mfc_sim_map_phys((unsigned int)(unsigned long)pOut->decYPhyAddr, ALIGN(decWidth, 128) * ALIGN(decHeight, 32));
+    srcC = mfc_sim_map_phys((unsigned int)(unsigned long)pOut->decCPhyAddr, ALIGN(decWidth, 128) * ALIGN(decHeight / 2, 32));
+    dstY = mfc_sim_map_phys((unsigned int)(unsigned long)pOut->encYPhyAddr, ALIGN(pOut->width, 128) * ALIGN(pOut->height, 32));
+    dstC = mfc_sim_map_phys((unsigned int)(unsigned long)pOut->encCPhyAddr, ALIGN(pOut->width, 128) * ALIGN(pOut->height / 2, 32));
+    if ((srcY == NULL) || (srcC == NULL) || (dstY == NULL) || (dstC == NULL)) {
+        printf("  frame is not in MFC memory\n");
+        return -1;
+    }
+
+    for (y = 0; y < pOut->height; y += 7) {
+        sy = (y * visHeight) / pOut->height;
+        for (x = 0; x < pOut->width; x += 7) {
+            sx = (x * visWidth) / pOut->width;
+            if (dstY[ref_tiled_offset(x, y, pOut->width, pOut->height)] !=
+                srcY[ref_tiled_offset(sx, sy, decWidth, decHeight)]) {
+                printf("  luma %d,%d is 0x%02x, nearest source pixel %d,%d is 0x%02x\n", x, y,
+                       dstY[ref_tiled_offset(x, y, pOut->width, pOut->height)], sx, sy,
+                       srcY[ref_tiled_offset(sx, sy, decWidth, decHeight)]);
+                return -1;
+            }
+        }
+    }
+
+    for (y = 0; y < pOut->height / 2; y += 5) {
+        sy = (y * (visHeight / 2)) / (pOut->height / 2);
+        for (x = 0; x < pOut->width / 2; x += 5) {
+            sx = (x * (visWidth / 2)) / (pOut->width / 2);
+            if ((dstC[ref_tiled_offset(x * 2, y, pOut->width, pOut->height / 2)] !=
+                 srcC[ref_tiled_offset(sx * 2, sy, decWidth, decHeight / 2)]) ||
+                (dstC[ref_tiled_offset((x * 2) + 1, y, pOut->width, pOut->height / 2)] !=
+                 srcC[ref_tiled_offset((sx * 2) + 1, sy, decWidth, decHeight / 2)])) {
+                printf("  chroma %d,%d differs from nearest source pair %d,%d\n", x, y, sx, sy);
+                return -1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int mfc_transcode_test_transcode(const MFC_TRANSCODE_TEST_CASE *pCase, MFC_TRANSCODE_TEST_STREAM *pSrc,
+                                        MFC_TRANSCODE_TEST_STREAM *pDst)
+{
+    SSBSIP_MFC_TRANSCODE_PARAM       param;
+    SSBSIP_MFC_TRANSCODE_OUTPUT_INFO out;
+    SSBSIP_MFC_DEC_OUTPUT_INFO       decInfo;
+    unsigned char *pInBuf;
+    void *phyInBuf;
+    void *hTranscode;
+    void *hDec;
+    unsigned int bufType = NO_CACHE;
+    int initSize, decWidth, decHeight, visWidth, visHeight;
+    int nextTag = MFC_TRANSCODE_TEST_TAG_BASE;
+    int bScaled;
+    int copyNum = 0;
+    int ret = -1;
+    int i;
+
+    /* decoded size the transcoder sees, from a decoder of its own */
+    initSize = pSrc->headerSize + ((pCase->decCodecType == H264_DEC) ? 0 : pSrc->frameSize[0]);
+    hDec = SsbSipMfcDecOpen(&bufType);
+    if (hDec == NULL)
+        return -1;
+    pInBuf = SsbSipMfcDecGetInBuf(hDec, &phyInBuf, MAX_DECODER_INPUT_BUFFER_SIZE);
+    memcpy(pInBuf, pSrc->data, pSrc->headerSize + pSrc->frameSize[0]);
+    if (SsbSipMfcDecInit(hDec, pCase->decCodecType, initSize) != MFC_RET_OK) {
+        SsbSipMfcDecClose(hDec);
+        return -1;
+    }
+    SsbSipMfcDecGetOutBuf(hDec, &decInfo);
+    SsbSipMfcDecClose(hDec);
+    decWidth = decInfo.img_width;
+    decHeight = decInfo.img_height;
+    visWidth = decWidth - decInfo.crop_left_offset - decInfo.crop_right_offset;
+    visHeight = decHeight - decInfo.crop_top_offset - decInfo.crop_bottom_offset;
+
+    hTranscode = SsbSipMfcTranscodeOpen();
+    if (hTranscode == NULL) {
+        printf("  SsbSipMfcTranscodeOpen failed\n");
+        return -1;
+    }
+
+    pInBuf = SsbSipMfcTranscodeGetInBuf(hTranscode, &phyInBuf, MAX_DECODER_INPUT_BUFFER_SIZE);
+    if (pInBuf == NULL)
+        goto EXIT;
+
+    memset(&param, 0, sizeof(param));
+    param.decCodecType = pCase->decCodecType;
+    param.encCodecType = pCase->encCodecType;
+    param.width = pCase->width;
+    param.height = pCase->height;
+    param.IDRPeriod = 10;
+    param.Bitrate = 512000;
+    param.FrameRate = 30;
+    param.FrameQp = 20;
+
+    memcpy(pInBuf, pSrc->data, pSrc->headerSize + pSrc->frameSize[0]);
+    if (SsbSipMfcTranscodeInit(hTranscode, &param, initSize) != MFC_RET_OK) {
+        printf("  SsbSipMfcTranscodeInit failed\n");
+        goto EXIT;
+    }
+    /* H.263 has no header */
+    SsbSipMfcTranscodeGetOutBuf(hTranscode, &out);
+    if (mfc_transcode_test_append(pDst, out.StrmVirAddr, out.headerSize, 0) != 0)
+        goto EXIT;
+
+    /* the frames, then one call per frame left in the decoder */
+    for (i = 0; i < MFC_TRANSCODE_TEST_FRAMES * 2; i++) {
+        int size = 0;
+
+        if (i < pSrc->frameNum) {
+            size = pSrc->frameSize[i];
+            memcpy(pInBuf, pSrc->data + pSrc->frameOffset[i], size);
+        }
+        if (SsbSipMfcTranscodeExe(hTranscode, size, MFC_TRANSCODE_TEST_TAG_BASE + i) != MFC_RET_OK) {
+            printf("  SsbSipMfcTranscodeExe of frame %d failed\n", i);
+            goto EXIT;
+        }
+        SsbSipMfcTranscodeGetOutBuf(hTranscode, &out);
+        if (out.status == MFC_GETOUTBUF_DISPLAY_END)
+            break;
+        if ((out.status != MFC_GETOUTBUF_DISPLAY_DECODING) && (out.status != MFC_GETOUTBUF_DISPLAY_ONLY))
+            continue;
+
+        if (out.frameTag != nextTag) {
+            printf("  frame tag %d, expected %d\n", out.frameTag, nextTag);
+            goto EXIT;
+        }
+        nextTag++;
+
+        bScaled = pCase->bScaled ||
+                  ((((unsigned int)(unsigned long)out.decYPhyAddr | (unsigned int)(unsigned long)out.decCPhyAddr) & 0xFFFF) != 0);
+        if (out.bScaled != bScaled) {
+            printf("  frame %d %s scaled\n", out.frameTag, out.bScaled ? "was" : "was not");
+            goto EXIT;
+        }
+
+        if (out.bScaled == 0) {
+            if ((out.encYPhyAddr != out.decYPhyAddr) || (out.encCPhyAddr != out.decCPhyAddr)) {
+                printf("  encoder read %p/%p, decoder wrote %p/%p\n",
+                       out.encYPhyAddr, out.encCPhyAddr, out.decYPhyAddr, out.decCPhyAddr);
+                goto EXIT;
+            }
+        } else {
+            if (out.encYPhyAddr == out.decYPhyAddr) {
+                printf("  scaled frame %d was read from the decoder\n", out.frameTag);
+                goto EXIT;
+            }
+            if (mfc_transcode_test_check_scaled(&out, decWidth, decHeight, visWidth, visHeight) != 0)
+                goto EXIT;
+            if (pCase->bScaled == 0)
+                copyNum++;
+        }
+
+        if ((out.dataSize == 0) ||
+            (mfc_transcode_test_append(pDst, out.StrmVirAddr, out.dataSize, 1) != 0)) {
+            printf("  frame %d: no encoded data\n", out.frameTag);
+            goto EXIT;
+        }
+    }
+
+    if (nextTag != MFC_TRANSCODE_TEST_TAG_BASE + pSrc->frameNum) {
+        printf("  %d frames transcoded of %d\n", nextTag - MFC_TRANSCODE_TEST_TAG_BASE, pSrc->frameNum);
+        goto EXIT;
+    }
+    if (copyNum > 0)
+        printf("  %d of %d frames out of alignment, copied by FIMC\n", copyNum, pSrc->frameNum);
+    ret = 0;
+
+EXIT:
+    SsbSipMfcTranscodeClose(hTranscode);
+    return ret;
+}
+
+/*
+ * Decodes the transcoded stream, returns number of frames or -1
+ */
+static int mfc_transcode_test_verify(SSBSIP_MFC_CODEC_TYPE decCodecType, MFC_TRANSCODE_TEST_STREAM *pStream,
+                                     int width, int height)
+{
+    SSBSIP_MFC_DEC_OUTPUT_INFO   decInfo;
+    SSBSIP_MFC_DEC_OUTBUF_STATUS status;
+    unsigned int bufType = NO_CACHE;
+    unsigned char *pInBuf;
+    void *phyInBuf;
+    void *hDec;
+    int initSize;
+    int frameNum = 0;
+    int last = 1;
+    int i;
+
+    hDec = SsbSipMfcDecOpen(&bufType);
+    if (hDec == NULL)
+        return -1;
+
+    pInBuf = SsbSipMfcDecGetInBuf(hDec, &phyInBuf, MAX_DECODER_INPUT_BUFFER_SIZE);
+    initSize = pStream->headerSize + ((decCodecType == H264_DEC) ? 0 : pStream->frameSize[0]);
+    memcpy(pInBuf, pStream->data, pStream->headerSize + pStream->frameSize[0]);
+    if (SsbSipMfcDecInit(hDec, decCodecType, initSize) != MFC_RET_OK)
+        goto EXIT;
+
+    SsbSipMfcDecGetOutBuf(hDec, &decInfo);
+    if ((decInfo.img_width - decInfo.crop_left_offset - decInfo.crop_right_offset != width) ||
+        (decInfo.img_height - decInfo.crop_top_offset - decInfo.crop_bottom_offset != height)) {
+        printf("  transcoded stream is %dx%d, expected %dx%d\n",
+               decInfo.img_width - decInfo.crop_left_offset - decInfo.crop_right_offset,
+               decInfo.img_height - decInfo.crop_top_offset - decInfo.crop_bottom_offset, width, height);
+        frameNum = -1;
+        goto EXIT;
+    }
+
+    for (i = 0; i < MFC_TRANSCODE_TEST_FRAMES * 2; i++) {
+        int size = 0;
+
+        if (i < pStream->frameNum) {
+            size = pStream->frameSize[i];
+            memcpy(pInBuf, pStream->data + pStream->frameOffset[i], size);
+        } else if (i == pStream->frameNum) {
+            SsbSipMfcDecSetConfig(hDec, MFC_DEC_SETCONF_IS_LAST_FRAME, &last);
+        }
+        if (SsbSipMfcDecExe(hDec, size) != MFC_RET_OK) {
+            frameNum = -1;
+            goto EXIT;
+        }
+        status = SsbSipMfcDecGetOutBuf(hDec, &decInfo);
+        if (status == MFC_GETOUTBUF_DISPLAY_END)
+            break;
+        if ((status == MFC_GETOUTBUF_DISPLAY_DECODING) || (status == MFC_GETOUTBUF_DISPLAY_ONLY))
+            frameNum++;
+    }
+
+EXIT:
+    SsbSipMfcDecClose(hDec);
+    return frameNum;
+}
+
+int main(int argc, char **argv)
+{
+    MFC_TRANSCODE_TEST_STREAM src, dst;
+    int caseNum = sizeof(mfc_transcode_test_cases) / sizeof(mfc_transcode_test_cases[0]);
+    int failNum = 0;
+    int c;
+
+    if (mfc_backend_init(MFC_BACKEND_SIM) != 0) {
+        printf("mfc_transcode_test: no MFC simulator\n");
+        return 2;
+    }
+    /* run time is of no interest here */
+    setenv("SEC_MFC_SIM_SPEED", "0", 1);
+
+    src.data = (unsigned char *)malloc(MFC_TRANSCODE_TEST_STREAM_SIZE);
+    dst.data = (unsigned char *)malloc(MFC_TRANSCODE_TEST_STREAM_SIZE);
+    if ((src.data == NULL) || (dst.data == NULL))
+        return 2;
+
+    for (c = 0; c < caseNum; c++) {
+        const MFC_TRANSCODE_TEST_CASE *pCase = &mfc_transcode_test_cases[c];
+        int width = pCase->width ? pCase->width : pCase->srcWidth;
+        int height = pCase->height ? pCase->height : pCase->srcHeight;
+        int frameNum;
+        int bFail = 1;
+
+        printf("%-5s %4dx%-4d -> %-5s %4dx%-4d %s\n",
+               mfc_transcode_test_codec_name(pCase->decCodecType), pCase->srcWidth, pCase->srcHeight,
+               mfc_transcode_test_codec_name(pCase->encCodecType), width, height,
+               pCase->bScaled ? "fimc" : "zero copy");
+
+        src.size = src.headerSize = src.frameNum = 0;
+        dst.size = dst.headerSize = dst.frameNum = 0;
+
+        if (mfc_transcode_test_source(&src, pCase->srcCodecType, pCase->srcWidth, pCase->srcHeight) != 0) {
+            printf("  source stream failed\n");
+        } else if (mfc_transcode_test_transcode(pCase, &src, &dst) == 0) {
+            frameNum = mfc_transcode_test_verify(mfc_transcode_test_dec_type(pCase->encCodecType),
+                                                 &dst, width, height);
+            if (frameNum == src.frameNum)
+                bFail = 0;
+            else
+                printf("  %d frames decoded of %d\n", frameNum, src.frameNum);
+        }
+
+        printf("  %s\n", bFail ? "FAIL" : "ok");
+        failNum += bFail;
+    }
+
+    free(src.data);
+    free(dst.data);
+
+    printf("mfc_transcode_test: %d of %d cases failed\n", failNum, caseNum);
+    return (failNum == 0) ? 0 : 1;
+}
@@ -6,7 +6,8 @@ LOCAL_MODULE_TAGS := optional
 LOCAL_SRC_FILES := \
 	SEC_OMX_Basecomponent.c \
 	SEC_OMX_Baseport.c \
-	SEC_OMX_Resourcemanager.c
+	SEC_OMX_FrameTag.c \
+	SEC_OMX_Stats.c
 
 
 LOCAL_MODULE := libsecbasecomponent.aries
@@ -22,3 +23,74 @@ LOCAL_C_INCLUDES := $(SEC_OMX_INC)/khronos \
 
 include $(BUILD_STATIC_LIBRARY)
 
+
+
+#########################################################################
+# Resource manager, one instance shared by all component libraries
+#########################################################################
+
+include $(CLEAR_VARS)
+
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_SRC_FILES := SEC_OMX_Resourcemanager.c
+
+LOCAL_MODULE := libSEC_OMX_Resourcemanager.aries
+
+LOCAL_CFLAGS :=
+
+LOCAL_ARM_MODE := arm
+
+LOCAL_STATIC_LIBRARIES := libsecosal.aries
+LOCAL_SHARED_LIBRARIES := libc libcutils libutils
+
+LOCAL_C_INCLUDES := $(SEC_OMX_INC)/khronos \
+	$(SEC_OMX_INC)/sec \
+	$(SEC_OMX_TOP)/sec_osal
+
+include $(BUILD_SHARED_LIBRARY)
+
+
+#########################################################################
+# Build base component and resource manager for host
+#########################################################################
+
+include $(CLEAR_VARS)
+
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_SRC_FILES := \
+	SEC_OMX_Basecomponent.c \
+	SEC_OMX_Baseport.c \
+	SEC_OMX_FrameTag.c \
+	SEC_OMX_Stats.c
+
+LOCAL_MODULE := libsecbasecomponent_host
+
+LOCAL_CFLAGS := -DUSE_MFC_SIM
+
+LOCAL_C_INCLUDES := $(SEC_OMX_INC)/khronos \
+	$(SEC_OMX_INC)/sec \
+	$(SEC_OMX_TOP)/sec_osal
+
+include $(BUILD_HOST_STATIC_LIBRARY)
+
+include $(CLEAR_VARS)
+
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_SRC_FILES := SEC_OMX_Resourcemanager.c
+
+LOCAL_MODULE := libSEC_OMX_Resourcemanager_host
+
+LOCAL_CFLAGS := -DUSE_MFC_SIM
+
+LOCAL_STATIC_LIBRARIES := libsecosal_host libcutils liblog
+
+LOCAL_LDLIBS := -lpthread -lrt
+
+LOCAL_C_INCLUDES := $(SEC_OMX_INC)/khronos \
+	$(SEC_OMX_INC)/sec \
+	$(SEC_OMX_TOP)/sec_osal
+
+include $(BUILD_HOST_SHARED_LIBRARY)
@@ -31,9 +31,11 @@
 
 #include "SEC_OSAL_Event.h"
 #include "SEC_OSAL_Thread.h"
+#include "SEC_OSAL_ETC.h"
 #include "SEC_OMX_Baseport.h"
 #include "SEC_OMX_Basecomponent.h"
 #include "SEC_OMX_Macros.h"
+#include "SEC_OMX_Resourcemanager.h"
 
 #undef  SEC_LOG_TAG
 #define SEC_LOG_TAG    "SEC_BASE_COMP"
@@ -158,6 +160,16 @@ EXIT:
     return ret;
 }
 
+/*
+ * The buffer process state turned runnable. The output thread of a video
+ * decoder waits on its own event, pauseEvent belongs to the buffer process thread.
+ */
+void SEC_OMX_OutputPauseEventSet(SEC_OMX_BASECOMPONENT *pSECComponent)
+{
+    if (pSECComponent->outputPauseEvent != NULL)
+        SEC_OSAL_SignalSet(pSECComponent->outputPauseEvent);
+}
+
 static OMX_ERRORTYPE SEC_OMX_BufferProcessThread(OMX_PTR threadData)
 {
     OMX_ERRORTYPE          ret = OMX_ErrorNone;
@@ -210,7 +222,8 @@ OMX_ERRORTYPE SEC_OMX_ComponentStateSet(OMX_COMPONENTTYPE *pOMXComponent, OMX_U3
         goto EXIT;
     }
 
-    if ((currentState == OMX_StateLoaded) && (destState == OMX_StateIdle)) {
+    if (((currentState == OMX_StateLoaded) || (currentState == OMX_StateWaitForResources)) &&
+        (destState == OMX_StateIdle)) {
         ret = SEC_OMX_Get_Resource(pOMXComponent);
         if (ret != OMX_ErrorNone) {
             goto EXIT;
@@ -290,18 +303,17 @@ OMX_ERRORTYPE SEC_OMX_ComponentStateSet(OMX_COMPONENTTYPE *pOMXComponent, OMX_U3
                 pSECComponent->pSECPort[i].bufferSemID = NULL;
             }
 
-            pSECComponent->sec_mfc_componentTerminate(pOMXComponent);
-
             for (i = 0; i < (pSECComponent->portParam.nPorts); i++) {
                 pSECPort = (pSECComponent->pSECPort + i);
                 if (CHECK_PORT_TUNNELED(pSECPort) && CHECK_PORT_BUFFER_SUPPLIER(pSECPort)) {
-                    while (SEC_OSAL_GetElemNum(&pSECPort->bufferQ) > 0) {
-                        message = (SEC_OMX_MESSAGE*)SEC_OSAL_Dequeue(&pSECPort->bufferQ);
+                    while (SEC_OSAL_RingGetElemNum(&pSECPort->bufferQ) > 0) {
+                        message = (SEC_OMX_MESSAGE*)SEC_OSAL_RingGet(&pSECPort->bufferQ);
                         if (message != NULL)
-                            SEC_OSAL_Free(message);
+                            SEC_OSAL_PoolFree(pSECComponent->hMemoryPool, message);
                     }
                     ret = pSECComponent->sec_FreeTunnelBuffer(pSECComponent, i);
                     if (OMX_ErrorNone != ret) {
+                        pSECComponent->sec_mfc_componentTerminate(pOMXComponent);
                         goto EXIT;
                     }
                 } else {
@@ -311,6 +323,9 @@ OMX_ERRORTYPE SEC_OMX_ComponentStateSet(OMX_COMPONENTTYPE *pOMXComponent, OMX_U3
                     }
                 }
             }
+
+            /* buffers of the codec memory stay mapped until the client has freed them */
+            pSECComponent->sec_mfc_componentTerminate(pOMXComponent);
             pSECComponent->currentState = OMX_StateLoaded;
             break;
         case OMX_StateWaitForResources:
@@ -327,6 +342,11 @@ OMX_ERRORTYPE SEC_OMX_ComponentStateSet(OMX_COMPONENTTYPE *pOMXComponent, OMX_U3
     case OMX_StateIdle:
         switch (currentState) {
         case OMX_StateLoaded:
+        case OMX_StateWaitForResources:
+            /*
+             * from WaitForResources the client sends this command after
+             * OMX_EventResourcesAcquired and allocates the buffers, as from Loaded
+             */
             for (i = 0; i < pSECComponent->portParam.nPorts; i++) {
                 pSECPort = (pSECComponent->pSECPort + i);
                 if (pSECPort == NULL) {
@@ -351,6 +371,7 @@ OMX_ERRORTYPE SEC_OMX_ComponentStateSet(OMX_COMPONENTTYPE *pOMXComponent, OMX_U3
                 /*
                  * if (CHECK_PORT_TUNNELED == OMX_TRUE) thenTunnel Buffer Free
                  */
+                SEC_OMX_Release_Resource(pOMXComponent);
                 goto EXIT;
             }
             pSECComponent->bExitBufferProcessThread = OMX_FALSE;
@@ -361,9 +382,10 @@ OMX_ERRORTYPE SEC_OMX_ComponentStateSet(OMX_COMPONENTTYPE *pOMXComponent, OMX_U3
             for (i = 0; i < ALL_PORT_NUM; i++) {
                 SEC_OSAL_MutexCreate(&pSECComponent->secDataBuffer[i].bufferMutex);
             }
-            ret = SEC_OSAL_ThreadCreate(&pSECComponent->hBufferProcess,
+            ret = SEC_OSAL_ThreadCreateEx(&pSECComponent->hBufferProcess,
                              SEC_OMX_BufferProcessThread,
-                             pOMXComponent);
+                             pOMXComponent,
+                             &pSECComponent->bufferProcessThreadAttr);
             if (ret != OMX_ErrorNone) {
                 /*
                  * if (CHECK_PORT_TUNNELED == OMX_TRUE) thenTunnel Buffer Free
@@ -378,6 +400,8 @@ OMX_ERRORTYPE SEC_OMX_ComponentStateSet(OMX_COMPONENTTYPE *pOMXComponent, OMX_U3
                     SEC_OSAL_SemaphoreTerminate(pSECComponent->pSECPort[i].bufferSemID);
                     pSECComponent->pSECPort[i].bufferSemID = NULL;
                 }
+                pSECComponent->sec_mfc_componentTerminate(pOMXComponent);
+                SEC_OMX_Release_Resource(pOMXComponent);
 
                 ret = OMX_ErrorInsufficientResources;
                 goto EXIT;
@@ -389,9 +413,6 @@ OMX_ERRORTYPE SEC_OMX_ComponentStateSet(OMX_COMPONENTTYPE *pOMXComponent, OMX_U3
             SEC_OMX_BufferFlushProcessNoEvent(pOMXComponent, ALL_PORT_INDEX);
             pSECComponent->currentState = OMX_StateIdle;
             break;
-        case OMX_StateWaitForResources:
-            pSECComponent->currentState = OMX_StateIdle;
-            break;
         }
         break;
     case OMX_StateExecuting:
@@ -412,6 +433,7 @@ OMX_ERRORTYPE SEC_OMX_ComponentStateSet(OMX_COMPONENTTYPE *pOMXComponent, OMX_U3
             pSECComponent->transientState = SEC_OMX_TransStateMax;
             pSECComponent->currentState = OMX_StateExecuting;
             SEC_OSAL_SignalSet(pSECComponent->pauseEvent);
+            SEC_OMX_OutputPauseEventSet(pSECComponent);
             break;
         case OMX_StatePause:
             for (i = 0; i < pSECComponent->portParam.nPorts; i++) {
@@ -419,8 +441,8 @@ OMX_ERRORTYPE SEC_OMX_ComponentStateSet(OMX_COMPONENTTYPE *pOMXComponent, OMX_U3
                 if (CHECK_PORT_TUNNELED(pSECPort) && CHECK_PORT_BUFFER_SUPPLIER(pSECPort) && CHECK_PORT_ENABLED(pSECPort)) {
                     OMX_U32 semaValue = 0, cnt = 0;
                     SEC_OSAL_Get_SemaphoreCount(pSECComponent->pSECPort[i].bufferSemID, &semaValue);
-                    if (SEC_OSAL_GetElemNum(&pSECPort->bufferQ) > semaValue) {
-                        cnt = SEC_OSAL_GetElemNum(&pSECPort->bufferQ) - semaValue;
+                    if (SEC_OSAL_RingGetElemNum(&pSECPort->bufferQ) > semaValue) {
+                        cnt = SEC_OSAL_RingGetElemNum(&pSECPort->bufferQ) - semaValue;
                         for (j = 0; j < cnt; j++) {
                             SEC_OSAL_SemaphorePost(pSECComponent->pSECPort[i].bufferSemID);
                         }
@@ -430,6 +452,7 @@ OMX_ERRORTYPE SEC_OMX_ComponentStateSet(OMX_COMPONENTTYPE *pOMXComponent, OMX_U3
 
             pSECComponent->currentState = OMX_StateExecuting;
             SEC_OSAL_SignalSet(pSECComponent->pauseEvent);
+            SEC_OMX_OutputPauseEventSet(pSECComponent);
             break;
         case OMX_StateWaitForResources:
             ret = OMX_ErrorIncorrectStateTransition;
@@ -539,7 +562,7 @@ static OMX_ERRORTYPE SEC_OMX_MessageHandlerThread(OMX_PTR threadData)
             default:
                 break;
             }
-            SEC_OSAL_Free(message);
+            SEC_OSAL_PoolFree(pSECComponent->hMemoryPool, message);
             message = NULL;
         }
     }
@@ -557,7 +580,8 @@ static OMX_ERRORTYPE SEC_StateSet(SEC_OMX_BASECOMPONENT *pSECComponent, OMX_U32
     OMX_U32 destState = nParam;
     OMX_U32 i = 0;
 
-    if ((destState == OMX_StateIdle) && (pSECComponent->currentState == OMX_StateLoaded)) {
+    if ((destState == OMX_StateIdle) &&
+        ((pSECComponent->currentState == OMX_StateLoaded) || (pSECComponent->currentState == OMX_StateWaitForResources))) {
         pSECComponent->transientState = SEC_OMX_TransStateLoadedToIdle;
         for(i = 0; i < pSECComponent->portParam.nPorts; i++) {
             pSECComponent->pSECPort[i].portState = OMX_StateIdle;
@@ -655,6 +679,7 @@ static OMX_ERRORTYPE SEC_SetPortEnable(SEC_OMX_BASECOMPONENT *pSECComponent, OMX
             pSECPort->portState = OMX_StateIdle;
         }
     }
+    SEC_OMX_OutputPauseEventSet(pSECComponent);
     ret = OMX_ErrorNone;
 
 EXIT:
@@ -733,7 +758,7 @@ static OMX_ERRORTYPE SEC_OMX_CommandQueue(
     OMX_PTR                pCmdData)
 {
     OMX_ERRORTYPE    ret = OMX_ErrorNone;
-    SEC_OMX_MESSAGE *command = (SEC_OMX_MESSAGE *)SEC_OSAL_Malloc(sizeof(SEC_OMX_MESSAGE));
+    SEC_OMX_MESSAGE *command = (SEC_OMX_MESSAGE *)SEC_OSAL_PoolMalloc(pSECComponent->hMemoryPool, sizeof(SEC_OMX_MESSAGE));
 
     if (command == NULL) {
         ret = OMX_ErrorInsufficientResources;
@@ -745,6 +770,7 @@ static OMX_ERRORTYPE SEC_OMX_CommandQueue(
 
     ret = SEC_OSAL_Queue(&pSECComponent->messageQ, (void *)command);
     if (ret != 0) {
+        SEC_OSAL_PoolFree(pSECComponent->hMemoryPool, command);
         ret = OMX_ErrorUndefined;
         goto EXIT;
     }
@@ -1067,7 +1093,8 @@ OMX_ERRORTYPE SEC_OMX_SetParameter(
                 goto EXIT;
             }
         }
-        if (portDefinition->nBufferCountActual < pSECPort->portDefinition.nBufferCountMin) {
+        if ((portDefinition->nBufferCountActual < pSECPort->portDefinition.nBufferCountMin) ||
+            (portDefinition->nBufferCountActual > MAX_BUFFER_NUM)) {
             ret = OMX_ErrorBadParameter;
             goto EXIT;
         }
@@ -1218,7 +1245,36 @@ OMX_ERRORTYPE SEC_OMX_GetConfig(
         ret = OMX_ErrorInvalidState;
         goto EXIT;
     }
-    ret = OMX_ErrorUnsupportedIndex;
+
+    switch (nIndex) {
+    case OMX_IndexVendorStatistics:
+    {
+        SEC_OMX_CONFIG_STATSTYPE *pStats = (SEC_OMX_CONFIG_STATSTYPE *)pComponentConfigStructure;
+
+        ret = SEC_OMX_Check_SizeVersion(pStats, sizeof(SEC_OMX_CONFIG_STATSTYPE));
+        if (ret != OMX_ErrorNone) {
+            goto EXIT;
+        }
+
+        ret = SEC_OMX_StatsGet(&pSECComponent->stats, pStats);
+    }
+        break;
+    case OMX_IndexVendorResourceUtilization:
+    {
+        SEC_OMX_CONFIG_RESOURCETYPE *pResource = (SEC_OMX_CONFIG_RESOURCETYPE *)pComponentConfigStructure;
+
+        ret = SEC_OMX_Check_SizeVersion(pResource, sizeof(SEC_OMX_CONFIG_RESOURCETYPE));
+        if (ret != OMX_ErrorNone) {
+            goto EXIT;
+        }
+
+        ret = SEC_OMX_Get_ResourceUtilization(pOMXComponent, pResource);
+    }
+        break;
+    default:
+        ret = OMX_ErrorUnsupportedIndex;
+        break;
+    }
 
 EXIT:
     FunctionOut();
@@ -1261,7 +1317,32 @@ OMX_ERRORTYPE SEC_OMX_SetConfig(
         ret = OMX_ErrorInvalidState;
         goto EXIT;
     }
-    ret = OMX_ErrorUnsupportedIndex;
+
+    switch (nIndex) {
+    case OMX_IndexVendorStatistics:
+    {
+        ret = SEC_OMX_Check_SizeVersion(pComponentConfigStructure, sizeof(SEC_OMX_CONFIG_STATSTYPE));
+        if (ret != OMX_ErrorNone) {
+            goto EXIT;
+        }
+
+        SEC_OMX_StatsReset(&pSECComponent->stats);
+    }
+        break;
+    case OMX_IndexVendorStatisticsDump:
+    {
+        ret = SEC_OMX_Check_SizeVersion(pComponentConfigStructure, sizeof(OMX_PARAM_U32TYPE));
+        if (ret != OMX_ErrorNone) {
+            goto EXIT;
+        }
+
+        ret = SEC_OMX_StatsDump(&pSECComponent->stats, pSECComponent->componentName);
+    }
+        break;
+    default:
+        ret = OMX_ErrorUnsupportedIndex;
+        break;
+    }
 
 EXIT:
     FunctionOut();
@@ -1305,7 +1386,18 @@ OMX_ERRORTYPE SEC_OMX_GetExtensionIndex(
         goto EXIT;
     }
 
-    ret = OMX_ErrorBadParameter;
+    if (SEC_OSAL_Strcmp(cParameterName, SEC_INDEX_CONFIG_STATISTICS) == 0) {
+        *pIndexType = OMX_IndexVendorStatistics;
+        ret = OMX_ErrorNone;
+    } else if (SEC_OSAL_Strcmp(cParameterName, SEC_INDEX_CONFIG_STATISTICS_DUMP) == 0) {
+        *pIndexType = OMX_IndexVendorStatisticsDump;
+        ret = OMX_ErrorNone;
+    } else if (SEC_OSAL_Strcmp(cParameterName, SEC_INDEX_CONFIG_RESOURCE_UTILIZATION) == 0) {
+        *pIndexType = OMX_IndexVendorResourceUtilization;
+        ret = OMX_ErrorNone;
+    } else {
+        ret = OMX_ErrorBadParameter;
+    }
 
 EXIT:
     FunctionOut();
@@ -1398,6 +1490,12 @@ OMX_ERRORTYPE SEC_OMX_BaseComponent_Constructor(
     SEC_OSAL_Memset(pSECComponent, 0, sizeof(SEC_OMX_BASECOMPONENT));
     pOMXComponent->pComponentPrivate = (OMX_PTR)pSECComponent;
 
+    ret = SEC_OSAL_MemoryPoolCreate(&pSECComponent->hMemoryPool);
+    if (ret != OMX_ErrorNone) {
+        ret = OMX_ErrorInsufficientResources;
+        SEC_OSAL_Log(SEC_LOG_ERROR, "OMX_ErrorInsufficientResources, Line:%d", __LINE__);
+        goto EXIT;
+    }
     ret = SEC_OSAL_SemaphoreCreate(&pSECComponent->msgSemaphoreHandle);
     if (ret != OMX_ErrorNone) {
         ret = OMX_ErrorInsufficientResources;
@@ -1410,9 +1508,20 @@ OMX_ERRORTYPE SEC_OMX_BaseComponent_Constructor(
         SEC_OSAL_Log(SEC_LOG_ERROR, "OMX_ErrorInsufficientResources, Line:%d", __LINE__);
         goto EXIT;
     }
+    ret = SEC_OMX_StatsCreate(&pSECComponent->stats);
+    if (ret != OMX_ErrorNone) {
+        ret = OMX_ErrorInsufficientResources;
+        SEC_OSAL_Log(SEC_LOG_ERROR, "OMX_ErrorInsufficientResources, Line:%d", __LINE__);
+        goto EXIT;
+    }
 
     pSECComponent->bExitMessageHandlerThread = OMX_FALSE;
-    SEC_OSAL_QueueCreate(&pSECComponent->messageQ);
+    ret = SEC_OSAL_QueueCreate(&pSECComponent->messageQ, MAX_QUEUE_ELEMENTS);
+    if (ret != OMX_ErrorNone) {
+        ret = OMX_ErrorInsufficientResources;
+        SEC_OSAL_Log(SEC_LOG_ERROR, "OMX_ErrorInsufficientResources, Line:%d", __LINE__);
+        goto EXIT;
+    }
     ret = SEC_OSAL_ThreadCreate(&pSECComponent->hMessageHandler, SEC_OMX_MessageHandlerThread, pOMXComponent);
     if (ret != OMX_ErrorNone) {
         ret = OMX_ErrorInsufficientResources;
@@ -1433,6 +1542,62 @@ EXIT:
     return ret;
 }
 
+/*
+ * Back to the state right after construction, keeping the message handler
+ * thread. Only for a component in Loaded state with no command pending.
+ */
+OMX_ERRORTYPE SEC_OMX_BaseComponent_Reset(
+    OMX_IN OMX_HANDLETYPE hComponent)
+{
+    OMX_ERRORTYPE          ret = OMX_ErrorNone;
+    OMX_COMPONENTTYPE     *pOMXComponent = NULL;
+    SEC_OMX_BASECOMPONENT *pSECComponent = NULL;
+
+    FunctionIn();
+
+    if (hComponent == NULL) {
+        ret = OMX_ErrorBadParameter;
+        goto EXIT;
+    }
+    pOMXComponent = (OMX_COMPONENTTYPE *)hComponent;
+    ret = SEC_OMX_Check_SizeVersion(pOMXComponent, sizeof(OMX_COMPONENTTYPE));
+    if (ret != OMX_ErrorNone) {
+        goto EXIT;
+    }
+
+    if (pOMXComponent->pComponentPrivate == NULL) {
+        ret = OMX_ErrorBadParameter;
+        goto EXIT;
+    }
+    pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+
+    if ((pSECComponent->currentState != OMX_StateLoaded) ||
+        ((pSECComponent->transientState != SEC_OMX_TransStateInvalid) &&
+         (pSECComponent->transientState != SEC_OMX_TransStateMax)) ||
+        (pSECComponent->hBufferProcess != NULL) ||
+        (SEC_OSAL_GetElemNum(&pSECComponent->messageQ) > 0)) {
+        ret = OMX_ErrorIncorrectStateOperation;
+        goto EXIT;
+    }
+
+    pSECComponent->transientState = SEC_OMX_TransStateInvalid;
+    SEC_OSAL_Memset(&pSECComponent->compPriority, 0, sizeof(SEC_OMX_PRIORITYMGMTTYPE));
+    SEC_OSAL_Memset(&pSECComponent->propagateMarkType, 0, sizeof(OMX_MARKTYPE));
+    pSECComponent->pCallbacks = NULL;
+    pSECComponent->callbackData = NULL;
+    pSECComponent->getAllDelayBuffer = OMX_FALSE;
+    pSECComponent->remainOutputData = OMX_FALSE;
+    pSECComponent->reInputData = OMX_FALSE;
+    pSECComponent->bUseFlagEOF = OMX_FALSE;
+    pSECComponent->bSaveFlagEOS = OMX_FALSE;
+    SEC_OMX_StatsReset(&pSECComponent->stats);
+
+EXIT:
+    FunctionOut();
+
+    return ret;
+}
+
 OMX_ERRORTYPE SEC_OMX_BaseComponent_Destructor(
     OMX_IN OMX_HANDLETYPE hComponent)
 {
@@ -1471,9 +1636,12 @@ OMX_ERRORTYPE SEC_OMX_BaseComponent_Destructor(
 
     SEC_OSAL_MutexTerminate(pSECComponent->compMutex);
     pSECComponent->compMutex = NULL;
+    SEC_OMX_StatsTerminate(&pSECComponent->stats);
     SEC_OSAL_SemaphoreTerminate(pSECComponent->msgSemaphoreHandle);
     pSECComponent->msgSemaphoreHandle = NULL;
     SEC_OSAL_QueueTerminate(&pSECComponent->messageQ);
+    SEC_OSAL_MemoryPoolTerminate(pSECComponent->hMemoryPool);
+    pSECComponent->hMemoryPool = NULL;
 
     SEC_OSAL_Free(pSECComponent);
     pSECComponent = NULL;
@@ -31,7 +31,10 @@
 #include "SEC_OMX_Def.h"
 #include "OMX_Component.h"
 #include "SEC_OSAL_Queue.h"
+#include "SEC_OSAL_Thread.h"
 #include "SEC_OMX_Baseport.h"
+#include "SEC_OMX_FrameTag.h"
+#include "SEC_OMX_Stats.h"
 
 
 typedef struct _SEC_OMX_MESSAGE
@@ -52,6 +55,7 @@ typedef struct _SEC_OMX_DATABUFFER
     OMX_U32               remainDataLen;
     OMX_U32               nFlags;
     OMX_TICKS             timeStamp;
+    OMX_U64               nEmptyTimeUs;   /* EmptyThisBuffer of the frame, 0 if unknown */
 } SEC_OMX_DATABUFFER;
 
 typedef struct _SEC_BUFFER_HEADER{
@@ -73,7 +77,12 @@ typedef struct _SEC_OMX_DATA
     OMX_U32   previousDataLen;
     OMX_U32   nFlags;
     OMX_TICKS timeStamp;
+    OMX_U64   nEmptyTimeUs;   /* EmptyThisBuffer of the frame, 0 if unknown */
     SEC_BUFFER_HEADER specificBufferHeader;
+
+    /* client buffer lent to the codec, dataBuffer points into it */
+    OMX_BUFFERHEADERTYPE *bufferHeader;
+    OMX_PTR   dataPhyBuffer;
 } SEC_OMX_DATA;
 
 /* for Check TimeStamp after Seek */
@@ -99,8 +108,17 @@ typedef struct _SEC_OMX_BASECOMPONENT
     OMX_MARKTYPE             propagateMarkType;
     OMX_HANDLETYPE           compMutex;
 
+    /* Pool of the messages and commands, see SEC_OSAL_PoolMalloc */
+    OMX_HANDLETYPE           hMemoryPool;
+
     OMX_HANDLETYPE           hCodecHandle;
 
+    /* Video decoder only, see SEC_OMX_DEC_PIPELINE */
+    OMX_HANDLETYPE           hDecPipeline;
+
+    /* Video encoder only, see SEC_OMX_ENC_INPUT */
+    OMX_HANDLETYPE           hEncInput;
+
     /* Message Handler */
     OMX_BOOL                 bExitMessageHandlerThread;
     OMX_HANDLETYPE           hMessageHandler;
@@ -110,6 +128,7 @@ typedef struct _SEC_OMX_BASECOMPONENT
     /* Buffer Process */
     OMX_BOOL                 bExitBufferProcessThread;
     OMX_HANDLETYPE           hBufferProcess;
+    SEC_OSAL_THREAD_ATTR     bufferProcessThreadAttr;  /* set by Vdec or Venc, named by the codec component */
 
     /* Buffer */
     SEC_OMX_DATABUFFER       secDataBuffer[2];
@@ -122,17 +141,19 @@ typedef struct _SEC_OMX_BASECOMPONENT
     SEC_OMX_BASEPORT        *pSECPort;
 
     OMX_HANDLETYPE           pauseEvent;
+    /* Video decoder only, the output thread of SEC_OMX_DEC_PIPELINE waits on it */
+    OMX_HANDLETYPE           outputPauseEvent;
 
     /* Callback function */
     OMX_CALLBACKTYPE        *pCallbacks;
     OMX_PTR                  callbackData;
 
-    /* Save Timestamp */
-    OMX_TICKS                timeStamp[MAX_TIMESTAMP];
+    /* Timestamp and flags of the frames in the codec, by MFC frame tag */
+    SEC_OMX_FRAME_TAG_MAP    frameTagMap;
     SEC_OMX_TIMESTAMP        checkTimeStamp;
 
-    /* Save Flags */
-    OMX_U32                  nFlags[MAX_FLAGS];
+    /* OMX_IndexVendorStatistics */
+    SEC_OMX_STATS_DATA       stats;
 
     OMX_BOOL                 getAllDelayBuffer;
     OMX_BOOL                 remainOutputData;
@@ -147,11 +168,21 @@ typedef struct _SEC_OMX_BASECOMPONENT
     OMX_ERRORTYPE (*sec_mfc_componentInit)(OMX_COMPONENTTYPE *pOMXComponent);
     OMX_ERRORTYPE (*sec_mfc_componentTerminate)(OMX_COMPONENTTYPE *pOMXComponent);
     OMX_ERRORTYPE (*sec_mfc_bufferProcess) (OMX_COMPONENTTYPE *pOMXComponent, SEC_OMX_DATA *pInputData, SEC_OMX_DATA *pOutputData);
+    /* optional, input buffers the codec reads in place */
+    OMX_ERRORTYPE (*sec_mfc_allocateInputBuffer)(OMX_COMPONENTTYPE *pOMXComponent, OMX_U32 nIndex, OMX_U32 nSizeBytes, OMX_U8 **ppBuffer, OMX_PTR *ppPhyBuffer);
+    OMX_ERRORTYPE (*sec_mfc_releaseInputBuffer)(OMX_COMPONENTTYPE *pOMXComponent, OMX_BOOL bAll);
+    /* optional, output buffers the codec encodes into in place */
+    OMX_ERRORTYPE (*sec_mfc_allocateOutputBuffer)(OMX_COMPONENTTYPE *pOMXComponent, OMX_U32 nIndex, OMX_U32 nSizeBytes, OMX_U8 **ppBuffer, OMX_PTR *ppPhyBuffer);
+    OMX_ERRORTYPE (*sec_mfc_releaseOutputBuffer)(OMX_COMPONENTTYPE *pOMXComponent);
+    /* optional, fills an output buffer with a frame decoded earlier */
+    OMX_ERRORTYPE (*sec_mfc_fillOutput)(OMX_COMPONENTTYPE *pOMXComponent, OMX_PTR pOutputInfo, SEC_OMX_DATA *pOutputData);
 
     OMX_ERRORTYPE (*sec_AllocateTunnelBuffer)(SEC_OMX_BASEPORT *pOMXBasePort, OMX_U32 nPortIndex);
     OMX_ERRORTYPE (*sec_FreeTunnelBuffer)(SEC_OMX_BASEPORT *pOMXBasePort, OMX_U32 nPortIndex);
     OMX_ERRORTYPE (*sec_BufferProcess)(OMX_HANDLETYPE hComponent);
     OMX_ERRORTYPE (*sec_BufferReset)(OMX_COMPONENTTYPE *pOMXComponent, OMX_U32 nPortIndex);
+    /* optional, drops the frames decoded but not delivered yet */
+    OMX_ERRORTYPE (*sec_BufferFlush)(OMX_COMPONENTTYPE *pOMXComponent, OMX_U32 nPortIndex);
     OMX_ERRORTYPE (*sec_InputBufferReturn)(OMX_COMPONENTTYPE *pOMXComponent);
     OMX_ERRORTYPE (*sec_OutputBufferReturn)(OMX_COMPONENTTYPE *pOMXComponent);
 
@@ -165,6 +196,8 @@ extern "C" {
 #endif
 
     OMX_ERRORTYPE SEC_OMX_Check_SizeVersion(OMX_PTR header, OMX_U32 size);
+    OMX_ERRORTYPE SEC_OMX_BaseComponent_Reset(OMX_IN OMX_HANDLETYPE hComponent);
+    void SEC_OMX_OutputPauseEventSet(SEC_OMX_BASECOMPONENT *pSECComponent);
 
 
 #ifdef __cplusplus
@@ -43,6 +43,15 @@
 #include "SEC_OSAL_Log.h"
 
 
+/* the decoder reads checkTimeStamp on its decode and output threads under compMutex */
+static void SEC_OMX_CheckTimeStampReset(SEC_OMX_BASECOMPONENT *pSECComponent)
+{
+    SEC_OSAL_MutexLock(pSECComponent->compMutex);
+    pSECComponent->checkTimeStamp.needSetStartTimeStamp = OMX_TRUE;
+    pSECComponent->checkTimeStamp.needCheckStartTimeStamp = OMX_FALSE;
+    SEC_OSAL_MutexUnlock(pSECComponent->compMutex);
+}
+
 OMX_ERRORTYPE SEC_OMX_FlushPort(OMX_COMPONENTTYPE *pOMXComponent, OMX_S32 portIndex)
 {
     OMX_ERRORTYPE          ret = OMX_ErrorNone;
@@ -55,14 +64,18 @@ OMX_ERRORTYPE SEC_OMX_FlushPort(OMX_COMPONENTTYPE *pOMXComponent, OMX_S32 portIn
 
     FunctionIn();
 
+    /* decoded frames of the flushed input, or waiting for the flushed output */
+    if (pSECComponent->sec_BufferFlush != NULL)
+        pSECComponent->sec_BufferFlush(pOMXComponent, portIndex);
+
     pSECPort = &pSECComponent->pSECPort[portIndex];
-    while (SEC_OSAL_GetElemNum(&pSECPort->bufferQ) > 0) {
+    while (SEC_OSAL_RingGetElemNum(&pSECPort->bufferQ) > 0) {
         SEC_OSAL_Get_SemaphoreCount(pSECComponent->pSECPort[portIndex].bufferSemID, &semValue);
         if (semValue == 0)
             SEC_OSAL_SemaphorePost(pSECComponent->pSECPort[portIndex].bufferSemID);
         SEC_OSAL_SemaphoreWait(pSECComponent->pSECPort[portIndex].bufferSemID);
 
-        message = (SEC_OMX_MESSAGE *)SEC_OSAL_Dequeue(&pSECPort->bufferQ);
+        message = (SEC_OMX_MESSAGE *)SEC_OSAL_RingGet(&pSECPort->bufferQ);
         if (message != NULL) {
             bufferHeader = (OMX_BUFFERHEADERTYPE *)message->pCmdData;
             bufferHeader->nFilledLen = 0;
@@ -73,12 +86,13 @@ OMX_ERRORTYPE SEC_OMX_FlushPort(OMX_COMPONENTTYPE *pOMXComponent, OMX_S32 portIn
                 } else {
                     OMX_FillThisBuffer(pSECPort->tunneledComponent, bufferHeader);
                 }
-                SEC_OSAL_Free(message);
+                SEC_OSAL_PoolFree(pSECComponent->hMemoryPool, message);
                 message = NULL;
             } else if (CHECK_PORT_TUNNELED(pSECPort) && CHECK_PORT_BUFFER_SUPPLIER(pSECPort)) {
                 SEC_OSAL_Log(SEC_LOG_ERROR, "Tunneled mode is not working, Line:%d", __LINE__);
                 ret = OMX_ErrorNotImplemented;
-                SEC_OSAL_Queue(&pSECPort->bufferQ, pSECPort);
+                if (SEC_OSAL_RingPut(&pSECPort->bufferQ, message) != 0)
+                    SEC_OSAL_PoolFree(pSECComponent->hMemoryPool, message);
                 goto EXIT;
             } else {
                 if (portIndex == OUTPUT_PORT_INDEX) {
@@ -87,7 +101,7 @@ OMX_ERRORTYPE SEC_OMX_FlushPort(OMX_COMPONENTTYPE *pOMXComponent, OMX_S32 portIn
                     pSECComponent->pCallbacks->EmptyBufferDone(pOMXComponent, pSECComponent->callbackData, bufferHeader);
                 }
 
-                SEC_OSAL_Free(message);
+                SEC_OSAL_PoolFree(pSECComponent->hMemoryPool, message);
                 message = NULL;
             }
         }
@@ -95,11 +109,14 @@ OMX_ERRORTYPE SEC_OMX_FlushPort(OMX_COMPONENTTYPE *pOMXComponent, OMX_S32 portIn
 
     if (pSECComponent->secDataBuffer[portIndex].dataValid == OMX_TRUE) {
         if (CHECK_PORT_TUNNELED(pSECPort) && CHECK_PORT_BUFFER_SUPPLIER(pSECPort)) {
-            message = SEC_OSAL_Malloc(sizeof(SEC_OMX_MESSAGE));
+            message = SEC_OSAL_PoolMalloc(pSECComponent->hMemoryPool, sizeof(SEC_OMX_MESSAGE));
             message->pCmdData = pSECComponent->secDataBuffer[portIndex].bufferHeader;
             message->messageType = 0;
             message->messageParam = -1;
-            SEC_OSAL_Queue(&pSECPort->bufferQ, message);
+            if (SEC_OSAL_RingPut(&pSECPort->bufferQ, message) != 0) {
+                SEC_OSAL_Log(SEC_LOG_ERROR, "bufferQ full, Line:%d", __LINE__);
+                SEC_OSAL_PoolFree(pSECComponent->hMemoryPool, message);
+            }
             pSECComponent->sec_BufferReset(pOMXComponent, portIndex);
         } else {
             if (portIndex == INPUT_PORT_INDEX)
@@ -109,12 +126,18 @@ OMX_ERRORTYPE SEC_OMX_FlushPort(OMX_COMPONENTTYPE *pOMXComponent, OMX_S32 portIn
         }
     }
 
+    /* input buffers the codec still reads in place */
+    if ((portIndex == INPUT_PORT_INDEX) && (pSECComponent->sec_mfc_releaseInputBuffer != NULL))
+        pSECComponent->sec_mfc_releaseInputBuffer(pOMXComponent, OMX_TRUE);
+
+    /* output buffers lent to the codec */
+    if ((portIndex == OUTPUT_PORT_INDEX) && (pSECComponent->sec_mfc_releaseOutputBuffer != NULL))
+        pSECComponent->sec_mfc_releaseOutputBuffer(pOMXComponent);
+
     if (CHECK_PORT_TUNNELED(pSECPort) && CHECK_PORT_BUFFER_SUPPLIER(pSECPort)) {
-        while (SEC_OSAL_GetElemNum(&pSECPort->bufferQ) < pSECPort->assignedBufferNum) {
+        while (SEC_OSAL_RingGetElemNum(&pSECPort->bufferQ) < pSECPort->assignedBufferNum) {
             SEC_OSAL_SemaphoreWait(pSECComponent->pSECPort[portIndex].bufferSemID);
         }
-        if (SEC_OSAL_GetElemNum(&pSECPort->bufferQ) != pSECPort->assignedBufferNum)
-            SEC_OSAL_SetElemNum(&pSECPort->bufferQ, pSECPort->assignedBufferNum);
     } else {
         while(1) {
             int cnt;
@@ -123,7 +146,6 @@ OMX_ERRORTYPE SEC_OMX_FlushPort(OMX_COMPONENTTYPE *pOMXComponent, OMX_S32 portIn
                 break;
             SEC_OSAL_SemaphoreWait(pSECComponent->pSECPort[portIndex].bufferSemID);
         }
-        SEC_OSAL_SetElemNum(&pSECPort->bufferQ, 0);
     }
 
     pSECComponent->processData[portIndex].dataLen       = 0;
@@ -191,10 +213,8 @@ OMX_ERRORTYPE SEC_OMX_BufferFlushProcess(OMX_COMPONENTTYPE *pOMXComponent, OMX_S
         }
 
         if (portIndex == INPUT_PORT_INDEX) {
-            pSECComponent->checkTimeStamp.needSetStartTimeStamp = OMX_TRUE;
-            pSECComponent->checkTimeStamp.needCheckStartTimeStamp = OMX_FALSE;
-            SEC_OSAL_Memset(pSECComponent->timeStamp, -19771003, sizeof(OMX_TICKS) * MAX_TIMESTAMP);
-            SEC_OSAL_Memset(pSECComponent->nFlags, 0, sizeof(OMX_U32) * MAX_FLAGS);
+            SEC_OMX_CheckTimeStampReset(pSECComponent);
+            SEC_OMX_FrameTagReset(&pSECComponent->frameTagMap);
             pSECComponent->getAllDelayBuffer = OMX_FALSE;
             pSECComponent->bSaveFlagEOS = OMX_FALSE;
             pSECComponent->reInputData = OMX_FALSE;
@@ -263,10 +283,8 @@ OMX_ERRORTYPE SEC_OMX_BufferFlushProcessNoEvent(OMX_COMPONENTTYPE *pOMXComponent
         pSECComponent->pSECPort[portIndex].bIsPortFlushed = OMX_FALSE;
 
         if (portIndex == INPUT_PORT_INDEX) {
-            pSECComponent->checkTimeStamp.needSetStartTimeStamp = OMX_TRUE;
-            pSECComponent->checkTimeStamp.needCheckStartTimeStamp = OMX_FALSE;
-            SEC_OSAL_Memset(pSECComponent->timeStamp, -19771003, sizeof(OMX_TICKS) * MAX_TIMESTAMP);
-            SEC_OSAL_Memset(pSECComponent->nFlags, 0, sizeof(OMX_U32) * MAX_FLAGS);
+            SEC_OMX_CheckTimeStampReset(pSECComponent);
+            SEC_OMX_FrameTagReset(&pSECComponent->frameTagMap);
             pSECComponent->getAllDelayBuffer = OMX_FALSE;
             pSECComponent->bSaveFlagEOS = OMX_FALSE;
             pSECComponent->remainOutputData = OMX_FALSE;
@@ -403,9 +421,9 @@ OMX_ERRORTYPE SEC_OMX_DisablePort(OMX_COMPONENTTYPE *pOMXComponent, OMX_S32 port
 
     if (pSECComponent->currentState!=OMX_StateLoaded) {
         if (CHECK_PORT_TUNNELED(pSECPort) && CHECK_PORT_BUFFER_SUPPLIER(pSECPort)) {
-            while (SEC_OSAL_GetElemNum(&pSECPort->bufferQ) >0 ) {
-                message = (SEC_OMX_MESSAGE*)SEC_OSAL_Dequeue(&pSECPort->bufferQ);
-                SEC_OSAL_Free(message);
+            while (SEC_OSAL_RingGetElemNum(&pSECPort->bufferQ) >0 ) {
+                message = (SEC_OMX_MESSAGE*)SEC_OSAL_RingGet(&pSECPort->bufferQ);
+                SEC_OSAL_PoolFree(pSECComponent->hMemoryPool, message);
             }
             ret = pSECComponent->sec_FreeTunnelBuffer(pSECPort, portIndex);
             if (OMX_ErrorNone != ret) {
@@ -417,9 +435,9 @@ OMX_ERRORTYPE SEC_OMX_DisablePort(OMX_COMPONENTTYPE *pOMXComponent, OMX_S32 port
             SEC_OSAL_SemaphoreWait(pSECPort->unloadedResource);
         } else {
             if (CHECK_PORT_BUFFER_SUPPLIER(pSECPort)) {
-                while (SEC_OSAL_GetElemNum(&pSECPort->bufferQ) >0 ) {
-                    message = (SEC_OMX_MESSAGE*)SEC_OSAL_Dequeue(&pSECPort->bufferQ);
-                    SEC_OSAL_Free(message);
+                while (SEC_OSAL_RingGetElemNum(&pSECPort->bufferQ) >0 ) {
+                    message = (SEC_OMX_MESSAGE*)SEC_OSAL_RingGet(&pSECPort->bufferQ);
+                    SEC_OSAL_PoolFree(pSECComponent->hMemoryPool, message);
                 }
             }
             pSECPort->portDefinition.bPopulated = OMX_FALSE;
@@ -480,10 +498,8 @@ OMX_ERRORTYPE SEC_OMX_PortDisableProcess(OMX_COMPONENTTYPE *pOMXComponent, OMX_S
         pSECComponent->pSECPort[portIndex].bIsPortFlushed = OMX_FALSE;
 
         if (portIndex == INPUT_PORT_INDEX) {
-            pSECComponent->checkTimeStamp.needSetStartTimeStamp = OMX_TRUE;
-            pSECComponent->checkTimeStamp.needCheckStartTimeStamp = OMX_FALSE;
-            SEC_OSAL_Memset(pSECComponent->timeStamp, -19771003, sizeof(OMX_TICKS) * MAX_TIMESTAMP);
-            SEC_OSAL_Memset(pSECComponent->nFlags, 0, sizeof(OMX_U32) * MAX_FLAGS);
+            SEC_OMX_CheckTimeStampReset(pSECComponent);
+            SEC_OMX_FrameTagReset(&pSECComponent->frameTagMap);
             pSECComponent->getAllDelayBuffer = OMX_FALSE;
             pSECComponent->bSaveFlagEOS = OMX_FALSE;
             pSECComponent->reInputData = OMX_FALSE;
@@ -600,7 +616,7 @@ OMX_ERRORTYPE SEC_OMX_EmptyThisBuffer(
         ret = OMX_ErrorNone;
     }
 
-    message = SEC_OSAL_Malloc(sizeof(SEC_OMX_MESSAGE));
+    message = SEC_OSAL_PoolMalloc(pSECComponent->hMemoryPool, sizeof(SEC_OMX_MESSAGE));
     if (message == NULL) {
         ret = OMX_ErrorInsufficientResources;
         goto EXIT;
@@ -609,7 +625,13 @@ OMX_ERRORTYPE SEC_OMX_EmptyThisBuffer(
     message->messageParam = (OMX_U32) i;
     message->pCmdData = (OMX_PTR)pBuffer;
 
-    SEC_OSAL_Queue(&pSECPort->bufferQ, (void *)message);
+    if (SEC_OSAL_RingPut(&pSECPort->bufferQ, (void *)message) != 0) {
+        SEC_OSAL_Log(SEC_LOG_ERROR, "bufferQ full, Line:%d", __LINE__);
+        SEC_OSAL_PoolFree(pSECComponent->hMemoryPool, message);
+        ret = OMX_ErrorInsufficientResources;
+        goto EXIT;
+    }
+    SEC_OMX_StatsInputEmptied(&pSECComponent->stats, i);
     SEC_OSAL_SemaphorePost(pSECPort->bufferSemID);
 
 EXIT:
@@ -697,7 +719,7 @@ OMX_ERRORTYPE SEC_OMX_FillThisBuffer(
         ret = OMX_ErrorNone;
     }
 
-    message = SEC_OSAL_Malloc(sizeof(SEC_OMX_MESSAGE));
+    message = SEC_OSAL_PoolMalloc(pSECComponent->hMemoryPool, sizeof(SEC_OMX_MESSAGE));
     if (message == NULL) {
         ret = OMX_ErrorInsufficientResources;
         goto EXIT;
@@ -706,7 +728,12 @@ OMX_ERRORTYPE SEC_OMX_FillThisBuffer(
     message->messageParam = (OMX_U32) i;
     message->pCmdData = (OMX_PTR)pBuffer;
 
-    SEC_OSAL_Queue(&pSECPort->bufferQ, (void *)message);
+    if (SEC_OSAL_RingPut(&pSECPort->bufferQ, (void *)message) != 0) {
+        SEC_OSAL_Log(SEC_LOG_ERROR, "bufferQ full, Line:%d", __LINE__);
+        SEC_OSAL_PoolFree(pSECComponent->hMemoryPool, message);
+        ret = OMX_ErrorInsufficientResources;
+        goto EXIT;
+    }
     SEC_OSAL_SemaphorePost(pSECPort->bufferSemID);
 
 EXIT:
@@ -715,6 +742,35 @@ EXIT:
     return ret;
 }
 
+/*
+ * Sizes bufferQ of a port for nBufferCountActual buffers.
+ * Called before the first buffer of the port is assigned, when nothing
+ * can be queued on it yet.
+ */
+OMX_ERRORTYPE SEC_OMX_PortBufferQueueSetup(SEC_OMX_BASEPORT *pSECPort)
+{
+    OMX_ERRORTYPE ret = OMX_ErrorNone;
+
+    FunctionIn();
+
+    if (pSECPort->assignedBufferNum != 0) {
+        ret = OMX_ErrorIncorrectStateOperation;
+        goto EXIT;
+    }
+
+    SEC_OSAL_RingTerminate(&pSECPort->bufferQ);
+    ret = SEC_OSAL_RingCreate(&pSECPort->bufferQ, pSECPort->portDefinition.nBufferCountActual);
+    if (ret != OMX_ErrorNone) {
+        SEC_OSAL_Log(SEC_LOG_ERROR, "bufferQ of %d buffers failed, Line:%d", pSECPort->portDefinition.nBufferCountActual, __LINE__);
+        goto EXIT;
+    }
+
+EXIT:
+    FunctionOut();
+
+    return ret;
+}
+
 OMX_ERRORTYPE SEC_OMX_Port_Constructor(OMX_HANDLETYPE hComponent)
 {
     OMX_ERRORTYPE          ret = OMX_ErrorNone;
@@ -761,7 +817,7 @@ OMX_ERRORTYPE SEC_OMX_Port_Constructor(OMX_HANDLETYPE hComponent)
     /* Input Port */
     pSECInputPort = &pSECPort[INPUT_PORT_INDEX];
 
-    SEC_OSAL_QueueCreate(&pSECInputPort->bufferQ);
+    /* bufferQ is sized by SEC_OMX_PortBufferQueueSetup() on first buffer */
 
     pSECInputPort->bufferHeader = SEC_OSAL_Malloc(sizeof(OMX_BUFFERHEADERTYPE*) * MAX_BUFFER_NUM);
     if (pSECInputPort->bufferHeader == NULL) {
@@ -838,7 +894,7 @@ OMX_ERRORTYPE SEC_OMX_Port_Constructor(OMX_HANDLETYPE hComponent)
     /* Output Port */
     pSECOutputPort = &pSECPort[OUTPUT_PORT_INDEX];
 
-    SEC_OSAL_QueueCreate(&pSECOutputPort->bufferQ);
+    /* bufferQ is sized by SEC_OMX_PortBufferQueueSetup() on first buffer */
 
     pSECOutputPort->bufferHeader = SEC_OSAL_Malloc(sizeof(OMX_BUFFERHEADERTYPE*) * MAX_BUFFER_NUM);
     if (pSECOutputPort->bufferHeader == NULL) {
@@ -960,6 +1016,87 @@ EXIT:
     return ret;
 }
 
+/*
+ * Ports back to their state after SEC_OMX_Port_Constructor. The MIME type
+ * string is kept for the video layer to refill. Fails if a buffer or a
+ * tunnel is still there.
+ */
+OMX_ERRORTYPE SEC_OMX_Port_Reset(OMX_HANDLETYPE hComponent)
+{
+    OMX_ERRORTYPE          ret = OMX_ErrorNone;
+    OMX_COMPONENTTYPE     *pOMXComponent = NULL;
+    SEC_OMX_BASECOMPONENT *pSECComponent = NULL;
+    SEC_OMX_BASEPORT      *pSECPort = NULL;
+    OMX_STRING             cMIMEType = NULL;
+    int i = 0;
+
+    FunctionIn();
+
+    if (hComponent == NULL) {
+        ret = OMX_ErrorBadParameter;
+        goto EXIT;
+    }
+    pOMXComponent = (OMX_COMPONENTTYPE *)hComponent;
+    ret = SEC_OMX_Check_SizeVersion(pOMXComponent, sizeof(OMX_COMPONENTTYPE));
+    if (ret != OMX_ErrorNone) {
+        goto EXIT;
+    }
+
+    if (pOMXComponent->pComponentPrivate == NULL) {
+        ret = OMX_ErrorBadParameter;
+        goto EXIT;
+    }
+    pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+
+    for (i = 0; i < ALL_PORT_NUM; i++) {
+        pSECPort = &pSECComponent->pSECPort[i];
+        if ((pSECPort->assignedBufferNum != 0) || (pSECPort->tunneledComponent != NULL)) {
+            ret = OMX_ErrorIncorrectStateOperation;
+            goto EXIT;
+        }
+    }
+
+    for (i = 0; i < ALL_PORT_NUM; i++) {
+        pSECPort = &pSECComponent->pSECPort[i];
+
+        SEC_OSAL_Memset(pSECPort->bufferHeader, 0, sizeof(OMX_BUFFERHEADERTYPE*) * MAX_BUFFER_NUM);
+        SEC_OSAL_Memset(pSECPort->bufferStateAllocate, 0, sizeof(OMX_U32) * MAX_BUFFER_NUM);
+        pSECPort->portState = OMX_StateMax;
+        pSECPort->bIsPortFlushed = OMX_FALSE;
+        pSECPort->bIsPortDisabled = OMX_FALSE;
+        pSECPort->markType.hMarkTargetComponent = NULL;
+        pSECPort->markType.pMarkData = NULL;
+        SEC_OSAL_Memset(&pSECPort->cropRectangle, 0, sizeof(OMX_CONFIG_RECTTYPE));
+        pSECPort->tunneledPort = 0;
+        pSECPort->tunnelBufferNum = 0;
+        pSECPort->bufferSupplier = OMX_BufferSupplyUnspecified;
+        pSECPort->tunnelFlags = 0;
+        pSECPort->eControlRate = OMX_Video_ControlRateDisable;
+        pSECPort->bUseAndroidNativeBuffer = OMX_FALSE;
+        pSECPort->bStoreMetaDataInBuffer = OMX_FALSE;
+
+        cMIMEType = pSECPort->portDefinition.format.video.cMIMEType;
+        SEC_OSAL_Memset(&pSECPort->portDefinition, 0, sizeof(OMX_PARAM_PORTDEFINITIONTYPE));
+        INIT_SET_SIZE_VERSION(&pSECPort->portDefinition, OMX_PARAM_PORTDEFINITIONTYPE);
+        pSECPort->portDefinition.nPortIndex = i;
+        pSECPort->portDefinition.eDir = (i == INPUT_PORT_INDEX) ? OMX_DirInput : OMX_DirOutput;
+        pSECPort->portDefinition.bEnabled = OMX_FALSE;
+        pSECPort->portDefinition.bPopulated = OMX_FALSE;
+        pSECPort->portDefinition.eDomain = OMX_PortDomainMax;
+        pSECPort->portDefinition.format.video.cMIMEType = cMIMEType;
+    }
+
+    pSECComponent->checkTimeStamp.needSetStartTimeStamp = OMX_FALSE;
+    pSECComponent->checkTimeStamp.needCheckStartTimeStamp = OMX_FALSE;
+    pSECComponent->checkTimeStamp.startTimeStamp = 0;
+    pSECComponent->checkTimeStamp.nStartFlags = 0x0;
+
+EXIT:
+    FunctionOut();
+
+    return ret;
+}
+
 OMX_ERRORTYPE SEC_OMX_Port_Destructor(OMX_HANDLETYPE hComponent)
 {
     OMX_ERRORTYPE          ret = OMX_ErrorNone;
@@ -997,7 +1134,7 @@ OMX_ERRORTYPE SEC_OMX_Port_Destructor(OMX_HANDLETYPE hComponent)
         SEC_OSAL_Free(pSECPort->bufferHeader);
         pSECPort->bufferHeader = NULL;
 
-        SEC_OSAL_QueueTerminate(&pSECPort->bufferQ);
+        SEC_OSAL_RingTerminate(&pSECPort->bufferQ);
     }
     SEC_OSAL_Free(pSECComponent->pSECPort);
     pSECComponent->pSECPort = NULL;
@@ -37,6 +37,7 @@
 #define BUFFER_STATE_ALLOCATED  (1 << 0)
 #define BUFFER_STATE_ASSIGNED   (1 << 1)
 #define HEADER_STATE_ALLOCATED  (1 << 2)
+#define BUFFER_STATE_CODEC      (1 << 3)  /* buffer memory is owned by the codec */
 #define BUFFER_STATE_FREE        0
 
 #define MAX_BUFFER_NUM          20
@@ -52,7 +53,7 @@ typedef struct _SEC_OMX_BASEPORT
     OMX_U32                       *bufferStateAllocate;
     OMX_PARAM_PORTDEFINITIONTYPE   portDefinition;
     OMX_HANDLETYPE                 bufferSemID;
-    SEC_QUEUE                      bufferQ;
+    SEC_RING                       bufferQ;
     OMX_U32                        assignedBufferNum;
     OMX_STATETYPE                  portState;
     OMX_HANDLETYPE                 loadedResource;
@@ -89,6 +90,8 @@ OMX_ERRORTYPE SEC_OMX_PortEnableProcess(OMX_COMPONENTTYPE *pOMXComponent, OMX_S3
 OMX_ERRORTYPE SEC_OMX_PortDisableProcess(OMX_COMPONENTTYPE *pOMXComponent, OMX_S32 nPortIndex);
 OMX_ERRORTYPE SEC_OMX_BufferFlushProcess(OMX_COMPONENTTYPE *pOMXComponent, OMX_S32 nPortIndex);
 OMX_ERRORTYPE SEC_OMX_BufferFlushProcessNoEvent(OMX_COMPONENTTYPE *pOMXComponent, OMX_S32 nPortIndex);
+OMX_ERRORTYPE SEC_OMX_PortBufferQueueSetup(SEC_OMX_BASEPORT *pSECPort);
+OMX_ERRORTYPE SEC_OMX_Port_Reset(OMX_HANDLETYPE hComponent);
 
 #ifdef __cplusplus
 };
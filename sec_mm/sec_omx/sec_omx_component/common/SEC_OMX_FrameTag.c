@@ -0,0 +1,171 @@
+/*
+ *
+ * Copyright 2010 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file       SEC_OMX_FrameTag.c
+ * @brief      Frame tag to per frame metadata map
+ * @version    1.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SEC_OMX_FrameTag.h"
+#include "SEC_OSAL_Memory.h"
+
+#undef  SEC_LOG_TAG
+#define SEC_LOG_TAG    "SEC_FRAME_TAG"
+#define SEC_LOG_OFF
+#include "SEC_OSAL_Log.h"
+
+
+/* keeps entry + nSize * generation below 2^31 for any map size */
+#define FRAME_TAG_GENERATION_MASK   0x1FFFFF
+
+OMX_ERRORTYPE SEC_OMX_FrameTagCreate(SEC_OMX_FRAME_TAG_MAP *pMap, OMX_U32 nSize)
+{
+    OMX_ERRORTYPE ret = OMX_ErrorNone;
+
+    FunctionIn();
+
+    if (pMap == NULL) {
+        ret = OMX_ErrorBadParameter;
+        goto EXIT;
+    }
+
+    if (nSize < FRAME_TAG_MAP_MIN_SIZE)
+        nSize = FRAME_TAG_MAP_MIN_SIZE;
+    if (nSize > FRAME_TAG_MAP_MAX_SIZE)
+        nSize = FRAME_TAG_MAP_MAX_SIZE;
+
+    SEC_OSAL_Memset(pMap, 0, sizeof(SEC_OMX_FRAME_TAG_MAP));
+    pMap->pEntry = (SEC_OMX_FRAME_TAG_ENTRY *)SEC_OSAL_Malloc(sizeof(SEC_OMX_FRAME_TAG_ENTRY) * nSize);
+    if (pMap->pEntry == NULL) {
+        ret = OMX_ErrorInsufficientResources;
+        goto EXIT;
+    }
+    SEC_OSAL_Memset(pMap->pEntry, 0, sizeof(SEC_OMX_FRAME_TAG_ENTRY) * nSize);
+    pMap->nSize = nSize;
+
+EXIT:
+    FunctionOut();
+
+    return ret;
+}
+
+OMX_ERRORTYPE SEC_OMX_FrameTagTerminate(SEC_OMX_FRAME_TAG_MAP *pMap)
+{
+    OMX_ERRORTYPE ret = OMX_ErrorNone;
+
+    FunctionIn();
+
+    if (pMap == NULL) {
+        ret = OMX_ErrorBadParameter;
+        goto EXIT;
+    }
+
+    if (pMap->nEvicted > 0)
+        SEC_OSAL_Log(SEC_LOG_TRACE, "%d frame tags were never returned", pMap->nEvicted);
+
+    SEC_OSAL_Free(pMap->pEntry);
+    SEC_OSAL_Memset(pMap, 0, sizeof(SEC_OMX_FRAME_TAG_MAP));
+
+EXIT:
+    FunctionOut();
+
+    return ret;
+}
+
+/* Drops all entries, the generation goes on so tags from before are not matched */
+void SEC_OMX_FrameTagReset(SEC_OMX_FRAME_TAG_MAP *pMap)
+{
+    FunctionIn();
+
+    if ((pMap == NULL) || (pMap->pEntry == NULL))
+        goto EXIT;
+
+    SEC_OSAL_Memset(pMap->pEntry, 0, sizeof(SEC_OMX_FRAME_TAG_ENTRY) * pMap->nSize);
+    pMap->nInUse = 0;
+    pMap->nNextEntry = 0;
+
+EXIT:
+    FunctionOut();
+}
+
+/* Returns the tag to give the MFC with the frame, -1 when there is no map */
+OMX_S32 SEC_OMX_FrameTagPut(SEC_OMX_FRAME_TAG_MAP *pMap, SEC_OMX_FRAME_META *pMeta)
+{
+    SEC_OMX_FRAME_TAG_ENTRY *pEntry = NULL;
+    OMX_U32                  index = 0;
+    OMX_U32                  i = 0;
+
+    if ((pMap == NULL) || (pMap->pEntry == NULL))
+        return -1;
+
+    if (pMap->nInUse == pMap->nSize) {
+        /* the codec dropped some frames without returning their tag */
+        OMX_U32 oldest = 0;
+
+        for (i = 1; i < pMap->nSize; i++) {
+            if ((pMap->nSequence - pMap->pEntry[i].nSequence) >
+                (pMap->nSequence - pMap->pEntry[oldest].nSequence))
+                oldest = i;
+        }
+        pMap->pEntry[oldest].bInUse = OMX_FALSE;
+        pMap->nInUse--;
+        pMap->nEvicted++;
+        pMap->nNextEntry = oldest;
+        SEC_OSAL_Log(SEC_LOG_WARNING, "frame tag %d dropped, timestamp %lld",
+                     pMap->pEntry[oldest].nTag, pMap->pEntry[oldest].meta.timeStamp);
+    }
+
+    index = pMap->nNextEntry;
+    while (pMap->pEntry[index].bInUse == OMX_TRUE)
+        index = (index + 1) % pMap->nSize;
+
+    pEntry = &pMap->pEntry[index];
+    pEntry->bInUse    = OMX_TRUE;
+    pEntry->nSequence = pMap->nSequence;
+    pEntry->nTag      = (OMX_S32)(index + pMap->nSize * (pMap->nSequence & FRAME_TAG_GENERATION_MASK));
+    SEC_OSAL_Memcpy(&pEntry->meta, pMeta, sizeof(SEC_OMX_FRAME_META));
+
+    pMap->nNextEntry = (index + 1) % pMap->nSize;
+    pMap->nSequence++;
+    pMap->nInUse++;
+
+    return pEntry->nTag;
+}
+
+/* Copies out and frees the entry of a tag the MFC returned, OMX_FALSE when it is unknown */
+OMX_BOOL SEC_OMX_FrameTagTake(SEC_OMX_FRAME_TAG_MAP *pMap, OMX_S32 nTag, SEC_OMX_FRAME_META *pMeta)
+{
+    SEC_OMX_FRAME_TAG_ENTRY *pEntry = NULL;
+
+    if ((pMap == NULL) || (pMap->pEntry == NULL) || (nTag < 0))
+        return OMX_FALSE;
+
+    pEntry = &pMap->pEntry[(OMX_U32)nTag % pMap->nSize];
+    if ((pEntry->bInUse != OMX_TRUE) || (pEntry->nTag != nTag))
+        return OMX_FALSE;
+
+    SEC_OSAL_Memcpy(pMeta, &pEntry->meta, sizeof(SEC_OMX_FRAME_META));
+    pEntry->bInUse = OMX_FALSE;
+    pMap->nInUse--;
+
+    return OMX_TRUE;
+}
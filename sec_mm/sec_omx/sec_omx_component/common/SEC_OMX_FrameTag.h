@@ -0,0 +1,84 @@
+/*
+ *
+ * Copyright 2010 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file       SEC_OMX_FrameTag.h
+ * @brief      Frame tag to per frame metadata map
+ * @version    1.0
+ */
+
+#ifndef SEC_OMX_FRAMETAG
+#define SEC_OMX_FRAMETAG
+
+#include "OMX_Types.h"
+#include "OMX_Core.h"
+
+
+#define FRAME_TAG_MAP_MIN_SIZE   17
+#define FRAME_TAG_MAP_MAX_SIZE   64
+
+/* What the client gave with a frame, returned when the MFC hands back its tag */
+typedef struct _SEC_OMX_FRAME_META
+{
+    OMX_TICKS timeStamp;
+    OMX_U32   nFlags;
+    OMX_U32   nStreamSize;     /* bytes handed to the codec */
+    OMX_U64   nSubmitTimeUs;   /* SEC_OSAL_GetSystemTimeUs when handed to the codec */
+    OMX_U64   nEmptyTimeUs;    /* SEC_OSAL_GetSystemTimeUs at EmptyThisBuffer, 0 if unknown */
+} SEC_OMX_FRAME_META;
+
+typedef struct _SEC_OMX_FRAME_TAG_ENTRY
+{
+    OMX_BOOL           bInUse;
+    OMX_S32            nTag;
+    OMX_U32            nSequence;
+    SEC_OMX_FRAME_META meta;
+} SEC_OMX_FRAME_TAG_ENTRY;
+
+/*
+ * A tag is the entry index plus a generation, so a tag the MFC returns
+ * after a flush never matches an entry reused since. Entries are only
+ * freed when their tag comes back; when the map is full the oldest entry
+ * is dropped. Accessed by the buffer process thread, or under the input
+ * port bufferMutex.
+ */
+typedef struct _SEC_OMX_FRAME_TAG_MAP
+{
+    SEC_OMX_FRAME_TAG_ENTRY *pEntry;
+    OMX_U32                  nSize;
+    OMX_U32                  nInUse;
+    OMX_U32                  nNextEntry;
+    OMX_U32                  nSequence;
+    OMX_U32                  nEvicted;   /* entries dropped to make room */
+} SEC_OMX_FRAME_TAG_MAP;
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+OMX_ERRORTYPE SEC_OMX_FrameTagCreate(SEC_OMX_FRAME_TAG_MAP *pMap, OMX_U32 nSize);
+OMX_ERRORTYPE SEC_OMX_FrameTagTerminate(SEC_OMX_FRAME_TAG_MAP *pMap);
+void          SEC_OMX_FrameTagReset(SEC_OMX_FRAME_TAG_MAP *pMap);
+OMX_S32       SEC_OMX_FrameTagPut(SEC_OMX_FRAME_TAG_MAP *pMap, SEC_OMX_FRAME_META *pMeta);
+OMX_BOOL      SEC_OMX_FrameTagTake(SEC_OMX_FRAME_TAG_MAP *pMap, OMX_S32 nTag, SEC_OMX_FRAME_META *pMeta);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif
@@ -30,6 +30,8 @@
 
 #include "SEC_OMX_Resourcemanager.h"
 #include "SEC_OMX_Basecomponent.h"
+#include "SEC_OSAL_Memory.h"
+#include "SEC_OSAL_Mutex.h"
 
 #undef  SEC_LOG_TAG
 #define SEC_LOG_TAG    "SEC_RM"
@@ -37,45 +39,91 @@
 #include "SEC_OSAL_Log.h"
 
 
+/* Max allowable video scheduler component instance */
 #define MAX_RESOURCE_VIDEO 4
 
-/* Max allowable video scheduler component instance */
+/*
+ * Video codec load is counted in macroblocks per second. The MFC runs one
+ * 1920x1088 stream at 30 frames per second.
+ */
+#define RESOURCE_VIDEO_CAPACITY   ((1920 / 16) * (1088 / 16) * 30)
+#define RESOURCE_VIDEO_FRAMERATE  30    /* for ports without xFramerate */
+
 static SEC_OMX_RM_COMPONENT_LIST *gpVideoRMComponentList = NULL;
-static SEC_OMX_RM_COMPONENT_LIST *gpVideoRMWaitingList = NULL;
+static SEC_OMX_RM_COMPONENT_LIST *gpVideoRMWaitingList = NULL;   /* by priority, FIFO in a priority */
 static OMX_HANDLETYPE ghVideoRMComponentListMutex = NULL;
+static OMX_U32 gVideoRMLoad = 0;
+static OMX_U32 gVideoRMInstanceNum = 0;
+
+
+/* Largest picture of the ports at the highest frame rate of the ports, at most the capacity */
+static OMX_U32 computeLoad(OMX_COMPONENTTYPE *pOMXComponent)
+{
+    SEC_OMX_BASECOMPONENT *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    OMX_PARAM_PORTDEFINITIONTYPE *pPortDef = NULL;
+    OMX_U32 mbNum = 0, frameRate = 0, load = 0;
+    OMX_U32 i = 0;
+
+    for (i = 0; i < pSECComponent->portParam.nPorts; i++) {
+        pPortDef = &pSECComponent->pSECPort[i].portDefinition;
+        if (pPortDef->eDomain != OMX_PortDomainVideo)
+            continue;
+        if ((((pPortDef->format.video.nFrameWidth + 15) >> 4) * ((pPortDef->format.video.nFrameHeight + 15) >> 4)) > mbNum)
+            mbNum = ((pPortDef->format.video.nFrameWidth + 15) >> 4) * ((pPortDef->format.video.nFrameHeight + 15) >> 4);
+        if ((pPortDef->format.video.xFramerate >> 16) > frameRate)
+            frameRate = pPortDef->format.video.xFramerate >> 16;
+    }
+    if (frameRate == 0)
+        frameRate = RESOURCE_VIDEO_FRAMERATE;
+
+    load = mbNum * frameRate;
+    if ((mbNum != 0) && ((load / mbNum != frameRate) || (load > RESOURCE_VIDEO_CAPACITY)))
+        load = RESOURCE_VIDEO_CAPACITY;
+
+    return load;
+}
 
+static OMX_BOOL checkFit(OMX_U32 load, OMX_U32 freeLoad, OMX_U32 freeInstanceNum)
+{
+    if ((gVideoRMInstanceNum - freeInstanceNum) >= MAX_RESOURCE_VIDEO)
+        return OMX_FALSE;
+    if ((gVideoRMLoad - freeLoad) + load > RESOURCE_VIDEO_CAPACITY)
+        return OMX_FALSE;
+    return OMX_TRUE;
+}
 
-OMX_ERRORTYPE addElementList(SEC_OMX_RM_COMPONENT_LIST **ppList, OMX_COMPONENTTYPE *pOMXComponent)
+OMX_ERRORTYPE addElementList(SEC_OMX_RM_COMPONENT_LIST **ppList, OMX_COMPONENTTYPE *pOMXComponent, OMX_U32 load)
 {
     OMX_ERRORTYPE              ret = OMX_ErrorNone;
     SEC_OMX_RM_COMPONENT_LIST *pTempComp = NULL;
+    SEC_OMX_RM_COMPONENT_LIST *pNewComp = NULL;
     SEC_OMX_BASECOMPONENT     *pSECComponent = NULL;
 
     pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
-    if (*ppList != NULL) {
-        pTempComp = *ppList;
-        while (pTempComp->pNext != NULL) {
-            pTempComp = pTempComp->pNext;
-        }
-        pTempComp->pNext = (SEC_OMX_RM_COMPONENT_LIST *)SEC_OSAL_Malloc(sizeof(SEC_OMX_RM_COMPONENT_LIST));
-        if (pTempComp->pNext == NULL) {
-            ret = OMX_ErrorInsufficientResources;
-            goto EXIT;
-        }
-        ((SEC_OMX_RM_COMPONENT_LIST *)(pTempComp->pNext))->pNext = NULL;
-        ((SEC_OMX_RM_COMPONENT_LIST *)(pTempComp->pNext))->pOMXStandComp = pOMXComponent;
-        ((SEC_OMX_RM_COMPONENT_LIST *)(pTempComp->pNext))->groupPriority = pSECComponent->compPriority.nGroupPriority;
+    pNewComp = (SEC_OMX_RM_COMPONENT_LIST *)SEC_OSAL_Malloc(sizeof(SEC_OMX_RM_COMPONENT_LIST));
+    if (pNewComp == NULL) {
+        ret = OMX_ErrorInsufficientResources;
         goto EXIT;
+    }
+    pNewComp->pNext = NULL;
+    pNewComp->pOMXStandComp = pOMXComponent;
+    pNewComp->groupPriority = pSECComponent->compPriority.nGroupPriority;
+    pNewComp->load = load;
+    pNewComp->bPreempt = OMX_FALSE;
+    pNewComp->bAcquired = OMX_FALSE;
+
+    /* behind the components of the same or higher priority */
+    if ((*ppList == NULL) || ((*ppList)->groupPriority > pNewComp->groupPriority)) {
+        pNewComp->pNext = *ppList;
+        *ppList = pNewComp;
     } else {
-        *ppList = (SEC_OMX_RM_COMPONENT_LIST *)SEC_OSAL_Malloc(sizeof(SEC_OMX_RM_COMPONENT_LIST));
-        if (*ppList == NULL) {
-            ret = OMX_ErrorInsufficientResources;
-            goto EXIT;
-        }
         pTempComp = *ppList;
-        pTempComp->pNext = NULL;
-        pTempComp->pOMXStandComp = pOMXComponent;
-        pTempComp->groupPriority = pSECComponent->compPriority.nGroupPriority;
+        while ((pTempComp->pNext != NULL) &&
+               (((SEC_OMX_RM_COMPONENT_LIST *)(pTempComp->pNext))->groupPriority <= pNewComp->groupPriority)) {
+            pTempComp = pTempComp->pNext;
+        }
+        pNewComp->pNext = pTempComp->pNext;
+        pTempComp->pNext = pNewComp;
     }
 
 EXIT:
@@ -99,11 +147,14 @@ OMX_ERRORTYPE removeElementList(SEC_OMX_RM_COMPONENT_LIST **ppList, OMX_COMPONEN
         if (pCurrComp->pOMXStandComp == pOMXComponent) {
             if (*ppList == pCurrComp) {
                 *ppList = pCurrComp->pNext;
-                SEC_OSAL_Free(pCurrComp);
             } else {
                 pPrevComp->pNext = pCurrComp->pNext;
-                SEC_OSAL_Free(pCurrComp);
             }
+            if (ppList == &gpVideoRMComponentList) {
+                gVideoRMLoad -= pCurrComp->load;
+                gVideoRMInstanceNum--;
+            }
+            SEC_OSAL_Free(pCurrComp);
             bDetectComp = OMX_TRUE;
             break;
         } else {
@@ -121,11 +172,25 @@ EXIT:
     return ret;
 }
 
+static SEC_OMX_RM_COMPONENT_LIST *findElementList(SEC_OMX_RM_COMPONENT_LIST *pList, OMX_COMPONENTTYPE *pOMXComponent)
+{
+    while ((pList != NULL) && (pList->pOMXStandComp != pOMXComponent))
+        pList = pList->pNext;
+
+    return pList;
+}
+
+/*
+ * Next victim for a component of priority inComp_priority: the lowest
+ * priority one, of those the one with the largest load. Only admitted
+ * components past Loaded are preempted, one in a state transition is not.
+ */
 int searchLowPriority(SEC_OMX_RM_COMPONENT_LIST *RMComp_list, int inComp_priority, SEC_OMX_RM_COMPONENT_LIST **outLowComp)
 {
     int ret = 0;
     SEC_OMX_RM_COMPONENT_LIST *pTempComp = NULL;
     SEC_OMX_RM_COMPONENT_LIST *pCandidateComp = NULL;
+    SEC_OMX_BASECOMPONENT     *pSECComponent = NULL;
 
     if (RMComp_list == NULL)
         ret = -1;
@@ -134,9 +199,16 @@ int searchLowPriority(SEC_OMX_RM_COMPONENT_LIST *RMComp_list, int inComp_priorit
     *outLowComp = 0;
 
     while (pTempComp != NULL) {
-        if (pTempComp->groupPriority > inComp_priority) {
+        pSECComponent = (SEC_OMX_BASECOMPONENT *)pTempComp->pOMXStandComp->pComponentPrivate;
+        if ((pTempComp->groupPriority > inComp_priority) && (pTempComp->bPreempt == OMX_FALSE) &&
+            ((pSECComponent->currentState == OMX_StateIdle) ||
+             (pSECComponent->currentState == OMX_StateExecuting) ||
+             (pSECComponent->currentState == OMX_StatePause)) &&
+            ((pSECComponent->transientState == SEC_OMX_TransStateInvalid) ||
+             (pSECComponent->transientState == SEC_OMX_TransStateMax))) {
             if (pCandidateComp != NULL) {
-                if (pCandidateComp->groupPriority < pTempComp->groupPriority)
+                if ((pCandidateComp->groupPriority < pTempComp->groupPriority) ||
+                    ((pCandidateComp->groupPriority == pTempComp->groupPriority) && (pCandidateComp->load < pTempComp->load)))
                     pCandidateComp = pTempComp;
             } else {
                 pCandidateComp = pTempComp;
@@ -156,6 +228,13 @@ EXIT:
     return ret;
 }
 
+/*
+ * Preempted in Idle the component goes to Loaded. Preempted in Executing
+ * or Pause it goes to Idle, the client then takes it to Loaded, which
+ * closes its MFC instance.
+ * Called without ghVideoRMComponentListMutex, the client may query the
+ * resource manager from its EventHandler.
+ */
 OMX_ERRORTYPE removeComponent(OMX_COMPONENTTYPE *pOMXComponent)
 {
     OMX_ERRORTYPE          ret = OMX_ErrorNone;
@@ -172,7 +251,14 @@ OMX_ERRORTYPE removeComponent(OMX_COMPONENTTYPE *pOMXComponent)
             goto EXIT;
         }
     } else if ((pSECComponent->currentState == OMX_StateExecuting) || (pSECComponent->currentState == OMX_StatePause)) {
-        /* Todo */
+        (*(pSECComponent->pCallbacks->EventHandler))
+            (pOMXComponent, pSECComponent->callbackData,
+            OMX_EventError, OMX_ErrorResourcesPreempted, 0, NULL);
+        ret = OMX_SendCommand(pOMXComponent, OMX_CommandStateSet, OMX_StateIdle, NULL);
+        if (ret != OMX_ErrorNone) {
+            ret = OMX_ErrorUndefined;
+            goto EXIT;
+        }
     }
 
     ret = OMX_ErrorNone;
@@ -181,11 +267,62 @@ EXIT:
     return ret;
 }
 
+/*
+ * Picks waiting components in priority order while the first one fits,
+ * counting those already told and not yet in Idle. Nothing is charged
+ * here: the client allocates the buffers and takes the component to Idle,
+ * which admits it in SEC_OMX_Get_Resource. Called with the mutex held.
+ */
+static OMX_U32 acquireWaitingComponents(OMX_COMPONENTTYPE **ppAcquiredComp)
+{
+    SEC_OMX_RM_COMPONENT_LIST *pComponentTemp = NULL;
+    OMX_U32 load = 0, pendingLoad = 0, pendingInstanceNum = 0;
+    OMX_U32 acquiredNum = 0;
+
+    for (pComponentTemp = gpVideoRMWaitingList; pComponentTemp != NULL; pComponentTemp = pComponentTemp->pNext) {
+        if (pComponentTemp->bAcquired == OMX_TRUE) {
+            pendingLoad += pComponentTemp->load;
+            pendingInstanceNum++;
+            continue;
+        }
+
+        load = computeLoad(pComponentTemp->pOMXStandComp);
+        if (((gVideoRMInstanceNum + pendingInstanceNum) >= MAX_RESOURCE_VIDEO) ||
+            (gVideoRMLoad + pendingLoad + load > RESOURCE_VIDEO_CAPACITY))
+            break;
+
+        pComponentTemp->load = load;
+        pComponentTemp->bAcquired = OMX_TRUE;
+        pendingLoad += load;
+        pendingInstanceNum++;
+        ppAcquiredComp[acquiredNum++] = pComponentTemp->pOMXStandComp;
+        SEC_OSAL_Log(SEC_LOG_TRACE, "resources for waiting component %p, load %d", pComponentTemp->pOMXStandComp, load);
+    }
+
+    return acquiredNum;
+}
+
+/* Called without the mutex, as removeComponent */
+static void notifyAcquiredComponents(OMX_COMPONENTTYPE **ppAcquiredComp, OMX_U32 acquiredNum)
+{
+    SEC_OMX_BASECOMPONENT *pSECComponent = NULL;
+    OMX_U32 i = 0;
+
+    for (i = 0; i < acquiredNum; i++) {
+        pSECComponent = (SEC_OMX_BASECOMPONENT *)ppAcquiredComp[i]->pComponentPrivate;
+        (*(pSECComponent->pCallbacks->EventHandler))
+            (ppAcquiredComp[i], pSECComponent->callbackData,
+            OMX_EventResourcesAcquired, 0, 0, NULL);
+    }
+}
+
 
 OMX_ERRORTYPE SEC_OMX_ResourceManager_Init()
 {
     FunctionIn();
     SEC_OSAL_MutexCreate(&ghVideoRMComponentListMutex);
+    gVideoRMLoad = 0;
+    gVideoRMInstanceNum = 0;
     FunctionOut();
     return OMX_ErrorNone;
 }
@@ -209,6 +346,8 @@ OMX_ERRORTYPE SEC_OMX_ResourceManager_Deinit()
         }
         gpVideoRMComponentList = NULL;
     }
+    gVideoRMLoad = 0;
+    gVideoRMInstanceNum = 0;
 
     if (gpVideoRMWaitingList) {
         pCurrComponent = gpVideoRMWaitingList;
@@ -231,13 +370,24 @@ EXIT:
     return ret;
 }
 
+/*
+ * Admission at Loaded or WaitForResources to Idle. A component that does
+ * not fit preempts lower priority components, but only if that frees
+ * enough, otherwise it gets OMX_ErrorInsufficientResources and nobody is
+ * preempted. A waiting component stays waiting until it is admitted.
+ */
 OMX_ERRORTYPE SEC_OMX_Get_Resource(OMX_COMPONENTTYPE *pOMXComponent)
 {
     OMX_ERRORTYPE              ret = OMX_ErrorNone;
     SEC_OMX_BASECOMPONENT     *pSECComponent = NULL;
     SEC_OMX_RM_COMPONENT_LIST *pComponentTemp = NULL;
     SEC_OMX_RM_COMPONENT_LIST *pComponentCandidate = NULL;
-    int numElem = 0;
+    SEC_OMX_RM_COMPONENT_LIST *pComponentWaiting = NULL;
+    OMX_COMPONENTTYPE         *pPreemptComp[MAX_RESOURCE_VIDEO];
+    OMX_U32 preemptNum = 0;
+    OMX_U32 load = 0;
+    OMX_U32 freeLoad = 0, freeInstanceNum = 0;
+    OMX_U32 i = 0;
     int lowCompDetect = 0;
 
     FunctionIn();
@@ -245,42 +395,54 @@ OMX_ERRORTYPE SEC_OMX_Get_Resource(OMX_COMPONENTTYPE *pOMXComponent)
     SEC_OSAL_MutexLock(ghVideoRMComponentListMutex);
 
     pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
-    pComponentTemp = gpVideoRMComponentList;
     if (pSECComponent->codecType == HW_VIDEO_CODEC) {
-        if (pComponentTemp != NULL) {
-            while (pComponentTemp) {
-                numElem++;
-                pComponentTemp = pComponentTemp->pNext;
-            }
-        } else {
-            numElem = 0;
+        if (findElementList(gpVideoRMComponentList, pOMXComponent) != NULL) {
+            ret = OMX_ErrorNone;
+            goto EXIT;
         }
-        if (numElem >= MAX_RESOURCE_VIDEO) {
+
+        pComponentWaiting = findElementList(gpVideoRMWaitingList, pOMXComponent);
+        load = computeLoad(pOMXComponent);
+        while (checkFit(load, freeLoad, freeInstanceNum) != OMX_TRUE) {
             lowCompDetect = searchLowPriority(gpVideoRMComponentList, pSECComponent->compPriority.nGroupPriority, &pComponentCandidate);
-            if (lowCompDetect <= 0) {
-                ret = OMX_ErrorInsufficientResources;
-                goto EXIT;
-            } else {
-                ret = removeComponent(pComponentCandidate->pOMXStandComp);
-                if (ret != OMX_ErrorNone) {
-                    ret = OMX_ErrorInsufficientResources;
-                    goto EXIT;
-                } else {
-                    ret = removeElementList(&gpVideoRMComponentList, pComponentCandidate->pOMXStandComp);
-                    ret = addElementList(&gpVideoRMComponentList, pOMXComponent);
-                    if (ret != OMX_ErrorNone) {
-                        ret = OMX_ErrorInsufficientResources;
-                        goto EXIT;
-                    }
-                }
-            }
-        } else {
-            ret = addElementList(&gpVideoRMComponentList, pOMXComponent);
-            if (ret != OMX_ErrorNone) {
-                ret = OMX_ErrorInsufficientResources;
-                goto EXIT;
+            if (lowCompDetect <= 0)
+                break;
+            pComponentCandidate->bPreempt = OMX_TRUE;
+            freeLoad += pComponentCandidate->load;
+            freeInstanceNum++;
+        }
+
+        if (checkFit(load, freeLoad, freeInstanceNum) != OMX_TRUE) {
+            for (pComponentTemp = gpVideoRMComponentList; pComponentTemp != NULL; pComponentTemp = pComponentTemp->pNext)
+                pComponentTemp->bPreempt = OMX_FALSE;
+            /* told again once resources are freed */
+            if (pComponentWaiting != NULL)
+                pComponentWaiting->bAcquired = OMX_FALSE;
+            SEC_OSAL_Log(SEC_LOG_TRACE, "refuse load %d, used %d of %d", load, gVideoRMLoad, RESOURCE_VIDEO_CAPACITY);
+            ret = OMX_ErrorInsufficientResources;
+            goto EXIT;
+        }
+
+        pComponentTemp = gpVideoRMComponentList;
+        while (pComponentTemp != NULL) {
+            pComponentCandidate = pComponentTemp;
+            pComponentTemp = pComponentTemp->pNext;
+            if (pComponentCandidate->bPreempt == OMX_TRUE) {
+                SEC_OSAL_Log(SEC_LOG_TRACE, "preempt component %p, load %d", pComponentCandidate->pOMXStandComp, pComponentCandidate->load);
+                pPreemptComp[preemptNum++] = pComponentCandidate->pOMXStandComp;
+                removeElementList(&gpVideoRMComponentList, pComponentCandidate->pOMXStandComp);
             }
         }
+
+        ret = addElementList(&gpVideoRMComponentList, pOMXComponent, load);
+        if (ret != OMX_ErrorNone) {
+            ret = OMX_ErrorInsufficientResources;
+            goto EXIT;
+        }
+        gVideoRMLoad += load;
+        gVideoRMInstanceNum++;
+        if (pComponentWaiting != NULL)
+            removeElementList(&gpVideoRMWaitingList, pOMXComponent);
     }
     ret = OMX_ErrorNone;
 
@@ -288,6 +450,9 @@ EXIT:
 
     SEC_OSAL_MutexUnlock(ghVideoRMComponentListMutex);
 
+    for (i = 0; i < preemptNum; i++)
+        removeComponent(pPreemptComp[i]);
+
     FunctionOut();
 
     return ret;
@@ -297,45 +462,29 @@ OMX_ERRORTYPE SEC_OMX_Release_Resource(OMX_COMPONENTTYPE *pOMXComponent)
 {
     OMX_ERRORTYPE              ret = OMX_ErrorNone;
     SEC_OMX_BASECOMPONENT     *pSECComponent = NULL;
-    SEC_OMX_RM_COMPONENT_LIST *pComponentTemp = NULL;
-    OMX_COMPONENTTYPE         *pOMXWaitComponent = NULL;
-    int numElem = 0;
+    OMX_COMPONENTTYPE         *pAcquiredComp[MAX_RESOURCE_VIDEO];
+    OMX_U32                    acquiredNum = 0;
 
     FunctionIn();
 
     SEC_OSAL_MutexLock(ghVideoRMComponentListMutex);
 
     pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
-    pComponentTemp = gpVideoRMWaitingList;
     if (pSECComponent->codecType == HW_VIDEO_CODEC) {
-        if (gpVideoRMComponentList == NULL) {
-            ret = OMX_ErrorUndefined;
-            goto EXIT;
-        }
-
+        /* not found once preempted, its load is already released */
         ret = removeElementList(&gpVideoRMComponentList, pOMXComponent);
-        if (ret != OMX_ErrorNone) {
+        if (ret != OMX_ErrorNone)
             ret = OMX_ErrorUndefined;
-            goto EXIT;
-        }
-        while (pComponentTemp) {
-            numElem++;
-            pComponentTemp = pComponentTemp->pNext;
-        }
-        if (numElem > 0) {
-            pOMXWaitComponent = gpVideoRMWaitingList->pOMXStandComp;
-            removeElementList(&gpVideoRMWaitingList, pOMXWaitComponent);
-            ret = OMX_SendCommand(pOMXWaitComponent, OMX_CommandStateSet, OMX_StateIdle, NULL);
-            if (ret != OMX_ErrorNone) {
-                goto EXIT;
-            }
-        }
+
+        acquiredNum = acquireWaitingComponents(pAcquiredComp);
     }
 
 EXIT:
 
     SEC_OSAL_MutexUnlock(ghVideoRMComponentListMutex);
 
+    notifyAcquiredComponents(pAcquiredComp, acquiredNum);
+
     FunctionOut();
 
     return ret;
@@ -345,17 +494,25 @@ OMX_ERRORTYPE SEC_OMX_In_WaitForResource(OMX_COMPONENTTYPE *pOMXComponent)
 {
     OMX_ERRORTYPE          ret = OMX_ErrorNone;
     SEC_OMX_BASECOMPONENT *pSECComponent = NULL;
+    OMX_COMPONENTTYPE     *pAcquiredComp[MAX_RESOURCE_VIDEO];
+    OMX_U32                acquiredNum = 0;
 
     FunctionIn();
 
     SEC_OSAL_MutexLock(ghVideoRMComponentListMutex);
 
     pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
-    if (pSECComponent->codecType == HW_VIDEO_CODEC)
-        ret = addElementList(&gpVideoRMWaitingList, pOMXComponent);
+    if (pSECComponent->codecType == HW_VIDEO_CODEC) {
+        ret = addElementList(&gpVideoRMWaitingList, pOMXComponent, 0);
+        /* resources freed since its Loaded to Idle failed */
+        if (ret == OMX_ErrorNone)
+            acquiredNum = acquireWaitingComponents(pAcquiredComp);
+    }
 
     SEC_OSAL_MutexUnlock(ghVideoRMComponentListMutex);
 
+    notifyAcquiredComponents(pAcquiredComp, acquiredNum);
+
     FunctionOut();
 
     return ret;
@@ -381,3 +538,45 @@ OMX_ERRORTYPE SEC_OMX_Out_WaitForResource(OMX_COMPONENTTYPE *pOMXComponent)
     return ret;
 }
 
+/* pOMXComponent NULL for the totals only */
+OMX_ERRORTYPE SEC_OMX_Get_ResourceUtilization(OMX_COMPONENTTYPE *pOMXComponent, SEC_OMX_CONFIG_RESOURCETYPE *pResource)
+{
+    OMX_ERRORTYPE              ret = OMX_ErrorNone;
+    SEC_OMX_RM_COMPONENT_LIST *pComponentTemp = NULL;
+
+    FunctionIn();
+
+    if (pResource == NULL) {
+        ret = OMX_ErrorBadParameter;
+        goto EXIT;
+    }
+
+    SEC_OSAL_MutexLock(ghVideoRMComponentListMutex);
+
+    pResource->nCapacity = RESOURCE_VIDEO_CAPACITY;
+    pResource->nUsed = gVideoRMLoad;
+    pResource->nInstances = gVideoRMInstanceNum;
+    pResource->nMaxInstances = MAX_RESOURCE_VIDEO;
+    pResource->nWaiting = 0;
+    for (pComponentTemp = gpVideoRMWaitingList; pComponentTemp != NULL; pComponentTemp = pComponentTemp->pNext)
+        pResource->nWaiting++;
+
+    pResource->bAdmitted = OMX_FALSE;
+    pResource->nLoad = 0;
+    if (pOMXComponent != NULL) {
+        pComponentTemp = findElementList(gpVideoRMComponentList, pOMXComponent);
+        if (pComponentTemp != NULL) {
+            pResource->bAdmitted = OMX_TRUE;
+            pResource->nLoad = pComponentTemp->load;
+        } else {
+            pResource->nLoad = computeLoad(pOMXComponent);
+        }
+    }
+
+    SEC_OSAL_MutexUnlock(ghVideoRMComponentListMutex);
+
+EXIT:
+    FunctionOut();
+
+    return ret;
+}
@@ -32,12 +32,14 @@
 #include "OMX_Component.h"
 
 
-struct SEC_OMX_RM_COMPONENT_LIST;
 typedef struct _SEC_OMX_RM_COMPONENT_LIST
 {
     OMX_COMPONENTTYPE         *pOMXStandComp;
     OMX_U32                    groupPriority;
-    struct SEC_OMX_RM_COMPONENT_LIST *pNext;
+    OMX_U32                    load;          /* macroblocks per second */
+    OMX_BOOL                   bPreempt;      /* chosen as victim by SEC_OMX_Get_Resource */
+    OMX_BOOL                   bAcquired;     /* waiting, told OMX_EventResourcesAcquired */
+    struct _SEC_OMX_RM_COMPONENT_LIST *pNext;
 } SEC_OMX_RM_COMPONENT_LIST;
 
 
@@ -51,6 +53,7 @@ OMX_ERRORTYPE SEC_OMX_Get_Resource(OMX_COMPONENTTYPE *pOMXComponent);
 OMX_ERRORTYPE SEC_OMX_Release_Resource(OMX_COMPONENTTYPE *pOMXComponent);
 OMX_ERRORTYPE SEC_OMX_In_WaitForResource(OMX_COMPONENTTYPE *pOMXComponent);
 OMX_ERRORTYPE SEC_OMX_Out_WaitForResource(OMX_COMPONENTTYPE *pOMXComponent);
+OMX_ERRORTYPE SEC_OMX_Get_ResourceUtilization(OMX_COMPONENTTYPE *pOMXComponent, SEC_OMX_CONFIG_RESOURCETYPE *pResource);
 
 #ifdef __cplusplus
 };
@@ -0,0 +1,327 @@
+/*
+ *
+ * Copyright 2010 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file       SEC_OMX_Stats.c
+ * @brief      Per frame latency and throughput statistics
+ * @version    1.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "SEC_OMX_Stats.h"
+#include "SEC_OSAL_Memory.h"
+#include "SEC_OSAL_Mutex.h"
+#include "SEC_OSAL_Thread.h"
+
+#undef  SEC_LOG_TAG
+#define SEC_LOG_TAG    "SEC_STATS"
+#define SEC_LOG_OFF
+#include "SEC_OSAL_Log.h"
+
+
+static const char *statsStageName[SEC_OMX_STATS_STAGE_NUM] = {
+    "input_wait",
+    "framing",
+    "mfc",
+    "reorder",
+    "csc",
+    "total"
+};
+
+static void SEC_OMX_StatsClear(SEC_OMX_STATS_DATA *pStats)
+{
+    SEC_OSAL_Memset(&pStats->stats, 0, sizeof(SEC_OMX_CONFIG_STATSTYPE));
+    pStats->stats.nSize = sizeof(SEC_OMX_CONFIG_STATSTYPE);
+    pStats->stats.nVersion.s.nVersionMajor = VERSIONMAJOR_NUMBER;
+    pStats->stats.nVersion.s.nVersionMinor = VERSIONMINOR_NUMBER;
+    pStats->stats.nVersion.s.nRevision = REVISION_NUMBER;
+    pStats->stats.nVersion.s.nStep = STEP_NUMBER;
+    pStats->nFirstEmptyTimeUs = 0;
+    pStats->nLastFillTimeUs = 0;
+}
+
+static void SEC_OMX_StatsHistogramAdd(SEC_OMX_STATS_HISTOGRAM *pHistogram, OMX_U32 timeUs)
+{
+    OMX_U32 value = timeUs / SEC_OMX_STATS_BUCKET_BASE_US;
+    OMX_U32 bucket = 0;
+    OMX_U32 i = 0;
+
+    if (pHistogram->nCount >= SEC_OMX_STATS_WINDOW) {
+        pHistogram->nCount = 0;
+        for (i = 0; i < SEC_OMX_STATS_BUCKET_NUM; i++) {
+            pHistogram->nBucket[i] >>= 1;
+            pHistogram->nCount += pHistogram->nBucket[i];
+        }
+        pHistogram->nTotalUs >>= 1;
+        pHistogram->nMinUs = timeUs;
+        pHistogram->nMaxUs = timeUs;
+    }
+
+    while ((value > 0) && (bucket < (SEC_OMX_STATS_BUCKET_NUM - 1))) {
+        value >>= 1;
+        bucket++;
+    }
+
+    if ((pHistogram->nCount == 0) || (timeUs < pHistogram->nMinUs))
+        pHistogram->nMinUs = timeUs;
+    if ((pHistogram->nCount == 0) || (timeUs > pHistogram->nMaxUs))
+        pHistogram->nMaxUs = timeUs;
+    pHistogram->nBucket[bucket]++;
+    pHistogram->nTotalUs += timeUs;
+    pHistogram->nCount++;
+}
+
+static void SEC_OMX_StatsSample(SEC_OMX_STATS_DATA *pStats, SEC_OMX_STATS_STAGE stage, OMX_U64 nStartTimeUs, OMX_U64 nEndTimeUs)
+{
+    OMX_U64 timeUs = 0;
+
+    if ((nStartTimeUs == 0) || (nEndTimeUs < nStartTimeUs) || (stage >= SEC_OMX_STATS_STAGE_NUM))
+        return;
+
+    timeUs = nEndTimeUs - nStartTimeUs;
+    if (timeUs > 0xFFFFFFFF)
+        timeUs = 0xFFFFFFFF;
+    SEC_OMX_StatsHistogramAdd(&pStats->stats.stage[stage], (OMX_U32)timeUs);
+}
+
+OMX_ERRORTYPE SEC_OMX_StatsCreate(SEC_OMX_STATS_DATA *pStats)
+{
+    OMX_ERRORTYPE ret = OMX_ErrorNone;
+
+    FunctionIn();
+
+    if (pStats == NULL) {
+        ret = OMX_ErrorBadParameter;
+        goto EXIT;
+    }
+
+    SEC_OSAL_Memset(pStats, 0, sizeof(SEC_OMX_STATS_DATA));
+    ret = SEC_OSAL_MutexCreate(&pStats->hMutex);
+    if (ret != OMX_ErrorNone) {
+        pStats->hMutex = NULL;
+        goto EXIT;
+    }
+    SEC_OMX_StatsClear(pStats);
+
+EXIT:
+    FunctionOut();
+
+    return ret;
+}
+
+OMX_ERRORTYPE SEC_OMX_StatsTerminate(SEC_OMX_STATS_DATA *pStats)
+{
+    OMX_ERRORTYPE ret = OMX_ErrorNone;
+
+    FunctionIn();
+
+    if ((pStats == NULL) || (pStats->hMutex == NULL)) {
+        ret = OMX_ErrorBadParameter;
+        goto EXIT;
+    }
+
+    SEC_OSAL_MutexTerminate(pStats->hMutex);
+    SEC_OSAL_Memset(pStats, 0, sizeof(SEC_OMX_STATS_DATA));
+
+EXIT:
+    FunctionOut();
+
+    return ret;
+}
+
+/* Clears the counters and histograms, buffers already emptied keep their time */
+void SEC_OMX_StatsReset(SEC_OMX_STATS_DATA *pStats)
+{
+    if ((pStats == NULL) || (pStats->hMutex == NULL))
+        return;
+
+    SEC_OSAL_MutexLock(pStats->hMutex);
+    SEC_OMX_StatsClear(pStats);
+    SEC_OSAL_MutexUnlock(pStats->hMutex);
+}
+
+/* EmptyThisBuffer of input port buffer nIndex */
+void SEC_OMX_StatsInputEmptied(SEC_OMX_STATS_DATA *pStats, OMX_U32 nIndex)
+{
+    OMX_U64 nowUs = 0;
+
+    if ((pStats == NULL) || (pStats->hMutex == NULL) || (nIndex >= MAX_BUFFER_NUM))
+        return;
+
+    nowUs = SEC_OSAL_GetSystemTimeUs();
+    SEC_OSAL_MutexLock(pStats->hMutex);
+    pStats->emptyTimeUs[nIndex] = nowUs;
+    if (pStats->nFirstEmptyTimeUs == 0)
+        pStats->nFirstEmptyTimeUs = nowUs;
+    SEC_OSAL_MutexUnlock(pStats->hMutex);
+}
+
+/* Input port buffer nIndex taken by the buffer process thread, returns its EmptyThisBuffer time */
+OMX_U64 SEC_OMX_StatsInputTaken(SEC_OMX_STATS_DATA *pStats, OMX_U32 nIndex)
+{
+    OMX_U64 emptyTimeUs = 0;
+
+    if ((pStats == NULL) || (pStats->hMutex == NULL) || (nIndex >= MAX_BUFFER_NUM))
+        return 0;
+
+    SEC_OSAL_MutexLock(pStats->hMutex);
+    emptyTimeUs = pStats->emptyTimeUs[nIndex];
+    pStats->emptyTimeUs[nIndex] = 0;
+    SEC_OMX_StatsSample(pStats, SEC_OMX_STATS_INPUT_WAIT, emptyTimeUs, SEC_OSAL_GetSystemTimeUs());
+    SEC_OSAL_MutexUnlock(pStats->hMutex);
+
+    return emptyTimeUs;
+}
+
+/* Adds one sample of stage, from nStartTimeUs until now. Returns now */
+OMX_U64 SEC_OMX_StatsAdd(SEC_OMX_STATS_DATA *pStats, SEC_OMX_STATS_STAGE stage, OMX_U64 nStartTimeUs)
+{
+    OMX_U64 nowUs = SEC_OSAL_GetSystemTimeUs();
+
+    if ((pStats == NULL) || (pStats->hMutex == NULL))
+        return nowUs;
+
+    SEC_OSAL_MutexLock(pStats->hMutex);
+    SEC_OMX_StatsSample(pStats, stage, nStartTimeUs, nowUs);
+    SEC_OSAL_MutexUnlock(pStats->hMutex);
+
+    return nowUs;
+}
+
+/* A frame of nBytes handed to the codec */
+void SEC_OMX_StatsFrameIn(SEC_OMX_STATS_DATA *pStats, OMX_U32 nBytes)
+{
+    if ((pStats == NULL) || (pStats->hMutex == NULL))
+        return;
+
+    SEC_OSAL_MutexLock(pStats->hMutex);
+    pStats->stats.nFramesIn++;
+    pStats->stats.nBytesIn += nBytes;
+    SEC_OSAL_MutexUnlock(pStats->hMutex);
+}
+
+/* FillBufferDone of a frame whose input was emptied at nEmptyTimeUs */
+void SEC_OMX_StatsFrameOut(SEC_OMX_STATS_DATA *pStats, OMX_U64 nEmptyTimeUs)
+{
+    OMX_U64 nowUs = 0;
+
+    if ((pStats == NULL) || (pStats->hMutex == NULL))
+        return;
+
+    nowUs = SEC_OSAL_GetSystemTimeUs();
+    SEC_OSAL_MutexLock(pStats->hMutex);
+    pStats->stats.nFramesOut++;
+    pStats->nLastFillTimeUs = nowUs;
+    SEC_OMX_StatsSample(pStats, SEC_OMX_STATS_TOTAL, nEmptyTimeUs, nowUs);
+    SEC_OSAL_MutexUnlock(pStats->hMutex);
+}
+
+OMX_ERRORTYPE SEC_OMX_StatsGet(SEC_OMX_STATS_DATA *pStats, SEC_OMX_CONFIG_STATSTYPE *pConfig)
+{
+    OMX_ERRORTYPE ret = OMX_ErrorNone;
+
+    FunctionIn();
+
+    if ((pStats == NULL) || (pStats->hMutex == NULL) || (pConfig == NULL)) {
+        ret = OMX_ErrorBadParameter;
+        goto EXIT;
+    }
+
+    SEC_OSAL_MutexLock(pStats->hMutex);
+    SEC_OSAL_Memcpy(pConfig, &pStats->stats, sizeof(SEC_OMX_CONFIG_STATSTYPE));
+    if ((pStats->nFirstEmptyTimeUs != 0) && (pStats->nLastFillTimeUs > pStats->nFirstEmptyTimeUs))
+        pConfig->nElapsedUs = pStats->nLastFillTimeUs - pStats->nFirstEmptyTimeUs;
+    SEC_OSAL_MutexUnlock(pStats->hMutex);
+
+EXIT:
+    FunctionOut();
+
+    return ret;
+}
+
+/* Appends a text report to a file of SEC_OMX_STATS_DUMP_DIR, never to a path of the IL client */
+OMX_ERRORTYPE SEC_OMX_StatsDump(SEC_OMX_STATS_DATA *pStats, OMX_STRING componentName)
+{
+    OMX_ERRORTYPE            ret = OMX_ErrorNone;
+    SEC_OMX_CONFIG_STATSTYPE stats;
+    SEC_OMX_STATS_HISTOGRAM *pHistogram = NULL;
+    FILE                    *fp = NULL;
+    char                     fileName[128];
+    OMX_U32                  stage = 0;
+    OMX_U32                  i = 0;
+
+    FunctionIn();
+
+    if ((componentName == NULL) || (strchr(componentName, '/') != NULL)) {
+        ret = OMX_ErrorBadParameter;
+        goto EXIT;
+    }
+
+    ret = SEC_OMX_StatsGet(pStats, &stats);
+    if (ret != OMX_ErrorNone)
+        goto EXIT;
+
+    snprintf(fileName, sizeof(fileName), "%s/%s.%d.stats", SEC_OMX_STATS_DUMP_DIR, componentName, (int)getpid());
+    fp = fopen(fileName, "a");
+    if (fp == NULL) {
+        SEC_OSAL_Log(SEC_LOG_ERROR, "can not open %s", fileName);
+        ret = OMX_ErrorUndefined;
+        goto EXIT;
+    }
+
+    fprintf(fp, "%s\n", componentName);
+    fprintf(fp, "frames in %lu, out %lu, bytes in %llu, elapsed %llu us",
+            (unsigned long)stats.nFramesIn, (unsigned long)stats.nFramesOut,
+            (unsigned long long)stats.nBytesIn, (unsigned long long)stats.nElapsedUs);
+    if (stats.nElapsedUs > 0)
+        fprintf(fp, ", %.2f fps", (double)stats.nFramesOut * 1E6 / (double)stats.nElapsedUs);
+    fprintf(fp, "\n");
+
+    for (stage = 0; stage < SEC_OMX_STATS_STAGE_NUM; stage++) {
+        pHistogram = &stats.stage[stage];
+        if (pHistogram->nCount == 0)
+            continue;
+
+        fprintf(fp, "  %-10s count %lu, min %lu us, avg %llu us, max %lu us\n   ",
+                statsStageName[stage], (unsigned long)pHistogram->nCount,
+                (unsigned long)pHistogram->nMinUs,
+                (unsigned long long)(pHistogram->nTotalUs / pHistogram->nCount),
+                (unsigned long)pHistogram->nMaxUs);
+        for (i = 0; i < SEC_OMX_STATS_BUCKET_NUM; i++) {
+            if (pHistogram->nBucket[i] == 0)
+                continue;
+            if (i < (SEC_OMX_STATS_BUCKET_NUM - 1))
+                fprintf(fp, " <%lu:%lu", (unsigned long)SEC_OMX_STATS_BUCKET_BASE_US << i,
+                        (unsigned long)pHistogram->nBucket[i]);
+            else
+                fprintf(fp, " >=%lu:%lu", (unsigned long)SEC_OMX_STATS_BUCKET_BASE_US << (i - 1),
+                        (unsigned long)pHistogram->nBucket[i]);
+        }
+        fprintf(fp, "\n");
+    }
+
+    fclose(fp);
+
+EXIT:
+    FunctionOut();
+
+    return ret;
+}
@@ -0,0 +1,69 @@
+/*
+ *
+ * Copyright 2010 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file       SEC_OMX_Stats.h
+ * @brief      Per frame latency and throughput statistics
+ * @version    1.0
+ */
+
+#ifndef SEC_OMX_STATS
+#define SEC_OMX_STATS
+
+#include "OMX_Types.h"
+#include "OMX_Core.h"
+#include "SEC_OMX_Def.h"
+#include "SEC_OMX_Baseport.h"
+
+/* OMX_IndexVendorStatisticsDump appends to <dir>/<component name>.<pid>.stats */
+#define SEC_OMX_STATS_DUMP_DIR "/data/local/tmp"
+
+/*
+ * Updated from EmptyThisBuffer, the buffer process thread, the MFC
+ * decode/encode thread and the output thread, so every call takes hMutex.
+ * Times are SEC_OSAL_GetSystemTimeUs, 0 stands for unknown.
+ */
+typedef struct _SEC_OMX_STATS_DATA
+{
+    OMX_HANDLETYPE           hMutex;
+    SEC_OMX_CONFIG_STATSTYPE stats;
+    OMX_U64                  nFirstEmptyTimeUs;
+    OMX_U64                  nLastFillTimeUs;
+    OMX_U64                  emptyTimeUs[MAX_BUFFER_NUM];  /* by input port buffer index */
+} SEC_OMX_STATS_DATA;
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+OMX_ERRORTYPE SEC_OMX_StatsCreate(SEC_OMX_STATS_DATA *pStats);
+OMX_ERRORTYPE SEC_OMX_StatsTerminate(SEC_OMX_STATS_DATA *pStats);
+void          SEC_OMX_StatsReset(SEC_OMX_STATS_DATA *pStats);
+void          SEC_OMX_StatsInputEmptied(SEC_OMX_STATS_DATA *pStats, OMX_U32 nIndex);
+OMX_U64       SEC_OMX_StatsInputTaken(SEC_OMX_STATS_DATA *pStats, OMX_U32 nIndex);
+OMX_U64       SEC_OMX_StatsAdd(SEC_OMX_STATS_DATA *pStats, SEC_OMX_STATS_STAGE stage, OMX_U64 nStartTimeUs);
+void          SEC_OMX_StatsFrameIn(SEC_OMX_STATS_DATA *pStats, OMX_U32 nBytes);
+void          SEC_OMX_StatsFrameOut(SEC_OMX_STATS_DATA *pStats, OMX_U64 nEmptyTimeUs);
+OMX_ERRORTYPE SEC_OMX_StatsGet(SEC_OMX_STATS_DATA *pStats, SEC_OMX_CONFIG_STATSTYPE *pConfig);
+OMX_ERRORTYPE SEC_OMX_StatsDump(SEC_OMX_STATS_DATA *pStats, OMX_STRING componentName);
+
+#ifdef __cplusplus
+};
+#endif
+
+#endif
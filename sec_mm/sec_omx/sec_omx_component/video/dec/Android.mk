@@ -18,3 +18,28 @@ LOCAL_C_INCLUDES := $(SEC_OMX_INC)/khronos \
 LOCAL_C_INCLUDES += $(SEC_OMX_TOP)/sec_codecs/video/mfc_c110/include
 
 include $(BUILD_STATIC_LIBRARY)
+
+#########################################################################
+# Build Vdec for host, on the MFC simulator
+#########################################################################
+
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES := \
+	SEC_OMX_Vdec.c
+
+LOCAL_MODULE := libSEC_OMX_Vdec_host
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_CFLAGS := -DUSE_MFC_SIM
+
+LOCAL_C_INCLUDES := $(SEC_OMX_INC)/khronos \
+	$(SEC_OMX_INC)/sec \
+	$(SEC_OMX_TOP)/sec_osal \
+	$(SEC_OMX_TOP)/sec_omx_core \
+	$(SEC_OMX_COMPONENT)/common \
+	$(SEC_OMX_COMPONENT)/video/dec
+
+LOCAL_C_INCLUDES += $(SEC_OMX_TOP)/sec_codecs/video/mfc_c110/include
+
+include $(BUILD_HOST_STATIC_LIBRARY)
@@ -31,9 +31,12 @@
 #include <string.h>
 #include "SEC_OMX_Macros.h"
 #include "SEC_OSAL_Event.h"
+#include "SEC_OSAL_Semaphore.h"
+#include "SEC_OSAL_Mutex.h"
 #include "SEC_OMX_Vdec.h"
 #include "SEC_OMX_Basecomponent.h"
 #include "SEC_OSAL_Thread.h"
+#include "SsbSipMfcApi.h"
 #include "color_space_convertor.h"
 
 #undef  SEC_LOG_TAG
@@ -128,6 +131,12 @@ OMX_ERRORTYPE SEC_OMX_UseBuffer(
         goto EXIT;
     }
 
+    if (pSECPort->assignedBufferNum == 0) {
+        ret = SEC_OMX_PortBufferQueueSetup(pSECPort);
+        if (ret != OMX_ErrorNone)
+            goto EXIT;
+    }
+
     temp_bufferHeader = (OMX_BUFFERHEADERTYPE *)SEC_OSAL_Malloc(sizeof(OMX_BUFFERHEADERTYPE));
     if (temp_bufferHeader == NULL) {
         ret = OMX_ErrorInsufficientResources;
@@ -183,6 +192,8 @@ OMX_ERRORTYPE SEC_OMX_AllocateBuffer(
     SEC_OMX_BASEPORT      *pSECPort = NULL;
     OMX_BUFFERHEADERTYPE  *temp_bufferHeader = NULL;
     OMX_U8                *temp_buffer = NULL;
+    OMX_PTR                temp_phyBuffer = NULL;
+    OMX_U32                bufferState = BUFFER_STATE_ALLOCATED;
     int                    i = 0;
 
     FunctionIn();
@@ -219,15 +230,39 @@ OMX_ERRORTYPE SEC_OMX_AllocateBuffer(
         goto EXIT;
     }
 
-    temp_buffer = SEC_OSAL_Malloc(sizeof(OMX_U8) * nSizeBytes);
+    if (pSECPort->assignedBufferNum == 0) {
+        ret = SEC_OMX_PortBufferQueueSetup(pSECPort);
+        if (ret != OMX_ErrorNone)
+            goto EXIT;
+    }
+
+    /* Input buffers in the codec's stream memory are read by the MFC in place */
+    if ((nPortIndex == INPUT_PORT_INDEX) && (pSECComponent->sec_mfc_allocateInputBuffer != NULL)) {
+        for (i = 0; i < pSECPort->portDefinition.nBufferCountActual; i++) {
+            if (pSECPort->bufferStateAllocate[i] == BUFFER_STATE_FREE)
+                break;
+        }
+        if (pSECComponent->sec_mfc_allocateInputBuffer(pOMXComponent, i, nSizeBytes, &temp_buffer, &temp_phyBuffer) == OMX_ErrorNone) {
+            bufferState = BUFFER_STATE_CODEC;
+        } else {
+            SEC_OSAL_Log(SEC_LOG_WARNING, "input buffer %d (%d bytes) is copied to the codec", i, nSizeBytes);
+            temp_buffer = NULL;
+            temp_phyBuffer = NULL;
+        }
+    }
+
     if (temp_buffer == NULL) {
-        ret = OMX_ErrorInsufficientResources;
-        goto EXIT;
+        temp_buffer = SEC_OSAL_Malloc(sizeof(OMX_U8) * nSizeBytes);
+        if (temp_buffer == NULL) {
+            ret = OMX_ErrorInsufficientResources;
+            goto EXIT;
+        }
     }
 
     temp_bufferHeader = (OMX_BUFFERHEADERTYPE *)SEC_OSAL_Malloc(sizeof(OMX_BUFFERHEADERTYPE));
     if (temp_bufferHeader == NULL) {
-        SEC_OSAL_Free(temp_buffer);
+        if (bufferState == BUFFER_STATE_ALLOCATED)
+            SEC_OSAL_Free(temp_buffer);
         temp_buffer = NULL;
         ret = OMX_ErrorInsufficientResources;
         goto EXIT;
@@ -237,15 +272,17 @@ OMX_ERRORTYPE SEC_OMX_AllocateBuffer(
     for (i = 0; i < pSECPort->portDefinition.nBufferCountActual; i++) {
         if (pSECPort->bufferStateAllocate[i] == BUFFER_STATE_FREE) {
             pSECPort->bufferHeader[i] = temp_bufferHeader;
-            pSECPort->bufferStateAllocate[i] = (BUFFER_STATE_ALLOCATED | HEADER_STATE_ALLOCATED);
+            pSECPort->bufferStateAllocate[i] = (bufferState | HEADER_STATE_ALLOCATED);
             INIT_SET_SIZE_VERSION(temp_bufferHeader, OMX_BUFFERHEADERTYPE);
             temp_bufferHeader->pBuffer        = temp_buffer;
             temp_bufferHeader->nAllocLen      = nSizeBytes;
             temp_bufferHeader->pAppPrivate    = pAppPrivate;
-            if ( nPortIndex == INPUT_PORT_INDEX)
+            if ( nPortIndex == INPUT_PORT_INDEX) {
                 temp_bufferHeader->nInputPortIndex = INPUT_PORT_INDEX;
-            else
+                temp_bufferHeader->pInputPortPrivate = temp_phyBuffer;
+            } else {
                 temp_bufferHeader->nOutputPortIndex = OUTPUT_PORT_INDEX;
+            }
             pSECPort->assignedBufferNum++;
             if (pSECPort->assignedBufferNum == pSECPort->portDefinition.nBufferCountActual) {
                 pSECPort->portDefinition.bPopulated = OMX_TRUE;
@@ -260,7 +297,8 @@ OMX_ERRORTYPE SEC_OMX_AllocateBuffer(
     }
 
     SEC_OSAL_Free(temp_bufferHeader);
-    SEC_OSAL_Free(temp_buffer);
+    if (bufferState == BUFFER_STATE_ALLOCATED)
+        SEC_OSAL_Free(temp_buffer);
     ret = OMX_ErrorInsufficientResources;
 
 EXIT:
@@ -321,6 +359,11 @@ OMX_ERRORTYPE SEC_OMX_FreeBuffer(
                     SEC_OSAL_Free(pSECPort->bufferHeader[i]->pBuffer);
                     pSECPort->bufferHeader[i]->pBuffer = NULL;
                     pBufferHdr->pBuffer = NULL;
+                } else if (pSECPort->bufferStateAllocate[i] & BUFFER_STATE_CODEC) {
+                    /* stream memory of the codec, released with the MFC */
+                    pSECPort->bufferHeader[i]->pBuffer = NULL;
+                    pSECPort->bufferHeader[i]->pInputPortPrivate = NULL;
+                    pBufferHdr->pBuffer = NULL;
                 } else if (pSECPort->bufferStateAllocate[i] & BUFFER_STATE_ASSIGNED) {
                     ; /* None*/
                 }
@@ -407,13 +450,15 @@ OMX_BOOL SEC_Check_BufferProcess_State(SEC_OMX_BASECOMPONENT *pSECComponent)
     }
 }
 
-static OMX_ERRORTYPE SEC_InputBufferReturn(OMX_COMPONENTTYPE *pOMXComponent)
+/* bLend: the codec still reads the buffer, it goes back from SEC_MFC_DecInputRelease */
+static OMX_ERRORTYPE SEC_InputBufferRelease(OMX_COMPONENTTYPE *pOMXComponent, OMX_BOOL bLend)
 {
     OMX_ERRORTYPE          ret = OMX_ErrorNone;
     SEC_OMX_BASECOMPONENT *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
     SEC_OMX_BASEPORT      *secOMXInputPort = &pSECComponent->pSECPort[INPUT_PORT_INDEX];
     SEC_OMX_BASEPORT      *secOMXOutputPort = &pSECComponent->pSECPort[OUTPUT_PORT_INDEX];
     SEC_OMX_DATABUFFER    *dataBuffer = &pSECComponent->secDataBuffer[INPUT_PORT_INDEX];
+    SEC_OMX_DATA          *inputData = &pSECComponent->processData[INPUT_PORT_INDEX];
     OMX_BUFFERHEADERTYPE  *bufferHeader = dataBuffer->bufferHeader;
 
     FunctionIn();
@@ -438,7 +483,10 @@ static OMX_ERRORTYPE SEC_InputBufferReturn(OMX_COMPONENTTYPE *pOMXComponent)
             }
         }
 
-        if (CHECK_PORT_TUNNELED(secOMXInputPort)) {
+        if (bLend == OMX_TRUE) {
+            inputData->bufferHeader  = bufferHeader;
+            inputData->dataPhyBuffer = bufferHeader->pInputPortPrivate;
+        } else if (CHECK_PORT_TUNNELED(secOMXInputPort)) {
             OMX_FillThisBuffer(secOMXInputPort->tunneledComponent, bufferHeader);
         } else {
             bufferHeader->nFilledLen = 0;
@@ -459,6 +507,7 @@ static OMX_ERRORTYPE SEC_InputBufferReturn(OMX_COMPONENTTYPE *pOMXComponent)
     dataBuffer->bufferHeader  = NULL;
     dataBuffer->nFlags        = 0;
     dataBuffer->timeStamp     = 0;
+    dataBuffer->nEmptyTimeUs  = 0;
 
 EXIT:
     FunctionOut();
@@ -466,6 +515,11 @@ EXIT:
     return ret;
 }
 
+static OMX_ERRORTYPE SEC_InputBufferReturn(OMX_COMPONENTTYPE *pOMXComponent)
+{
+    return SEC_InputBufferRelease(pOMXComponent, OMX_FALSE);
+}
+
 OMX_ERRORTYPE SEC_InputBufferGetQueue(SEC_OMX_BASECOMPONENT *pSECComponent)
 {
     OMX_ERRORTYPE       ret = OMX_ErrorNone;
@@ -486,7 +540,7 @@ OMX_ERRORTYPE SEC_InputBufferGetQueue(SEC_OMX_BASECOMPONENT *pSECComponent)
         SEC_OSAL_SemaphoreWait(pSECPort->bufferSemID);
         SEC_OSAL_MutexLock(inputUseBuffer->bufferMutex);
         if (dataBuffer->dataValid != OMX_TRUE) {
-            message = (SEC_OMX_MESSAGE *)SEC_OSAL_Dequeue(&pSECPort->bufferQ);
+            message = (SEC_OMX_MESSAGE *)SEC_OSAL_RingGet(&pSECPort->bufferQ);
             if (message == NULL) {
                 ret = OMX_ErrorUndefined;
                 SEC_OSAL_MutexUnlock(inputUseBuffer->bufferMutex);
@@ -501,8 +555,9 @@ OMX_ERRORTYPE SEC_InputBufferGetQueue(SEC_OMX_BASECOMPONENT *pSECComponent)
             dataBuffer->dataValid = OMX_TRUE;
             dataBuffer->nFlags = dataBuffer->bufferHeader->nFlags;
             dataBuffer->timeStamp = dataBuffer->bufferHeader->nTimeStamp;
+            dataBuffer->nEmptyTimeUs = SEC_OMX_StatsInputTaken(&pSECComponent->stats, message->messageParam);
 
-            SEC_OSAL_Free(message);
+            SEC_OSAL_PoolFree(pSECComponent->hMemoryPool, message);
 
             if (dataBuffer->allocSize <= dataBuffer->dataLen)
                 SEC_OSAL_Log(SEC_LOG_WARNING, "Input Buffer Full, Check input buffer size! allocSize:%d, dataLen:%d", dataBuffer->allocSize, dataBuffer->dataLen);
@@ -548,6 +603,9 @@ static OMX_ERRORTYPE SEC_OutputBufferReturn(OMX_COMPONENTTYPE *pOMXComponent)
                             bufferHeader->nFlags, NULL);
         }
 
+        if (bufferHeader->nFilledLen > 0)
+            SEC_OMX_StatsFrameOut(&pSECComponent->stats, dataBuffer->nEmptyTimeUs);
+
         if (CHECK_PORT_TUNNELED(secOMXOutputPort)) {
             OMX_EmptyThisBuffer(secOMXOutputPort->tunneledComponent, bufferHeader);
         } else {
@@ -569,6 +627,7 @@ static OMX_ERRORTYPE SEC_OutputBufferReturn(OMX_COMPONENTTYPE *pOMXComponent)
     dataBuffer->bufferHeader  = NULL;
     dataBuffer->nFlags        = 0;
     dataBuffer->timeStamp     = 0;
+    dataBuffer->nEmptyTimeUs  = 0;
 
 EXIT:
     FunctionOut();
@@ -596,7 +655,7 @@ OMX_ERRORTYPE SEC_OutputBufferGetQueue(SEC_OMX_BASECOMPONENT *pSECComponent)
         SEC_OSAL_SemaphoreWait(pSECPort->bufferSemID);
         SEC_OSAL_MutexLock(outputUseBuffer->bufferMutex);
         if (dataBuffer->dataValid != OMX_TRUE) {
-            message = (SEC_OMX_MESSAGE *)SEC_OSAL_Dequeue(&pSECPort->bufferQ);
+            message = (SEC_OMX_MESSAGE *)SEC_OSAL_RingGet(&pSECPort->bufferQ);
             if (message == NULL) {
                 ret = OMX_ErrorUndefined;
                 SEC_OSAL_MutexUnlock(outputUseBuffer->bufferMutex);
@@ -614,7 +673,7 @@ OMX_ERRORTYPE SEC_OutputBufferGetQueue(SEC_OMX_BASECOMPONENT *pSECComponent)
             pSECComponent->processData[OUTPUT_PORT_INDEX].dataBuffer = dataBuffer->bufferHeader->pBuffer;
             pSECComponent->processData[OUTPUT_PORT_INDEX].allocSize = dataBuffer->bufferHeader->nAllocLen;
 
-            SEC_OSAL_Free(message);
+            SEC_OSAL_PoolFree(pSECComponent->hMemoryPool, message);
         }
         SEC_OSAL_MutexUnlock(outputUseBuffer->bufferMutex);
         ret = OMX_ErrorNone;
@@ -641,6 +700,7 @@ static OMX_ERRORTYPE SEC_BufferReset(OMX_COMPONENTTYPE *pOMXComponent, OMX_U32 p
     dataBuffer->bufferHeader  = NULL;
     dataBuffer->nFlags        = 0;
     dataBuffer->timeStamp     = 0;
+    dataBuffer->nEmptyTimeUs  = 0;
 
     return ret;
 }
@@ -659,6 +719,7 @@ static OMX_ERRORTYPE SEC_DataReset(OMX_COMPONENTTYPE *pOMXComponent, OMX_U32 por
     processData->usedDataLen   = 0;
     processData->nFlags        = 0;
     processData->timeStamp     = 0;
+    processData->nEmptyTimeUs  = 0;
 
     return ret;
 }
@@ -667,6 +728,7 @@ OMX_BOOL SEC_Preprocessor_InputData(OMX_COMPONENTTYPE *pOMXComponent)
 {
     OMX_BOOL               ret = OMX_FALSE;
     SEC_OMX_BASECOMPONENT *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    SEC_OMX_BASEPORT      *secInputPort = &pSECComponent->pSECPort[INPUT_PORT_INDEX];
     SEC_OMX_DATABUFFER    *inputUseBuffer = &pSECComponent->secDataBuffer[INPUT_PORT_INDEX];
     SEC_OMX_DATA          *inputData = &pSECComponent->processData[INPUT_PORT_INDEX];
     OMX_U32                copySize = 0;
@@ -675,10 +737,19 @@ OMX_BOOL SEC_Preprocessor_InputData(OMX_COMPONENTTYPE *pOMXComponent)
     OMX_U32                checkedSize = 0;
     OMX_BOOL               flagEOF = OMX_FALSE;
     OMX_BOOL               previousFrameEOF = OMX_FALSE;
+    OMX_BOOL               bLend = OMX_FALSE;
+    OMX_U64                framingStartUs = 0;
 
     FunctionIn();
 
+    /* a lent frame the codec has not taken yet */
+    if (inputData->bufferHeader != NULL) {
+        ret = OMX_TRUE;
+        goto EXIT;
+    }
+
     if (inputUseBuffer->dataValid == OMX_TRUE) {
+        framingStartUs = SEC_OSAL_GetSystemTimeUs();
         checkInputStream = inputUseBuffer->bufferHeader->pBuffer + inputUseBuffer->usedDataLen;
         checkInputStreamLen = inputUseBuffer->remainDataLen;
 
@@ -707,8 +778,24 @@ OMX_BOOL SEC_Preprocessor_InputData(OMX_COMPONENTTYPE *pOMXComponent)
         if (inputUseBuffer->nFlags & OMX_BUFFERFLAG_EOS)
             pSECComponent->bSaveFlagEOS = OMX_TRUE;
 
+        if ((previousFrameEOF == OMX_TRUE) && (copySize > 0) &&
+            (pSECComponent->sec_mfc_releaseInputBuffer != NULL)) {
+            /* the codec slot taking this frame may still hold a lent buffer */
+            pSECComponent->sec_mfc_releaseInputBuffer(pOMXComponent, OMX_FALSE);
+
+            /* a whole frame in the codec's stream memory is lent instead of copied */
+            if ((inputUseBuffer->bufferHeader->pInputPortPrivate != NULL) &&
+                (!CHECK_PORT_TUNNELED(secInputPort)) &&
+                (flagEOF == OMX_TRUE) && (inputUseBuffer->usedDataLen == 0) &&
+                (copySize == checkInputStreamLen)) {
+                bLend = OMX_TRUE;
+                inputData->dataBuffer = checkInputStream;
+                inputData->allocSize  = inputUseBuffer->allocSize;
+            }
+        }
+
         if (((inputData->allocSize) - (inputData->dataLen)) >= copySize) {
-            if (copySize > 0)
+            if ((copySize > 0) && (bLend == OMX_FALSE))
                 SEC_OSAL_Memcpy(inputData->dataBuffer + inputData->dataLen, checkInputStream, copySize);
 
             inputUseBuffer->dataLen -= copySize;
@@ -721,6 +808,7 @@ OMX_BOOL SEC_Preprocessor_InputData(OMX_COMPONENTTYPE *pOMXComponent)
             if (previousFrameEOF == OMX_TRUE) {
                 inputData->timeStamp = inputUseBuffer->timeStamp;
                 inputData->nFlags = inputUseBuffer->nFlags;
+                inputData->nEmptyTimeUs = inputUseBuffer->nEmptyTimeUs;
             }
 
             if (pSECComponent->bUseFlagEOF == OMX_TRUE) {
@@ -763,24 +851,30 @@ OMX_BOOL SEC_Preprocessor_InputData(OMX_COMPONENTTYPE *pOMXComponent)
         }
 
         if (inputUseBuffer->remainDataLen == 0)
-            SEC_InputBufferReturn(pOMXComponent);
+            SEC_InputBufferRelease(pOMXComponent, bLend);
         else
             inputUseBuffer->dataValid = OMX_TRUE;
     }
 
     if (flagEOF == OMX_TRUE) {
+        /* the call completing the frame, earlier calls were only waiting for more input */
+        SEC_OMX_StatsAdd(&pSECComponent->stats, SEC_OMX_STATS_FRAMING, framingStartUs);
+
+        SEC_OSAL_MutexLock(pSECComponent->compMutex);
         if (pSECComponent->checkTimeStamp.needSetStartTimeStamp == OMX_TRUE) {
             pSECComponent->checkTimeStamp.needCheckStartTimeStamp = OMX_TRUE;
             pSECComponent->checkTimeStamp.startTimeStamp = inputData->timeStamp;
             pSECComponent->checkTimeStamp.nStartFlags = inputData->nFlags;
             pSECComponent->checkTimeStamp.needSetStartTimeStamp = OMX_FALSE;
         }
+        SEC_OSAL_MutexUnlock(pSECComponent->compMutex);
 
         ret = OMX_TRUE;
     } else {
         ret = OMX_FALSE;
     }
 
+EXIT:
     FunctionOut();
 
     return ret;
@@ -793,10 +887,13 @@ OMX_BOOL SEC_Postprocess_OutputData(OMX_COMPONENTTYPE *pOMXComponent)
     SEC_OMX_DATABUFFER    *outputUseBuffer = &pSECComponent->secDataBuffer[OUTPUT_PORT_INDEX];
     SEC_OMX_DATA          *outputData = &pSECComponent->processData[OUTPUT_PORT_INDEX];
     OMX_U32                copySize = 0;
+    OMX_BOOL               bDrop = OMX_FALSE;
 
     FunctionIn();
 
     if (outputUseBuffer->dataValid == OMX_TRUE) {
+        /* set by SEC_Preprocessor_InputData, which runs on another thread in a pipeline */
+        SEC_OSAL_MutexLock(pSECComponent->compMutex);
         if (pSECComponent->checkTimeStamp.needCheckStartTimeStamp == OMX_TRUE) {
             if ((pSECComponent->checkTimeStamp.startTimeStamp == outputData->timeStamp) &&
                 (pSECComponent->checkTimeStamp.nStartFlags == outputData->nFlags)){
@@ -805,12 +902,14 @@ OMX_BOOL SEC_Postprocess_OutputData(OMX_COMPONENTTYPE *pOMXComponent)
                 pSECComponent->checkTimeStamp.needSetStartTimeStamp = OMX_FALSE;
                 pSECComponent->checkTimeStamp.needCheckStartTimeStamp = OMX_FALSE;
             } else {
-                SEC_DataReset(pOMXComponent, OUTPUT_PORT_INDEX);
-
-                ret = OMX_TRUE;
-                goto EXIT;
+                bDrop = OMX_TRUE;
             }
         } else if (pSECComponent->checkTimeStamp.needSetStartTimeStamp == OMX_TRUE) {
+            bDrop = OMX_TRUE;
+        }
+        SEC_OSAL_MutexUnlock(pSECComponent->compMutex);
+
+        if (bDrop == OMX_TRUE) {
             SEC_DataReset(pOMXComponent, OUTPUT_PORT_INDEX);
 
             ret = OMX_TRUE;
@@ -823,6 +922,7 @@ OMX_BOOL SEC_Postprocess_OutputData(OMX_COMPONENTTYPE *pOMXComponent)
             outputUseBuffer->remainDataLen += copySize;
             outputUseBuffer->nFlags = outputData->nFlags;
             outputUseBuffer->timeStamp = outputData->timeStamp;
+            outputUseBuffer->nEmptyTimeUs = outputData->nEmptyTimeUs;
 
             ret = OMX_TRUE;
 
@@ -840,6 +940,7 @@ OMX_BOOL SEC_Postprocess_OutputData(OMX_COMPONENTTYPE *pOMXComponent)
             outputUseBuffer->remainDataLen += copySize;
             outputUseBuffer->nFlags = 0;
             outputUseBuffer->timeStamp = outputData->timeStamp;
+            outputUseBuffer->nEmptyTimeUs = outputData->nEmptyTimeUs;
 
             ret = OMX_FALSE;
 
@@ -858,6 +959,339 @@ EXIT:
     return ret;
 }
 
+/* Frames the codec decodes ahead of output delivery, 0 when decode and delivery share a thread */
+OMX_U32 SEC_OMX_DecPipelineDepth(OMX_COMPONENTTYPE *pOMXComponent)
+{
+    SEC_OMX_BASECOMPONENT *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    SEC_OMX_DEC_PIPELINE  *pPipeline = (SEC_OMX_DEC_PIPELINE *)pSECComponent->hDecPipeline;
+
+    if ((pPipeline == NULL) || (pPipeline->bEnabled == OMX_FALSE))
+        return 0;
+
+    return pPipeline->nDepth;
+}
+
+/*
+ * Called by the codec in place of filling the output buffer. Returns OMX_FALSE
+ * when there is no pipeline and the codec fills the buffer itself.
+ */
+OMX_BOOL SEC_OMX_DecFrameDefer(OMX_COMPONENTTYPE *pOMXComponent, SSBSIP_MFC_DEC_OUTPUT_INFO *pOutputInfo)
+{
+    SEC_OMX_BASECOMPONENT *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    SEC_OMX_DEC_PIPELINE  *pPipeline = (SEC_OMX_DEC_PIPELINE *)pSECComponent->hDecPipeline;
+
+    if ((pPipeline == NULL) || (pPipeline->pSubmitFrame == NULL))
+        return OMX_FALSE;
+
+    SEC_OSAL_Memcpy(&pPipeline->pSubmitFrame->outputInfo, pOutputInfo, sizeof(SSBSIP_MFC_DEC_OUTPUT_INFO));
+    pPipeline->pSubmitFrame->bDeferred = OMX_TRUE;
+
+    return OMX_TRUE;
+}
+
+/* Decodes the framed input into the next free frame entry and queues it for delivery */
+static OMX_ERRORTYPE SEC_OMX_DecFrameSubmit(OMX_COMPONENTTYPE *pOMXComponent)
+{
+    OMX_ERRORTYPE          ret = OMX_ErrorNone;
+    SEC_OMX_BASECOMPONENT *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    SEC_OMX_DEC_PIPELINE  *pPipeline = (SEC_OMX_DEC_PIPELINE *)pSECComponent->hDecPipeline;
+    SEC_OMX_DATABUFFER    *inputUseBuffer = &pSECComponent->secDataBuffer[INPUT_PORT_INDEX];
+    SEC_OMX_DATA          *inputData = &pSECComponent->processData[INPUT_PORT_INDEX];
+    SEC_OMX_DEC_FRAME     *pFrame = NULL;
+    OMX_U32                nFlushCount = 0;
+    OMX_BOOL               bQueued = OMX_FALSE;
+
+    FunctionIn();
+
+    /* all entries decoded and not delivered yet, the output side is behind */
+    SEC_OSAL_SemaphoreWait(pPipeline->hFrameFree);
+    if (pSECComponent->bExitBufferProcessThread == OMX_TRUE)
+        goto EXIT;
+
+    /* an input port flush holds bufferMutex, it is either before this or after the decode */
+    SEC_OSAL_MutexLock(inputUseBuffer->bufferMutex);
+    SEC_OSAL_MutexLock(pPipeline->hLock);
+    pFrame = &pPipeline->frame[pPipeline->frameIndex];
+    nFlushCount = pPipeline->nFlushCount;
+    SEC_OSAL_MutexUnlock(pPipeline->hLock);
+    SEC_OSAL_Memset(pFrame, 0, sizeof(SEC_OMX_DEC_FRAME));
+
+    pPipeline->pSubmitFrame = pFrame;
+    ret = pSECComponent->sec_mfc_bufferProcess(pOMXComponent, inputData, &pFrame->outputData);
+    pPipeline->pSubmitFrame = NULL;
+    SEC_OSAL_MutexUnlock(inputUseBuffer->bufferMutex);
+
+    SEC_OSAL_MutexLock(pPipeline->hLock);
+    if (nFlushCount != pPipeline->nFlushCount) {
+        /* a port flush since the entry was taken, it is used again */
+        SEC_OSAL_Log(SEC_LOG_TRACE, "frame decoded across a flush dropped");
+    } else if (SEC_OSAL_RingPut(&pPipeline->frameQ, pFrame) != 0) {
+        /* hFrameFree bounds the frames in flight to the ring size */
+        SEC_OSAL_Log(SEC_LOG_ERROR, "frameQ full, Line:%d", __LINE__);
+        ret = OMX_ErrorUndefined;
+    } else {
+        pPipeline->frameIndex = (pPipeline->frameIndex + 1) % pPipeline->nDepth;
+        bQueued = OMX_TRUE;
+    }
+    SEC_OSAL_MutexUnlock(pPipeline->hLock);
+
+    if (bQueued == OMX_TRUE)
+        SEC_OSAL_SemaphorePost(pPipeline->hFrameReady);
+    else
+        SEC_OSAL_SemaphorePost(pPipeline->hFrameFree);
+
+EXIT:
+    FunctionOut();
+
+    return ret;
+}
+
+/* A port was flushed since nFlushCount was read */
+static OMX_BOOL SEC_OMX_DecFrameStale(SEC_OMX_DEC_PIPELINE *pPipeline, OMX_U32 nFlushCount)
+{
+    OMX_BOOL bStale = OMX_FALSE;
+
+    SEC_OSAL_MutexLock(pPipeline->hLock);
+    if (nFlushCount != pPipeline->nFlushCount)
+        bStale = OMX_TRUE;
+    SEC_OSAL_MutexUnlock(pPipeline->hLock);
+
+    return bStale;
+}
+
+/* Fills and returns an output buffer for one frame entry, as the serial loop does after decoding */
+static void SEC_OMX_DecFrameDeliver(OMX_COMPONENTTYPE *pOMXComponent, SEC_OMX_DEC_FRAME *pFrame, OMX_U32 nFlushCount)
+{
+    OMX_ERRORTYPE          ret = OMX_ErrorNone;
+    SEC_OMX_BASECOMPONENT *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    SEC_OMX_DEC_PIPELINE  *pPipeline = (SEC_OMX_DEC_PIPELINE *)pSECComponent->hDecPipeline;
+    SEC_OMX_BASEPORT      *secOutputPort = &pSECComponent->pSECPort[OUTPUT_PORT_INDEX];
+    SEC_OMX_DATABUFFER    *outputUseBuffer = &pSECComponent->secDataBuffer[OUTPUT_PORT_INDEX];
+    SEC_OMX_DATA          *outputData = &pSECComponent->processData[OUTPUT_PORT_INDEX];
+    OMX_BOOL               bFilled = OMX_FALSE;
+    OMX_BOOL               bDone = OMX_FALSE;
+
+    FunctionIn();
+
+    while ((bDone == OMX_FALSE) && (!pSECComponent->bExitBufferProcessThread)) {
+        SEC_OSAL_SleepMillisec(0);
+
+        if (SEC_OMX_DecFrameStale(pPipeline, nFlushCount) == OMX_TRUE)
+            break;
+
+        if (SEC_Check_BufferProcess_State(pSECComponent) == OMX_FALSE) {
+            /* only this thread resets outputPauseEvent, so a set after the reset is not lost */
+            SEC_OSAL_SignalReset(pSECComponent->outputPauseEvent);
+            if ((SEC_Check_BufferProcess_State(pSECComponent) == OMX_FALSE) &&
+                (SEC_OMX_DecFrameStale(pPipeline, nFlushCount) == OMX_FALSE) &&
+                (!pSECComponent->bExitBufferProcessThread))
+                SEC_OSAL_SignalWait(pSECComponent->outputPauseEvent, DEF_MAX_WAIT_TIME);
+            continue;
+        }
+
+        SEC_OSAL_MutexLock(outputUseBuffer->bufferMutex);
+        if ((outputUseBuffer->dataValid != OMX_TRUE) &&
+            (!CHECK_PORT_BEING_FLUSHED(secOutputPort))) {
+            SEC_OSAL_MutexUnlock(outputUseBuffer->bufferMutex);
+            if (SEC_OutputBufferGetQueue(pSECComponent) != OMX_ErrorNone)
+                continue;
+            SEC_OSAL_MutexLock(outputUseBuffer->bufferMutex);
+        }
+
+        /* flushed while waiting for an output buffer, an output flush resets outputData itself */
+        if (SEC_OMX_DecFrameStale(pPipeline, nFlushCount) == OMX_TRUE) {
+            if (bFilled == OMX_TRUE)
+                SEC_DataReset(pOMXComponent, OUTPUT_PORT_INDEX);
+            SEC_OSAL_MutexUnlock(outputUseBuffer->bufferMutex);
+            break;
+        }
+
+        if ((bFilled == OMX_FALSE) && (outputUseBuffer->dataValid == OMX_TRUE)) {
+            outputData->dataLen   = pFrame->outputData.dataLen;
+            outputData->nFlags    = pFrame->outputData.nFlags;
+            outputData->timeStamp = pFrame->outputData.timeStamp;
+            outputData->nEmptyTimeUs = pFrame->outputData.nEmptyTimeUs;
+
+            if (pFrame->bDeferred == OMX_TRUE) {
+                ret = pSECComponent->sec_mfc_fillOutput(pOMXComponent, &pFrame->outputInfo, outputData);
+                if (ret != OMX_ErrorNone) {
+                    pSECComponent->pCallbacks->EventHandler((OMX_HANDLETYPE)pOMXComponent,
+                                                            pSECComponent->callbackData,
+                                                            OMX_EventError, ret, 0, NULL);
+                }
+            }
+            outputData->usedDataLen   = 0;
+            outputData->remainDataLen = outputData->dataLen;
+            bFilled = OMX_TRUE;
+        }
+
+        if (bFilled == OMX_TRUE)
+            bDone = SEC_Postprocess_OutputData(pOMXComponent);
+
+        SEC_OSAL_MutexUnlock(outputUseBuffer->bufferMutex);
+    }
+
+    FunctionOut();
+}
+
+/*
+ * Output stage of the decode pipeline. A port flush drops the frames in
+ * frameQ, see SEC_OMX_DecBufferFlush, and the frame being delivered.
+ */
+static OMX_ERRORTYPE SEC_OMX_OutputProcessThread(OMX_PTR threadData)
+{
+    OMX_ERRORTYPE          ret = OMX_ErrorNone;
+    OMX_COMPONENTTYPE     *pOMXComponent = (OMX_COMPONENTTYPE *)threadData;
+    SEC_OMX_BASECOMPONENT *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    SEC_OMX_DEC_PIPELINE  *pPipeline = (SEC_OMX_DEC_PIPELINE *)pSECComponent->hDecPipeline;
+    SEC_OMX_DEC_FRAME     *pFrame = NULL;
+    OMX_U32                nFlushCount = 0;
+
+    FunctionIn();
+
+    while (!pSECComponent->bExitBufferProcessThread) {
+        SEC_OSAL_SemaphoreWait(pPipeline->hFrameReady);
+
+        /* hFrameReady counts the frames drained by a flush too */
+        SEC_OSAL_MutexLock(pPipeline->hLock);
+        pFrame = (SEC_OMX_DEC_FRAME *)SEC_OSAL_RingGet(&pPipeline->frameQ);
+        nFlushCount = pPipeline->nFlushCount;
+        SEC_OSAL_MutexUnlock(pPipeline->hLock);
+        if (pFrame == NULL)
+            continue;
+
+        SEC_OMX_DecFrameDeliver(pOMXComponent, pFrame, nFlushCount);
+        SEC_OSAL_SemaphorePost(pPipeline->hFrameFree);
+    }
+
+    /* the submit side may wait for a free entry */
+    SEC_OSAL_SemaphorePost(pPipeline->hFrameFree);
+
+    SEC_OSAL_ThreadExit(NULL);
+
+    FunctionOut();
+
+    return ret;
+}
+
+/*
+ * sec_BufferFlush, called with the bufferMutex of the flushed port held.
+ * Frames in frameQ go back to hFrameFree, the output thread drops the one
+ * it delivers and the submit side the one being decoded.
+ */
+static OMX_ERRORTYPE SEC_OMX_DecBufferFlush(OMX_COMPONENTTYPE *pOMXComponent, OMX_U32 nPortIndex)
+{
+    OMX_ERRORTYPE          ret = OMX_ErrorNone;
+    SEC_OMX_BASECOMPONENT *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    SEC_OMX_DEC_PIPELINE  *pPipeline = (SEC_OMX_DEC_PIPELINE *)pSECComponent->hDecPipeline;
+    SEC_OMX_DEC_FRAME     *pFrame = NULL;
+    OMX_BOOL               bFirst = OMX_TRUE;
+
+    FunctionIn();
+
+    if ((pPipeline == NULL) || (pPipeline->bEnabled == OMX_FALSE))
+        goto EXIT;
+
+    SEC_OSAL_MutexLock(pPipeline->hLock);
+    pPipeline->nFlushCount++;
+    while ((pFrame = (SEC_OMX_DEC_FRAME *)SEC_OSAL_RingGet(&pPipeline->frameQ)) != NULL) {
+        /* the newest entries in use, the submit side fills them again from the oldest */
+        if (bFirst == OMX_TRUE) {
+            pPipeline->frameIndex = pFrame - pPipeline->frame;
+            bFirst = OMX_FALSE;
+        }
+        SEC_OSAL_SemaphorePost(pPipeline->hFrameFree);
+    }
+    SEC_OSAL_MutexUnlock(pPipeline->hLock);
+
+    /* a paused output thread holds a frame of before the flush */
+    SEC_OMX_OutputPauseEventSet(pSECComponent);
+
+EXIT:
+    FunctionOut();
+
+    return ret;
+}
+
+static void SEC_OMX_DecPipelineStop(OMX_COMPONENTTYPE *pOMXComponent)
+{
+    SEC_OMX_BASECOMPONENT *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    SEC_OMX_DEC_PIPELINE  *pPipeline = (SEC_OMX_DEC_PIPELINE *)pSECComponent->hDecPipeline;
+
+    FunctionIn();
+
+    if (pPipeline == NULL)
+        goto EXIT;
+
+    if (pPipeline->hOutputThread != NULL) {
+        SEC_OSAL_SemaphorePost(pPipeline->hFrameReady);
+        SEC_OSAL_SignalSet(pSECComponent->outputPauseEvent);
+        SEC_OSAL_ThreadTerminate(pPipeline->hOutputThread);
+        pPipeline->hOutputThread = NULL;
+    }
+    if (pPipeline->hFrameReady != NULL) {
+        SEC_OSAL_SemaphoreTerminate(pPipeline->hFrameReady);
+        pPipeline->hFrameReady = NULL;
+    }
+    if (pPipeline->hFrameFree != NULL) {
+        SEC_OSAL_SemaphoreTerminate(pPipeline->hFrameFree);
+        pPipeline->hFrameFree = NULL;
+    }
+    if (pPipeline->frameQ.data != NULL)
+        SEC_OSAL_RingTerminate(&pPipeline->frameQ);
+    if (pPipeline->hLock != NULL) {
+        SEC_OSAL_MutexTerminate(pPipeline->hLock);
+        pPipeline->hLock = NULL;
+    }
+
+    pPipeline->bEnabled = OMX_FALSE;
+
+EXIT:
+    FunctionOut();
+}
+
+/* Starts the output thread, without it decoding and delivery stay on one thread */
+static void SEC_OMX_DecPipelineStart(OMX_COMPONENTTYPE *pOMXComponent)
+{
+    SEC_OMX_BASECOMPONENT *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    SEC_OMX_DEC_PIPELINE  *pPipeline = (SEC_OMX_DEC_PIPELINE *)pSECComponent->hDecPipeline;
+    SEC_OSAL_THREAD_ATTR   threadAttr;
+
+    FunctionIn();
+
+    if ((pPipeline == NULL) || (pPipeline->nDepth == 0) ||
+        (pSECComponent->sec_mfc_fillOutput == NULL))
+        goto EXIT;
+
+    pPipeline->frameIndex   = 0;
+    pPipeline->nFlushCount  = 0;
+    pPipeline->pSubmitFrame = NULL;
+    if ((SEC_OSAL_MutexCreate(&pPipeline->hLock) != OMX_ErrorNone) ||
+        (SEC_OSAL_SemaphoreCreate(&pPipeline->hFrameReady) != OMX_ErrorNone) ||
+        (SEC_OSAL_SemaphoreCreate(&pPipeline->hFrameFree) != OMX_ErrorNone) ||
+        (SEC_OSAL_RingCreate(&pPipeline->frameQ, pPipeline->nDepth) != OMX_ErrorNone))
+        goto ERROR;
+    SEC_OSAL_Set_SemaphoreCount(pPipeline->hFrameFree, pPipeline->nDepth);
+
+    threadAttr = pSECComponent->bufferProcessThreadAttr;
+    snprintf(threadAttr.name, SEC_OSAL_THREAD_NAME_SIZE, "%.11sOut", pSECComponent->bufferProcessThreadAttr.name);
+    if (SEC_OSAL_ThreadCreateEx(&pPipeline->hOutputThread, SEC_OMX_OutputProcessThread,
+                                pOMXComponent, &threadAttr) != OMX_ErrorNone) {
+        pPipeline->hOutputThread = NULL;
+        goto ERROR;
+    }
+
+    pPipeline->bEnabled = OMX_TRUE;
+    goto EXIT;
+
+ERROR:
+    SEC_OSAL_Log(SEC_LOG_ERROR, "decode pipeline of depth %d not started, output on the decode thread", pPipeline->nDepth);
+    SEC_OMX_DecPipelineStop(pOMXComponent);
+
+EXIT:
+    FunctionOut();
+}
+
 OMX_ERRORTYPE SEC_OMX_BufferProcess(OMX_HANDLETYPE hComponent)
 {
     OMX_ERRORTYPE          ret = OMX_ErrorNone;
@@ -870,12 +1304,16 @@ OMX_ERRORTYPE SEC_OMX_BufferProcess(OMX_HANDLETYPE hComponent)
     SEC_OMX_DATA          *inputData = &pSECComponent->processData[INPUT_PORT_INDEX];
     SEC_OMX_DATA          *outputData = &pSECComponent->processData[OUTPUT_PORT_INDEX];
     OMX_U32                copySize = 0;
+    OMX_BOOL               bPipeline = OMX_FALSE;
 
     pSECComponent->remainOutputData = OMX_FALSE;
     pSECComponent->reInputData = OMX_FALSE;
 
     FunctionIn();
 
+    SEC_OMX_DecPipelineStart(pOMXComponent);
+    bPipeline = (SEC_OMX_DecPipelineDepth(pOMXComponent) > 0) ? OMX_TRUE : OMX_FALSE;
+
     while (!pSECComponent->bExitBufferProcessThread) {
         SEC_OSAL_SleepMillisec(0);
 
@@ -892,18 +1330,21 @@ OMX_ERRORTYPE SEC_OMX_BufferProcess(OMX_HANDLETYPE hComponent)
         while (SEC_Check_BufferProcess_State(pSECComponent) && !pSECComponent->bExitBufferProcessThread) {
             SEC_OSAL_SleepMillisec(0);
 
-            SEC_OSAL_MutexLock(outputUseBuffer->bufferMutex);
-            if ((outputUseBuffer->dataValid != OMX_TRUE) &&
-                (!CHECK_PORT_BEING_FLUSHED(secOutputPort))) {
-                SEC_OSAL_MutexUnlock(outputUseBuffer->bufferMutex);
-                ret = SEC_OutputBufferGetQueue(pSECComponent);
-                if ((ret == OMX_ErrorUndefined) ||
-                    (secInputPort->portState != OMX_StateIdle) ||
-                    (secOutputPort->portState != OMX_StateIdle)) {
-                    break;
+            /* output buffers belong to SEC_OMX_OutputProcessThread in a pipeline */
+            if (bPipeline == OMX_FALSE) {
+                SEC_OSAL_MutexLock(outputUseBuffer->bufferMutex);
+                if ((outputUseBuffer->dataValid != OMX_TRUE) &&
+                    (!CHECK_PORT_BEING_FLUSHED(secOutputPort))) {
+                    SEC_OSAL_MutexUnlock(outputUseBuffer->bufferMutex);
+                    ret = SEC_OutputBufferGetQueue(pSECComponent);
+                    if ((ret == OMX_ErrorUndefined) ||
+                        (secInputPort->portState != OMX_StateIdle) ||
+                        (secOutputPort->portState != OMX_StateIdle)) {
+                        break;
+                    }
+                } else {
+                    SEC_OSAL_MutexUnlock(outputUseBuffer->bufferMutex);
                 }
-            } else {
-                SEC_OSAL_MutexUnlock(outputUseBuffer->bufferMutex);
             }
 
             if (pSECComponent->remainOutputData == OMX_FALSE) {
@@ -919,11 +1360,15 @@ OMX_ERRORTYPE SEC_OMX_BufferProcess(OMX_HANDLETYPE hComponent)
                     SEC_OSAL_MutexUnlock(inputUseBuffer->bufferMutex);
                 }
 
-                SEC_OSAL_MutexLock(inputUseBuffer->bufferMutex);
-                SEC_OSAL_MutexLock(outputUseBuffer->bufferMutex);
-                ret = pSECComponent->sec_mfc_bufferProcess(pOMXComponent, inputData, outputData);
-                SEC_OSAL_MutexUnlock(outputUseBuffer->bufferMutex);
-                SEC_OSAL_MutexUnlock(inputUseBuffer->bufferMutex);
+                if (bPipeline == OMX_TRUE) {
+                    ret = SEC_OMX_DecFrameSubmit(pOMXComponent);
+                } else {
+                    SEC_OSAL_MutexLock(inputUseBuffer->bufferMutex);
+                    SEC_OSAL_MutexLock(outputUseBuffer->bufferMutex);
+                    ret = pSECComponent->sec_mfc_bufferProcess(pOMXComponent, inputData, outputData);
+                    SEC_OSAL_MutexUnlock(outputUseBuffer->bufferMutex);
+                    SEC_OSAL_MutexUnlock(inputUseBuffer->bufferMutex);
+                }
 
                 if (ret == OMX_ErrorInputDataDecodeYet)
                     pSECComponent->reInputData = OMX_TRUE;
@@ -931,6 +1376,9 @@ OMX_ERRORTYPE SEC_OMX_BufferProcess(OMX_HANDLETYPE hComponent)
                     pSECComponent->reInputData = OMX_FALSE;
             }
 
+            if (bPipeline == OMX_TRUE)
+                continue;
+
             SEC_OSAL_MutexLock(outputUseBuffer->bufferMutex);
 
             if (SEC_Postprocess_OutputData(pOMXComponent) == OMX_FALSE)
@@ -942,6 +1390,8 @@ OMX_ERRORTYPE SEC_OMX_BufferProcess(OMX_HANDLETYPE hComponent)
         }
     }
 
+    SEC_OMX_DecPipelineStop(pOMXComponent);
+
 EXIT:
     FunctionOut();
 
@@ -1084,6 +1534,19 @@ OMX_ERRORTYPE SEC_OMX_VideoDecodeGetParameter(
         ret = OMX_ErrorNone;
     }
         break;
+    case OMX_IndexVendorDecodePipelineDepth:
+    {
+        OMX_PARAM_U32TYPE    *pPipelineDepth = (OMX_PARAM_U32TYPE *)ComponentParameterStructure;
+        SEC_OMX_DEC_PIPELINE *pPipeline = (SEC_OMX_DEC_PIPELINE *)pSECComponent->hDecPipeline;
+
+        ret = SEC_OMX_Check_SizeVersion(pPipelineDepth, sizeof(OMX_PARAM_U32TYPE));
+        if (ret != OMX_ErrorNone) {
+            goto EXIT;
+        }
+
+        pPipelineDepth->nU32 = pPipeline->nDepth;
+    }
+        break;
 #ifdef USE_ANDROID_EXTENSION
     case OMX_IndexParamGetAndroidNativeBuffer:
     {
@@ -1196,6 +1659,35 @@ OMX_ERRORTYPE SEC_OMX_VideoDecodeSetParameter(
         ret = OMX_ErrorNone;
     }
         break;
+    case OMX_IndexVendorDecodePipelineDepth:
+    {
+        OMX_PARAM_U32TYPE    *pPipelineDepth = (OMX_PARAM_U32TYPE *)ComponentParameterStructure;
+        SEC_OMX_DEC_PIPELINE *pPipeline = (SEC_OMX_DEC_PIPELINE *)pSECComponent->hDecPipeline;
+        SEC_OMX_BASEPORT     *pSECPort = &pSECComponent->pSECPort[OUTPUT_PORT_INDEX];
+
+        ret = SEC_OMX_Check_SizeVersion(pPipelineDepth, sizeof(OMX_PARAM_U32TYPE));
+        if (ret != OMX_ErrorNone) {
+            goto EXIT;
+        }
+
+        if (pSECComponent->currentState != OMX_StateLoaded) {
+            ret = OMX_ErrorIncorrectStateOperation;
+            goto EXIT;
+        }
+
+        if (pPipelineDepth->nU32 > MAX_DEC_PIPELINE_DEPTH) {
+            ret = OMX_ErrorBadParameter;
+            goto EXIT;
+        }
+
+        pPipeline->nDepth = pPipelineDepth->nU32;
+
+        /* one buffer with the client while the pipeline holds the rest */
+        if (pSECPort->portDefinition.nBufferCountActual < pPipeline->nDepth + 1)
+            pSECPort->portDefinition.nBufferCountActual = pPipeline->nDepth + 1;
+        ret = OMX_ErrorNone;
+    }
+        break;
 #ifdef USE_ANDROID_EXTENSION
     case OMX_IndexParamEnableAndroidBuffers:
     {
@@ -1248,41 +1740,292 @@ EXIT:
     return ret;
 }
 
-OMX_ERRORTYPE SEC_OMX_VideoDecodeComponentInit(OMX_IN OMX_HANDLETYPE hComponent)
+/*
+ * Opens the MFC decoder. The stream buffer holds the MFC_INPUT_BUFFER_NUM_MAX
+ * buffers of copied input, then clientSlotNum input port buffers for
+ * SEC_MFC_DecClientBufferGet. Without room for those, input is copied.
+ */
+OMX_PTR SEC_MFC_DecOpen(
+    MFC_DEC_INPUT_BUFFER  *pInputBuffer,
+    MFC_DEC_CLIENT_BUFFER *pClientBuffer,
+    OMX_U32                clientSlotSize,
+    OMX_U32                clientSlotNum)
 {
-    OMX_ERRORTYPE          ret = OMX_ErrorNone;
-    OMX_COMPONENTTYPE     *pOMXComponent = NULL;
-    SEC_OMX_BASECOMPONENT *pSECComponent = NULL;
-    SEC_OMX_BASEPORT      *pSECPort = NULL;
+    SSBIP_MFC_BUFFER_TYPE buf_type = CACHE;
+    OMX_PTR               hMFCHandle = NULL;
+    OMX_U8               *pStreamBuffer = NULL;
+    OMX_PTR               pStreamPhyBuffer = NULL;
+    OMX_U32               streamSize = DEFAULT_MFC_INPUT_BUFFER_SIZE * MFC_INPUT_BUFFER_NUM_MAX;
+    int                   i = 0;
 
     FunctionIn();
 
-    if (hComponent == NULL) {
-        ret = OMX_ErrorBadParameter;
+    SEC_OSAL_Memset(pClientBuffer, 0, sizeof(MFC_DEC_CLIENT_BUFFER));
+
+    /* MFC(Multi Function Codec) decoder and CMM(Codec Memory Management) driver open */
+    hMFCHandle = (OMX_PTR)SsbSipMfcDecOpen(&buf_type);
+    if (hMFCHandle == NULL)
         goto EXIT;
+
+    clientSlotSize = (clientSlotSize + MFC_CLIENT_BUFFER_ALIGN - 1) & ~(MFC_CLIENT_BUFFER_ALIGN - 1);
+    if ((clientSlotSize > MFC_CLIENT_BUFFER_SIZE_MAX) || (clientSlotNum > MAX_BUFFER_NUM))
+        clientSlotNum = 0;
+
+    if (clientSlotNum > 0) {
+        pStreamBuffer = SsbSipMfcDecGetInBuf(hMFCHandle, &pStreamPhyBuffer, streamSize + (clientSlotSize * clientSlotNum));
+        if (pStreamBuffer != NULL) {
+            pClientBuffer->pVirBase = pStreamBuffer + streamSize;
+            pClientBuffer->pPhyBase = (OMX_U8 *)pStreamPhyBuffer + streamSize;
+            pClientBuffer->slotSize = clientSlotSize;
+            pClientBuffer->slotNum  = clientSlotNum;
+        } else {
+            SEC_OSAL_Log(SEC_LOG_WARNING, "no MFC memory for %d input buffers of %d bytes", clientSlotNum, clientSlotSize);
+        }
     }
-    pOMXComponent = (OMX_COMPONENTTYPE *)hComponent;
-    ret = SEC_OMX_Check_SizeVersion(pOMXComponent, sizeof(OMX_COMPONENTTYPE));
-    if (ret != OMX_ErrorNone) {
-        SEC_OSAL_Log(SEC_LOG_ERROR, "OMX_Error, Line:%d", __LINE__);
+
+    /* Allocate decoder's input buffer */
+    if (pStreamBuffer == NULL)
+        pStreamBuffer = SsbSipMfcDecGetInBuf(hMFCHandle, &pStreamPhyBuffer, streamSize);
+    if (pStreamBuffer == NULL) {
+        SsbSipMfcDecClose(hMFCHandle);
+        hMFCHandle = NULL;
         goto EXIT;
     }
 
-    ret = SEC_OMX_BaseComponent_Constructor(pOMXComponent);
-    if (ret != OMX_ErrorNone) {
-        SEC_OSAL_Log(SEC_LOG_ERROR, "OMX_Error, Line:%d", __LINE__);
+    for (i = 0; i < MFC_INPUT_BUFFER_NUM_MAX; i++) {
+        pInputBuffer[i].VirAddr       = pStreamBuffer + (DEFAULT_MFC_INPUT_BUFFER_SIZE * i);
+        pInputBuffer[i].PhyAddr       = (OMX_U8 *)pStreamPhyBuffer + (DEFAULT_MFC_INPUT_BUFFER_SIZE * i);
+        pInputBuffer[i].bufferSize    = DEFAULT_MFC_INPUT_BUFFER_SIZE;
+        pInputBuffer[i].dataSize      = 0;
+        pInputBuffer[i].pClientBuffer = NULL;
+        pInputBuffer[i].MFCVirAddr    = pInputBuffer[i].VirAddr;
+        pInputBuffer[i].MFCPhyAddr    = pInputBuffer[i].PhyAddr;
+        pInputBuffer[i].MFCBufferSize = pInputBuffer[i].bufferSize;
+    }
+
+EXIT:
+    FunctionOut();
+
+    return hMFCHandle;
+}
+
+void SEC_MFC_DecClose(
+    OMX_PTR                hMFCHandle,
+    MFC_DEC_INPUT_BUFFER  *pInputBuffer,
+    MFC_DEC_CLIENT_BUFFER *pClientBuffer)
+{
+    FunctionIn();
+
+    /* the driver frees the stream buffer it was last given */
+    SsbSipMfcDecSetInBuf(hMFCHandle,
+                         pInputBuffer[0].MFCPhyAddr,
+                         pInputBuffer[0].MFCVirAddr,
+                         DEFAULT_MFC_INPUT_BUFFER_SIZE * MFC_INPUT_BUFFER_NUM_MAX);
+    SsbSipMfcDecClose(hMFCHandle);
+
+    SEC_OSAL_Memset(pInputBuffer, 0, sizeof(MFC_DEC_INPUT_BUFFER) * MFC_INPUT_BUFFER_NUM_MAX);
+    SEC_OSAL_Memset(pClientBuffer, 0, sizeof(MFC_DEC_CLIENT_BUFFER));
+
+    FunctionOut();
+}
+
+OMX_ERRORTYPE SEC_MFC_DecClientBufferGet(
+    MFC_DEC_CLIENT_BUFFER *pClientBuffer,
+    OMX_U32                nIndex,
+    OMX_U32                nSizeBytes,
+    OMX_U8               **ppBuffer,
+    OMX_PTR               *ppPhyBuffer)
+{
+    OMX_ERRORTYPE ret = OMX_ErrorNone;
+
+    if ((nIndex >= pClientBuffer->slotNum) || (nSizeBytes > pClientBuffer->slotSize)) {
+        ret = OMX_ErrorInsufficientResources;
         goto EXIT;
     }
 
-    ret = SEC_OMX_Port_Constructor(pOMXComponent);
-    if (ret != OMX_ErrorNone) {
-        SEC_OMX_BaseComponent_Destructor(pOMXComponent);
-        SEC_OSAL_Log(SEC_LOG_ERROR, "OMX_Error, Line:%d", __LINE__);
+    *ppBuffer    = (OMX_U8 *)pClientBuffer->pVirBase + (pClientBuffer->slotSize * nIndex);
+    *ppPhyBuffer = (OMX_U8 *)pClientBuffer->pPhyBase + (pClientBuffer->slotSize * nIndex);
+
+EXIT:
+    return ret;
+}
+
+static void SEC_MFC_DecInputGiveBack(OMX_COMPONENTTYPE *pOMXComponent, OMX_BUFFERHEADERTYPE *bufferHeader)
+{
+    SEC_OMX_BASECOMPONENT *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+
+    bufferHeader->nFilledLen = 0;
+    pSECComponent->pCallbacks->EmptyBufferDone(pOMXComponent, pSECComponent->callbackData, bufferHeader);
+}
+
+static void SEC_MFC_DecSlotGiveBack(OMX_COMPONENTTYPE *pOMXComponent, MFC_DEC_INPUT_BUFFER *pSlot)
+{
+    if (pSlot->pClientBuffer == NULL)
+        return;
+
+    SEC_MFC_DecInputGiveBack(pOMXComponent, pSlot->pClientBuffer);
+    pSlot->pClientBuffer = NULL;
+    pSlot->VirAddr    = pSlot->MFCVirAddr;
+    pSlot->PhyAddr    = pSlot->MFCPhyAddr;
+    pSlot->bufferSize = pSlot->MFCBufferSize;
+}
+
+/*
+ * Called by the codec with a frame lent by SEC_Preprocessor_InputData.
+ * bLend: the MFC decodes from the client buffer and pSlot holds it until
+ * the slot is reused, else the frame is copied into the slot (stream
+ * header parsing reads the MFC's own buffer).
+ */
+void SEC_MFC_DecInputTake(
+    OMX_COMPONENTTYPE    *pOMXComponent,
+    MFC_DEC_INPUT_BUFFER *pSlot,
+    SEC_OMX_DATA         *pInputData,
+    OMX_BOOL              bLend)
+{
+    OMX_BUFFERHEADERTYPE *bufferHeader = pInputData->bufferHeader;
+
+    FunctionIn();
+
+    if (bufferHeader == NULL)
         goto EXIT;
+
+    SEC_MFC_DecSlotGiveBack(pOMXComponent, pSlot);
+
+    if (bLend == OMX_TRUE) {
+        pSlot->pClientBuffer = bufferHeader;
+        pSlot->VirAddr       = pInputData->dataBuffer;
+        pSlot->PhyAddr       = pInputData->dataPhyBuffer;
+        pSlot->bufferSize    = bufferHeader->nAllocLen;
+    } else {
+        if (pInputData->dataLen > (OMX_U32)pSlot->bufferSize) {
+            SEC_OSAL_Log(SEC_LOG_ERROR, "input frame %d bytes, truncated to %d", pInputData->dataLen, pSlot->bufferSize);
+            pInputData->dataLen = pInputData->remainDataLen = pSlot->bufferSize;
+        }
+        SEC_OSAL_Memcpy(pSlot->VirAddr, pInputData->dataBuffer, pInputData->dataLen);
+        SEC_MFC_DecInputGiveBack(pOMXComponent, bufferHeader);
     }
 
-    pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
-    pSECComponent->bSaveFlagEOS = OMX_FALSE;
+    pInputData->dataBuffer    = pSlot->VirAddr;
+    pInputData->allocSize     = pSlot->bufferSize;
+    pInputData->bufferHeader  = NULL;
+    pInputData->dataPhyBuffer = NULL;
+
+EXIT:
+    FunctionOut();
+}
+
+/*
+ * Gives back the client buffer lent to the slot nIndex, or to every slot
+ * (bAll), and any frame not taken by the codec yet. The MFC must not be
+ * reading the slots given back.
+ */
+void SEC_MFC_DecInputRelease(
+    OMX_COMPONENTTYPE    *pOMXComponent,
+    MFC_DEC_INPUT_BUFFER *pInputBuffer,
+    OMX_U32               nIndex,
+    OMX_BOOL              bAll)
+{
+    SEC_OMX_BASECOMPONENT *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    SEC_OMX_DATA          *inputData = &pSECComponent->processData[INPUT_PORT_INDEX];
+    OMX_U32                i = 0;
+
+    FunctionIn();
+
+    if (inputData->bufferHeader != NULL) {
+        SEC_MFC_DecInputGiveBack(pOMXComponent, inputData->bufferHeader);
+        inputData->bufferHeader  = NULL;
+        inputData->dataPhyBuffer = NULL;
+    }
+
+    for (i = 0; i < MFC_INPUT_BUFFER_NUM_MAX; i++) {
+        if ((bAll == OMX_TRUE) || (i == nIndex))
+            SEC_MFC_DecSlotGiveBack(pOMXComponent, &pInputBuffer[i]);
+    }
+
+    inputData->dataBuffer = pInputBuffer[nIndex].VirAddr;
+    inputData->allocSize  = pInputBuffer[nIndex].bufferSize;
+
+    FunctionOut();
+}
+
+/*
+ * Start code search shared by the frame scanners of the codec components.
+ * Words without a zero byte can not hold the second zero of a start code,
+ * only the few words that have one are compared byte by byte.
+ */
+typedef unsigned long __attribute__((__may_alias__)) SEC_STREAM_WORD;
+
+#define STREAM_WORD_SIZE      sizeof(SEC_STREAM_WORD)
+#define STREAM_WORD_ONES      ((SEC_STREAM_WORD)-1 / 0xFF)
+#define STREAM_WORD_HAS_ZERO(x) \
+    (((x) - STREAM_WORD_ONES) & ~(x) & (STREAM_WORD_ONES * 0x80))
+
+#define IS_START_CODE(p, codeMask, code) \
+    (((p)[0] == 0x00) && ((p)[1] == 0x00) && (((p)[2] & (codeMask)) == (code)))
+
+/* Returns the offset of the first 00 00 xx with (xx & codeMask) == code, streamSize if none */
+int SEC_FindStartCode(
+    OMX_U8 *pStream,
+    int     streamSize,
+    OMX_U8  codeMask,
+    OMX_U8  code)
+{
+    OMX_U8 *pEnd = pStream + streamSize;
+    OMX_U8 *pWord = NULL;
+    OMX_U8 *p = pStream;
+
+    if (streamSize < 3)
+        return streamSize;
+
+    /* candidates until the second zero falls on a word boundary */
+    while ((((unsigned long)(p + 1)) & (STREAM_WORD_SIZE - 1)) && (p + 2 < pEnd)) {
+        if (IS_START_CODE(p, codeMask, code))
+            return p - pStream;
+        p++;
+    }
+
+    for (pWord = p + 1; pWord + STREAM_WORD_SIZE <= pEnd; pWord += STREAM_WORD_SIZE) {
+        SEC_STREAM_WORD x = *(SEC_STREAM_WORD *)pWord;
+
+        if (!STREAM_WORD_HAS_ZERO(x))
+            continue;
+        /* second zero inside this word */
+        for (p = pWord - 1; (p < pWord + STREAM_WORD_SIZE - 1) && (p + 2 < pEnd); p++) {
+            if (IS_START_CODE(p, codeMask, code))
+                return p - pStream;
+        }
+    }
+
+    for (p = pWord - 1; p + 2 < pEnd; p++) {
+        if (IS_START_CODE(p, codeMask, code))
+            return p - pStream;
+    }
+
+    return streamSize;
+}
+
+/* Converts MFC output to linear frame, band parallel for large frames */
+void SEC_TiledToLinearFrame(
+    CSC_LINEAR_FRAME *pDest,
+    OMX_PTR           pYSrc,
+    OMX_PTR           pCSrc,
+    CSC_TILE_MAP     *pYMap,
+    CSC_TILE_MAP     *pCMap)
+{
+    FunctionIn();
+
+    if ((pYMap->width * pYMap->height) >= PARALLEL_CSC_MIN_FRAME_SIZE)
+        csc_tiled_to_linear_frame_parallel(pDest, (char *)pYSrc, (char *)pCSrc, pYMap, pCMap);
+    else
+        csc_tiled_to_linear_frame(pDest, (char *)pYSrc, (char *)pCSrc, pYMap, pCMap);
+
+    FunctionOut();
+}
+
+/* Port defaults of the video decoder layer, the codec component sets its own on top */
+static void SEC_OMX_VideoDecodeSetDefault(SEC_OMX_BASECOMPONENT *pSECComponent)
+{
+    SEC_OMX_BASEPORT *pSECPort = NULL;
 
     /* Input port */
     pSECPort = &pSECComponent->pSECPort[INPUT_PORT_INDEX];
@@ -1291,7 +2034,6 @@ OMX_ERRORTYPE SEC_OMX_VideoDecodeComponentInit(OMX_IN OMX_HANDLETYPE hComponent)
     pSECPort->portDefinition.nBufferSize = 0;
     pSECPort->portDefinition.eDomain = OMX_PortDomainVideo;
 
-    pSECPort->portDefinition.format.video.cMIMEType = SEC_OSAL_Malloc(MAX_OMX_MIMETYPE_SIZE);
     SEC_OSAL_Strcpy(pSECPort->portDefinition.format.video.cMIMEType, "raw/video");
     pSECPort->portDefinition.format.video.pNativeRender = 0;
     pSECPort->portDefinition.format.video.bFlagErrorConcealment = OMX_FALSE;
@@ -1313,7 +2055,6 @@ OMX_ERRORTYPE SEC_OMX_VideoDecodeComponentInit(OMX_IN OMX_HANDLETYPE hComponent)
     pSECPort->portDefinition.nBufferSize = DEFAULT_VIDEO_OUTPUT_BUFFER_SIZE;
     pSECPort->portDefinition.eDomain = OMX_PortDomainVideo;
 
-    pSECPort->portDefinition.format.video.cMIMEType = SEC_OSAL_Malloc(MAX_OMX_MIMETYPE_SIZE);
     SEC_OSAL_Strcpy(pSECPort->portDefinition.format.video.cMIMEType, "raw/video");
     pSECPort->portDefinition.format.video.pNativeRender = 0;
     pSECPort->portDefinition.format.video.bFlagErrorConcealment = OMX_FALSE;
@@ -1327,6 +2068,72 @@ OMX_ERRORTYPE SEC_OMX_VideoDecodeComponentInit(OMX_IN OMX_HANDLETYPE hComponent)
     pSECPort->portDefinition.format.video.xFramerate = (15 << 16);
     pSECPort->portDefinition.format.video.eColorFormat = OMX_COLOR_FormatUnused;
     pSECPort->portDefinition.format.video.pNativeWindow = NULL;
+}
+
+OMX_ERRORTYPE SEC_OMX_VideoDecodeComponentInit(OMX_IN OMX_HANDLETYPE hComponent)
+{
+    OMX_ERRORTYPE          ret = OMX_ErrorNone;
+    OMX_COMPONENTTYPE     *pOMXComponent = NULL;
+    SEC_OMX_BASECOMPONENT *pSECComponent = NULL;
+
+    FunctionIn();
+
+    if (hComponent == NULL) {
+        ret = OMX_ErrorBadParameter;
+        goto EXIT;
+    }
+    pOMXComponent = (OMX_COMPONENTTYPE *)hComponent;
+    ret = SEC_OMX_Check_SizeVersion(pOMXComponent, sizeof(OMX_COMPONENTTYPE));
+    if (ret != OMX_ErrorNone) {
+        SEC_OSAL_Log(SEC_LOG_ERROR, "OMX_Error, Line:%d", __LINE__);
+        goto EXIT;
+    }
+
+    ret = SEC_OMX_BaseComponent_Constructor(pOMXComponent);
+    if (ret != OMX_ErrorNone) {
+        SEC_OSAL_Log(SEC_LOG_ERROR, "OMX_Error, Line:%d", __LINE__);
+        goto EXIT;
+    }
+
+    ret = SEC_OMX_Port_Constructor(pOMXComponent);
+    if (ret != OMX_ErrorNone) {
+        SEC_OMX_BaseComponent_Destructor(pOMXComponent);
+        SEC_OSAL_Log(SEC_LOG_ERROR, "OMX_Error, Line:%d", __LINE__);
+        goto EXIT;
+    }
+
+    pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    pSECComponent->bSaveFlagEOS = OMX_FALSE;
+
+    pSECComponent->hDecPipeline = SEC_OSAL_Malloc(sizeof(SEC_OMX_DEC_PIPELINE));
+    if (pSECComponent->hDecPipeline == NULL) {
+        SEC_OMX_Port_Destructor(pOMXComponent);
+        SEC_OMX_BaseComponent_Destructor(pOMXComponent);
+        ret = OMX_ErrorInsufficientResources;
+        SEC_OSAL_Log(SEC_LOG_ERROR, "OMX_ErrorInsufficientResources, Line:%d", __LINE__);
+        goto EXIT;
+    }
+    SEC_OSAL_Memset(pSECComponent->hDecPipeline, 0, sizeof(SEC_OMX_DEC_PIPELINE));
+
+    ret = SEC_OSAL_SignalCreate(&pSECComponent->outputPauseEvent);
+    if (ret != OMX_ErrorNone) {
+        SEC_OSAL_Free(pSECComponent->hDecPipeline);
+        pSECComponent->hDecPipeline = NULL;
+        SEC_OMX_Port_Destructor(pOMXComponent);
+        SEC_OMX_BaseComponent_Destructor(pOMXComponent);
+        SEC_OSAL_Log(SEC_LOG_ERROR, "OMX_Error, Line:%d", __LINE__);
+        goto EXIT;
+    }
+
+    pSECComponent->pSECPort[INPUT_PORT_INDEX].portDefinition.format.video.cMIMEType = SEC_OSAL_Malloc(MAX_OMX_MIMETYPE_SIZE);
+    pSECComponent->pSECPort[OUTPUT_PORT_INDEX].portDefinition.format.video.cMIMEType = SEC_OSAL_Malloc(MAX_OMX_MIMETYPE_SIZE);
+    SEC_OMX_VideoDecodeSetDefault(pSECComponent);
+
+    /* the codec component names the thread */
+    SEC_OSAL_Strcpy(pSECComponent->bufferProcessThreadAttr.name, "SecVideoDec");
+    pSECComponent->bufferProcessThreadAttr.policy   = SEC_OSAL_SCHED_OTHER;
+    pSECComponent->bufferProcessThreadAttr.priority = SEC_OMX_BUFFER_PROCESS_PRIORITY;
+    pSECComponent->bufferProcessThreadAttr.cpuMask  = SEC_OMX_BUFFER_PROCESS_CPU_MASK;
 
     pOMXComponent->UseBuffer              = &SEC_OMX_UseBuffer;
     pOMXComponent->AllocateBuffer         = &SEC_OMX_AllocateBuffer;
@@ -1337,9 +2144,62 @@ OMX_ERRORTYPE SEC_OMX_VideoDecodeComponentInit(OMX_IN OMX_HANDLETYPE hComponent)
     pSECComponent->sec_FreeTunnelBuffer     = &SEC_OMX_FreeTunnelBuffer;
     pSECComponent->sec_BufferProcess        = &SEC_OMX_BufferProcess;
     pSECComponent->sec_BufferReset          = &SEC_BufferReset;
+    pSECComponent->sec_BufferFlush          = &SEC_OMX_DecBufferFlush;
     pSECComponent->sec_InputBufferReturn    = &SEC_InputBufferReturn;
     pSECComponent->sec_OutputBufferReturn   = &SEC_OutputBufferReturn;
 
+    csc_parallel_open();
+
+EXIT:
+    FunctionOut();
+
+    return ret;
+}
+
+/* Back to the defaults of a new component for reuse, the codec component resets its own part */
+OMX_ERRORTYPE SEC_OMX_VideoDecodeComponentReset(OMX_IN OMX_HANDLETYPE hComponent)
+{
+    OMX_ERRORTYPE          ret = OMX_ErrorNone;
+    OMX_COMPONENTTYPE     *pOMXComponent = NULL;
+    SEC_OMX_BASECOMPONENT *pSECComponent = NULL;
+    SEC_OMX_DEC_PIPELINE  *pPipeline = NULL;
+
+    FunctionIn();
+
+    if (hComponent == NULL) {
+        ret = OMX_ErrorBadParameter;
+        goto EXIT;
+    }
+    pOMXComponent = (OMX_COMPONENTTYPE *)hComponent;
+    ret = SEC_OMX_Check_SizeVersion(pOMXComponent, sizeof(OMX_COMPONENTTYPE));
+    if (ret != OMX_ErrorNone) {
+        goto EXIT;
+    }
+
+    if (pOMXComponent->pComponentPrivate == NULL) {
+        ret = OMX_ErrorBadParameter;
+        goto EXIT;
+    }
+    pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+
+    pPipeline = (SEC_OMX_DEC_PIPELINE *)pSECComponent->hDecPipeline;
+    if ((pPipeline->hOutputThread != NULL) || (pPipeline->hFrameReady != NULL)) {
+        ret = OMX_ErrorIncorrectStateOperation;
+        goto EXIT;
+    }
+
+    ret = SEC_OMX_BaseComponent_Reset(pOMXComponent);
+    if (ret != OMX_ErrorNone) {
+        goto EXIT;
+    }
+    ret = SEC_OMX_Port_Reset(pOMXComponent);
+    if (ret != OMX_ErrorNone) {
+        goto EXIT;
+    }
+
+    SEC_OSAL_Memset(pSECComponent->hDecPipeline, 0, sizeof(SEC_OMX_DEC_PIPELINE));
+    SEC_OMX_VideoDecodeSetDefault(pSECComponent);
+
 EXIT:
     FunctionOut();
 
@@ -1378,6 +2238,13 @@ OMX_ERRORTYPE SEC_OMX_VideoDecodeComponentDeinit(OMX_IN OMX_HANDLETYPE hComponen
         pSECPort->portDefinition.format.video.cMIMEType = NULL;
     }
 
+    csc_parallel_close();
+
+    SEC_OSAL_Free(pSECComponent->hDecPipeline);
+    pSECComponent->hDecPipeline = NULL;
+    SEC_OSAL_SignalTerminate(pSECComponent->outputPauseEvent);
+    pSECComponent->outputPauseEvent = NULL;
+
     ret = SEC_OMX_Port_Destructor(pOMXComponent);
 
     ret = SEC_OMX_BaseComponent_Destructor(hComponent);
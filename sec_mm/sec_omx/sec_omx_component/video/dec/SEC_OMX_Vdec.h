@@ -33,6 +33,9 @@
 #include "SEC_OMX_Def.h"
 #include "SEC_OSAL_Queue.h"
 #include "SEC_OMX_Baseport.h"
+#include "SEC_OMX_Basecomponent.h"
+#include "SsbSipMfcApi.h"
+#include "color_space_convertor.h"
 
 #define MAX_VIDEO_INPUTBUFFER_NUM    5
 #define MAX_VIDEO_OUTPUTBUFFER_NUM   2
@@ -45,6 +48,15 @@
 
 #define MFC_INPUT_BUFFER_NUM_MAX         2
 #define DEFAULT_MFC_INPUT_BUFFER_SIZE    ((1280 * 720 * 3) / 2)
+/* Client input buffers in the MFC stream buffer, see SEC_MFC_DecOpen */
+#define MFC_CLIENT_BUFFER_ALIGN          2048
+#define MFC_CLIENT_BUFFER_SIZE_MAX       (3 * 1024 * 1024)
+
+/* Frames decoded ahead of output delivery, see OMX_IndexVendorDecodePipelineDepth */
+#define MAX_DEC_PIPELINE_DEPTH           4
+
+/* Color conversion of frames this large runs on all cores */
+#define PARALLEL_CSC_MIN_FRAME_SIZE      (1280 * 720)
 
 #define INPUT_PORT_SUPPORTFORMAT_NUM_MAX    1
 #define OUTPUT_PORT_SUPPORTFORMAT_NUM_MAX   3
@@ -76,8 +88,50 @@ typedef struct _MFC_DEC_INPUT_BUFFER
     void *VirAddr;      // virtual address
     int   bufferSize;   // input buffer alloc size
     int   dataSize;     // Data length
+
+    /* client buffer lent to the MFC in place of this slot, see SEC_MFC_DecInputTake */
+    OMX_BUFFERHEADERTYPE *pClientBuffer;
+    void *MFCPhyAddr;   // physical address of the slot in the MFC stream buffer
+    void *MFCVirAddr;   // virtual address of the slot in the MFC stream buffer
+    int   MFCBufferSize;
 } MFC_DEC_INPUT_BUFFER;
 
+/* Input port buffers handed out by AllocateBuffer from the MFC stream buffer */
+typedef struct _MFC_DEC_CLIENT_BUFFER
+{
+    void   *pVirBase;
+    void   *pPhyBase;
+    OMX_U32 slotSize;
+    OMX_U32 slotNum;
+} MFC_DEC_CLIENT_BUFFER;
+
+/* A decode result waiting for an output buffer */
+typedef struct _SEC_OMX_DEC_FRAME
+{
+    SEC_OMX_DATA               outputData;  /* as the codec left it, without a buffer */
+    OMX_BOOL                   bDeferred;   /* outputInfo still has to be copied out */
+    SSBSIP_MFC_DEC_OUTPUT_INFO outputInfo;
+} SEC_OMX_DEC_FRAME;
+
+/*
+ * With nDepth > 0 the buffer process thread only frames input and runs
+ * the MFC, SEC_OMX_OutputProcessThread fills and returns output buffers.
+ */
+typedef struct _SEC_OMX_DEC_PIPELINE
+{
+    OMX_U32            nDepth;
+    OMX_BOOL           bEnabled;
+    OMX_HANDLETYPE     hOutputThread;
+    OMX_HANDLETYPE     hFrameReady;    /* frames in frameQ */
+    OMX_HANDLETYPE     hFrameFree;     /* free entries of frame[] */
+    OMX_HANDLETYPE     hLock;          /* frameQ and nFlushCount */
+    SEC_RING           frameQ;
+    OMX_U32            nFlushCount;    /* port flushes, frames decoded before the last one are dropped */
+    SEC_OMX_DEC_FRAME  frame[MAX_DEC_PIPELINE_DEPTH];
+    OMX_U32            frameIndex;     /* next entry of frame[] to fill */
+    SEC_OMX_DEC_FRAME *pSubmitFrame;   /* entry the codec is filling now */
+} SEC_OMX_DEC_PIPELINE;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -121,6 +175,45 @@ OMX_ERRORTYPE SEC_OMX_VideoDecodeSetParameter(
     OMX_IN OMX_INDEXTYPE  nIndex,
     OMX_IN OMX_PTR        ComponentParameterStructure);
 OMX_ERRORTYPE SEC_OMX_VideoDecodeComponentDeinit(OMX_IN OMX_HANDLETYPE hComponent);
+OMX_ERRORTYPE SEC_OMX_VideoDecodeComponentReset(OMX_IN OMX_HANDLETYPE hComponent);
+OMX_PTR SEC_MFC_DecOpen(
+    MFC_DEC_INPUT_BUFFER  *pInputBuffer,
+    MFC_DEC_CLIENT_BUFFER *pClientBuffer,
+    OMX_U32                clientSlotSize,
+    OMX_U32                clientSlotNum);
+void SEC_MFC_DecClose(
+    OMX_PTR                hMFCHandle,
+    MFC_DEC_INPUT_BUFFER  *pInputBuffer,
+    MFC_DEC_CLIENT_BUFFER *pClientBuffer);
+OMX_ERRORTYPE SEC_MFC_DecClientBufferGet(
+    MFC_DEC_CLIENT_BUFFER *pClientBuffer,
+    OMX_U32                nIndex,
+    OMX_U32                nSizeBytes,
+    OMX_U8               **ppBuffer,
+    OMX_PTR               *ppPhyBuffer);
+void SEC_MFC_DecInputTake(
+    OMX_COMPONENTTYPE    *pOMXComponent,
+    MFC_DEC_INPUT_BUFFER *pSlot,
+    SEC_OMX_DATA         *pInputData,
+    OMX_BOOL              bLend);
+void SEC_MFC_DecInputRelease(
+    OMX_COMPONENTTYPE    *pOMXComponent,
+    MFC_DEC_INPUT_BUFFER *pInputBuffer,
+    OMX_U32               nIndex,
+    OMX_BOOL              bAll);
+OMX_U32 SEC_OMX_DecPipelineDepth(OMX_COMPONENTTYPE *pOMXComponent);
+OMX_BOOL SEC_OMX_DecFrameDefer(OMX_COMPONENTTYPE *pOMXComponent, SSBSIP_MFC_DEC_OUTPUT_INFO *pOutputInfo);
+int SEC_FindStartCode(
+    OMX_U8 *pStream,
+    int     streamSize,
+    OMX_U8  codeMask,
+    OMX_U8  code);
+void SEC_TiledToLinearFrame(
+    CSC_LINEAR_FRAME *pDest,
+    OMX_PTR           pYSrc,
+    OMX_PTR           pCSrc,
+    CSC_TILE_MAP     *pYMap,
+    CSC_TILE_MAP     *pCMap);
 
 #ifdef __cplusplus
 }
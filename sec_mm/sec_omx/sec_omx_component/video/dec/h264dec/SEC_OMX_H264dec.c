@@ -81,13 +81,15 @@ SEC_OMX_VIDEO_PROFILELEVEL supportedAVCProfileLevels[] ={
     {OMX_VIDEO_AVCProfileHigh, OMX_VIDEO_AVCLevel31}};
 
 
+/*
+ * A frame ends before an AUD, or before a slice with first_mb_in_slice 0
+ * (its first bit is set) once a slice, SPS or PPS has been seen.
+ */
 static int Check_H264_Frame(OMX_U8 *pInputStream, int buffSize, OMX_U32 flag, OMX_BOOL bPreviousFrameEOF, OMX_BOOL *pbEndOfFrame)
 {
-    OMX_U32  preFourByte       = (OMX_U32)-1;
-    int      accessUnitSize    = 0;
-    int      frameTypeBoundary = 0;
-    int      nextNaluSize      = 0;
-    int      naluStart         = 0;
+    int      startCode  = 0;
+    int      naluHeader = 0;
+    int      naluStart  = 0;
 
     if (bPreviousFrameEOF == OMX_TRUE)
         naluStart = 0;
@@ -95,64 +97,47 @@ static int Check_H264_Frame(OMX_U8 *pInputStream, int buffSize, OMX_U32 flag, OM
         naluStart = 1;
 
     while (1) {
-        int inputOneByte = 0;
+        int naluType = 0;
 
-        if (accessUnitSize == buffSize)
+        startCode = naluHeader + SEC_FindStartCode(pInputStream + naluHeader, buffSize - naluHeader, 0xFF, 0x01);
+        naluHeader = startCode + 3;
+        if (naluHeader >= buffSize) {
+            naluHeader = buffSize;
             goto EXIT;
+        }
 
-        inputOneByte = *(pInputStream++);
-        accessUnitSize += 1;
-
-        if (preFourByte == 0x00000001 || (preFourByte << 8) == 0x00000100) {
-            int naluType = inputOneByte & 0x1F;
+        naluType = pInputStream[naluHeader] & 0x1F;
 
-            SEC_OSAL_Log(SEC_LOG_TRACE, "NaluType : %d", naluType);
-            if (naluStart == 0) {
+        SEC_OSAL_Log(SEC_LOG_TRACE, "NaluType : %d", naluType);
+        if (naluStart == 0) {
 #ifdef ADD_SPS_PPS_I_FRAME
-                if (naluType == 1 || naluType == 5)
+            if (naluType == 1 || naluType == 5)
 #else
-                if (naluType == 1 || naluType == 5 || naluType == 7 || naluType == 8)
+            if (naluType == 1 || naluType == 5 || naluType == 7 || naluType == 8)
 #endif
-                    naluStart = 1;
-            } else {
-#ifdef OLD_DETECT
-                frameTypeBoundary = (8 - naluType) & (naluType - 10); //AUD(9)
-#else
-                if (naluType == 9)
-                    frameTypeBoundary = -2;
-#endif
-                if (naluType == 1 || naluType == 5) {
-                    if (accessUnitSize == buffSize) {
-                        accessUnitSize--;
-                        goto EXIT;
-                    }
-                    inputOneByte = *pInputStream++;
-                    accessUnitSize += 1;
-
-                    if (inputOneByte >= 0x80)
-                        frameTypeBoundary = -1;
-                }
-                if (frameTypeBoundary < 0) {
+                naluStart = 1;
+        } else {
+            if (naluType == 9)
+                break;
+            if (naluType == 1 || naluType == 5) {
+                if (naluHeader + 1 == buffSize)
+                    goto EXIT;
+                if (pInputStream[naluHeader + 1] >= 0x80)
                     break;
-                }
             }
-
         }
-        preFourByte = (preFourByte << 8) + inputOneByte;
     }
 
     *pbEndOfFrame = OMX_TRUE;
-    nextNaluSize = -5;
-    if (frameTypeBoundary == -1)
-        nextNaluSize = -6;
-    if (preFourByte != 0x00000001)
-        nextNaluSize++;
-    return (accessUnitSize + nextNaluSize);
+    /* the frame ends before the leading zero of a four byte start code */
+    if ((startCode > 0) && (pInputStream[startCode - 1] == 0x00))
+        startCode--;
+    return startCode;
 
 EXIT:
     *pbEndOfFrame = OMX_FALSE;
 
-    return accessUnitSize;
+    return naluHeader;
 }
 
 OMX_BOOL Check_H264_StartCode(OMX_U8 *pInputStream, OMX_U32 streamSize)
@@ -428,7 +413,8 @@ OMX_ERRORTYPE SEC_MFC_H264Dec_SetParameter(
                 goto EXIT;
             }
         }
-        if(pPortDefinition->nBufferCountActual < pSECPort->portDefinition.nBufferCountMin) {
+        if ((pPortDefinition->nBufferCountActual < pSECPort->portDefinition.nBufferCountMin) ||
+            (pPortDefinition->nBufferCountActual > MAX_BUFFER_NUM)) {
             ret = OMX_ErrorBadParameter;
             goto EXIT;
         }
@@ -697,6 +683,9 @@ OMX_ERRORTYPE SEC_MFC_H264Dec_GetExtensionIndex(
         SEC_H264DEC_HANDLE *pH264Dec = (SEC_H264DEC_HANDLE *)pSECComponent->hCodecHandle;
         *pIndexType = OMX_IndexVendorThumbnailMode;
         ret = OMX_ErrorNone;
+    } else if (SEC_OSAL_Strcmp(cParameterName, SEC_INDEX_PARAM_DECODE_PIPELINE_DEPTH) == 0) {
+        *pIndexType = OMX_IndexVendorDecodePipelineDepth;
+        ret = OMX_ErrorNone;
 #ifdef USE_ANDROID_EXTENSION
     } else if (SEC_OSAL_Strcmp(cParameterName, SEC_INDEX_PARAM_ENABLE_ANB) == 0) {
         *pIndexType = OMX_IndexParamEnableAndroidBuffers;
@@ -764,7 +753,10 @@ OMX_ERRORTYPE SEC_MFC_DecodeThread(OMX_HANDLETYPE hComponent)
         SEC_OSAL_SemaphoreWait(pH264Dec->NBDecThread.hDecFrameStart);
 
         if (pH264Dec->NBDecThread.bExitDecodeThread == OMX_FALSE) {
+            OMX_U64 decodeStartUs = SEC_OSAL_GetSystemTimeUs();
+
             pH264Dec->hMFCH264Handle.returnCodec = SsbSipMfcDecExe(pH264Dec->hMFCH264Handle.hMFCHandle, pH264Dec->NBDecThread.oneFrameSize);
+            SEC_OMX_StatsAdd(&pSECComponent->stats, SEC_OMX_STATS_MFC, decodeStartUs);
             SEC_OSAL_SemaphorePost(pH264Dec->NBDecThread.hDecFrameEnd);
         }
     }
@@ -776,6 +768,69 @@ EXIT:
     return ret;
 }
 
+/* Input port buffer nIndex in the stream buffer, the MFC is opened for it */
+OMX_ERRORTYPE SEC_MFC_H264Dec_AllocateInputBuffer(
+    OMX_COMPONENTTYPE *pOMXComponent,
+    OMX_U32            nIndex,
+    OMX_U32            nSizeBytes,
+    OMX_U8           **ppBuffer,
+    OMX_PTR           *ppPhyBuffer)
+{
+    OMX_ERRORTYPE          ret = OMX_ErrorNone;
+    SEC_OMX_BASECOMPONENT *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    SEC_H264DEC_HANDLE    *pH264Dec = (SEC_H264DEC_HANDLE *)pSECComponent->hCodecHandle;
+    SEC_OMX_BASEPORT      *pSECInputPort = &pSECComponent->pSECPort[INPUT_PORT_INDEX];
+    OMX_U32                slotSize = pSECInputPort->portDefinition.nBufferSize;
+
+    FunctionIn();
+
+    if (pH264Dec->hMFCH264Handle.hMFCHandle == NULL) {
+        if (slotSize < nSizeBytes)
+            slotSize = nSizeBytes;
+        pH264Dec->hMFCH264Handle.hMFCHandle = SEC_MFC_DecOpen(pH264Dec->MFCDecInputBuffer, &pH264Dec->MFCDecClientBuffer,
+            slotSize, pSECInputPort->portDefinition.nBufferCountActual);
+        if (pH264Dec->hMFCH264Handle.hMFCHandle == NULL) {
+            ret = OMX_ErrorInsufficientResources;
+            goto EXIT;
+        }
+    }
+
+    ret = SEC_MFC_DecClientBufferGet(&pH264Dec->MFCDecClientBuffer, nIndex, nSizeBytes, ppBuffer, ppPhyBuffer);
+
+EXIT:
+    FunctionOut();
+
+    return ret;
+}
+
+/* Gives back input port buffers the MFC reads in place */
+OMX_ERRORTYPE SEC_MFC_H264Dec_ReleaseInputBuffer(OMX_COMPONENTTYPE *pOMXComponent, OMX_BOOL bAll)
+{
+    OMX_ERRORTYPE          ret = OMX_ErrorNone;
+    SEC_OMX_BASECOMPONENT *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    SEC_H264DEC_HANDLE    *pH264Dec = (SEC_H264DEC_HANDLE *)pSECComponent->hCodecHandle;
+
+    FunctionIn();
+
+    if (pH264Dec->hMFCH264Handle.hMFCHandle == NULL)
+        goto EXIT;
+
+    /* wait for mfc decode done, it may read a lent buffer */
+    if ((bAll == OMX_TRUE) && (pH264Dec->NBDecThread.bDecoderRun == OMX_TRUE)) {
+        SEC_OSAL_SemaphoreWait(pH264Dec->NBDecThread.hDecFrameEnd);
+        pH264Dec->NBDecThread.bDecoderRun = OMX_FALSE;
+    }
+
+    SEC_MFC_DecInputRelease(pOMXComponent, pH264Dec->MFCDecInputBuffer, pH264Dec->indexInputBuffer, bAll);
+    pH264Dec->hMFCH264Handle.pMFCStreamBuffer    = pH264Dec->MFCDecInputBuffer[pH264Dec->indexInputBuffer].VirAddr;
+    pH264Dec->hMFCH264Handle.pMFCStreamPhyBuffer = pH264Dec->MFCDecInputBuffer[pH264Dec->indexInputBuffer].PhyAddr;
+
+EXIT:
+    FunctionOut();
+
+    return ret;
+}
+
 /* MFC Init */
 OMX_ERRORTYPE SEC_MFC_H264Dec_Init(OMX_COMPONENTTYPE *pOMXComponent)
 {
@@ -783,39 +838,19 @@ OMX_ERRORTYPE SEC_MFC_H264Dec_Init(OMX_COMPONENTTYPE *pOMXComponent)
     SEC_OMX_BASECOMPONENT *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
     SEC_H264DEC_HANDLE    *pH264Dec = NULL;
 
-    OMX_PTR hMFCHandle       = NULL;
-    OMX_PTR pStreamBuffer    = NULL;
-    OMX_PTR pStreamPhyBuffer = NULL;
-
     pH264Dec = (SEC_H264DEC_HANDLE *)pSECComponent->hCodecHandle;
     pH264Dec->hMFCH264Handle.bConfiguredMFC = OMX_FALSE;
     pSECComponent->bUseFlagEOF = OMX_FALSE;
     pSECComponent->bSaveFlagEOS = OMX_FALSE;
 
-    /* MFC(Multi Function Codec) decoder and CMM(Codec Memory Management) driver open */
-    SSBIP_MFC_BUFFER_TYPE buf_type = CACHE;
-    hMFCHandle = (OMX_PTR)SsbSipMfcDecOpen(&buf_type);
-    if (hMFCHandle == NULL) {
-        ret = OMX_ErrorInsufficientResources;
-        goto EXIT;
-    }
-    pH264Dec->hMFCH264Handle.hMFCHandle = hMFCHandle;
-
-    /* Allocate decoder's input buffer */
-    pStreamBuffer = SsbSipMfcDecGetInBuf(hMFCHandle, &pStreamPhyBuffer, DEFAULT_MFC_INPUT_BUFFER_SIZE * MFC_INPUT_BUFFER_NUM_MAX);
-    if (pStreamBuffer == NULL) {
-        ret = OMX_ErrorInsufficientResources;
-        goto EXIT;
+    /* Already open when the input port buffers were allocated in the stream buffer */
+    if (pH264Dec->hMFCH264Handle.hMFCHandle == NULL) {
+        pH264Dec->hMFCH264Handle.hMFCHandle = SEC_MFC_DecOpen(pH264Dec->MFCDecInputBuffer, &pH264Dec->MFCDecClientBuffer, 0, 0);
+        if (pH264Dec->hMFCH264Handle.hMFCHandle == NULL) {
+            ret = OMX_ErrorInsufficientResources;
+            goto EXIT;
+        }
     }
-
-    pH264Dec->MFCDecInputBuffer[0].VirAddr = pStreamBuffer;
-    pH264Dec->MFCDecInputBuffer[0].PhyAddr = pStreamPhyBuffer;
-    pH264Dec->MFCDecInputBuffer[0].bufferSize = DEFAULT_MFC_INPUT_BUFFER_SIZE;
-    pH264Dec->MFCDecInputBuffer[0].dataSize = 0;
-    pH264Dec->MFCDecInputBuffer[1].VirAddr = (unsigned char *)pStreamBuffer + pH264Dec->MFCDecInputBuffer[0].bufferSize;
-    pH264Dec->MFCDecInputBuffer[1].PhyAddr = (unsigned char *)pStreamPhyBuffer + pH264Dec->MFCDecInputBuffer[0].bufferSize;
-    pH264Dec->MFCDecInputBuffer[1].bufferSize = DEFAULT_MFC_INPUT_BUFFER_SIZE;
-    pH264Dec->MFCDecInputBuffer[1].dataSize = 0;
     pH264Dec->indexInputBuffer = 0;
 
     pH264Dec->bFirstFrame = OMX_TRUE;
@@ -836,9 +871,11 @@ OMX_ERRORTYPE SEC_MFC_H264Dec_Init(OMX_COMPONENTTYPE *pOMXComponent)
     pSECComponent->processData[INPUT_PORT_INDEX].dataBuffer = pH264Dec->MFCDecInputBuffer[0].VirAddr;
     pSECComponent->processData[INPUT_PORT_INDEX].allocSize  = pH264Dec->MFCDecInputBuffer[0].bufferSize;
 
-    SEC_OSAL_Memset(pSECComponent->timeStamp, -19771003, sizeof(OMX_TICKS) * MAX_TIMESTAMP);
-    SEC_OSAL_Memset(pSECComponent->nFlags, 0, sizeof(OMX_U32) * MAX_FLAGS);
-    pH264Dec->hMFCH264Handle.indexTimestamp = 0;
+    /* a tag for each frame the MFC may hold: DPB, display delay and the decode pipeline */
+    ret = SEC_OMX_FrameTagCreate(&pSECComponent->frameTagMap,
+                                 H264_DEC_MAX_DPB + H264_DEC_DISPLAY_DELAY + MAX_DEC_PIPELINE_DEPTH + MFC_INPUT_BUFFER_NUM_MAX);
+    if (ret != OMX_ErrorNone)
+        goto EXIT;
     pSECComponent->getAllDelayBuffer = OMX_FALSE;
 
 EXIT:
@@ -858,6 +895,8 @@ OMX_ERRORTYPE SEC_MFC_H264Dec_Terminate(OMX_COMPONENTTYPE *pOMXComponent)
     pH264Dec = (SEC_H264DEC_HANDLE *)pSECComponent->hCodecHandle;
     hMFCHandle = pH264Dec->hMFCH264Handle.hMFCHandle;
 
+    SEC_MFC_H264Dec_ReleaseInputBuffer(pOMXComponent, OMX_TRUE);
+
     pH264Dec->hMFCH264Handle.pMFCStreamBuffer    = NULL;
     pH264Dec->hMFCH264Handle.pMFCStreamPhyBuffer = NULL;
     pSECComponent->processData[INPUT_PORT_INDEX].dataBuffer = NULL;
@@ -881,10 +920,134 @@ OMX_ERRORTYPE SEC_MFC_H264Dec_Terminate(OMX_COMPONENTTYPE *pOMXComponent)
     }
 
     if (hMFCHandle != NULL) {
-        SsbSipMfcDecClose(hMFCHandle);
+        SEC_MFC_DecClose(hMFCHandle, pH264Dec->MFCDecInputBuffer, &pH264Dec->MFCDecClientBuffer);
         hMFCHandle = pH264Dec->hMFCH264Handle.hMFCHandle = NULL;
     }
 
+    csc_tile_map_release(&pH264Dec->hMFCH264Handle.tileMapY);
+    csc_tile_map_release(&pH264Dec->hMFCH264Handle.tileMapC);
+
+    SEC_OMX_FrameTagTerminate(&pSECComponent->frameTagMap);
+
+EXIT:
+    FunctionOut();
+
+    return ret;
+}
+
+/* Fills an output buffer from a frame in the MFC DPB, on the output thread in a decode pipeline */
+OMX_ERRORTYPE SEC_MFC_H264Dec_FillOutput(OMX_COMPONENTTYPE *pOMXComponent, OMX_PTR pOutputInfo, SEC_OMX_DATA *pOutputData)
+{
+    OMX_ERRORTYPE              ret = OMX_ErrorNone;
+    SEC_OMX_BASECOMPONENT     *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    SEC_H264DEC_HANDLE        *pH264Dec = (SEC_H264DEC_HANDLE *)pSECComponent->hCodecHandle;
+    SEC_OMX_BASEPORT          *pSECInputPort = &pSECComponent->pSECPort[INPUT_PORT_INDEX];
+    SEC_OMX_BASEPORT          *pSECOutputPort = &pSECComponent->pSECPort[OUTPUT_PORT_INDEX];
+    SSBSIP_MFC_DEC_OUTPUT_INFO outputInfo;
+    void                      *pOutputBuf[3];
+    int                        bufWidth = 0;
+    int                        bufHeight = 0;
+    int                        frameSize = 0;
+    int                        actualWidth = 0;
+    int                        actualHeight = 0;
+    int                        actualImageSize = 0;
+    OMX_U64                    cscStartUs = 0;
+
+    FunctionIn();
+
+    SEC_OSAL_Memcpy(&outputInfo, pOutputInfo, sizeof(SSBSIP_MFC_DEC_OUTPUT_INFO));
+    bufWidth  = (outputInfo.img_width + 15) & (~15);
+    bufHeight = (outputInfo.img_height + 15) & (~15);
+
+    frameSize = bufWidth * bufHeight;
+    actualWidth  = outputInfo.img_width;
+    actualHeight = outputInfo.img_height;
+    actualImageSize = actualWidth * actualHeight;
+
+    pOutputBuf[0] = (void *)pOutputData->dataBuffer;
+    pOutputBuf[1] = (void *)pOutputData->dataBuffer + actualImageSize;
+    pOutputBuf[2] = (void *)pOutputData->dataBuffer + ((actualImageSize * 5) / 4);
+
+#ifdef USE_ANDROID_EXTENSION
+    if (pSECOutputPort->bUseAndroidNativeBuffer == OMX_TRUE) {
+        OMX_U32 retANB = 0;
+        void *pVirAddrs[2];
+        actualWidth  = (outputInfo.img_width + 15) & (~15);
+        actualImageSize = actualWidth * actualHeight;
+
+        retANB = getVADDRfromANB (pOutputData->dataBuffer,
+                        (OMX_U32)pSECInputPort->portDefinition.format.video.nFrameWidth,
+                        (OMX_U32)pSECInputPort->portDefinition.format.video.nFrameHeight,
+                        pVirAddrs);
+        if (retANB != 0) {
+            SEC_OSAL_Log(SEC_LOG_ERROR, "Error getVADDRfromANB, Error code:%d", retANB);
+            ret = OMX_ErrorOverflow;
+            goto EXIT;
+        }
+        pOutputBuf[0] = pVirAddrs[0];
+        pOutputBuf[1] = pVirAddrs[1];
+    }
+#endif
+    if ((pH264Dec->hMFCH264Handle.bThumbnailMode == OMX_FALSE) &&
+        (pSECOutputPort->portDefinition.format.video.eColorFormat == OMX_SEC_COLOR_FormatNV12TPhysicalAddress))
+    {
+        /* if use Post copy address structure */
+        SEC_OSAL_Memcpy(pOutputBuf[0], &frameSize, sizeof(frameSize));
+        SEC_OSAL_Memcpy(pOutputBuf[0] + sizeof(frameSize), &(outputInfo.YPhyAddr), sizeof(outputInfo.YPhyAddr));
+        SEC_OSAL_Memcpy(pOutputBuf[0] + sizeof(frameSize) + (sizeof(void *) * 1), &(outputInfo.CPhyAddr), sizeof(outputInfo.CPhyAddr));
+        SEC_OSAL_Memcpy(pOutputBuf[0] + sizeof(frameSize) + (sizeof(void *) * 2), &(outputInfo.YVirAddr), sizeof(outputInfo.YVirAddr));
+        SEC_OSAL_Memcpy(pOutputBuf[0] + sizeof(frameSize) + (sizeof(void *) * 3), &(outputInfo.CVirAddr), sizeof(outputInfo.CVirAddr));
+        pOutputData->dataLen = (bufWidth * bufHeight * 3) / 2;
+    } else if ((csc_tile_map_update(&pH264Dec->hMFCH264Handle.tileMapY, outputInfo.img_width, outputInfo.img_height) != 0) ||
+               (csc_tile_map_update(&pH264Dec->hMFCH264Handle.tileMapC, outputInfo.img_width, outputInfo.img_height >> 1) != 0)) {
+        SEC_OSAL_Log(SEC_LOG_ERROR, "Failed to build tile map for %dx%d", actualWidth, actualHeight);
+        pOutputData->dataLen = 0;
+        ret = OMX_ErrorInsufficientResources;
+    } else {
+        CSC_LINEAR_FRAME linearFrame;
+
+        switch (pSECOutputPort->portDefinition.format.video.eColorFormat) {
+        case OMX_COLOR_FormatYUV420Planar:
+        {
+            SEC_OSAL_Log(SEC_LOG_TRACE, "YUV420P out");
+            linearFrame.layout = CSC_LAYOUT_I420;
+            linearFrame.plane[0] = (char *)pOutputBuf[0];
+            linearFrame.plane[1] = (char *)pOutputBuf[1];
+            linearFrame.plane[2] = (char *)pOutputBuf[2];
+            linearFrame.stride[0] = actualWidth;
+            linearFrame.stride[1] = actualWidth >> 1;
+            linearFrame.stride[2] = actualWidth >> 1;
+        }
+            break;
+        case OMX_COLOR_FormatYUV420SemiPlanar:
+        case OMX_SEC_COLOR_FormatANBYUV420SemiPlanar:
+        default:
+        {
+            SEC_OSAL_Log(SEC_LOG_TRACE, "YUV420SP out");
+            linearFrame.layout = CSC_LAYOUT_NV12;
+            linearFrame.plane[0] = (char *)pOutputBuf[0];
+            linearFrame.plane[1] = (char *)pOutputBuf[1];
+            linearFrame.plane[2] = NULL;
+            linearFrame.stride[0] = actualWidth;
+            linearFrame.stride[1] = actualWidth;
+            linearFrame.stride[2] = 0;
+        }
+            break;
+        }
+        cscStartUs = SEC_OSAL_GetSystemTimeUs();
+        SEC_TiledToLinearFrame(&linearFrame,
+            outputInfo.YVirAddr,
+            outputInfo.CVirAddr,
+            &pH264Dec->hMFCH264Handle.tileMapY,
+            &pH264Dec->hMFCH264Handle.tileMapC);
+        SEC_OMX_StatsAdd(&pSECComponent->stats, SEC_OMX_STATS_CSC, cscStartUs);
+        pOutputData->dataLen = actualImageSize * 3 / 2;
+    }
+#ifdef USE_ANDROID_EXTENSION
+    if (pSECOutputPort->bUseAndroidNativeBuffer == OMX_TRUE)
+        putVADDRtoANB(pOutputData->dataBuffer);
+#endif
+
 EXIT:
     FunctionOut();
 
@@ -899,12 +1062,23 @@ OMX_ERRORTYPE SEC_MFC_H264_Decode(OMX_COMPONENTTYPE *pOMXComponent, SEC_OMX_DATA
     OMX_U32                    oneFrameSize = pInputData->dataLen;
     SSBSIP_MFC_DEC_OUTPUT_INFO outputInfo;
     OMX_S32                    setConfVal = 0;
-    int                        bufWidth = 0;
-    int                        bufHeight = 0;
     OMX_BOOL                   outputDataValid = OMX_FALSE;
+    SEC_OMX_FRAME_META         inputMeta;
+    SEC_OMX_FRAME_META         outputMeta;
+    int                        frameTag = -1;
 
     FunctionIn();
 
+    /* a frame lent from an input port buffer, see SEC_Preprocessor_InputData */
+    if (pInputData->bufferHeader != NULL) {
+        MFC_DEC_INPUT_BUFFER *pSlot = &pH264Dec->MFCDecInputBuffer[pH264Dec->indexInputBuffer];
+
+        SEC_MFC_DecInputTake(pOMXComponent, pSlot, pInputData, pH264Dec->hMFCH264Handle.bConfiguredMFC);
+        pH264Dec->hMFCH264Handle.pMFCStreamBuffer    = pSlot->VirAddr;
+        pH264Dec->hMFCH264Handle.pMFCStreamPhyBuffer = pSlot->PhyAddr;
+        oneFrameSize = pInputData->dataLen;
+    }
+
     if (pH264Dec->hMFCH264Handle.bConfiguredMFC == OMX_FALSE) {
         SSBSIP_MFC_CODEC_TYPE eCodecType = H264_DEC;
 
@@ -915,15 +1089,16 @@ OMX_ERRORTYPE SEC_MFC_H264_Decode(OMX_COMPONENTTYPE *pOMXComponent, SEC_OMX_DATA
             goto EXIT;
         }
 
-        setConfVal = 0;
+        /* frames queued in the decode pipeline stay in the DPB until they are filled */
+        setConfVal = SEC_OMX_DecPipelineDepth(pOMXComponent);
         SsbSipMfcDecSetConfig(pH264Dec->hMFCH264Handle.hMFCHandle, MFC_DEC_SETCONF_EXTRA_BUFFER_NUM, &setConfVal);
 
         /* Default number in the driver is optimized */
         if (pH264Dec->hMFCH264Handle.bThumbnailMode == OMX_TRUE) {
-            setConfVal = 1;
+            setConfVal = H264_DEC_THUMBNAIL_DISPLAY_DELAY;
             SsbSipMfcDecSetConfig(pH264Dec->hMFCH264Handle.hMFCHandle, MFC_DEC_SETCONF_DISPLAY_DELAY, &setConfVal);
         } else {
-            setConfVal = 8;
+            setConfVal = H264_DEC_DISPLAY_DELAY;
             SsbSipMfcDecSetConfig(pH264Dec->hMFCH264Handle.hMFCHandle, MFC_DEC_SETCONF_DISPLAY_DELAY, &setConfVal);
         }
 
@@ -1014,13 +1189,13 @@ OMX_ERRORTYPE SEC_MFC_H264_Decode(OMX_COMPONENTTYPE *pOMXComponent, SEC_OMX_DATA
         pSECComponent->bUseFlagEOF = OMX_TRUE;
 #endif
 
-    pSECComponent->timeStamp[pH264Dec->hMFCH264Handle.indexTimestamp] = pInputData->timeStamp;
-    pSECComponent->nFlags[pH264Dec->hMFCH264Handle.indexTimestamp] = pInputData->nFlags;
+    inputMeta.timeStamp = pInputData->timeStamp;
+    inputMeta.nFlags    = pInputData->nFlags;
+    inputMeta.nEmptyTimeUs = pInputData->nEmptyTimeUs;
 
     if ((pH264Dec->hMFCH264Handle.returnCodec == MFC_RET_OK) &&
         (pH264Dec->bFirstFrame == OMX_FALSE)) {
         SSBSIP_MFC_DEC_OUTBUF_STATUS status;
-        OMX_S32 indexTimestamp = 0;
 
         /* wait for mfc decode done */
         if (pH264Dec->NBDecThread.bDecoderRun == OMX_TRUE) {
@@ -1029,16 +1204,17 @@ OMX_ERRORTYPE SEC_MFC_H264_Decode(OMX_COMPONENTTYPE *pOMXComponent, SEC_OMX_DATA
         }
 
         status = SsbSipMfcDecGetOutBuf(pH264Dec->hMFCH264Handle.hMFCHandle, &outputInfo);
-        bufWidth  = (outputInfo.img_width + 15) & (~15);
-        bufHeight = (outputInfo.img_height + 15) & (~15);
 
-        if ((SsbSipMfcDecGetConfig(pH264Dec->hMFCH264Handle.hMFCHandle, MFC_DEC_GETCONF_FRAME_TAG, &indexTimestamp) != MFC_RET_OK) ||
-            (((indexTimestamp < 0) || (indexTimestamp >= MAX_TIMESTAMP)))) {
+        if ((SsbSipMfcDecGetConfig(pH264Dec->hMFCH264Handle.hMFCHandle, MFC_DEC_GETCONF_FRAME_TAG, &frameTag) != MFC_RET_OK) ||
+            (SEC_OMX_FrameTagTake(&pSECComponent->frameTagMap, frameTag, &outputMeta) != OMX_TRUE)) {
             pOutputData->timeStamp = pInputData->timeStamp;
             pOutputData->nFlags = pInputData->nFlags;
+            pOutputData->nEmptyTimeUs = pInputData->nEmptyTimeUs;
         } else {
-            pOutputData->timeStamp = pSECComponent->timeStamp[indexTimestamp];
-            pOutputData->nFlags = pSECComponent->nFlags[indexTimestamp];
+            pOutputData->timeStamp = outputMeta.timeStamp;
+            pOutputData->nFlags = outputMeta.nFlags;
+            pOutputData->nEmptyTimeUs = outputMeta.nEmptyTimeUs;
+            SEC_OMX_StatsAdd(&pSECComponent->stats, SEC_OMX_STATS_REORDER, outputMeta.nSubmitTimeUs);
         }
         SEC_OSAL_Log(SEC_LOG_TRACE, "timestamp %lld us (%.2f secs)", pOutputData->timeStamp, pOutputData->timeStamp / 1E6);
 
@@ -1117,9 +1293,11 @@ OMX_ERRORTYPE SEC_MFC_H264_Decode(OMX_COMPONENTTYPE *pOMXComponent, SEC_OMX_DATA
 
     if ((Check_H264_StartCode(pInputData->dataBuffer, pInputData->dataLen) == OMX_TRUE) &&
         ((pOutputData->nFlags & OMX_BUFFERFLAG_EOS) != OMX_BUFFERFLAG_EOS)) {
-        SsbSipMfcDecSetConfig(pH264Dec->hMFCH264Handle.hMFCHandle, MFC_DEC_SETCONF_FRAME_TAG, &(pH264Dec->hMFCH264Handle.indexTimestamp));
-        pH264Dec->hMFCH264Handle.indexTimestamp++;
-        pH264Dec->hMFCH264Handle.indexTimestamp %= MAX_TIMESTAMP;
+        inputMeta.nStreamSize   = oneFrameSize;
+        inputMeta.nSubmitTimeUs = SEC_OSAL_GetSystemTimeUs();
+        frameTag = SEC_OMX_FrameTagPut(&pSECComponent->frameTagMap, &inputMeta);
+        SEC_OMX_StatsFrameIn(&pSECComponent->stats, oneFrameSize);
+        SsbSipMfcDecSetConfig(pH264Dec->hMFCH264Handle.hMFCHandle, MFC_DEC_SETCONF_FRAME_TAG, &frameTag);
 
         SsbSipMfcDecSetInBuf(pH264Dec->hMFCH264Handle.hMFCHandle,
                              pH264Dec->hMFCH264Handle.pMFCStreamPhyBuffer,
@@ -1149,95 +1327,14 @@ OMX_ERRORTYPE SEC_MFC_H264_Decode(OMX_COMPONENTTYPE *pOMXComponent, SEC_OMX_DATA
     }
 
     /** Fill Output Buffer **/
-    if (outputDataValid == OMX_TRUE) {
-        SEC_OMX_BASEPORT *pSECInputPort = &pSECComponent->pSECPort[INPUT_PORT_INDEX];
-        SEC_OMX_BASEPORT *pSECOutputPort = &pSECComponent->pSECPort[OUTPUT_PORT_INDEX];
-        void *pOutputBuf[3];
-
-        int frameSize = bufWidth * bufHeight;
-        int imageSize = outputInfo.img_width * outputInfo.img_height;
-
-        int actualWidth  = outputInfo.img_width;
-        int actualHeight = outputInfo.img_height;
-        int actualImageSize = imageSize;
-
-        pOutputBuf[0] = (void *)pOutputData->dataBuffer;
-        pOutputBuf[1] = (void *)pOutputData->dataBuffer + actualImageSize;
-        pOutputBuf[2] = (void *)pOutputData->dataBuffer + ((actualImageSize * 5) / 4);
-
-#ifdef USE_ANDROID_EXTENSION
-        if (pSECOutputPort->bUseAndroidNativeBuffer == OMX_TRUE) {
-            OMX_U32 retANB = 0;
-            void *pVirAddrs[2];
-            actualWidth  = (outputInfo.img_width + 15) & (~15);
-            actualImageSize = actualWidth * actualHeight;
-
-            retANB = getVADDRfromANB (pOutputData->dataBuffer,
-                            (OMX_U32)pSECInputPort->portDefinition.format.video.nFrameWidth,
-                            (OMX_U32)pSECInputPort->portDefinition.format.video.nFrameHeight,
-                            pVirAddrs);
-            if (retANB != 0) {
-                SEC_OSAL_Log(SEC_LOG_ERROR, "Error getVADDRfromANB, Error code:%d", retANB);
-                ret = OMX_ErrorOverflow;
-                goto EXIT;
-            }
-            pOutputBuf[0] = pVirAddrs[0];
-            pOutputBuf[1] = pVirAddrs[1];
-        }
-#endif
-        if ((pH264Dec->hMFCH264Handle.bThumbnailMode == OMX_FALSE) &&
-            (pSECOutputPort->portDefinition.format.video.eColorFormat == OMX_SEC_COLOR_FormatNV12TPhysicalAddress))
-        {
-            /* if use Post copy address structure */
-            SEC_OSAL_Memcpy(pOutputBuf[0], &frameSize, sizeof(frameSize));
-            SEC_OSAL_Memcpy(pOutputBuf[0] + sizeof(frameSize), &(outputInfo.YPhyAddr), sizeof(outputInfo.YPhyAddr));
-            SEC_OSAL_Memcpy(pOutputBuf[0] + sizeof(frameSize) + (sizeof(void *) * 1), &(outputInfo.CPhyAddr), sizeof(outputInfo.CPhyAddr));
-            SEC_OSAL_Memcpy(pOutputBuf[0] + sizeof(frameSize) + (sizeof(void *) * 2), &(outputInfo.YVirAddr), sizeof(outputInfo.YVirAddr));
-            SEC_OSAL_Memcpy(pOutputBuf[0] + sizeof(frameSize) + (sizeof(void *) * 3), &(outputInfo.CVirAddr), sizeof(outputInfo.CVirAddr));
-            pOutputData->dataLen = (bufWidth * bufHeight * 3) / 2;
-        } else {
-            switch (pSECOutputPort->portDefinition.format.video.eColorFormat) {
-            case OMX_COLOR_FormatYUV420Planar:
-            {
-                SEC_OSAL_Log(SEC_LOG_TRACE, "YUV420P out");
-                csc_tiled_to_linear(
-                    (unsigned char *)pOutputBuf[0],
-                    (unsigned char *)outputInfo.YVirAddr,
-                    actualWidth,
-                    actualHeight);
-                csc_tiled_to_linear_deinterleave(
-                    (unsigned char *)pOutputBuf[1],
-                    (unsigned char *)pOutputBuf[2],
-                    (unsigned char *)outputInfo.CVirAddr,
-                    actualWidth,
-                    actualHeight >> 1);
-                pOutputData->dataLen = actualImageSize * 3 / 2;
-            }
-                break;
-            case OMX_COLOR_FormatYUV420SemiPlanar:
-            case OMX_SEC_COLOR_FormatANBYUV420SemiPlanar:
-            default:
-            {
-                SEC_OSAL_Log(SEC_LOG_TRACE, "YUV420SP out");
-                csc_tiled_to_linear(
-                    (unsigned char *)pOutputBuf[0],
-                    (unsigned char *)outputInfo.YVirAddr,
-                    actualWidth,
-                    actualHeight);
-                csc_tiled_to_linear(
-                    (unsigned char *)pOutputBuf[1],
-                    (unsigned char *)outputInfo.CVirAddr,
-                    actualWidth,
-                    actualHeight >> 1);
-                pOutputData->dataLen = actualImageSize * 3 / 2;
-            }
-                break;
-            }
-        }
-#ifdef USE_ANDROID_EXTENSION
-        if (pSECOutputPort->bUseAndroidNativeBuffer == OMX_TRUE)
-            putVADDRtoANB(pOutputData->dataBuffer);
-#endif
+    if ((outputDataValid == OMX_TRUE) &&
+        (SEC_OMX_DecFrameDefer(pOMXComponent, &outputInfo) == OMX_TRUE)) {
+        /* filled by SEC_MFC_H264Dec_FillOutput once an output buffer is free */
+        pOutputData->dataLen = 0;
+    } else if (outputDataValid == OMX_TRUE) {
+        OMX_ERRORTYPE fillRet = SEC_MFC_H264Dec_FillOutput(pOMXComponent, &outputInfo, pOutputData);
+        if (fillRet != OMX_ErrorNone)
+            ret = fillRet;
     } else {
         pOutputData->dataLen = 0;
     }
@@ -1297,14 +1394,57 @@ EXIT:
     return ret;
 }
 
+/* Port and codec parameter defaults, on a new component and on reset */
+static void SEC_MFC_H264Dec_SetDefault(SEC_OMX_BASECOMPONENT *pSECComponent)
+{
+    SEC_OMX_BASEPORT      *pSECPort = NULL;
+    SEC_H264DEC_HANDLE    *pH264Dec = (SEC_H264DEC_HANDLE *)pSECComponent->hCodecHandle;
+    int i = 0;
+
+    /* Input port */
+    pSECPort = &pSECComponent->pSECPort[INPUT_PORT_INDEX];
+    pSECPort->portDefinition.format.video.nFrameWidth = DEFAULT_FRAME_WIDTH;
+    pSECPort->portDefinition.format.video.nFrameHeight= DEFAULT_FRAME_HEIGHT;
+    pSECPort->portDefinition.format.video.nStride = 0; /*DEFAULT_FRAME_WIDTH;*/
+    pSECPort->portDefinition.format.video.nSliceHeight = 0;
+    pSECPort->portDefinition.nBufferSize = DEFAULT_VIDEO_INPUT_BUFFER_SIZE;
+    pSECPort->portDefinition.format.video.eCompressionFormat = OMX_VIDEO_CodingAVC;
+    SEC_OSAL_Memset(pSECPort->portDefinition.format.video.cMIMEType, 0, MAX_OMX_MIMETYPE_SIZE);
+    SEC_OSAL_Strcpy(pSECPort->portDefinition.format.video.cMIMEType, "video/avc");
+    pSECPort->portDefinition.format.video.pNativeRender = 0;
+    pSECPort->portDefinition.format.video.bFlagErrorConcealment = OMX_FALSE;
+    pSECPort->portDefinition.format.video.eColorFormat = OMX_COLOR_FormatUnused;
+    pSECPort->portDefinition.bEnabled = OMX_TRUE;
+
+    /* Output port */
+    pSECPort = &pSECComponent->pSECPort[OUTPUT_PORT_INDEX];
+    pSECPort->portDefinition.format.video.nFrameWidth = DEFAULT_FRAME_WIDTH;
+    pSECPort->portDefinition.format.video.nFrameHeight= DEFAULT_FRAME_HEIGHT;
+    pSECPort->portDefinition.format.video.nStride = 0; /*DEFAULT_FRAME_WIDTH;*/
+    pSECPort->portDefinition.format.video.nSliceHeight = 0;
+    pSECPort->portDefinition.nBufferSize = DEFAULT_VIDEO_OUTPUT_BUFFER_SIZE;
+    pSECPort->portDefinition.format.video.eCompressionFormat = OMX_VIDEO_CodingUnused;
+    SEC_OSAL_Memset(pSECPort->portDefinition.format.video.cMIMEType, 0, MAX_OMX_MIMETYPE_SIZE);
+    SEC_OSAL_Strcpy(pSECPort->portDefinition.format.video.cMIMEType, "raw/video");
+    pSECPort->portDefinition.format.video.pNativeRender = 0;
+    pSECPort->portDefinition.format.video.bFlagErrorConcealment = OMX_FALSE;
+    pSECPort->portDefinition.format.video.eColorFormat = OMX_COLOR_FormatYUV420SemiPlanar;
+    pSECPort->portDefinition.bEnabled = OMX_TRUE;
+
+    for(i = 0; i < ALL_PORT_NUM; i++) {
+        INIT_SET_SIZE_VERSION(&pH264Dec->AVCComponent[i], OMX_VIDEO_PARAM_AVCTYPE);
+        pH264Dec->AVCComponent[i].nPortIndex = i;
+        pH264Dec->AVCComponent[i].eProfile   = OMX_VIDEO_AVCProfileBaseline;
+        pH264Dec->AVCComponent[i].eLevel     = OMX_VIDEO_AVCLevel4;
+    }
+}
+
 OSCL_EXPORT_REF OMX_ERRORTYPE SEC_OMX_ComponentInit(OMX_HANDLETYPE hComponent, OMX_STRING componentName)
 {
     OMX_ERRORTYPE            ret = OMX_ErrorNone;
     OMX_COMPONENTTYPE       *pOMXComponent = NULL;
     SEC_OMX_BASECOMPONENT   *pSECComponent = NULL;
-    SEC_OMX_BASEPORT        *pSECPort = NULL;
     SEC_H264DEC_HANDLE      *pH264Dec = NULL;
-    int i = 0;
 
     FunctionIn();
 
@@ -1348,6 +1488,9 @@ OSCL_EXPORT_REF OMX_ERRORTYPE SEC_OMX_ComponentInit(OMX_HANDLETYPE hComponent, O
     pSECComponent->hCodecHandle = (OMX_HANDLETYPE)pH264Dec;
 
     SEC_OSAL_Strcpy(pSECComponent->componentName, SEC_OMX_COMPONENT_H264_DEC);
+
+    SEC_OSAL_Strcpy(pSECComponent->bufferProcessThreadAttr.name, "SecAvcDec");
+
     /* Set componentVersion */
     pSECComponent->componentVersion.s.nVersionMajor = VERSIONMAJOR_NUMBER;
     pSECComponent->componentVersion.s.nVersionMinor = VERSIONMINOR_NUMBER;
@@ -1369,42 +1512,7 @@ OSCL_EXPORT_REF OMX_ERRORTYPE SEC_OMX_ComponentInit(OMX_HANDLETYPE hComponent, O
     pSECComponent->capabilityFlags.iOMXComponentCanHandleIncompleteFrames         = OMX_TRUE;
     pSECComponent->capabilityFlags.iOMXComponentUsesFullAVCFrames                 = OMX_TRUE;
 
-    /* Input port */
-    pSECPort = &pSECComponent->pSECPort[INPUT_PORT_INDEX];
-    pSECPort->portDefinition.format.video.nFrameWidth = DEFAULT_FRAME_WIDTH;
-    pSECPort->portDefinition.format.video.nFrameHeight= DEFAULT_FRAME_HEIGHT;
-    pSECPort->portDefinition.format.video.nStride = 0; /*DEFAULT_FRAME_WIDTH;*/
-    pSECPort->portDefinition.format.video.nSliceHeight = 0;
-    pSECPort->portDefinition.nBufferSize = DEFAULT_VIDEO_INPUT_BUFFER_SIZE;
-    pSECPort->portDefinition.format.video.eCompressionFormat = OMX_VIDEO_CodingAVC;
-    SEC_OSAL_Memset(pSECPort->portDefinition.format.video.cMIMEType, 0, MAX_OMX_MIMETYPE_SIZE);
-    SEC_OSAL_Strcpy(pSECPort->portDefinition.format.video.cMIMEType, "video/avc");
-    pSECPort->portDefinition.format.video.pNativeRender = 0;
-    pSECPort->portDefinition.format.video.bFlagErrorConcealment = OMX_FALSE;
-    pSECPort->portDefinition.format.video.eColorFormat = OMX_COLOR_FormatUnused;
-    pSECPort->portDefinition.bEnabled = OMX_TRUE;
-
-    /* Output port */
-    pSECPort = &pSECComponent->pSECPort[OUTPUT_PORT_INDEX];
-    pSECPort->portDefinition.format.video.nFrameWidth = DEFAULT_FRAME_WIDTH;
-    pSECPort->portDefinition.format.video.nFrameHeight= DEFAULT_FRAME_HEIGHT;
-    pSECPort->portDefinition.format.video.nStride = 0; /*DEFAULT_FRAME_WIDTH;*/
-    pSECPort->portDefinition.format.video.nSliceHeight = 0;
-    pSECPort->portDefinition.nBufferSize = DEFAULT_VIDEO_OUTPUT_BUFFER_SIZE;
-    pSECPort->portDefinition.format.video.eCompressionFormat = OMX_VIDEO_CodingUnused;
-    SEC_OSAL_Memset(pSECPort->portDefinition.format.video.cMIMEType, 0, MAX_OMX_MIMETYPE_SIZE);
-    SEC_OSAL_Strcpy(pSECPort->portDefinition.format.video.cMIMEType, "raw/video");
-    pSECPort->portDefinition.format.video.pNativeRender = 0;
-    pSECPort->portDefinition.format.video.bFlagErrorConcealment = OMX_FALSE;
-    pSECPort->portDefinition.format.video.eColorFormat = OMX_COLOR_FormatYUV420SemiPlanar;
-    pSECPort->portDefinition.bEnabled = OMX_TRUE;
-
-    for(i = 0; i < ALL_PORT_NUM; i++) {
-        INIT_SET_SIZE_VERSION(&pH264Dec->AVCComponent[i], OMX_VIDEO_PARAM_AVCTYPE);
-        pH264Dec->AVCComponent[i].nPortIndex = i;
-        pH264Dec->AVCComponent[i].eProfile   = OMX_VIDEO_AVCProfileBaseline;
-        pH264Dec->AVCComponent[i].eLevel     = OMX_VIDEO_AVCLevel4;
-    }
+    SEC_MFC_H264Dec_SetDefault(pSECComponent);
 
     pOMXComponent->GetParameter      = &SEC_MFC_H264Dec_GetParameter;
     pOMXComponent->SetParameter      = &SEC_MFC_H264Dec_SetParameter;
@@ -1417,6 +1525,9 @@ OSCL_EXPORT_REF OMX_ERRORTYPE SEC_OMX_ComponentInit(OMX_HANDLETYPE hComponent, O
     pSECComponent->sec_mfc_componentInit      = &SEC_MFC_H264Dec_Init;
     pSECComponent->sec_mfc_componentTerminate = &SEC_MFC_H264Dec_Terminate;
     pSECComponent->sec_mfc_bufferProcess      = &SEC_MFC_H264Dec_bufferProcess;
+    pSECComponent->sec_mfc_allocateInputBuffer = &SEC_MFC_H264Dec_AllocateInputBuffer;
+    pSECComponent->sec_mfc_releaseInputBuffer  = &SEC_MFC_H264Dec_ReleaseInputBuffer;
+    pSECComponent->sec_mfc_fillOutput          = &SEC_MFC_H264Dec_FillOutput;
     pSECComponent->sec_checkInputFrame        = &Check_H264_Frame;
 
     pSECComponent->currentState = OMX_StateLoaded;
@@ -1450,6 +1561,11 @@ OMX_ERRORTYPE SEC_OMX_ComponentDeinit(OMX_HANDLETYPE hComponent)
 
     pH264Dec = (SEC_H264DEC_HANDLE *)pSECComponent->hCodecHandle;
     if (pH264Dec != NULL) {
+        /* opened for input port buffers but never initialized */
+        if (pH264Dec->hMFCH264Handle.hMFCHandle != NULL) {
+            SEC_MFC_DecClose(pH264Dec->hMFCH264Handle.hMFCHandle, pH264Dec->MFCDecInputBuffer, &pH264Dec->MFCDecClientBuffer);
+            pH264Dec->hMFCH264Handle.hMFCHandle = NULL;
+        }
         SEC_OSAL_Free(pH264Dec);
         pH264Dec = pSECComponent->hCodecHandle = NULL;
     }
@@ -1466,3 +1582,39 @@ EXIT:
 
     return ret;
 }
+
+/* A Loaded component with no MFC instance back to its defaults, kept by the core for reuse */
+OSCL_EXPORT_REF OMX_ERRORTYPE SEC_OMX_ComponentReset(OMX_HANDLETYPE hComponent)
+{
+    OMX_ERRORTYPE            ret = OMX_ErrorNone;
+    OMX_COMPONENTTYPE       *pOMXComponent = NULL;
+    SEC_OMX_BASECOMPONENT   *pSECComponent = NULL;
+    SEC_H264DEC_HANDLE      *pH264Dec = NULL;
+
+    FunctionIn();
+
+    if (hComponent == NULL) {
+        ret = OMX_ErrorBadParameter;
+        goto EXIT;
+    }
+    pOMXComponent = (OMX_COMPONENTTYPE *)hComponent;
+    pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    pH264Dec = (SEC_H264DEC_HANDLE *)pSECComponent->hCodecHandle;
+    if ((pH264Dec == NULL) || (pH264Dec->hMFCH264Handle.hMFCHandle != NULL)) {
+        ret = OMX_ErrorIncorrectStateOperation;
+        goto EXIT;
+    }
+
+    ret = SEC_OMX_VideoDecodeComponentReset(pOMXComponent);
+    if (ret != OMX_ErrorNone) {
+        goto EXIT;
+    }
+
+    SEC_OSAL_Memset(pH264Dec, 0, sizeof(SEC_H264DEC_HANDLE));
+    SEC_MFC_H264Dec_SetDefault(pSECComponent);
+
+EXIT:
+    FunctionOut();
+
+    return ret;
+}
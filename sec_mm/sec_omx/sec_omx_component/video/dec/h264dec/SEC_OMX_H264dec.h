@@ -29,18 +29,24 @@
 
 #include "SEC_OMX_Def.h"
 #include "OMX_Component.h"
+#include "color_space_convertor.h"
 #include "OMX_Video.h"
 
+/* Largest H.264 DPB in frames and the display delays set to the MFC */
+#define H264_DEC_MAX_DPB                    16
+#define H264_DEC_DISPLAY_DELAY              8
+#define H264_DEC_THUMBNAIL_DISPLAY_DELAY    1
 
 typedef struct _SEC_MFC_H264DEC_HANDLE
 {
     OMX_HANDLETYPE hMFCHandle;
     OMX_PTR pMFCStreamBuffer;
     OMX_PTR pMFCStreamPhyBuffer;
-    OMX_U32    indexTimestamp;
     OMX_BOOL bConfiguredMFC;
     OMX_BOOL bThumbnailMode;
     OMX_S32  returnCodec;
+    CSC_TILE_MAP tileMapY;
+    CSC_TILE_MAP tileMapC;
 } SEC_MFC_H264DEC_HANDLE;
 
 typedef struct _SEC_H264DEC_HANDLE
@@ -57,6 +63,7 @@ typedef struct _SEC_H264DEC_HANDLE
     OMX_BOOL bFirstFrame;
     MFC_DEC_INPUT_BUFFER MFCDecInputBuffer[MFC_INPUT_BUFFER_NUM_MAX];
     OMX_U32  indexInputBuffer;
+    MFC_DEC_CLIENT_BUFFER MFCDecClientBuffer;
 } SEC_H264DEC_HANDLE;
 
 #ifdef __cplusplus
@@ -65,6 +72,7 @@ extern "C" {
 
 OSCL_EXPORT_REF OMX_ERRORTYPE SEC_OMX_ComponentInit(OMX_HANDLETYPE hComponent, OMX_STRING componentName);
 OMX_ERRORTYPE SEC_OMX_ComponentDeinit(OMX_HANDLETYPE hComponent);
+OSCL_EXPORT_REF OMX_ERRORTYPE SEC_OMX_ComponentReset(OMX_HANDLETYPE hComponent);
 
 #ifdef __cplusplus
 };
@@ -15,8 +15,8 @@ LOCAL_CFLAGS :=
 LOCAL_ARM_MODE := arm
 
 LOCAL_STATIC_LIBRARIES := libSEC_OMX_Vdec.aries libsecosal.aries libsecbasecomponent.aries \
-						libsecmfcdecapi.aries libseccsc.aries
-LOCAL_SHARED_LIBRARIES := libc libdl libcutils libutils libui libhardware
+						libsecmfcdecapi.aries libsecmfcbackend.aries libseccsc.aries
+LOCAL_SHARED_LIBRARIES := libSEC_OMX_Resourcemanager.aries libc libdl libcutils libutils libui libhardware
 
 LOCAL_C_INCLUDES := $(SEC_OMX_INC)/khronos \
 	$(SEC_OMX_INC)/sec \
@@ -28,3 +28,36 @@ LOCAL_C_INCLUDES := $(SEC_OMX_INC)/khronos \
 LOCAL_C_INCLUDES += $(SEC_OMX_TOP)/sec_codecs/video/mfc_c110/include
 
 include $(BUILD_SHARED_LIBRARY)
+
+#########################################################################
+# Build component for host, on the MFC simulator
+#########################################################################
+
+include $(CLEAR_VARS)
+
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_SRC_FILES := \
+	SEC_OMX_Mpeg4dec.c \
+	library_register.c
+
+LOCAL_MODULE := libOMX.SEC.M4V.Decoder_host
+
+LOCAL_CFLAGS := -DUSE_MFC_SIM
+
+LOCAL_STATIC_LIBRARIES := libSEC_OMX_Vdec_host libsecbasecomponent_host libsecosal_host \
+						libsecmfcapi_host libseccsc_host libcutils liblog
+LOCAL_SHARED_LIBRARIES := libSEC_OMX_Resourcemanager_host
+
+LOCAL_LDLIBS := -lpthread -ldl -lrt
+
+LOCAL_C_INCLUDES := $(SEC_OMX_INC)/khronos \
+	$(SEC_OMX_INC)/sec \
+	$(SEC_OMX_TOP)/sec_osal \
+	$(SEC_OMX_TOP)/sec_omx_core \
+	$(SEC_OMX_COMPONENT)/common \
+	$(SEC_OMX_COMPONENT)/video/dec
+
+LOCAL_C_INCLUDES += $(SEC_OMX_TOP)/sec_codecs/video/mfc_c110/include
+
+include $(BUILD_HOST_SHARED_LIBRARY)
@@ -105,10 +105,39 @@ SEC_OMX_VIDEO_PROFILELEVEL supportedH263ProfileLevels[] = {
 static OMX_HANDLETYPE ghMFCHandle = NULL;
 static OMX_BOOL gbFIMV1 = OMX_FALSE;
 
+/* Offset of the first VOP start code 00 00 01 B6, buffSize if none */
+static int Find_Mpeg4_VOP(OMX_U8 *pInputStream, int buffSize)
+{
+    int offset = 0;
+
+    while (1) {
+        offset += SEC_FindStartCode(pInputStream + offset, buffSize - offset, 0xFF, 0x01);
+        if (offset + 3 >= buffSize)
+            return buffSize;
+        if (pInputStream[offset + 3] == 0xB6)
+            return offset;
+        offset += 3;
+    }
+}
+
+/* Offset of the first PSC 0000 0000 0000 0000 1000 00 followed by PTYPE bits 10, buffSize if none */
+static int Find_H263_PSC(OMX_U8 *pInputStream, int buffSize)
+{
+    int offset = 0;
+
+    while (1) {
+        offset += SEC_FindStartCode(pInputStream + offset, buffSize - offset, 0xFC, 0x80);
+        if (offset + 3 >= buffSize)
+            return buffSize;
+        if ((pInputStream[offset + 3] & 0x03) == 0x02)
+            return offset;
+        offset += 3;
+    }
+}
+
 static int Check_Mpeg4_Frame(OMX_U8 *pInputStream, OMX_U32 buffSize, OMX_U32 flag, OMX_BOOL bPreviousFrameEOF, OMX_BOOL *pbEndOfFrame)
 {
-    int len, readStream;
-    unsigned startCode;
+    int len;
     OMX_BOOL bFrameStart;
 
     len = 0;
@@ -141,49 +170,37 @@ static int Check_Mpeg4_Frame(OMX_U8 *pInputStream, OMX_U32 buffSize, OMX_U32 fla
     if (bPreviousFrameEOF == OMX_FALSE)
         bFrameStart = OMX_TRUE;
 
-    startCode = 0xFFFFFFFF;
     if (bFrameStart == OMX_FALSE) {
         /* find VOP start code */
-        while(startCode != 0x1B6) {
-            readStream = *(pInputStream + len);
-            startCode = (startCode << 8) | readStream;
-            len++;
-            if (len > buffSize)
-                goto EXIT;
-        }
+        len = Find_Mpeg4_VOP(pInputStream, buffSize);
+        if (len == (int)buffSize)
+            goto EXIT;
+        len += 4;
     }
 
     /* find next VOP start code */
-    startCode = 0xFFFFFFFF;
-    while ((startCode != 0x1B6)) {
-        readStream = *(pInputStream + len);
-        startCode = (startCode << 8) | readStream;
-        len++;
-        if (len > buffSize)
-            goto EXIT;
-    }
+    len += Find_Mpeg4_VOP(pInputStream + len, buffSize - len);
+    if (len == (int)buffSize)
+        goto EXIT;
 
     *pbEndOfFrame = OMX_TRUE;
 
-    SEC_OSAL_Log(SEC_LOG_TRACE, "1. Check_Mpeg4_Frame returned EOF = %d, len = %d, buffSize = %d", *pbEndOfFrame, len - 4, buffSize);
+    SEC_OSAL_Log(SEC_LOG_TRACE, "1. Check_Mpeg4_Frame returned EOF = %d, len = %d, buffSize = %d", *pbEndOfFrame, len, buffSize);
 
-    return len - 4;
+    return len;
 
 EXIT :
     *pbEndOfFrame = OMX_FALSE;
 
-    SEC_OSAL_Log(SEC_LOG_TRACE, "2. Check_Mpeg4_Frame returned EOF = %d, len = %d, buffSize = %d", *pbEndOfFrame, len - 1, buffSize);
+    SEC_OSAL_Log(SEC_LOG_TRACE, "2. Check_Mpeg4_Frame returned EOF = %d, len = %d, buffSize = %d", *pbEndOfFrame, buffSize, buffSize);
 
-    return --len;
+    return buffSize;
 }
 
 static int Check_H263_Frame(OMX_U8 *pInputStream, OMX_U32 buffSize, OMX_U32 flag, OMX_BOOL bPreviousFrameEOF, OMX_BOOL *pbEndOfFrame)
 {
-    int len, readStream;
-    unsigned startCode;
+    int len;
     OMX_BOOL bFrameStart = 0;
-    unsigned pTypeMask = 0x03;
-    unsigned pType = 0;
 
     len = 0;
     bFrameStart = OMX_FALSE;
@@ -191,50 +208,32 @@ static int Check_H263_Frame(OMX_U8 *pInputStream, OMX_U32 buffSize, OMX_U32 flag
     if (bPreviousFrameEOF == OMX_FALSE)
         bFrameStart = OMX_TRUE;
 
-    startCode = 0xFFFFFFFF;
     if (bFrameStart == OMX_FALSE) {
-        /* find PSC(Picture Start Code) : 0000 0000 0000 0000 1000 00 */
-        while (((startCode << 8 >> 10) != 0x20) || (pType != 0x02)) {
-            readStream = *(pInputStream + len);
-            startCode = (startCode << 8) | readStream;
-
-            readStream = *(pInputStream + len + 1);
-            pType = readStream & pTypeMask;
-
-            len++;
-            if (len > buffSize)
-                goto EXIT;
-        }
+        /* find PSC(Picture Start Code) */
+        len = Find_H263_PSC(pInputStream, buffSize);
+        if (len == (int)buffSize)
+            goto EXIT;
+        len += 3;
     }
 
     /* find next PSC */
-    startCode = 0xFFFFFFFF;
-    pType = 0;
-    while (((startCode << 8 >> 10) != 0x20) || (pType != 0x02)) {
-        readStream = *(pInputStream + len);
-        startCode = (startCode << 8) | readStream;
-
-        readStream = *(pInputStream + len + 1);
-        pType = readStream & pTypeMask;
-
-        len++;
-        if (len > buffSize)
-            goto EXIT;
-    }
+    len += Find_H263_PSC(pInputStream + len, buffSize - len);
+    if (len == (int)buffSize)
+        goto EXIT;
 
     *pbEndOfFrame = OMX_TRUE;
 
-    SEC_OSAL_Log(SEC_LOG_TRACE, "1. Check_H263_Frame returned EOF = %d, len = %d, iBuffSize = %d", *pbEndOfFrame, len - 3, buffSize);
+    SEC_OSAL_Log(SEC_LOG_TRACE, "1. Check_H263_Frame returned EOF = %d, len = %d, iBuffSize = %d", *pbEndOfFrame, len, buffSize);
 
-    return len - 3;
+    return len;
 
 EXIT :
 
     *pbEndOfFrame = OMX_FALSE;
 
-    SEC_OSAL_Log(SEC_LOG_TRACE, "2. Check_H263_Frame returned EOF = %d, len = %d, iBuffSize = %d", *pbEndOfFrame, len - 1, buffSize);
+    SEC_OSAL_Log(SEC_LOG_TRACE, "2. Check_H263_Frame returned EOF = %d, len = %d, iBuffSize = %d", *pbEndOfFrame, buffSize, buffSize);
 
-    return --len;
+    return buffSize;
 }
 
 OMX_BOOL Check_Stream_PrefixCode(OMX_U8 *pInputStream, OMX_U32 streamSize, CODEC_TYPE codecType)
@@ -586,7 +585,8 @@ OMX_ERRORTYPE SEC_MFC_Mpeg4Dec_SetParameter(
                 goto EXIT;
             }
         }
-        if (pPortDefinition->nBufferCountActual < pSECPort->portDefinition.nBufferCountMin) {
+        if ((pPortDefinition->nBufferCountActual < pSECPort->portDefinition.nBufferCountMin) ||
+            (pPortDefinition->nBufferCountActual > MAX_BUFFER_NUM)) {
             ret = OMX_ErrorBadParameter;
             goto EXIT;
         }
@@ -834,6 +834,9 @@ OMX_ERRORTYPE SEC_MFC_Mpeg4Dec_GetExtensionIndex(
         SEC_MPEG4_HANDLE *pMpeg4Dec = (SEC_MPEG4_HANDLE *)pSECComponent->hCodecHandle;
         *pIndexType = OMX_IndexVendorThumbnailMode;
         ret = OMX_ErrorNone;
+    } else if (SEC_OSAL_Strcmp(cParameterName, SEC_INDEX_PARAM_DECODE_PIPELINE_DEPTH) == 0) {
+        *pIndexType = OMX_IndexVendorDecodePipelineDepth;
+        ret = OMX_ErrorNone;
 #ifdef USE_ANDROID_EXTENSION
     } else if (SEC_OSAL_Strcmp(cParameterName, SEC_INDEX_PARAM_ENABLE_ANB) == 0) {
         *pIndexType = OMX_IndexParamEnableAndroidBuffers;
@@ -924,7 +927,10 @@ OMX_ERRORTYPE SEC_MFC_DecodeThread(OMX_HANDLETYPE hComponent)
         SEC_OSAL_SemaphoreWait(pMpeg4Dec->NBDecThread.hDecFrameStart);
 
         if (pMpeg4Dec->NBDecThread.bExitDecodeThread == OMX_FALSE) {
+            OMX_U64 decodeStartUs = SEC_OSAL_GetSystemTimeUs();
+
             pMpeg4Dec->hMFCMpeg4Handle.returnCodec = SsbSipMfcDecExe(pMpeg4Dec->hMFCMpeg4Handle.hMFCHandle, pMpeg4Dec->NBDecThread.oneFrameSize);
+            SEC_OMX_StatsAdd(&pSECComponent->stats, SEC_OMX_STATS_MFC, decodeStartUs);
             SEC_OSAL_SemaphorePost(pMpeg4Dec->NBDecThread.hDecFrameEnd);
         }
     }
@@ -936,15 +942,76 @@ EXIT:
     return ret;
 }
 
+/* Input port buffer nIndex in the stream buffer, the MFC is opened for it */
+OMX_ERRORTYPE SEC_MFC_Mpeg4Dec_AllocateInputBuffer(
+    OMX_COMPONENTTYPE *pOMXComponent,
+    OMX_U32            nIndex,
+    OMX_U32            nSizeBytes,
+    OMX_U8           **ppBuffer,
+    OMX_PTR           *ppPhyBuffer)
+{
+    OMX_ERRORTYPE          ret = OMX_ErrorNone;
+    SEC_OMX_BASECOMPONENT *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    SEC_MPEG4_HANDLE      *pMpeg4Dec = (SEC_MPEG4_HANDLE *)pSECComponent->hCodecHandle;
+    SEC_OMX_BASEPORT      *pSECInputPort = &pSECComponent->pSECPort[INPUT_PORT_INDEX];
+    OMX_U32                slotSize = pSECInputPort->portDefinition.nBufferSize;
+
+    FunctionIn();
+
+    if (pMpeg4Dec->hMFCMpeg4Handle.hMFCHandle == NULL) {
+        if (slotSize < nSizeBytes)
+            slotSize = nSizeBytes;
+        pMpeg4Dec->hMFCMpeg4Handle.hMFCHandle = SEC_MFC_DecOpen(pMpeg4Dec->MFCDecInputBuffer, &pMpeg4Dec->MFCDecClientBuffer,
+            slotSize, pSECInputPort->portDefinition.nBufferCountActual);
+        if (pMpeg4Dec->hMFCMpeg4Handle.hMFCHandle == NULL) {
+            ret = OMX_ErrorInsufficientResources;
+            goto EXIT;
+        }
+        ghMFCHandle = pMpeg4Dec->hMFCMpeg4Handle.hMFCHandle;
+    }
+
+    ret = SEC_MFC_DecClientBufferGet(&pMpeg4Dec->MFCDecClientBuffer, nIndex, nSizeBytes, ppBuffer, ppPhyBuffer);
+
+EXIT:
+    FunctionOut();
+
+    return ret;
+}
+
+/* Gives back input port buffers the MFC reads in place */
+OMX_ERRORTYPE SEC_MFC_Mpeg4Dec_ReleaseInputBuffer(OMX_COMPONENTTYPE *pOMXComponent, OMX_BOOL bAll)
+{
+    OMX_ERRORTYPE          ret = OMX_ErrorNone;
+    SEC_OMX_BASECOMPONENT *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    SEC_MPEG4_HANDLE      *pMpeg4Dec = (SEC_MPEG4_HANDLE *)pSECComponent->hCodecHandle;
+
+    FunctionIn();
+
+    if (pMpeg4Dec->hMFCMpeg4Handle.hMFCHandle == NULL)
+        goto EXIT;
+
+    /* wait for mfc decode done, it may read a lent buffer */
+    if ((bAll == OMX_TRUE) && (pMpeg4Dec->NBDecThread.bDecoderRun == OMX_TRUE)) {
+        SEC_OSAL_SemaphoreWait(pMpeg4Dec->NBDecThread.hDecFrameEnd);
+        pMpeg4Dec->NBDecThread.bDecoderRun = OMX_FALSE;
+    }
+
+    SEC_MFC_DecInputRelease(pOMXComponent, pMpeg4Dec->MFCDecInputBuffer, pMpeg4Dec->indexInputBuffer, bAll);
+    pMpeg4Dec->hMFCMpeg4Handle.pMFCStreamBuffer    = pMpeg4Dec->MFCDecInputBuffer[pMpeg4Dec->indexInputBuffer].VirAddr;
+    pMpeg4Dec->hMFCMpeg4Handle.pMFCStreamPhyBuffer = pMpeg4Dec->MFCDecInputBuffer[pMpeg4Dec->indexInputBuffer].PhyAddr;
+
+EXIT:
+    FunctionOut();
+
+    return ret;
+}
+
 /* MFC Init */
 OMX_ERRORTYPE SEC_MFC_Mpeg4Dec_Init(OMX_COMPONENTTYPE *pOMXComponent)
 {
     OMX_ERRORTYPE          ret = OMX_ErrorNone;
     SEC_OMX_BASECOMPONENT *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
     SEC_MPEG4_HANDLE      *pMpeg4Dec = NULL;
-    OMX_HANDLETYPE         hMFCHandle = NULL;
-    OMX_PTR                pStreamBuffer = NULL;
-    OMX_PTR                pStreamPhyBuffer = NULL;
 
     FunctionIn();
 
@@ -953,30 +1020,15 @@ OMX_ERRORTYPE SEC_MFC_Mpeg4Dec_Init(OMX_COMPONENTTYPE *pOMXComponent)
     pSECComponent->bUseFlagEOF = OMX_FALSE;
     pSECComponent->bSaveFlagEOS = OMX_FALSE;
 
-    /* MFC(Multi Format Codec) decoder and CMM(Codec Memory Management) driver open */
-    SSBIP_MFC_BUFFER_TYPE buf_type = CACHE;
-    hMFCHandle = (OMX_PTR)SsbSipMfcDecOpen(&buf_type);
-    if (hMFCHandle == NULL) {
-        ret = OMX_ErrorInsufficientResources;
-        goto EXIT;
-    }
-    ghMFCHandle = pMpeg4Dec->hMFCMpeg4Handle.hMFCHandle = hMFCHandle;
-
-    /* Allocate decoder's input buffer */
-    pStreamBuffer = SsbSipMfcDecGetInBuf(hMFCHandle, &pStreamPhyBuffer, DEFAULT_MFC_INPUT_BUFFER_SIZE);
-    if (pStreamBuffer == NULL) {
-        ret = OMX_ErrorInsufficientResources;
-        goto EXIT;
+    /* Already open when the input port buffers were allocated in the stream buffer */
+    if (pMpeg4Dec->hMFCMpeg4Handle.hMFCHandle == NULL) {
+        pMpeg4Dec->hMFCMpeg4Handle.hMFCHandle = SEC_MFC_DecOpen(pMpeg4Dec->MFCDecInputBuffer, &pMpeg4Dec->MFCDecClientBuffer, 0, 0);
+        if (pMpeg4Dec->hMFCMpeg4Handle.hMFCHandle == NULL) {
+            ret = OMX_ErrorInsufficientResources;
+            goto EXIT;
+        }
     }
-
-    pMpeg4Dec->MFCDecInputBuffer[0].VirAddr = pStreamBuffer;
-    pMpeg4Dec->MFCDecInputBuffer[0].PhyAddr = pStreamPhyBuffer;
-    pMpeg4Dec->MFCDecInputBuffer[0].bufferSize = DEFAULT_MFC_INPUT_BUFFER_SIZE;
-    pMpeg4Dec->MFCDecInputBuffer[0].dataSize = 0;
-    pMpeg4Dec->MFCDecInputBuffer[1].VirAddr = (unsigned char *)pStreamBuffer + pMpeg4Dec->MFCDecInputBuffer[0].bufferSize;
-    pMpeg4Dec->MFCDecInputBuffer[1].PhyAddr = (unsigned char *)pStreamPhyBuffer + pMpeg4Dec->MFCDecInputBuffer[0].bufferSize;
-    pMpeg4Dec->MFCDecInputBuffer[1].bufferSize = DEFAULT_MFC_INPUT_BUFFER_SIZE;
-    pMpeg4Dec->MFCDecInputBuffer[1].dataSize = 0;
+    ghMFCHandle = pMpeg4Dec->hMFCMpeg4Handle.hMFCHandle;
     pMpeg4Dec->indexInputBuffer = 0;
 
     pMpeg4Dec->bFirstFrame = OMX_TRUE;
@@ -997,9 +1049,11 @@ OMX_ERRORTYPE SEC_MFC_Mpeg4Dec_Init(OMX_COMPONENTTYPE *pOMXComponent)
     pSECComponent->processData[INPUT_PORT_INDEX].dataBuffer = pMpeg4Dec->MFCDecInputBuffer[0].VirAddr;
     pSECComponent->processData[INPUT_PORT_INDEX].allocSize = pMpeg4Dec->MFCDecInputBuffer[0].bufferSize;
 
-    SEC_OSAL_Memset(pSECComponent->timeStamp, -19771003, sizeof(OMX_TICKS) * MAX_TIMESTAMP);
-    SEC_OSAL_Memset(pSECComponent->nFlags, 0, sizeof(OMX_U32) * MAX_FLAGS);
-    pMpeg4Dec->hMFCMpeg4Handle.indexTimestamp = 0;
+    /* a tag for each frame the MFC may hold: references, B-VOP and the decode pipeline */
+    ret = SEC_OMX_FrameTagCreate(&pSECComponent->frameTagMap,
+                                 MPEG4_DEC_MAX_DPB + MAX_DEC_PIPELINE_DEPTH + MFC_INPUT_BUFFER_NUM_MAX);
+    if (ret != OMX_ErrorNone)
+        goto EXIT;
     pSECComponent->getAllDelayBuffer = OMX_FALSE;
 
 EXIT:
@@ -1021,6 +1075,8 @@ OMX_ERRORTYPE SEC_MFC_Mpeg4Dec_Terminate(OMX_COMPONENTTYPE *pOMXComponent)
     pMpeg4Dec = (SEC_MPEG4_HANDLE *)pSECComponent->hCodecHandle;
     hMFCHandle = pMpeg4Dec->hMFCMpeg4Handle.hMFCHandle;
 
+    SEC_MFC_Mpeg4Dec_ReleaseInputBuffer(pOMXComponent, OMX_TRUE);
+
     pMpeg4Dec->hMFCMpeg4Handle.pMFCStreamBuffer    = NULL;
     pMpeg4Dec->hMFCMpeg4Handle.pMFCStreamPhyBuffer = NULL;
     pSECComponent->processData[INPUT_PORT_INDEX].dataBuffer = NULL;
@@ -1044,9 +1100,133 @@ OMX_ERRORTYPE SEC_MFC_Mpeg4Dec_Terminate(OMX_COMPONENTTYPE *pOMXComponent)
     }
 
     if (hMFCHandle != NULL) {
-        SsbSipMfcDecClose(hMFCHandle);
-        pMpeg4Dec->hMFCMpeg4Handle.hMFCHandle = NULL;
+        SEC_MFC_DecClose(hMFCHandle, pMpeg4Dec->MFCDecInputBuffer, &pMpeg4Dec->MFCDecClientBuffer);
+        ghMFCHandle = pMpeg4Dec->hMFCMpeg4Handle.hMFCHandle = NULL;
+    }
+
+    csc_tile_map_release(&pMpeg4Dec->hMFCMpeg4Handle.tileMapY);
+    csc_tile_map_release(&pMpeg4Dec->hMFCMpeg4Handle.tileMapC);
+
+    SEC_OMX_FrameTagTerminate(&pSECComponent->frameTagMap);
+
+EXIT:
+    FunctionOut();
+
+    return ret;
+}
+
+/* Fills an output buffer from a frame in the MFC DPB, on the output thread in a decode pipeline */
+OMX_ERRORTYPE SEC_MFC_Mpeg4Dec_FillOutput(OMX_COMPONENTTYPE *pOMXComponent, OMX_PTR pOutputInfo, SEC_OMX_DATA *pOutputData)
+{
+    OMX_ERRORTYPE              ret = OMX_ErrorNone;
+    SEC_OMX_BASECOMPONENT     *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    SEC_MPEG4_HANDLE          *pMpeg4Dec = (SEC_MPEG4_HANDLE *)pSECComponent->hCodecHandle;
+    SEC_OMX_BASEPORT          *pSECInputPort = &pSECComponent->pSECPort[INPUT_PORT_INDEX];
+    SEC_OMX_BASEPORT          *pSECOutputPort = &pSECComponent->pSECPort[OUTPUT_PORT_INDEX];
+    SSBSIP_MFC_DEC_OUTPUT_INFO outputInfo;
+    void                      *pOutputBuf[3];
+    int                        bufWidth = 0;
+    int                        bufHeight = 0;
+    int                        frameSize = 0;
+    int                        actualWidth = 0;
+    int                        actualHeight = 0;
+    int                        actualImageSize = 0;
+    OMX_U64                    cscStartUs = 0;
+
+    FunctionIn();
+
+    SEC_OSAL_Memcpy(&outputInfo, pOutputInfo, sizeof(SSBSIP_MFC_DEC_OUTPUT_INFO));
+    bufWidth  = (outputInfo.img_width + 15) & (~15);
+    bufHeight = (outputInfo.img_height + 15) & (~15);
+
+    frameSize = bufWidth * bufHeight;
+    actualWidth  = outputInfo.img_width;
+    actualHeight = outputInfo.img_height;
+    actualImageSize = actualWidth * actualHeight;
+
+    pOutputBuf[0] = (void *)pOutputData->dataBuffer;
+    pOutputBuf[1] = (void *)pOutputData->dataBuffer + actualImageSize;
+    pOutputBuf[2] = (void *)pOutputData->dataBuffer + ((actualImageSize * 5) / 4);
+
+#ifdef USE_ANDROID_EXTENSION
+    if (pSECOutputPort->bUseAndroidNativeBuffer == OMX_TRUE) {
+        OMX_U32 retANB = 0;
+        void *pVirAddrs[2];
+        actualWidth  = (outputInfo.img_width + 15) & (~15);
+        actualImageSize = actualWidth * actualHeight;
+
+         retANB = getVADDRfromANB(pOutputData->dataBuffer,
+                        (OMX_U32)pSECInputPort->portDefinition.format.video.nFrameWidth,
+                        (OMX_U32)pSECInputPort->portDefinition.format.video.nFrameHeight,
+                        pVirAddrs);
+        if (retANB != 0) {
+            SEC_OSAL_Log(SEC_LOG_ERROR, "Error getVADDRfromANB, Error code:%d", retANB);
+            ret = OMX_ErrorOverflow;
+            goto EXIT;
+        }
+        pOutputBuf[0] = pVirAddrs[0];
+        pOutputBuf[1] = pVirAddrs[1];
+    }
+#endif
+    if ((pMpeg4Dec->hMFCMpeg4Handle.bThumbnailMode == OMX_FALSE) &&
+        (pSECOutputPort->portDefinition.format.video.eColorFormat == OMX_SEC_COLOR_FormatNV12TPhysicalAddress))
+    {
+        /* if use Post copy address structure */
+        SEC_OSAL_Memcpy(pOutputBuf[0], &frameSize, sizeof(frameSize));
+        SEC_OSAL_Memcpy(pOutputBuf[0] + sizeof(frameSize), &(outputInfo.YPhyAddr), sizeof(outputInfo.YPhyAddr));
+        SEC_OSAL_Memcpy(pOutputBuf[0] + sizeof(frameSize) + (sizeof(void *) * 1), &(outputInfo.CPhyAddr), sizeof(outputInfo.CPhyAddr));
+        SEC_OSAL_Memcpy(pOutputBuf[0] + sizeof(frameSize) + (sizeof(void *) * 2), &(outputInfo.YVirAddr), sizeof(outputInfo.YVirAddr));
+        SEC_OSAL_Memcpy(pOutputBuf[0] + sizeof(frameSize) + (sizeof(void *) * 3), &(outputInfo.CVirAddr), sizeof(outputInfo.CVirAddr));
+        pOutputData->dataLen = (bufWidth * bufHeight * 3) / 2;
+    } else if ((csc_tile_map_update(&pMpeg4Dec->hMFCMpeg4Handle.tileMapY, outputInfo.img_width, outputInfo.img_height) != 0) ||
+               (csc_tile_map_update(&pMpeg4Dec->hMFCMpeg4Handle.tileMapC, outputInfo.img_width, outputInfo.img_height >> 1) != 0)) {
+        SEC_OSAL_Log(SEC_LOG_ERROR, "Failed to build tile map for %dx%d", actualWidth, actualHeight);
+        pOutputData->dataLen = 0;
+        ret = OMX_ErrorInsufficientResources;
+    } else {
+        CSC_LINEAR_FRAME linearFrame;
+
+        switch (pSECComponent->pSECPort[OUTPUT_PORT_INDEX].portDefinition.format.video.eColorFormat) {
+        case OMX_COLOR_FormatYUV420Planar:
+        {
+            SEC_OSAL_Log(SEC_LOG_TRACE, "YUV420P out");
+            linearFrame.layout = CSC_LAYOUT_I420;
+            linearFrame.plane[0] = (char *)pOutputBuf[0];
+            linearFrame.plane[1] = (char *)pOutputBuf[1];
+            linearFrame.plane[2] = (char *)pOutputBuf[2];
+            linearFrame.stride[0] = actualWidth;
+            linearFrame.stride[1] = actualWidth >> 1;
+            linearFrame.stride[2] = actualWidth >> 1;
+        }
+            break;
+        case OMX_COLOR_FormatYUV420SemiPlanar:
+        case OMX_SEC_COLOR_FormatANBYUV420SemiPlanar:
+        default:
+        {
+            SEC_OSAL_Log(SEC_LOG_TRACE, "YUV420SP out");
+            linearFrame.layout = CSC_LAYOUT_NV12;
+            linearFrame.plane[0] = (char *)pOutputBuf[0];
+            linearFrame.plane[1] = (char *)pOutputBuf[1];
+            linearFrame.plane[2] = NULL;
+            linearFrame.stride[0] = actualWidth;
+            linearFrame.stride[1] = actualWidth;
+            linearFrame.stride[2] = 0;
+        }
+            break;
+        }
+        cscStartUs = SEC_OSAL_GetSystemTimeUs();
+        SEC_TiledToLinearFrame(&linearFrame,
+            outputInfo.YVirAddr,
+            outputInfo.CVirAddr,
+            &pMpeg4Dec->hMFCMpeg4Handle.tileMapY,
+            &pMpeg4Dec->hMFCMpeg4Handle.tileMapC);
+        SEC_OMX_StatsAdd(&pSECComponent->stats, SEC_OMX_STATS_CSC, cscStartUs);
+        pOutputData->dataLen = actualImageSize * 3 / 2;
     }
+#ifdef USE_ANDROID_EXTENSION
+    if (pSECOutputPort->bUseAndroidNativeBuffer == OMX_TRUE)
+        putVADDRtoANB(pOutputData->dataBuffer);
+#endif
 
 EXIT:
     FunctionOut();
@@ -1063,12 +1243,23 @@ OMX_ERRORTYPE SEC_MFC_Mpeg4_Decode(OMX_COMPONENTTYPE *pOMXComponent, SEC_OMX_DAT
     OMX_U32                    oneFrameSize = pInputData->dataLen;
     SSBSIP_MFC_DEC_OUTPUT_INFO outputInfo;
     OMX_S32                    configValue = 0;
-    int                        bufWidth = 0;
-    int                        bufHeight = 0;
     OMX_BOOL                   outputDataValid = OMX_FALSE;
+    SEC_OMX_FRAME_META         inputMeta;
+    SEC_OMX_FRAME_META         outputMeta;
+    int                        frameTag = -1;
 
     FunctionIn();
 
+    /* a frame lent from an input port buffer, see SEC_Preprocessor_InputData */
+    if (pInputData->bufferHeader != NULL) {
+        MFC_DEC_INPUT_BUFFER *pSlot = &pMpeg4Dec->MFCDecInputBuffer[pMpeg4Dec->indexInputBuffer];
+
+        SEC_MFC_DecInputTake(pOMXComponent, pSlot, pInputData, pMpeg4Dec->hMFCMpeg4Handle.bConfiguredMFC);
+        pMpeg4Dec->hMFCMpeg4Handle.pMFCStreamBuffer    = pSlot->VirAddr;
+        pMpeg4Dec->hMFCMpeg4Handle.pMFCStreamPhyBuffer = pSlot->PhyAddr;
+        oneFrameSize = pInputData->dataLen;
+    }
+
     if (pMpeg4Dec->hMFCMpeg4Handle.bConfiguredMFC == OMX_FALSE) {
         SSBSIP_MFC_CODEC_TYPE MFCCodecType;
         if (pMpeg4Dec->hMFCMpeg4Handle.codecType == CODEC_TYPE_MPEG4) {
@@ -1087,8 +1278,8 @@ OMX_ERRORTYPE SEC_MFC_Mpeg4_Decode(OMX_COMPONENTTYPE *pOMXComponent, SEC_OMX_DAT
             goto EXIT;
         }
 
-        /* Set the number of extra buffer to prevent tearing */
-        configValue = 0;
+        /* Set the number of extra buffer to prevent tearing, one per frame queued in the decode pipeline */
+        configValue = SEC_OMX_DecPipelineDepth(pOMXComponent);
         SsbSipMfcDecSetConfig(hMFCHandle, MFC_DEC_SETCONF_EXTRA_BUFFER_NUM, &configValue);
 
         /* Set mpeg4 deblocking filter enable */
@@ -1159,13 +1350,13 @@ OMX_ERRORTYPE SEC_MFC_Mpeg4_Decode(OMX_COMPONENTTYPE *pOMXComponent, SEC_OMX_DAT
         pSECComponent->bUseFlagEOF = OMX_TRUE;
 #endif
 
-    pSECComponent->timeStamp[pMpeg4Dec->hMFCMpeg4Handle.indexTimestamp] = pInputData->timeStamp;
-    pSECComponent->nFlags[pMpeg4Dec->hMFCMpeg4Handle.indexTimestamp] = pInputData->nFlags;
+    inputMeta.timeStamp = pInputData->timeStamp;
+    inputMeta.nFlags    = pInputData->nFlags;
+    inputMeta.nEmptyTimeUs = pInputData->nEmptyTimeUs;
 
     if ((pMpeg4Dec->hMFCMpeg4Handle.returnCodec == MFC_RET_OK) &&
         (pMpeg4Dec->bFirstFrame == OMX_FALSE)) {
         SSBSIP_MFC_DEC_OUTBUF_STATUS status;
-        OMX_S32 indexTimestamp = 0;
 
         /* wait for mfc decode done */
         if (pMpeg4Dec->NBDecThread.bDecoderRun == OMX_TRUE) {
@@ -1174,16 +1365,17 @@ OMX_ERRORTYPE SEC_MFC_Mpeg4_Decode(OMX_COMPONENTTYPE *pOMXComponent, SEC_OMX_DAT
         }
 
         status = SsbSipMfcDecGetOutBuf(hMFCHandle, &outputInfo);
-        bufWidth =  (outputInfo.img_width + 15) & (~15);
-        bufHeight =  (outputInfo.img_height + 15) & (~15);
 
-        if ((SsbSipMfcDecGetConfig(hMFCHandle, MFC_DEC_GETCONF_FRAME_TAG, &indexTimestamp) != MFC_RET_OK) ||
-            (((indexTimestamp < 0) || (indexTimestamp >= MAX_TIMESTAMP)))) {
+        if ((SsbSipMfcDecGetConfig(hMFCHandle, MFC_DEC_GETCONF_FRAME_TAG, &frameTag) != MFC_RET_OK) ||
+            (SEC_OMX_FrameTagTake(&pSECComponent->frameTagMap, frameTag, &outputMeta) != OMX_TRUE)) {
             pOutputData->timeStamp = pInputData->timeStamp;
             pOutputData->nFlags = pInputData->nFlags;
+            pOutputData->nEmptyTimeUs = pInputData->nEmptyTimeUs;
         } else {
-            pOutputData->timeStamp = pSECComponent->timeStamp[indexTimestamp];
-            pOutputData->nFlags = pSECComponent->nFlags[indexTimestamp];
+            pOutputData->timeStamp = outputMeta.timeStamp;
+            pOutputData->nFlags = outputMeta.nFlags;
+            pOutputData->nEmptyTimeUs = outputMeta.nEmptyTimeUs;
+            SEC_OMX_StatsAdd(&pSECComponent->stats, SEC_OMX_STATS_REORDER, outputMeta.nSubmitTimeUs);
         }
         SEC_OSAL_Log(SEC_LOG_TRACE, "timestamp %lld us (%.2f secs)", pOutputData->timeStamp, pOutputData->timeStamp / 1E6);
 
@@ -1262,9 +1454,11 @@ OMX_ERRORTYPE SEC_MFC_Mpeg4_Decode(OMX_COMPONENTTYPE *pOMXComponent, SEC_OMX_DAT
 
     if ((Check_Stream_PrefixCode(pInputData->dataBuffer, pInputData->dataLen, pMpeg4Dec->hMFCMpeg4Handle.codecType) == OMX_TRUE) &&
         ((pOutputData->nFlags & OMX_BUFFERFLAG_EOS) != OMX_BUFFERFLAG_EOS)) {
-        SsbSipMfcDecSetConfig(hMFCHandle, MFC_DEC_SETCONF_FRAME_TAG, &(pMpeg4Dec->hMFCMpeg4Handle.indexTimestamp));
-        pMpeg4Dec->hMFCMpeg4Handle.indexTimestamp++;
-        pMpeg4Dec->hMFCMpeg4Handle.indexTimestamp %= MAX_TIMESTAMP;
+        inputMeta.nStreamSize   = oneFrameSize;
+        inputMeta.nSubmitTimeUs = SEC_OSAL_GetSystemTimeUs();
+        frameTag = SEC_OMX_FrameTagPut(&pSECComponent->frameTagMap, &inputMeta);
+        SEC_OMX_StatsFrameIn(&pSECComponent->stats, oneFrameSize);
+        SsbSipMfcDecSetConfig(hMFCHandle, MFC_DEC_SETCONF_FRAME_TAG, &frameTag);
 
         SsbSipMfcDecSetInBuf(pMpeg4Dec->hMFCMpeg4Handle.hMFCHandle,
                              pMpeg4Dec->hMFCMpeg4Handle.pMFCStreamPhyBuffer,
@@ -1294,95 +1488,14 @@ OMX_ERRORTYPE SEC_MFC_Mpeg4_Decode(OMX_COMPONENTTYPE *pOMXComponent, SEC_OMX_DAT
     }
 
     /** Fill Output Buffer **/
-    if (outputDataValid == OMX_TRUE) {
-        SEC_OMX_BASEPORT *pSECInputPort = &pSECComponent->pSECPort[INPUT_PORT_INDEX];
-        SEC_OMX_BASEPORT *pSECOutputPort = &pSECComponent->pSECPort[OUTPUT_PORT_INDEX];
-        void *pOutputBuf[3];
-
-        int frameSize = bufWidth * bufHeight;
-        int imageSize = outputInfo.img_width * outputInfo.img_height;
-
-        int actualWidth  = outputInfo.img_width;
-        int actualHeight = outputInfo.img_height;
-        int actualImageSize = imageSize;
-
-        pOutputBuf[0] = (void *)pOutputData->dataBuffer;
-        pOutputBuf[1] = (void *)pOutputData->dataBuffer + actualImageSize;
-        pOutputBuf[2] = (void *)pOutputData->dataBuffer + ((actualImageSize * 5) / 4);
-
-#ifdef USE_ANDROID_EXTENSION
-        if (pSECOutputPort->bUseAndroidNativeBuffer == OMX_TRUE) {
-            OMX_U32 retANB = 0;
-            void *pVirAddrs[2];
-            actualWidth  = (outputInfo.img_width + 15) & (~15);
-            actualImageSize = actualWidth * actualHeight;
-
-             retANB = getVADDRfromANB(pOutputData->dataBuffer,
-                            (OMX_U32)pSECInputPort->portDefinition.format.video.nFrameWidth,
-                            (OMX_U32)pSECInputPort->portDefinition.format.video.nFrameHeight,
-                            pVirAddrs);
-            if (retANB != 0) {
-                SEC_OSAL_Log(SEC_LOG_ERROR, "Error getVADDRfromANB, Error code:%d", retANB);
-                ret = OMX_ErrorOverflow;
-                goto EXIT;
-            }
-            pOutputBuf[0] = pVirAddrs[0];
-            pOutputBuf[1] = pVirAddrs[1];
-        }
-#endif
-        if ((pMpeg4Dec->hMFCMpeg4Handle.bThumbnailMode == OMX_FALSE) &&
-            (pSECOutputPort->portDefinition.format.video.eColorFormat == OMX_SEC_COLOR_FormatNV12TPhysicalAddress))
-        {
-            /* if use Post copy address structure */
-            SEC_OSAL_Memcpy(pOutputBuf[0], &frameSize, sizeof(frameSize));
-            SEC_OSAL_Memcpy(pOutputBuf[0] + sizeof(frameSize), &(outputInfo.YPhyAddr), sizeof(outputInfo.YPhyAddr));
-            SEC_OSAL_Memcpy(pOutputBuf[0] + sizeof(frameSize) + (sizeof(void *) * 1), &(outputInfo.CPhyAddr), sizeof(outputInfo.CPhyAddr));
-            SEC_OSAL_Memcpy(pOutputBuf[0] + sizeof(frameSize) + (sizeof(void *) * 2), &(outputInfo.YVirAddr), sizeof(outputInfo.YVirAddr));
-            SEC_OSAL_Memcpy(pOutputBuf[0] + sizeof(frameSize) + (sizeof(void *) * 3), &(outputInfo.CVirAddr), sizeof(outputInfo.CVirAddr));
-            pOutputData->dataLen = (bufWidth * bufHeight * 3) / 2;
-        } else {
-            switch (pSECComponent->pSECPort[OUTPUT_PORT_INDEX].portDefinition.format.video.eColorFormat) {
-            case OMX_COLOR_FormatYUV420Planar:
-            {
-                SEC_OSAL_Log(SEC_LOG_TRACE, "YUV420P out");
-                csc_tiled_to_linear(
-                    (unsigned char *)pOutputBuf[0],
-                    (unsigned char *)outputInfo.YVirAddr,
-                    actualWidth,
-                    actualHeight);
-                csc_tiled_to_linear_deinterleave(
-                    (unsigned char *)pOutputBuf[1],
-                    (unsigned char *)pOutputBuf[2],
-                    (unsigned char *)outputInfo.CVirAddr,
-                    actualWidth,
-                    actualHeight >> 1);
-                pOutputData->dataLen = actualImageSize * 3 / 2;
-            }
-                break;
-            case OMX_COLOR_FormatYUV420SemiPlanar:
-            case OMX_SEC_COLOR_FormatANBYUV420SemiPlanar:
-            default:
-            {
-                SEC_OSAL_Log(SEC_LOG_TRACE, "YUV420SP out");
-                csc_tiled_to_linear(
-                    (unsigned char *)pOutputBuf[0],
-                    (unsigned char *)outputInfo.YVirAddr,
-                    actualWidth,
-                    actualHeight);
-                csc_tiled_to_linear(
-                    (unsigned char *)pOutputBuf[1],
-                    (unsigned char *)outputInfo.CVirAddr,
-                    actualWidth,
-                    actualHeight >> 1);
-                pOutputData->dataLen = actualImageSize * 3 / 2;
-            }
-                break;
-            }
-        }
-#ifdef USE_ANDROID_EXTENSION
-        if (pSECOutputPort->bUseAndroidNativeBuffer == OMX_TRUE)
-            putVADDRtoANB(pOutputData->dataBuffer);
-#endif
+    if ((outputDataValid == OMX_TRUE) &&
+        (SEC_OMX_DecFrameDefer(pOMXComponent, &outputInfo) == OMX_TRUE)) {
+        /* filled by SEC_MFC_Mpeg4Dec_FillOutput once an output buffer is free */
+        pOutputData->dataLen = 0;
+    } else if (outputDataValid == OMX_TRUE) {
+        OMX_ERRORTYPE fillRet = SEC_MFC_Mpeg4Dec_FillOutput(pOMXComponent, &outputInfo, pOutputData);
+        if (fillRet != OMX_ErrorNone)
+            ret = fillRet;
     } else {
         pOutputData->dataLen = 0;
     }
@@ -1442,15 +1555,74 @@ EXIT:
     return ret;
 }
 
+/* Port and codec parameter defaults, on a new component and on reset */
+static void SEC_MFC_Mpeg4Dec_SetDefault(SEC_OMX_BASECOMPONENT *pSECComponent)
+{
+    SEC_OMX_BASEPORT      *pSECPort = NULL;
+    SEC_MPEG4_HANDLE      *pMpeg4Dec = (SEC_MPEG4_HANDLE *)pSECComponent->hCodecHandle;
+    CODEC_TYPE             codecType = pMpeg4Dec->hMFCMpeg4Handle.codecType;
+    int i = 0;
+
+    /* Input port */
+    pSECPort = &pSECComponent->pSECPort[INPUT_PORT_INDEX];
+    pSECPort->portDefinition.format.video.nFrameWidth = DEFAULT_FRAME_WIDTH;
+    pSECPort->portDefinition.format.video.nFrameHeight= DEFAULT_FRAME_HEIGHT;
+    pSECPort->portDefinition.format.video.nStride = 0;
+    pSECPort->portDefinition.format.video.nSliceHeight = 0;
+    pSECPort->portDefinition.nBufferSize = DEFAULT_VIDEO_INPUT_BUFFER_SIZE;
+    if (codecType == CODEC_TYPE_MPEG4) {
+        pSECPort->portDefinition.format.video.eCompressionFormat = OMX_VIDEO_CodingMPEG4;
+        SEC_OSAL_Memset(pSECPort->portDefinition.format.video.cMIMEType, 0, MAX_OMX_MIMETYPE_SIZE);
+        SEC_OSAL_Strcpy(pSECPort->portDefinition.format.video.cMIMEType, "video/mpeg4");
+    } else {
+        pSECPort->portDefinition.format.video.eCompressionFormat = OMX_VIDEO_CodingH263;
+        SEC_OSAL_Memset(pSECPort->portDefinition.format.video.cMIMEType, 0, MAX_OMX_MIMETYPE_SIZE);
+        SEC_OSAL_Strcpy(pSECPort->portDefinition.format.video.cMIMEType, "video/h263");
+    }
+    pSECPort->portDefinition.format.video.pNativeRender = 0;
+    pSECPort->portDefinition.format.video.bFlagErrorConcealment = OMX_FALSE;
+    pSECPort->portDefinition.format.video.eColorFormat = OMX_COLOR_FormatUnused;
+    pSECPort->portDefinition.bEnabled = OMX_TRUE;
+
+    /* Output port */
+    pSECPort = &pSECComponent->pSECPort[OUTPUT_PORT_INDEX];
+    pSECPort->portDefinition.format.video.nFrameWidth = DEFAULT_FRAME_WIDTH;
+    pSECPort->portDefinition.format.video.nFrameHeight= DEFAULT_FRAME_HEIGHT;
+    pSECPort->portDefinition.format.video.nStride = 0;
+    pSECPort->portDefinition.format.video.nSliceHeight = 0;
+    pSECPort->portDefinition.nBufferSize = DEFAULT_VIDEO_OUTPUT_BUFFER_SIZE;
+    pSECPort->portDefinition.format.video.eCompressionFormat = OMX_VIDEO_CodingUnused;
+    SEC_OSAL_Memset(pSECPort->portDefinition.format.video.cMIMEType, 0, MAX_OMX_MIMETYPE_SIZE);
+    SEC_OSAL_Strcpy(pSECPort->portDefinition.format.video.cMIMEType, "raw/video");
+    pSECPort->portDefinition.format.video.pNativeRender = 0;
+    pSECPort->portDefinition.format.video.bFlagErrorConcealment = OMX_FALSE;
+    pSECPort->portDefinition.format.video.eColorFormat = OMX_COLOR_FormatYUV420SemiPlanar;
+    pSECPort->portDefinition.bEnabled = OMX_TRUE;
+
+    if (codecType == CODEC_TYPE_MPEG4) {
+        for(i = 0; i < ALL_PORT_NUM; i++) {
+            INIT_SET_SIZE_VERSION(&pMpeg4Dec->mpeg4Component[i], OMX_VIDEO_PARAM_MPEG4TYPE);
+            pMpeg4Dec->mpeg4Component[i].nPortIndex = i;
+            pMpeg4Dec->mpeg4Component[i].eProfile   = OMX_VIDEO_MPEG4ProfileSimple;
+            pMpeg4Dec->mpeg4Component[i].eLevel     = OMX_VIDEO_MPEG4Level3;
+        }
+    } else {
+        for(i = 0; i < ALL_PORT_NUM; i++) {
+            INIT_SET_SIZE_VERSION(&pMpeg4Dec->h263Component[i], OMX_VIDEO_PARAM_H263TYPE);
+            pMpeg4Dec->h263Component[i].nPortIndex = i;
+            pMpeg4Dec->h263Component[i].eProfile   = OMX_VIDEO_H263ProfileBaseline | OMX_VIDEO_H263ProfileISWV2;
+            pMpeg4Dec->h263Component[i].eLevel     = OMX_VIDEO_H263Level45;
+        }
+    }
+}
+
 OSCL_EXPORT_REF OMX_ERRORTYPE SEC_OMX_ComponentInit(OMX_HANDLETYPE hComponent, OMX_STRING componentName)
 {
     OMX_ERRORTYPE            ret = OMX_ErrorNone;
     OMX_COMPONENTTYPE       *pOMXComponent = NULL;
     SEC_OMX_BASECOMPONENT   *pSECComponent = NULL;
-    SEC_OMX_BASEPORT        *pSECPort = NULL;
     SEC_MPEG4_HANDLE        *pMpeg4Dec = NULL;
     OMX_S32                  codecType = -1;
-    int i = 0;
 
     FunctionIn();
 
@@ -1498,10 +1670,13 @@ OSCL_EXPORT_REF OMX_ERRORTYPE SEC_OMX_ComponentInit(OMX_HANDLETYPE hComponent, O
     pSECComponent->hCodecHandle = (OMX_HANDLETYPE)pMpeg4Dec;
     pMpeg4Dec->hMFCMpeg4Handle.codecType = codecType;
 
-    if (codecType == CODEC_TYPE_MPEG4)
+    if (codecType == CODEC_TYPE_MPEG4) {
         SEC_OSAL_Strcpy(pSECComponent->componentName, SEC_OMX_COMPONENT_MPEG4_DEC);
-    else
+        SEC_OSAL_Strcpy(pSECComponent->bufferProcessThreadAttr.name, "SecM4vDec");
+    } else {
         SEC_OSAL_Strcpy(pSECComponent->componentName, SEC_OMX_COMPONENT_H263_DEC);
+        SEC_OSAL_Strcpy(pSECComponent->bufferProcessThreadAttr.name, "SecH263Dec");
+    }
 
     /* Set componentVersion */
     pSECComponent->componentVersion.s.nVersionMajor = VERSIONMAJOR_NUMBER;
@@ -1524,57 +1699,7 @@ OSCL_EXPORT_REF OMX_ERRORTYPE SEC_OMX_ComponentInit(OMX_HANDLETYPE hComponent, O
     pSECComponent->capabilityFlags.iOMXComponentCanHandleIncompleteFrames         = OMX_TRUE;
     pSECComponent->capabilityFlags.iOMXComponentUsesFullAVCFrames                 = OMX_TRUE;
 
-    /* Input port */
-    pSECPort = &pSECComponent->pSECPort[INPUT_PORT_INDEX];
-    pSECPort->portDefinition.format.video.nFrameWidth = DEFAULT_FRAME_WIDTH;
-    pSECPort->portDefinition.format.video.nFrameHeight= DEFAULT_FRAME_HEIGHT;
-    pSECPort->portDefinition.format.video.nStride = 0;
-    pSECPort->portDefinition.format.video.nSliceHeight = 0;
-    pSECPort->portDefinition.nBufferSize = DEFAULT_VIDEO_INPUT_BUFFER_SIZE;
-    if (codecType == CODEC_TYPE_MPEG4) {
-        pSECPort->portDefinition.format.video.eCompressionFormat = OMX_VIDEO_CodingMPEG4;
-        SEC_OSAL_Memset(pSECPort->portDefinition.format.video.cMIMEType, 0, MAX_OMX_MIMETYPE_SIZE);
-        SEC_OSAL_Strcpy(pSECPort->portDefinition.format.video.cMIMEType, "video/mpeg4");
-    } else {
-        pSECPort->portDefinition.format.video.eCompressionFormat = OMX_VIDEO_CodingH263;
-        SEC_OSAL_Memset(pSECPort->portDefinition.format.video.cMIMEType, 0, MAX_OMX_MIMETYPE_SIZE);
-        SEC_OSAL_Strcpy(pSECPort->portDefinition.format.video.cMIMEType, "video/h263");
-    }
-    pSECPort->portDefinition.format.video.pNativeRender = 0;
-    pSECPort->portDefinition.format.video.bFlagErrorConcealment = OMX_FALSE;
-    pSECPort->portDefinition.format.video.eColorFormat = OMX_COLOR_FormatUnused;
-    pSECPort->portDefinition.bEnabled = OMX_TRUE;
-
-    /* Output port */
-    pSECPort = &pSECComponent->pSECPort[OUTPUT_PORT_INDEX];
-    pSECPort->portDefinition.format.video.nFrameWidth = DEFAULT_FRAME_WIDTH;
-    pSECPort->portDefinition.format.video.nFrameHeight= DEFAULT_FRAME_HEIGHT;
-    pSECPort->portDefinition.format.video.nStride = 0;
-    pSECPort->portDefinition.format.video.nSliceHeight = 0;
-    pSECPort->portDefinition.nBufferSize = DEFAULT_VIDEO_OUTPUT_BUFFER_SIZE;
-    pSECPort->portDefinition.format.video.eCompressionFormat = OMX_VIDEO_CodingUnused;
-    SEC_OSAL_Memset(pSECPort->portDefinition.format.video.cMIMEType, 0, MAX_OMX_MIMETYPE_SIZE);
-    SEC_OSAL_Strcpy(pSECPort->portDefinition.format.video.cMIMEType, "raw/video");
-    pSECPort->portDefinition.format.video.pNativeRender = 0;
-    pSECPort->portDefinition.format.video.bFlagErrorConcealment = OMX_FALSE;
-    pSECPort->portDefinition.format.video.eColorFormat = OMX_COLOR_FormatYUV420SemiPlanar;
-    pSECPort->portDefinition.bEnabled = OMX_TRUE;
-
-    if (codecType == CODEC_TYPE_MPEG4) {
-        for(i = 0; i < ALL_PORT_NUM; i++) {
-            INIT_SET_SIZE_VERSION(&pMpeg4Dec->mpeg4Component[i], OMX_VIDEO_PARAM_MPEG4TYPE);
-            pMpeg4Dec->mpeg4Component[i].nPortIndex = i;
-            pMpeg4Dec->mpeg4Component[i].eProfile   = OMX_VIDEO_MPEG4ProfileSimple;
-            pMpeg4Dec->mpeg4Component[i].eLevel     = OMX_VIDEO_MPEG4Level3;
-        }
-    } else {
-        for(i = 0; i < ALL_PORT_NUM; i++) {
-            INIT_SET_SIZE_VERSION(&pMpeg4Dec->h263Component[i], OMX_VIDEO_PARAM_H263TYPE);
-            pMpeg4Dec->h263Component[i].nPortIndex = i;
-            pMpeg4Dec->h263Component[i].eProfile   = OMX_VIDEO_H263ProfileBaseline | OMX_VIDEO_H263ProfileISWV2;
-            pMpeg4Dec->h263Component[i].eLevel     = OMX_VIDEO_H263Level45;
-        }
-    }
+    SEC_MFC_Mpeg4Dec_SetDefault(pSECComponent);
 
     pOMXComponent->GetParameter      = &SEC_MFC_Mpeg4Dec_GetParameter;
     pOMXComponent->SetParameter      = &SEC_MFC_Mpeg4Dec_SetParameter;
@@ -1587,6 +1712,9 @@ OSCL_EXPORT_REF OMX_ERRORTYPE SEC_OMX_ComponentInit(OMX_HANDLETYPE hComponent, O
     pSECComponent->sec_mfc_componentInit      = &SEC_MFC_Mpeg4Dec_Init;
     pSECComponent->sec_mfc_componentTerminate = &SEC_MFC_Mpeg4Dec_Terminate;
     pSECComponent->sec_mfc_bufferProcess      = &SEC_MFC_Mpeg4Dec_bufferProcess;
+    pSECComponent->sec_mfc_allocateInputBuffer = &SEC_MFC_Mpeg4Dec_AllocateInputBuffer;
+    pSECComponent->sec_mfc_releaseInputBuffer  = &SEC_MFC_Mpeg4Dec_ReleaseInputBuffer;
+    pSECComponent->sec_mfc_fillOutput          = &SEC_MFC_Mpeg4Dec_FillOutput;
     if (codecType == CODEC_TYPE_MPEG4)
         pSECComponent->sec_checkInputFrame = &Check_Mpeg4_Frame;
     else
@@ -1623,6 +1751,12 @@ OMX_ERRORTYPE SEC_OMX_ComponentDeinit(OMX_HANDLETYPE hComponent)
 
     pMpeg4Dec = (SEC_MPEG4_HANDLE *)pSECComponent->hCodecHandle;
     if (pMpeg4Dec != NULL) {
+        /* opened for input port buffers but never initialized */
+        if (pMpeg4Dec->hMFCMpeg4Handle.hMFCHandle != NULL) {
+            SEC_MFC_DecClose(pMpeg4Dec->hMFCMpeg4Handle.hMFCHandle, pMpeg4Dec->MFCDecInputBuffer, &pMpeg4Dec->MFCDecClientBuffer);
+            pMpeg4Dec->hMFCMpeg4Handle.hMFCHandle = NULL;
+            ghMFCHandle = NULL;
+        }
         SEC_OSAL_Free(pMpeg4Dec);
         pSECComponent->hCodecHandle = NULL;
     }
@@ -1639,3 +1773,42 @@ EXIT:
 
     return ret;
 }
+
+/* A Loaded component with no MFC instance back to its defaults, kept by the core for reuse */
+OSCL_EXPORT_REF OMX_ERRORTYPE SEC_OMX_ComponentReset(OMX_HANDLETYPE hComponent)
+{
+    OMX_ERRORTYPE            ret = OMX_ErrorNone;
+    OMX_COMPONENTTYPE       *pOMXComponent = NULL;
+    SEC_OMX_BASECOMPONENT   *pSECComponent = NULL;
+    SEC_MPEG4_HANDLE        *pMpeg4Dec = NULL;
+    CODEC_TYPE               codecType;
+
+    FunctionIn();
+
+    if (hComponent == NULL) {
+        ret = OMX_ErrorBadParameter;
+        goto EXIT;
+    }
+    pOMXComponent = (OMX_COMPONENTTYPE *)hComponent;
+    pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    pMpeg4Dec = (SEC_MPEG4_HANDLE *)pSECComponent->hCodecHandle;
+    if ((pMpeg4Dec == NULL) || (pMpeg4Dec->hMFCMpeg4Handle.hMFCHandle != NULL)) {
+        ret = OMX_ErrorIncorrectStateOperation;
+        goto EXIT;
+    }
+
+    ret = SEC_OMX_VideoDecodeComponentReset(pOMXComponent);
+    if (ret != OMX_ErrorNone) {
+        goto EXIT;
+    }
+
+    codecType = pMpeg4Dec->hMFCMpeg4Handle.codecType;
+    SEC_OSAL_Memset(pMpeg4Dec, 0, sizeof(SEC_MPEG4_HANDLE));
+    pMpeg4Dec->hMFCMpeg4Handle.codecType = codecType;
+    SEC_MFC_Mpeg4Dec_SetDefault(pSECComponent);
+
+EXIT:
+    FunctionOut();
+
+    return ret;
+}
@@ -29,6 +29,10 @@
 
 #include "SEC_OMX_Def.h"
 #include "OMX_Component.h"
+#include "color_space_convertor.h"
+
+/* Frames the MFC holds for MPEG-4/H.263: two references and a B-VOP */
+#define MPEG4_DEC_MAX_DPB    3
 
 
 typedef enum _CODEC_TYPE
@@ -60,11 +64,12 @@ typedef struct _SEC_MFC_MPEG4_HANDLE
     OMX_HANDLETYPE hMFCHandle;
     OMX_PTR        pMFCStreamBuffer;
     OMX_PTR        pMFCStreamPhyBuffer;
-    OMX_U32        indexTimestamp;
     OMX_BOOL       bConfiguredMFC;
     OMX_BOOL       bThumbnailMode;
     CODEC_TYPE     codecType;
     OMX_S32        returnCodec;
+    CSC_TILE_MAP   tileMapY;
+    CSC_TILE_MAP   tileMapC;
 } SEC_MFC_MPEG4_HANDLE;
 
 typedef struct _SEC_MPEG4_HANDLE
@@ -82,6 +87,7 @@ typedef struct _SEC_MPEG4_HANDLE
     OMX_BOOL bFirstFrame;
     MFC_DEC_INPUT_BUFFER MFCDecInputBuffer[MFC_INPUT_BUFFER_NUM_MAX];
     OMX_U32  indexInputBuffer;
+    MFC_DEC_CLIENT_BUFFER MFCDecClientBuffer;
 } SEC_MPEG4_HANDLE;
 
 #ifdef __cplusplus
@@ -90,6 +96,7 @@ extern "C" {
 
 OSCL_EXPORT_REF OMX_ERRORTYPE SEC_OMX_ComponentInit(OMX_HANDLETYPE hComponent, OMX_STRING componentName);
                 OMX_ERRORTYPE SEC_OMX_ComponentDeinit(OMX_HANDLETYPE hComponent);
+OSCL_EXPORT_REF OMX_ERRORTYPE SEC_OMX_ComponentReset(OMX_HANDLETYPE hComponent);
 
 #ifdef __cplusplus
 };
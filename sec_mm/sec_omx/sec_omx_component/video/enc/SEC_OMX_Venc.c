@@ -33,6 +33,7 @@
 #include "SEC_OMX_Venc.h"
 #include "SEC_OMX_Basecomponent.h"
 #include "SEC_OSAL_Thread.h"
+#include "SsbSipMfcApi.h"
 #include "color_space_convertor.h"
 
 #undef  SEC_LOG_TAG
@@ -126,6 +127,12 @@ OMX_ERRORTYPE SEC_OMX_UseBuffer(
         goto EXIT;
     }
 
+    if (pSECPort->assignedBufferNum == 0) {
+        ret = SEC_OMX_PortBufferQueueSetup(pSECPort);
+        if (ret != OMX_ErrorNone)
+            goto EXIT;
+    }
+
     temp_bufferHeader = (OMX_BUFFERHEADERTYPE *)SEC_OSAL_Malloc(sizeof(OMX_BUFFERHEADERTYPE));
     if (temp_bufferHeader == NULL) {
         ret = OMX_ErrorInsufficientResources;
@@ -181,6 +188,8 @@ OMX_ERRORTYPE SEC_OMX_AllocateBuffer(
     SEC_OMX_BASEPORT      *pSECPort = NULL;
     OMX_BUFFERHEADERTYPE  *temp_bufferHeader = NULL;
     OMX_U8                *temp_buffer = NULL;
+    OMX_PTR                temp_phyBuffer = NULL;
+    OMX_U32                bufferState = BUFFER_STATE_ALLOCATED;
     int                    i = 0;
 
     FunctionIn();
@@ -217,15 +226,39 @@ OMX_ERRORTYPE SEC_OMX_AllocateBuffer(
         goto EXIT;
     }
 
-    temp_buffer = SEC_OSAL_Malloc(sizeof(OMX_U8) * nSizeBytes);
+    if (pSECPort->assignedBufferNum == 0) {
+        ret = SEC_OMX_PortBufferQueueSetup(pSECPort);
+        if (ret != OMX_ErrorNone)
+            goto EXIT;
+    }
+
+    /* Output buffers in the codec's memory are encoded into in place */
+    if ((nPortIndex == OUTPUT_PORT_INDEX) && (pSECComponent->sec_mfc_allocateOutputBuffer != NULL)) {
+        for (i = 0; i < pSECPort->portDefinition.nBufferCountActual; i++) {
+            if (pSECPort->bufferStateAllocate[i] == BUFFER_STATE_FREE)
+                break;
+        }
+        if (pSECComponent->sec_mfc_allocateOutputBuffer(pOMXComponent, i, nSizeBytes, &temp_buffer, &temp_phyBuffer) == OMX_ErrorNone) {
+            bufferState = BUFFER_STATE_CODEC;
+        } else {
+            SEC_OSAL_Log(SEC_LOG_WARNING, "output buffer %d (%d bytes) is copied from the codec", i, nSizeBytes);
+            temp_buffer = NULL;
+            temp_phyBuffer = NULL;
+        }
+    }
+
     if (temp_buffer == NULL) {
-        ret = OMX_ErrorInsufficientResources;
-        goto EXIT;
+        temp_buffer = SEC_OSAL_Malloc(sizeof(OMX_U8) * nSizeBytes);
+        if (temp_buffer == NULL) {
+            ret = OMX_ErrorInsufficientResources;
+            goto EXIT;
+        }
     }
 
     temp_bufferHeader = (OMX_BUFFERHEADERTYPE *)SEC_OSAL_Malloc(sizeof(OMX_BUFFERHEADERTYPE));
     if (temp_bufferHeader == NULL) {
-        SEC_OSAL_Free(temp_buffer);
+        if (bufferState == BUFFER_STATE_ALLOCATED)
+            SEC_OSAL_Free(temp_buffer);
         temp_buffer = NULL;
         ret = OMX_ErrorInsufficientResources;
         goto EXIT;
@@ -235,15 +268,17 @@ OMX_ERRORTYPE SEC_OMX_AllocateBuffer(
     for (i = 0; i < pSECPort->portDefinition.nBufferCountActual; i++) {
         if (pSECPort->bufferStateAllocate[i] == BUFFER_STATE_FREE) {
             pSECPort->bufferHeader[i] = temp_bufferHeader;
-            pSECPort->bufferStateAllocate[i] = (BUFFER_STATE_ALLOCATED | HEADER_STATE_ALLOCATED);
+            pSECPort->bufferStateAllocate[i] = (bufferState | HEADER_STATE_ALLOCATED);
             INIT_SET_SIZE_VERSION(temp_bufferHeader, OMX_BUFFERHEADERTYPE);
             temp_bufferHeader->pBuffer        = temp_buffer;
             temp_bufferHeader->nAllocLen        = nSizeBytes;
             temp_bufferHeader->pAppPrivate        = pAppPrivate;
-            if (nPortIndex == INPUT_PORT_INDEX)
+            if (nPortIndex == INPUT_PORT_INDEX) {
                 temp_bufferHeader->nInputPortIndex = INPUT_PORT_INDEX;
-            else
+            } else {
                 temp_bufferHeader->nOutputPortIndex = OUTPUT_PORT_INDEX;
+                temp_bufferHeader->pOutputPortPrivate = temp_phyBuffer;
+            }
             pSECPort->assignedBufferNum++;
             if (pSECPort->assignedBufferNum == pSECPort->portDefinition.nBufferCountActual) {
                 pSECPort->portDefinition.bPopulated = OMX_TRUE;
@@ -258,7 +293,8 @@ OMX_ERRORTYPE SEC_OMX_AllocateBuffer(
     }
 
     SEC_OSAL_Free(temp_bufferHeader);
-    SEC_OSAL_Free(temp_buffer);
+    if (bufferState == BUFFER_STATE_ALLOCATED)
+        SEC_OSAL_Free(temp_buffer);
     ret = OMX_ErrorInsufficientResources;
 
 EXIT:
@@ -319,6 +355,11 @@ OMX_ERRORTYPE SEC_OMX_FreeBuffer(
                     SEC_OSAL_Free(pSECPort->bufferHeader[i]->pBuffer);
                     pSECPort->bufferHeader[i]->pBuffer = NULL;
                     pBufferHdr->pBuffer = NULL;
+                } else if (pSECPort->bufferStateAllocate[i] & BUFFER_STATE_CODEC) {
+                    /* memory of the codec, released with the MFC */
+                    pSECPort->bufferHeader[i]->pBuffer = NULL;
+                    pSECPort->bufferHeader[i]->pOutputPortPrivate = NULL;
+                    pBufferHdr->pBuffer = NULL;
                 } else if (pSECPort->bufferStateAllocate[i] & BUFFER_STATE_ASSIGNED) {
                     ; /* None*/
                 }
@@ -457,6 +498,7 @@ static OMX_ERRORTYPE SEC_InputBufferReturn(OMX_COMPONENTTYPE *pOMXComponent)
     dataBuffer->bufferHeader  = NULL;
     dataBuffer->nFlags        = 0;
     dataBuffer->timeStamp     = 0;
+    dataBuffer->nEmptyTimeUs  = 0;
 
 EXIT:
     FunctionOut();
@@ -484,7 +526,7 @@ OMX_ERRORTYPE SEC_InputBufferGetQueue(SEC_OMX_BASECOMPONENT *pSECComponent)
         SEC_OSAL_SemaphoreWait(pSECPort->bufferSemID);
         SEC_OSAL_MutexLock(inputUseBuffer->bufferMutex);
         if (dataBuffer->dataValid != OMX_TRUE) {
-            message = (SEC_OMX_MESSAGE *)SEC_OSAL_Dequeue(&pSECPort->bufferQ);
+            message = (SEC_OMX_MESSAGE *)SEC_OSAL_RingGet(&pSECPort->bufferQ);
             if (message == NULL) {
                 ret = OMX_ErrorUndefined;
                 SEC_OSAL_MutexUnlock(inputUseBuffer->bufferMutex);
@@ -499,10 +541,11 @@ OMX_ERRORTYPE SEC_InputBufferGetQueue(SEC_OMX_BASECOMPONENT *pSECComponent)
             dataBuffer->dataValid = OMX_TRUE;
             dataBuffer->nFlags = dataBuffer->bufferHeader->nFlags;
             dataBuffer->timeStamp = dataBuffer->bufferHeader->nTimeStamp;
+            dataBuffer->nEmptyTimeUs = SEC_OMX_StatsInputTaken(&pSECComponent->stats, message->messageParam);
             pSECComponent->processData[INPUT_PORT_INDEX].dataBuffer = dataBuffer->bufferHeader->pBuffer;
             pSECComponent->processData[INPUT_PORT_INDEX].allocSize = dataBuffer->bufferHeader->nAllocLen;
 
-            SEC_OSAL_Free(message);
+            SEC_OSAL_PoolFree(pSECComponent->hMemoryPool, message);
         }
         SEC_OSAL_MutexUnlock(inputUseBuffer->bufferMutex);
         ret = OMX_ErrorNone;
@@ -513,6 +556,37 @@ EXIT:
     return ret;
 }
 
+/* Hands a filled output buffer to the client or the tunneled component */
+static void SEC_OutputBufferDeliver(OMX_COMPONENTTYPE *pOMXComponent, OMX_BUFFERHEADERTYPE *bufferHeader, OMX_U64 nEmptyTimeUs)
+{
+    SEC_OMX_BASECOMPONENT *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    SEC_OMX_BASEPORT      *secOMXOutputPort = &pSECComponent->pSECPort[OUTPUT_PORT_INDEX];
+
+    if (pSECComponent->propagateMarkType.hMarkTargetComponent != NULL) {
+        bufferHeader->hMarkTargetComponent = pSECComponent->propagateMarkType.hMarkTargetComponent;
+        bufferHeader->pMarkData = pSECComponent->propagateMarkType.pMarkData;
+        pSECComponent->propagateMarkType.hMarkTargetComponent = NULL;
+        pSECComponent->propagateMarkType.pMarkData = NULL;
+    }
+
+    if (bufferHeader->nFlags & OMX_BUFFERFLAG_EOS) {
+        pSECComponent->pCallbacks->EventHandler(pOMXComponent,
+                        pSECComponent->callbackData,
+                        OMX_EventBufferFlag,
+                        OUTPUT_PORT_INDEX,
+                        bufferHeader->nFlags, NULL);
+    }
+
+    if (bufferHeader->nFilledLen > 0)
+        SEC_OMX_StatsFrameOut(&pSECComponent->stats, nEmptyTimeUs);
+
+    if (CHECK_PORT_TUNNELED(secOMXOutputPort)) {
+        OMX_EmptyThisBuffer(secOMXOutputPort->tunneledComponent, bufferHeader);
+    } else {
+        pSECComponent->pCallbacks->FillBufferDone(pOMXComponent, pSECComponent->callbackData, bufferHeader);
+    }
+}
+
 static OMX_ERRORTYPE SEC_OutputBufferReturn(OMX_COMPONENTTYPE *pOMXComponent)
 {
     OMX_ERRORTYPE          ret = OMX_ErrorNone;
@@ -530,26 +604,7 @@ static OMX_ERRORTYPE SEC_OutputBufferReturn(OMX_COMPONENTTYPE *pOMXComponent)
         bufferHeader->nFlags     = dataBuffer->nFlags;
         bufferHeader->nTimeStamp = dataBuffer->timeStamp;
 
-        if (pSECComponent->propagateMarkType.hMarkTargetComponent != NULL) {
-            bufferHeader->hMarkTargetComponent = pSECComponent->propagateMarkType.hMarkTargetComponent;
-            bufferHeader->pMarkData = pSECComponent->propagateMarkType.pMarkData;
-            pSECComponent->propagateMarkType.hMarkTargetComponent = NULL;
-            pSECComponent->propagateMarkType.pMarkData = NULL;
-        }
-
-        if (bufferHeader->nFlags & OMX_BUFFERFLAG_EOS) {
-            pSECComponent->pCallbacks->EventHandler(pOMXComponent,
-                            pSECComponent->callbackData,
-                            OMX_EventBufferFlag,
-                            OUTPUT_PORT_INDEX,
-                            bufferHeader->nFlags, NULL);
-        }
-
-        if (CHECK_PORT_TUNNELED(secOMXOutputPort)) {
-            OMX_EmptyThisBuffer(secOMXOutputPort->tunneledComponent, bufferHeader);
-        } else {
-            pSECComponent->pCallbacks->FillBufferDone(pOMXComponent, pSECComponent->callbackData, bufferHeader);
-        }
+        SEC_OutputBufferDeliver(pOMXComponent, bufferHeader, dataBuffer->nEmptyTimeUs);
     }
 
     if ((pSECComponent->currentState == OMX_StatePause) &&
@@ -566,6 +621,7 @@ static OMX_ERRORTYPE SEC_OutputBufferReturn(OMX_COMPONENTTYPE *pOMXComponent)
     dataBuffer->bufferHeader  = NULL;
     dataBuffer->nFlags        = 0;
     dataBuffer->timeStamp     = 0;
+    dataBuffer->nEmptyTimeUs  = 0;
 
 EXIT:
     FunctionOut();
@@ -593,7 +649,7 @@ OMX_ERRORTYPE SEC_OutputBufferGetQueue(SEC_OMX_BASECOMPONENT *pSECComponent)
         SEC_OSAL_SemaphoreWait(pSECPort->bufferSemID);
         SEC_OSAL_MutexLock(outputUseBuffer->bufferMutex);
         if (dataBuffer->dataValid != OMX_TRUE) {
-            message = (SEC_OMX_MESSAGE *)SEC_OSAL_Dequeue(&pSECPort->bufferQ);
+            message = (SEC_OMX_MESSAGE *)SEC_OSAL_RingGet(&pSECPort->bufferQ);
             if (message == NULL) {
                 ret = OMX_ErrorUndefined;
                 SEC_OSAL_MutexUnlock(outputUseBuffer->bufferMutex);
@@ -608,7 +664,7 @@ OMX_ERRORTYPE SEC_OutputBufferGetQueue(SEC_OMX_BASECOMPONENT *pSECComponent)
             dataBuffer->dataValid =OMX_TRUE;
             /* dataBuffer->nFlags = dataBuffer->bufferHeader->nFlags; */
             /* dataBuffer->nTimeStamp = dataBuffer->bufferHeader->nTimeStamp; */
-            SEC_OSAL_Free(message);
+            SEC_OSAL_PoolFree(pSECComponent->hMemoryPool, message);
         }
         SEC_OSAL_MutexUnlock(outputUseBuffer->bufferMutex);
         ret = OMX_ErrorNone;
@@ -635,6 +691,7 @@ static OMX_ERRORTYPE SEC_BufferReset(OMX_COMPONENTTYPE *pOMXComponent, OMX_U32 p
     dataBuffer->bufferHeader  = NULL;
     dataBuffer->nFlags        = 0;
     dataBuffer->timeStamp     = 0;
+    dataBuffer->nEmptyTimeUs  = 0;
 
     return ret;
 }
@@ -653,10 +710,133 @@ static OMX_ERRORTYPE SEC_DataReset(OMX_COMPONENTTYPE *pOMXComponent, OMX_U32 por
     processData->usedDataLen   = 0;
     processData->nFlags        = 0;
     processData->timeStamp     = 0;
+    processData->nEmptyTimeUs  = 0;
 
     return ret;
 }
 
+/*
+ * Layout of a raw frame of the input port at pBuffer.
+ * nStride and nSliceHeight of the port are used if they are larger than
+ * the picture. Returns the frame size, 0 if the CPU does not convert the
+ * color format.
+ */
+static OMX_U32 SEC_InputFrameLayout(SEC_OMX_BASEPORT *pSECPort, OMX_BYTE pBuffer, CSC_LINEAR_FRAME *pFrame)
+{
+    OMX_U32 width = pSECPort->portDefinition.format.video.nFrameWidth;
+    OMX_U32 height = pSECPort->portDefinition.format.video.nFrameHeight;
+    OMX_U32 stride = 0;
+    OMX_U32 sliceHeight = pSECPort->portDefinition.format.video.nSliceHeight;
+
+    if (pSECPort->portDefinition.format.video.nStride > 0)
+        stride = pSECPort->portDefinition.format.video.nStride;
+    if (sliceHeight < height)
+        sliceHeight = height;
+
+    pFrame->plane[0] = (char *)pBuffer;
+    pFrame->plane[1] = NULL;
+    pFrame->plane[2] = NULL;
+    pFrame->stride[1] = 0;
+    pFrame->stride[2] = 0;
+
+    switch ((OMX_U32)pSECPort->portDefinition.format.video.eColorFormat) {
+    case OMX_COLOR_FormatYUV420Planar:
+        if (stride < width)
+            stride = width;
+        pFrame->layout = CSC_LAYOUT_I420;
+        pFrame->plane[1] = pFrame->plane[0] + (stride * sliceHeight);
+        pFrame->plane[2] = pFrame->plane[1] + ((stride / 2) * (sliceHeight / 2));
+        pFrame->stride[0] = stride;
+        pFrame->stride[1] = stride / 2;
+        pFrame->stride[2] = stride / 2;
+        return (stride * sliceHeight) + ((stride / 2) * (sliceHeight / 2) * 2);
+    case OMX_COLOR_FormatYUV420SemiPlanar:
+    case OMX_SEC_COLOR_FormatNV21Linear:
+        if (stride < width)
+            stride = width;
+        if (pSECPort->portDefinition.format.video.eColorFormat == OMX_COLOR_FormatYUV420SemiPlanar)
+            pFrame->layout = CSC_LAYOUT_NV12;
+        else
+            pFrame->layout = CSC_LAYOUT_NV21;
+        pFrame->plane[1] = pFrame->plane[0] + (stride * sliceHeight);
+        pFrame->stride[0] = stride;
+        pFrame->stride[1] = stride;
+        return (stride * sliceHeight) + (stride * (sliceHeight / 2));
+    case OMX_COLOR_FormatYCbYCr:
+        if (stride < (width * 2))
+            stride = width * 2;
+        pFrame->layout = CSC_LAYOUT_YUYV;
+        pFrame->stride[0] = stride;
+        return stride * sliceHeight;
+    default:
+        break;
+    }
+
+    return 0;
+}
+
+/*
+ * Converts a raw input frame into the NV12T input buffer of the MFC in one
+ * pass. A part of a frame is only gathered in the staging buffer until the
+ * frame is complete. Returns OMX_FALSE if the staging buffer or the tile
+ * maps can not be allocated.
+ */
+static OMX_BOOL SEC_InputFrameToMFC(
+    OMX_COMPONENTTYPE *pOMXComponent,
+    OMX_BYTE           pStream,
+    OMX_U32            streamLen,
+    OMX_U32            frameSize,
+    OMX_BOOL           bFrameEnd)
+{
+    SEC_OMX_BASECOMPONENT *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    SEC_OMX_BASEPORT      *pSECPort = &pSECComponent->pSECPort[INPUT_PORT_INDEX];
+    SEC_OMX_DATA          *inputData = &pSECComponent->processData[INPUT_PORT_INDEX];
+    SEC_OMX_ENC_INPUT     *pEncInput = (SEC_OMX_ENC_INPUT *)pSECComponent->hEncInput;
+    OMX_U32                width = pSECPort->portDefinition.format.video.nFrameWidth;
+    OMX_U32                height = pSECPort->portDefinition.format.video.nFrameHeight;
+    OMX_BYTE               pSrc = pStream;
+    CSC_LINEAR_FRAME       frame;
+
+    if ((inputData->dataLen != 0) || (streamLen < frameSize)) {
+        /* frame split over several buffers */
+        if (pEncInput->nStagingSize < frameSize) {
+            SEC_OSAL_Free(pEncInput->pStaging);
+            pEncInput->pStaging = SEC_OSAL_Malloc(frameSize);
+            if (pEncInput->pStaging == NULL) {
+                pEncInput->nStagingSize = 0;
+                SEC_OSAL_Log(SEC_LOG_ERROR, "OMX_ErrorInsufficientResources, Line:%d", __LINE__);
+                return OMX_FALSE;
+            }
+            pEncInput->nStagingSize = frameSize;
+        }
+        if ((inputData->dataLen + streamLen) > frameSize)
+            streamLen = frameSize - inputData->dataLen;
+        SEC_OSAL_Memcpy(pEncInput->pStaging + inputData->dataLen, pStream, streamLen);
+
+        if (bFrameEnd == OMX_FALSE)
+            return OMX_TRUE;
+        pSrc = pEncInput->pStaging;
+    }
+
+    if ((csc_tile_map_update(&pEncInput->tileMapY, width, height) != 0) ||
+        (csc_tile_map_update(&pEncInput->tileMapC, width, height >> 1) != 0)) {
+        SEC_OSAL_Log(SEC_LOG_ERROR, "OMX_ErrorInsufficientResources, Line:%d", __LINE__);
+        return OMX_FALSE;
+    }
+
+    SEC_InputFrameLayout(pSECPort, pSrc, &frame);
+    if ((width * height) >= PARALLEL_CSC_MIN_FRAME_SIZE)
+        csc_linear_to_tiled_frame_parallel(inputData->specificBufferHeader.YVirAddr,
+                                           inputData->specificBufferHeader.CVirAddr,
+                                           &frame, &pEncInput->tileMapY, &pEncInput->tileMapC);
+    else
+        csc_linear_to_tiled_frame(inputData->specificBufferHeader.YVirAddr,
+                                  inputData->specificBufferHeader.CVirAddr,
+                                  &frame, &pEncInput->tileMapY, &pEncInput->tileMapC);
+
+    return OMX_TRUE;
+}
+
 OMX_BOOL SEC_Preprocessor_InputData(OMX_COMPONENTTYPE *pOMXComponent)
 {
     OMX_BOOL               ret = OMX_FALSE;
@@ -670,8 +850,25 @@ OMX_BOOL SEC_Preprocessor_InputData(OMX_COMPONENTTYPE *pOMXComponent)
     OMX_BOOL               flagEOS = OMX_FALSE;
     OMX_BOOL               flagEOF = OMX_FALSE;
     OMX_BOOL               previousFrameEOF = OMX_FALSE;
+    OMX_U64                framingStartUs = 0;
+    SEC_OMX_BASEPORT      *pSECInputPort = &pSECComponent->pSECPort[INPUT_PORT_INDEX];
+    OMX_U32                frameSize = 0;
+    OMX_U32                inputCapacity = 0;
+    OMX_BOOL               bConvert = OMX_FALSE;
+    CSC_LINEAR_FRAME       inputFrame;
 
     if (inputUseBuffer->dataValid == OMX_TRUE) {
+        framingStartUs = SEC_OSAL_GetSystemTimeUs();
+        frameSize = SEC_InputFrameLayout(pSECInputPort, NULL, &inputFrame);
+        inputCapacity = inputData->allocSize;
+        if ((frameSize != 0) &&
+            (pSECInputPort->portDefinition.format.video.eColorFormat != OMX_SEC_COLOR_FormatNV12TPhysicalAddress) &&
+            (pSECInputPort->bStoreMetaDataInBuffer == OMX_FALSE)) {
+            /* the frame goes to the MFC input buffer, not to inputData */
+            bConvert = OMX_TRUE;
+            if (inputCapacity < frameSize)
+                inputCapacity = frameSize;
+        }
         checkInputStream = inputUseBuffer->bufferHeader->pBuffer + inputUseBuffer->usedDataLen;
         checkInputStreamLen = inputUseBuffer->remainDataLen;
 
@@ -703,13 +900,9 @@ OMX_BOOL SEC_Preprocessor_InputData(OMX_COMPONENTTYPE *pOMXComponent)
             SEC_OMX_BASEPORT *pSECPort = &pSECComponent->pSECPort[INPUT_PORT_INDEX];
             int width = pSECPort->portDefinition.format.video.nFrameWidth;
             int height = pSECPort->portDefinition.format.video.nFrameHeight;
-            int oneFrameSize = 0;
+            int oneFrameSize = frameSize;
 
-            if (pSECPort->portDefinition.format.video.eColorFormat == OMX_COLOR_FormatYUV420SemiPlanar)
-                oneFrameSize = (width * height * 3) / 2;
-            else if (pSECPort->portDefinition.format.video.eColorFormat == OMX_COLOR_FormatYUV420Planar)
-                oneFrameSize = (width * height * 3) / 2;
-            else if (pSECPort->portDefinition.format.video.eColorFormat == OMX_COLOR_FormatYUV422Planar)
+            if (pSECPort->portDefinition.format.video.eColorFormat == OMX_COLOR_FormatYUV422Planar)
                 oneFrameSize = width * height * 2;
 
             if (previousFrameEOF == OMX_TRUE) {
@@ -745,40 +938,29 @@ OMX_BOOL SEC_Preprocessor_InputData(OMX_COMPONENTTYPE *pOMXComponent)
         if (inputUseBuffer->nFlags & OMX_BUFFERFLAG_EOS)
             pSECComponent->bSaveFlagEOS = OMX_TRUE;
 
-        if (((inputData->allocSize) - (inputData->dataLen)) >= copySize) {
+        if ((inputCapacity - inputData->dataLen) >= copySize) {
             SEC_OMX_BASEPORT *pSECPort = &pSECComponent->pSECPort[INPUT_PORT_INDEX];
+            OMX_BOOL bConverted = OMX_TRUE;
 
-            if ((pSECPort->portDefinition.format.video.eColorFormat != OMX_SEC_COLOR_FormatNV12TPhysicalAddress) &&
-                (pSECPort->bStoreMetaDataInBuffer == OMX_FALSE)) {
-                if (flagEOF == OMX_TRUE) {
-                    OMX_U32 width, height;
-
-                    width = pSECPort->portDefinition.format.video.nFrameWidth;
-                    height = pSECPort->portDefinition.format.video.nFrameHeight;
-
-                    SEC_OSAL_Log(SEC_LOG_TRACE, "inputData->specificBufferHeader.YVirAddr : 0x%x", inputData->specificBufferHeader.YVirAddr);
-                    SEC_OSAL_Log(SEC_LOG_TRACE, "inputData->specificBufferHeader.CVirAddr : 0x%x", inputData->specificBufferHeader.CVirAddr);
-
-                    SEC_OSAL_Log(SEC_LOG_TRACE, "width:%d, height:%d, Ysize:%d", width, height, ALIGN_TO_8KB(ALIGN_TO_128B(width) * ALIGN_TO_32B(height)));
-                    SEC_OSAL_Log(SEC_LOG_TRACE, "width:%d, height:%d, Csize:%d", width, height, ALIGN_TO_8KB(ALIGN_TO_128B(width) * ALIGN_TO_32B(height / 2)));
-
-                    switch (pSECPort->portDefinition.format.video.eColorFormat) {
-                    case OMX_COLOR_FormatYUV420Planar:
-                        /* Real YUV420P Data */
-                        csc_linear_to_tiled(inputData->specificBufferHeader.YVirAddr,
-                                                checkInputStream, width, height);
-                        csc_linear_to_tiled_interleave(inputData->specificBufferHeader.CVirAddr,
-                                                 checkInputStream + (width * height),
-                                                 checkInputStream + (((width * height) * 5) / 4),
-                                                 width, height >> 1);
-                        break;
-                    case OMX_COLOR_FormatYUV420SemiPlanar:
-                    default:
-                        SEC_OSAL_Memcpy(inputData->specificBufferHeader.YVirAddr, checkInputStream, (width * height));
-                        SEC_OSAL_Memcpy(inputData->specificBufferHeader.CVirAddr, checkInputStream + (width * height), (width * height / 2));
-                        break;
-                    }
-                }
+            if (bConvert == OMX_TRUE) {
+                OMX_U64 cscStartUs = SEC_OSAL_GetSystemTimeUs();
+
+                SEC_OSAL_Log(SEC_LOG_TRACE, "inputData->specificBufferHeader.YVirAddr : 0x%x", inputData->specificBufferHeader.YVirAddr);
+                SEC_OSAL_Log(SEC_LOG_TRACE, "inputData->specificBufferHeader.CVirAddr : 0x%x", inputData->specificBufferHeader.CVirAddr);
+
+                bConverted = SEC_InputFrameToMFC(pOMXComponent, checkInputStream, copySize, frameSize, flagEOF);
+
+                /* the framing time goes without the conversion */
+                if (flagEOF == OMX_TRUE)
+                    framingStartUs += SEC_OMX_StatsAdd(&pSECComponent->stats, SEC_OMX_STATS_CSC, cscStartUs) - cscStartUs;
+            } else if ((pSECPort->portDefinition.format.video.eColorFormat != OMX_SEC_COLOR_FormatNV12TPhysicalAddress) &&
+                       (pSECPort->bStoreMetaDataInBuffer == OMX_FALSE) &&
+                       (flagEOF == OMX_TRUE)) {
+                OMX_U32 width = pSECPort->portDefinition.format.video.nFrameWidth;
+                OMX_U32 height = pSECPort->portDefinition.format.video.nFrameHeight;
+
+                SEC_OSAL_Memcpy(inputData->specificBufferHeader.YVirAddr, checkInputStream, (width * height));
+                SEC_OSAL_Memcpy(inputData->specificBufferHeader.CVirAddr, checkInputStream + (width * height), (width * height / 2));
             }
 
             inputUseBuffer->dataLen -= copySize;
@@ -791,6 +973,7 @@ OMX_BOOL SEC_Preprocessor_InputData(OMX_COMPONENTTYPE *pOMXComponent)
             if (previousFrameEOF == OMX_TRUE) {
                 inputData->timeStamp = inputUseBuffer->timeStamp;
                 inputData->nFlags = inputUseBuffer->nFlags;
+                inputData->nEmptyTimeUs = inputUseBuffer->nEmptyTimeUs;
             }
 
             if (pSECComponent->bUseFlagEOF == OMX_TRUE) {
@@ -808,6 +991,12 @@ OMX_BOOL SEC_Preprocessor_InputData(OMX_COMPONENTTYPE *pOMXComponent)
                     inputData->nFlags = (inputUseBuffer->nFlags & (~OMX_BUFFERFLAG_EOS));
                 }
             }
+
+            if (bConverted == OMX_FALSE) {
+                /* out of memory, the frame is dropped */
+                SEC_DataReset(pOMXComponent, INPUT_PORT_INDEX);
+                flagEOF = OMX_FALSE;
+            }
         } else {
             /*????????????????????????????????? Error ?????????????????????????????????*/
             SEC_DataReset(pOMXComponent, INPUT_PORT_INDEX);
@@ -823,6 +1012,8 @@ OMX_BOOL SEC_Preprocessor_InputData(OMX_COMPONENTTYPE *pOMXComponent)
     }
 
     if (flagEOF == OMX_TRUE) {
+        SEC_OMX_StatsAdd(&pSECComponent->stats, SEC_OMX_STATS_FRAMING, framingStartUs);
+
         if (pSECComponent->checkTimeStamp.needSetStartTimeStamp == OMX_TRUE) {
             pSECComponent->checkTimeStamp.needCheckStartTimeStamp = OMX_TRUE;
             pSECComponent->checkTimeStamp.startTimeStamp = inputData->timeStamp;
@@ -837,6 +1028,52 @@ OMX_BOOL SEC_Preprocessor_InputData(OMX_COMPONENTTYPE *pOMXComponent)
     return ret;
 }
 
+/* Output buffer lent to the codec that carries no frame, kept for the next one */
+static void SEC_OutputBufferUnused(OMX_COMPONENTTYPE *pOMXComponent, OMX_BUFFERHEADERTYPE *bufferHeader)
+{
+    SEC_OMX_BASECOMPONENT *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    SEC_OMX_DATABUFFER    *outputUseBuffer = &pSECComponent->secDataBuffer[OUTPUT_PORT_INDEX];
+
+    if (outputUseBuffer->dataValid == OMX_TRUE) {
+        bufferHeader->nFilledLen = 0;
+        bufferHeader->nOffset    = 0;
+        bufferHeader->nFlags     = 0;
+        pSECComponent->pCallbacks->FillBufferDone(pOMXComponent, pSECComponent->callbackData, bufferHeader);
+        return;
+    }
+
+    outputUseBuffer->bufferHeader  = bufferHeader;
+    outputUseBuffer->allocSize     = bufferHeader->nAllocLen;
+    outputUseBuffer->dataLen       = 0;
+    outputUseBuffer->remainDataLen = 0;
+    outputUseBuffer->usedDataLen   = 0;
+    outputUseBuffer->dataValid     = OMX_TRUE;
+}
+
+/* The codec encoded the frame straight into the client buffer of outputData */
+static void SEC_Postprocess_LentOutputData(OMX_COMPONENTTYPE *pOMXComponent)
+{
+    SEC_OMX_BASECOMPONENT *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    SEC_OMX_DATA          *outputData = &pSECComponent->processData[OUTPUT_PORT_INDEX];
+    OMX_BUFFERHEADERTYPE  *bufferHeader = outputData->bufferHeader;
+
+    outputData->bufferHeader  = NULL;
+    outputData->dataPhyBuffer = NULL;
+
+    if ((outputData->remainDataLen == 0) && !(outputData->nFlags & OMX_BUFFERFLAG_EOS)) {
+        SEC_OutputBufferUnused(pOMXComponent, bufferHeader);
+    } else {
+        bufferHeader->nFilledLen = outputData->remainDataLen;
+        bufferHeader->nOffset    = (outputData->dataBuffer + outputData->usedDataLen) - bufferHeader->pBuffer;
+        bufferHeader->nFlags     = outputData->nFlags;
+        bufferHeader->nTimeStamp = outputData->timeStamp;
+
+        SEC_OutputBufferDeliver(pOMXComponent, bufferHeader, outputData->nEmptyTimeUs);
+    }
+
+    SEC_DataReset(pOMXComponent, OUTPUT_PORT_INDEX);
+}
+
 OMX_BOOL SEC_Postprocess_OutputData(OMX_COMPONENTTYPE *pOMXComponent)
 {
     OMX_BOOL               ret = OMX_FALSE;
@@ -845,7 +1082,7 @@ OMX_BOOL SEC_Postprocess_OutputData(OMX_COMPONENTTYPE *pOMXComponent)
     SEC_OMX_DATA          *outputData = &pSECComponent->processData[OUTPUT_PORT_INDEX];
     OMX_U32                copySize = 0;
 
-    if (outputUseBuffer->dataValid == OMX_TRUE) {
+    if ((outputUseBuffer->dataValid == OMX_TRUE) || (outputData->bufferHeader != NULL)) {
         if (pSECComponent->checkTimeStamp.needCheckStartTimeStamp == OMX_TRUE) {
             if (pSECComponent->checkTimeStamp.startTimeStamp == outputData->timeStamp){
                 pSECComponent->checkTimeStamp.startTimeStamp = -19761123;
@@ -853,18 +1090,33 @@ OMX_BOOL SEC_Postprocess_OutputData(OMX_COMPONENTTYPE *pOMXComponent)
                 pSECComponent->checkTimeStamp.needSetStartTimeStamp = OMX_FALSE;
                 pSECComponent->checkTimeStamp.needCheckStartTimeStamp = OMX_FALSE;
             } else {
+                if (outputData->bufferHeader != NULL) {
+                    SEC_OutputBufferUnused(pOMXComponent, outputData->bufferHeader);
+                    outputData->bufferHeader = NULL;
+                }
                 SEC_DataReset(pOMXComponent, OUTPUT_PORT_INDEX);
 
                 ret = OMX_TRUE;
                 goto EXIT;
             }
         } else if (pSECComponent->checkTimeStamp.needSetStartTimeStamp == OMX_TRUE) {
+            if (outputData->bufferHeader != NULL) {
+                SEC_OutputBufferUnused(pOMXComponent, outputData->bufferHeader);
+                outputData->bufferHeader = NULL;
+            }
             SEC_DataReset(pOMXComponent, OUTPUT_PORT_INDEX);
 
             ret = OMX_TRUE;
             goto EXIT;
         }
 
+        if (outputData->bufferHeader != NULL) {
+            SEC_Postprocess_LentOutputData(pOMXComponent);
+
+            ret = OMX_TRUE;
+            goto EXIT;
+        }
+
         if (outputData->remainDataLen <= (outputUseBuffer->allocSize - outputUseBuffer->dataLen)) {
             copySize = outputData->remainDataLen;
             if (copySize > 0)
@@ -876,6 +1128,7 @@ OMX_BOOL SEC_Postprocess_OutputData(OMX_COMPONENTTYPE *pOMXComponent)
             outputUseBuffer->remainDataLen += copySize;
             outputUseBuffer->nFlags = outputData->nFlags;
             outputUseBuffer->timeStamp = outputData->timeStamp;
+            outputUseBuffer->nEmptyTimeUs = outputData->nEmptyTimeUs;
 
             ret = OMX_TRUE;
 
@@ -898,6 +1151,7 @@ OMX_BOOL SEC_Postprocess_OutputData(OMX_COMPONENTTYPE *pOMXComponent)
             outputUseBuffer->remainDataLen += copySize;
             outputUseBuffer->nFlags = 0;
             outputUseBuffer->timeStamp = outputData->timeStamp;
+            outputUseBuffer->nEmptyTimeUs = outputData->nEmptyTimeUs;
 
             ret = OMX_FALSE;
 
@@ -906,6 +1160,10 @@ OMX_BOOL SEC_Postprocess_OutputData(OMX_COMPONENTTYPE *pOMXComponent)
 
             SEC_OutputBufferReturn(pOMXComponent);
         }
+    } else if ((outputData->remainDataLen == 0) && !(outputData->nFlags & OMX_BUFFERFLAG_EOS)) {
+        /* the output buffer is lent to the codec and there is nothing to copy */
+        SEC_DataReset(pOMXComponent, OUTPUT_PORT_INDEX);
+        ret = OMX_TRUE;
     } else {
         ret = OMX_FALSE;
     }
@@ -1010,6 +1268,169 @@ EXIT:
     return ret;
 }
 
+/*
+ * Output port buffer nIndex in MFC memory. The memory of slotNum buffers
+ * of slotSize is allocated with the first one, without it output is copied.
+ */
+OMX_ERRORTYPE SEC_MFC_EncClientBufferGet(
+    OMX_PTR                hMFCHandle,
+    MFC_ENC_CLIENT_BUFFER *pClientBuffer,
+    OMX_U32                slotSize,
+    OMX_U32                slotNum,
+    OMX_U32                nIndex,
+    OMX_U32                nSizeBytes,
+    OMX_U8               **ppBuffer,
+    OMX_PTR               *ppPhyBuffer)
+{
+    OMX_ERRORTYPE ret = OMX_ErrorNone;
+    OMX_U8       *pStreamBuffer = NULL;
+    OMX_PTR       pStreamPhyBuffer = NULL;
+
+    FunctionIn();
+
+    if (pClientBuffer->pVirBase == NULL) {
+        if (slotSize < nSizeBytes)
+            slotSize = nSizeBytes;
+        slotSize = (slotSize + MFC_CLIENT_BUFFER_ALIGN - 1) & ~(MFC_CLIENT_BUFFER_ALIGN - 1);
+        if ((slotSize > MFC_ENC_CLIENT_BUFFER_SIZE_MAX) || (slotNum == 0) || (slotNum > MAX_BUFFER_NUM)) {
+            ret = OMX_ErrorInsufficientResources;
+            goto EXIT;
+        }
+
+        pStreamBuffer = SsbSipMfcEncGetStrmBuf(hMFCHandle, &pStreamPhyBuffer, slotSize * slotNum);
+        if (pStreamBuffer == NULL) {
+            SEC_OSAL_Log(SEC_LOG_WARNING, "no MFC memory for %d output buffers of %d bytes", slotNum, slotSize);
+            ret = OMX_ErrorInsufficientResources;
+            goto EXIT;
+        }
+        pClientBuffer->pVirBase = pStreamBuffer;
+        pClientBuffer->pPhyBase = pStreamPhyBuffer;
+        pClientBuffer->slotSize = slotSize;
+        pClientBuffer->slotNum  = slotNum;
+        pClientBuffer->pLent    = NULL;
+    }
+
+    if ((nIndex >= pClientBuffer->slotNum) || (nSizeBytes > pClientBuffer->slotSize)) {
+        ret = OMX_ErrorInsufficientResources;
+        goto EXIT;
+    }
+
+    *ppBuffer    = (OMX_U8 *)pClientBuffer->pVirBase + (pClientBuffer->slotSize * nIndex);
+    *ppPhyBuffer = (OMX_U8 *)pClientBuffer->pPhyBase + (pClientBuffer->slotSize * nIndex);
+
+EXIT:
+    FunctionOut();
+
+    return ret;
+}
+
+static void SEC_MFC_EncOutputGiveBack(OMX_COMPONENTTYPE *pOMXComponent, OMX_BUFFERHEADERTYPE *bufferHeader)
+{
+    SEC_OMX_BASECOMPONENT *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+
+    bufferHeader->nFilledLen = 0;
+    bufferHeader->nOffset    = 0;
+    bufferHeader->nFlags     = 0;
+    pSECComponent->pCallbacks->FillBufferDone(pOMXComponent, pSECComponent->callbackData, bufferHeader);
+}
+
+/*
+ * Called by the codec before it starts the MFC on a frame. The output
+ * buffer is lent to the MFC when it is in MFC memory and pOutputData, the
+ * frame encoded before, is not copied into it. Else the MFC encodes into
+ * its own stream buffer and the frame is copied by SEC_Postprocess_OutputData.
+ */
+void SEC_MFC_EncOutputLend(
+    OMX_COMPONENTTYPE     *pOMXComponent,
+    OMX_PTR                hMFCHandle,
+    MFC_ENC_CLIENT_BUFFER *pClientBuffer,
+    SEC_OMX_DATA          *pOutputData)
+{
+    SEC_OMX_BASECOMPONENT *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    SEC_OMX_DATABUFFER    *outputUseBuffer = &pSECComponent->secDataBuffer[OUTPUT_PORT_INDEX];
+    OMX_BUFFERHEADERTYPE  *bufferHeader = outputUseBuffer->bufferHeader;
+
+    FunctionIn();
+
+    /* still lent, the MFC did not run since */
+    if (pClientBuffer->pLent != NULL)
+        goto EXIT;
+
+    if ((outputUseBuffer->dataValid != OMX_TRUE) ||
+        (outputUseBuffer->dataLen != 0) ||
+        (bufferHeader->pOutputPortPrivate == NULL) ||
+        (pOutputData->nFlags & OMX_BUFFERFLAG_EOS) ||
+        ((pOutputData->bufferHeader == NULL) && (pOutputData->dataLen != 0))) {
+        SsbSipMfcEncSetOutBuf(hMFCHandle, NULL, NULL, 0);
+        goto EXIT;
+    }
+
+    SsbSipMfcEncSetOutBuf(hMFCHandle, bufferHeader->pOutputPortPrivate, bufferHeader->pBuffer, bufferHeader->nAllocLen);
+    pClientBuffer->pLent = bufferHeader;
+    SEC_BufferReset(pOMXComponent, OUTPUT_PORT_INDEX);
+
+EXIT:
+    FunctionOut();
+}
+
+/* Called by the codec with the output of the MFC in pOutputData */
+void SEC_MFC_EncOutputTake(
+    OMX_COMPONENTTYPE     *pOMXComponent,
+    MFC_ENC_CLIENT_BUFFER *pClientBuffer,
+    SEC_OMX_DATA          *pOutputData)
+{
+    OMX_BUFFERHEADERTYPE *bufferHeader = pClientBuffer->pLent;
+
+    FunctionIn();
+
+    if (bufferHeader == NULL)
+        goto EXIT;
+
+    pClientBuffer->pLent = NULL;
+    if (pOutputData->dataBuffer == bufferHeader->pBuffer) {
+        pOutputData->bufferHeader  = bufferHeader;
+        pOutputData->dataPhyBuffer = bufferHeader->pOutputPortPrivate;
+    } else {
+        SEC_OSAL_Log(SEC_LOG_WARNING, "output buffer lent to the MFC is not used");
+        SEC_MFC_EncOutputGiveBack(pOMXComponent, bufferHeader);
+    }
+
+EXIT:
+    FunctionOut();
+}
+
+/*
+ * Gives back the output buffer lent to the MFC and the encoded frame not
+ * delivered yet. The MFC must not be encoding.
+ */
+void SEC_MFC_EncOutputRelease(
+    OMX_COMPONENTTYPE     *pOMXComponent,
+    OMX_PTR                hMFCHandle,
+    MFC_ENC_CLIENT_BUFFER *pClientBuffer)
+{
+    SEC_OMX_BASECOMPONENT *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    SEC_OMX_DATA          *outputData = &pSECComponent->processData[OUTPUT_PORT_INDEX];
+
+    FunctionIn();
+
+    if (outputData->bufferHeader != NULL) {
+        SEC_MFC_EncOutputGiveBack(pOMXComponent, outputData->bufferHeader);
+        outputData->bufferHeader  = NULL;
+        outputData->dataPhyBuffer = NULL;
+        SEC_DataReset(pOMXComponent, OUTPUT_PORT_INDEX);
+    }
+
+    if (pClientBuffer->pLent != NULL) {
+        SEC_MFC_EncOutputGiveBack(pOMXComponent, pClientBuffer->pLent);
+        pClientBuffer->pLent = NULL;
+    }
+
+    if (hMFCHandle != NULL)
+        SsbSipMfcEncSetOutBuf(hMFCHandle, NULL, NULL, 0);
+
+    FunctionOut();
+}
+
 OMX_ERRORTYPE SEC_OMX_VideoEncodeGetParameter(
     OMX_IN OMX_HANDLETYPE hComponent,
     OMX_IN OMX_INDEXTYPE  nParamIndex,
@@ -1108,8 +1529,18 @@ OMX_ERRORTYPE SEC_OMX_VideoEncodeGetParameter(
                 portFormat->eColorFormat       = OMX_SEC_COLOR_FormatNV12TPhysicalAddress;
                 portFormat->xFramerate         = portDefinition->format.video.xFramerate;
                 break;
-#ifdef USE_ANDROID_EXTENSION
             case supportFormat_3:
+                portFormat->eCompressionFormat = OMX_VIDEO_CodingUnused;
+                portFormat->eColorFormat       = OMX_SEC_COLOR_FormatNV21Linear;
+                portFormat->xFramerate         = portDefinition->format.video.xFramerate;
+                break;
+            case supportFormat_4:
+                portFormat->eCompressionFormat = OMX_VIDEO_CodingUnused;
+                portFormat->eColorFormat       = OMX_COLOR_FormatYCbYCr;
+                portFormat->xFramerate         = portDefinition->format.video.xFramerate;
+                break;
+#ifdef USE_ANDROID_EXTENSION
+            case supportFormat_5:
                 portFormat->eCompressionFormat = OMX_VIDEO_CodingUnused;
                 portFormat->eColorFormat       = OMX_COLOR_FormatAndroidOpaque;
                 portFormat->xFramerate         = portDefinition->format.video.xFramerate;
@@ -1326,41 +1757,10 @@ EXIT:
     return ret;
 }
 
-OMX_ERRORTYPE SEC_OMX_VideoEncodeComponentInit(OMX_IN OMX_HANDLETYPE hComponent)
+/* Port defaults of the video encoder layer, the codec component sets its own on top */
+static void SEC_OMX_VideoEncodeSetDefault(SEC_OMX_BASECOMPONENT *pSECComponent)
 {
-    OMX_ERRORTYPE          ret = OMX_ErrorNone;
-    OMX_COMPONENTTYPE     *pOMXComponent = NULL;
-    SEC_OMX_BASECOMPONENT *pSECComponent = NULL;
-    SEC_OMX_BASEPORT      *pSECPort = NULL;
-
-    FunctionIn();
-
-    if (hComponent == NULL) {
-        ret = OMX_ErrorBadParameter;
-        goto EXIT;
-    }
-    pOMXComponent = (OMX_COMPONENTTYPE *)hComponent;
-    ret = SEC_OMX_Check_SizeVersion(pOMXComponent, sizeof(OMX_COMPONENTTYPE));
-    if (ret != OMX_ErrorNone) {
-        SEC_OSAL_Log(SEC_LOG_ERROR, "OMX_Error, Line:%d", __LINE__);
-        goto EXIT;
-    }
-
-    ret = SEC_OMX_BaseComponent_Constructor(pOMXComponent);
-    if (ret != OMX_ErrorNone) {
-        SEC_OSAL_Log(SEC_LOG_ERROR, "OMX_Error, Line:%d", __LINE__);
-        goto EXIT;
-    }
-
-    ret = SEC_OMX_Port_Constructor(pOMXComponent);
-    if (ret != OMX_ErrorNone) {
-        SEC_OMX_BaseComponent_Destructor(pOMXComponent);
-        SEC_OSAL_Log(SEC_LOG_ERROR, "OMX_Error, Line:%d", __LINE__);
-        goto EXIT;
-    }
-
-    pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
-    pSECComponent->bSaveFlagEOS = OMX_FALSE;
+    SEC_OMX_BASEPORT *pSECPort = NULL;
 
     /* Input port */
     pSECPort = &pSECComponent->pSECPort[INPUT_PORT_INDEX];
@@ -1369,7 +1769,6 @@ OMX_ERRORTYPE SEC_OMX_VideoEncodeComponentInit(OMX_IN OMX_HANDLETYPE hComponent)
     pSECPort->portDefinition.nBufferSize = 0;
     pSECPort->portDefinition.eDomain = OMX_PortDomainVideo;
 
-    pSECPort->portDefinition.format.video.cMIMEType = SEC_OSAL_Malloc(MAX_OMX_MIMETYPE_SIZE);
     SEC_OSAL_Strcpy(pSECPort->portDefinition.format.video.cMIMEType, "raw/video");
     pSECPort->portDefinition.format.video.pNativeRender = 0;
     pSECPort->portDefinition.format.video.bFlagErrorConcealment = OMX_FALSE;
@@ -1391,7 +1790,6 @@ OMX_ERRORTYPE SEC_OMX_VideoEncodeComponentInit(OMX_IN OMX_HANDLETYPE hComponent)
     pSECPort->portDefinition.nBufferSize = DEFAULT_VIDEO_OUTPUT_BUFFER_SIZE;
     pSECPort->portDefinition.eDomain = OMX_PortDomainVideo;
 
-    pSECPort->portDefinition.format.video.cMIMEType = SEC_OSAL_Malloc(MAX_OMX_MIMETYPE_SIZE);
     SEC_OSAL_Strcpy(pSECPort->portDefinition.format.video.cMIMEType, "raw/video");
     pSECPort->portDefinition.format.video.pNativeRender = 0;
     pSECPort->portDefinition.format.video.bFlagErrorConcealment = OMX_FALSE;
@@ -1405,6 +1803,62 @@ OMX_ERRORTYPE SEC_OMX_VideoEncodeComponentInit(OMX_IN OMX_HANDLETYPE hComponent)
     pSECPort->portDefinition.format.video.xFramerate = (15 << 16);
     pSECPort->portDefinition.format.video.eColorFormat = OMX_COLOR_FormatUnused;
     pSECPort->portDefinition.format.video.pNativeWindow = NULL;
+}
+
+OMX_ERRORTYPE SEC_OMX_VideoEncodeComponentInit(OMX_IN OMX_HANDLETYPE hComponent)
+{
+    OMX_ERRORTYPE          ret = OMX_ErrorNone;
+    OMX_COMPONENTTYPE     *pOMXComponent = NULL;
+    SEC_OMX_BASECOMPONENT *pSECComponent = NULL;
+
+    FunctionIn();
+
+    if (hComponent == NULL) {
+        ret = OMX_ErrorBadParameter;
+        goto EXIT;
+    }
+    pOMXComponent = (OMX_COMPONENTTYPE *)hComponent;
+    ret = SEC_OMX_Check_SizeVersion(pOMXComponent, sizeof(OMX_COMPONENTTYPE));
+    if (ret != OMX_ErrorNone) {
+        SEC_OSAL_Log(SEC_LOG_ERROR, "OMX_Error, Line:%d", __LINE__);
+        goto EXIT;
+    }
+
+    ret = SEC_OMX_BaseComponent_Constructor(pOMXComponent);
+    if (ret != OMX_ErrorNone) {
+        SEC_OSAL_Log(SEC_LOG_ERROR, "OMX_Error, Line:%d", __LINE__);
+        goto EXIT;
+    }
+
+    ret = SEC_OMX_Port_Constructor(pOMXComponent);
+    if (ret != OMX_ErrorNone) {
+        SEC_OMX_BaseComponent_Destructor(pOMXComponent);
+        SEC_OSAL_Log(SEC_LOG_ERROR, "OMX_Error, Line:%d", __LINE__);
+        goto EXIT;
+    }
+
+    pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    pSECComponent->bSaveFlagEOS = OMX_FALSE;
+
+    pSECComponent->hEncInput = SEC_OSAL_Malloc(sizeof(SEC_OMX_ENC_INPUT));
+    if (pSECComponent->hEncInput == NULL) {
+        SEC_OMX_Port_Destructor(pOMXComponent);
+        SEC_OMX_BaseComponent_Destructor(pOMXComponent);
+        ret = OMX_ErrorInsufficientResources;
+        SEC_OSAL_Log(SEC_LOG_ERROR, "OMX_ErrorInsufficientResources, Line:%d", __LINE__);
+        goto EXIT;
+    }
+    SEC_OSAL_Memset(pSECComponent->hEncInput, 0, sizeof(SEC_OMX_ENC_INPUT));
+
+    pSECComponent->pSECPort[INPUT_PORT_INDEX].portDefinition.format.video.cMIMEType = SEC_OSAL_Malloc(MAX_OMX_MIMETYPE_SIZE);
+    pSECComponent->pSECPort[OUTPUT_PORT_INDEX].portDefinition.format.video.cMIMEType = SEC_OSAL_Malloc(MAX_OMX_MIMETYPE_SIZE);
+    SEC_OMX_VideoEncodeSetDefault(pSECComponent);
+
+    /* the codec component names the thread */
+    SEC_OSAL_Strcpy(pSECComponent->bufferProcessThreadAttr.name, "SecVideoEnc");
+    pSECComponent->bufferProcessThreadAttr.policy   = SEC_OSAL_SCHED_OTHER;
+    pSECComponent->bufferProcessThreadAttr.priority = SEC_OMX_BUFFER_PROCESS_PRIORITY;
+    pSECComponent->bufferProcessThreadAttr.cpuMask  = SEC_OMX_BUFFER_PROCESS_CPU_MASK;
 
     pOMXComponent->UseBuffer              = &SEC_OMX_UseBuffer;
     pOMXComponent->AllocateBuffer         = &SEC_OMX_AllocateBuffer;
@@ -1418,6 +1872,50 @@ OMX_ERRORTYPE SEC_OMX_VideoEncodeComponentInit(OMX_IN OMX_HANDLETYPE hComponent)
     pSECComponent->sec_InputBufferReturn    = &SEC_InputBufferReturn;
     pSECComponent->sec_OutputBufferReturn   = &SEC_OutputBufferReturn;
 
+    csc_parallel_open();
+
+EXIT:
+    FunctionOut();
+
+    return ret;
+}
+
+/* Back to the defaults of a new component for reuse, the codec component resets its own part */
+OMX_ERRORTYPE SEC_OMX_VideoEncodeComponentReset(OMX_IN OMX_HANDLETYPE hComponent)
+{
+    OMX_ERRORTYPE          ret = OMX_ErrorNone;
+    OMX_COMPONENTTYPE     *pOMXComponent = NULL;
+    SEC_OMX_BASECOMPONENT *pSECComponent = NULL;
+
+    FunctionIn();
+
+    if (hComponent == NULL) {
+        ret = OMX_ErrorBadParameter;
+        goto EXIT;
+    }
+    pOMXComponent = (OMX_COMPONENTTYPE *)hComponent;
+    ret = SEC_OMX_Check_SizeVersion(pOMXComponent, sizeof(OMX_COMPONENTTYPE));
+    if (ret != OMX_ErrorNone) {
+        goto EXIT;
+    }
+
+    if (pOMXComponent->pComponentPrivate == NULL) {
+        ret = OMX_ErrorBadParameter;
+        goto EXIT;
+    }
+    pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+
+    ret = SEC_OMX_BaseComponent_Reset(pOMXComponent);
+    if (ret != OMX_ErrorNone) {
+        goto EXIT;
+    }
+    ret = SEC_OMX_Port_Reset(pOMXComponent);
+    if (ret != OMX_ErrorNone) {
+        goto EXIT;
+    }
+
+    SEC_OMX_VideoEncodeSetDefault(pSECComponent);
+
 EXIT:
     FunctionOut();
 
@@ -1430,6 +1928,7 @@ OMX_ERRORTYPE SEC_OMX_VideoEncodeComponentDeinit(OMX_IN OMX_HANDLETYPE hComponen
     OMX_COMPONENTTYPE     *pOMXComponent = NULL;
     SEC_OMX_BASECOMPONENT *pSECComponent = NULL;
     SEC_OMX_BASEPORT      *pSECPort = NULL;
+    SEC_OMX_ENC_INPUT     *pEncInput = NULL;
     int                    i = 0;
 
     FunctionIn();
@@ -1456,6 +1955,15 @@ OMX_ERRORTYPE SEC_OMX_VideoEncodeComponentDeinit(OMX_IN OMX_HANDLETYPE hComponen
         pSECPort->portDefinition.format.video.cMIMEType = NULL;
     }
 
+    pEncInput = (SEC_OMX_ENC_INPUT *)pSECComponent->hEncInput;
+    csc_tile_map_release(&pEncInput->tileMapY);
+    csc_tile_map_release(&pEncInput->tileMapC);
+    SEC_OSAL_Free(pEncInput->pStaging);
+    SEC_OSAL_Free(pSECComponent->hEncInput);
+    pSECComponent->hEncInput = NULL;
+
+    csc_parallel_close();
+
     ret = SEC_OMX_Port_Destructor(pOMXComponent);
 
     ret = SEC_OMX_BaseComponent_Destructor(hComponent);
@@ -32,6 +32,9 @@
 #include "SEC_OMX_Def.h"
 #include "SEC_OSAL_Queue.h"
 #include "SEC_OMX_Baseport.h"
+#include "SEC_OMX_Basecomponent.h"
+#include "SsbSipMfcApi.h"
+#include "color_space_convertor.h"
 
 #define MAX_VIDEO_INPUTBUFFER_NUM    5
 #define MAX_VIDEO_OUTPUTBUFFER_NUM   4
@@ -46,10 +49,17 @@
 
 #define MFC_INPUT_BUFFER_NUM_MAX            2
 
+#define MFC_CLIENT_BUFFER_ALIGN             2048
+/* the size of one half of the encoder's own stream buffer */
+#define MFC_ENC_CLIENT_BUFFER_SIZE_MAX      (MAX_ENCODER_OUTPUT_BUFFER_SIZE / 2)
+
+/* Color conversion of frames this large runs on all cores */
+#define PARALLEL_CSC_MIN_FRAME_SIZE         (1280 * 720)
+
 #ifdef USE_ANDROID_EXTENSION
-#define INPUT_PORT_SUPPORTFORMAT_NUM_MAX    4
+#define INPUT_PORT_SUPPORTFORMAT_NUM_MAX    6
 #else
-#define INPUT_PORT_SUPPORTFORMAT_NUM_MAX    3
+#define INPUT_PORT_SUPPORTFORMAT_NUM_MAX    5
 #endif
 #define OUTPUT_PORT_SUPPORTFORMAT_NUM_MAX   1
 
@@ -86,6 +96,34 @@ typedef struct _MFC_ENC_INPUT_BUFFER
     int CDataSize;  // input size of CbCr data
 } MFC_ENC_INPUT_BUFFER;
 
+/*
+ * Raw input frames are converted by the CPU straight into the NV12T
+ * input buffer of the MFC. A frame split over several input buffers is
+ * gathered in pStaging first.
+ */
+typedef struct _SEC_OMX_ENC_INPUT
+{
+    CSC_TILE_MAP  tileMapY;
+    CSC_TILE_MAP  tileMapC;
+    OMX_U8       *pStaging;
+    OMX_U32       nStagingSize;
+} SEC_OMX_ENC_INPUT;
+
+/*
+ * Output port buffers handed out by AllocateBuffer from MFC memory. The
+ * MFC encodes a frame straight into the one it is lent.
+ */
+typedef struct _MFC_ENC_CLIENT_BUFFER
+{
+    void   *pVirBase;
+    void   *pPhyBase;
+    OMX_U32 slotSize;
+    OMX_U32 slotNum;
+
+    /* output buffer of the frame being encoded, see SEC_MFC_EncOutputLend */
+    OMX_BUFFERHEADERTYPE *pLent;
+} MFC_ENC_CLIENT_BUFFER;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -120,6 +158,28 @@ OMX_ERRORTYPE SEC_OMX_ComponentTunnelRequest(
     OMX_IN OMX_U32         nTunneledPort,
     OMX_INOUT OMX_TUNNELSETUPTYPE *pTunnelSetup);
 OMX_ERRORTYPE SEC_OMX_BufferProcess(OMX_HANDLETYPE hComponent);
+OMX_ERRORTYPE SEC_MFC_EncClientBufferGet(
+    OMX_PTR                hMFCHandle,
+    MFC_ENC_CLIENT_BUFFER *pClientBuffer,
+    OMX_U32                slotSize,
+    OMX_U32                slotNum,
+    OMX_U32                nIndex,
+    OMX_U32                nSizeBytes,
+    OMX_U8               **ppBuffer,
+    OMX_PTR               *ppPhyBuffer);
+void SEC_MFC_EncOutputLend(
+    OMX_COMPONENTTYPE     *pOMXComponent,
+    OMX_PTR                hMFCHandle,
+    MFC_ENC_CLIENT_BUFFER *pClientBuffer,
+    SEC_OMX_DATA          *pOutputData);
+void SEC_MFC_EncOutputTake(
+    OMX_COMPONENTTYPE     *pOMXComponent,
+    MFC_ENC_CLIENT_BUFFER *pClientBuffer,
+    SEC_OMX_DATA          *pOutputData);
+void SEC_MFC_EncOutputRelease(
+    OMX_COMPONENTTYPE     *pOMXComponent,
+    OMX_PTR                hMFCHandle,
+    MFC_ENC_CLIENT_BUFFER *pClientBuffer);
 OMX_ERRORTYPE SEC_OMX_VideoEncodeGetParameter(
     OMX_IN OMX_HANDLETYPE hComponent,
     OMX_IN OMX_INDEXTYPE  nParamIndex,
@@ -129,6 +189,7 @@ OMX_ERRORTYPE SEC_OMX_VideoEncodeSetParameter(
     OMX_IN OMX_INDEXTYPE  nIndex,
     OMX_IN OMX_PTR        ComponentParameterStructure);
 OMX_ERRORTYPE SEC_OMX_VideoEncodeComponentDeinit(OMX_IN OMX_HANDLETYPE hComponent);
+OMX_ERRORTYPE SEC_OMX_VideoEncodeComponentReset(OMX_IN OMX_HANDLETYPE hComponent);
 
 #ifdef __cplusplus
 }
@@ -36,6 +36,7 @@
 #include "SEC_OMX_H264enc.h"
 #include "SsbSipMfcApi.h"
 #include "color_space_convertor.h"
+#include "SEC_OSAL_Mutex.h"
 
 #undef  SEC_LOG_TAG
 #define SEC_LOG_TAG    "SEC_H264_ENC"
@@ -183,6 +184,17 @@ void H264PrintParams(SSBSIP_MFC_ENC_H264_PARAM h264Arg)
     SEC_OSAL_Log(SEC_LOG_TRACE, "ActivityDisable         : %d\n", h264Arg.ActivityDisable);
 }
 
+/* Bitrate within nMinBitrate and nMaxBitrate, zero being no limit */
+static OMX_U32 SEC_MFC_H264Enc_RateControlClamp(SEC_MFC_H264ENC_RATECONTROL *pRateControl, OMX_U32 nBitrate)
+{
+    if ((pRateControl->nMinBitrate != 0) && (nBitrate < pRateControl->nMinBitrate))
+        nBitrate = pRateControl->nMinBitrate;
+    if ((pRateControl->nMaxBitrate != 0) && (nBitrate > pRateControl->nMaxBitrate))
+        nBitrate = pRateControl->nMaxBitrate;
+
+    return nBitrate;
+}
+
 void Set_H264ENC_Param(SSBSIP_MFC_ENC_H264_PARAM *pH264Arg, SEC_OMX_BASECOMPONENT *pSECComponent)
 {
     SEC_OMX_BASEPORT          *pSECInputPort = NULL;
@@ -200,7 +212,9 @@ void Set_H264ENC_Param(SSBSIP_MFC_ENC_H264_PARAM *pH264Arg, SEC_OMX_BASECOMPONEN
     pH264Arg->SliceMode    = 0;
     pH264Arg->RandomIntraMBRefresh = 0;
     pH264Arg->EnableFRMRateControl = 1;        // 0: Disable, 1: Frame level RC
-    pH264Arg->Bitrate      = pSECOutputPort->portDefinition.format.video.nBitrate;
+    SEC_OSAL_MutexLock(pH264Enc->rateControl.hMutex);
+    pH264Arg->Bitrate      = SEC_MFC_H264Enc_RateControlClamp(&pH264Enc->rateControl, pSECOutputPort->portDefinition.format.video.nBitrate);
+    SEC_OSAL_MutexUnlock(pH264Enc->rateControl.hMutex);
     pH264Arg->FrameQp      = 20;
     pH264Arg->FrameQp_P    = 20;
     pH264Arg->QSCodeMax    = 30;
@@ -231,16 +245,16 @@ void Set_H264ENC_Param(SSBSIP_MFC_ENC_H264_PARAM *pH264Arg, SEC_OMX_BASECOMPONEN
     pH264Arg->StaticDisable   = 1;
     pH264Arg->ActivityDisable = 1;
 
-    switch ((SEC_OMX_COLOR_FORMATTYPE)pSECInputPort->portDefinition.format.video.eColorFormat) {
-    case OMX_COLOR_FormatYUV420SemiPlanar:
-        pH264Arg->FrameMap = NV12_LINEAR;
-        break;
-    case OMX_SEC_COLOR_FormatNV12TPhysicalAddress:
-    default:
-        pH264Arg->FrameMap = NV12_TILE;
-        break;
+    if (pH264Enc->lowLatency.bEnable == OMX_TRUE) {
+        /* no B frame holds a frame back, slices as asked for */
+        pH264Arg->NumberBFrames = 0;
+        pH264Arg->SliceMode     = pH264Enc->lowLatency.nSliceMode;
+        pH264Arg->SliceArgument = pH264Enc->lowLatency.nSliceSize;
     }
 
+    /* raw input of any color format is converted to NV12T by SEC_Preprocessor_InputData */
+    pH264Arg->FrameMap = NV12_TILE;
+
 #ifdef USE_ANDROID_EXTENSION
     if (pSECInputPort->bStoreMetaDataInBuffer != OMX_FALSE) {
         SEC_OMX_DATA *pInputData = &pSECComponent->processData[INPUT_PORT_INDEX];
@@ -421,6 +435,28 @@ OMX_ERRORTYPE SEC_MFC_H264Enc_GetParameter(
         pDstErrorCorrectionType->bEnableRVLC = pSrcErrorCorrectionType->bEnableRVLC;
     }
         break;
+    case OMX_IndexVendorLowLatency:
+    {
+        SEC_OMX_VIDEO_PARAM_LOWLATENCYTYPE *pDstLowLatency = (SEC_OMX_VIDEO_PARAM_LOWLATENCYTYPE *)pComponentParameterStructure;
+        SEC_H264ENC_HANDLE                 *pH264Enc = NULL;
+
+        ret = SEC_OMX_Check_SizeVersion(pDstLowLatency, sizeof(SEC_OMX_VIDEO_PARAM_LOWLATENCYTYPE));
+        if (ret != OMX_ErrorNone) {
+            goto EXIT;
+        }
+
+        if (pDstLowLatency->nPortIndex != OUTPUT_PORT_INDEX) {
+            ret = OMX_ErrorBadPortIndex;
+            goto EXIT;
+        }
+
+        pH264Enc = (SEC_H264ENC_HANDLE *)pSECComponent->hCodecHandle;
+        pDstLowLatency->bEnable      = pH264Enc->lowLatency.bEnable;
+        pDstLowLatency->nSliceMode   = pH264Enc->lowLatency.nSliceMode;
+        pDstLowLatency->nSliceSize   = pH264Enc->lowLatency.nSliceSize;
+        pDstLowLatency->bSliceOutput = pH264Enc->lowLatency.bSliceOutput;
+    }
+        break;
     default:
         ret = SEC_OMX_VideoEncodeGetParameter(hComponent, nParamIndex, pComponentParameterStructure);
         break;
@@ -556,6 +592,40 @@ OMX_ERRORTYPE SEC_MFC_H264Enc_SetParameter(
         pDstErrorCorrectionType->bEnableRVLC = pSrcErrorCorrectionType->bEnableRVLC;
     }
         break;
+    case OMX_IndexVendorLowLatency:
+    {
+        SEC_OMX_VIDEO_PARAM_LOWLATENCYTYPE *pSrcLowLatency = (SEC_OMX_VIDEO_PARAM_LOWLATENCYTYPE *)pComponentParameterStructure;
+        SEC_H264ENC_HANDLE                 *pH264Enc = NULL;
+
+        ret = SEC_OMX_Check_SizeVersion(pSrcLowLatency, sizeof(SEC_OMX_VIDEO_PARAM_LOWLATENCYTYPE));
+        if (ret != OMX_ErrorNone) {
+            goto EXIT;
+        }
+
+        if (pSrcLowLatency->nPortIndex != OUTPUT_PORT_INDEX) {
+            ret = OMX_ErrorBadPortIndex;
+            goto EXIT;
+        }
+
+        /* the encode loop is chosen when the MFC is set up */
+        if ((pSECComponent->currentState != OMX_StateLoaded) && (pSECComponent->currentState != OMX_StateWaitForResources)) {
+            ret = OMX_ErrorIncorrectStateOperation;
+            goto EXIT;
+        }
+
+        if ((pSrcLowLatency->nSliceMode > OMX_VIDEO_SLICEMODE_AVCByteSlice) ||
+            ((pSrcLowLatency->nSliceMode != OMX_VIDEO_SLICEMODE_AVCDefault) && (pSrcLowLatency->nSliceSize == 0))) {
+            ret = OMX_ErrorBadParameter;
+            goto EXIT;
+        }
+
+        pH264Enc = (SEC_H264ENC_HANDLE *)pSECComponent->hCodecHandle;
+        pH264Enc->lowLatency.bEnable      = pSrcLowLatency->bEnable;
+        pH264Enc->lowLatency.nSliceMode   = pSrcLowLatency->nSliceMode;
+        pH264Enc->lowLatency.nSliceSize   = pSrcLowLatency->nSliceSize;
+        pH264Enc->lowLatency.bSliceOutput = pSrcLowLatency->bSliceOutput;
+    }
+        break;
     default:
         ret = SEC_OMX_VideoEncodeSetParameter(hComponent, nIndex, pComponentParameterStructure);
         break;
@@ -574,6 +644,7 @@ OMX_ERRORTYPE SEC_MFC_H264Enc_GetConfig(
     OMX_ERRORTYPE           ret = OMX_ErrorNone;
     OMX_COMPONENTTYPE     *pOMXComponent = NULL;
     SEC_OMX_BASECOMPONENT *pSECComponent = NULL;
+    SEC_H264ENC_HANDLE    *pH264Enc = NULL;
 
     FunctionIn();
 
@@ -602,7 +673,80 @@ OMX_ERRORTYPE SEC_MFC_H264Enc_GetConfig(
         goto EXIT;
     }
 
+    pH264Enc = (SEC_H264ENC_HANDLE *)pSECComponent->hCodecHandle;
+
     switch (nIndex) {
+    case OMX_IndexConfigVideoBitrate:
+    {
+        OMX_VIDEO_CONFIG_BITRATETYPE *pBitrate = (OMX_VIDEO_CONFIG_BITRATETYPE *)pComponentConfigStructure;
+
+        ret = SEC_OMX_Check_SizeVersion(pBitrate, sizeof(OMX_VIDEO_CONFIG_BITRATETYPE));
+        if (ret != OMX_ErrorNone) {
+            goto EXIT;
+        }
+        if (pBitrate->nPortIndex != OUTPUT_PORT_INDEX) {
+            ret = OMX_ErrorBadPortIndex;
+            goto EXIT;
+        }
+
+        pBitrate->nEncodeBitrate = pSECComponent->pSECPort[OUTPUT_PORT_INDEX].portDefinition.format.video.nBitrate;
+    }
+        break;
+    case OMX_IndexConfigVideoFramerate:
+    {
+        OMX_CONFIG_FRAMERATETYPE *pFramerate = (OMX_CONFIG_FRAMERATETYPE *)pComponentConfigStructure;
+
+        ret = SEC_OMX_Check_SizeVersion(pFramerate, sizeof(OMX_CONFIG_FRAMERATETYPE));
+        if (ret != OMX_ErrorNone) {
+            goto EXIT;
+        }
+        if (pFramerate->nPortIndex >= ALL_PORT_NUM) {
+            ret = OMX_ErrorBadPortIndex;
+            goto EXIT;
+        }
+
+        pFramerate->xEncodeFramerate = pSECComponent->pSECPort[pFramerate->nPortIndex].portDefinition.format.video.xFramerate;
+    }
+        break;
+    case OMX_IndexConfigVideoIntraVOPRefresh:
+    {
+        OMX_CONFIG_INTRAREFRESHVOPTYPE *pIntraRefresh = (OMX_CONFIG_INTRAREFRESHVOPTYPE *)pComponentConfigStructure;
+
+        ret = SEC_OMX_Check_SizeVersion(pIntraRefresh, sizeof(OMX_CONFIG_INTRAREFRESHVOPTYPE));
+        if (ret != OMX_ErrorNone) {
+            goto EXIT;
+        }
+        if (pIntraRefresh->nPortIndex != OUTPUT_PORT_INDEX) {
+            ret = OMX_ErrorBadPortIndex;
+            goto EXIT;
+        }
+
+        pIntraRefresh->IntraRefreshVOP = (pH264Enc->rateControl.nChange & H264ENC_RC_REQUEST_IDR) ? OMX_TRUE : OMX_FALSE;
+    }
+        break;
+    case OMX_IndexVendorRateControl:
+    {
+        SEC_OMX_VIDEO_CONFIG_RATECONTROLTYPE *pRateControl = (SEC_OMX_VIDEO_CONFIG_RATECONTROLTYPE *)pComponentConfigStructure;
+
+        ret = SEC_OMX_Check_SizeVersion(pRateControl, sizeof(SEC_OMX_VIDEO_CONFIG_RATECONTROLTYPE));
+        if (ret != OMX_ErrorNone) {
+            goto EXIT;
+        }
+        if (pRateControl->nPortIndex != OUTPUT_PORT_INDEX) {
+            ret = OMX_ErrorBadPortIndex;
+            goto EXIT;
+        }
+
+        SEC_OSAL_MutexLock(pH264Enc->rateControl.hMutex);
+        pRateControl->bFrameSkip       = pH264Enc->rateControl.bFrameSkip;
+        pRateControl->bClosedLoop      = pH264Enc->rateControl.bClosedLoop;
+        pRateControl->nMinBitrate      = pH264Enc->rateControl.nMinBitrate;
+        pRateControl->nMaxBitrate      = pH264Enc->rateControl.nMaxBitrate;
+        pRateControl->nEncoderBitrate  = pH264Enc->rateControl.nEncoderBitrate;
+        pRateControl->nMeasuredBitrate = pH264Enc->rateControl.nMeasuredBitrate;
+        SEC_OSAL_MutexUnlock(pH264Enc->rateControl.hMutex);
+    }
+        break;
     default:
         ret = SEC_OMX_GetConfig(hComponent, nIndex, pComponentConfigStructure);
         break;
@@ -622,6 +766,7 @@ OMX_ERRORTYPE SEC_MFC_H264Enc_SetConfig(
     OMX_ERRORTYPE          ret = OMX_ErrorNone;
     OMX_COMPONENTTYPE     *pOMXComponent = NULL;
     SEC_OMX_BASECOMPONENT *pSECComponent = NULL;
+    SEC_H264ENC_HANDLE    *pH264Enc = NULL;
 
     FunctionIn();
 
@@ -645,7 +790,123 @@ OMX_ERRORTYPE SEC_MFC_H264Enc_SetConfig(
         goto EXIT;
     }
 
+    pH264Enc = (SEC_H264ENC_HANDLE *)pSECComponent->hCodecHandle;
+
     switch (nIndex) {
+    case OMX_IndexConfigVideoBitrate:
+    {
+        OMX_VIDEO_CONFIG_BITRATETYPE *pBitrate = (OMX_VIDEO_CONFIG_BITRATETYPE *)pComponentConfigStructure;
+
+        ret = SEC_OMX_Check_SizeVersion(pBitrate, sizeof(OMX_VIDEO_CONFIG_BITRATETYPE));
+        if (ret != OMX_ErrorNone) {
+            goto EXIT;
+        }
+        if (pBitrate->nPortIndex != OUTPUT_PORT_INDEX) {
+            ret = OMX_ErrorBadPortIndex;
+            goto EXIT;
+        }
+        if (pBitrate->nEncodeBitrate == 0) {
+            ret = OMX_ErrorBadParameter;
+            goto EXIT;
+        }
+
+        SEC_OSAL_MutexLock(pH264Enc->rateControl.hMutex);
+        pSECComponent->pSECPort[OUTPUT_PORT_INDEX].portDefinition.format.video.nBitrate = pBitrate->nEncodeBitrate;
+        pH264Enc->rateControl.nEncoderBitrate = SEC_MFC_H264Enc_RateControlClamp(&pH264Enc->rateControl, pBitrate->nEncodeBitrate);
+        pH264Enc->rateControl.nWindowFrames = 0;
+        pH264Enc->rateControl.nWindowBytes = 0;
+        pH264Enc->rateControl.nChange |= H264ENC_RC_CHANGE_BITRATE;
+        SEC_OSAL_MutexUnlock(pH264Enc->rateControl.hMutex);
+    }
+        break;
+    case OMX_IndexConfigVideoFramerate:
+    {
+        OMX_CONFIG_FRAMERATETYPE *pFramerate = (OMX_CONFIG_FRAMERATETYPE *)pComponentConfigStructure;
+
+        ret = SEC_OMX_Check_SizeVersion(pFramerate, sizeof(OMX_CONFIG_FRAMERATETYPE));
+        if (ret != OMX_ErrorNone) {
+            goto EXIT;
+        }
+        if (pFramerate->nPortIndex >= ALL_PORT_NUM) {
+            ret = OMX_ErrorBadPortIndex;
+            goto EXIT;
+        }
+        if ((pFramerate->xEncodeFramerate >> 16) == 0) {
+            ret = OMX_ErrorBadParameter;
+            goto EXIT;
+        }
+
+        /* the MFC takes the rate of the input port, see Set_H264ENC_Param */
+        SEC_OSAL_MutexLock(pH264Enc->rateControl.hMutex);
+        pSECComponent->pSECPort[INPUT_PORT_INDEX].portDefinition.format.video.xFramerate = pFramerate->xEncodeFramerate;
+        pSECComponent->pSECPort[OUTPUT_PORT_INDEX].portDefinition.format.video.xFramerate = pFramerate->xEncodeFramerate;
+        pH264Enc->rateControl.nWindowFrames = 0;
+        pH264Enc->rateControl.nWindowBytes = 0;
+        pH264Enc->rateControl.nChange |= H264ENC_RC_CHANGE_FRAMERATE;
+        SEC_OSAL_MutexUnlock(pH264Enc->rateControl.hMutex);
+    }
+        break;
+    case OMX_IndexConfigVideoIntraVOPRefresh:
+    {
+        OMX_CONFIG_INTRAREFRESHVOPTYPE *pIntraRefresh = (OMX_CONFIG_INTRAREFRESHVOPTYPE *)pComponentConfigStructure;
+
+        ret = SEC_OMX_Check_SizeVersion(pIntraRefresh, sizeof(OMX_CONFIG_INTRAREFRESHVOPTYPE));
+        if (ret != OMX_ErrorNone) {
+            goto EXIT;
+        }
+        if (pIntraRefresh->nPortIndex != OUTPUT_PORT_INDEX) {
+            ret = OMX_ErrorBadPortIndex;
+            goto EXIT;
+        }
+
+        SEC_OSAL_MutexLock(pH264Enc->rateControl.hMutex);
+        if (pIntraRefresh->IntraRefreshVOP == OMX_TRUE)
+            pH264Enc->rateControl.nChange |= H264ENC_RC_REQUEST_IDR;
+        else
+            pH264Enc->rateControl.nChange &= ~H264ENC_RC_REQUEST_IDR;
+        SEC_OSAL_MutexUnlock(pH264Enc->rateControl.hMutex);
+    }
+        break;
+    case OMX_IndexVendorRateControl:
+    {
+        SEC_OMX_VIDEO_CONFIG_RATECONTROLTYPE *pRateControl = (SEC_OMX_VIDEO_CONFIG_RATECONTROLTYPE *)pComponentConfigStructure;
+        OMX_U32 nTarget = 0;
+
+        ret = SEC_OMX_Check_SizeVersion(pRateControl, sizeof(SEC_OMX_VIDEO_CONFIG_RATECONTROLTYPE));
+        if (ret != OMX_ErrorNone) {
+            goto EXIT;
+        }
+        if (pRateControl->nPortIndex != OUTPUT_PORT_INDEX) {
+            ret = OMX_ErrorBadPortIndex;
+            goto EXIT;
+        }
+        if ((pRateControl->nMaxBitrate != 0) && (pRateControl->nMinBitrate > pRateControl->nMaxBitrate)) {
+            ret = OMX_ErrorBadParameter;
+            goto EXIT;
+        }
+
+        SEC_OSAL_MutexLock(pH264Enc->rateControl.hMutex);
+        if (pH264Enc->rateControl.bFrameSkip != pRateControl->bFrameSkip) {
+            pH264Enc->rateControl.bFrameSkip = pRateControl->bFrameSkip;
+            pH264Enc->rateControl.nChange |= H264ENC_RC_CHANGE_FRAMESKIP;
+        }
+        pH264Enc->rateControl.bClosedLoop = pRateControl->bClosedLoop;
+        pH264Enc->rateControl.nMinBitrate = pRateControl->nMinBitrate;
+        pH264Enc->rateControl.nMaxBitrate = pRateControl->nMaxBitrate;
+
+        /* open loop, or new limits: back to the port bitrate within them */
+        nTarget = pSECComponent->pSECPort[OUTPUT_PORT_INDEX].portDefinition.format.video.nBitrate;
+        if (pH264Enc->rateControl.bClosedLoop == OMX_FALSE)
+            nTarget = SEC_MFC_H264Enc_RateControlClamp(&pH264Enc->rateControl, nTarget);
+        else
+            nTarget = SEC_MFC_H264Enc_RateControlClamp(&pH264Enc->rateControl, pH264Enc->rateControl.nEncoderBitrate);
+        if (nTarget != pH264Enc->rateControl.nEncoderBitrate) {
+            pH264Enc->rateControl.nEncoderBitrate = nTarget;
+            pH264Enc->rateControl.nChange |= H264ENC_RC_CHANGE_BITRATE;
+        }
+        SEC_OSAL_MutexUnlock(pH264Enc->rateControl.hMutex);
+    }
+        break;
     default:
         ret = SEC_OMX_SetConfig(hComponent, nIndex, pComponentConfigStructure);
         break;
@@ -697,12 +958,18 @@ OMX_ERRORTYPE SEC_MFC_H264Enc_GetExtensionIndex(
     if (SEC_OSAL_Strcmp(cParameterName, SEC_INDEX_PARAM_STORE_METADATA_BUFFER) == 0) {
         *pIndexType = OMX_IndexParamStoreMetaDataBuffer;
         ret = OMX_ErrorNone;
+        goto EXIT;
+    }
+#endif
+    if (SEC_OSAL_Strcmp(cParameterName, SEC_INDEX_CONFIG_RATE_CONTROL) == 0) {
+        *pIndexType = OMX_IndexVendorRateControl;
+        ret = OMX_ErrorNone;
+    } else if (SEC_OSAL_Strcmp(cParameterName, SEC_INDEX_PARAM_LOW_LATENCY) == 0) {
+        *pIndexType = OMX_IndexVendorLowLatency;
+        ret = OMX_ErrorNone;
     } else {
         ret = SEC_OMX_GetExtensionIndex(hComponent, cParameterName, pIndexType);
     }
-#else
-    ret = SEC_OMX_GetExtensionIndex(hComponent, cParameterName, pIndexType);
-#endif
 
 EXIT:
     FunctionOut();
@@ -756,7 +1023,10 @@ OMX_ERRORTYPE SEC_MFC_EncodeThread(OMX_HANDLETYPE hComponent)
         SEC_OSAL_SemaphoreWait(pH264Enc->NBEncThread.hEncFrameStart);
 
         if (pH264Enc->NBEncThread.bExitEncodeThread == OMX_FALSE) {
+            OMX_U64 encodeStartUs = SEC_OSAL_GetSystemTimeUs();
+
             pH264Enc->hMFCH264Handle.returnCodec = SsbSipMfcEncExe(pH264Enc->hMFCH264Handle.hMFCHandle);
+            SEC_OMX_StatsAdd(&pSECComponent->stats, SEC_OMX_STATS_MFC, encodeStartUs);
             SEC_OSAL_SemaphorePost(pH264Enc->NBEncThread.hEncFrameEnd);
         }
     }
@@ -768,6 +1038,69 @@ EXIT:
     return ret;
 }
 
+/* Output port buffer nIndex in MFC memory, the MFC is opened for it */
+OMX_ERRORTYPE SEC_MFC_H264Enc_AllocateOutputBuffer(
+    OMX_COMPONENTTYPE *pOMXComponent,
+    OMX_U32            nIndex,
+    OMX_U32            nSizeBytes,
+    OMX_U8           **ppBuffer,
+    OMX_PTR           *ppPhyBuffer)
+{
+    OMX_ERRORTYPE          ret = OMX_ErrorNone;
+    SEC_OMX_BASECOMPONENT *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    SEC_H264ENC_HANDLE    *pH264Enc = (SEC_H264ENC_HANDLE *)pSECComponent->hCodecHandle;
+    SEC_OMX_BASEPORT      *pSECOutputPort = &pSECComponent->pSECPort[OUTPUT_PORT_INDEX];
+    SSBIP_MFC_BUFFER_TYPE  buf_type = CACHE;
+
+    FunctionIn();
+
+    if (pH264Enc->hMFCH264Handle.hMFCHandle == NULL) {
+        pH264Enc->hMFCH264Handle.hMFCHandle = (OMX_PTR)SsbSipMfcEncOpen(&buf_type);
+        if (pH264Enc->hMFCH264Handle.hMFCHandle == NULL) {
+            ret = OMX_ErrorInsufficientResources;
+            goto EXIT;
+        }
+        SEC_OSAL_Memset(&pH264Enc->MFCEncClientBuffer, 0, sizeof(MFC_ENC_CLIENT_BUFFER));
+    }
+
+    ret = SEC_MFC_EncClientBufferGet(pH264Enc->hMFCH264Handle.hMFCHandle, &pH264Enc->MFCEncClientBuffer,
+                                     pSECOutputPort->portDefinition.nBufferSize,
+                                     pSECOutputPort->portDefinition.nBufferCountActual,
+                                     nIndex, nSizeBytes, ppBuffer, ppPhyBuffer);
+
+EXIT:
+    FunctionOut();
+
+    return ret;
+}
+
+/* Gives back output port buffers lent to the MFC */
+OMX_ERRORTYPE SEC_MFC_H264Enc_ReleaseOutputBuffer(OMX_COMPONENTTYPE *pOMXComponent)
+{
+    OMX_ERRORTYPE          ret = OMX_ErrorNone;
+    SEC_OMX_BASECOMPONENT *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    SEC_H264ENC_HANDLE    *pH264Enc = (SEC_H264ENC_HANDLE *)pSECComponent->hCodecHandle;
+
+    FunctionIn();
+
+    if (pH264Enc->hMFCH264Handle.hMFCHandle == NULL)
+        goto EXIT;
+
+    /* wait for mfc encode done, it may write a lent buffer. The frame is dropped */
+    if ((pH264Enc->MFCEncClientBuffer.pLent != NULL) && (pH264Enc->NBEncThread.bEncoderRun == OMX_TRUE)) {
+        SEC_OSAL_SemaphoreWait(pH264Enc->NBEncThread.hEncFrameEnd);
+        pH264Enc->NBEncThread.bEncoderRun = OMX_FALSE;
+        pH264Enc->bFirstFrame = OMX_TRUE;
+    }
+
+    SEC_MFC_EncOutputRelease(pOMXComponent, pH264Enc->hMFCH264Handle.hMFCHandle, &pH264Enc->MFCEncClientBuffer);
+
+EXIT:
+    FunctionOut();
+
+    return ret;
+}
+
 /* MFC Init */
 OMX_ERRORTYPE SEC_MFC_H264Enc_Init(OMX_COMPONENTTYPE *pOMXComponent)
 {
@@ -786,14 +1119,19 @@ OMX_ERRORTYPE SEC_MFC_H264Enc_Init(OMX_COMPONENTTYPE *pOMXComponent)
     pSECComponent->bUseFlagEOF = OMX_FALSE;
     pSECComponent->bSaveFlagEOS = OMX_FALSE;
 
-    /* MFC(Multi Function Codec) encoder and CMM(Codec Memory Management) driver open */
-    SSBIP_MFC_BUFFER_TYPE buf_type = CACHE;
-    hMFCHandle = (OMX_PTR)SsbSipMfcEncOpen(&buf_type);
-    if (hMFCHandle == NULL) {
-        ret = OMX_ErrorInsufficientResources;
-        goto EXIT;
+    /* MFC(Multi Function Codec) encoder and CMM(Codec Memory Management) driver open,
+       unless it was for the output port buffers */
+    if (pH264Enc->hMFCH264Handle.hMFCHandle == NULL) {
+        SSBIP_MFC_BUFFER_TYPE buf_type = CACHE;
+        hMFCHandle = (OMX_PTR)SsbSipMfcEncOpen(&buf_type);
+        if (hMFCHandle == NULL) {
+            ret = OMX_ErrorInsufficientResources;
+            goto EXIT;
+        }
+        pH264Enc->hMFCH264Handle.hMFCHandle = hMFCHandle;
+        SEC_OSAL_Memset(&pH264Enc->MFCEncClientBuffer, 0, sizeof(MFC_ENC_CLIENT_BUFFER));
     }
-    pH264Enc->hMFCH264Handle.hMFCHandle = hMFCHandle;
+    hMFCHandle = pH264Enc->hMFCH264Handle.hMFCHandle;
 
     SsbSipMfcEncSetSize(hMFCHandle, H264_ENC,
                         pSECOutputPort->portDefinition.format.video.nFrameWidth,
@@ -852,9 +1190,10 @@ OMX_ERRORTYPE SEC_MFC_H264Enc_Init(OMX_COMPONENTTYPE *pOMXComponent)
         pH264Enc->hMFCH264Handle.returnCodec = MFC_RET_OK;
     }
 
-    SEC_OSAL_Memset(pSECComponent->timeStamp, -19771003, sizeof(OMX_TICKS) * MAX_TIMESTAMP);
-    SEC_OSAL_Memset(pSECComponent->nFlags, 0, sizeof(OMX_U32) * MAX_FLAGS);
-    pH264Enc->hMFCH264Handle.indexTimestamp = 0;
+    /* frames in the encoder, at most the B frames and the one being encoded */
+    ret = SEC_OMX_FrameTagCreate(&pSECComponent->frameTagMap, FRAME_TAG_MAP_MIN_SIZE);
+    if (ret != OMX_ErrorNone)
+        goto EXIT;
 
 EXIT:
     FunctionOut();
@@ -874,6 +1213,8 @@ OMX_ERRORTYPE SEC_MFC_H264Enc_Terminate(OMX_COMPONENTTYPE *pOMXComponent)
 
     pH264Enc = (SEC_H264ENC_HANDLE *)pSECComponent->hCodecHandle;
 
+    SEC_MFC_H264Enc_ReleaseOutputBuffer(pOMXComponent);
+
     if (pH264Enc->NBEncThread.hNBEncodeThread != NULL) {
         pH264Enc->NBEncThread.bExitEncodeThread = OMX_TRUE;
         SEC_OSAL_SemaphorePost(pH264Enc->NBEncThread.hEncFrameStart);
@@ -895,87 +1236,118 @@ OMX_ERRORTYPE SEC_MFC_H264Enc_Terminate(OMX_COMPONENTTYPE *pOMXComponent)
     if (hMFCHandle != NULL) {
         SsbSipMfcEncClose(hMFCHandle);
         hMFCHandle = pH264Enc->hMFCH264Handle.hMFCHandle = NULL;
+        SEC_OSAL_Memset(&pH264Enc->MFCEncClientBuffer, 0, sizeof(MFC_ENC_CLIENT_BUFFER));
     }
 
+    SEC_OMX_FrameTagTerminate(&pSECComponent->frameTagMap);
+
 EXIT:
     FunctionOut();
 
     return ret;
 }
 
-OMX_ERRORTYPE SEC_MFC_H264_Encode(OMX_COMPONENTTYPE *pOMXComponent, SEC_OMX_DATA *pInputData, SEC_OMX_DATA *pOutputData)
+/* Pending runtime changes to the MFC, called only while it is idle */
+static void SEC_MFC_H264Enc_RateControlApply(SEC_OMX_BASECOMPONENT *pSECComponent)
 {
-    OMX_ERRORTYPE              ret = OMX_ErrorNone;
-    SEC_OMX_BASECOMPONENT     *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
-    SEC_H264ENC_HANDLE        *pH264Enc = (SEC_H264ENC_HANDLE *)pSECComponent->hCodecHandle;
-    SSBSIP_MFC_ENC_INPUT_INFO *pInputInfo = &pH264Enc->hMFCH264Handle.inputInfo;
-    SSBSIP_MFC_ENC_OUTPUT_INFO outputInfo;
-    SEC_OMX_BASEPORT          *pSECPort = NULL;
-    MFC_ENC_ADDR_INFO          addrInfo;
-    OMX_U32                    oneFrameSize = pInputData->dataLen;
-
-    FunctionIn();
+    SEC_H264ENC_HANDLE          *pH264Enc = (SEC_H264ENC_HANDLE *)pSECComponent->hCodecHandle;
+    SEC_MFC_H264ENC_RATECONTROL *pRateControl = &pH264Enc->rateControl;
+    OMX_HANDLETYPE               hMFCHandle = pH264Enc->hMFCH264Handle.hMFCHandle;
+    unsigned int                 value = 0;
 
-    if (pH264Enc->hMFCH264Handle.bConfiguredMFC == OMX_FALSE) {
-        Set_H264ENC_Param(&(pH264Enc->hMFCH264Handle.mfcVideoAvc), pSECComponent);
-        pH264Enc->hMFCH264Handle.returnCodec = SsbSipMfcEncInit(pH264Enc->hMFCH264Handle.hMFCHandle, &(pH264Enc->hMFCH264Handle.mfcVideoAvc));
-        if (pH264Enc->hMFCH264Handle.returnCodec != MFC_RET_OK) {
-            ret = OMX_ErrorInsufficientResources;
-            goto EXIT;
-        }
+    SEC_OSAL_MutexLock(pRateControl->hMutex);
 
-        pH264Enc->hMFCH264Handle.returnCodec = SsbSipMfcEncGetOutBuf(pH264Enc->hMFCH264Handle.hMFCHandle, &outputInfo);
-        if (pH264Enc->hMFCH264Handle.returnCodec != MFC_RET_OK)
-        {
-            SEC_OSAL_Log(SEC_LOG_TRACE, "%s - SsbSipMfcEncGetOutBuf Failed\n", __func__);
-            ret = OMX_ErrorUndefined;
-            goto EXIT;
-        } else {
-            char *p = NULL;
-            int iSpsSize = 0;
-            int iPpsSize = 0;
+    if (pRateControl->nChange & H264ENC_RC_CHANGE_FRAMERATE) {
+        value = pSECComponent->pSECPort[INPUT_PORT_INDEX].portDefinition.format.video.xFramerate >> 16;
+        if (SsbSipMfcEncSetConfig(hMFCHandle, MFC_ENC_SETCONF_CHANGE_FRAME_RATE, &value) != MFC_RET_OK)
+            SEC_OSAL_Log(SEC_LOG_ERROR, "%s: frame rate %d failed", __FUNCTION__, value);
+    }
+    if (pRateControl->nChange & H264ENC_RC_CHANGE_BITRATE) {
+        value = pRateControl->nEncoderBitrate;
+        if (SsbSipMfcEncSetConfig(hMFCHandle, MFC_ENC_SETCONF_CHANGE_BIT_RATE, &value) != MFC_RET_OK)
+            SEC_OSAL_Log(SEC_LOG_ERROR, "%s: bitrate %d failed", __FUNCTION__, value);
+    }
+    if (pRateControl->nChange & H264ENC_RC_CHANGE_FRAMESKIP) {
+        value = (pRateControl->bFrameSkip == OMX_TRUE) ? 1 : 0;
+        if (SsbSipMfcEncSetConfig(hMFCHandle, MFC_ENC_SETCONF_ALLOW_FRAME_SKIP, &value) != MFC_RET_OK)
+            SEC_OSAL_Log(SEC_LOG_ERROR, "%s: frame skip %d failed", __FUNCTION__, value);
+    }
+    if (pRateControl->nChange & H264ENC_RC_REQUEST_IDR) {
+        value = I_FRAME;
+        if (SsbSipMfcEncSetConfig(hMFCHandle, MFC_ENC_SETCONF_FRAME_TYPE, &value) != MFC_RET_OK)
+            SEC_OSAL_Log(SEC_LOG_ERROR, "%s: IDR request failed", __FUNCTION__);
+    }
+    pRateControl->nChange = 0;
 
-            p = FindDelimiter((OMX_U8 *)outputInfo.StrmVirAddr + 4, outputInfo.headerSize - 4);
+    SEC_OSAL_MutexUnlock(pRateControl->hMutex);
+}
 
-            iSpsSize = (unsigned int)p - (unsigned int)outputInfo.StrmVirAddr;
-            pH264Enc->hMFCH264Handle.headerData.pHeaderSPS = (OMX_PTR)outputInfo.StrmVirAddr;
-            pH264Enc->hMFCH264Handle.headerData.SPSLen = iSpsSize;
+/*
+ * Closed loop: the output of about one second of frames is measured, and
+ * the MFC bitrate moved half way to what would have hit the port bitrate.
+ * It stays within half and twice the port bitrate and the limits, and
+ * changes below 5% are not worth an MFC reconfiguration.
+ */
+static void SEC_MFC_H264Enc_RateControlUpdate(SEC_OMX_BASECOMPONENT *pSECComponent, OMX_U32 nFrameBytes)
+{
+    SEC_H264ENC_HANDLE          *pH264Enc = (SEC_H264ENC_HANDLE *)pSECComponent->hCodecHandle;
+    SEC_MFC_H264ENC_RATECONTROL *pRateControl = &pH264Enc->rateControl;
+    OMX_U32 nFrameRate = 0;
+    OMX_U32 nTarget = 0;
+    OMX_U32 nBitrate = 0;
+    OMX_U32 nDiff = 0;
+
+    SEC_OSAL_MutexLock(pRateControl->hMutex);
+
+    nFrameRate = pSECComponent->pSECPort[INPUT_PORT_INDEX].portDefinition.format.video.xFramerate >> 16;
+    if (nFrameRate == 0)
+        nFrameRate = 30;
+
+    pRateControl->nWindowFrames++;
+    pRateControl->nWindowBytes += nFrameBytes;
+    if (pRateControl->nWindowFrames < nFrameRate)
+        goto EXIT;
 
-            iPpsSize = outputInfo.headerSize - iSpsSize;
-            pH264Enc->hMFCH264Handle.headerData.pHeaderPPS = outputInfo.StrmVirAddr + iSpsSize;
-            pH264Enc->hMFCH264Handle.headerData.PPSLen = iPpsSize;
-        }
+    pRateControl->nMeasuredBitrate = (OMX_U32)(((OMX_U64)pRateControl->nWindowBytes * 8 * nFrameRate) / pRateControl->nWindowFrames);
+    pRateControl->nWindowFrames = 0;
+    pRateControl->nWindowBytes = 0;
 
-        /* SEC_OSAL_Memcpy((void*)(pOutputData->dataBuffer), (const void*)(outputInfo.StrmVirAddr), outputInfo.headerSize); */
-        pOutputData->dataBuffer = outputInfo.StrmVirAddr;
-        pOutputData->allocSize = outputInfo.headerSize;
-        pOutputData->dataLen = outputInfo.headerSize;
-        pOutputData->timeStamp = 0;
-        pOutputData->nFlags |= OMX_BUFFERFLAG_CODECCONFIG;
-        pOutputData->nFlags |= OMX_BUFFERFLAG_ENDOFFRAME;
+    if ((pRateControl->bClosedLoop == OMX_FALSE) || (pRateControl->nMeasuredBitrate == 0))
+        goto EXIT;
 
-        pH264Enc->hMFCH264Handle.bConfiguredMFC = OMX_TRUE;
+    nTarget = pSECComponent->pSECPort[OUTPUT_PORT_INDEX].portDefinition.format.video.nBitrate;
+    nBitrate = (OMX_U32)(((OMX_U64)pRateControl->nEncoderBitrate * (nTarget + pRateControl->nMeasuredBitrate)) /
+                         (2 * (OMX_U64)pRateControl->nMeasuredBitrate));
+    if (nBitrate < nTarget / 2)
+        nBitrate = nTarget / 2;
+    if (nBitrate > nTarget * 2)
+        nBitrate = nTarget * 2;
+    nBitrate = SEC_MFC_H264Enc_RateControlClamp(pRateControl, nBitrate);
 
-        ret = OMX_ErrorInputDataEncodeYet;
-        goto EXIT;
+    nDiff = (nBitrate > pRateControl->nEncoderBitrate) ?
+            (nBitrate - pRateControl->nEncoderBitrate) : (pRateControl->nEncoderBitrate - nBitrate);
+    if (nDiff > pRateControl->nEncoderBitrate / 20) {
+        SEC_OSAL_Log(SEC_LOG_TRACE, "rate control: measured %d, target %d, MFC %d -> %d",
+                     pRateControl->nMeasuredBitrate, nTarget, pRateControl->nEncoderBitrate, nBitrate);
+        pRateControl->nEncoderBitrate = nBitrate;
+        pRateControl->nChange |= H264ENC_RC_CHANGE_BITRATE;
     }
 
-    if ((pInputData->nFlags & OMX_BUFFERFLAG_ENDOFFRAME) &&
-        (pSECComponent->bUseFlagEOF == OMX_FALSE)) {
-        pSECComponent->bUseFlagEOF = OMX_TRUE;
-    }
-
-    if (oneFrameSize <= 0) {
-        pOutputData->timeStamp = pInputData->timeStamp;
-        pOutputData->nFlags = pInputData->nFlags;
+EXIT:
+    SEC_OSAL_MutexUnlock(pRateControl->hMutex);
+}
 
-        ret = OMX_ErrorNone;
-        goto EXIT;
-    }
+/* MFC input addresses of the frame in pInputData, bDummy for the last input buffer again */
+static OMX_ERRORTYPE SEC_MFC_H264Enc_InputSet(OMX_COMPONENTTYPE *pOMXComponent, SEC_OMX_DATA *pInputData, OMX_BOOL bDummy)
+{
+    OMX_ERRORTYPE              ret = OMX_ErrorNone;
+    SEC_OMX_BASECOMPONENT     *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    SEC_H264ENC_HANDLE        *pH264Enc = (SEC_H264ENC_HANDLE *)pSECComponent->hCodecHandle;
+    SSBSIP_MFC_ENC_INPUT_INFO *pInputInfo = &pH264Enc->hMFCH264Handle.inputInfo;
+    SEC_OMX_BASEPORT          *pSECPort = &pSECComponent->pSECPort[INPUT_PORT_INDEX];
+    MFC_ENC_ADDR_INFO          addrInfo;
 
-    pSECPort = &pSECComponent->pSECPort[INPUT_PORT_INDEX];
-    if (((pInputData->nFlags & OMX_BUFFERFLAG_EOS) == OMX_BUFFERFLAG_EOS) ||
-        (pSECComponent->getAllDelayBuffer == OMX_TRUE)){
+    if (bDummy == OMX_TRUE) {
         /* Dummy input data for get out encoded last frame */
         pInputInfo->YPhyAddr = pH264Enc->MFCEncInputBuffer[pH264Enc->indexInputBuffer].YPhyAddr;
         pInputInfo->CPhyAddr = pH264Enc->MFCEncInputBuffer[pH264Enc->indexInputBuffer].CPhyAddr;
@@ -989,8 +1361,6 @@ OMX_ERRORTYPE SEC_MFC_H264_Encode(OMX_COMPONENTTYPE *pOMXComponent, SEC_OMX_DATA
 #ifdef USE_ANDROID_EXTENSION
     } else if (pSECPort->bStoreMetaDataInBuffer != OMX_FALSE) {
         ret = preprocessMetaDataInBuffers(pOMXComponent, pInputData->dataBuffer, pInputInfo);
-        if (ret != OMX_ErrorNone)
-            goto EXIT;
 #endif
     } else {
         /* Real input data */
@@ -998,48 +1368,305 @@ OMX_ERRORTYPE SEC_MFC_H264_Encode(OMX_COMPONENTTYPE *pOMXComponent, SEC_OMX_DATA
         pInputInfo->CPhyAddr = pSECComponent->processData[INPUT_PORT_INDEX].specificBufferHeader.CPhyAddr;
     }
 
-    pSECComponent->timeStamp[pH264Enc->hMFCH264Handle.indexTimestamp] = pInputData->timeStamp;
-    pSECComponent->nFlags[pH264Enc->hMFCH264Handle.indexTimestamp] = pInputData->nFlags;
+    return ret;
+}
 
-    if ((pH264Enc->hMFCH264Handle.returnCodec == MFC_RET_OK) &&
-        (pH264Enc->bFirstFrame == OMX_FALSE)) {
-        OMX_S32 indexTimestamp = 0;
+/* Hands the frame of pInputMeta to the encode thread */
+static OMX_ERRORTYPE SEC_MFC_H264Enc_FrameStart(OMX_COMPONENTTYPE *pOMXComponent, SEC_OMX_FRAME_META *pInputMeta, OMX_U32 oneFrameSize, SEC_OMX_DATA *pOutputData)
+{
+    OMX_ERRORTYPE              ret = OMX_ErrorNone;
+    SEC_OMX_BASECOMPONENT     *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    SEC_H264ENC_HANDLE        *pH264Enc = (SEC_H264ENC_HANDLE *)pSECComponent->hCodecHandle;
+    int                        frameTag = -1;
 
-        /* wait for mfc encode done */
-        if (pH264Enc->NBEncThread.bEncoderRun != OMX_FALSE) {
-            SEC_OSAL_SemaphoreWait(pH264Enc->NBEncThread.hEncFrameEnd);
-            pH264Enc->NBEncThread.bEncoderRun = OMX_FALSE;
+    pH264Enc->hMFCH264Handle.returnCodec = SsbSipMfcEncSetInBuf(pH264Enc->hMFCH264Handle.hMFCHandle, &pH264Enc->hMFCH264Handle.inputInfo);
+    if (pH264Enc->hMFCH264Handle.returnCodec != MFC_RET_OK) {
+        SEC_OSAL_Log(SEC_LOG_TRACE, "Error : SsbSipMfcEncSetInBuf() \n");
+        ret = OMX_ErrorUndefined;
+        goto EXIT;
+    } else {
+        pH264Enc->indexInputBuffer++;
+        pH264Enc->indexInputBuffer %= MFC_INPUT_BUFFER_NUM_MAX;
+        pSECComponent->processData[INPUT_PORT_INDEX].specificBufferHeader.YPhyAddr = pH264Enc->MFCEncInputBuffer[pH264Enc->indexInputBuffer].YPhyAddr;
+        pSECComponent->processData[INPUT_PORT_INDEX].specificBufferHeader.CPhyAddr = pH264Enc->MFCEncInputBuffer[pH264Enc->indexInputBuffer].CPhyAddr;
+        pSECComponent->processData[INPUT_PORT_INDEX].specificBufferHeader.YVirAddr = pH264Enc->MFCEncInputBuffer[pH264Enc->indexInputBuffer].YVirAddr;
+        pSECComponent->processData[INPUT_PORT_INDEX].specificBufferHeader.CVirAddr = pH264Enc->MFCEncInputBuffer[pH264Enc->indexInputBuffer].CVirAddr;
+        pSECComponent->processData[INPUT_PORT_INDEX].specificBufferHeader.YSize = pH264Enc->MFCEncInputBuffer[pH264Enc->indexInputBuffer].YBufferSize;
+        pSECComponent->processData[INPUT_PORT_INDEX].specificBufferHeader.CSize = pH264Enc->MFCEncInputBuffer[pH264Enc->indexInputBuffer].CBufferSize;
+    }
+
+    pInputMeta->nStreamSize   = oneFrameSize;
+    pInputMeta->nSubmitTimeUs = SEC_OSAL_GetSystemTimeUs();
+    frameTag = SEC_OMX_FrameTagPut(&pSECComponent->frameTagMap, pInputMeta);
+    SEC_OMX_StatsFrameIn(&pSECComponent->stats, oneFrameSize);
+    SsbSipMfcEncSetConfig(pH264Enc->hMFCH264Handle.hMFCHandle, MFC_ENC_SETCONF_FRAME_TAG, &frameTag);
+    if (pH264Enc->rateControl.nChange != 0)
+        SEC_MFC_H264Enc_RateControlApply(pSECComponent);
+
+    /* slices go out in output buffers of their own, copied from the MFC stream buffer */
+    if ((pH264Enc->lowLatency.bEnable == OMX_TRUE) && (pH264Enc->lowLatency.bSliceOutput == OMX_TRUE))
+        SsbSipMfcEncSetOutBuf(pH264Enc->hMFCH264Handle.hMFCHandle, NULL, NULL, 0);
+    else
+        SEC_MFC_EncOutputLend(pOMXComponent, pH264Enc->hMFCH264Handle.hMFCHandle, &pH264Enc->MFCEncClientBuffer, pOutputData);
+
+    /* mfc encode start */
+    SEC_OSAL_SemaphorePost(pH264Enc->NBEncThread.hEncFrameStart);
+    pH264Enc->NBEncThread.bEncoderRun = OMX_TRUE;
+    pH264Enc->bFirstFrame = OMX_FALSE;
+
+EXIT:
+    return ret;
+}
+
+/* Waits for the encode thread and fills pOutputData with the frame it encoded */
+static OMX_ERRORTYPE SEC_MFC_H264Enc_FrameOut(OMX_COMPONENTTYPE *pOMXComponent, SEC_OMX_DATA *pInputData, SEC_OMX_DATA *pOutputData)
+{
+    OMX_ERRORTYPE              ret = OMX_ErrorNone;
+    SEC_OMX_BASECOMPONENT     *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    SEC_H264ENC_HANDLE        *pH264Enc = (SEC_H264ENC_HANDLE *)pSECComponent->hCodecHandle;
+    SSBSIP_MFC_ENC_OUTPUT_INFO outputInfo;
+    SEC_OMX_FRAME_META         outputMeta;
+    int                        frameTag = -1;
+
+    /* wait for mfc encode done */
+    if (pH264Enc->NBEncThread.bEncoderRun != OMX_FALSE) {
+        SEC_OSAL_SemaphoreWait(pH264Enc->NBEncThread.hEncFrameEnd);
+        pH264Enc->NBEncThread.bEncoderRun = OMX_FALSE;
+    }
+
+    pH264Enc->hMFCH264Handle.returnCodec = SsbSipMfcEncGetOutBuf(pH264Enc->hMFCH264Handle.hMFCHandle, &outputInfo);
+    if ((SsbSipMfcEncGetConfig(pH264Enc->hMFCH264Handle.hMFCHandle, MFC_ENC_GETCONF_FRAME_TAG, &frameTag) != MFC_RET_OK) ||
+        (SEC_OMX_FrameTagTake(&pSECComponent->frameTagMap, frameTag, &outputMeta) != OMX_TRUE)){
+        pOutputData->timeStamp = pInputData->timeStamp;
+        pOutputData->nFlags = pInputData->nFlags;
+        pOutputData->nEmptyTimeUs = pInputData->nEmptyTimeUs;
+    } else {
+        pOutputData->timeStamp = outputMeta.timeStamp;
+        pOutputData->nFlags = outputMeta.nFlags;
+        pOutputData->nEmptyTimeUs = outputMeta.nEmptyTimeUs;
+        SEC_OMX_StatsAdd(&pSECComponent->stats, SEC_OMX_STATS_REORDER, outputMeta.nSubmitTimeUs);
+    }
+
+    if (pH264Enc->hMFCH264Handle.returnCodec == MFC_RET_OK) {
+        /** Fill Output Buffer **/
+        pOutputData->dataBuffer = outputInfo.StrmVirAddr;
+        pOutputData->allocSize = outputInfo.dataSize;
+        pOutputData->dataLen = outputInfo.dataSize;
+        pOutputData->usedDataLen = 0;
+        SEC_MFC_EncOutputTake(pOMXComponent, &pH264Enc->MFCEncClientBuffer, pOutputData);
+
+        pOutputData->nFlags |= OMX_BUFFERFLAG_ENDOFFRAME;
+        if (outputInfo.frameType == MFC_FRAME_TYPE_I_FRAME)
+                pOutputData->nFlags |= OMX_BUFFERFLAG_SYNCFRAME;
+
+        SEC_MFC_H264Enc_RateControlUpdate(pSECComponent, outputInfo.dataSize);
+
+        SEC_OSAL_Log(SEC_LOG_TRACE, "MFC Encode OK!!!!!!!!!!!!!!!!!!!!!!!!!!!!!\n");
+
+        ret = OMX_ErrorNone;
+    } else {
+        SEC_OSAL_Log(SEC_LOG_ERROR, "%s: SsbSipMfcEncGetOutBuf failed, ret:%d", __FUNCTION__, pH264Enc->hMFCH264Handle.returnCodec);
+        ret = OMX_ErrorUndefined;
+    }
+
+    return ret;
+}
+
+/*
+ * Next slice of the frame kept in lowLatency, a NAL unit behind each start code.
+ * The input stays until the last one is out, only that one ends the frame.
+ */
+static OMX_ERRORTYPE SEC_MFC_H264Enc_SliceOut(SEC_H264ENC_HANDLE *pH264Enc, SEC_OMX_DATA *pOutputData)
+{
+    SEC_MFC_H264ENC_LOWLATENCY *pLowLatency = &pH264Enc->lowLatency;
+    OMX_U8                     *pSlice = pLowLatency->pFrame + pLowLatency->nSliceOffset;
+    OMX_U8                     *pNext = NULL;
+    OMX_U32                     sliceSize = pLowLatency->nFrameSize - pLowLatency->nSliceOffset;
+
+    if (sliceSize > 8) {
+        pNext = FindDelimiter(pSlice + 4, sliceSize - 4);
+        if (pNext != NULL)
+            sliceSize = pNext - pSlice;
+    }
+    pLowLatency->nSliceOffset += sliceSize;
+
+    pOutputData->dataBuffer = pSlice;
+    pOutputData->allocSize = sliceSize;
+    pOutputData->dataLen = sliceSize;
+    pOutputData->usedDataLen = 0;
+    pOutputData->timeStamp = pLowLatency->frameMeta.timeStamp;
+    pOutputData->nFlags = pLowLatency->frameMeta.nFlags;
+    pOutputData->nEmptyTimeUs = pLowLatency->frameMeta.nEmptyTimeUs;
+
+    if (pLowLatency->nSliceOffset < pLowLatency->nFrameSize) {
+        pOutputData->nFlags &= ~(OMX_BUFFERFLAG_ENDOFFRAME | OMX_BUFFERFLAG_EOS);
+        return OMX_ErrorInputDataEncodeYet;
+    }
+
+    pLowLatency->pFrame = NULL;
+    pLowLatency->nFrameSize = 0;
+    pLowLatency->nSliceOffset = 0;
+
+    return OMX_ErrorNone;
+}
+
+/*
+ * Low latency: the frame is encoded within the call that brings it in,
+ * nothing is left in the MFC for the next input to push out.
+ */
+static OMX_ERRORTYPE SEC_MFC_H264Enc_EncodeLowLatency(OMX_COMPONENTTYPE *pOMXComponent, SEC_OMX_DATA *pInputData, SEC_OMX_DATA *pOutputData)
+{
+    OMX_ERRORTYPE               ret = OMX_ErrorNone;
+    SEC_OMX_BASECOMPONENT      *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    SEC_H264ENC_HANDLE         *pH264Enc = (SEC_H264ENC_HANDLE *)pSECComponent->hCodecHandle;
+    SEC_MFC_H264ENC_LOWLATENCY *pLowLatency = &pH264Enc->lowLatency;
+    SEC_OMX_FRAME_META          inputMeta;
+
+    if (pLowLatency->nFrameSize != 0) {
+        if (pSECComponent->reInputData == OMX_TRUE) {
+            ret = SEC_MFC_H264Enc_SliceOut(pH264Enc, pOutputData);
+            goto EXIT;
+        }
+        /* the input was flushed with slices of its frame left */
+        pLowLatency->pFrame = NULL;
+        pLowLatency->nFrameSize = 0;
+        pLowLatency->nSliceOffset = 0;
+    }
+
+    ret = SEC_MFC_H264Enc_InputSet(pOMXComponent, pInputData, OMX_FALSE);
+    if (ret != OMX_ErrorNone)
+        goto EXIT;
+
+    inputMeta.timeStamp = pInputData->timeStamp;
+    inputMeta.nFlags    = pInputData->nFlags;
+    inputMeta.nEmptyTimeUs = pInputData->nEmptyTimeUs;
+
+    ret = SEC_MFC_H264Enc_FrameStart(pOMXComponent, &inputMeta, pInputData->dataLen, pOutputData);
+    if (ret != OMX_ErrorNone)
+        goto EXIT;
+
+    SEC_OSAL_SemaphoreWait(pH264Enc->NBEncThread.hEncFrameEnd);
+    pH264Enc->NBEncThread.bEncoderRun = OMX_FALSE;
+    if (pH264Enc->hMFCH264Handle.returnCodec != MFC_RET_OK) {
+        SEC_OSAL_Log(SEC_LOG_ERROR, "In %s : SsbSipMfcEncExe Failed!!!\n", __func__);
+        ret = OMX_ErrorUndefined;
+        goto EXIT;
+    }
+
+    ret = SEC_MFC_H264Enc_FrameOut(pOMXComponent, pInputData, pOutputData);
+    if (ret != OMX_ErrorNone)
+        goto EXIT;
+
+    if ((pLowLatency->bSliceOutput == OMX_TRUE) && (pOutputData->dataLen > 0)) {
+        pLowLatency->pFrame = pOutputData->dataBuffer;
+        pLowLatency->nFrameSize = pOutputData->dataLen;
+        pLowLatency->nSliceOffset = 0;
+        pLowLatency->frameMeta.timeStamp = pOutputData->timeStamp;
+        pLowLatency->frameMeta.nFlags = pOutputData->nFlags;
+        pLowLatency->frameMeta.nEmptyTimeUs = pOutputData->nEmptyTimeUs;
+        ret = SEC_MFC_H264Enc_SliceOut(pH264Enc, pOutputData);
+    }
+
+EXIT:
+    return ret;
+}
+
+OMX_ERRORTYPE SEC_MFC_H264_Encode(OMX_COMPONENTTYPE *pOMXComponent, SEC_OMX_DATA *pInputData, SEC_OMX_DATA *pOutputData)
+{
+    OMX_ERRORTYPE              ret = OMX_ErrorNone;
+    SEC_OMX_BASECOMPONENT     *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    SEC_H264ENC_HANDLE        *pH264Enc = (SEC_H264ENC_HANDLE *)pSECComponent->hCodecHandle;
+    SSBSIP_MFC_ENC_OUTPUT_INFO outputInfo;
+    OMX_U32                    oneFrameSize = pInputData->dataLen;
+    SEC_OMX_FRAME_META         inputMeta;
+
+    FunctionIn();
+
+    if (pH264Enc->hMFCH264Handle.bConfiguredMFC == OMX_FALSE) {
+        Set_H264ENC_Param(&(pH264Enc->hMFCH264Handle.mfcVideoAvc), pSECComponent);
+        pH264Enc->hMFCH264Handle.returnCodec = SsbSipMfcEncInit(pH264Enc->hMFCH264Handle.hMFCHandle, &(pH264Enc->hMFCH264Handle.mfcVideoAvc));
+        if (pH264Enc->hMFCH264Handle.returnCodec != MFC_RET_OK) {
+            ret = OMX_ErrorInsufficientResources;
+            goto EXIT;
         }
 
+        /* the MFC starts with the clamped port bitrate and the framerate, only the rest is left to apply */
+        SEC_OSAL_MutexLock(pH264Enc->rateControl.hMutex);
+        pH264Enc->rateControl.nEncoderBitrate = pH264Enc->hMFCH264Handle.mfcVideoAvc.Bitrate;
+        pH264Enc->rateControl.nChange &= ~(H264ENC_RC_CHANGE_BITRATE | H264ENC_RC_CHANGE_FRAMERATE | H264ENC_RC_REQUEST_IDR);
+        pH264Enc->rateControl.nWindowFrames = 0;
+        pH264Enc->rateControl.nWindowBytes = 0;
+        SEC_OSAL_MutexUnlock(pH264Enc->rateControl.hMutex);
+
         pH264Enc->hMFCH264Handle.returnCodec = SsbSipMfcEncGetOutBuf(pH264Enc->hMFCH264Handle.hMFCHandle, &outputInfo);
-        if ((SsbSipMfcEncGetConfig(pH264Enc->hMFCH264Handle.hMFCHandle, MFC_ENC_GETCONF_FRAME_TAG, &indexTimestamp) != MFC_RET_OK) ||
-            (((indexTimestamp < 0) || (indexTimestamp >= MAX_TIMESTAMP)))){
-            pOutputData->timeStamp = pInputData->timeStamp;
-            pOutputData->nFlags = pInputData->nFlags;
+        if (pH264Enc->hMFCH264Handle.returnCodec != MFC_RET_OK)
+        {
+            SEC_OSAL_Log(SEC_LOG_TRACE, "%s - SsbSipMfcEncGetOutBuf Failed\n", __func__);
+            ret = OMX_ErrorUndefined;
+            goto EXIT;
         } else {
-            pOutputData->timeStamp = pSECComponent->timeStamp[indexTimestamp];
-            pOutputData->nFlags = pSECComponent->nFlags[indexTimestamp];
+            char *p = NULL;
+            int iSpsSize = 0;
+            int iPpsSize = 0;
+
+            p = FindDelimiter((OMX_U8 *)outputInfo.StrmVirAddr + 4, outputInfo.headerSize - 4);
+
+            iSpsSize = (unsigned int)p - (unsigned int)outputInfo.StrmVirAddr;
+            pH264Enc->hMFCH264Handle.headerData.pHeaderSPS = (OMX_PTR)outputInfo.StrmVirAddr;
+            pH264Enc->hMFCH264Handle.headerData.SPSLen = iSpsSize;
+
+            iPpsSize = outputInfo.headerSize - iSpsSize;
+            pH264Enc->hMFCH264Handle.headerData.pHeaderPPS = outputInfo.StrmVirAddr + iSpsSize;
+            pH264Enc->hMFCH264Handle.headerData.PPSLen = iPpsSize;
         }
 
-        if (pH264Enc->hMFCH264Handle.returnCodec == MFC_RET_OK) {
-            /** Fill Output Buffer **/
-            pOutputData->dataBuffer = outputInfo.StrmVirAddr;
-            pOutputData->allocSize = outputInfo.dataSize;
-            pOutputData->dataLen = outputInfo.dataSize;
-            pOutputData->usedDataLen = 0;
+        /* SEC_OSAL_Memcpy((void*)(pOutputData->dataBuffer), (const void*)(outputInfo.StrmVirAddr), outputInfo.headerSize); */
+        pOutputData->dataBuffer = outputInfo.StrmVirAddr;
+        pOutputData->allocSize = outputInfo.headerSize;
+        pOutputData->dataLen = outputInfo.headerSize;
+        pOutputData->timeStamp = 0;
+        pOutputData->nFlags |= OMX_BUFFERFLAG_CODECCONFIG;
+        pOutputData->nFlags |= OMX_BUFFERFLAG_ENDOFFRAME;
 
-            pOutputData->nFlags |= OMX_BUFFERFLAG_ENDOFFRAME;
-            if (outputInfo.frameType == MFC_FRAME_TYPE_I_FRAME)
-                    pOutputData->nFlags |= OMX_BUFFERFLAG_SYNCFRAME;
+        pH264Enc->hMFCH264Handle.bConfiguredMFC = OMX_TRUE;
 
-            SEC_OSAL_Log(SEC_LOG_TRACE, "MFC Encode OK!!!!!!!!!!!!!!!!!!!!!!!!!!!!!\n");
+        ret = OMX_ErrorInputDataEncodeYet;
+        goto EXIT;
+    }
 
-            ret = OMX_ErrorNone;
-        } else {
-            SEC_OSAL_Log(SEC_LOG_ERROR, "%s: SsbSipMfcEncGetOutBuf failed, ret:%d", __FUNCTION__, pH264Enc->hMFCH264Handle.returnCodec);
-            ret = OMX_ErrorUndefined;
+    if ((pInputData->nFlags & OMX_BUFFERFLAG_ENDOFFRAME) &&
+        (pSECComponent->bUseFlagEOF == OMX_FALSE)) {
+        pSECComponent->bUseFlagEOF = OMX_TRUE;
+    }
+
+    if (oneFrameSize <= 0) {
+        pOutputData->timeStamp = pInputData->timeStamp;
+        pOutputData->nFlags = pInputData->nFlags;
+
+        ret = OMX_ErrorNone;
+        goto EXIT;
+    }
+
+    if (pH264Enc->lowLatency.bEnable == OMX_TRUE) {
+        ret = SEC_MFC_H264Enc_EncodeLowLatency(pOMXComponent, pInputData, pOutputData);
+        goto EXIT;
+    }
+
+    ret = SEC_MFC_H264Enc_InputSet(pOMXComponent, pInputData,
+                                   (((pInputData->nFlags & OMX_BUFFERFLAG_EOS) == OMX_BUFFERFLAG_EOS) ||
+                                    (pSECComponent->getAllDelayBuffer == OMX_TRUE)) ? OMX_TRUE : OMX_FALSE);
+    if (ret != OMX_ErrorNone)
+        goto EXIT;
+
+    inputMeta.timeStamp = pInputData->timeStamp;
+    inputMeta.nFlags    = pInputData->nFlags;
+    inputMeta.nEmptyTimeUs = pInputData->nEmptyTimeUs;
+
+    if ((pH264Enc->hMFCH264Handle.returnCodec == MFC_RET_OK) &&
+        (pH264Enc->bFirstFrame == OMX_FALSE)) {
+        ret = SEC_MFC_H264Enc_FrameOut(pOMXComponent, pInputData, pOutputData);
+        if (ret != OMX_ErrorNone)
             goto EXIT;
-        }
 
         if (pSECComponent->getAllDelayBuffer == OMX_TRUE) {
             ret = OMX_ErrorInputDataEncodeYet;
@@ -1062,30 +1689,8 @@ OMX_ERRORTYPE SEC_MFC_H264_Encode(OMX_COMPONENTTYPE *pOMXComponent, SEC_OMX_DATA
         ret = OMX_ErrorUndefined;
     }
 
-    pH264Enc->hMFCH264Handle.returnCodec = SsbSipMfcEncSetInBuf(pH264Enc->hMFCH264Handle.hMFCHandle, pInputInfo);
-    if (pH264Enc->hMFCH264Handle.returnCodec != MFC_RET_OK) {
-        SEC_OSAL_Log(SEC_LOG_TRACE, "Error : SsbSipMfcEncSetInBuf() \n");
+    if (SEC_MFC_H264Enc_FrameStart(pOMXComponent, &inputMeta, oneFrameSize, pOutputData) != OMX_ErrorNone)
         ret = OMX_ErrorUndefined;
-        goto EXIT;
-    } else {
-        pH264Enc->indexInputBuffer++;
-        pH264Enc->indexInputBuffer %= MFC_INPUT_BUFFER_NUM_MAX;
-        pSECComponent->processData[INPUT_PORT_INDEX].specificBufferHeader.YPhyAddr = pH264Enc->MFCEncInputBuffer[pH264Enc->indexInputBuffer].YPhyAddr;
-        pSECComponent->processData[INPUT_PORT_INDEX].specificBufferHeader.CPhyAddr = pH264Enc->MFCEncInputBuffer[pH264Enc->indexInputBuffer].CPhyAddr;
-        pSECComponent->processData[INPUT_PORT_INDEX].specificBufferHeader.YVirAddr = pH264Enc->MFCEncInputBuffer[pH264Enc->indexInputBuffer].YVirAddr;
-        pSECComponent->processData[INPUT_PORT_INDEX].specificBufferHeader.CVirAddr = pH264Enc->MFCEncInputBuffer[pH264Enc->indexInputBuffer].CVirAddr;
-        pSECComponent->processData[INPUT_PORT_INDEX].specificBufferHeader.YSize = pH264Enc->MFCEncInputBuffer[pH264Enc->indexInputBuffer].YBufferSize;
-        pSECComponent->processData[INPUT_PORT_INDEX].specificBufferHeader.CSize = pH264Enc->MFCEncInputBuffer[pH264Enc->indexInputBuffer].CBufferSize;
-    }
-
-    SsbSipMfcEncSetConfig(pH264Enc->hMFCH264Handle.hMFCHandle, MFC_ENC_SETCONF_FRAME_TAG, &(pH264Enc->hMFCH264Handle.indexTimestamp));
-
-    /* mfc encode start */
-    SEC_OSAL_SemaphorePost(pH264Enc->NBEncThread.hEncFrameStart);
-    pH264Enc->NBEncThread.bEncoderRun = OMX_TRUE;
-    pH264Enc->hMFCH264Handle.indexTimestamp++;
-    pH264Enc->hMFCH264Handle.indexTimestamp %= MAX_TIMESTAMP;
-    pH264Enc->bFirstFrame = OMX_FALSE;
 
 EXIT:
     FunctionOut();
@@ -1142,14 +1747,51 @@ EXIT:
     return ret;
 }
 
+/* Port and codec parameter defaults, on a new component and on reset */
+static void SEC_MFC_H264Enc_SetDefault(SEC_OMX_BASECOMPONENT *pSECComponent)
+{
+    SEC_OMX_BASEPORT      *pSECPort = NULL;
+    SEC_H264ENC_HANDLE    *pH264Enc = (SEC_H264ENC_HANDLE *)pSECComponent->hCodecHandle;
+    int i = 0;
+
+    /* Input port */
+    pSECPort = &pSECComponent->pSECPort[INPUT_PORT_INDEX];
+    pSECPort->portDefinition.format.video.nFrameWidth = DEFAULT_FRAME_WIDTH;
+    pSECPort->portDefinition.format.video.nFrameHeight= DEFAULT_FRAME_HEIGHT;
+    pSECPort->portDefinition.format.video.nStride = 0; /*DEFAULT_FRAME_WIDTH;*/
+    pSECPort->portDefinition.nBufferSize = DEFAULT_VIDEO_INPUT_BUFFER_SIZE;
+    pSECPort->portDefinition.format.video.eCompressionFormat = OMX_VIDEO_CodingUnused;
+    SEC_OSAL_Memset(pSECPort->portDefinition.format.video.cMIMEType, 0, MAX_OMX_MIMETYPE_SIZE);
+    SEC_OSAL_Strcpy(pSECPort->portDefinition.format.video.cMIMEType, "raw/video");
+    pSECPort->portDefinition.format.video.eColorFormat = OMX_COLOR_FormatYUV420SemiPlanar;
+    pSECPort->portDefinition.bEnabled = OMX_TRUE;
+
+    /* Output port */
+    pSECPort = &pSECComponent->pSECPort[OUTPUT_PORT_INDEX];
+    pSECPort->portDefinition.format.video.nFrameWidth = DEFAULT_FRAME_WIDTH;
+    pSECPort->portDefinition.format.video.nFrameHeight= DEFAULT_FRAME_HEIGHT;
+    pSECPort->portDefinition.format.video.nStride = 0; /*DEFAULT_FRAME_WIDTH;*/
+    pSECPort->portDefinition.nBufferSize = DEFAULT_VIDEO_OUTPUT_BUFFER_SIZE;
+    pSECPort->portDefinition.format.video.eCompressionFormat = OMX_VIDEO_CodingAVC;
+    SEC_OSAL_Memset(pSECPort->portDefinition.format.video.cMIMEType, 0, MAX_OMX_MIMETYPE_SIZE);
+    SEC_OSAL_Strcpy(pSECPort->portDefinition.format.video.cMIMEType, "video/avc");
+    pSECPort->portDefinition.format.video.eColorFormat = OMX_COLOR_FormatUnused;
+    pSECPort->portDefinition.bEnabled = OMX_TRUE;
+
+    for(i = 0; i < ALL_PORT_NUM; i++) {
+        INIT_SET_SIZE_VERSION(&pH264Enc->AVCComponent[i], OMX_VIDEO_PARAM_AVCTYPE);
+        pH264Enc->AVCComponent[i].nPortIndex = i;
+        pH264Enc->AVCComponent[i].eProfile   = OMX_VIDEO_AVCProfileBaseline;
+        pH264Enc->AVCComponent[i].eLevel     = OMX_VIDEO_AVCLevel31;
+    }
+}
+
 OSCL_EXPORT_REF OMX_ERRORTYPE SEC_OMX_ComponentInit(OMX_HANDLETYPE hComponent, OMX_STRING componentName)
 {
     OMX_ERRORTYPE            ret = OMX_ErrorNone;
     OMX_COMPONENTTYPE       *pOMXComponent = NULL;
     SEC_OMX_BASECOMPONENT   *pSECComponent = NULL;
-    SEC_OMX_BASEPORT        *pSECPort = NULL;
     SEC_H264ENC_HANDLE      *pH264Enc = NULL;
-    int i = 0;
 
     FunctionIn();
 
@@ -1192,7 +1834,20 @@ OSCL_EXPORT_REF OMX_ERRORTYPE SEC_OMX_ComponentInit(OMX_HANDLETYPE hComponent, O
     SEC_OSAL_Memset(pH264Enc, 0, sizeof(SEC_H264ENC_HANDLE));
     pSECComponent->hCodecHandle = (OMX_HANDLETYPE)pH264Enc;
 
+    ret = SEC_OSAL_MutexCreate(&pH264Enc->rateControl.hMutex);
+    if (ret != OMX_ErrorNone) {
+        SEC_OSAL_Free(pH264Enc);
+        pSECComponent->hCodecHandle = NULL;
+        SEC_OMX_VideoEncodeComponentDeinit(pOMXComponent);
+        SEC_OSAL_Log(SEC_LOG_ERROR, "OMX_ErrorInsufficientResources, Line:%d", __LINE__);
+        ret = OMX_ErrorInsufficientResources;
+        goto EXIT;
+    }
+
     SEC_OSAL_Strcpy(pSECComponent->componentName, SEC_OMX_COMPONENT_H264_ENC);
+
+    SEC_OSAL_Strcpy(pSECComponent->bufferProcessThreadAttr.name, "SecAvcEnc");
+
     /* Set componentVersion */
     pSECComponent->componentVersion.s.nVersionMajor = VERSIONMAJOR_NUMBER;
     pSECComponent->componentVersion.s.nVersionMinor = VERSIONMINOR_NUMBER;
@@ -1214,36 +1869,7 @@ OSCL_EXPORT_REF OMX_ERRORTYPE SEC_OMX_ComponentInit(OMX_HANDLETYPE hComponent, O
     pSECComponent->capabilityFlags.iOMXComponentCanHandleIncompleteFrames         = OMX_TRUE;
     pSECComponent->capabilityFlags.iOMXComponentUsesFullAVCFrames                 = OMX_TRUE;
 
-    /* Input port */
-    pSECPort = &pSECComponent->pSECPort[INPUT_PORT_INDEX];
-    pSECPort->portDefinition.format.video.nFrameWidth = DEFAULT_FRAME_WIDTH;
-    pSECPort->portDefinition.format.video.nFrameHeight= DEFAULT_FRAME_HEIGHT;
-    pSECPort->portDefinition.format.video.nStride = 0; /*DEFAULT_FRAME_WIDTH;*/
-    pSECPort->portDefinition.nBufferSize = DEFAULT_VIDEO_INPUT_BUFFER_SIZE;
-    pSECPort->portDefinition.format.video.eCompressionFormat = OMX_VIDEO_CodingUnused;
-    SEC_OSAL_Memset(pSECPort->portDefinition.format.video.cMIMEType, 0, MAX_OMX_MIMETYPE_SIZE);
-    SEC_OSAL_Strcpy(pSECPort->portDefinition.format.video.cMIMEType, "raw/video");
-    pSECPort->portDefinition.format.video.eColorFormat = OMX_COLOR_FormatYUV420SemiPlanar;
-    pSECPort->portDefinition.bEnabled = OMX_TRUE;
-
-    /* Output port */
-    pSECPort = &pSECComponent->pSECPort[OUTPUT_PORT_INDEX];
-    pSECPort->portDefinition.format.video.nFrameWidth = DEFAULT_FRAME_WIDTH;
-    pSECPort->portDefinition.format.video.nFrameHeight= DEFAULT_FRAME_HEIGHT;
-    pSECPort->portDefinition.format.video.nStride = 0; /*DEFAULT_FRAME_WIDTH;*/
-    pSECPort->portDefinition.nBufferSize = DEFAULT_VIDEO_OUTPUT_BUFFER_SIZE;
-    pSECPort->portDefinition.format.video.eCompressionFormat = OMX_VIDEO_CodingAVC;
-    SEC_OSAL_Memset(pSECPort->portDefinition.format.video.cMIMEType, 0, MAX_OMX_MIMETYPE_SIZE);
-    SEC_OSAL_Strcpy(pSECPort->portDefinition.format.video.cMIMEType, "video/avc");
-    pSECPort->portDefinition.format.video.eColorFormat = OMX_COLOR_FormatUnused;
-    pSECPort->portDefinition.bEnabled = OMX_TRUE;
-
-    for(i = 0; i < ALL_PORT_NUM; i++) {
-        INIT_SET_SIZE_VERSION(&pH264Enc->AVCComponent[i], OMX_VIDEO_PARAM_AVCTYPE);
-        pH264Enc->AVCComponent[i].nPortIndex = i;
-        pH264Enc->AVCComponent[i].eProfile   = OMX_VIDEO_AVCProfileBaseline;
-        pH264Enc->AVCComponent[i].eLevel     = OMX_VIDEO_AVCLevel31;
-    }
+    SEC_MFC_H264Enc_SetDefault(pSECComponent);
 
     pOMXComponent->GetParameter      = &SEC_MFC_H264Enc_GetParameter;
     pOMXComponent->SetParameter      = &SEC_MFC_H264Enc_SetParameter;
@@ -1258,6 +1884,9 @@ OSCL_EXPORT_REF OMX_ERRORTYPE SEC_OMX_ComponentInit(OMX_HANDLETYPE hComponent, O
     pSECComponent->sec_mfc_bufferProcess      = &SEC_MFC_H264Enc_bufferProcess;
     pSECComponent->sec_checkInputFrame        = NULL;
 
+    pSECComponent->sec_mfc_allocateOutputBuffer = &SEC_MFC_H264Enc_AllocateOutputBuffer;
+    pSECComponent->sec_mfc_releaseOutputBuffer  = &SEC_MFC_H264Enc_ReleaseOutputBuffer;
+
     pSECComponent->currentState = OMX_StateLoaded;
 
     ret = OMX_ErrorNone;
@@ -1289,6 +1918,12 @@ OMX_ERRORTYPE SEC_OMX_ComponentDeinit(OMX_HANDLETYPE hComponent)
 
     pH264Enc = (SEC_H264ENC_HANDLE *)pSECComponent->hCodecHandle;
     if (pH264Enc != NULL) {
+        /* opened for output port buffers but never initialized */
+        if (pH264Enc->hMFCH264Handle.hMFCHandle != NULL) {
+            SsbSipMfcEncClose(pH264Enc->hMFCH264Handle.hMFCHandle);
+            pH264Enc->hMFCH264Handle.hMFCHandle = NULL;
+        }
+        SEC_OSAL_MutexTerminate(pH264Enc->rateControl.hMutex);
         SEC_OSAL_Free(pH264Enc);
         pH264Enc = pSECComponent->hCodecHandle = NULL;
     }
@@ -1305,3 +1940,42 @@ EXIT:
 
     return ret;
 }
+
+/* A Loaded component with no MFC instance back to its defaults, kept by the core for reuse */
+OSCL_EXPORT_REF OMX_ERRORTYPE SEC_OMX_ComponentReset(OMX_HANDLETYPE hComponent)
+{
+    OMX_ERRORTYPE            ret = OMX_ErrorNone;
+    OMX_COMPONENTTYPE       *pOMXComponent = NULL;
+    SEC_OMX_BASECOMPONENT   *pSECComponent = NULL;
+    SEC_H264ENC_HANDLE      *pH264Enc = NULL;
+    OMX_HANDLETYPE           hMutex = NULL;
+
+    FunctionIn();
+
+    if (hComponent == NULL) {
+        ret = OMX_ErrorBadParameter;
+        goto EXIT;
+    }
+    pOMXComponent = (OMX_COMPONENTTYPE *)hComponent;
+    pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    pH264Enc = (SEC_H264ENC_HANDLE *)pSECComponent->hCodecHandle;
+    if ((pH264Enc == NULL) || (pH264Enc->hMFCH264Handle.hMFCHandle != NULL)) {
+        ret = OMX_ErrorIncorrectStateOperation;
+        goto EXIT;
+    }
+
+    ret = SEC_OMX_VideoEncodeComponentReset(pOMXComponent);
+    if (ret != OMX_ErrorNone) {
+        goto EXIT;
+    }
+
+    hMutex = pH264Enc->rateControl.hMutex;
+    SEC_OSAL_Memset(pH264Enc, 0, sizeof(SEC_H264ENC_HANDLE));
+    pH264Enc->rateControl.hMutex = hMutex;
+    SEC_MFC_H264Enc_SetDefault(pSECComponent);
+
+EXIT:
+    FunctionOut();
+
+    return ret;
+}
@@ -47,12 +47,45 @@ typedef struct _SEC_MFC_H264ENC_HANDLE
     SSBSIP_MFC_ENC_H264_PARAM mfcVideoAvc;
     SSBSIP_MFC_ENC_INPUT_INFO inputInfo;
 /*    SSBSIP_MFC_ENC_OUTPUT_INFO outputInfo; */
-    OMX_U32 indexTimestamp;
     OMX_BOOL bConfiguredMFC;
     EXTRA_DATA headerData;
     OMX_S32 returnCodec;
 } SEC_MFC_H264ENC_HANDLE;
 
+/* nChange, given to the MFC before its next encode */
+#define H264ENC_RC_CHANGE_BITRATE   0x01
+#define H264ENC_RC_CHANGE_FRAMERATE 0x02
+#define H264ENC_RC_CHANGE_FRAMESKIP 0x04
+#define H264ENC_RC_REQUEST_IDR      0x08
+
+typedef struct _SEC_MFC_H264ENC_RATECONTROL
+{
+    OMX_HANDLETYPE hMutex;          /* SetConfig against the buffer process thread */
+    OMX_U32  nChange;
+    OMX_BOOL bFrameSkip;
+    OMX_BOOL bClosedLoop;
+    OMX_U32  nMinBitrate;
+    OMX_U32  nMaxBitrate;
+    OMX_U32  nEncoderBitrate;       /* last one given to the MFC */
+    OMX_U32  nMeasuredBitrate;
+    OMX_U32  nWindowFrames;
+    OMX_U32  nWindowBytes;
+} SEC_MFC_H264ENC_RATECONTROL;
+
+typedef struct _SEC_MFC_H264ENC_LOWLATENCY
+{
+    OMX_BOOL bEnable;
+    OMX_U32  nSliceMode;            /* OMX_VIDEO_AVCSLICEMODETYPE, the MFC slice mode */
+    OMX_U32  nSliceSize;
+    OMX_BOOL bSliceOutput;
+
+    /* the last frame, while its slices are given out one by one */
+    OMX_U8  *pFrame;
+    OMX_U32  nFrameSize;
+    OMX_U32  nSliceOffset;
+    SEC_OMX_FRAME_META frameMeta;
+} SEC_MFC_H264ENC_LOWLATENCY;
+
 typedef struct _SEC_H264ENC_HANDLE
 {
     /* OMX Codec specific */
@@ -61,12 +94,15 @@ typedef struct _SEC_H264ENC_HANDLE
 
     /* SEC MFC Codec specific */
     SEC_MFC_H264ENC_HANDLE hMFCH264Handle;
+    SEC_MFC_H264ENC_RATECONTROL rateControl;
+    SEC_MFC_H264ENC_LOWLATENCY lowLatency;
 
     /* For Non-Block mode */
     SEC_MFC_NBENC_THREAD NBEncThread;
     OMX_BOOL bFirstFrame;
     MFC_ENC_INPUT_BUFFER MFCEncInputBuffer[MFC_INPUT_BUFFER_NUM_MAX];
     OMX_U32  indexInputBuffer;
+    MFC_ENC_CLIENT_BUFFER MFCEncClientBuffer;
 } SEC_H264ENC_HANDLE;
 
 #ifdef __cplusplus
@@ -75,6 +111,7 @@ extern "C" {
 
 OSCL_EXPORT_REF OMX_ERRORTYPE SEC_OMX_ComponentInit(OMX_HANDLETYPE hComponent, OMX_STRING componentName);
 OMX_ERRORTYPE SEC_OMX_ComponentDeinit(OMX_HANDLETYPE hComponent);
+OSCL_EXPORT_REF OMX_ERRORTYPE SEC_OMX_ComponentReset(OMX_HANDLETYPE hComponent);
 
 #ifdef __cplusplus
 };
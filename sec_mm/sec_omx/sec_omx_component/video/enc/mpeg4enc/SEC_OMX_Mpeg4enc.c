@@ -215,15 +215,8 @@ void Set_Mpeg4Enc_Param(SSBSIP_MFC_ENC_MPEG4_PARAM *pMpeg4Param, SEC_OMX_BASECOM
     pMpeg4Param->NumberBFrames        = 0;    /* 0(not used) ~ 2 */
     pMpeg4Param->DisableQpelME        = 1;
 
-    switch ((SEC_OMX_COLOR_FORMATTYPE)pSECInputPort->portDefinition.format.video.eColorFormat) {
-    case OMX_COLOR_FormatYUV420SemiPlanar:
-        pMpeg4Param->FrameMap = NV12_LINEAR;
-        break;
-    case OMX_SEC_COLOR_FormatNV12TPhysicalAddress:
-    default:
-        pMpeg4Param->FrameMap = NV12_TILE;
-        break;
-    }
+    /* raw input of any color format is converted to NV12T by SEC_Preprocessor_InputData */
+    pMpeg4Param->FrameMap = NV12_TILE;
 
 #ifdef USE_ANDROID_EXTENSION
     if (pSECInputPort->bStoreMetaDataInBuffer != OMX_FALSE) {
@@ -292,15 +285,8 @@ void Set_H263Enc_Param(SSBSIP_MFC_ENC_H263_PARAM *pH263Param, SEC_OMX_BASECOMPON
 
     pH263Param->FrameRate            = (pSECInputPort->portDefinition.format.video.xFramerate) >> 16;
 
-    switch ((SEC_OMX_COLOR_FORMATTYPE)pSECInputPort->portDefinition.format.video.eColorFormat) {
-    case OMX_COLOR_FormatYUV420SemiPlanar:
-        pH263Param->FrameMap = NV12_LINEAR;
-        break;
-    case OMX_SEC_COLOR_FormatNV12TPhysicalAddress:
-    default:
-        pH263Param->FrameMap = NV12_TILE;
-        break;
-    }
+    /* raw input of any color format is converted to NV12T by SEC_Preprocessor_InputData */
+    pH263Param->FrameMap = NV12_TILE;
 
 #ifdef USE_ANDROID_EXTENSION
     if (pSECInputPort->bStoreMetaDataInBuffer != OMX_FALSE) {
@@ -925,7 +911,10 @@ OMX_ERRORTYPE SEC_MFC_EncodeThread(OMX_HANDLETYPE hComponent)
         SEC_OSAL_SemaphoreWait(pMpeg4Enc->NBEncThread.hEncFrameStart);
 
         if (pMpeg4Enc->NBEncThread.bExitEncodeThread == OMX_FALSE) {
+            OMX_U64 encodeStartUs = SEC_OSAL_GetSystemTimeUs();
+
             pMpeg4Enc->hMFCMpeg4Handle.returnCodec = SsbSipMfcEncExe(pMpeg4Enc->hMFCMpeg4Handle.hMFCHandle);
+            SEC_OMX_StatsAdd(&pSECComponent->stats, SEC_OMX_STATS_MFC, encodeStartUs);
             SEC_OSAL_SemaphorePost(pMpeg4Enc->NBEncThread.hEncFrameEnd);
         }
     }
@@ -937,6 +926,69 @@ EXIT:
     return ret;
 }
 
+/* Output port buffer nIndex in MFC memory, the MFC is opened for it */
+OMX_ERRORTYPE SEC_MFC_Mpeg4Enc_AllocateOutputBuffer(
+    OMX_COMPONENTTYPE *pOMXComponent,
+    OMX_U32            nIndex,
+    OMX_U32            nSizeBytes,
+    OMX_U8           **ppBuffer,
+    OMX_PTR           *ppPhyBuffer)
+{
+    OMX_ERRORTYPE          ret = OMX_ErrorNone;
+    SEC_OMX_BASECOMPONENT *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    SEC_MPEG4ENC_HANDLE   *pMpeg4Enc = (SEC_MPEG4ENC_HANDLE *)pSECComponent->hCodecHandle;
+    SEC_OMX_BASEPORT      *pSECOutputPort = &pSECComponent->pSECPort[OUTPUT_PORT_INDEX];
+    SSBIP_MFC_BUFFER_TYPE  buf_type = CACHE;
+
+    FunctionIn();
+
+    if (pMpeg4Enc->hMFCMpeg4Handle.hMFCHandle == NULL) {
+        pMpeg4Enc->hMFCMpeg4Handle.hMFCHandle = (OMX_PTR)SsbSipMfcEncOpen(&buf_type);
+        if (pMpeg4Enc->hMFCMpeg4Handle.hMFCHandle == NULL) {
+            ret = OMX_ErrorInsufficientResources;
+            goto EXIT;
+        }
+        SEC_OSAL_Memset(&pMpeg4Enc->MFCEncClientBuffer, 0, sizeof(MFC_ENC_CLIENT_BUFFER));
+    }
+
+    ret = SEC_MFC_EncClientBufferGet(pMpeg4Enc->hMFCMpeg4Handle.hMFCHandle, &pMpeg4Enc->MFCEncClientBuffer,
+                                     pSECOutputPort->portDefinition.nBufferSize,
+                                     pSECOutputPort->portDefinition.nBufferCountActual,
+                                     nIndex, nSizeBytes, ppBuffer, ppPhyBuffer);
+
+EXIT:
+    FunctionOut();
+
+    return ret;
+}
+
+/* Gives back output port buffers lent to the MFC */
+OMX_ERRORTYPE SEC_MFC_Mpeg4Enc_ReleaseOutputBuffer(OMX_COMPONENTTYPE *pOMXComponent)
+{
+    OMX_ERRORTYPE          ret = OMX_ErrorNone;
+    SEC_OMX_BASECOMPONENT *pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    SEC_MPEG4ENC_HANDLE   *pMpeg4Enc = (SEC_MPEG4ENC_HANDLE *)pSECComponent->hCodecHandle;
+
+    FunctionIn();
+
+    if (pMpeg4Enc->hMFCMpeg4Handle.hMFCHandle == NULL)
+        goto EXIT;
+
+    /* wait for mfc encode done, it may write a lent buffer. The frame is dropped */
+    if ((pMpeg4Enc->MFCEncClientBuffer.pLent != NULL) && (pMpeg4Enc->NBEncThread.bEncoderRun == OMX_TRUE)) {
+        SEC_OSAL_SemaphoreWait(pMpeg4Enc->NBEncThread.hEncFrameEnd);
+        pMpeg4Enc->NBEncThread.bEncoderRun = OMX_FALSE;
+        pMpeg4Enc->bFirstFrame = OMX_TRUE;
+    }
+
+    SEC_MFC_EncOutputRelease(pOMXComponent, pMpeg4Enc->hMFCMpeg4Handle.hMFCHandle, &pMpeg4Enc->MFCEncClientBuffer);
+
+EXIT:
+    FunctionOut();
+
+    return ret;
+}
+
 /* MFC Init */
 OMX_ERRORTYPE SEC_MFC_Mpeg4Enc_Init(OMX_COMPONENTTYPE *pOMXComponent)
 {
@@ -956,14 +1008,19 @@ OMX_ERRORTYPE SEC_MFC_Mpeg4Enc_Init(OMX_COMPONENTTYPE *pOMXComponent)
     pSECComponent->bUseFlagEOF = OMX_FALSE;
     pSECComponent->bSaveFlagEOS = OMX_FALSE;
 
-    /* MFC(Multi Format Codec) encoder and CMM(Codec Memory Management) driver open */
-    SSBIP_MFC_BUFFER_TYPE buf_type = CACHE;
-    hMFCHandle = (OMX_PTR)SsbSipMfcEncOpen(&buf_type);
-    if (hMFCHandle == NULL) {
-        ret = OMX_ErrorInsufficientResources;
-        goto EXIT;
+    /* MFC(Multi Format Codec) encoder and CMM(Codec Memory Management) driver open,
+       unless it was for the output port buffers */
+    if (pMpeg4Enc->hMFCMpeg4Handle.hMFCHandle == NULL) {
+        SSBIP_MFC_BUFFER_TYPE buf_type = CACHE;
+        hMFCHandle = (OMX_PTR)SsbSipMfcEncOpen(&buf_type);
+        if (hMFCHandle == NULL) {
+            ret = OMX_ErrorInsufficientResources;
+            goto EXIT;
+        }
+        pMpeg4Enc->hMFCMpeg4Handle.hMFCHandle = hMFCHandle;
+        SEC_OSAL_Memset(&pMpeg4Enc->MFCEncClientBuffer, 0, sizeof(MFC_ENC_CLIENT_BUFFER));
     }
-    pMpeg4Enc->hMFCMpeg4Handle.hMFCHandle = hMFCHandle;
+    hMFCHandle = pMpeg4Enc->hMFCMpeg4Handle.hMFCHandle;
 
     /* set MFC ENC VIDEO PARAM and initialize MFC encoder instance */
     if (pMpeg4Enc->hMFCMpeg4Handle.codecType == CODEC_TYPE_MPEG4) {
@@ -1030,9 +1087,10 @@ OMX_ERRORTYPE SEC_MFC_Mpeg4Enc_Init(OMX_COMPONENTTYPE *pOMXComponent)
         pMpeg4Enc->hMFCMpeg4Handle.returnCodec = MFC_RET_OK;
     }
 
-    SEC_OSAL_Memset(pSECComponent->timeStamp, -19771003, sizeof(OMX_TICKS) * MAX_TIMESTAMP);
-    SEC_OSAL_Memset(pSECComponent->nFlags, 0, sizeof(OMX_U32) * MAX_FLAGS);
-    pMpeg4Enc->hMFCMpeg4Handle.indexTimestamp = 0;
+    /* frames in the encoder, at most the B-VOPs and the one being encoded */
+    ret = SEC_OMX_FrameTagCreate(&pSECComponent->frameTagMap, FRAME_TAG_MAP_MIN_SIZE);
+    if (ret != OMX_ErrorNone)
+        goto EXIT;
 
 EXIT:
     FunctionOut();
@@ -1052,6 +1110,8 @@ OMX_ERRORTYPE SEC_MFC_Mpeg4Enc_Terminate(OMX_COMPONENTTYPE *pOMXComponent)
 
     pMpeg4Enc = (SEC_MPEG4ENC_HANDLE *)pSECComponent->hCodecHandle;
 
+    SEC_MFC_Mpeg4Enc_ReleaseOutputBuffer(pOMXComponent);
+
     if (pMpeg4Enc->NBEncThread.hNBEncodeThread != NULL) {
         pMpeg4Enc->NBEncThread.bExitEncodeThread = OMX_TRUE;
         SEC_OSAL_SemaphorePost(pMpeg4Enc->NBEncThread.hEncFrameStart);
@@ -1073,8 +1133,11 @@ OMX_ERRORTYPE SEC_MFC_Mpeg4Enc_Terminate(OMX_COMPONENTTYPE *pOMXComponent)
     if (hMFCHandle != NULL) {
         SsbSipMfcEncClose(hMFCHandle);
         pMpeg4Enc->hMFCMpeg4Handle.hMFCHandle = NULL;
+        SEC_OSAL_Memset(&pMpeg4Enc->MFCEncClientBuffer, 0, sizeof(MFC_ENC_CLIENT_BUFFER));
     }
 
+    SEC_OMX_FrameTagTerminate(&pSECComponent->frameTagMap);
+
 EXIT:
     FunctionOut();
 
@@ -1092,6 +1155,9 @@ OMX_ERRORTYPE SEC_MFC_Mpeg4_Encode(OMX_COMPONENTTYPE *pOMXComponent, SEC_OMX_DAT
     SEC_OMX_BASEPORT          *pSECPort = NULL;
     MFC_ENC_ADDR_INFO          addrInfo;
     OMX_U32                    oneFrameSize = pInputData->dataLen;
+    SEC_OMX_FRAME_META         inputMeta;
+    SEC_OMX_FRAME_META         outputMeta;
+    int                        frameTag = -1;
 
     FunctionIn();
 
@@ -1168,12 +1234,12 @@ OMX_ERRORTYPE SEC_MFC_Mpeg4_Encode(OMX_COMPONENTTYPE *pOMXComponent, SEC_OMX_DAT
         pInputInfo->CPhyAddr = pSECComponent->processData[INPUT_PORT_INDEX].specificBufferHeader.CPhyAddr;
     }
 
-    pSECComponent->timeStamp[pMpeg4Enc->hMFCMpeg4Handle.indexTimestamp] = pInputData->timeStamp;
-    pSECComponent->nFlags[pMpeg4Enc->hMFCMpeg4Handle.indexTimestamp] = pInputData->nFlags;
+    inputMeta.timeStamp = pInputData->timeStamp;
+    inputMeta.nFlags    = pInputData->nFlags;
+    inputMeta.nEmptyTimeUs = pInputData->nEmptyTimeUs;
 
     if ((pMpeg4Enc->hMFCMpeg4Handle.returnCodec == MFC_RET_OK) &&
         (pMpeg4Enc->bFirstFrame == OMX_FALSE)) {
-        OMX_S32 indexTimestamp = 0;
 
         /* wait for mfc encode done */
         if (pMpeg4Enc->NBEncThread.bEncoderRun != OMX_FALSE) {
@@ -1182,13 +1248,16 @@ OMX_ERRORTYPE SEC_MFC_Mpeg4_Encode(OMX_COMPONENTTYPE *pOMXComponent, SEC_OMX_DAT
         }
 
         pMpeg4Enc->hMFCMpeg4Handle.returnCodec = SsbSipMfcEncGetOutBuf(hMFCHandle, &outputInfo);
-        if ((SsbSipMfcEncGetConfig(hMFCHandle, MFC_ENC_GETCONF_FRAME_TAG, &indexTimestamp) != MFC_RET_OK) ||
-            (((indexTimestamp < 0) || (indexTimestamp >= MAX_TIMESTAMP)))) {
+        if ((SsbSipMfcEncGetConfig(hMFCHandle, MFC_ENC_GETCONF_FRAME_TAG, &frameTag) != MFC_RET_OK) ||
+            (SEC_OMX_FrameTagTake(&pSECComponent->frameTagMap, frameTag, &outputMeta) != OMX_TRUE)) {
             pOutputData->timeStamp = pInputData->timeStamp;
             pOutputData->nFlags = pInputData->nFlags;
+            pOutputData->nEmptyTimeUs = pInputData->nEmptyTimeUs;
         } else {
-            pOutputData->timeStamp = pSECComponent->timeStamp[indexTimestamp];
-            pOutputData->nFlags = pSECComponent->nFlags[indexTimestamp];
+            pOutputData->timeStamp = outputMeta.timeStamp;
+            pOutputData->nFlags = outputMeta.nFlags;
+            pOutputData->nEmptyTimeUs = outputMeta.nEmptyTimeUs;
+            SEC_OMX_StatsAdd(&pSECComponent->stats, SEC_OMX_STATS_REORDER, outputMeta.nSubmitTimeUs);
         }
 
         if (pMpeg4Enc->hMFCMpeg4Handle.returnCodec == MFC_RET_OK) {
@@ -1197,6 +1266,7 @@ OMX_ERRORTYPE SEC_MFC_Mpeg4_Encode(OMX_COMPONENTTYPE *pOMXComponent, SEC_OMX_DAT
             pOutputData->allocSize = outputInfo.dataSize;
             pOutputData->dataLen = outputInfo.dataSize;
             pOutputData->usedDataLen = 0;
+            SEC_MFC_EncOutputTake(pOMXComponent, &pMpeg4Enc->MFCEncClientBuffer, pOutputData);
 
             pOutputData->nFlags |= OMX_BUFFERFLAG_ENDOFFRAME;
             if (outputInfo.frameType == MFC_FRAME_TYPE_I_FRAME)
@@ -1246,13 +1316,16 @@ OMX_ERRORTYPE SEC_MFC_Mpeg4_Encode(OMX_COMPONENTTYPE *pOMXComponent, SEC_OMX_DAT
         pSECComponent->processData[INPUT_PORT_INDEX].specificBufferHeader.CSize = pMpeg4Enc->MFCEncInputBuffer[pMpeg4Enc->indexInputBuffer].CBufferSize;
     }
 
-    SsbSipMfcEncSetConfig(hMFCHandle, MFC_ENC_SETCONF_FRAME_TAG, &(pMpeg4Enc->hMFCMpeg4Handle.indexTimestamp));
+    inputMeta.nStreamSize   = oneFrameSize;
+    inputMeta.nSubmitTimeUs = SEC_OSAL_GetSystemTimeUs();
+    frameTag = SEC_OMX_FrameTagPut(&pSECComponent->frameTagMap, &inputMeta);
+    SEC_OMX_StatsFrameIn(&pSECComponent->stats, oneFrameSize);
+    SsbSipMfcEncSetConfig(hMFCHandle, MFC_ENC_SETCONF_FRAME_TAG, &frameTag);
+    SEC_MFC_EncOutputLend(pOMXComponent, hMFCHandle, &pMpeg4Enc->MFCEncClientBuffer, pOutputData);
 
     /* mfc encode start */
     SEC_OSAL_SemaphorePost(pMpeg4Enc->NBEncThread.hEncFrameStart);
     pMpeg4Enc->NBEncThread.bEncoderRun = OMX_TRUE;
-    pMpeg4Enc->hMFCMpeg4Handle.indexTimestamp++;
-    pMpeg4Enc->hMFCMpeg4Handle.indexTimestamp %= MAX_TIMESTAMP;
     pMpeg4Enc->bFirstFrame = OMX_FALSE;
 
 EXIT:
@@ -1305,15 +1378,89 @@ EXIT:
     return ret;
 }
 
+/* Port and codec parameter defaults, on a new component and on reset */
+static void SEC_MFC_Mpeg4Enc_SetDefault(SEC_OMX_BASECOMPONENT *pSECComponent)
+{
+    SEC_OMX_BASEPORT      *pSECPort = NULL;
+    SEC_MPEG4ENC_HANDLE   *pMpeg4Enc = (SEC_MPEG4ENC_HANDLE *)pSECComponent->hCodecHandle;
+    CODEC_TYPE             codecType = pMpeg4Enc->hMFCMpeg4Handle.codecType;
+    int i = 0;
+
+    /* Input port */
+    pSECPort = &pSECComponent->pSECPort[INPUT_PORT_INDEX];
+    pSECPort->portDefinition.format.video.nFrameWidth = DEFAULT_FRAME_WIDTH;
+    pSECPort->portDefinition.format.video.nFrameHeight= DEFAULT_FRAME_HEIGHT;
+    pSECPort->portDefinition.format.video.nBitrate = 64000;
+    pSECPort->portDefinition.format.video.xFramerate= (15 << 16);
+    pSECPort->portDefinition.format.video.eCompressionFormat = OMX_VIDEO_CodingUnused;
+    pSECPort->portDefinition.format.video.pNativeRender = 0;
+    pSECPort->portDefinition.format.video.bFlagErrorConcealment = OMX_FALSE;
+    SEC_OSAL_Memset(pSECPort->portDefinition.format.video.cMIMEType, 0, MAX_OMX_MIMETYPE_SIZE);
+    SEC_OSAL_Strcpy(pSECPort->portDefinition.format.video.cMIMEType, "raw/video");
+    pSECPort->portDefinition.format.video.eColorFormat = OMX_COLOR_FormatYUV420SemiPlanar;
+    pSECPort->portDefinition.nBufferSize = DEFAULT_VIDEO_INPUT_BUFFER_SIZE;
+    pSECPort->portDefinition.bEnabled = OMX_TRUE;
+
+    /* Output port */
+    pSECPort = &pSECComponent->pSECPort[OUTPUT_PORT_INDEX];
+    pSECPort->portDefinition.format.video.nFrameWidth = DEFAULT_FRAME_WIDTH;
+    pSECPort->portDefinition.format.video.nFrameHeight= DEFAULT_FRAME_HEIGHT;
+    pSECPort->portDefinition.format.video.nBitrate = 64000;
+    pSECPort->portDefinition.format.video.xFramerate= (15 << 16);
+    if (codecType == CODEC_TYPE_MPEG4) {
+        pSECPort->portDefinition.format.video.eCompressionFormat = OMX_VIDEO_CodingMPEG4;
+        SEC_OSAL_Memset(pSECPort->portDefinition.format.video.cMIMEType, 0, MAX_OMX_MIMETYPE_SIZE);
+        SEC_OSAL_Strcpy(pSECPort->portDefinition.format.video.cMIMEType, "video/mpeg4");
+    } else {
+        pSECPort->portDefinition.format.video.eCompressionFormat = OMX_VIDEO_CodingH263;
+        SEC_OSAL_Memset(pSECPort->portDefinition.format.video.cMIMEType, 0, MAX_OMX_MIMETYPE_SIZE);
+        SEC_OSAL_Strcpy(pSECPort->portDefinition.format.video.cMIMEType, "video/h263");
+    }
+    pSECPort->portDefinition.format.video.pNativeRender = 0;
+    pSECPort->portDefinition.format.video.bFlagErrorConcealment = OMX_FALSE;
+    pSECPort->portDefinition.format.video.eColorFormat = OMX_COLOR_FormatUnused;
+    pSECPort->portDefinition.nBufferSize = DEFAULT_VIDEO_OUTPUT_BUFFER_SIZE;
+    pSECPort->portDefinition.bEnabled = OMX_TRUE;
+
+    if (codecType == CODEC_TYPE_MPEG4) {
+        for(i = 0; i < ALL_PORT_NUM; i++) {
+            INIT_SET_SIZE_VERSION(&pMpeg4Enc->mpeg4Component[i], OMX_VIDEO_PARAM_MPEG4TYPE);
+            pMpeg4Enc->mpeg4Component[i].nPortIndex = i;
+            pMpeg4Enc->mpeg4Component[i].eProfile   = OMX_VIDEO_MPEG4ProfileSimple;
+            pMpeg4Enc->mpeg4Component[i].eLevel     = OMX_VIDEO_MPEG4Level4;
+
+            pMpeg4Enc->mpeg4Component[i].nPFrames = 10;
+            pMpeg4Enc->mpeg4Component[i].nBFrames = 0;          /* No support for B frames */
+            pMpeg4Enc->mpeg4Component[i].nMaxPacketSize = 256;  /* Default value */
+            pMpeg4Enc->mpeg4Component[i].nAllowedPictureTypes =  OMX_VIDEO_PictureTypeI | OMX_VIDEO_PictureTypeP;
+            pMpeg4Enc->mpeg4Component[i].bGov = OMX_FALSE;
+
+        }
+    } else {
+        for(i = 0; i < ALL_PORT_NUM; i++) {
+            INIT_SET_SIZE_VERSION(&pMpeg4Enc->h263Component[i], OMX_VIDEO_PARAM_H263TYPE);
+            pMpeg4Enc->h263Component[i].nPortIndex = i;
+            pMpeg4Enc->h263Component[i].eProfile   = OMX_VIDEO_H263ProfileBaseline;
+            pMpeg4Enc->h263Component[i].eLevel     = OMX_VIDEO_H263Level45;
+
+            pMpeg4Enc->h263Component[i].nPFrames = 20;
+            pMpeg4Enc->h263Component[i].nBFrames = 0;          /* No support for B frames */
+            pMpeg4Enc->h263Component[i].bPLUSPTYPEAllowed = OMX_FALSE;
+            pMpeg4Enc->h263Component[i].nAllowedPictureTypes = OMX_VIDEO_PictureTypeI | OMX_VIDEO_PictureTypeP;
+            pMpeg4Enc->h263Component[i].bForceRoundingTypeToZero = OMX_TRUE;
+            pMpeg4Enc->h263Component[i].nPictureHeaderRepetition = 0;
+            pMpeg4Enc->h263Component[i].nGOBHeaderInterval = 0;
+        }
+    }
+}
+
 OSCL_EXPORT_REF OMX_ERRORTYPE SEC_OMX_ComponentInit(OMX_HANDLETYPE hComponent, OMX_STRING componentName)
 {
     OMX_ERRORTYPE            ret = OMX_ErrorNone;
     OMX_COMPONENTTYPE       *pOMXComponent = NULL;
     SEC_OMX_BASECOMPONENT   *pSECComponent = NULL;
-    SEC_OMX_BASEPORT        *pSECPort = NULL;
     SEC_MPEG4ENC_HANDLE     *pMpeg4Enc = NULL;
     OMX_S32                  codecType = -1;
-    int i = 0;
 
     FunctionIn();
 
@@ -1361,10 +1508,13 @@ OSCL_EXPORT_REF OMX_ERRORTYPE SEC_OMX_ComponentInit(OMX_HANDLETYPE hComponent, O
     pSECComponent->hCodecHandle = (OMX_HANDLETYPE)pMpeg4Enc;
     pMpeg4Enc->hMFCMpeg4Handle.codecType = codecType;
 
-    if (codecType == CODEC_TYPE_MPEG4)
+    if (codecType == CODEC_TYPE_MPEG4) {
         SEC_OSAL_Strcpy(pSECComponent->componentName, SEC_OMX_COMPONENT_MPEG4_ENC);
-    else
+        SEC_OSAL_Strcpy(pSECComponent->bufferProcessThreadAttr.name, "SecM4vEnc");
+    } else {
         SEC_OSAL_Strcpy(pSECComponent->componentName, SEC_OMX_COMPONENT_H263_ENC);
+        SEC_OSAL_Strcpy(pSECComponent->bufferProcessThreadAttr.name, "SecH263Enc");
+    }
 
     /* Set componentVersion */
     pSECComponent->componentVersion.s.nVersionMajor = VERSIONMAJOR_NUMBER;
@@ -1387,72 +1537,7 @@ OSCL_EXPORT_REF OMX_ERRORTYPE SEC_OMX_ComponentInit(OMX_HANDLETYPE hComponent, O
     pSECComponent->capabilityFlags.iOMXComponentCanHandleIncompleteFrames         = OMX_TRUE;
     pSECComponent->capabilityFlags.iOMXComponentUsesFullAVCFrames                 = OMX_TRUE;
 
-    /* Input port */
-    pSECPort = &pSECComponent->pSECPort[INPUT_PORT_INDEX];
-    pSECPort->portDefinition.format.video.nFrameWidth = DEFAULT_FRAME_WIDTH;
-    pSECPort->portDefinition.format.video.nFrameHeight= DEFAULT_FRAME_HEIGHT;
-    pSECPort->portDefinition.format.video.nBitrate = 64000;
-    pSECPort->portDefinition.format.video.xFramerate= (15 << 16);
-    pSECPort->portDefinition.format.video.eCompressionFormat = OMX_VIDEO_CodingUnused;
-    pSECPort->portDefinition.format.video.pNativeRender = 0;
-    pSECPort->portDefinition.format.video.bFlagErrorConcealment = OMX_FALSE;
-    SEC_OSAL_Memset(pSECPort->portDefinition.format.video.cMIMEType, 0, MAX_OMX_MIMETYPE_SIZE);
-    SEC_OSAL_Strcpy(pSECPort->portDefinition.format.video.cMIMEType, "raw/video");
-    pSECPort->portDefinition.format.video.eColorFormat = OMX_COLOR_FormatYUV420SemiPlanar;
-    pSECPort->portDefinition.nBufferSize = DEFAULT_VIDEO_INPUT_BUFFER_SIZE;
-    pSECPort->portDefinition.bEnabled = OMX_TRUE;
-
-    /* Output port */
-    pSECPort = &pSECComponent->pSECPort[OUTPUT_PORT_INDEX];
-    pSECPort->portDefinition.format.video.nFrameWidth = DEFAULT_FRAME_WIDTH;
-    pSECPort->portDefinition.format.video.nFrameHeight= DEFAULT_FRAME_HEIGHT;
-    pSECPort->portDefinition.format.video.nBitrate = 64000;
-    pSECPort->portDefinition.format.video.xFramerate= (15 << 16);
-    if (codecType == CODEC_TYPE_MPEG4) {
-        pSECPort->portDefinition.format.video.eCompressionFormat = OMX_VIDEO_CodingMPEG4;
-        SEC_OSAL_Memset(pSECPort->portDefinition.format.video.cMIMEType, 0, MAX_OMX_MIMETYPE_SIZE);
-        SEC_OSAL_Strcpy(pSECPort->portDefinition.format.video.cMIMEType, "video/mpeg4");
-    } else {
-        pSECPort->portDefinition.format.video.eCompressionFormat = OMX_VIDEO_CodingH263;
-        SEC_OSAL_Memset(pSECPort->portDefinition.format.video.cMIMEType, 0, MAX_OMX_MIMETYPE_SIZE);
-        SEC_OSAL_Strcpy(pSECPort->portDefinition.format.video.cMIMEType, "video/h263");
-    }
-    pSECPort->portDefinition.format.video.pNativeRender = 0;
-    pSECPort->portDefinition.format.video.bFlagErrorConcealment = OMX_FALSE;
-    pSECPort->portDefinition.format.video.eColorFormat = OMX_COLOR_FormatUnused;
-    pSECPort->portDefinition.nBufferSize = DEFAULT_VIDEO_OUTPUT_BUFFER_SIZE;
-    pSECPort->portDefinition.bEnabled = OMX_TRUE;
-
-    if (codecType == CODEC_TYPE_MPEG4) {
-        for(i = 0; i < ALL_PORT_NUM; i++) {
-            INIT_SET_SIZE_VERSION(&pMpeg4Enc->mpeg4Component[i], OMX_VIDEO_PARAM_MPEG4TYPE);
-            pMpeg4Enc->mpeg4Component[i].nPortIndex = i;
-            pMpeg4Enc->mpeg4Component[i].eProfile   = OMX_VIDEO_MPEG4ProfileSimple;
-            pMpeg4Enc->mpeg4Component[i].eLevel     = OMX_VIDEO_MPEG4Level4;
-
-            pMpeg4Enc->mpeg4Component[i].nPFrames = 10;
-            pMpeg4Enc->mpeg4Component[i].nBFrames = 0;          /* No support for B frames */
-            pMpeg4Enc->mpeg4Component[i].nMaxPacketSize = 256;  /* Default value */
-            pMpeg4Enc->mpeg4Component[i].nAllowedPictureTypes =  OMX_VIDEO_PictureTypeI | OMX_VIDEO_PictureTypeP;
-            pMpeg4Enc->mpeg4Component[i].bGov = OMX_FALSE;
-
-        }
-    } else {
-        for(i = 0; i < ALL_PORT_NUM; i++) {
-            INIT_SET_SIZE_VERSION(&pMpeg4Enc->h263Component[i], OMX_VIDEO_PARAM_H263TYPE);
-            pMpeg4Enc->h263Component[i].nPortIndex = i;
-            pMpeg4Enc->h263Component[i].eProfile   = OMX_VIDEO_H263ProfileBaseline;
-            pMpeg4Enc->h263Component[i].eLevel     = OMX_VIDEO_H263Level45;
-
-            pMpeg4Enc->h263Component[i].nPFrames = 20;
-            pMpeg4Enc->h263Component[i].nBFrames = 0;          /* No support for B frames */
-            pMpeg4Enc->h263Component[i].bPLUSPTYPEAllowed = OMX_FALSE;
-            pMpeg4Enc->h263Component[i].nAllowedPictureTypes = OMX_VIDEO_PictureTypeI | OMX_VIDEO_PictureTypeP;
-            pMpeg4Enc->h263Component[i].bForceRoundingTypeToZero = OMX_TRUE;
-            pMpeg4Enc->h263Component[i].nPictureHeaderRepetition = 0;
-            pMpeg4Enc->h263Component[i].nGOBHeaderInterval = 0;
-        }
-    }
+    SEC_MFC_Mpeg4Enc_SetDefault(pSECComponent);
 
     pOMXComponent->GetParameter      = &SEC_MFC_Mpeg4Enc_GetParameter;
     pOMXComponent->SetParameter      = &SEC_MFC_Mpeg4Enc_SetParameter;
@@ -1467,6 +1552,9 @@ OSCL_EXPORT_REF OMX_ERRORTYPE SEC_OMX_ComponentInit(OMX_HANDLETYPE hComponent, O
     pSECComponent->sec_mfc_bufferProcess      = &SEC_MFC_Mpeg4Enc_bufferProcess;
     pSECComponent->sec_checkInputFrame        = NULL;
 
+    pSECComponent->sec_mfc_allocateOutputBuffer = &SEC_MFC_Mpeg4Enc_AllocateOutputBuffer;
+    pSECComponent->sec_mfc_releaseOutputBuffer  = &SEC_MFC_Mpeg4Enc_ReleaseOutputBuffer;
+
     pSECComponent->currentState = OMX_StateLoaded;
 
     ret = OMX_ErrorNone;
@@ -1498,6 +1586,11 @@ OMX_ERRORTYPE SEC_OMX_ComponentDeinit(OMX_HANDLETYPE hComponent)
 
     pMpeg4Enc = (SEC_MPEG4ENC_HANDLE *)pSECComponent->hCodecHandle;
     if (pMpeg4Enc != NULL) {
+        /* opened for output port buffers but never initialized */
+        if (pMpeg4Enc->hMFCMpeg4Handle.hMFCHandle != NULL) {
+            SsbSipMfcEncClose(pMpeg4Enc->hMFCMpeg4Handle.hMFCHandle);
+            pMpeg4Enc->hMFCMpeg4Handle.hMFCHandle = NULL;
+        }
         SEC_OSAL_Free(pMpeg4Enc);
         pMpeg4Enc = pSECComponent->hCodecHandle = NULL;
     }
@@ -1514,3 +1607,42 @@ EXIT:
 
     return ret;
 }
+
+/* A Loaded component with no MFC instance back to its defaults, kept by the core for reuse */
+OSCL_EXPORT_REF OMX_ERRORTYPE SEC_OMX_ComponentReset(OMX_HANDLETYPE hComponent)
+{
+    OMX_ERRORTYPE            ret = OMX_ErrorNone;
+    OMX_COMPONENTTYPE       *pOMXComponent = NULL;
+    SEC_OMX_BASECOMPONENT   *pSECComponent = NULL;
+    SEC_MPEG4ENC_HANDLE     *pMpeg4Enc = NULL;
+    CODEC_TYPE               codecType;
+
+    FunctionIn();
+
+    if (hComponent == NULL) {
+        ret = OMX_ErrorBadParameter;
+        goto EXIT;
+    }
+    pOMXComponent = (OMX_COMPONENTTYPE *)hComponent;
+    pSECComponent = (SEC_OMX_BASECOMPONENT *)pOMXComponent->pComponentPrivate;
+    pMpeg4Enc = (SEC_MPEG4ENC_HANDLE *)pSECComponent->hCodecHandle;
+    if ((pMpeg4Enc == NULL) || (pMpeg4Enc->hMFCMpeg4Handle.hMFCHandle != NULL)) {
+        ret = OMX_ErrorIncorrectStateOperation;
+        goto EXIT;
+    }
+
+    ret = SEC_OMX_VideoEncodeComponentReset(pOMXComponent);
+    if (ret != OMX_ErrorNone) {
+        goto EXIT;
+    }
+
+    codecType = pMpeg4Enc->hMFCMpeg4Handle.codecType;
+    SEC_OSAL_Memset(pMpeg4Enc, 0, sizeof(SEC_MPEG4ENC_HANDLE));
+    pMpeg4Enc->hMFCMpeg4Handle.codecType = codecType;
+    SEC_MFC_Mpeg4Enc_SetDefault(pSECComponent);
+
+EXIT:
+    FunctionOut();
+
+    return ret;
+}
@@ -44,7 +44,6 @@ typedef struct _SEC_MFC_MPEG4ENC_HANDLE
     SSBSIP_MFC_ENC_MPEG4_PARAM mpeg4MFCParam;
     SSBSIP_MFC_ENC_H263_PARAM  h263MFCParam;
     SSBSIP_MFC_ENC_INPUT_INFO  inputInfo;
-    OMX_U32                    indexTimestamp;
     OMX_BOOL                   bConfiguredMFC;
     CODEC_TYPE                 codecType;
     OMX_S32                    returnCodec;
@@ -65,6 +64,7 @@ typedef struct _SEC_MPEG4ENC_HANDLE
     OMX_BOOL bFirstFrame;
     MFC_ENC_INPUT_BUFFER MFCEncInputBuffer[MFC_INPUT_BUFFER_NUM_MAX];
     OMX_U32  indexInputBuffer;
+    MFC_ENC_CLIENT_BUFFER MFCEncClientBuffer;
 } SEC_MPEG4ENC_HANDLE;
 
 
@@ -75,6 +75,7 @@ extern "C" {
 
 OSCL_EXPORT_REF OMX_ERRORTYPE SEC_OMX_ComponentInit(OMX_HANDLETYPE hComponent, OMX_STRING componentName);
                 OMX_ERRORTYPE SEC_OMX_ComponentDeinit(OMX_HANDLETYPE hComponent);
+OSCL_EXPORT_REF OMX_ERRORTYPE SEC_OMX_ComponentReset(OMX_HANDLETYPE hComponent);
 
 #ifdef __cplusplus
 };
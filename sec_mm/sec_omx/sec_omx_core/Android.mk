@@ -14,7 +14,7 @@ LOCAL_CFLAGS :=
 LOCAL_ARM_MODE := arm
 
 LOCAL_STATIC_LIBRARIES := libsecosal.aries libsecbasecomponent.aries
-LOCAL_SHARED_LIBRARIES := libc libdl libcutils libutils
+LOCAL_SHARED_LIBRARIES := libSEC_OMX_Resourcemanager.aries libc libdl libcutils libutils
 
 LOCAL_C_INCLUDES := $(SEC_OMX_INC)/khronos \
 	$(SEC_OMX_INC)/sec \
@@ -23,3 +23,79 @@ LOCAL_C_INCLUDES := $(SEC_OMX_INC)/khronos \
 
 include $(BUILD_SHARED_LIBRARY)
 
+
+#########################################################################
+# Build end-to-end decode benchmark
+#########################################################################
+
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES := SEC_OMX_DecBench.c
+
+LOCAL_MODULE := sec_omx_dec_bench
+
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_CFLAGS :=
+
+LOCAL_STATIC_LIBRARIES := libsecosal.aries
+LOCAL_SHARED_LIBRARIES := libSEC_OMX_Core.aries libc libdl libcutils libutils
+
+LOCAL_C_INCLUDES := $(SEC_OMX_INC)/khronos \
+	$(SEC_OMX_INC)/sec \
+	$(SEC_OMX_TOP)/sec_osal \
+	$(SEC_OMX_TOP)/sec_omx_core
+
+include $(BUILD_EXECUTABLE)
+
+#########################################################################
+# Build IL core and decode benchmark for host, on the MFC simulator
+#########################################################################
+
+include $(CLEAR_VARS)
+
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_SRC_FILES := SEC_OMX_Component_Register.c \
+	SEC_OMX_Core.c
+
+LOCAL_MODULE := libSEC_OMX_Core_host
+
+# the components are found through secomxregistry_host in this directory
+LOCAL_CFLAGS := -DUSE_MFC_SIM \
+	-DREGISTRY_PATH=\"$(abspath $(LOCAL_PATH))/\" \
+	-DREGISTRY_FILENAME=\"secomxregistry_host\"
+
+LOCAL_STATIC_LIBRARIES := libsecosal_host libsecbasecomponent_host libcutils liblog
+LOCAL_SHARED_LIBRARIES := libSEC_OMX_Resourcemanager_host
+
+LOCAL_LDLIBS := -lpthread -ldl -lrt
+
+LOCAL_C_INCLUDES := $(SEC_OMX_INC)/khronos \
+	$(SEC_OMX_INC)/sec \
+	$(SEC_OMX_TOP)/sec_osal \
+	$(SEC_OMX_TOP)/sec_omx_component/common
+
+include $(BUILD_HOST_SHARED_LIBRARY)
+
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES := SEC_OMX_DecBench.c
+
+LOCAL_MODULE := sec_omx_dec_bench_host
+
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_CFLAGS := -DUSE_MFC_SIM
+
+LOCAL_STATIC_LIBRARIES := libsecosal_host libcutils liblog
+LOCAL_SHARED_LIBRARIES := libSEC_OMX_Core_host libSEC_OMX_Resourcemanager_host
+
+LOCAL_LDLIBS := -lpthread -ldl -lrt
+
+LOCAL_C_INCLUDES := $(SEC_OMX_INC)/khronos \
+	$(SEC_OMX_INC)/sec \
+	$(SEC_OMX_TOP)/sec_osal \
+	$(SEC_OMX_TOP)/sec_omx_core
+
+include $(BUILD_HOST_EXECUTABLE)
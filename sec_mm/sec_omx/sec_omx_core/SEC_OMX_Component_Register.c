@@ -45,94 +45,201 @@
 #include "SEC_OSAL_Log.h"
 
 
+/* the host build names a registry of its own, with the libraries built for host */
+#ifndef REGISTRY_PATH
+#define REGISTRY_PATH     "/system/etc/"
+#endif
+#ifndef REGISTRY_FILENAME
 #define REGISTRY_FILENAME "secomxregistry"
+#endif
+#define REGISTRY_DELIMITER " \t\r"
 
+/*
+ * Registry file format, one component per line:
+ *
+ *   libName componentName role[,role...] [profile:level[,profile:level...]]
+ *
+ * Lines in full are registered as they are, the library is opened only when
+ * the component is loaded. A line with the library name alone is the old
+ * format: the library is opened to ask SEC_OMX_COMPONENT_Library_Register
+ * for its components. Lines starting with '#' are comments.
+ */
+
+static int SEC_OMX_Component_Scan(OMX_STRING libName, SEC_OMX_COMPONENT_REGLIST *componentList, int totalCompNum)
+{
+    int            componentNum = 0;
+    OMX_HANDLETYPE soHandle;
+    const char    *errorMsg;
+    int (*SEC_OMX_COMPONENT_Library_Register)(SECRegisterComponentType **secComponents);
+    SECRegisterComponentType **secComponentsTemp;
+
+    if ((soHandle = SEC_OSAL_dlopen(libName, RTLD_NOW)) != NULL) {
+        SEC_OSAL_dlerror();    /* clear error*/
+        if ((SEC_OMX_COMPONENT_Library_Register = SEC_OSAL_dlsym(soHandle, "SEC_OMX_COMPONENT_Library_Register")) != NULL) {
+            int i = 0, j = 0;
+
+            componentNum = (*SEC_OMX_COMPONENT_Library_Register)(NULL);
+            secComponentsTemp = (SECRegisterComponentType **)SEC_OSAL_Malloc(sizeof(SECRegisterComponentType*) * componentNum);
+            for (i = 0; i < componentNum; i++) {
+                secComponentsTemp[i] = SEC_OSAL_Malloc(sizeof(SECRegisterComponentType));
+                SEC_OSAL_Memset(secComponentsTemp[i], 0, sizeof(SECRegisterComponentType));
+            }
+            (*SEC_OMX_COMPONENT_Library_Register)(secComponentsTemp);
+
+            for (i = 0; (i < componentNum) && (totalCompNum < MAX_OMX_COMPONENT_NUM); i++) {
+                SEC_OSAL_Strcpy(componentList[totalCompNum].component.componentName, secComponentsTemp[i]->componentName);
+                for (j = 0; j < secComponentsTemp[i]->totalRoleNum; j++)
+                    SEC_OSAL_Strcpy(componentList[totalCompNum].component.roles[j], secComponentsTemp[i]->roles[j]);
+                componentList[totalCompNum].component.totalRoleNum = secComponentsTemp[i]->totalRoleNum;
+
+                SEC_OSAL_Strcpy(componentList[totalCompNum].libName, libName);
+
+                totalCompNum++;
+            }
+            for (i = 0; i < componentNum; i++) {
+                SEC_OSAL_Free(secComponentsTemp[i]);
+            }
+
+            SEC_OSAL_Free(secComponentsTemp);
+        } else {
+            if ((errorMsg = SEC_OSAL_dlerror()) != NULL)
+                SEC_OSAL_Log(SEC_LOG_WARNING, "dlsym failed: %s", errorMsg);
+        }
+        SEC_OSAL_dlclose(soHandle);
+    } else {
+        SEC_OSAL_Log(SEC_LOG_WARNING, "dlopen failed: %s", SEC_OSAL_dlerror());
+    }
+
+    return totalCompNum;
+}
+
+static OMX_BOOL SEC_OMX_Component_Parse(char *line, SEC_OMX_COMPONENT_REGLIST *component)
+{
+    char *token, *item;
+    char *lineSave = NULL, *itemSave = NULL;
+    char *end;
+
+    token = strtok_r(line, REGISTRY_DELIMITER, &lineSave);
+    if ((token == NULL) || (SEC_OSAL_Strlen(token) >= MAX_OMX_COMPONENT_NAME_SIZE))
+        return OMX_FALSE;
+    SEC_OSAL_Strcpy(component->component.componentName, token);
+
+    token = strtok_r(NULL, REGISTRY_DELIMITER, &lineSave);
+    if (token == NULL)
+        return OMX_FALSE;
+    for (item = strtok_r(token, ",", &itemSave); item != NULL; item = strtok_r(NULL, ",", &itemSave)) {
+        if ((component->component.totalRoleNum >= MAX_OMX_COMPONENT_ROLE_NUM) ||
+            (SEC_OSAL_Strlen(item) >= MAX_OMX_COMPONENT_ROLE_SIZE))
+            return OMX_FALSE;
+        SEC_OSAL_Strcpy(component->component.roles[component->component.totalRoleNum], item);
+        component->component.totalRoleNum++;
+    }
+
+    token = strtok_r(NULL, REGISTRY_DELIMITER, &lineSave);
+    if (token == NULL)
+        return OMX_TRUE;
+    for (item = strtok_r(token, ",", &itemSave); item != NULL; item = strtok_r(NULL, ",", &itemSave)) {
+        SEC_OMX_VIDEO_PROFILELEVEL *pProfileLevel;
+
+        if (component->totalProfileLevelNum >= MAX_OMX_COMPONENT_PROFILELEVEL_NUM)
+            return OMX_FALSE;
+        pProfileLevel = &component->profileLevel[component->totalProfileLevelNum];
+        pProfileLevel->profile = strtoul(item, &end, 0);
+        if (*end != ':')
+            return OMX_FALSE;
+        pProfileLevel->level = strtoul(end + 1, &end, 0);
+        if (*end != '\0')
+            return OMX_FALSE;
+        component->totalProfileLevelNum++;
+    }
+
+    return OMX_TRUE;
+}
 
 OMX_ERRORTYPE SEC_OMX_Component_Register(SEC_OMX_COMPONENT_REGLIST **compList, OMX_U32 *compNum)
 {
     OMX_ERRORTYPE  ret = OMX_ErrorNone;
-    int            componentNum = 0, roleNum = 0, totalCompNum = 0;
-    int            read;
+    int            totalCompNum = 0;
     char          *omxregistryfile = NULL;
-    char          *line = NULL;
+    char          *registry = NULL;
+    char          *line, *next;
     char          *libName;
     FILE          *omxregistryfp;
-    size_t         len;
-    OMX_HANDLETYPE soHandle;
-    const char    *errorMsg;
-    int (*SEC_OMX_COMPONENT_Library_Register)(SECRegisterComponentType **secComponents);
-    SECRegisterComponentType **secComponentsTemp;
+    long           size;
     SEC_OMX_COMPONENT_REGLIST *componentList;
 
     FunctionIn();
 
-    omxregistryfile = SEC_OSAL_Malloc(strlen("/system/etc/") + strlen(REGISTRY_FILENAME) + 2);
-    SEC_OSAL_Strcpy(omxregistryfile, "/system/etc/");
+    omxregistryfile = SEC_OSAL_Malloc(strlen(REGISTRY_PATH) + strlen(REGISTRY_FILENAME) + 2);
+    SEC_OSAL_Strcpy(omxregistryfile, REGISTRY_PATH);
     SEC_OSAL_Strcat(omxregistryfile, REGISTRY_FILENAME);
 
     omxregistryfp = fopen(omxregistryfile, "r");
+    SEC_OSAL_Free(omxregistryfile);
     if (omxregistryfp == NULL) {
         ret = OMX_ErrorUndefined;
         goto EXIT;
     }
-    SEC_OSAL_Free(omxregistryfile);
 
-    fseek(omxregistryfp, 0, 0);
+    /* the whole registry in one read */
+    fseek(omxregistryfp, 0, SEEK_END);
+    size = ftell(omxregistryfp);
+    fseek(omxregistryfp, 0, SEEK_SET);
+    if (size < 0) {
+        fclose(omxregistryfp);
+        ret = OMX_ErrorUndefined;
+        goto EXIT;
+    }
+    registry = SEC_OSAL_Malloc(size + 1);
+    if (registry == NULL) {
+        fclose(omxregistryfp);
+        ret = OMX_ErrorInsufficientResources;
+        goto EXIT;
+    }
+    size = fread(registry, 1, size, omxregistryfp);
+    registry[size] = '\0';
+    fclose(omxregistryfp);
+
     componentList = (SEC_OMX_COMPONENT_REGLIST *)SEC_OSAL_Malloc(sizeof(SEC_OMX_COMPONENT_REGLIST) * MAX_OMX_COMPONENT_NUM);
     SEC_OSAL_Memset(componentList, 0, sizeof(SEC_OMX_COMPONENT_REGLIST) * MAX_OMX_COMPONENT_NUM);
-    libName = SEC_OSAL_Malloc(MAX_OMX_COMPONENT_LIBNAME_SIZE);
-
-    while ((read = getline(&line, &len, omxregistryfp)) != -1) {
-        if ((*line == 'l') && (*(line + 1) == 'i') && (*(line + 2) == 'b') &&
-            (*(line + 3) == 'O') && (*(line + 4) == 'M') && (*(line + 5) == 'X')) {
-            SEC_OSAL_Memset(libName, 0, MAX_OMX_COMPONENT_LIBNAME_SIZE);
-            SEC_OSAL_Strncpy(libName, line, SEC_OSAL_Strlen(line)-1);
-            SEC_OSAL_Log(SEC_LOG_TRACE, "libName : %s", libName);
-
-            if ((soHandle = SEC_OSAL_dlopen(libName, RTLD_NOW)) != NULL) {
-                SEC_OSAL_dlerror();    /* clear error*/
-                if ((SEC_OMX_COMPONENT_Library_Register = SEC_OSAL_dlsym(soHandle, "SEC_OMX_COMPONENT_Library_Register")) != NULL) {
-                    int i = 0, j = 0;
-
-                    componentNum = (*SEC_OMX_COMPONENT_Library_Register)(NULL);
-                    secComponentsTemp = (SECRegisterComponentType **)SEC_OSAL_Malloc(sizeof(SECRegisterComponentType*) * componentNum);
-                    for (i = 0; i < componentNum; i++) {
-                        secComponentsTemp[i] = SEC_OSAL_Malloc(sizeof(SECRegisterComponentType));
-                        SEC_OSAL_Memset(secComponentsTemp[i], 0, sizeof(SECRegisterComponentType));
-                    }
-                    (*SEC_OMX_COMPONENT_Library_Register)(secComponentsTemp);
-
-                    for (i = 0; i < componentNum; i++) {
-                        SEC_OSAL_Strcpy(componentList[totalCompNum].component.componentName, secComponentsTemp[i]->componentName);
-                        for (j = 0; j < secComponentsTemp[i]->totalRoleNum; j++)
-                            SEC_OSAL_Strcpy(componentList[totalCompNum].component.roles[j], secComponentsTemp[i]->roles[j]);
-                        componentList[totalCompNum].component.totalRoleNum = secComponentsTemp[i]->totalRoleNum;
-
-                        SEC_OSAL_Strcpy(componentList[totalCompNum].libName, libName);
-
-                        totalCompNum++;
-                    }
-                    for (i = 0; i < componentNum; i++) {
-                        SEC_OSAL_Free(secComponentsTemp[i]);
-                    }
-
-                    SEC_OSAL_Free(secComponentsTemp);
-                } else {
-                    if ((errorMsg = SEC_OSAL_dlerror()) != NULL)
-                        SEC_OSAL_Log(SEC_LOG_WARNING, "dlsym failed: %s", errorMsg);
-                }
-                SEC_OSAL_dlclose(soHandle);
-            } else {
-                SEC_OSAL_Log(SEC_LOG_WARNING, "dlopen failed: %s", SEC_OSAL_dlerror());
-            }
-        } else {
-            /* not a component name line. skip */
+
+    for (line = registry; (line != NULL) && (totalCompNum < MAX_OMX_COMPONENT_NUM); line = next) {
+        char *rest;
+
+        next = strchr(line, '\n');
+        if (next != NULL)
+            *next++ = '\0';
+
+        line += strspn(line, REGISTRY_DELIMITER);
+        if (strncmp(line, "libOMX", 6) != 0) {
+            /* not a component line. skip */
+            continue;
+        }
+
+        libName = line;
+        rest = line + strcspn(line, REGISTRY_DELIMITER);
+        if (*rest != '\0')
+            *rest++ = '\0';
+        rest += strspn(rest, REGISTRY_DELIMITER);
+        if (SEC_OSAL_Strlen(libName) >= MAX_OMX_COMPONENT_LIBNAME_SIZE)
+            continue;
+        SEC_OSAL_Log(SEC_LOG_TRACE, "libName : %s", libName);
+
+        if (*rest == '\0') {
+            totalCompNum = SEC_OMX_Component_Scan(libName, componentList, totalCompNum);
             continue;
         }
+
+        if (SEC_OMX_Component_Parse(rest, &componentList[totalCompNum]) != OMX_TRUE) {
+            SEC_OSAL_Log(SEC_LOG_WARNING, "bad registry entry of %s", libName);
+            SEC_OSAL_Memset(&componentList[totalCompNum], 0, sizeof(SEC_OMX_COMPONENT_REGLIST));
+            continue;
+        }
+        SEC_OSAL_Strcpy(componentList[totalCompNum].libName, libName);
+        totalCompNum++;
     }
 
-    SEC_OSAL_Free(libName);
-    fclose(omxregistryfp);
+    SEC_OSAL_Free(registry);
 
     *compList = componentList;
     *compNum = totalCompNum;
@@ -229,6 +336,7 @@ OMX_ERRORTYPE SEC_OMX_ComponentLoad(SEC_OMX_COMPONENT *sec_component)
         }
         sec_component->libHandle = libHandle;
         sec_component->pOMXComponent = pOMXComponent;
+        sec_component->componentReset = SEC_OSAL_dlsym(libHandle, "SEC_OMX_ComponentReset");
         ret = OMX_ErrorNone;
     }
 
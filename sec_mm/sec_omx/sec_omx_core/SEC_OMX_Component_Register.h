@@ -44,6 +44,9 @@ typedef struct _SEC_OMX_COMPONENT_REGLIST
 {
     SECRegisterComponentType component;
     OMX_U8  libName[MAX_OMX_COMPONENT_LIBNAME_SIZE];
+    /* highest level of each profile, only known for components listed in full */
+    SEC_OMX_VIDEO_PROFILELEVEL profileLevel[MAX_OMX_COMPONENT_PROFILELEVEL_NUM];
+    OMX_U32 totalProfileLevelNum;
 } SEC_OMX_COMPONENT_REGLIST;
 
 struct SEC_OMX_COMPONENT;
@@ -53,6 +56,8 @@ typedef struct _SEC_OMX_COMPONENT
     OMX_U8                    libName[MAX_OMX_COMPONENT_LIBNAME_SIZE];
     OMX_HANDLETYPE            libHandle;
     OMX_COMPONENTTYPE        *pOMXComponent;
+    /* SEC_OMX_ComponentReset of the library, NULL if the component can not be reused */
+    OMX_ERRORTYPE           (*componentReset)(OMX_HANDLETYPE hComponent);
     struct SEC_OMX_COMPONENT *nextOMXComp;
 } SEC_OMX_COMPONENT;
 
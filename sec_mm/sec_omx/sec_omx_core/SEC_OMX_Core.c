@@ -47,6 +47,85 @@ static int gComponentNum = 0;
 static SEC_OMX_COMPONENT_REGLIST *gComponentList = NULL;
 static SEC_OMX_COMPONENT *gLoadComponentList = NULL;
 static OMX_HANDLETYPE ghLoadComponentListMutex = NULL;
+/* Freed components in Loaded state, library still open, protected by ghLoadComponentListMutex */
+static SEC_OMX_COMPONENT *gIdleComponentList = NULL;
+static int gIdleComponentNum = 0;
+
+/*
+ * Keep a freed component for the next GetHandle of the same name instead of
+ * closing its library. Only a component in Loaded state whose library
+ * provides SEC_OMX_ComponentReset is kept, the reset drops everything left
+ * by the previous client.
+ */
+static OMX_ERRORTYPE SEC_OMX_IdleComponentPut(SEC_OMX_COMPONENT *component)
+{
+    OMX_ERRORTYPE ret = OMX_ErrorNone;
+    OMX_STATETYPE state = OMX_StateInvalid;
+
+    if ((MAX_OMX_IDLE_COMPONENT_NUM <= 0) || (component->componentReset == NULL)) {
+        ret = OMX_ErrorNotImplemented;
+        goto EXIT;
+    }
+
+    SEC_OSAL_MutexLock(ghLoadComponentListMutex);
+    if (gIdleComponentNum >= MAX_OMX_IDLE_COMPONENT_NUM) {
+        SEC_OSAL_MutexUnlock(ghLoadComponentListMutex);
+        ret = OMX_ErrorInsufficientResources;
+        goto EXIT;
+    }
+    SEC_OSAL_MutexUnlock(ghLoadComponentListMutex);
+
+    ret = component->pOMXComponent->GetState(component->pOMXComponent, &state);
+    if ((ret != OMX_ErrorNone) || (state != OMX_StateLoaded)) {
+        ret = OMX_ErrorIncorrectStateOperation;
+        goto EXIT;
+    }
+
+    ret = component->componentReset(component->pOMXComponent);
+    if (ret != OMX_ErrorNone)
+        goto EXIT;
+
+    SEC_OSAL_MutexLock(ghLoadComponentListMutex);
+    if (gIdleComponentNum >= MAX_OMX_IDLE_COMPONENT_NUM) {
+        SEC_OSAL_MutexUnlock(ghLoadComponentListMutex);
+        ret = OMX_ErrorInsufficientResources;
+        goto EXIT;
+    }
+    component->nextOMXComp = gIdleComponentList;
+    gIdleComponentList = component;
+    gIdleComponentNum++;
+    SEC_OSAL_MutexUnlock(ghLoadComponentListMutex);
+
+    SEC_OSAL_Log(SEC_LOG_TRACE, "kept %s for reuse, %d idle", component->componentName, gIdleComponentNum);
+
+EXIT:
+    return ret;
+}
+
+static SEC_OMX_COMPONENT *SEC_OMX_IdleComponentGet(OMX_STRING cComponentName)
+{
+    SEC_OMX_COMPONENT *component = NULL;
+    SEC_OMX_COMPONENT *prevComponent = NULL;
+
+    SEC_OSAL_MutexLock(ghLoadComponentListMutex);
+    component = gIdleComponentList;
+    while (component != NULL) {
+        if (SEC_OSAL_Strcmp(component->componentName, cComponentName) == 0) {
+            if (prevComponent == NULL)
+                gIdleComponentList = component->nextOMXComp;
+            else
+                prevComponent->nextOMXComp = component->nextOMXComp;
+            component->nextOMXComp = NULL;
+            gIdleComponentNum--;
+            break;
+        }
+        prevComponent = component;
+        component = component->nextOMXComp;
+    }
+    SEC_OSAL_MutexUnlock(ghLoadComponentListMutex);
+
+    return component;
+}
 
 
 OMX_API OMX_ERRORTYPE OMX_APIENTRY SEC_OMX_Init(void)
@@ -82,6 +161,14 @@ OMX_API OMX_ERRORTYPE OMX_APIENTRY SEC_OMX_Deinit(void)
 
     FunctionIn();
 
+    while (gIdleComponentList != NULL) {
+        SEC_OMX_COMPONENT *idleComponent = gIdleComponentList;
+        gIdleComponentList = idleComponent->nextOMXComp;
+        SEC_OMX_ComponentUnload(idleComponent);
+        SEC_OSAL_Free(idleComponent);
+    }
+    gIdleComponentNum = 0;
+
     SEC_OSAL_MutexTerminate(ghLoadComponentListMutex);
     ghLoadComponentListMutex = NULL;
 
@@ -150,16 +237,19 @@ OMX_API OMX_ERRORTYPE OMX_APIENTRY SEC_OMX_GetHandle(
 
     for (i = 0; i < gComponentNum; i++) {
         if (SEC_OSAL_Strcmp(cComponentName, gComponentList[i].component.componentName) == 0) {
-            loadComponent = SEC_OSAL_Malloc(sizeof(SEC_OMX_COMPONENT));
-            SEC_OSAL_Memset(loadComponent, 0, sizeof(SEC_OMX_COMPONENT));
-
-            SEC_OSAL_Strcpy(loadComponent->libName, gComponentList[i].libName);
-            SEC_OSAL_Strcpy(loadComponent->componentName, gComponentList[i].component.componentName);
-            ret = SEC_OMX_ComponentLoad(loadComponent);
-            if (ret != OMX_ErrorNone) {
-                SEC_OSAL_Free(loadComponent);
-                SEC_OSAL_Log(SEC_LOG_ERROR, "OMX_Error, Line:%d", __LINE__);
-                goto EXIT;
+            loadComponent = SEC_OMX_IdleComponentGet(cComponentName);
+            if (loadComponent == NULL) {
+                loadComponent = SEC_OSAL_Malloc(sizeof(SEC_OMX_COMPONENT));
+                SEC_OSAL_Memset(loadComponent, 0, sizeof(SEC_OMX_COMPONENT));
+
+                SEC_OSAL_Strcpy(loadComponent->libName, gComponentList[i].libName);
+                SEC_OSAL_Strcpy(loadComponent->componentName, gComponentList[i].component.componentName);
+                ret = SEC_OMX_ComponentLoad(loadComponent);
+                if (ret != OMX_ErrorNone) {
+                    SEC_OSAL_Free(loadComponent);
+                    SEC_OSAL_Log(SEC_LOG_ERROR, "OMX_Error, Line:%d", __LINE__);
+                    goto EXIT;
+                }
             }
 
             ret = loadComponent->pOMXComponent->SetCallbacks(loadComponent->pOMXComponent, pCallBacks, pAppData);
@@ -235,8 +325,11 @@ OMX_API OMX_ERRORTYPE OMX_APIENTRY SEC_OMX_FreeHandle(OMX_IN OMX_HANDLETYPE hCom
     }
     SEC_OSAL_MutexUnlock(ghLoadComponentListMutex);
 
-    SEC_OMX_ComponentUnload(deleteComponent);
-    SEC_OSAL_Free(deleteComponent);
+    deleteComponent->nextOMXComp = NULL;
+    if (SEC_OMX_IdleComponentPut(deleteComponent) != OMX_ErrorNone) {
+        SEC_OMX_ComponentUnload(deleteComponent);
+        SEC_OSAL_Free(deleteComponent);
+    }
 
 EXIT:
     FunctionOut();
@@ -352,3 +445,47 @@ EXIT:
 
     return ret;
 }
+
+/*
+ * Highest level of each profile the component supports, as listed in the
+ * registry, without loading the component. *pNumProfileLevels is 0 for a
+ * component registered from its library.
+ */
+OMX_API OMX_ERRORTYPE SEC_OMX_GetProfileLevelsOfComponent (
+    OMX_IN    OMX_STRING compName,
+    OMX_INOUT OMX_U32 *pNumProfileLevels,
+    OMX_OUT   SEC_OMX_VIDEO_PROFILELEVEL *profileLevels)
+{
+    OMX_ERRORTYPE ret = OMX_ErrorComponentNotFound;
+    int i = 0;
+
+    FunctionIn();
+
+    if (gInitialized != 1) {
+        ret = OMX_ErrorNotReady;
+        goto EXIT;
+    }
+
+    if ((compName == NULL) || (pNumProfileLevels == NULL)) {
+        ret = OMX_ErrorBadParameter;
+        goto EXIT;
+    }
+
+    *pNumProfileLevels = 0;
+    for (i = 0; i < gComponentNum; i++) {
+        if (SEC_OSAL_Strcmp(gComponentList[i].component.componentName, compName) == 0) {
+            *pNumProfileLevels = gComponentList[i].totalProfileLevelNum;
+            if (profileLevels != NULL) {
+                SEC_OSAL_Memcpy(profileLevels, gComponentList[i].profileLevel,
+                                sizeof(SEC_OMX_VIDEO_PROFILELEVEL) * gComponentList[i].totalProfileLevelNum);
+            }
+            ret = OMX_ErrorNone;
+            break;
+        }
+    }
+
+EXIT:
+    FunctionOut();
+
+    return ret;
+}
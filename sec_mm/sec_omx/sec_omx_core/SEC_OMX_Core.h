@@ -68,6 +68,10 @@ SEC_EXPORT_REF OMX_API OMX_ERRORTYPE              SEC_OMX_GetRolesOfComponent(
     OMX_IN    OMX_STRING        compName,
     OMX_INOUT OMX_U32          *pNumRoles,
     OMX_OUT   OMX_U8          **roles);
+SEC_EXPORT_REF OMX_API OMX_ERRORTYPE              SEC_OMX_GetProfileLevelsOfComponent(
+    OMX_IN    OMX_STRING        compName,
+    OMX_INOUT OMX_U32          *pNumProfileLevels,
+    OMX_OUT   SEC_OMX_VIDEO_PROFILELEVEL *profileLevels);
 
 
 #ifdef __cplusplus
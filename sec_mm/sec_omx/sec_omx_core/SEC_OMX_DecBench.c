@@ -0,0 +1,951 @@
+/*
+ *
+ * Copyright 2010 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file        SEC_OMX_DecBench.c
+ * @brief       End-to-end decode benchmark through the SEC OMX IL core
+ *   Loads a decoder with SEC_OMX_GetHandle, takes it Loaded -> Idle ->
+ *   Executing, feeds an elementary stream one frame per EmptyThisBuffer
+ *   (codec config first, OMX_BUFFERFLAG_CODECCONFIG), follows output port
+ *   settings changes with a port disable/enable, and takes it back to
+ *   Loaded after EOS. Reports
+ *   - decode fps, first EmptyThisBuffer to last FillBufferDone
+ *   - frame latency percentiles, EmptyThisBuffer to the FillBufferDone
+ *     carrying the same timestamp
+ *   - buffers held by the component, sampled at every EmptyThisBuffer
+ *   - CPU time of every thread of the process, sampled at EOS
+ *   - the component stage statistics (OMX.SEC.index.Statistics)
+ *   usage: sec_omx_dec_bench [-c component] [-n frames] [-f fps]
+ *                            [-i inbufs] [-o outbufs] [-w out.yuv] stream
+ *   The component is guessed from the file extension if -c is not given:
+ *   .264/.h264/.avc, .m4v/.cmp/.mp4v, .263/.h263.
+ * @version     1.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <dirent.h>
+
+#include "OMX_Component.h"
+#include "SEC_OMX_Def.h"
+#include "SEC_OMX_Core.h"
+#include "SEC_OSAL_Event.h"
+#include "SEC_OSAL_Mutex.h"
+#include "SEC_OSAL_Queue.h"
+#include "SEC_OSAL_Thread.h"
+
+#define DECBENCH_H264_COMPONENT     "OMX.SEC.AVC.Decoder"
+#define DECBENCH_MPEG4_COMPONENT    "OMX.SEC.MPEG4.Decoder"
+#define DECBENCH_H263_COMPONENT     "OMX.SEC.H263.Decoder"
+
+#define DECBENCH_INPUT_PORT         0
+#define DECBENCH_OUTPUT_PORT        1
+
+#define DECBENCH_DEFAULT_FPS        30
+#define DECBENCH_MAX_BUFFER_NUM     20
+#define DECBENCH_STALL_TIMEOUT_MS   5000
+#define DECBENCH_MAX_THREAD_NUM     64
+#define DECBENCH_CMD_NUM            (OMX_CommandMarkBuffer + 1)
+#define DECBENCH_CMD_DATA_NUM       8   /* states and port indexes */
+
+typedef enum _DECBENCH_CODEC
+{
+    DECBENCH_CODEC_H264 = 0,
+    DECBENCH_CODEC_MPEG4,
+    DECBENCH_CODEC_H263
+} DECBENCH_CODEC;
+
+/* one EmptyThisBuffer worth of stream */
+typedef struct _DECBENCH_FRAME
+{
+    OMX_U32  offset;
+    OMX_U32  size;
+    OMX_BOOL bConfig;
+    OMX_U64  emptyTimeUs;      /* 0 until sent */
+} DECBENCH_FRAME;
+
+typedef struct _DECBENCH_THREAD_CPU
+{
+    int  tid;
+    char name[SEC_OSAL_THREAD_NAME_SIZE + 2];
+    long userTicks;
+    long sysTicks;
+} DECBENCH_THREAD_CPU;
+
+typedef struct _DECBENCH
+{
+    OMX_HANDLETYPE        hComponent;
+    OMX_STRING            componentName;
+    DECBENCH_CODEC        codec;
+
+    OMX_U8               *stream;
+    OMX_U32               streamSize;
+    DECBENCH_FRAME       *frame;
+    OMX_U32               frameNum;     /* including codec config */
+    OMX_U32               nextFrame;
+    OMX_U32               frameDurationUs;
+
+    OMX_BUFFERHEADERTYPE *inBuffer[DECBENCH_MAX_BUFFER_NUM];
+    OMX_U32               inBufferNum;
+    OMX_BUFFERHEADERTYPE *outBuffer[DECBENCH_MAX_BUFFER_NUM];
+    OMX_U32               outBufferNum;
+    OMX_U32               inBufferReq;  /* 0 for the component default */
+    OMX_U32               outBufferReq;
+
+    /* filled by the callbacks, drained by the main thread */
+    SEC_QUEUE             inFreeQ;
+    SEC_QUEUE             outDoneQ;
+    OMX_HANDLETYPE        hWake;
+    OMX_HANDLETYPE        hCmdDone;
+    OMX_HANDLETYPE        hMutex;
+    OMX_U32               cmdDone[DECBENCH_CMD_NUM][DECBENCH_CMD_DATA_NUM]; /* completions not waited for yet */
+    OMX_ERRORTYPE         error;
+    OMX_BOOL              bPortChanged;
+
+    /* owned by the component, under hMutex */
+    OMX_U32               inHeld;
+    OMX_U32               outHeld;
+    OMX_U64               inHeldSum;
+    OMX_U64               outHeldSum;
+    OMX_U32               inHeldMax;
+    OMX_U32               outHeldMax;
+    OMX_U32               heldSamples;
+
+    OMX_U32               framesOut;
+    OMX_U32               maxFrames;    /* 0 for the whole stream */
+    OMX_U32              *latencyUs;
+    OMX_U32               latencyNum;
+    OMX_U64               firstEmptyUs;
+    OMX_U64               firstFillUs;
+    OMX_U64               lastFillUs;
+    OMX_BOOL              bEOS;
+    OMX_U32               reconfigNum;
+    FILE                 *outFile;
+} DECBENCH;
+
+static void DecBench_InitHeader(OMX_PTR pStruct, OMX_U32 nSize)
+{
+    OMX_VERSIONTYPE *pVersion = (OMX_VERSIONTYPE *)((OMX_U8 *)pStruct + sizeof(OMX_U32));
+
+    memset(pStruct, 0, nSize);
+    *(OMX_U32 *)pStruct = nSize;
+    pVersion->s.nVersionMajor = VERSIONMAJOR_NUMBER;
+    pVersion->s.nVersionMinor = VERSIONMINOR_NUMBER;
+    pVersion->s.nRevision = REVISION_NUMBER;
+    pVersion->s.nStep = STEP_NUMBER;
+}
+
+/* offset of the next 00 00 01 at or after pos, size if none */
+static OMX_U32 DecBench_NextStartCode(const OMX_U8 *buf, OMX_U32 size, OMX_U32 pos)
+{
+    for (; pos + 3 <= size; pos++) {
+        if ((buf[pos] == 0) && (buf[pos + 1] == 0) && (buf[pos + 2] == 1))
+            return pos;
+    }
+
+    return size;
+}
+
+static OMX_ERRORTYPE DecBench_AddFrame(DECBENCH *pBench, OMX_U32 offset, OMX_U32 end, OMX_BOOL bConfig)
+{
+    DECBENCH_FRAME *frame;
+
+    if (end <= offset)
+        return OMX_ErrorNone;
+
+    if ((pBench->frameNum & 255) == 0) {
+        frame = realloc(pBench->frame, (pBench->frameNum + 256) * sizeof(DECBENCH_FRAME));
+        if (frame == NULL)
+            return OMX_ErrorInsufficientResources;
+        pBench->frame = frame;
+    }
+
+    frame = &pBench->frame[pBench->frameNum++];
+    frame->offset = offset;
+    frame->size = end - offset;
+    frame->bConfig = bConfig;
+    frame->emptyTimeUs = 0;
+
+    return OMX_ErrorNone;
+}
+
+/*
+ * Splits the stream into frames as a demuxer would hand them over: for
+ * H.264 one access unit each, with the parameter sets before the first
+ * slice as codec config; for MPEG-4 one VOP each, headers before the
+ * first VOP as codec config; for H.263 one picture each.
+ */
+static OMX_ERRORTYPE DecBench_SplitFrames(DECBENCH *pBench)
+{
+    const OMX_U8 *buf = pBench->stream;
+    OMX_U32       size = pBench->streamSize;
+    OMX_U32       frameStart = 0;
+    OMX_BOOL      bConfig = OMX_TRUE;
+    OMX_BOOL      bPicture = OMX_FALSE;
+    OMX_BOOL      bNewFrame;
+    OMX_U32       pos, unit;
+    OMX_U8        code;
+    OMX_ERRORTYPE ret = OMX_ErrorNone;
+
+    if (pBench->codec == DECBENCH_CODEC_H263) {
+        for (pos = 0; pos + 3 <= size; pos++) {
+            /* picture start code, 22 bits */
+            if ((buf[pos] == 0) && (buf[pos + 1] == 0) && ((buf[pos + 2] & 0xFC) == 0x80)) {
+                ret = DecBench_AddFrame(pBench, frameStart, pos, OMX_FALSE);
+                if (ret != OMX_ErrorNone)
+                    return ret;
+                frameStart = pos;
+                pos += 2;
+            }
+        }
+        return DecBench_AddFrame(pBench, frameStart, size, OMX_FALSE);
+    }
+
+    for (pos = DecBench_NextStartCode(buf, size, 0); pos + 3 < size; pos = DecBench_NextStartCode(buf, size, pos + 3)) {
+        /* a zero before 00 00 01 belongs to the 4 byte start code */
+        unit = ((pos > 0) && (buf[pos - 1] == 0)) ? pos - 1 : pos;
+        code = buf[pos + 3];
+        bNewFrame = OMX_FALSE;
+
+        if (pBench->codec == DECBENCH_CODEC_H264) {
+            OMX_U8 nalType = code & 0x1F;
+
+            if ((nalType == 1) || (nalType == 5)) {
+                /* first_mb_in_slice == 0 starts a picture */
+                if ((bPicture == OMX_TRUE) && (pos + 4 < size) && (buf[pos + 4] & 0x80))
+                    bNewFrame = OMX_TRUE;
+                else if (bConfig == OMX_TRUE)
+                    bNewFrame = OMX_TRUE;
+            } else if ((nalType == 6) || (nalType == 7) || (nalType == 8) || (nalType == 9) ||
+                       ((nalType >= 14) && (nalType <= 18))) {
+                bNewFrame = bPicture;
+            }
+            if (bNewFrame == OMX_TRUE) {
+                ret = DecBench_AddFrame(pBench, frameStart, unit, bConfig);
+                frameStart = unit;
+                bConfig = OMX_FALSE;
+                bPicture = OMX_FALSE;
+            }
+            if ((nalType == 1) || (nalType == 5))
+                bPicture = OMX_TRUE;
+        } else {
+            if (code == 0xB6) {
+                bNewFrame = (bConfig == OMX_TRUE) || (bPicture == OMX_TRUE);
+            } else if ((code == 0xB0) || (code == 0xB3) || ((code >= 0x20) && (code <= 0x2F))) {
+                bNewFrame = bPicture;
+            }
+            if (bNewFrame == OMX_TRUE) {
+                ret = DecBench_AddFrame(pBench, frameStart, unit, bConfig);
+                frameStart = unit;
+                bConfig = OMX_FALSE;
+                bPicture = OMX_FALSE;
+            }
+            if (code == 0xB6)
+                bPicture = OMX_TRUE;
+        }
+
+        if (ret != OMX_ErrorNone)
+            return ret;
+    }
+
+    return DecBench_AddFrame(pBench, frameStart, size, bConfig);
+}
+
+static OMX_ERRORTYPE DecBench_EventHandler(
+    OMX_HANDLETYPE hComponent,
+    OMX_PTR        pAppData,
+    OMX_EVENTTYPE  eEvent,
+    OMX_U32        nData1,
+    OMX_U32        nData2,
+    OMX_PTR        pEventData)
+{
+    DECBENCH *pBench = (DECBENCH *)pAppData;
+
+    switch (eEvent) {
+    case OMX_EventCmdComplete:
+        SEC_OSAL_MutexLock(pBench->hMutex);
+        if ((nData1 < DECBENCH_CMD_NUM) && (nData2 < DECBENCH_CMD_DATA_NUM))
+            pBench->cmdDone[nData1][nData2]++;
+        SEC_OSAL_MutexUnlock(pBench->hMutex);
+        SEC_OSAL_SignalSet(pBench->hCmdDone);
+        break;
+    case OMX_EventPortSettingsChanged:
+        if (nData1 == DECBENCH_OUTPUT_PORT) {
+            SEC_OSAL_MutexLock(pBench->hMutex);
+            pBench->bPortChanged = OMX_TRUE;
+            SEC_OSAL_MutexUnlock(pBench->hMutex);
+            SEC_OSAL_SignalSet(pBench->hWake);
+        }
+        break;
+    case OMX_EventError:
+        printf("component error 0x%x\n", (unsigned int)nData1);
+        SEC_OSAL_MutexLock(pBench->hMutex);
+        pBench->error = (OMX_ERRORTYPE)nData1;
+        SEC_OSAL_MutexUnlock(pBench->hMutex);
+        SEC_OSAL_SignalSet(pBench->hCmdDone);
+        SEC_OSAL_SignalSet(pBench->hWake);
+        break;
+    default:
+        break;
+    }
+
+    return OMX_ErrorNone;
+}
+
+static OMX_ERRORTYPE DecBench_EmptyBufferDone(
+    OMX_HANDLETYPE        hComponent,
+    OMX_PTR               pAppData,
+    OMX_BUFFERHEADERTYPE *pBuffer)
+{
+    DECBENCH *pBench = (DECBENCH *)pAppData;
+
+    SEC_OSAL_MutexLock(pBench->hMutex);
+    pBench->inHeld--;
+    SEC_OSAL_MutexUnlock(pBench->hMutex);
+
+    SEC_OSAL_Queue(&pBench->inFreeQ, pBuffer);
+    SEC_OSAL_SignalSet(pBench->hWake);
+
+    return OMX_ErrorNone;
+}
+
+static OMX_ERRORTYPE DecBench_FillBufferDone(
+    OMX_HANDLETYPE        hComponent,
+    OMX_PTR               pAppData,
+    OMX_BUFFERHEADERTYPE *pBuffer)
+{
+    DECBENCH *pBench = (DECBENCH *)pAppData;
+    OMX_U64   nowUs = SEC_OSAL_GetSystemTimeUs();
+    OMX_U32   index;
+
+    SEC_OSAL_MutexLock(pBench->hMutex);
+    pBench->outHeld--;
+    if (pBuffer->nFilledLen > 0) {
+        /* frame index from the timestamp given at EmptyThisBuffer */
+        index = (OMX_U32)(pBuffer->nTimeStamp / pBench->frameDurationUs);
+        if ((index < pBench->frameNum) && (pBench->frame[index].emptyTimeUs != 0) &&
+            (pBench->latencyNum < pBench->frameNum))
+            pBench->latencyUs[pBench->latencyNum++] = (OMX_U32)(nowUs - pBench->frame[index].emptyTimeUs);
+        if (pBench->firstFillUs == 0)
+            pBench->firstFillUs = nowUs;
+        pBench->lastFillUs = nowUs;
+        pBench->framesOut++;
+    }
+    if (pBuffer->nFlags & OMX_BUFFERFLAG_EOS)
+        pBench->bEOS = OMX_TRUE;
+    SEC_OSAL_MutexUnlock(pBench->hMutex);
+
+    SEC_OSAL_Queue(&pBench->outDoneQ, pBuffer);
+    SEC_OSAL_SignalSet(pBench->hWake);
+
+    return OMX_ErrorNone;
+}
+
+static OMX_CALLBACKTYPE decBenchCallbacks = {
+    DecBench_EventHandler,
+    DecBench_EmptyBufferDone,
+    DecBench_FillBufferDone
+};
+
+static OMX_ERRORTYPE DecBench_WaitCommand(DECBENCH *pBench, OMX_COMMANDTYPE cmd, OMX_U32 data)
+{
+    OMX_ERRORTYPE ret = OMX_ErrorNone;
+
+    for (;;) {
+        SEC_OSAL_MutexLock(pBench->hMutex);
+        if (pBench->error != OMX_ErrorNone) {
+            ret = pBench->error;
+        } else if (pBench->cmdDone[cmd][data] > 0) {
+            pBench->cmdDone[cmd][data]--;
+            SEC_OSAL_MutexUnlock(pBench->hMutex);
+            return OMX_ErrorNone;
+        }
+        SEC_OSAL_MutexUnlock(pBench->hMutex);
+        if (ret != OMX_ErrorNone)
+            return ret;
+
+        if (SEC_OSAL_SignalWait(pBench->hCmdDone, DECBENCH_STALL_TIMEOUT_MS) == OMX_ErrorTimeout) {
+            printf("command %d (%d) timed out\n", (int)cmd, (int)data);
+            return OMX_ErrorTimeout;
+        }
+        SEC_OSAL_SignalReset(pBench->hCmdDone);
+    }
+}
+
+/*
+ * The buffer count is set while the component is Loaded or the port disabled,
+ * that is before the Idle or PortEnable command is sent.
+ */
+static OMX_ERRORTYPE DecBench_SetBufferCount(DECBENCH *pBench, OMX_U32 nPortIndex)
+{
+    OMX_PARAM_PORTDEFINITIONTYPE portDef;
+    OMX_U32 request = (nPortIndex == DECBENCH_INPUT_PORT) ? pBench->inBufferReq : pBench->outBufferReq;
+    OMX_ERRORTYPE ret;
+
+    if (request == 0)
+        return OMX_ErrorNone;
+
+    DecBench_InitHeader(&portDef, sizeof(portDef));
+    portDef.nPortIndex = nPortIndex;
+    ret = OMX_GetParameter(pBench->hComponent, OMX_IndexParamPortDefinition, &portDef);
+    if (ret != OMX_ErrorNone)
+        return ret;
+
+    portDef.nBufferCountActual = (request < portDef.nBufferCountMin) ? portDef.nBufferCountMin : request;
+    return OMX_SetParameter(pBench->hComponent, OMX_IndexParamPortDefinition, &portDef);
+}
+
+static OMX_ERRORTYPE DecBench_AllocatePort(DECBENCH *pBench, OMX_U32 nPortIndex)
+{
+    OMX_PARAM_PORTDEFINITIONTYPE portDef;
+    OMX_BUFFERHEADERTYPE **buffer = (nPortIndex == DECBENCH_INPUT_PORT) ? pBench->inBuffer : pBench->outBuffer;
+    OMX_U32 *bufferNum = (nPortIndex == DECBENCH_INPUT_PORT) ? &pBench->inBufferNum : &pBench->outBufferNum;
+    OMX_ERRORTYPE ret;
+    OMX_U32 i;
+
+    DecBench_InitHeader(&portDef, sizeof(portDef));
+    portDef.nPortIndex = nPortIndex;
+    ret = OMX_GetParameter(pBench->hComponent, OMX_IndexParamPortDefinition, &portDef);
+    if (ret != OMX_ErrorNone)
+        return ret;
+
+    if (portDef.nBufferCountActual > DECBENCH_MAX_BUFFER_NUM)
+        return OMX_ErrorInsufficientResources;
+
+    for (i = 0; i < portDef.nBufferCountActual; i++) {
+        ret = OMX_AllocateBuffer(pBench->hComponent, &buffer[i], nPortIndex, pBench, portDef.nBufferSize);
+        if (ret != OMX_ErrorNone)
+            return ret;
+        *bufferNum = i + 1;
+        if (nPortIndex == DECBENCH_INPUT_PORT)
+            SEC_OSAL_Queue(&pBench->inFreeQ, buffer[i]);
+    }
+
+    if (nPortIndex == DECBENCH_OUTPUT_PORT) {
+        printf("output port: %dx%d stride %d, %d buffers of %d bytes\n",
+               (int)portDef.format.video.nFrameWidth, (int)portDef.format.video.nFrameHeight,
+               (int)portDef.format.video.nStride, (int)portDef.nBufferCountActual, (int)portDef.nBufferSize);
+    }
+
+    return OMX_ErrorNone;
+}
+
+static void DecBench_FreePort(DECBENCH *pBench, OMX_U32 nPortIndex)
+{
+    OMX_BUFFERHEADERTYPE **buffer = (nPortIndex == DECBENCH_INPUT_PORT) ? pBench->inBuffer : pBench->outBuffer;
+    OMX_U32 *bufferNum = (nPortIndex == DECBENCH_INPUT_PORT) ? &pBench->inBufferNum : &pBench->outBufferNum;
+    OMX_U32 i;
+
+    for (i = 0; i < *bufferNum; i++)
+        OMX_FreeBuffer(pBench->hComponent, nPortIndex, buffer[i]);
+    *bufferNum = 0;
+}
+
+static OMX_ERRORTYPE DecBench_FillAll(DECBENCH *pBench)
+{
+    OMX_ERRORTYPE ret = OMX_ErrorNone;
+    OMX_U32 i;
+
+    for (i = 0; (i < pBench->outBufferNum) && (ret == OMX_ErrorNone); i++) {
+        SEC_OSAL_MutexLock(pBench->hMutex);
+        pBench->outHeld++;
+        SEC_OSAL_MutexUnlock(pBench->hMutex);
+        ret = OMX_FillThisBuffer(pBench->hComponent, pBench->outBuffer[i]);
+    }
+
+    return ret;
+}
+
+/*
+ * Output port settings changed: disable the port, which returns the
+ * output buffers, free them, reallocate for the new definition, enable.
+ */
+static OMX_ERRORTYPE DecBench_ReconfigureOutput(DECBENCH *pBench)
+{
+    OMX_ERRORTYPE ret;
+    OMX_U32       outHeld;
+
+    pBench->reconfigNum++;
+
+    ret = OMX_SendCommand(pBench->hComponent, OMX_CommandPortDisable, DECBENCH_OUTPUT_PORT, NULL);
+    if (ret != OMX_ErrorNone)
+        return ret;
+
+    /* the flush returns the buffers through FillBufferDone, they are not refilled */
+    for (;;) {
+        SEC_OSAL_MutexLock(pBench->hMutex);
+        outHeld = pBench->outHeld;
+        SEC_OSAL_MutexUnlock(pBench->hMutex);
+        if (outHeld == 0)
+            break;
+        if (SEC_OSAL_SignalWait(pBench->hWake, DECBENCH_STALL_TIMEOUT_MS) == OMX_ErrorTimeout) {
+            printf("%d output buffers not returned on port disable\n", (int)outHeld);
+            return OMX_ErrorTimeout;
+        }
+        SEC_OSAL_SignalReset(pBench->hWake);
+    }
+    while (SEC_OSAL_Dequeue(&pBench->outDoneQ) != NULL)
+        ;
+    DecBench_FreePort(pBench, DECBENCH_OUTPUT_PORT);
+    ret = DecBench_WaitCommand(pBench, OMX_CommandPortDisable, DECBENCH_OUTPUT_PORT);
+    if (ret != OMX_ErrorNone)
+        return ret;
+
+    ret = DecBench_SetBufferCount(pBench, DECBENCH_OUTPUT_PORT);
+    if (ret != OMX_ErrorNone)
+        return ret;
+    ret = OMX_SendCommand(pBench->hComponent, OMX_CommandPortEnable, DECBENCH_OUTPUT_PORT, NULL);
+    if (ret != OMX_ErrorNone)
+        return ret;
+    ret = DecBench_AllocatePort(pBench, DECBENCH_OUTPUT_PORT);
+    if (ret != OMX_ErrorNone)
+        return ret;
+    ret = DecBench_WaitCommand(pBench, OMX_CommandPortEnable, DECBENCH_OUTPUT_PORT);
+    if (ret != OMX_ErrorNone)
+        return ret;
+
+    return DecBench_FillAll(pBench);
+}
+
+static OMX_ERRORTYPE DecBench_EmptyNext(DECBENCH *pBench, OMX_BUFFERHEADERTYPE *pBuffer)
+{
+    DECBENCH_FRAME *frame = NULL;
+    OMX_U32 lastFrame = pBench->frameNum;
+    OMX_U64 nowUs;
+
+    if ((pBench->maxFrames > 0) && (pBench->maxFrames < lastFrame))
+        lastFrame = pBench->maxFrames;
+
+    pBuffer->nOffset = 0;
+    pBuffer->nFilledLen = 0;
+    pBuffer->nFlags = 0;
+    pBuffer->nTimeStamp = (OMX_TICKS)pBench->nextFrame * pBench->frameDurationUs;
+
+    if (pBench->nextFrame < lastFrame) {
+        frame = &pBench->frame[pBench->nextFrame];
+        if (frame->size > pBuffer->nAllocLen) {
+            printf("frame %d of %d bytes does not fit an input buffer of %d bytes\n",
+                   (int)pBench->nextFrame, (int)frame->size, (int)pBuffer->nAllocLen);
+            return OMX_ErrorBadParameter;
+        }
+        memcpy(pBuffer->pBuffer, pBench->stream + frame->offset, frame->size);
+        pBuffer->nFilledLen = frame->size;
+        pBuffer->nFlags = OMX_BUFFERFLAG_ENDOFFRAME;
+        if (frame->bConfig == OMX_TRUE)
+            pBuffer->nFlags |= OMX_BUFFERFLAG_CODECCONFIG;
+    }
+    if (pBench->nextFrame + 1 >= lastFrame)
+        pBuffer->nFlags |= OMX_BUFFERFLAG_EOS;
+
+    nowUs = SEC_OSAL_GetSystemTimeUs();
+    SEC_OSAL_MutexLock(pBench->hMutex);
+    if (frame != NULL)
+        frame->emptyTimeUs = nowUs;
+    if (pBench->firstEmptyUs == 0)
+        pBench->firstEmptyUs = nowUs;
+    pBench->inHeld++;
+    pBench->inHeldSum += pBench->inHeld;
+    pBench->outHeldSum += pBench->outHeld;
+    if (pBench->inHeld > pBench->inHeldMax)
+        pBench->inHeldMax = pBench->inHeld;
+    if (pBench->outHeld > pBench->outHeldMax)
+        pBench->outHeldMax = pBench->outHeld;
+    pBench->heldSamples++;
+    SEC_OSAL_MutexUnlock(pBench->hMutex);
+
+    pBench->nextFrame++;
+
+    return OMX_EmptyThisBuffer(pBench->hComponent, pBuffer);
+}
+
+static OMX_ERRORTYPE DecBench_Run(DECBENCH *pBench)
+{
+    OMX_BUFFERHEADERTYPE *pBuffer;
+    OMX_ERRORTYPE ret = OMX_ErrorNone;
+    OMX_BOOL bPortChanged;
+    OMX_BOOL bEOS = OMX_FALSE;
+    OMX_BOOL bInputDone = OMX_FALSE;
+
+    ret = DecBench_FillAll(pBench);
+
+    while ((ret == OMX_ErrorNone) && (bEOS == OMX_FALSE)) {
+        SEC_OSAL_MutexLock(pBench->hMutex);
+        bPortChanged = pBench->bPortChanged;
+        pBench->bPortChanged = OMX_FALSE;
+        bEOS = pBench->bEOS;
+        ret = pBench->error;
+        SEC_OSAL_MutexUnlock(pBench->hMutex);
+        if (ret != OMX_ErrorNone)
+            break;
+
+        if (bPortChanged == OMX_TRUE) {
+            ret = DecBench_ReconfigureOutput(pBench);
+            continue;
+        }
+
+        while ((pBuffer = SEC_OSAL_Dequeue(&pBench->outDoneQ)) != NULL) {
+            if ((pBench->outFile != NULL) && (pBuffer->nFilledLen > 0))
+                fwrite(pBuffer->pBuffer + pBuffer->nOffset, 1, pBuffer->nFilledLen, pBench->outFile);
+            if (bEOS == OMX_TRUE)
+                continue;
+            pBuffer->nFilledLen = 0;
+            pBuffer->nFlags = 0;
+            SEC_OSAL_MutexLock(pBench->hMutex);
+            pBench->outHeld++;
+            SEC_OSAL_MutexUnlock(pBench->hMutex);
+            ret = OMX_FillThisBuffer(pBench->hComponent, pBuffer);
+            if (ret != OMX_ErrorNone)
+                break;
+        }
+
+        while ((ret == OMX_ErrorNone) && (bInputDone == OMX_FALSE) &&
+               ((pBuffer = SEC_OSAL_Dequeue(&pBench->inFreeQ)) != NULL)) {
+            ret = DecBench_EmptyNext(pBench, pBuffer);
+            if (pBuffer->nFlags & OMX_BUFFERFLAG_EOS)
+                bInputDone = OMX_TRUE;
+        }
+
+        if ((ret != OMX_ErrorNone) || (bEOS == OMX_TRUE))
+            break;
+
+        if (SEC_OSAL_SignalWait(pBench->hWake, DECBENCH_STALL_TIMEOUT_MS) == OMX_ErrorTimeout) {
+            printf("no buffer returned for %d ms, %d frames out\n", DECBENCH_STALL_TIMEOUT_MS, (int)pBench->framesOut);
+            ret = OMX_ErrorTimeout;
+            break;
+        }
+        SEC_OSAL_SignalReset(pBench->hWake);
+    }
+
+    return ret;
+}
+
+static int DecBench_CompareU32(const void *a, const void *b)
+{
+    OMX_U32 x = *(const OMX_U32 *)a;
+    OMX_U32 y = *(const OMX_U32 *)b;
+
+    return (x > y) - (x < y);
+}
+
+static int DecBench_ReadThreadsCpu(DECBENCH_THREAD_CPU *thread, int maxNum)
+{
+    DIR *dir;
+    struct dirent *entry;
+    char path[64];
+    char line[512];
+    FILE *file;
+    char *name, *end;
+    int num = 0;
+
+    dir = opendir("/proc/self/task");
+    if (dir == NULL)
+        return 0;
+
+    while (((entry = readdir(dir)) != NULL) && (num < maxNum)) {
+        if (entry->d_name[0] == '.')
+            continue;
+        snprintf(path, sizeof(path), "/proc/self/task/%s/stat", entry->d_name);
+        file = fopen(path, "r");
+        if (file == NULL)
+            continue;
+        if (fgets(line, sizeof(line), file) != NULL) {
+            /* pid (comm) state ppid ... utime is field 14, stime 15 */
+            name = strchr(line, '(');
+            end = strrchr(line, ')');
+            if ((name != NULL) && (end != NULL) && (end > name) &&
+                (sscanf(end + 2, "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %ld %ld",
+                        &thread[num].userTicks, &thread[num].sysTicks) == 2)) {
+                thread[num].tid = atoi(entry->d_name);
+                *end = '\0';
+                snprintf(thread[num].name, sizeof(thread[num].name), "%s", name + 1);
+                num++;
+            }
+        }
+        fclose(file);
+    }
+    closedir(dir);
+
+    return num;
+}
+
+static void DecBench_ReportComponentStats(DECBENCH *pBench)
+{
+    static const char *stageName[SEC_OMX_STATS_STAGE_NUM] = {
+        "input_wait", "framing", "mfc", "reorder", "csc", "total"
+    };
+    SEC_OMX_CONFIG_STATSTYPE stats;
+    OMX_INDEXTYPE index;
+    int i;
+
+    if (OMX_GetExtensionIndex(pBench->hComponent, SEC_INDEX_CONFIG_STATISTICS, &index) != OMX_ErrorNone)
+        return;
+
+    DecBench_InitHeader(&stats, sizeof(stats));
+    if (OMX_GetConfig(pBench->hComponent, index, &stats) != OMX_ErrorNone)
+        return;
+
+    printf("component stages     count    mean us     min us     max us\n");
+    for (i = 0; i < SEC_OMX_STATS_STAGE_NUM; i++) {
+        if (stats.stage[i].nCount == 0)
+            continue;
+        printf("  %-16s %9u %10u %10u %10u\n", stageName[i], (unsigned int)stats.stage[i].nCount,
+               (unsigned int)(stats.stage[i].nTotalUs / stats.stage[i].nCount),
+               (unsigned int)stats.stage[i].nMinUs, (unsigned int)stats.stage[i].nMaxUs);
+    }
+}
+
+static void DecBench_Report(DECBENCH *pBench, DECBENCH_THREAD_CPU *thread, int threadNum, OMX_U64 wallUs)
+{
+    long ticksPerSec = sysconf(_SC_CLK_TCK);
+    double elapsedSec = 0;
+    long totalTicks = 0;
+    OMX_U32 n = pBench->latencyNum;
+    int i;
+
+    if (pBench->lastFillUs > pBench->firstEmptyUs)
+        elapsedSec = (pBench->lastFillUs - pBench->firstEmptyUs) / 1e6;
+
+    printf("%s: %d frames in, %d frames out, %d output reconfigurations\n", pBench->componentName,
+           (int)pBench->nextFrame, (int)pBench->framesOut, (int)pBench->reconfigNum);
+    if (elapsedSec > 0)
+        printf("decode: %.2f fps over %.3f s, first frame after %.2f ms\n",
+               pBench->framesOut / elapsedSec, elapsedSec, (pBench->firstFillUs - pBench->firstEmptyUs) / 1e3);
+
+    if (n > 0) {
+        qsort(pBench->latencyUs, n, sizeof(OMX_U32), DecBench_CompareU32);
+        printf("latency ms: p50 %.2f  p90 %.2f  p99 %.2f  max %.2f\n",
+               pBench->latencyUs[n / 2] / 1e3, pBench->latencyUs[(n * 9) / 10] / 1e3,
+               pBench->latencyUs[(n * 99) / 100] / 1e3, pBench->latencyUs[n - 1] / 1e3);
+    }
+
+    if (pBench->heldSamples > 0)
+        printf("held by component: input mean %.2f max %d of %d, output mean %.2f max %d of %d\n",
+               (double)pBench->inHeldSum / pBench->heldSamples, (int)pBench->inHeldMax, (int)pBench->inBufferNum,
+               (double)pBench->outHeldSum / pBench->heldSamples, (int)pBench->outHeldMax, (int)pBench->outBufferNum);
+
+    if ((threadNum > 0) && (ticksPerSec > 0)) {
+        printf("thread cpu             tid    user ms     sys ms\n");
+        for (i = 0; i < threadNum; i++) {
+            printf("  %-16s %7d %10ld %10ld\n", thread[i].name, thread[i].tid,
+                   thread[i].userTicks * 1000 / ticksPerSec, thread[i].sysTicks * 1000 / ticksPerSec);
+            totalTicks += thread[i].userTicks + thread[i].sysTicks;
+        }
+        if (wallUs > 0)
+            printf("  process load %.1f%% of one cpu\n", (totalTicks * 1e8 / ticksPerSec) / wallUs);
+    }
+
+    DecBench_ReportComponentStats(pBench);
+}
+
+static int DecBench_Usage(const char *prog)
+{
+    printf("usage: %s [-c component] [-n frames] [-f fps] [-i inbufs] [-o outbufs] [-w out.yuv] stream\n", prog);
+    return 2;
+}
+
+static OMX_STRING DecBench_GuessComponent(const char *fileName, DECBENCH_CODEC *pCodec)
+{
+    const char *ext = strrchr(fileName, '.');
+
+    if (ext == NULL)
+        return NULL;
+
+    if (!strcasecmp(ext, ".264") || !strcasecmp(ext, ".h264") || !strcasecmp(ext, ".avc") || !strcasecmp(ext, ".jsv")) {
+        *pCodec = DECBENCH_CODEC_H264;
+        return DECBENCH_H264_COMPONENT;
+    }
+    if (!strcasecmp(ext, ".m4v") || !strcasecmp(ext, ".cmp") || !strcasecmp(ext, ".mp4v")) {
+        *pCodec = DECBENCH_CODEC_MPEG4;
+        return DECBENCH_MPEG4_COMPONENT;
+    }
+    if (!strcasecmp(ext, ".263") || !strcasecmp(ext, ".h263")) {
+        *pCodec = DECBENCH_CODEC_H263;
+        return DECBENCH_H263_COMPONENT;
+    }
+
+    return NULL;
+}
+
+int main(int argc, char **argv)
+{
+    DECBENCH bench;
+    DECBENCH_THREAD_CPU thread[DECBENCH_MAX_THREAD_NUM];
+    int threadNum = 0;
+    OMX_STRING componentName = NULL;
+    const char *outName = NULL;
+    FILE *file;
+    OMX_U64 startUs, wallUs;
+    OMX_ERRORTYPE ret = OMX_ErrorNone;
+    int fps = DECBENCH_DEFAULT_FPS;
+    int opt;
+
+    memset(&bench, 0, sizeof(bench));
+
+    while ((opt = getopt(argc, argv, "c:n:f:i:o:w:")) != -1) {
+        switch (opt) {
+        case 'c':
+            componentName = optarg;
+            break;
+        case 'n':
+            bench.maxFrames = atoi(optarg);
+            break;
+        case 'f':
+            fps = atoi(optarg);
+            break;
+        case 'i':
+            bench.inBufferReq = atoi(optarg);
+            break;
+        case 'o':
+            bench.outBufferReq = atoi(optarg);
+            break;
+        case 'w':
+            outName = optarg;
+            break;
+        default:
+            return DecBench_Usage(argv[0]);
+        }
+    }
+    if ((optind != argc - 1) || (fps <= 0) ||
+        (bench.inBufferReq > DECBENCH_MAX_BUFFER_NUM) || (bench.outBufferReq > DECBENCH_MAX_BUFFER_NUM))
+        return DecBench_Usage(argv[0]);
+
+    bench.componentName = DecBench_GuessComponent(argv[optind], &bench.codec);
+    if (componentName != NULL) {
+        bench.componentName = componentName;
+        if (strstr(componentName, "AVC") != NULL)
+            bench.codec = DECBENCH_CODEC_H264;
+        else if (strstr(componentName, "H263") != NULL)
+            bench.codec = DECBENCH_CODEC_H263;
+        else
+            bench.codec = DECBENCH_CODEC_MPEG4;
+    }
+    if (bench.componentName == NULL) {
+        printf("%s: no component for %s, use -c\n", argv[0], argv[optind]);
+        return 2;
+    }
+    bench.frameDurationUs = 1000000 / fps;
+
+    file = fopen(argv[optind], "rb");
+    if (file == NULL) {
+        printf("%s: cannot open %s\n", argv[0], argv[optind]);
+        return 1;
+    }
+    fseek(file, 0, SEEK_END);
+    bench.streamSize = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    bench.stream = malloc(bench.streamSize + 1);
+    if ((bench.stream == NULL) || (fread(bench.stream, 1, bench.streamSize, file) != bench.streamSize)) {
+        printf("%s: cannot read %s\n", argv[0], argv[optind]);
+        fclose(file);
+        return 1;
+    }
+    fclose(file);
+
+    if ((DecBench_SplitFrames(&bench) != OMX_ErrorNone) || (bench.frameNum == 0)) {
+        printf("%s: no frames in %s\n", argv[0], argv[optind]);
+        return 1;
+    }
+    bench.latencyUs = malloc(bench.frameNum * sizeof(OMX_U32));
+    if (bench.latencyUs == NULL)
+        return 1;
+
+    if (outName != NULL) {
+        bench.outFile = fopen(outName, "wb");
+        if (bench.outFile == NULL) {
+            printf("%s: cannot create %s\n", argv[0], outName);
+            return 1;
+        }
+    }
+
+    SEC_OSAL_QueueCreate(&bench.inFreeQ, DECBENCH_MAX_BUFFER_NUM);
+    SEC_OSAL_QueueCreate(&bench.outDoneQ, DECBENCH_MAX_BUFFER_NUM);
+    SEC_OSAL_SignalCreate(&bench.hWake);
+    SEC_OSAL_SignalCreate(&bench.hCmdDone);
+    SEC_OSAL_MutexCreate(&bench.hMutex);
+
+    ret = SEC_OMX_Init();
+    if (ret != OMX_ErrorNone) {
+        printf("%s: SEC_OMX_Init failed 0x%x\n", argv[0], ret);
+        return 1;
+    }
+
+    ret = SEC_OMX_GetHandle(&bench.hComponent, bench.componentName, &bench, &decBenchCallbacks);
+    if (ret != OMX_ErrorNone) {
+        printf("%s: cannot load %s, 0x%x\n", argv[0], bench.componentName, ret);
+        SEC_OMX_Deinit();
+        return 1;
+    }
+
+    /* Loaded -> Idle: buffers are allocated while the command is pending */
+    ret = DecBench_SetBufferCount(&bench, DECBENCH_INPUT_PORT);
+    if (ret == OMX_ErrorNone)
+        ret = DecBench_SetBufferCount(&bench, DECBENCH_OUTPUT_PORT);
+    if (ret == OMX_ErrorNone)
+        ret = OMX_SendCommand(bench.hComponent, OMX_CommandStateSet, OMX_StateIdle, NULL);
+    if (ret == OMX_ErrorNone)
+        ret = DecBench_AllocatePort(&bench, DECBENCH_INPUT_PORT);
+    if (ret == OMX_ErrorNone)
+        ret = DecBench_AllocatePort(&bench, DECBENCH_OUTPUT_PORT);
+    if (ret == OMX_ErrorNone)
+        ret = DecBench_WaitCommand(&bench, OMX_CommandStateSet, OMX_StateIdle);
+
+    if (ret == OMX_ErrorNone)
+        ret = OMX_SendCommand(bench.hComponent, OMX_CommandStateSet, OMX_StateExecuting, NULL);
+    if (ret == OMX_ErrorNone)
+        ret = DecBench_WaitCommand(&bench, OMX_CommandStateSet, OMX_StateExecuting);
+
+    startUs = SEC_OSAL_GetSystemTimeUs();
+    if (ret == OMX_ErrorNone)
+        ret = DecBench_Run(&bench);
+    wallUs = SEC_OSAL_GetSystemTimeUs() - startUs;
+
+    /* the component threads exit on the way to Loaded */
+    threadNum = DecBench_ReadThreadsCpu(thread, DECBENCH_MAX_THREAD_NUM);
+    DecBench_Report(&bench, thread, threadNum, wallUs);
+    if (ret != OMX_ErrorNone)
+        printf("%s: stopped with 0x%x\n", argv[0], ret);
+
+    /* Executing -> Idle -> Loaded, errors here are reported, not retried */
+    SEC_OSAL_MutexLock(bench.hMutex);
+    bench.error = OMX_ErrorNone;
+    SEC_OSAL_MutexUnlock(bench.hMutex);
+    if (OMX_SendCommand(bench.hComponent, OMX_CommandStateSet, OMX_StateIdle, NULL) == OMX_ErrorNone)
+        DecBench_WaitCommand(&bench, OMX_CommandStateSet, OMX_StateIdle);
+    if (OMX_SendCommand(bench.hComponent, OMX_CommandStateSet, OMX_StateLoaded, NULL) == OMX_ErrorNone) {
+        DecBench_FreePort(&bench, DECBENCH_INPUT_PORT);
+        DecBench_FreePort(&bench, DECBENCH_OUTPUT_PORT);
+        DecBench_WaitCommand(&bench, OMX_CommandStateSet, OMX_StateLoaded);
+    }
+
+    SEC_OMX_FreeHandle(bench.hComponent);
+    SEC_OMX_Deinit();
+
+    SEC_OSAL_MutexTerminate(bench.hMutex);
+    SEC_OSAL_SignalTerminate(bench.hCmdDone);
+    SEC_OSAL_SignalTerminate(bench.hWake);
+    SEC_OSAL_QueueTerminate(&bench.outDoneQ);
+    SEC_OSAL_QueueTerminate(&bench.inFreeQ);
+    if (bench.outFile != NULL)
+        fclose(bench.outFile);
+    free(bench.latencyUs);
+    free(bench.frame);
+    free(bench.stream);
+
+    return (ret == OMX_ErrorNone) ? 0 : 1;
+}
@@ -42,11 +42,23 @@
 #define MAX_OMX_COMPONENT_ROLE_SIZE        OMX_MAX_STRINGNAME_SIZE
 #define MAX_OMX_COMPONENT_LIBNAME_SIZE     OMX_MAX_STRINGNAME_SIZE * 2
 #define MAX_OMX_MIMETYPE_SIZE              OMX_MAX_STRINGNAME_SIZE
+#define MAX_OMX_COMPONENT_PROFILELEVEL_NUM 8
 
-#define MAX_TIMESTAMP        17
-#define MAX_FLAGS            17
+/* Freed components kept by the core in Loaded state for the next GetHandle, 0 for none */
+#define MAX_OMX_IDLE_COMPONENT_NUM         4
 
+/*
+ * Buffer process thread of the codec components: nice value of
+ * ANDROID_PRIORITY_URGENT_DISPLAY, so decoding keeps up with the display
+ * while the UI is busy. No CPU pinning, S5PC110 has a single core.
+ */
+#define SEC_OMX_BUFFER_PROCESS_PRIORITY    (-8)
+#define SEC_OMX_BUFFER_PROCESS_CPU_MASK    0
+
+/* Android native and metadata buffers, none on the host build over the MFC simulator */
+#ifndef USE_MFC_SIM
 #define USE_ANDROID_EXTENSION
+#endif
 
 
 typedef enum _SEC_CODEC_TYPE
@@ -67,6 +79,23 @@ typedef enum _SEC_OMX_INDEXTYPE
 {
 #define SEC_INDEX_PARAM_ENABLE_THUMBNAIL "OMX.SEC.index.ThumbnailMode"
     OMX_IndexVendorThumbnailMode        = 0x7F000001,
+    /* OMX_PARAM_U32TYPE, frames decoded ahead of output delivery, 0 for none */
+#define SEC_INDEX_PARAM_DECODE_PIPELINE_DEPTH "OMX.SEC.index.DecodePipelineDepth"
+    OMX_IndexVendorDecodePipelineDepth  = 0x7F000002,
+    /* config, SEC_OMX_CONFIG_STATSTYPE, set clears the statistics */
+#define SEC_INDEX_CONFIG_STATISTICS "OMX.SEC.index.Statistics"
+    OMX_IndexVendorStatistics           = 0x7F000003,
+    /* config, set only, OMX_PARAM_U32TYPE with nU32 unused, see SEC_OMX_STATS_DUMP_DIR */
+#define SEC_INDEX_CONFIG_STATISTICS_DUMP "OMX.SEC.index.StatisticsDump"
+    OMX_IndexVendorStatisticsDump       = 0x7F000004,
+    /* config, get only, SEC_OMX_CONFIG_RESOURCETYPE */
+#define SEC_INDEX_CONFIG_RESOURCE_UTILIZATION "OMX.SEC.index.ResourceUtilization"
+    OMX_IndexVendorResourceUtilization  = 0x7F000005,
+#define SEC_INDEX_CONFIG_RATE_CONTROL "OMX.SEC.index.RateControl"
+    OMX_IndexVendorRateControl          = 0x7F000006,
+    /* param, SEC_OMX_VIDEO_PARAM_LOWLATENCYTYPE, set in the loaded state only */
+#define SEC_INDEX_PARAM_LOW_LATENCY "OMX.SEC.index.LowLatency"
+    OMX_IndexVendorLowLatency           = 0x7F000007,
 
     /* for Android Native Window */
 #define SEC_INDEX_PARAM_ENABLE_ANB "OMX.google.android.index.enableAndroidNativeBuffers"
@@ -109,6 +138,8 @@ typedef enum _SEC_OMX_TRANS_STATETYPE {
 
 typedef enum _SEC_OMX_COLOR_FORMATTYPE {
     OMX_SEC_COLOR_FormatNV12TPhysicalAddress = 0x7F000001, /**< Reserved region for introducing Vendor Extensions */
+    /* YUV420SemiPlanar with Cr before Cb, as from the camera */
+    OMX_SEC_COLOR_FormatNV21Linear = 0x7F000011,
     /* for Android Native Window */
     OMX_SEC_COLOR_FormatANBYUV420SemiPlanar = 0x100,
     /* for Android surface texture encode */
@@ -120,7 +151,9 @@ typedef enum _SEC_OMX_SUPPORTFORMAT_TYPE
     supportFormat_0 = 0x00,
     supportFormat_1,
     supportFormat_2,
-    supportFormat_3
+    supportFormat_3,
+    supportFormat_4,
+    supportFormat_5
 } SEC_OMX_SUPPORTFORMAT_TYPE;
 
 
@@ -138,6 +171,98 @@ typedef struct _OMXComponentCapabilityFlagsType
     OMX_BOOL iOMXComponentUsesFullAVCFrames;
 } OMXComponentCapabilityFlagsType;
 
+/* Stages timed per frame, see OMX_IndexVendorStatistics */
+typedef enum _SEC_OMX_STATS_STAGE
+{
+    SEC_OMX_STATS_INPUT_WAIT = 0,   /* EmptyThisBuffer until the buffer process thread takes it */
+    SEC_OMX_STATS_FRAMING,          /* finding the frame and copying it to the MFC stream buffer */
+    SEC_OMX_STATS_MFC,              /* one decode or encode run of the MFC */
+    SEC_OMX_STATS_REORDER,          /* handed to the MFC until its frame comes back (DPB, display delay) */
+    SEC_OMX_STATS_CSC,              /* color conversion of one frame */
+    SEC_OMX_STATS_TOTAL,            /* EmptyThisBuffer until FillBufferDone of the frame */
+    SEC_OMX_STATS_STAGE_NUM
+} SEC_OMX_STATS_STAGE;
+
+/* bucket i counts the times below (SEC_OMX_STATS_BUCKET_BASE_US << i), the last one the rest */
+#define SEC_OMX_STATS_BUCKET_NUM           16
+#define SEC_OMX_STATS_BUCKET_BASE_US       125
+
+/*
+ * Rolling: once nCount reaches SEC_OMX_STATS_WINDOW the counts and the
+ * total are halved, so old samples fade out. nMinUs and nMaxUs are over
+ * the samples since the last halving.
+ */
+#define SEC_OMX_STATS_WINDOW               512
+
+typedef struct _SEC_OMX_STATS_HISTOGRAM
+{
+    OMX_U32 nCount;
+    OMX_U32 nMinUs;
+    OMX_U32 nMaxUs;
+    OMX_U64 nTotalUs;
+    OMX_U32 nBucket[SEC_OMX_STATS_BUCKET_NUM];
+} SEC_OMX_STATS_HISTOGRAM;
+
+typedef struct _SEC_OMX_CONFIG_STATSTYPE
+{
+    OMX_U32                 nSize;
+    OMX_VERSIONTYPE         nVersion;
+    OMX_U32                 nFramesIn;      /* frames handed to the codec */
+    OMX_U32                 nFramesOut;     /* frames returned by FillBufferDone */
+    OMX_U64                 nBytesIn;       /* stream or picture bytes handed to the codec */
+    OMX_U64                 nElapsedUs;     /* first EmptyThisBuffer until the last FillBufferDone */
+    SEC_OMX_STATS_HISTOGRAM stage[SEC_OMX_STATS_STAGE_NUM];
+} SEC_OMX_CONFIG_STATSTYPE;
+
+/*
+ * Video codec resources shared by all components of the process. Loads are
+ * in macroblocks per second, the largest picture of the ports at their
+ * highest xFramerate (30 if not set).
+ */
+typedef struct _SEC_OMX_CONFIG_RESOURCETYPE
+{
+    OMX_U32         nSize;
+    OMX_VERSIONTYPE nVersion;
+    OMX_U32         nCapacity;      /* load the MFC runs in real time */
+    OMX_U32         nUsed;          /* sum of the loads of the admitted components */
+    OMX_U32         nInstances;     /* admitted components */
+    OMX_U32         nMaxInstances;
+    OMX_U32         nWaiting;       /* components in WaitForResources */
+    OMX_U32         nLoad;          /* of this component, charged or to be charged */
+    OMX_BOOL        bAdmitted;      /* holds its share, Idle or later */
+} SEC_OMX_CONFIG_RESOURCETYPE;
+
+/*
+ * Encoder rate adaptation, next to OMX_IndexConfigVideoBitrate,
+ * OMX_IndexConfigVideoFramerate and OMX_IndexConfigVideoIntraVOPRefresh.
+ * With bClosedLoop the bitrate given to the MFC is corrected about once a
+ * second so that the measured output follows nEncodeBitrate of the port.
+ * A zero nMinBitrate or nMaxBitrate is no limit.
+ */
+typedef struct _SEC_OMX_VIDEO_CONFIG_RATECONTROLTYPE
+{
+    OMX_U32         nSize;
+    OMX_VERSIONTYPE nVersion;
+    OMX_U32         nPortIndex;
+    OMX_BOOL        bFrameSkip;         /* the MFC may skip frames to hold the bitrate */
+    OMX_BOOL        bClosedLoop;
+    OMX_U32         nMinBitrate;
+    OMX_U32         nMaxBitrate;
+    OMX_U32         nEncoderBitrate;    /* get only, bitrate the MFC runs at */
+    OMX_U32         nMeasuredBitrate;   /* get only, output of the last window */
+} SEC_OMX_VIDEO_CONFIG_RATECONTROLTYPE;
+
+typedef struct _SEC_OMX_VIDEO_PARAM_LOWLATENCYTYPE
+{
+    OMX_U32         nSize;
+    OMX_VERSIONTYPE nVersion;
+    OMX_U32         nPortIndex;
+    OMX_BOOL        bEnable;            /* each frame encoded and given out before the next is taken */
+    OMX_U32         nSliceMode;         /* OMX_VIDEO_AVCSLICEMODETYPE */
+    OMX_U32         nSliceSize;         /* macroblocks or bytes per slice, by nSliceMode */
+    OMX_BOOL        bSliceOutput;       /* each slice in an output buffer of its own */
+} SEC_OMX_VIDEO_PARAM_LOWLATENCYTYPE;
+
 typedef struct _SEC_OMX_VIDEO_PROFILELEVEL
 {
     OMX_S32  profile;
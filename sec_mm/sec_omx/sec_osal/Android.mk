@@ -4,22 +4,36 @@ include $(CLEAR_VARS)
 LOCAL_MODULE_TAGS := optional
 
 LOCAL_SRC_FILES := \
-	SEC_OSAL_Event.c \
 	SEC_OSAL_Queue.c \
 	SEC_OSAL_ETC.c \
 	SEC_OSAL_Mutex.c \
 	SEC_OSAL_Thread.c \
 	SEC_OSAL_Memory.c \
-	SEC_OSAL_Semaphore.c \
 	SEC_OSAL_Library.c \
 	SEC_OSAL_Log.c \
 	SEC_OSAL_Buffer.cpp
 
+# Event and Semaphore on futex by default, on pthread cond and POSIX
+# semaphore when SEC_OSAL_USE_PTHREAD_SYNC is true
+ifeq ($(SEC_OSAL_USE_PTHREAD_SYNC),true)
+LOCAL_SRC_FILES += \
+	SEC_OSAL_Event.c \
+	SEC_OSAL_Semaphore.c
+else
+LOCAL_SRC_FILES += \
+	SEC_OSAL_Event_Futex.c \
+	SEC_OSAL_Semaphore_Futex.c
+endif
 
 LOCAL_MODULE := libsecosal.aries
 
 LOCAL_CFLAGS :=
 
+# Block counts of SEC_OSAL_Malloc for debugging, atomic on every call
+ifeq ($(SEC_OSAL_HEAP_STAT),true)
+LOCAL_CFLAGS += -DUSE_SEC_OSAL_HEAP_STAT
+endif
+
 LOCAL_STATIC_LIBRARIES :=
 
 LOCAL_SHARED_LIBRARIES := libcutils libutils \
@@ -37,3 +51,99 @@ LOCAL_C_INCLUDES := $(SEC_OMX_INC)/khronos \
 	$(SEC_OMX_TOP)/../../include
 
 include $(BUILD_STATIC_LIBRARY)
+
+#########################################################################
+# Build sync micro-benchmark, futex and pthread implementations
+#########################################################################
+
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES := \
+	SEC_OSAL_SyncBench.c \
+	SEC_OSAL_Event_Futex.c \
+	SEC_OSAL_Semaphore_Futex.c \
+	SEC_OSAL_Thread.c \
+	SEC_OSAL_Memory.c \
+	SEC_OSAL_Log.c
+
+LOCAL_MODULE := sec_osal_sync_bench
+
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_CFLAGS := -DSEC_OSAL_SYNC_NAME=\"futex\"
+
+LOCAL_SHARED_LIBRARIES := libcutils libutils
+
+LOCAL_C_INCLUDES := $(SEC_OMX_INC)/khronos \
+	$(SEC_OMX_INC)/sec \
+	$(SEC_OMX_TOP)/sec_osal
+
+include $(BUILD_EXECUTABLE)
+
+include $(CLEAR_VARS)
+
+LOCAL_SRC_FILES := \
+	SEC_OSAL_SyncBench.c \
+	SEC_OSAL_Event.c \
+	SEC_OSAL_Semaphore.c \
+	SEC_OSAL_Mutex.c \
+	SEC_OSAL_Thread.c \
+	SEC_OSAL_Memory.c \
+	SEC_OSAL_Log.c
+
+LOCAL_MODULE := sec_osal_sync_bench_pthread
+
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_CFLAGS := -DSEC_OSAL_SYNC_NAME=\"pthread\"
+
+LOCAL_SHARED_LIBRARIES := libcutils libutils
+
+LOCAL_C_INCLUDES := $(SEC_OMX_INC)/khronos \
+	$(SEC_OMX_INC)/sec \
+	$(SEC_OMX_TOP)/sec_osal
+
+include $(BUILD_EXECUTABLE)
+
+#########################################################################
+# Build OSAL for host, without the Android native buffers
+#########################################################################
+
+include $(CLEAR_VARS)
+
+LOCAL_MODULE_TAGS := optional
+
+LOCAL_SRC_FILES := \
+	SEC_OSAL_Queue.c \
+	SEC_OSAL_ETC.c \
+	SEC_OSAL_Mutex.c \
+	SEC_OSAL_Thread.c \
+	SEC_OSAL_Memory.c \
+	SEC_OSAL_Library.c \
+	SEC_OSAL_Log.c
+
+ifeq ($(SEC_OSAL_USE_PTHREAD_SYNC),true)
+LOCAL_SRC_FILES += \
+	SEC_OSAL_Event.c \
+	SEC_OSAL_Semaphore.c
+else
+LOCAL_SRC_FILES += \
+	SEC_OSAL_Event_Futex.c \
+	SEC_OSAL_Semaphore_Futex.c
+endif
+
+LOCAL_MODULE := libsecosal_host
+
+LOCAL_CFLAGS := -DUSE_MFC_SIM
+
+ifeq ($(SEC_OSAL_HEAP_STAT),true)
+LOCAL_CFLAGS += -DUSE_SEC_OSAL_HEAP_STAT
+endif
+
+LOCAL_C_INCLUDES := $(SEC_OMX_INC)/khronos \
+	$(SEC_OMX_INC)/sec \
+	$(SEC_OMX_TOP)/sec_osal \
+	$(SEC_OMX_COMPONENT)/common \
+	$(SEC_OMX_TOP)/../../include
+
+include $(BUILD_HOST_STATIC_LIBRARY)
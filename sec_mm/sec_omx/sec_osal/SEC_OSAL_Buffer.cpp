@@ -255,6 +255,12 @@ OMX_ERRORTYPE UseBufferANB(
         goto EXIT;
     }
 
+    if (pSECPort->assignedBufferNum == 0) {
+        ret = SEC_OMX_PortBufferQueueSetup(pSECPort);
+        if (ret != OMX_ErrorNone)
+            goto EXIT;
+    }
+
     temp_bufferHeader = (OMX_BUFFERHEADERTYPE *)SEC_OSAL_Malloc(sizeof(OMX_BUFFERHEADERTYPE));
     if (temp_bufferHeader == NULL) {
         ret = OMX_ErrorInsufficientResources;
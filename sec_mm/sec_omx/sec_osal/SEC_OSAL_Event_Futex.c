@@ -0,0 +1,180 @@
+/*
+ *
+ * Copyright 2010 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file        SEC_OSAL_Event_Futex.c
+ * @brief       futex implementation of SEC_OSAL_Signal*
+ *   Set and Reset are a single atomic operation, Set enters the kernel
+ *   only when a thread is sleeping in SignalWait.
+ * @version     1.0
+ */
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "SEC_OSAL_Memory.h"
+#include "SEC_OSAL_Event.h"
+#include "SEC_OSAL_Futex.h"
+
+#undef  SEC_LOG_TAG
+#define SEC_LOG_TAG    "SEC_OSAL_EVENT"
+#define SEC_LOG_OFF
+#include "SEC_OSAL_Log.h"
+
+
+typedef struct _SEC_OSAL_FUTEXEVENT
+{
+    volatile int32_t signal;
+    volatile int32_t waiters;
+} SEC_OSAL_FUTEXEVENT;
+
+
+OMX_ERRORTYPE SEC_OSAL_SignalCreate(OMX_HANDLETYPE *eventHandle)
+{
+    SEC_OSAL_FUTEXEVENT *event;
+    OMX_ERRORTYPE ret = OMX_ErrorNone;
+
+    event = (SEC_OSAL_FUTEXEVENT *)SEC_OSAL_Malloc(sizeof(SEC_OSAL_FUTEXEVENT));
+    if (!event) {
+        ret = OMX_ErrorInsufficientResources;
+        goto EXIT;
+    }
+
+    SEC_OSAL_Memset(event, 0, sizeof(SEC_OSAL_FUTEXEVENT));
+
+    *eventHandle = (OMX_HANDLETYPE)event;
+    ret = OMX_ErrorNone;
+
+EXIT:
+    return ret;
+}
+
+OMX_ERRORTYPE SEC_OSAL_SignalTerminate(OMX_HANDLETYPE eventHandle)
+{
+    SEC_OSAL_FUTEXEVENT *event = (SEC_OSAL_FUTEXEVENT *)eventHandle;
+    OMX_ERRORTYPE ret = OMX_ErrorNone;
+
+    if (!event) {
+        ret = OMX_ErrorBadParameter;
+        goto EXIT;
+    }
+
+    SEC_OSAL_Free(event);
+
+EXIT:
+    return ret;
+}
+
+OMX_ERRORTYPE SEC_OSAL_SignalReset(OMX_HANDLETYPE eventHandle)
+{
+    SEC_OSAL_FUTEXEVENT *event = (SEC_OSAL_FUTEXEVENT *)eventHandle;
+    OMX_ERRORTYPE ret = OMX_ErrorNone;
+
+    if (!event) {
+        ret = OMX_ErrorBadParameter;
+        goto EXIT;
+    }
+
+    __sync_lock_test_and_set(&event->signal, 0);
+    __sync_synchronize();
+
+EXIT:
+    return ret;
+}
+
+OMX_ERRORTYPE SEC_OSAL_SignalSet(OMX_HANDLETYPE eventHandle)
+{
+    SEC_OSAL_FUTEXEVENT *event = (SEC_OSAL_FUTEXEVENT *)eventHandle;
+    OMX_ERRORTYPE ret = OMX_ErrorNone;
+
+    if (!event) {
+        ret = OMX_ErrorBadParameter;
+        goto EXIT;
+    }
+
+    /*
+     * signal stays set until Reset, so every sleeper may go.
+     * The barrier orders the store to signal before the load of waiters,
+     * pairing with the increment of waiters before the load of signal
+     * in SignalWait.
+     */
+    __sync_lock_test_and_set(&event->signal, 1);
+    __sync_synchronize();
+    if (event->waiters > 0)
+        SEC_OSAL_FutexWake(&event->signal, INT_MAX);
+
+EXIT:
+    return ret;
+}
+
+OMX_ERRORTYPE SEC_OSAL_SignalWait(OMX_HANDLETYPE eventHandle, OMX_U32 ms)
+{
+    SEC_OSAL_FUTEXEVENT *event = (SEC_OSAL_FUTEXEVENT *)eventHandle;
+    OMX_ERRORTYPE         ret = OMX_ErrorNone;
+    struct timespec       deadline;
+    struct timespec       left;
+
+    FunctionIn();
+
+    if (!event) {
+        ret = OMX_ErrorBadParameter;
+        goto EXIT;
+    }
+
+    if (event->signal)
+        goto EXIT;
+
+    if (ms == 0) {
+        ret = OMX_ErrorTimeout;
+        goto EXIT;
+    }
+
+    if (ms != DEF_MAX_WAIT_TIME) {
+        clock_gettime(CLOCK_MONOTONIC, &deadline);
+        deadline.tv_sec += ms / 1000;
+        deadline.tv_nsec += (ms % 1000) * 1000000;
+        if (deadline.tv_nsec >= 1000000000) {
+            deadline.tv_sec++;
+            deadline.tv_nsec -= 1000000000;
+        }
+    }
+
+    __sync_fetch_and_add(&event->waiters, 1);
+    while (!event->signal) {
+        if (ms == DEF_MAX_WAIT_TIME) {
+            SEC_OSAL_FutexWait(&event->signal, 0, NULL);
+        } else {
+            if (SEC_OSAL_FutexTimeLeft(&deadline, &left) != 0) {
+                ret = OMX_ErrorTimeout;
+                break;
+            }
+            SEC_OSAL_FutexWait(&event->signal, 0, &left);
+        }
+    }
+    __sync_fetch_and_sub(&event->waiters, 1);
+
+    if ((ret == OMX_ErrorTimeout) && (event->signal))
+        ret = OMX_ErrorNone;
+
+EXIT:
+    FunctionOut();
+
+    return ret;
+}
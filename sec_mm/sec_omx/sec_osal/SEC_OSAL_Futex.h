@@ -0,0 +1,70 @@
+/*
+ *
+ * Copyright 2010 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file    SEC_OSAL_Futex.h
+ * @brief   futex helpers shared by the futex Event and Semaphore
+ * @version    1.0
+ */
+
+#ifndef SEC_OSAL_FUTEX
+#define SEC_OSAL_FUTEX
+
+#include <stdint.h>
+#include <time.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+/* Sleeps while *addr == val. Returns 0, or -1 with errno set */
+static inline int SEC_OSAL_FutexWait(volatile int32_t *addr, int32_t val, const struct timespec *timeout)
+{
+    return syscall(__NR_futex, addr, FUTEX_WAIT, val, timeout, NULL, 0);
+}
+
+/* Wakes up to count threads sleeping on addr */
+static inline int SEC_OSAL_FutexWake(volatile int32_t *addr, int32_t count)
+{
+    return syscall(__NR_futex, addr, FUTEX_WAKE, count, NULL, NULL, 0);
+}
+
+/*
+ * Time left until deadline, set to {0, 0} once passed.
+ * Returns 0 while time is left, -1 otherwise.
+ */
+static inline int SEC_OSAL_FutexTimeLeft(const struct timespec *deadline, struct timespec *left)
+{
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    left->tv_sec = deadline->tv_sec - now.tv_sec;
+    left->tv_nsec = deadline->tv_nsec - now.tv_nsec;
+    if (left->tv_nsec < 0) {
+        left->tv_sec--;
+        left->tv_nsec += 1000000000;
+    }
+    if (left->tv_sec < 0) {
+        left->tv_sec = 0;
+        left->tv_nsec = 0;
+        return -1;
+    }
+
+    return 0;
+}
+
+#endif
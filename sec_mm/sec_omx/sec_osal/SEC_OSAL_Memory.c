@@ -27,6 +27,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
 
 #include "SEC_OSAL_Memory.h"
 
@@ -34,27 +35,300 @@
 #include "SEC_OSAL_Log.h"
 
 
-static int mem_cnt = 0;
+#define SEC_MEM_MAGIC_HEAP      0x53484541  /* blocks of SEC_OSAL_PoolMalloc outside the size classes */
+#define SEC_MEM_MAGIC_POOL      0x53504F4F  /* blocks of a size class */
+#define SEC_MEM_MAGIC_FREE      0x53465245  /* given back, catches double free */
+
+#define SEC_MEM_POOL_CLASS_NUM  4
+#define SEC_MEM_POOL_SLAB_SIZE  4096
+
+/*
+ * Every block of SEC_OSAL_PoolMalloc is preceded by this header so
+ * SEC_OSAL_PoolFree can tell heap blocks from pool blocks. It keeps the
+ * alignment malloc() gives. Blocks of SEC_OSAL_Malloc have no header.
+ */
+typedef union _SEC_MEM_HEADER
+{
+    struct {
+        OMX_U32               magic;
+        OMX_U32               size;
+        struct _SEC_MEM_POOL *pool;
+    } info;
+    double align[2];
+} SEC_MEM_HEADER;
+
+/* A free pool block keeps the free list link in its user area */
+typedef struct _SEC_MEM_FREEBLOCK
+{
+    SEC_MEM_HEADER             header;
+    struct _SEC_MEM_FREEBLOCK *next;
+} SEC_MEM_FREEBLOCK;
+
+typedef union _SEC_MEM_SLAB
+{
+    union _SEC_MEM_SLAB *next;
+    double               align[2];
+} SEC_MEM_SLAB;
+
+typedef struct _SEC_MEM_POOL
+{
+    pthread_mutex_t    lock;
+    SEC_MEM_FREEBLOCK *freeList[SEC_MEM_POOL_CLASS_NUM];
+    SEC_MEM_SLAB      *slabList;
+    SEC_OSAL_MEMSTAT   stat;
+} SEC_MEM_POOL;
+
+static const OMX_U32 poolClassSize[SEC_MEM_POOL_CLASS_NUM] = {32, 64, 128, 256};
+
+#ifdef USE_SEC_OSAL_HEAP_STAT
+/* shared by every thread of the process, debug builds only */
+static SEC_OSAL_MEMSTAT heapStat;
+#endif
+
+
+static int SEC_OSAL_PoolClass(OMX_U32 size)
+{
+    int i;
+
+    for (i = 0; i < SEC_MEM_POOL_CLASS_NUM; i++) {
+        if (size <= poolClassSize[i])
+            return i;
+    }
+
+    return -1;
+}
+
+/* Called with pool->lock held */
+static int SEC_OSAL_PoolAddSlab(SEC_MEM_POOL *pool, int class)
+{
+    SEC_MEM_SLAB      *slab;
+    SEC_MEM_FREEBLOCK *block;
+    OMX_U32            blockSize = sizeof(SEC_MEM_HEADER) + poolClassSize[class];
+    OMX_U32            offset;
+
+    slab = (SEC_MEM_SLAB *)malloc(SEC_MEM_POOL_SLAB_SIZE);
+    if (slab == NULL)
+        return -1;
+
+    slab->next = pool->slabList;
+    pool->slabList = slab;
+    pool->stat.heapAllocNum++;
+
+    for (offset = sizeof(SEC_MEM_SLAB); offset + blockSize <= SEC_MEM_POOL_SLAB_SIZE; offset += blockSize) {
+        block = (SEC_MEM_FREEBLOCK *)((char *)slab + offset);
+        block->header.info.magic = SEC_MEM_MAGIC_FREE;
+        block->header.info.pool = pool;
+        block->next = pool->freeList[class];
+        pool->freeList[class] = block;
+    }
+
+    return 0;
+}
 
 OMX_PTR SEC_OSAL_Malloc(OMX_U32 size)
 {
-    mem_cnt++;
-    SEC_OSAL_Log(SEC_LOG_TRACE, "alloc count: %d", mem_cnt);
+    OMX_PTR addr;
+
+    addr = (OMX_PTR)malloc(size);
+    if (addr == NULL)
+        return NULL;
+
+#ifdef USE_SEC_OSAL_HEAP_STAT
+    __sync_fetch_and_add(&heapStat.allocNum, 1);
+    __sync_fetch_and_add(&heapStat.heapAllocNum, 1);
+    __sync_fetch_and_add(&heapStat.usedNum, 1);
+    SEC_OSAL_Log(SEC_LOG_TRACE, "alloc count: %d", heapStat.usedNum);
+#endif
 
-    return (OMX_PTR)malloc(size);
+    return addr;
 }
 
 void SEC_OSAL_Free(OMX_PTR addr)
 {
-    mem_cnt--;
-    SEC_OSAL_Log(SEC_LOG_TRACE, "free count: %d", mem_cnt);
+    if (addr == NULL)
+        return;
 
-    if (addr)
-        free(addr);
+#ifdef USE_SEC_OSAL_HEAP_STAT
+    __sync_fetch_and_add(&heapStat.freeNum, 1);
+    __sync_fetch_and_sub(&heapStat.usedNum, 1);
+    SEC_OSAL_Log(SEC_LOG_TRACE, "free count: %d", heapStat.usedNum);
+#endif
+
+    free(addr);
 
     return;
 }
 
+OMX_ERRORTYPE SEC_OSAL_MemoryPoolCreate(OMX_HANDLETYPE *poolHandle)
+{
+    SEC_MEM_POOL  *pool;
+    OMX_ERRORTYPE  ret = OMX_ErrorNone;
+
+    if (poolHandle == NULL) {
+        ret = OMX_ErrorBadParameter;
+        goto EXIT;
+    }
+
+    pool = (SEC_MEM_POOL *)SEC_OSAL_Malloc(sizeof(SEC_MEM_POOL));
+    if (pool == NULL) {
+        ret = OMX_ErrorInsufficientResources;
+        goto EXIT;
+    }
+    SEC_OSAL_Memset(pool, 0, sizeof(SEC_MEM_POOL));
+
+    if (pthread_mutex_init(&pool->lock, NULL) != 0) {
+        SEC_OSAL_Free(pool);
+        ret = OMX_ErrorUndefined;
+        goto EXIT;
+    }
+
+    *poolHandle = (OMX_HANDLETYPE)pool;
+
+EXIT:
+    return ret;
+}
+
+/*
+ * Blocks still out are reported as leaks and released with the slabs,
+ * they must not be used or freed afterwards.
+ */
+OMX_ERRORTYPE SEC_OSAL_MemoryPoolTerminate(OMX_HANDLETYPE poolHandle)
+{
+    SEC_MEM_POOL  *pool = (SEC_MEM_POOL *)poolHandle;
+    SEC_MEM_SLAB  *slab;
+    OMX_ERRORTYPE  ret = OMX_ErrorNone;
+
+    if (pool == NULL) {
+        ret = OMX_ErrorBadParameter;
+        goto EXIT;
+    }
+
+    if (pool->stat.usedNum != 0)
+        SEC_OSAL_Log(SEC_LOG_ERROR, "memory pool %p: %d blocks, %d bytes leaked",
+                     pool, pool->stat.usedNum, pool->stat.usedSize);
+    SEC_OSAL_Log(SEC_LOG_TRACE, "memory pool %p: %d allocs, peak %d bytes, %d slabs",
+                 pool, pool->stat.allocNum, pool->stat.peakUsedSize, pool->stat.heapAllocNum);
+
+    while (pool->slabList != NULL) {
+        slab = pool->slabList;
+        pool->slabList = slab->next;
+        free(slab);
+    }
+
+    pthread_mutex_destroy(&pool->lock);
+    SEC_OSAL_Free(pool);
+
+EXIT:
+    return ret;
+}
+
+OMX_PTR SEC_OSAL_PoolMalloc(OMX_HANDLETYPE poolHandle, OMX_U32 size)
+{
+    SEC_MEM_POOL      *pool = (SEC_MEM_POOL *)poolHandle;
+    SEC_MEM_FREEBLOCK *block = NULL;
+    SEC_MEM_HEADER    *header;
+    int                class;
+
+    class = SEC_OSAL_PoolClass(size);
+    if ((pool == NULL) || (class < 0)) {
+        if (size > 0xFFFFFFFF - sizeof(SEC_MEM_HEADER))
+            return NULL;
+
+        header = (SEC_MEM_HEADER *)malloc(sizeof(SEC_MEM_HEADER) + size);
+        if (header == NULL)
+            return NULL;
+
+        header->info.magic = SEC_MEM_MAGIC_HEAP;
+        header->info.size = size;
+        header->info.pool = NULL;
+        return (OMX_PTR)(header + 1);
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    if ((pool->freeList[class] == NULL) && (SEC_OSAL_PoolAddSlab(pool, class) != 0))
+        goto EXIT;
+
+    block = pool->freeList[class];
+    pool->freeList[class] = block->next;
+
+    block->header.info.magic = SEC_MEM_MAGIC_POOL;
+    block->header.info.size = size;
+
+    pool->stat.allocNum++;
+    pool->stat.usedNum++;
+    pool->stat.usedSize += size;
+    if (pool->stat.usedSize > pool->stat.peakUsedSize)
+        pool->stat.peakUsedSize = pool->stat.usedSize;
+
+EXIT:
+    pthread_mutex_unlock(&pool->lock);
+
+    return (block != NULL) ? (OMX_PTR)(&block->header + 1) : NULL;
+}
+
+void SEC_OSAL_PoolFree(OMX_HANDLETYPE poolHandle, OMX_PTR addr)
+{
+    SEC_MEM_HEADER *header;
+    SEC_MEM_POOL   *pool;
+    int             class;
+
+    if (addr == NULL)
+        return;
+
+    header = (SEC_MEM_HEADER *)addr - 1;
+
+    switch (header->info.magic) {
+    case SEC_MEM_MAGIC_HEAP:
+        header->info.magic = SEC_MEM_MAGIC_FREE;
+        free(header);
+        break;
+    case SEC_MEM_MAGIC_POOL:
+        pool = header->info.pool;
+        if (pool != (SEC_MEM_POOL *)poolHandle)
+            SEC_OSAL_Log(SEC_LOG_ERROR, "%s: %p freed to pool %p, allocated from %p", __FUNCTION__, addr, poolHandle, pool);
+        class = SEC_OSAL_PoolClass(header->info.size);
+        pthread_mutex_lock(&pool->lock);
+        header->info.magic = SEC_MEM_MAGIC_FREE;
+        ((SEC_MEM_FREEBLOCK *)header)->next = pool->freeList[class];
+        pool->freeList[class] = (SEC_MEM_FREEBLOCK *)header;
+        pool->stat.freeNum++;
+        pool->stat.usedNum--;
+        pool->stat.usedSize -= header->info.size;
+        pthread_mutex_unlock(&pool->lock);
+        break;
+    case SEC_MEM_MAGIC_FREE:
+        SEC_OSAL_Log(SEC_LOG_ERROR, "%s: %p freed twice", __FUNCTION__, addr);
+        break;
+    default:
+        SEC_OSAL_Log(SEC_LOG_ERROR, "%s: %p not allocated by SEC_OSAL_PoolMalloc", __FUNCTION__, addr);
+        break;
+    }
+
+    return;
+}
+
+OMX_ERRORTYPE SEC_OSAL_GetMemoryStat(OMX_HANDLETYPE poolHandle, SEC_OSAL_MEMSTAT *stat)
+{
+    SEC_MEM_POOL *pool = (SEC_MEM_POOL *)poolHandle;
+
+    if (stat == NULL)
+        return OMX_ErrorBadParameter;
+
+    if (pool == NULL) {
+#ifdef USE_SEC_OSAL_HEAP_STAT
+        SEC_OSAL_Memcpy(stat, &heapStat, sizeof(SEC_OSAL_MEMSTAT));
+#else
+        return OMX_ErrorNotImplemented;
+#endif
+    } else {
+        pthread_mutex_lock(&pool->lock);
+        SEC_OSAL_Memcpy(stat, &pool->stat, sizeof(SEC_OSAL_MEMSTAT));
+        pthread_mutex_unlock(&pool->lock);
+    }
+
+    return OMX_ErrorNone;
+}
+
 OMX_PTR SEC_OSAL_Memset(OMX_PTR dest, OMX_S32 c, OMX_S32 n)
 {
     return memset(dest, c, n);
@@ -28,8 +28,19 @@
 #define SEC_OSAL_MEMORY
 
 #include "OMX_Types.h"
+#include "OMX_Core.h"
 
 
+typedef struct _SEC_OSAL_MEMSTAT
+{
+    OMX_U32 allocNum;      /* blocks handed out */
+    OMX_U32 freeNum;       /* blocks given back */
+    OMX_U32 usedNum;       /* blocks not given back yet */
+    OMX_U32 usedSize;      /* bytes requested by the blocks not given back yet */
+    OMX_U32 peakUsedSize;
+    OMX_U32 heapAllocNum;  /* calls to malloc(), one per slab for a pool */
+} SEC_OSAL_MEMSTAT;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -39,6 +50,23 @@ void    SEC_OSAL_Free(OMX_PTR addr);
 OMX_PTR SEC_OSAL_Memset(OMX_PTR dest, OMX_S32 c, OMX_S32 n);
 OMX_PTR SEC_OSAL_Memcpy(OMX_PTR dest, OMX_PTR src, OMX_S32 n);
 
+/*
+ * Size class pool for the small, short lived blocks of one component
+ * (messages, commands). Blocks come from PoolMalloc and go back with
+ * PoolFree only, never with SEC_OSAL_Free.
+ * A NULL poolHandle or a size above the classes falls back to the heap.
+ */
+OMX_ERRORTYPE SEC_OSAL_MemoryPoolCreate(OMX_HANDLETYPE *poolHandle);
+OMX_ERRORTYPE SEC_OSAL_MemoryPoolTerminate(OMX_HANDLETYPE poolHandle);
+OMX_PTR       SEC_OSAL_PoolMalloc(OMX_HANDLETYPE poolHandle, OMX_U32 size);
+void          SEC_OSAL_PoolFree(OMX_HANDLETYPE poolHandle, OMX_PTR addr);
+/*
+ * poolHandle NULL reports the block counts of SEC_OSAL_Malloc, not their
+ * sizes, in builds with USE_SEC_OSAL_HEAP_STAT only. Otherwise it returns
+ * OMX_ErrorNotImplemented, the counters would be shared by every thread.
+ */
+OMX_ERRORTYPE SEC_OSAL_GetMemoryStat(OMX_HANDLETYPE poolHandle, SEC_OSAL_MEMSTAT *stat);
+
 #ifdef __cplusplus
 }
 #endif
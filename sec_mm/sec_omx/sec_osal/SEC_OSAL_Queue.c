@@ -28,13 +28,14 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <cutils/atomic.h>
 
 #include "SEC_OSAL_Memory.h"
 #include "SEC_OSAL_Mutex.h"
 #include "SEC_OSAL_Queue.h"
 
 
-OMX_ERRORTYPE SEC_OSAL_QueueCreate(SEC_QUEUE *queueHandle)
+OMX_ERRORTYPE SEC_OSAL_QueueCreate(SEC_QUEUE *queueHandle, int maxNumElem)
 {
     int i = 0;
     SEC_QElem *newqelem = NULL;
@@ -43,7 +44,7 @@ OMX_ERRORTYPE SEC_OSAL_QueueCreate(SEC_QUEUE *queueHandle)
 
     OMX_ERRORTYPE ret = OMX_ErrorNone;
 
-    if (!queue)
+    if ((!queue) || (maxNumElem <= 0))
         return OMX_ErrorBadParameter;
 
     ret = SEC_OSAL_MutexCreate(&queue->qMutex);
@@ -51,14 +52,18 @@ OMX_ERRORTYPE SEC_OSAL_QueueCreate(SEC_QUEUE *queueHandle)
         return ret;
 
     queue->first = (SEC_QElem *)SEC_OSAL_Malloc(sizeof(SEC_QElem));
-    if (queue->first == NULL)
+    if (queue->first == NULL) {
+        SEC_OSAL_MutexTerminate(queue->qMutex);
+        queue->qMutex = NULL;
         return OMX_ErrorInsufficientResources;
+    }
 
     SEC_OSAL_Memset(queue->first, 0, sizeof(SEC_QElem));
     currentqelem = queue->last = queue->first;
     queue->numElem = 0;
+    queue->maxNumElem = maxNumElem;
 
-    for (i = 0; i < (MAX_QUEUE_ELEMENTS - 2); i++) {
+    for (i = 0; i < (maxNumElem - 1); i++) {
         newqelem = (SEC_QElem *)SEC_OSAL_Malloc(sizeof(SEC_QElem));
         if (newqelem == NULL) {
             while (queue->first != NULL) {
@@ -66,6 +71,8 @@ OMX_ERRORTYPE SEC_OSAL_QueueCreate(SEC_QUEUE *queueHandle)
                 SEC_OSAL_Free((OMX_PTR)queue->first);
                 queue->first = currentqelem;
             }
+            SEC_OSAL_MutexTerminate(queue->qMutex);
+            queue->qMutex = NULL;
             return OMX_ErrorInsufficientResources;
         } else {
             SEC_OSAL_Memset(newqelem, 0, sizeof(SEC_QElem));
@@ -89,16 +96,14 @@ OMX_ERRORTYPE SEC_OSAL_QueueTerminate(SEC_QUEUE *queueHandle)
     if (!queue)
         return OMX_ErrorBadParameter;
 
-    for ( i = 0; i < (MAX_QUEUE_ELEMENTS - 2); i++) {
+    for ( i = 0; (queue->first != NULL) && (i < queue->maxNumElem); i++) {
         currentqelem = queue->first->qNext;
         SEC_OSAL_Free(queue->first);
         queue->first = currentqelem;
     }
-
-    if(queue->first) {
-        SEC_OSAL_Free(queue->first);
-        queue->first = NULL;
-    }
+    queue->first = NULL;
+    queue->last = NULL;
+    queue->maxNumElem = 0;
 
     ret = SEC_OSAL_MutexTerminate(queue->qMutex);
 
@@ -113,7 +118,7 @@ int SEC_OSAL_Queue(SEC_QUEUE *queueHandle, void *data)
 
     SEC_OSAL_MutexLock(queue->qMutex);
 
-    if ((queue->last->data != NULL) || (queue->numElem >= MAX_QUEUE_ELEMENTS)) {
+    if ((queue->last->data != NULL) || (queue->numElem >= queue->maxNumElem)) {
         SEC_OSAL_MutexUnlock(queue->qMutex);
         return -1;
     }
@@ -172,3 +177,132 @@ int SEC_OSAL_SetElemNum(SEC_QUEUE *queueHandle, int ElemNum)
     return ElemNum;
 }
 
+/*
+ * head is published with release semantics after the slot is written,
+ * and read with acquire semantics before the slot is read; the same for
+ * tail in the other direction. Indexes run freely and wrap at 2^32.
+ */
+static inline uint32_t SEC_OSAL_RingLoad(volatile uint32_t *index)
+{
+    return (uint32_t)android_atomic_acquire_load((volatile const int32_t *)index);
+}
+
+static inline void SEC_OSAL_RingStore(volatile uint32_t *index, uint32_t value)
+{
+    android_atomic_release_store((int32_t)value, (volatile int32_t *)index);
+}
+
+OMX_ERRORTYPE SEC_OSAL_RingCreate(SEC_RING *ringHandle, int size)
+{
+    SEC_RING *ring = (SEC_RING *)ringHandle;
+    uint32_t capacity = 1;
+
+    if ((!ring) || (size <= 0))
+        return OMX_ErrorBadParameter;
+
+    while (capacity < (uint32_t)size)
+        capacity <<= 1;
+
+    if (SEC_OSAL_MutexCreate(&ring->putMutex) != OMX_ErrorNone)
+        return OMX_ErrorInsufficientResources;
+
+    ring->data = (void **)SEC_OSAL_Malloc(sizeof(void *) * capacity);
+    if (ring->data == NULL) {
+        SEC_OSAL_MutexTerminate(ring->putMutex);
+        ring->putMutex = NULL;
+        return OMX_ErrorInsufficientResources;
+    }
+
+    SEC_OSAL_Memset(ring->data, 0, sizeof(void *) * capacity);
+    ring->size = capacity;
+    ring->mask = capacity - 1;
+    ring->head = 0;
+    ring->tail = 0;
+
+    return OMX_ErrorNone;
+}
+
+OMX_ERRORTYPE SEC_OSAL_RingTerminate(SEC_RING *ringHandle)
+{
+    SEC_RING *ring = (SEC_RING *)ringHandle;
+
+    if (!ring)
+        return OMX_ErrorBadParameter;
+
+    if (ring->data) {
+        SEC_OSAL_Free(ring->data);
+        ring->data = NULL;
+    }
+    if (ring->putMutex) {
+        SEC_OSAL_MutexTerminate(ring->putMutex);
+        ring->putMutex = NULL;
+    }
+    ring->size = 0;
+    ring->mask = 0;
+    ring->head = 0;
+    ring->tail = 0;
+
+    return OMX_ErrorNone;
+}
+
+/* Producer side, -1 if the ring is full */
+int SEC_OSAL_RingPut(SEC_RING *ringHandle, void *data)
+{
+    SEC_RING *ring = (SEC_RING *)ringHandle;
+    uint32_t head, tail;
+    int ret = 0;
+
+    if ((ring == NULL) || (ring->data == NULL))
+        return -1;
+
+    SEC_OSAL_MutexLock(ring->putMutex);
+    head = ring->head;
+    tail = SEC_OSAL_RingLoad(&ring->tail);
+    if ((head - tail) >= ring->size) {
+        ret = -1;
+    } else {
+        ring->data[head & ring->mask] = data;
+        SEC_OSAL_RingStore(&ring->head, head + 1);
+    }
+    SEC_OSAL_MutexUnlock(ring->putMutex);
+
+    return ret;
+}
+
+/* Consumer side */
+void *SEC_OSAL_RingGet(SEC_RING *ringHandle)
+{
+    SEC_RING *ring = (SEC_RING *)ringHandle;
+    uint32_t head, tail;
+    void *data = NULL;
+
+    if ((ring == NULL) || (ring->data == NULL))
+        return NULL;
+
+    tail = ring->tail;
+    head = SEC_OSAL_RingLoad(&ring->head);
+    if (head == tail)
+        return NULL;
+
+    data = ring->data[tail & ring->mask];
+    SEC_OSAL_RingStore(&ring->tail, tail + 1);
+
+    return data;
+}
+
+/* Exact when called from the consumer, a snapshot otherwise */
+int SEC_OSAL_RingGetElemNum(SEC_RING *ringHandle)
+{
+    SEC_RING *ring = (SEC_RING *)ringHandle;
+    uint32_t head, tail;
+
+    if (ring == NULL)
+        return -1;
+
+    tail = SEC_OSAL_RingLoad(&ring->tail);
+    head = SEC_OSAL_RingLoad(&ring->head);
+    if ((head - tail) > ring->size)
+        return (int)ring->size;
+
+    return (int)(head - tail);
+}
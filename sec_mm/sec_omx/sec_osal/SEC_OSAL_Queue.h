@@ -27,12 +27,15 @@
 #ifndef SEC_OSAL_QUEUE
 #define SEC_OSAL_QUEUE
 
+#include <stdint.h>
 #include "OMX_Types.h"
 #include "OMX_Core.h"
 
 
 #define MAX_QUEUE_ELEMENTS    10
 
+#define SEC_CACHE_LINE_SIZE   64
+
 typedef struct _SEC_QElem
 {
     void              *data;
@@ -44,21 +47,47 @@ typedef struct _SEC_QUEUE
     SEC_QElem     *first;
     SEC_QElem     *last;
     int            numElem;
+    int            maxNumElem;
     OMX_HANDLETYPE qMutex;
 } SEC_QUEUE;
 
+/*
+ * Ring for any number of producers and one consumer.
+ * Producers are serialized by putMutex, the only writer of head, so an
+ * ETB or FTB from any client thread is safe. The consumer alone writes
+ * tail and takes no lock. Several consumers must be serialized by the
+ * caller.
+ */
+typedef struct _SEC_RING
+{
+    void             **data;
+    uint32_t           size;
+    uint32_t           mask;
+    OMX_HANDLETYPE     putMutex;
+    volatile uint32_t  head;
+    char               headPad[SEC_CACHE_LINE_SIZE - sizeof(uint32_t)];
+    volatile uint32_t  tail;
+    char               tailPad[SEC_CACHE_LINE_SIZE - sizeof(uint32_t)];
+} SEC_RING;
+
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-OMX_ERRORTYPE SEC_OSAL_QueueCreate(SEC_QUEUE *queueHandle);
+OMX_ERRORTYPE SEC_OSAL_QueueCreate(SEC_QUEUE *queueHandle, int maxNumElem);
 OMX_ERRORTYPE SEC_OSAL_QueueTerminate(SEC_QUEUE *queueHandle);
 int           SEC_OSAL_Queue(SEC_QUEUE *queueHandle, void *data);
 void         *SEC_OSAL_Dequeue(SEC_QUEUE *queueHandle);
 int           SEC_OSAL_GetElemNum(SEC_QUEUE *queueHandle);
 int           SEC_OSAL_SetElemNum(SEC_QUEUE *queueHandle, int ElemNum);
 
+OMX_ERRORTYPE SEC_OSAL_RingCreate(SEC_RING *ringHandle, int size);
+OMX_ERRORTYPE SEC_OSAL_RingTerminate(SEC_RING *ringHandle);
+int           SEC_OSAL_RingPut(SEC_RING *ringHandle, void *data);
+void         *SEC_OSAL_RingGet(SEC_RING *ringHandle);
+int           SEC_OSAL_RingGetElemNum(SEC_RING *ringHandle);
+
 #ifdef __cplusplus
 }
 #endif
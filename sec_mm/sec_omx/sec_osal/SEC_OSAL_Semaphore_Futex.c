@@ -0,0 +1,150 @@
+/*
+ *
+ * Copyright 2010 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file        SEC_OSAL_Semaphore_Futex.c
+ * @brief       futex implementation of SEC_OSAL_Semaphore*
+ *   Post and Wait on an available count are a single atomic operation,
+ *   the kernel is entered only to sleep on a zero count or to wake a
+ *   sleeper.
+ * @version     1.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+#include "SEC_OSAL_Memory.h"
+#include "SEC_OSAL_Semaphore.h"
+#include "SEC_OSAL_Futex.h"
+
+#undef SEC_LOG_TAG
+#define SEC_LOG_TAG    "SEC_LOG_SEMA"
+#define SEC_LOG_OFF
+#include "SEC_OSAL_Log.h"
+
+
+typedef struct _SEC_OSAL_FUTEXSEMA
+{
+    volatile int32_t count;
+    volatile int32_t waiters;
+} SEC_OSAL_FUTEXSEMA;
+
+
+OMX_ERRORTYPE SEC_OSAL_SemaphoreCreate(OMX_HANDLETYPE *semaphoreHandle)
+{
+    SEC_OSAL_FUTEXSEMA *sema;
+
+    sema = (SEC_OSAL_FUTEXSEMA *)SEC_OSAL_Malloc(sizeof(SEC_OSAL_FUTEXSEMA));
+    if (!sema)
+        return OMX_ErrorInsufficientResources;
+
+    SEC_OSAL_Memset(sema, 0, sizeof(SEC_OSAL_FUTEXSEMA));
+
+    *semaphoreHandle = (OMX_HANDLETYPE)sema;
+    return OMX_ErrorNone;
+}
+
+OMX_ERRORTYPE SEC_OSAL_SemaphoreTerminate(OMX_HANDLETYPE semaphoreHandle)
+{
+    SEC_OSAL_FUTEXSEMA *sema = (SEC_OSAL_FUTEXSEMA *)semaphoreHandle;
+
+    if (sema == NULL)
+        return OMX_ErrorBadParameter;
+
+    SEC_OSAL_Free(sema);
+    return OMX_ErrorNone;
+}
+
+OMX_ERRORTYPE SEC_OSAL_SemaphoreWait(OMX_HANDLETYPE semaphoreHandle)
+{
+    SEC_OSAL_FUTEXSEMA *sema = (SEC_OSAL_FUTEXSEMA *)semaphoreHandle;
+    int32_t count;
+
+    FunctionIn();
+
+    if (sema == NULL)
+        return OMX_ErrorBadParameter;
+
+    while (1) {
+        count = sema->count;
+        if (count > 0) {
+            if (__sync_bool_compare_and_swap(&sema->count, count, count - 1))
+                break;
+            continue;
+        }
+
+        /*
+         * The increment of waiters is a full barrier, so Post either sees
+         * it or has already raised count, and then the kernel refuses to
+         * sleep on a non zero count.
+         */
+        __sync_fetch_and_add(&sema->waiters, 1);
+        SEC_OSAL_FutexWait(&sema->count, 0, NULL);
+        __sync_fetch_and_sub(&sema->waiters, 1);
+    }
+
+    FunctionOut();
+
+    return OMX_ErrorNone;
+}
+
+OMX_ERRORTYPE SEC_OSAL_SemaphorePost(OMX_HANDLETYPE semaphoreHandle)
+{
+    SEC_OSAL_FUTEXSEMA *sema = (SEC_OSAL_FUTEXSEMA *)semaphoreHandle;
+
+    FunctionIn();
+
+    if (sema == NULL)
+        return OMX_ErrorBadParameter;
+
+    __sync_fetch_and_add(&sema->count, 1);
+    if (sema->waiters > 0)
+        SEC_OSAL_FutexWake(&sema->count, 1);
+
+    FunctionOut();
+
+    return OMX_ErrorNone;
+}
+
+OMX_ERRORTYPE SEC_OSAL_Set_SemaphoreCount(OMX_HANDLETYPE semaphoreHandle, OMX_S32 val)
+{
+    SEC_OSAL_FUTEXSEMA *sema = (SEC_OSAL_FUTEXSEMA *)semaphoreHandle;
+
+    if ((sema == NULL) || (val < 0))
+        return OMX_ErrorBadParameter;
+
+    __sync_lock_test_and_set(&sema->count, val);
+    __sync_synchronize();
+    if ((val > 0) && (sema->waiters > 0))
+        SEC_OSAL_FutexWake(&sema->count, INT_MAX);
+
+    return OMX_ErrorNone;
+}
+
+OMX_ERRORTYPE SEC_OSAL_Get_SemaphoreCount(OMX_HANDLETYPE semaphoreHandle, OMX_S32 *val)
+{
+    SEC_OSAL_FUTEXSEMA *sema = (SEC_OSAL_FUTEXSEMA *)semaphoreHandle;
+
+    if (sema == NULL)
+        return OMX_ErrorBadParameter;
+
+    *val = sema->count;
+
+    return OMX_ErrorNone;
+}
@@ -0,0 +1,192 @@
+/*
+ *
+ * Copyright 2010 Samsung Electronics S.LSI Co. LTD
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+/*
+ * @file        SEC_OSAL_SyncBench.c
+ * @brief       Micro-benchmark of SEC_OSAL_Semaphore* and SEC_OSAL_Signal*
+ *   Built once against each implementation (sec_osal_sync_bench and
+ *   sec_osal_sync_bench_pthread), run both on the same device to compare.
+ *   - uncontended : Post then Wait on one thread, no sleeping
+ *   - ping-pong   : two threads hand a token back and forth, every hand-off
+ *                   wakes a sleeping thread, as in the buffer queues
+ * @version     1.0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "SEC_OSAL_Event.h"
+#include "SEC_OSAL_Semaphore.h"
+#include "SEC_OSAL_Thread.h"
+
+#ifndef SEC_OSAL_SYNC_NAME
+#define SEC_OSAL_SYNC_NAME "futex"
+#endif
+
+#define DEFAULT_LOOP_NUM    100000
+
+typedef struct _SYNC_BENCH_PAIR
+{
+    OMX_HANDLETYPE ping;
+    OMX_HANDLETYPE pong;
+    int            loopNum;
+} SYNC_BENCH_PAIR;
+
+static double SyncBench_NowNs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void SyncBench_Report(const char *name, double ns, int loopNum)
+{
+    printf("%-8s %-28s %10.0f ns/op\n", SEC_OSAL_SYNC_NAME, name, ns / loopNum);
+}
+
+static void *SyncBench_SemaphorePeer(void *arg)
+{
+    SYNC_BENCH_PAIR *pair = (SYNC_BENCH_PAIR *)arg;
+    int i;
+
+    for (i = 0; i < pair->loopNum; i++) {
+        SEC_OSAL_SemaphoreWait(pair->ping);
+        SEC_OSAL_SemaphorePost(pair->pong);
+    }
+
+    return NULL;
+}
+
+static void *SyncBench_SignalPeer(void *arg)
+{
+    SYNC_BENCH_PAIR *pair = (SYNC_BENCH_PAIR *)arg;
+    int i;
+
+    for (i = 0; i < pair->loopNum; i++) {
+        SEC_OSAL_SignalWait(pair->ping, DEF_MAX_WAIT_TIME);
+        SEC_OSAL_SignalReset(pair->ping);
+        SEC_OSAL_SignalSet(pair->pong);
+    }
+
+    return NULL;
+}
+
+static int SyncBench_Semaphore(int loopNum)
+{
+    SYNC_BENCH_PAIR pair;
+    OMX_HANDLETYPE  thread = NULL;
+    double          ns;
+    int             i;
+
+    if (SEC_OSAL_SemaphoreCreate(&pair.ping) != OMX_ErrorNone ||
+        SEC_OSAL_SemaphoreCreate(&pair.pong) != OMX_ErrorNone)
+        return -1;
+    pair.loopNum = loopNum;
+
+    ns = SyncBench_NowNs();
+    for (i = 0; i < loopNum; i++) {
+        SEC_OSAL_SemaphorePost(pair.ping);
+        SEC_OSAL_SemaphoreWait(pair.ping);
+    }
+    SyncBench_Report("semaphore uncontended", SyncBench_NowNs() - ns, loopNum);
+
+    if (SEC_OSAL_ThreadCreate(&thread, (OMX_PTR)SyncBench_SemaphorePeer, &pair) != OMX_ErrorNone)
+        return -1;
+
+    ns = SyncBench_NowNs();
+    for (i = 0; i < loopNum; i++) {
+        SEC_OSAL_SemaphorePost(pair.ping);
+        SEC_OSAL_SemaphoreWait(pair.pong);
+    }
+    ns = SyncBench_NowNs() - ns;
+    /* one round trip is two wake-ups */
+    SyncBench_Report("semaphore wake-up", ns / 2, loopNum);
+
+    SEC_OSAL_ThreadTerminate(thread);
+    SEC_OSAL_SemaphoreTerminate(pair.ping);
+    SEC_OSAL_SemaphoreTerminate(pair.pong);
+
+    return 0;
+}
+
+static int SyncBench_Signal(int loopNum)
+{
+    SYNC_BENCH_PAIR pair;
+    OMX_HANDLETYPE  thread = NULL;
+    double          ns;
+    int             i;
+
+    if (SEC_OSAL_SignalCreate(&pair.ping) != OMX_ErrorNone ||
+        SEC_OSAL_SignalCreate(&pair.pong) != OMX_ErrorNone)
+        return -1;
+    pair.loopNum = loopNum;
+
+    ns = SyncBench_NowNs();
+    for (i = 0; i < loopNum; i++) {
+        SEC_OSAL_SignalSet(pair.ping);
+        SEC_OSAL_SignalWait(pair.ping, DEF_MAX_WAIT_TIME);
+        SEC_OSAL_SignalReset(pair.ping);
+    }
+    SyncBench_Report("signal uncontended", SyncBench_NowNs() - ns, loopNum);
+
+    if (SEC_OSAL_ThreadCreate(&thread, (OMX_PTR)SyncBench_SignalPeer, &pair) != OMX_ErrorNone)
+        return -1;
+
+    ns = SyncBench_NowNs();
+    for (i = 0; i < loopNum; i++) {
+        SEC_OSAL_SignalSet(pair.ping);
+        SEC_OSAL_SignalWait(pair.pong, DEF_MAX_WAIT_TIME);
+        SEC_OSAL_SignalReset(pair.pong);
+    }
+    ns = SyncBench_NowNs() - ns;
+    SyncBench_Report("signal wake-up", ns / 2, loopNum);
+
+    SEC_OSAL_ThreadTerminate(thread);
+    SEC_OSAL_SignalTerminate(pair.ping);
+    SEC_OSAL_SignalTerminate(pair.pong);
+
+    ns = SyncBench_NowNs();
+    SEC_OSAL_SignalCreate(&pair.ping);
+    if (SEC_OSAL_SignalWait(pair.ping, 10) != OMX_ErrorTimeout)
+        printf("%-8s signal timeout not reported\n", SEC_OSAL_SYNC_NAME);
+    SyncBench_Report("signal 10 ms timeout", SyncBench_NowNs() - ns, 1);
+    SEC_OSAL_SignalTerminate(pair.ping);
+
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    int loopNum = DEFAULT_LOOP_NUM;
+
+    if (argc > 1)
+        loopNum = atoi(argv[1]);
+    if (loopNum <= 0) {
+        printf("usage: %s [loop_num]\n", argv[0]);
+        return 2;
+    }
+
+    if (SyncBench_Semaphore(loopNum) != 0 || SyncBench_Signal(loopNum) != 0) {
+        printf("%s: setup failed\n", argv[0]);
+        return 1;
+    }
+
+    return 0;
+}
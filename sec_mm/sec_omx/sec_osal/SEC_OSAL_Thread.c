@@ -30,6 +30,12 @@
 #include <pthread.h>
 #include <semaphore.h>
 #include <errno.h>
+#include <sched.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/prctl.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
 
 #include "SEC_OSAL_Memory.h"
 #include "SEC_OSAL_Thread.h"
@@ -42,14 +48,74 @@
 
 typedef struct _SEC_THREAD_HANDLE_TYPE
 {
-    pthread_t          pthread;
-    pthread_attr_t     attr;
-    struct sched_param schedparam;
-    int                stack_size;
+    pthread_t            pthread;
+    pthread_attr_t       attr;
+    struct sched_param   schedparam;
+    int                  stack_size;
+    void              *(*function)(void *);
+    void                *argument;
+    SEC_OSAL_THREAD_ATTR threadAttr;
 } SEC_THREAD_HANDLE_TYPE;
 
 
+/*
+ * bionic has no pthread_setname_np nor pthread_setaffinity_np,
+ * so the attributes go to the kernel thread id from inside the thread.
+ */
+static void SEC_OSAL_ThreadApplyAttr(const SEC_OSAL_THREAD_ATTR *threadAttr)
+{
+    pid_t              tid = (pid_t)syscall(__NR_gettid);
+    struct sched_param schedparam;
+    unsigned long      cpuMask;
+
+    if (threadAttr->name[0] != '\0')
+        prctl(PR_SET_NAME, (unsigned long)threadAttr->name, 0, 0, 0);
+
+    switch (threadAttr->policy) {
+    case SEC_OSAL_SCHED_OTHER:
+        schedparam.sched_priority = 0;
+        if ((sched_setscheduler(tid, SCHED_OTHER, &schedparam) != 0) ||
+            (setpriority(PRIO_PROCESS, tid, threadAttr->priority) != 0))
+            SEC_OSAL_Log(SEC_LOG_WARNING, "%s: nice %d refused, errno %d",
+                         threadAttr->name, (int)threadAttr->priority, errno);
+        break;
+    case SEC_OSAL_SCHED_FIFO:
+    case SEC_OSAL_SCHED_RR:
+        schedparam.sched_priority = threadAttr->priority;
+        if (sched_setscheduler(tid, (threadAttr->policy == SEC_OSAL_SCHED_FIFO) ? SCHED_FIFO : SCHED_RR, &schedparam) != 0)
+            SEC_OSAL_Log(SEC_LOG_WARNING, "%s: real time priority %d refused, errno %d",
+                         threadAttr->name, (int)threadAttr->priority, errno);
+        break;
+    default:
+        break;
+    }
+
+    if (threadAttr->cpuMask != 0) {
+        cpuMask = threadAttr->cpuMask;
+        if (syscall(__NR_sched_setaffinity, tid, sizeof(cpuMask), &cpuMask) != 0)
+            SEC_OSAL_Log(SEC_LOG_WARNING, "%s: cpu mask 0x%x refused, errno %d",
+                         threadAttr->name, (unsigned int)threadAttr->cpuMask, errno);
+    }
+
+    return;
+}
+
+static void *SEC_OSAL_ThreadStart(void *arg)
+{
+    SEC_THREAD_HANDLE_TYPE *thread = (SEC_THREAD_HANDLE_TYPE *)arg;
+
+    SEC_OSAL_ThreadApplyAttr(&thread->threadAttr);
+
+    return thread->function(thread->argument);
+}
+
 OMX_ERRORTYPE SEC_OSAL_ThreadCreate(OMX_HANDLETYPE *threadHandle, OMX_PTR function_name, OMX_PTR argument)
+{
+    return SEC_OSAL_ThreadCreateEx(threadHandle, function_name, argument, NULL);
+}
+
+OMX_ERRORTYPE SEC_OSAL_ThreadCreateEx(OMX_HANDLETYPE *threadHandle, OMX_PTR function_name, OMX_PTR argument,
+                                      const SEC_OSAL_THREAD_ATTR *threadAttr)
 {
     FunctionIn();
 
@@ -59,24 +125,35 @@ OMX_ERRORTYPE SEC_OSAL_ThreadCreate(OMX_HANDLETYPE *threadHandle, OMX_PTR functi
     OMX_ERRORTYPE ret = OMX_ErrorNone;
 
     thread = SEC_OSAL_Malloc(sizeof(SEC_THREAD_HANDLE_TYPE));
+    if (thread == NULL) {
+        *threadHandle = NULL;
+        ret = OMX_ErrorInsufficientResources;
+        goto EXIT;
+    }
     SEC_OSAL_Memset(thread, 0, sizeof(SEC_THREAD_HANDLE_TYPE));
 
+    thread->function = (void *(*)(void *))function_name;
+    thread->argument = (void *)argument;
+    if (threadAttr != NULL) {
+        SEC_OSAL_Memcpy(&thread->threadAttr, (OMX_PTR)threadAttr, sizeof(SEC_OSAL_THREAD_ATTR));
+        thread->threadAttr.name[SEC_OSAL_THREAD_NAME_SIZE - 1] = '\0';
+        thread->stack_size = threadAttr->stackSize;
+    }
+
     pthread_attr_init(&thread->attr);
     if (thread->stack_size != 0)
         pthread_attr_setstacksize(&thread->attr, thread->stack_size);
 
-    /* set priority */
-    if (thread->schedparam.sched_priority != 0)
-        pthread_attr_setschedparam(&thread->attr, &thread->schedparam);
-
     detach_ret = pthread_attr_setdetachstate(&thread->attr, PTHREAD_CREATE_JOINABLE);
     if (detach_ret != 0) {
+        pthread_attr_destroy(&thread->attr);
+        SEC_OSAL_Free(thread);
+        *threadHandle = NULL;
         ret = OMX_ErrorUndefined;
         goto EXIT;
     }
 
-    result = pthread_create(&thread->pthread, &thread->attr, function_name, (void *)argument);
-    /* pthread_setschedparam(thread->pthread, SCHED_RR, &thread->schedparam); */
+    result = pthread_create(&thread->pthread, &thread->attr, SEC_OSAL_ThreadStart, (void *)thread);
 
     switch (result) {
     case 0:
@@ -93,6 +170,11 @@ OMX_ERRORTYPE SEC_OSAL_ThreadCreate(OMX_HANDLETYPE *threadHandle, OMX_PTR functi
         break;
     }
 
+    if (result != 0) {
+        pthread_attr_destroy(&thread->attr);
+        SEC_OSAL_Free(thread);
+    }
+
 EXIT:
     FunctionOut();
 
@@ -151,3 +233,13 @@ void SEC_OSAL_SleepMillisec(OMX_U32 ms)
     usleep(ms * 1000);
     return;
 }
+
+/* Monotonic clock, for intervals only */
+OMX_U64 SEC_OSAL_GetSystemTimeUs(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return ((OMX_U64)ts.tv_sec * 1000000) + (ts.tv_nsec / 1000);
+}
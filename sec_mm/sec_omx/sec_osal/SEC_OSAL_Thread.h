@@ -31,15 +31,42 @@
 #include "OMX_Core.h"
 
 
+typedef enum _SEC_OSAL_SCHED_POLICY
+{
+    SEC_OSAL_SCHED_INHERIT = 0,  /* keep the policy and priority of the creator */
+    SEC_OSAL_SCHED_OTHER,        /* time sharing, priority is a nice value */
+    SEC_OSAL_SCHED_FIFO,         /* real time, priority is 1..99 */
+    SEC_OSAL_SCHED_RR
+} SEC_OSAL_SCHED_POLICY;
+
+#define SEC_OSAL_THREAD_NAME_SIZE   16
+
+/*
+ * Zero filled means a default thread, as created by SEC_OSAL_ThreadCreate.
+ * The attributes are applied by the new thread itself before it runs
+ * function_name; a refused policy or affinity is logged, not fatal.
+ */
+typedef struct _SEC_OSAL_THREAD_ATTR
+{
+    char                  name[SEC_OSAL_THREAD_NAME_SIZE];
+    SEC_OSAL_SCHED_POLICY policy;
+    OMX_S32               priority;
+    OMX_U32               cpuMask;    /* bit n allows cpu n, 0 allows all */
+    OMX_U32               stackSize;  /* 0 for the default */
+} SEC_OSAL_THREAD_ATTR;
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 OMX_ERRORTYPE SEC_OSAL_ThreadCreate(OMX_HANDLETYPE *threadHandle, OMX_PTR function_name, OMX_PTR argument);
+OMX_ERRORTYPE SEC_OSAL_ThreadCreateEx(OMX_HANDLETYPE *threadHandle, OMX_PTR function_name, OMX_PTR argument,
+                                      const SEC_OSAL_THREAD_ATTR *threadAttr);
 OMX_ERRORTYPE SEC_OSAL_ThreadTerminate(OMX_HANDLETYPE threadHandle);
 OMX_ERRORTYPE SEC_OSAL_ThreadCancel(OMX_HANDLETYPE threadHandle);
 void          SEC_OSAL_ThreadExit(void *value_ptr);
 void          SEC_OSAL_SleepMillisec(OMX_U32 ms);
+OMX_U64       SEC_OSAL_GetSystemTimeUs(void);
 
 #ifdef __cplusplus
 }